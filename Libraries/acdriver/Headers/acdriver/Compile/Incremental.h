@@ -0,0 +1,106 @@
+/**
+ Copyright (c) 2015-present, Facebook, Inc.
+ All rights reserved.
+
+ This source code is licensed under the BSD-style license found in the
+ LICENSE file in the root directory of this source tree. An additional grant
+ of patent rights can be found in the PATENTS file in the same directory.
+ */
+
+#ifndef __acdriver_Compile_Incremental_h
+#define __acdriver_Compile_Incremental_h
+
+#include <car/Reader.h>
+#include <libutil/Hash.h>
+
+#include <map>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <ext/optional>
+
+namespace libutil { class Filesystem; }
+namespace xcassets { namespace Asset { class Asset; } }
+
+struct bom_context;
+
+namespace acdriver {
+namespace Compile {
+
+/*
+ * State for compiling into an archive incrementally.
+ *
+ * The inputs of each image set, its contents and the files it refers to,
+ * are fingerprinted and recorded in the compiled archive. When compiling
+ * again, image sets with the same fingerprint as in the previous archive
+ * have their renditions copied from it rather than being encoded again.
+ */
+class Incremental {
+private:
+    ext::optional<car::Reader>                     _previous;
+    std::unordered_map<std::string, libutil::Hash> _previousFingerprints;
+
+private:
+    std::map<std::string, libutil::Hash>           _fingerprints;
+    std::unordered_set<std::string>                _duplicates;
+    size_t                                         _reused;
+
+public:
+    Incremental();
+
+public:
+    /*
+     * The previously compiled archive, if there is one.
+     */
+    ext::optional<car::Reader> const &previous() const
+    { return _previous; }
+
+    /*
+     * The number of image sets copied from the previous archive.
+     */
+    size_t reused() const
+    { return _reused; }
+
+public:
+    /*
+     * Fingerprint the inputs of the image sets within an asset. Image sets
+     * sharing a name share a facet, so those are not fingerprinted.
+     */
+    void fingerprint(libutil::Filesystem const *filesystem, xcassets::Asset::Asset const *asset);
+
+    /*
+     * If the image set with a name is unchanged from the previous archive.
+     */
+    bool unchanged(std::string const &name) const;
+
+    /*
+     * Note an image set was copied from the previous archive.
+     */
+    void reuse();
+
+    /*
+     * Note an image set failed to compile. Its fingerprint is not recorded,
+     * so it is compiled again, reporting the same errors, next time.
+     */
+    void invalidate(std::string const &name);
+
+public:
+    /*
+     * Record the fingerprints in an archive being written.
+     */
+    void write(struct bom_context *bom) const;
+
+public:
+    /*
+     * Load the state from a previously compiled archive. If there isn't
+     * one, or it was not compiled incrementally, nothing is reused.
+     */
+    static std::unique_ptr<Incremental>
+    Load(libutil::Filesystem const *filesystem, std::string const &path);
+};
+
+}
+}
+
+#endif // !__acdriver_Compile_Incremental_h
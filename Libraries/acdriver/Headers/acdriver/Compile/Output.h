@@ -10,11 +10,13 @@
 #ifndef __acdriver_Compile_Output_h
 #define __acdriver_Compile_Output_h
 
+#include <acdriver/Compile/Incremental.h>
 #include <plist/Dictionary.h>
 #include <car/Writer.h>
 
 #include <memory>
 #include <string>
+#include <unordered_map>
 #include <utility>
 #include <vector>
 #include <ext/optional>
@@ -54,6 +56,10 @@ private:
     std::vector<std::pair<std::string, std::string>> _copies;
     std::unique_ptr<plist::Dictionary> _additionalInfo;
 
+private:
+    std::unordered_map<std::string, uint16_t> _facetIdentifiers;
+    std::unique_ptr<Incremental>       _incremental;
+
 private:
     std::vector<std::string>           _inputs;
     std::vector<std::string>           _outputs;
@@ -116,6 +122,21 @@ public:
     plist::Dictionary *additionalInfo()
     { return _additionalInfo.get(); }
 
+public:
+    /*
+     * The identifier of the facet with a name in the compiled archive, and
+     * if it is new. Identifiers are allocated in order, starting from one.
+     */
+    std::pair<uint16_t, bool> facetIdentifier(std::string const &name);
+
+    /*
+     * If compiling incrementally, the state from the previous compile.
+     */
+    std::unique_ptr<Incremental> const &incremental() const
+    { return _incremental; }
+    std::unique_ptr<Incremental> &incremental()
+    { return _incremental; }
+
 public:
     /*
      * Files that were read in as input.
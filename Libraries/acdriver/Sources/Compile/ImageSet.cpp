@@ -9,6 +9,7 @@
 
 #include <acdriver/Compile/ImageSet.h>
 #include <acdriver/Compile/Convert.h>
+#include <acdriver/Compile/Incremental.h>
 #include <acdriver/Compile/Output.h>
 #include <acdriver/Result.h>
 #include <graphics/PixelFormat.h>
@@ -16,13 +17,14 @@
 #include <xcassets/Asset/ImageSet.h>
 #include <xcassets/Slot/Idiom.h>
 #include <car/Facet.h>
+#include <car/Reader.h>
 #include <car/Rendition.h>
 #include <car/Writer.h>
+#include <car/car_format.h>
 #include <libutil/Filesystem.h>
 #include <libutil/FSUtil.h>
 
 #include <algorithm>
-#include <map>
 #include <string>
 
 using acdriver::Compile::ImageSet;
@@ -32,6 +34,59 @@ using acdriver::Result;
 using libutil::Filesystem;
 using libutil::FSUtil;
 
+/*
+ * Copy an unchanged image set's renditions from the previous archive. The
+ * facet is created at the same point as compiling it would, so facets are
+ * numbered the same as in a clean compile.
+ */
+static bool
+ImageSetReuse(xcassets::Asset::ImageSet const *imageSet, Output *compileOutput)
+{
+    std::string name = imageSet->name().string();
+    car::Reader const &previous = *compileOutput->incremental()->previous();
+
+    /* Compiling creates the facet for the first image with a file. */
+    bool compiled = false;
+    if (imageSet->images()) {
+        for (xcassets::Asset::ImageSet::Image const &image : *imageSet->images()) {
+            if (image.fileName() && !image.unassigned() && image.idiom()) {
+                compiled = true;
+                break;
+            }
+        }
+    }
+    if (!compiled) {
+        return true;
+    }
+
+    ext::optional<car::Facet> facet = previous.lookupFacet(name);
+    if (!facet) {
+        return false;
+    }
+
+    uint16_t facetIdentifier = compileOutput->facetIdentifier(name).first;
+    compileOutput->car()->addFacet(car::Facet::Create(name, car::AttributeList({
+        { car_attribute_identifier_identifier, facetIdentifier },
+    })));
+
+    struct car_key_format *keyfmt = previous.keyfmt();
+    previous.renditionFastIterate(*facet, [&](void *key, size_t key_len, void *value, size_t value_len) {
+        car::AttributeList previousAttributes = car::AttributeList::Load(keyfmt->num_identifiers, keyfmt->identifier_list, static_cast<car_rendition_key *>(key));
+
+        /* Only the attributes compiling sets, as the key format can change. */
+        car::AttributeList attributes = car::AttributeList({
+            { car_attribute_identifier_idiom, previousAttributes.get(car_attribute_identifier_idiom).value_or(0) },
+            { car_attribute_identifier_scale, previousAttributes.get(car_attribute_identifier_scale).value_or(0) },
+            { car_attribute_identifier_identifier, facetIdentifier },
+        });
+
+        compileOutput->car()->addRendition(attributes, value, value_len);
+    });
+
+    compileOutput->incremental()->reuse();
+    return true;
+}
+
 bool ImageSet::
 Compile(
     xcassets::Asset::ImageSet const *imageSet,
@@ -41,6 +96,14 @@ Compile(
 {
     bool success = true;
 
+    std::string name = imageSet->name().string();
+    Incremental *incremental = compileOutput->incremental().get();
+    if (incremental != nullptr && incremental->unchanged(name)) {
+        if (ImageSetReuse(imageSet, compileOutput)) {
+            return true;
+        }
+    }
+
     if (imageSet->images()) {
         for (xcassets::Asset::ImageSet::Image const &image : *imageSet->images()) {
             if (!CompileAsset(imageSet, image, filesystem, compileOutput, result)) {
@@ -49,14 +112,11 @@ Compile(
         }
     }
 
-    return success;
-}
+    if (!success && incremental != nullptr) {
+        incremental->invalidate(name);
+    }
 
-static uint16_t
-GenerateIdentifier(void) {
-    static uint16_t last = 0;
-    last = last + 1;
-    return last;
+    return success;
 }
 
 bool ImageSet::
@@ -67,8 +127,6 @@ CompileAsset(
     Output *compileOutput,
     Result *result)
 {
-    static std::map<std::string, uint16_t> idMap = {};
-
     /* Skip any entry that is not attached to a file, or is explicitly unassigned. */
     if (!image.fileName() || image.unassigned()) {
         return true;
@@ -158,17 +216,9 @@ CompileAsset(
         return false;
     }
 
-    bool createFacet = false;
-    uint16_t facetIdentifier = 0;
-    auto it = idMap.find(name);
-    if (it == idMap.end()) {
-        facetIdentifier = GenerateIdentifier();
-        idMap[name] = facetIdentifier;
-        createFacet = true;
-    } else {
-        facetIdentifier = it->second;
-    }
-    if (createFacet) {
+    std::pair<uint16_t, bool> identifier = compileOutput->facetIdentifier(name);
+    uint16_t facetIdentifier = identifier.first;
+    if (identifier.second) {
         car::AttributeList attributes = car::AttributeList({
             { car_attribute_identifier_identifier, facetIdentifier },
         });
@@ -0,0 +1,194 @@
+/**
+ Copyright (c) 2015-present, Facebook, Inc.
+ All rights reserved.
+
+ This source code is licensed under the BSD-style license found in the
+ LICENSE file in the root directory of this source tree. An additional grant
+ of patent rights can be found in the PATENTS file in the same directory.
+ */
+
+#include <acdriver/Compile/Incremental.h>
+#include <acdriver/Version.h>
+#include <xcassets/Asset/Asset.h>
+#include <xcassets/Asset/ImageSet.h>
+#include <bom/bom.h>
+#include <libutil/Filesystem.h>
+#include <libutil/FSUtil.h>
+
+using acdriver::Compile::Incremental;
+using acdriver::Version;
+using libutil::Filesystem;
+using libutil::FSUtil;
+
+/*
+ * The BOM tree holding fingerprints, from image set name to hash.
+ */
+static char const *const IncrementalFingerprintsVariable = "FINGERPRINTS";
+
+Incremental::
+Incremental() :
+    _reused(0)
+{
+}
+
+static void
+IncrementalFingerprintFile(Filesystem const *filesystem, std::string const &name, std::string const &path, libutil::Hash::Stream *stream)
+{
+    uint64_t size = 0;
+    libutil::Hash::Stream contents;
+    bool read = filesystem->readContents(path, [&](uint8_t const *data, size_t length) {
+        contents.update(data, length);
+        size += length;
+    });
+
+    /* Separate the name and contents so no two inputs hash the same. */
+    stream->update(name.c_str(), name.size() + 1);
+    if (read) {
+        libutil::Hash hash = contents.finish();
+        uint64_t digest[3] = { size, hash.low(), hash.high() };
+        stream->update(digest, sizeof(digest));
+    } else {
+        stream->update("", 1);
+    }
+}
+
+static libutil::Hash
+IncrementalFingerprintImageSet(Filesystem const *filesystem, xcassets::Asset::ImageSet const *imageSet)
+{
+    libutil::Hash::Stream stream;
+
+    /* Changes to how assets are compiled change the output. */
+    int version = Version::BuildVersion();
+    stream.update(&version, sizeof(version));
+
+    IncrementalFingerprintFile(filesystem, "Contents.json", imageSet->path() + "/Contents.json", &stream);
+
+    if (imageSet->images()) {
+        for (xcassets::Asset::ImageSet::Image const &image : *imageSet->images()) {
+            if (image.fileName()) {
+                std::string filename = FSUtil::ResolveRelativePath(*image.fileName(), imageSet->path());
+                IncrementalFingerprintFile(filesystem, *image.fileName(), filename, &stream);
+            }
+        }
+    }
+
+    return stream.finish();
+}
+
+void Incremental::
+fingerprint(Filesystem const *filesystem, xcassets::Asset::Asset const *asset)
+{
+    if (asset->type() == xcassets::Asset::AssetType::ImageSet) {
+        auto imageSet = static_cast<xcassets::Asset::ImageSet const *>(asset);
+        std::string name = imageSet->name().string();
+
+        if (_duplicates.find(name) == _duplicates.end()) {
+            if (_fingerprints.find(name) != _fingerprints.end()) {
+                _fingerprints.erase(name);
+                _duplicates.insert(name);
+            } else {
+                _fingerprints.insert({ name, IncrementalFingerprintImageSet(filesystem, imageSet) });
+            }
+        }
+    }
+
+    for (auto const &child : asset->children()) {
+        fingerprint(filesystem, child.get());
+    }
+}
+
+bool Incremental::
+unchanged(std::string const &name) const
+{
+    if (!_previous) {
+        return false;
+    }
+
+    auto it = _fingerprints.find(name);
+    if (it == _fingerprints.end()) {
+        return false;
+    }
+
+    auto previous = _previousFingerprints.find(name);
+    return (previous != _previousFingerprints.end() && previous->second == it->second);
+}
+
+void Incremental::
+reuse()
+{
+    _reused++;
+}
+
+void Incremental::
+invalidate(std::string const &name)
+{
+    _fingerprints.erase(name);
+}
+
+void Incremental::
+write(struct bom_context *bom) const
+{
+    struct bom_tree_context *tree = bom_tree_alloc_empty(bom, IncrementalFingerprintsVariable);
+    if (tree == NULL) {
+        return;
+    }
+
+    bom_tree_reserve(tree, _fingerprints.size());
+    for (auto const &entry : _fingerprints) {
+        std::string hex = entry.second.hex();
+        bom_tree_add(tree, entry.first.data(), entry.first.size(), hex.data(), hex.size());
+    }
+
+    bom_tree_free(tree);
+}
+
+static void
+IncrementalLoadFingerprint(struct bom_tree_context *tree, void *key, size_t key_len, void *value, size_t value_len, void *ctx)
+{
+    auto fingerprints = static_cast<std::unordered_map<std::string, libutil::Hash> *>(ctx);
+
+    std::string name = std::string(static_cast<char const *>(key), key_len);
+    if (auto hash = libutil::Hash::Parse(std::string(static_cast<char const *>(value), value_len))) {
+        fingerprints->insert({ name, *hash });
+    }
+}
+
+std::unique_ptr<Incremental> Incremental::
+Load(Filesystem const *filesystem, std::string const &path)
+{
+    auto incremental = std::unique_ptr<Incremental>(new Incremental());
+
+    if (!filesystem->isReadable(path)) {
+        return incremental;
+    }
+
+    std::unique_ptr<Filesystem::Mapping> mapping = filesystem->map(path);
+    if (mapping == nullptr) {
+        return incremental;
+    }
+
+    /* Copy the archive: the new archive is written over it. */
+    struct bom_context_memory memory = bom_context_memory(mapping->data(), mapping->size());
+    mapping.reset();
+
+    auto bom = car::Reader::unique_ptr_bom(bom_alloc_load(memory), bom_free);
+    if (bom == nullptr) {
+        return incremental;
+    }
+
+    ext::optional<car::Reader> reader = car::Reader::Load(std::move(bom));
+    if (!reader) {
+        return incremental;
+    }
+
+    struct bom_tree_context *tree = bom_tree_alloc_load(reader->bom(), IncrementalFingerprintsVariable);
+    if (tree == NULL) {
+        return incremental;
+    }
+
+    bom_tree_iterate(tree, IncrementalLoadFingerprint, &incremental->_previousFingerprints);
+    bom_tree_free(tree);
+
+    incremental->_previous = std::move(reader);
+    return incremental;
+}
@@ -38,6 +38,19 @@ Output(
 {
 }
 
+std::pair<uint16_t, bool> Output::
+facetIdentifier(std::string const &name)
+{
+    auto it = _facetIdentifiers.find(name);
+    if (it != _facetIdentifiers.end()) {
+        return { it->second, false };
+    }
+
+    uint16_t identifier = static_cast<uint16_t>(_facetIdentifiers.size() + 1);
+    _facetIdentifiers.insert({ name, identifier });
+    return { identifier, true };
+}
+
 std::string Output::
 AssetReference(xcassets::Asset::Asset const *asset)
 {
@@ -10,6 +10,7 @@
 #include <acdriver/CompileAction.h>
 #include <acdriver/Compile/Output.h>
 #include <acdriver/Compile/Asset.h>
+#include <acdriver/Compile/Incremental.h>
 #include <acdriver/Version.h>
 #include <acdriver/Options.h>
 #include <acdriver/Output.h>
@@ -64,6 +65,24 @@ WriteOutput(Filesystem *filesystem, Options const &options, Compile::Output cons
     if (compileOutput.car()) {
         // TODO: only write if non-empty. but did mmap already create the file?
         compileOutput.car()->write();
+
+        if (compileOutput.incremental()) {
+            compileOutput.incremental()->write(compileOutput.car()->bom());
+
+            if (compileOutput.incremental()->reused() > 0) {
+                result->normal(
+                    Result::Severity::Notice,
+                    std::to_string(compileOutput.incremental()->reused()) + " unchanged image sets copied from the previous archive");
+            }
+        }
+
+        car::Writer::Statistics const &statistics = compileOutput.car()->statistics();
+        if (statistics.deduplicated > 0) {
+            result->normal(
+                Result::Severity::Notice,
+                std::to_string(statistics.deduplicated) + " of " + std::to_string(statistics.renditions) +
+                " renditions shared identical contents, saving " + std::to_string(statistics.deduplicatedBytes) + " bytes");
+        }
     }
 
     /*
@@ -226,10 +245,6 @@ WarnUnsupportedOptions(Options const &options, Result *result)
         result->normal(Result::Severity::Warning, "on-demand resources not supported");
     }
 
-    if (options.enableIncrementalDistill()) {
-        result->normal(Result::Severity::Warning, "incremental distill not supported");
-    }
-
     if (options.filterForDeviceModel()) {
         result->normal(Result::Severity::Warning, "filter device model not supported");
     }
@@ -270,6 +285,13 @@ run(Filesystem *filesystem, Options const &options, Output *output, Result *resu
         std::string outputFilename = options.compileOutputFilename().value_or("Assets.car");
         std::string path = compileOutput.root() + "/" + outputFilename;
 
+        /*
+         * Read what can be reused before the archive is replaced.
+         */
+        if (options.enableIncrementalDistill()) {
+            compileOutput.incremental() = Compile::Incremental::Load(filesystem, path);
+        }
+
         ext::optional<car::Writer> writer = CreateWriter(path);
         if (!writer) {
             result->normal(Result::Severity::Error, "unable to create compiled asset writer");
@@ -282,12 +304,10 @@ run(Filesystem *filesystem, Options const &options, Output *output, Result *resu
     }
 
     /*
-     * Compile each asset catalog into the output.
+     * Load the input asset catalogs.
      */
+    std::vector<std::pair<std::string, std::unique_ptr<xcassets::Asset::Catalog>>> catalogs;
     for (std::string const &input : options.inputs()) {
-        /*
-         * Load the input asset catalog.
-         */
         auto catalog = xcassets::Asset::Catalog::Load(filesystem, input);
         if (catalog == nullptr) {
             result->normal(
@@ -298,15 +318,29 @@ run(Filesystem *filesystem, Options const &options, Output *output, Result *resu
             continue;
         }
 
-        /*
-         * Compile the asset catalog.
-         */
-        if (!Compile::Asset::Compile(catalog.get(), filesystem, &compileOutput, result)) {
+        catalogs.push_back({ input, std::move(catalog) });
+    }
+
+    /*
+     * Fingerprint every catalog before compiling, as image sets in
+     * different catalogs can share a name.
+     */
+    if (compileOutput.incremental()) {
+        for (auto const &catalog : catalogs) {
+            compileOutput.incremental()->fingerprint(filesystem, catalog.second.get());
+        }
+    }
+
+    /*
+     * Compile each asset catalog into the output.
+     */
+    for (auto const &catalog : catalogs) {
+        if (!Compile::Asset::Compile(catalog.second.get(), filesystem, &compileOutput, result)) {
             /* Error already printed. */
             continue;
         }
 
-        compileOutput.inputs().push_back(input);
+        compileOutput.inputs().push_back(catalog.first);
     }
 
     /*
@@ -317,4 +351,3 @@ run(Filesystem *filesystem, Options const &options, Output *output, Result *resu
         return;
     }
 }
-
@@ -0,0 +1,200 @@
+/**
+ Copyright (c) 2015-present, Facebook, Inc.
+ All rights reserved.
+
+ This source code is licensed under the BSD-style license found in the
+ LICENSE file in the root directory of this source tree. An additional grant
+ of patent rights can be found in the PATENTS file in the same directory.
+ */
+
+#include <gtest/gtest.h>
+#include <acdriver/CompileAction.h>
+#include <acdriver/Options.h>
+#include <acdriver/Output.h>
+#include <acdriver/Result.h>
+#include <graphics/Image.h>
+#include <graphics/PixelFormat.h>
+#include <graphics/Format/PNG.h>
+#include <bom/bom.h>
+#include <car/Facet.h>
+#include <car/Reader.h>
+#include <car/Rendition.h>
+#include <car/car_format.h>
+#include <libutil/DefaultFilesystem.h>
+
+#include <cstddef>
+#include <cstdlib>
+
+using acdriver::CompileAction;
+using acdriver::Options;
+using acdriver::Output;
+using acdriver::Result;
+using libutil::DefaultFilesystem;
+
+#if !_WIN32
+
+static std::vector<uint8_t>
+Contents(std::string const &string)
+{
+    return std::vector<uint8_t>(string.begin(), string.end());
+}
+
+static std::vector<uint8_t>
+ImageContents(size_t size, uint8_t seed)
+{
+    std::vector<uint8_t> pixels;
+    for (size_t i = 0; i < size * size; i++) {
+        pixels.push_back(static_cast<uint8_t>(seed + i));
+        pixels.push_back(static_cast<uint8_t>(seed * 3 + i / size));
+        pixels.push_back(seed);
+    }
+
+    graphics::PixelFormat format = graphics::PixelFormat(
+        graphics::PixelFormat::Color::RGB,
+        graphics::PixelFormat::Order::Forward,
+        graphics::PixelFormat::Alpha::None);
+    auto png = graphics::Format::PNG::Write(graphics::Image(size, size, format, pixels));
+    return png.first.value_or(std::vector<uint8_t>());
+}
+
+/*
+ * Write an image set with a 1x and a 2x image.
+ */
+static bool
+WriteImageSet(DefaultFilesystem *filesystem, std::string const &catalog, std::string const &name, uint8_t seed)
+{
+    std::string path = catalog + "/" + name + ".imageset";
+    return filesystem->createDirectory(path, true) &&
+        filesystem->write(Contents(
+            "{ \"images\" : ["
+            "{ \"idiom\" : \"universal\", \"filename\" : \"image.png\", \"scale\" : \"1x\" },"
+            "{ \"idiom\" : \"universal\", \"filename\" : \"image@2x.png\", \"scale\" : \"2x\" }"
+            "], \"info\" : { \"version\" : 1, \"author\" : \"xcode\" } }"), path + "/Contents.json") &&
+        filesystem->write(ImageContents(4, seed), path + "/image.png") &&
+        filesystem->write(ImageContents(8, seed), path + "/image@2x.png");
+}
+
+static std::string
+CreateCatalog(DefaultFilesystem *filesystem)
+{
+    char directory[] = "/tmp/acdriver-CompileAction-XXXXXX";
+    if (mkdtemp(directory) == nullptr) {
+        return std::string();
+    }
+
+    std::string root = directory;
+    std::string catalog = root + "/Assets.xcassets";
+    if (!filesystem->createDirectory(catalog, true) ||
+        !filesystem->write(Contents("{ \"info\" : { \"version\" : 1, \"author\" : \"xcode\" } }"), catalog + "/Contents.json") ||
+        !WriteImageSet(filesystem, catalog, "First", 1) ||
+        !WriteImageSet(filesystem, catalog, "Second", 2) ||
+        !WriteImageSet(filesystem, catalog, "Third", 3) ||
+        !WriteImageSet(filesystem, catalog, "Fourth", 4)) {
+        return std::string();
+    }
+
+    return root;
+}
+
+/*
+ * Compile a catalog, returning the notices.
+ */
+static std::string
+Compile(DefaultFilesystem *filesystem, std::string const &catalog, std::string const &output)
+{
+    filesystem->createDirectory(output, true);
+
+    Options options;
+    auto parse = libutil::Options::Parse<Options>(&options, {
+        "--compile", output,
+        "--minimum-deployment-target", "10.0",
+        "--enable-incremental-distill",
+        catalog,
+    });
+    EXPECT_TRUE(parse.first);
+
+    Output out;
+    Result result;
+    CompileAction().run(filesystem, options, &out, &result);
+    EXPECT_TRUE(result.success());
+
+    return result.normalText(Result::Severity::Notice).value_or(std::string());
+}
+
+/*
+ * Read a compiled archive, without the time it was created.
+ */
+static std::vector<uint8_t>
+ReadArchive(DefaultFilesystem *filesystem, std::string const &path)
+{
+    std::vector<uint8_t> contents;
+    EXPECT_TRUE(filesystem->read(&contents, path));
+
+    struct bom_context *bom = bom_alloc_load(bom_context_memory(contents.data(), contents.size()));
+    EXPECT_NE(nullptr, bom);
+    if (bom == nullptr) {
+        return contents;
+    }
+
+    int header_index = bom_variable_get(bom, car_header_variable);
+    uint8_t const *header = static_cast<uint8_t const *>(bom_index_get(bom, header_index, NULL));
+    EXPECT_NE(nullptr, header);
+    if (header != nullptr) {
+        size_t offset = (header - static_cast<uint8_t const *>(bom_memory(bom)->data)) + offsetof(struct car_header, storage_timestamp);
+        memset(&contents[offset], 0, sizeof(uint32_t));
+    }
+
+    bom_free(bom);
+    return contents;
+}
+
+TEST(CompileAction, Incremental)
+{
+    DefaultFilesystem filesystem;
+    std::string root = CreateCatalog(&filesystem);
+    ASSERT_FALSE(root.empty());
+    std::string catalog = root + "/Assets.xcassets";
+
+    /* Nothing to reuse the first time. */
+    std::string notices = Compile(&filesystem, catalog, root + "/Incremental");
+    EXPECT_EQ(std::string::npos, notices.find("copied from the previous archive"));
+
+    /* Compiling again without changes reuses everything. */
+    notices = Compile(&filesystem, catalog, root + "/Incremental");
+    EXPECT_NE(std::string::npos, notices.find("4 unchanged image sets copied from the previous archive"));
+
+    std::vector<uint8_t> unchanged = ReadArchive(&filesystem, root + "/Incremental/Assets.car");
+    Compile(&filesystem, catalog, root + "/Clean");
+    EXPECT_TRUE(unchanged == ReadArchive(&filesystem, root + "/Clean/Assets.car"));
+
+    /* Edit an image, add an image set, and remove one. */
+    ASSERT_TRUE(filesystem.write(ImageContents(8, 20), catalog + "/Second.imageset/image@2x.png"));
+    ASSERT_TRUE(WriteImageSet(&filesystem, catalog, "Fifth", 5));
+    ASSERT_TRUE(WriteImageSet(&filesystem, catalog, "Alpha", 6));
+    ASSERT_TRUE(filesystem.removeDirectory(catalog + "/Third.imageset", true));
+
+    notices = Compile(&filesystem, catalog, root + "/Incremental");
+    EXPECT_NE(std::string::npos, notices.find("2 unchanged image sets copied from the previous archive"));
+
+    /* The same as compiling from scratch. */
+    ASSERT_TRUE(filesystem.removeDirectory(root + "/Clean", true));
+    Compile(&filesystem, catalog, root + "/Clean");
+
+    std::vector<uint8_t> incremental = ReadArchive(&filesystem, root + "/Incremental/Assets.car");
+    std::vector<uint8_t> clean = ReadArchive(&filesystem, root + "/Clean/Assets.car");
+    EXPECT_EQ(clean.size(), incremental.size());
+    EXPECT_TRUE(clean == incremental);
+
+    /* Every image set is there, with the edited image. */
+    auto reader = car::Reader::Open(root + "/Incremental/Assets.car");
+    ASSERT_TRUE(reader);
+    EXPECT_EQ(5, reader->facetCount());
+    EXPECT_EQ(10, reader->renditionCount());
+    EXPECT_FALSE(reader->lookupFacet("Third"));
+    ASSERT_TRUE(reader->lookupFacet("Alpha"));
+    ASSERT_TRUE(reader->lookupFacet("Second"));
+
+    EXPECT_TRUE(filesystem.removeDirectory(root, true));
+}
+
+#endif
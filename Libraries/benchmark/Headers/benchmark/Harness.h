@@ -0,0 +1,122 @@
+/**
+ Copyright (c) 2015-present, Facebook, Inc.
+ All rights reserved.
+
+ This source code is licensed under the BSD-style license found in the
+ LICENSE file in the root directory of this source tree. An additional grant
+ of patent rights can be found in the PATENTS file in the same directory.
+ */
+
+#ifndef __benchmark_Harness_h
+#define __benchmark_Harness_h
+
+#include <functional>
+#include <string>
+#include <vector>
+
+#include <cstdint>
+#include <cstdio>
+
+namespace benchmark {
+
+/*
+ * Measures named stages of a benchmark. Each stage records its wall time
+ * and the peak resident memory of the process once the stage completes.
+ */
+class Harness {
+public:
+    /*
+     * The measurements of a single stage.
+     */
+    class Result {
+    private:
+        std::string _stage;
+        bool        _success;
+        double      _seconds;
+        uint64_t    _peakResidentBytes;
+
+    public:
+        Result(std::string const &stage, bool success, double seconds, uint64_t peakResidentBytes);
+
+    public:
+        /*
+         * The name of the stage.
+         */
+        std::string const &stage() const
+        { return _stage; }
+
+        /*
+         * If the stage completed successfully.
+         */
+        bool success() const
+        { return _success; }
+
+        /*
+         * Wall time spent in the stage.
+         */
+        double seconds() const
+        { return _seconds; }
+
+        /*
+         * Peak resident memory of the process after the stage. Zero if
+         * the platform does not support measuring resident memory.
+         */
+        uint64_t peakResidentBytes() const
+        { return _peakResidentBytes; }
+    };
+
+private:
+    std::string         _name;
+    std::vector<Result> _results;
+
+public:
+    explicit Harness(std::string const &name);
+    ~Harness();
+
+public:
+    /*
+     * The name of the benchmark.
+     */
+    std::string const &name() const
+    { return _name; }
+
+    /*
+     * The stages measured so far.
+     */
+    std::vector<Result> const &results() const
+    { return _results; }
+
+public:
+    /*
+     * Run and measure a stage. Returns the result of the stage.
+     */
+    bool stage(std::string const &name, std::function<bool()> const &function);
+
+public:
+    /*
+     * Print the measured stages in a human-readable table.
+     */
+    void report(FILE *file) const;
+
+    /*
+     * Print the measured stages as comma separated values, suitable to
+     * compare across runs. Each line is prefixed with the benchmark name.
+     */
+    void reportCSV(FILE *file, bool header) const;
+
+public:
+    /*
+     * The peak resident memory of this process, in bytes.
+     */
+    static uint64_t PeakResidentBytes();
+
+    /*
+     * Reset the peak resident memory to the current resident memory, if
+     * supported, so later stages do not include memory from earlier ones.
+     */
+    static bool ResetPeakResidentBytes();
+};
+
+}
+
+#endif // !__benchmark_Harness_h
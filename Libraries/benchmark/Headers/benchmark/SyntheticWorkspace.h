@@ -0,0 +1,140 @@
+/**
+ Copyright (c) 2015-present, Facebook, Inc.
+ All rights reserved.
+
+ This source code is licensed under the BSD-style license found in the
+ LICENSE file in the root directory of this source tree. An additional grant
+ of patent rights can be found in the PATENTS file in the same directory.
+ */
+
+#ifndef __benchmark_SyntheticWorkspace_h
+#define __benchmark_SyntheticWorkspace_h
+
+#include <string>
+#include <vector>
+
+namespace libutil { class Filesystem; }
+
+namespace benchmark {
+
+/*
+ * Generates a synthetic workspace for benchmarking the build pipeline. The
+ * workspace contains a number of projects, each with a number of static
+ * library targets, along with a minimal developer directory to build them.
+ */
+class SyntheticWorkspace {
+public:
+    /*
+     * The shape of the generated workspace.
+     */
+    class Parameters {
+    private:
+        size_t _projects;
+        size_t _targets;
+        size_t _filesPerTarget;
+        size_t _xcconfigDepth;
+        size_t _crossProjectDependencies;
+
+    public:
+        Parameters(
+            size_t projects,
+            size_t targets,
+            size_t filesPerTarget,
+            size_t xcconfigDepth,
+            size_t crossProjectDependencies);
+
+    public:
+        /*
+         * Number of projects in the workspace.
+         */
+        size_t projects() const
+        { return _projects; }
+
+        /*
+         * Number of targets in each project.
+         */
+        size_t targets() const
+        { return _targets; }
+
+        /*
+         * Number of source files in each target.
+         */
+        size_t filesPerTarget() const
+        { return _filesPerTarget; }
+
+        /*
+         * Depth of the chain of included configuration files.
+         */
+        size_t xcconfigDepth() const
+        { return _xcconfigDepth; }
+
+        /*
+         * Number of dependencies from each target on targets in other projects.
+         */
+        size_t crossProjectDependencies() const
+        { return _crossProjectDependencies; }
+    };
+
+private:
+    Parameters  _parameters;
+    std::string _root;
+
+public:
+    SyntheticWorkspace(Parameters const &parameters, std::string const &root);
+
+public:
+    /*
+     * The shape of the workspace.
+     */
+    Parameters const &parameters() const
+    { return _parameters; }
+
+    /*
+     * The directory containing everything generated.
+     */
+    std::string const &root() const
+    { return _root; }
+
+public:
+    /*
+     * Path to the generated developer directory.
+     */
+    std::string developerRoot() const;
+
+    /*
+     * Path to the generated workspace.
+     */
+    std::string workspacePath() const;
+
+    /*
+     * Name of the shared scheme building every target.
+     */
+    std::string schemeName() const;
+
+    /*
+     * Path to a placeholder build tool executable. Tools the build expects
+     * to find next to the build tool, like `dependency-info-tool`, are
+     * also generated in this directory.
+     */
+    std::string executablePath() const;
+
+    /*
+     * Path to a directory for build products.
+     */
+    std::string derivedDataPath() const;
+
+public:
+    /*
+     * Write the workspace into a filesystem. The build specifications from
+     * `specificationsPath` in `specificationsFilesystem` are copied into the
+     * generated developer directory.
+     */
+    bool write(
+        libutil::Filesystem *filesystem,
+        libutil::Filesystem const *specificationsFilesystem,
+        std::string const &specificationsPath) const;
+};
+
+}
+
+#endif // !__benchmark_SyntheticWorkspace_h
@@ -0,0 +1,160 @@
+/**
+ Copyright (c) 2015-present, Facebook, Inc.
+ All rights reserved.
+
+ This source code is licensed under the BSD-style license found in the
+ LICENSE file in the root directory of this source tree. An additional grant
+ of patent rights can be found in the PATENTS file in the same directory.
+ */
+
+#include <benchmark/Harness.h>
+
+#include <chrono>
+#include <cstring>
+
+#if _WIN32
+#include <windows.h>
+#include <psapi.h>
+#else
+#include <sys/resource.h>
+#endif
+
+using benchmark::Harness;
+
+Harness::Result::
+Result(std::string const &stage, bool success, double seconds, uint64_t peakResidentBytes) :
+    _stage            (stage),
+    _success          (success),
+    _seconds          (seconds),
+    _peakResidentBytes(peakResidentBytes)
+{
+}
+
+Harness::
+Harness(std::string const &name) :
+    _name(name)
+{
+}
+
+Harness::
+~Harness()
+{
+}
+
+bool Harness::
+stage(std::string const &name, std::function<bool()> const &function)
+{
+    ResetPeakResidentBytes();
+
+    auto start = std::chrono::steady_clock::now();
+    bool success = function();
+    auto end = std::chrono::steady_clock::now();
+
+    double seconds = std::chrono::duration<double>(end - start).count();
+    _results.push_back(Result(name, success, seconds, PeakResidentBytes()));
+
+    if (!success) {
+        fprintf(stderr, "error: benchmark stage '%s' failed\n", name.c_str());
+    }
+
+    return success;
+}
+
+void Harness::
+report(FILE *file) const
+{
+    fprintf(file, "%s\n", _name.c_str());
+    fprintf(file, "  %-40s %12s %14s\n", "stage", "time (ms)", "peak RSS (MB)");
+
+    for (Result const &result : _results) {
+        fprintf(file, "  %-40s %12.2f %14.1f%s\n",
+            result.stage().c_str(),
+            result.seconds() * 1000.0,
+            static_cast<double>(result.peakResidentBytes()) / (1024.0 * 1024.0),
+            result.success() ? "" : " (failed)");
+    }
+}
+
+void Harness::
+reportCSV(FILE *file, bool header) const
+{
+    if (header) {
+        fprintf(file, "benchmark,stage,success,seconds,peak_resident_bytes\n");
+    }
+
+    for (Result const &result : _results) {
+        fprintf(file, "%s,%s,%d,%.6f,%llu\n",
+            _name.c_str(),
+            result.stage().c_str(),
+            result.success() ? 1 : 0,
+            result.seconds(),
+            static_cast<unsigned long long>(result.peakResidentBytes()));
+    }
+}
+
+uint64_t Harness::
+PeakResidentBytes()
+{
+#if _WIN32
+    PROCESS_MEMORY_COUNTERS counters;
+    if (!GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters))) {
+        return 0;
+    }
+    return static_cast<uint64_t>(counters.PeakWorkingSetSize);
+#else
+#if defined(__linux__)
+    /*
+     * Prefer the high water mark from procfs: unlike `getrusage()`, it
+     * respects a reset through `clear_refs`.
+     */
+    if (FILE *status = fopen("/proc/self/status", "r")) {
+        char line[256];
+        unsigned long long kilobytes = 0;
+        bool found = false;
+        while (fgets(line, sizeof(line), status) != nullptr) {
+            if (strncmp(line, "VmHWM:", 6) == 0) {
+                found = (sscanf(line + 6, "%llu", &kilobytes) == 1);
+                break;
+            }
+        }
+        fclose(status);
+
+        if (found) {
+            return static_cast<uint64_t>(kilobytes) * 1024;
+        }
+    }
+#endif
+
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) != 0) {
+        return 0;
+    }
+
+#if defined(__APPLE__)
+    /* Darwin reports bytes. */
+    return static_cast<uint64_t>(usage.ru_maxrss);
+#else
+    /* Other platforms report kilobytes. */
+    return static_cast<uint64_t>(usage.ru_maxrss) * 1024;
+#endif
+#endif
+}
+
+bool Harness::
+ResetPeakResidentBytes()
+{
+#if defined(__linux__)
+    /* Writing "5" resets the peak resident set size (Linux 4.0+). */
+    FILE *clear = fopen("/proc/self/clear_refs", "w");
+    if (clear == nullptr) {
+        return false;
+    }
+
+    bool success = (fputs("5", clear) >= 0);
+    fclose(clear);
+    return success;
+#else
+    /* Not supported: the peak includes memory from previous stages. */
+    return false;
+#endif
+}
@@ -0,0 +1,572 @@
+/**
+ Copyright (c) 2015-present, Facebook, Inc.
+ All rights reserved.
+
+ This source code is licensed under the BSD-style license found in the
+ LICENSE file in the root directory of this source tree. An additional grant
+ of patent rights can be found in the PATENTS file in the same directory.
+ */
+
+#include <benchmark/SyntheticWorkspace.h>
+#include <libutil/Filesystem.h>
+#include <libutil/FSUtil.h>
+#include <libutil/Permissions.h>
+
+#include <cstdio>
+
+using benchmark::SyntheticWorkspace;
+using libutil::Filesystem;
+using libutil::FSUtil;
+using libutil::Permissions;
+
+SyntheticWorkspace::Parameters::
+Parameters(
+    size_t projects,
+    size_t targets,
+    size_t filesPerTarget,
+    size_t xcconfigDepth,
+    size_t crossProjectDependencies) :
+    _projects                (projects),
+    _targets                 (targets),
+    _filesPerTarget          (filesPerTarget),
+    _xcconfigDepth           (xcconfigDepth),
+    _crossProjectDependencies(crossProjectDependencies)
+{
+}
+
+SyntheticWorkspace::
+SyntheticWorkspace(Parameters const &parameters, std::string const &root) :
+    _parameters(parameters),
+    _root      (root)
+{
+}
+
+std::string SyntheticWorkspace::
+developerRoot() const
+{
+    return _root + "/Developer";
+}
+
+std::string SyntheticWorkspace::
+workspacePath() const
+{
+    return _root + "/Workspace/Bench.xcworkspace";
+}
+
+std::string SyntheticWorkspace::
+schemeName() const
+{
+    return "Bench";
+}
+
+std::string SyntheticWorkspace::
+executablePath() const
+{
+    return _root + "/bin/xcbuild";
+}
+
+std::string SyntheticWorkspace::
+derivedDataPath() const
+{
+    return _root + "/DerivedData";
+}
+
+/*
+ * Tools that the build expects to find, either next to the build tool or in
+ * the toolchain. Only their presence matters; they are never executed.
+ */
+static std::vector<std::string> const &
+BuildToolNames()
+{
+    static std::vector<std::string> const names = {
+        "dependency-info-tool",
+    };
+    return names;
+}
+
+static std::vector<std::string> const &
+ToolchainToolNames()
+{
+    static std::vector<std::string> const names = {
+        "clang",
+        "ld",
+        "libtool",
+    };
+    return names;
+}
+
+static std::string
+ProjectName(size_t project)
+{
+    return "Project" + std::to_string(project);
+}
+
+static std::string
+TargetName(size_t project, size_t target)
+{
+    return "P" + std::to_string(project) + "T" + std::to_string(target);
+}
+
+static std::string
+ProductName(size_t project, size_t target)
+{
+    return "lib" + TargetName(project, target) + ".a";
+}
+
+/*
+ * Object identifiers in project files are 24 hexadecimal digits. Generate
+ * them from the kind of object and its position so they are deterministic
+ * and unique across all projects in the workspace.
+ */
+enum class ObjectKind : unsigned int {
+    Project = 1,
+    ProjectConfigurationList,
+    ProjectConfiguration,
+    MainGroup,
+    ProductsGroup,
+    ConfigurationFileReference,
+    ProjectFileReference,
+    Target,
+    TargetConfigurationList,
+    TargetConfiguration,
+    ProductReference,
+    SourcesPhase,
+    FrameworksPhase,
+    SourceFileReference,
+    SourceBuildFile,
+    TargetDependency,
+    ContainerItemProxy,
+};
+
+static std::string
+ObjectID(ObjectKind kind, size_t project, size_t index = 0, size_t subindex = 0)
+{
+    char buffer[25];
+    snprintf(buffer, sizeof(buffer), "%02X%06X%08X%08X",
+        static_cast<unsigned int>(kind) & 0xFF,
+        static_cast<unsigned int>(project) & 0xFFFFFF,
+        static_cast<unsigned int>(index),
+        static_cast<unsigned int>(subindex));
+    return std::string(buffer);
+}
+
+static std::string
+Quote(std::string const &value)
+{
+    return "\"" + value + "\"";
+}
+
+static bool
+WriteFile(Filesystem *filesystem, std::string const &path, std::string const &contents, bool executable = false)
+{
+    if (!filesystem->createDirectory(FSUtil::GetDirectoryName(path), true)) {
+        fprintf(stderr, "error: unable to create directory for %s\n", path.c_str());
+        return false;
+    }
+
+    std::vector<uint8_t> data = std::vector<uint8_t>(contents.begin(), contents.end());
+    if (!filesystem->write(data, path)) {
+        fprintf(stderr, "error: unable to write %s\n", path.c_str());
+        return false;
+    }
+
+    if (executable) {
+        Permissions permissions = Permissions(
+            { Permissions::Permission::Read, Permissions::Permission::Write, Permissions::Permission::Execute },
+            { Permissions::Permission::Read, Permissions::Permission::Execute },
+            { Permissions::Permission::Read, Permissions::Permission::Execute });
+        if (!filesystem->writeFilePermissions(path, Permissions::Operation::Set, permissions)) {
+            fprintf(stderr, "error: unable to make %s executable\n", path.c_str());
+            return false;
+        }
+    }
+
+    return true;
+}
+
+static std::string
+PlatformInfo()
+{
+    return "{\n"
+        "    Identifier = \"com.apple.platform.macosx\";\n"
+        "    Name = macosx;\n"
+        "    Description = \"macOS\";\n"
+        "    FamilyIdentifier = macosx;\n"
+        "    FamilyName = \"macOS\";\n"
+        "    Version = \"1.1\";\n"
+        "    IsDeploymentPlatform = YES;\n"
+        "    DefaultProperties = {\n"
+        "        PLATFORM_NAME = macosx;\n"
+        "        EFFECTIVE_PLATFORM_NAME = \"\";\n"
+        "    };\n"
+        "}\n";
+}
+
+static std::string
+PlatformSpecifications()
+{
+    return "(\n"
+        "    {\n"
+        "        Type = Architecture;\n"
+        "        Identifier = Standard;\n"
+        "        Name = \"Standard Architectures\";\n"
+        "        RealArchitectures = ( x86_64 );\n"
+        "        ArchitectureSetting = ARCHS_STANDARD;\n"
+        "    },\n"
+        "    {\n"
+        "        Type = Architecture;\n"
+        "        Identifier = x86_64;\n"
+        "        Name = \"Intel 64-bit\";\n"
+        "        ByteOrder = little;\n"
+        "        ListInEnum = YES;\n"
+        "        SortNumber = 1;\n"
+        "    },\n"
+        "    {\n"
+        "        Type = PackageType;\n"
+        "        Identifier = \"com.apple.package-type.static-library\";\n"
+        "        Name = \"Mach-O Static Library\";\n"
+        "        DefaultBuildSettings = {\n"
+        "            EXECUTABLE_PREFIX = lib;\n"
+        "            EXECUTABLE_SUFFIX = \".a\";\n"
+        "            EXECUTABLE_NAME = \"$(EXECUTABLE_PREFIX)$(PRODUCT_NAME)$(EXECUTABLE_VARIANT_SUFFIX)$(EXECUTABLE_SUFFIX)\";\n"
+        "            EXECUTABLE_PATH = \"$(EXECUTABLE_NAME)\";\n"
+        "        };\n"
+        "        ProductReference = {\n"
+        "            FileType = archive.ar;\n"
+        "            Name = \"$(EXECUTABLE_NAME)\";\n"
+        "            IsLaunchable = NO;\n"
+        "        };\n"
+        "    },\n"
+        "    {\n"
+        "        Type = ProductType;\n"
+        "        Identifier = \"com.apple.product-type.library.static\";\n"
+        "        Name = \"Static Library\";\n"
+        "        DefaultTargetName = \"Static Library\";\n"
+        "        DefaultBuildProperties = {\n"
+        "            FULL_PRODUCT_NAME = \"$(EXECUTABLE_NAME)\";\n"
+        "            MACH_O_TYPE = staticlib;\n"
+        "            INSTALL_PATH = \"/usr/local/lib\";\n"
+        "        };\n"
+        "        PackageTypes = ( \"com.apple.package-type.static-library\" );\n"
+        "    },\n"
+        ")\n";
+}
+
+static std::string
+SDKSettings()
+{
+    return "{\n"
+        "    CanonicalName = macosx;\n"
+        "    DisplayName = \"macOS\";\n"
+        "    Version = \"1.0\";\n"
+        "    IsBaseSDK = YES;\n"
+        "    DefaultProperties = {\n"
+        "        PLATFORM_NAME = macosx;\n"
+        "    };\n"
+        "}\n";
+}
+
+static std::string
+ToolchainInfo()
+{
+    return "{\n"
+        "    Identifier = \"com.apple.dt.toolchain.XcodeDefault\";\n"
+        "}\n";
+}
+
+static std::string
+WorkspaceContents(size_t projects)
+{
+    std::string contents;
+    contents += "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n";
+    contents += "<Workspace version = \"1.0\">\n";
+    for (size_t p = 0; p < projects; p++) {
+        contents += "   <FileRef location = \"group:" + ProjectName(p) + "/" + ProjectName(p) + ".xcodeproj\">\n";
+        contents += "   </FileRef>\n";
+    }
+    contents += "</Workspace>\n";
+    return contents;
+}
+
+static std::string
+SchemeContents(SyntheticWorkspace::Parameters const &parameters)
+{
+    std::string contents;
+    contents += "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n";
+    contents += "<Scheme LastUpgradeVersion = \"0800\" version = \"1.3\">\n";
+    contents += "   <BuildAction parallelizeBuildables = \"YES\" buildImplicitDependencies = \"YES\">\n";
+    contents += "      <BuildActionEntries>\n";
+    for (size_t p = 0; p < parameters.projects(); p++) {
+        for (size_t t = 0; t < parameters.targets(); t++) {
+            contents += "         <BuildActionEntry buildForTesting = \"YES\" buildForRunning = \"YES\" buildForProfiling = \"YES\" buildForArchiving = \"YES\" buildForAnalyzing = \"YES\">\n";
+            contents += "            <BuildableReference BuildableIdentifier = \"primary\"";
+            contents += " BlueprintIdentifier = \"" + ObjectID(ObjectKind::Target, p, t) + "\"";
+            contents += " BuildableName = \"" + ProductName(p, t) + "\"";
+            contents += " BlueprintName = \"" + TargetName(p, t) + "\"";
+            contents += " ReferencedContainer = \"container:" + ProjectName(p) + "/" + ProjectName(p) + ".xcodeproj\">\n";
+            contents += "            </BuildableReference>\n";
+            contents += "         </BuildActionEntry>\n";
+        }
+    }
+    contents += "      </BuildActionEntries>\n";
+    contents += "   </BuildAction>\n";
+    contents += "</Scheme>\n";
+    return contents;
+}
+
+static std::string
+ConfigurationFileName(size_t depth)
+{
+    return "Level" + std::to_string(depth) + ".xcconfig";
+}
+
+static std::string
+ConfigurationFileContents(size_t depth, size_t xcconfigDepth)
+{
+    std::string contents;
+    if (depth + 1 < xcconfigDepth) {
+        contents += "#include \"" + ConfigurationFileName(depth + 1) + "\"\n\n";
+    }
+
+    std::string level = std::to_string(depth);
+    contents += "OTHER_CFLAGS = $(inherited) -DSYNTHETIC_LEVEL_" + level + "=1\n";
+    contents += "HEADER_SEARCH_PATHS = $(inherited) $(SRCROOT)/Include" + level + "\n";
+    contents += "GCC_PREPROCESSOR_DEFINITIONS[arch=x86_64] = $(inherited) SYNTHETIC_X86_64_" + level + "=1\n";
+    contents += "GCC_PREPROCESSOR_DEFINITIONS[config=Debug] = $(inherited) SYNTHETIC_DEBUG_" + level + "=1\n";
+    contents += "WARNING_CFLAGS[sdk=macosx*] = $(inherited) -Wno-level-" + level + "\n";
+    return contents;
+}
+
+static std::string
+SourceFileName(size_t target, size_t file)
+{
+    return "Sources/T" + std::to_string(target) + "/File" + std::to_string(file) + ".c";
+}
+
+static std::string
+SourceFileContents(size_t project, size_t target, size_t file)
+{
+    std::string name = "p" + std::to_string(project) + "_t" + std::to_string(target) + "_f" + std::to_string(file);
+    return "int " + name + "(int value) { return value + " + std::to_string(file) + "; }\n";
+}
+
+/*
+ * Targets in a project only depend on targets in lower numbered projects,
+ * so the dependency graph is always acyclic.
+ */
+static std::vector<size_t>
+CrossProjectDependencies(SyntheticWorkspace::Parameters const &parameters, size_t project)
+{
+    std::vector<size_t> projects;
+    for (size_t d = 1; d <= parameters.crossProjectDependencies() && d <= project; d++) {
+        projects.push_back(project - d);
+    }
+    return projects;
+}
+
+static std::string
+ProjectContents(SyntheticWorkspace::Parameters const &parameters, size_t p)
+{
+    std::string objects;
+
+    /* Project configurations. */
+    std::string projectID = ObjectID(ObjectKind::Project, p);
+    std::string projectConfigurationListID = ObjectID(ObjectKind::ProjectConfigurationList, p);
+    std::string projectConfigurationID = ObjectID(ObjectKind::ProjectConfiguration, p);
+    objects += "        " + projectConfigurationListID + " = { isa = XCConfigurationList; buildConfigurations = ( " + projectConfigurationID + " ); defaultConfigurationIsVisible = 0; defaultConfigurationName = Debug; };\n";
+    objects += "        " + projectConfigurationID + " = { isa = XCBuildConfiguration; buildSettings = { SDKROOT = macosx; ARCHS = x86_64; ONLY_ACTIVE_ARCH = YES; GCC_OPTIMIZATION_LEVEL = 0; }; name = Debug; };\n";
+
+    /* Groups. */
+    std::string mainGroupID = ObjectID(ObjectKind::MainGroup, p);
+    std::string productsGroupID = ObjectID(ObjectKind::ProductsGroup, p);
+
+    std::string mainGroupChildren;
+    std::string productsGroupChildren;
+
+    /* Chain of configuration files. */
+    for (size_t d = 0; d < parameters.xcconfigDepth(); d++) {
+        std::string configurationFileID = ObjectID(ObjectKind::ConfigurationFileReference, p, d);
+        objects += "        " + configurationFileID + " = { isa = PBXFileReference; lastKnownFileType = text.xcconfig; path = " + Quote("Config/" + ConfigurationFileName(d)) + "; sourceTree = \"<group>\"; };\n";
+        mainGroupChildren += configurationFileID + ", ";
+    }
+
+    /* References to other projects. */
+    std::vector<size_t> dependencyProjects = CrossProjectDependencies(parameters, p);
+    for (size_t q : dependencyProjects) {
+        std::string projectFileID = ObjectID(ObjectKind::ProjectFileReference, p, q);
+        std::string path = "../" + ProjectName(q) + "/" + ProjectName(q) + ".xcodeproj";
+        objects += "        " + projectFileID + " = { isa = PBXFileReference; lastKnownFileType = \"wrapper.pb-project\"; name = " + Quote(ProjectName(q) + ".xcodeproj") + "; path = " + Quote(path) + "; sourceTree = \"<group>\"; };\n";
+        mainGroupChildren += projectFileID + ", ";
+    }
+
+    std::string targets;
+    for (size_t t = 0; t < parameters.targets(); t++) {
+        std::string targetID = ObjectID(ObjectKind::Target, p, t);
+        std::string targetConfigurationListID = ObjectID(ObjectKind::TargetConfigurationList, p, t);
+        std::string targetConfigurationID = ObjectID(ObjectKind::TargetConfiguration, p, t);
+        std::string productReferenceID = ObjectID(ObjectKind::ProductReference, p, t);
+        std::string sourcesPhaseID = ObjectID(ObjectKind::SourcesPhase, p, t);
+        std::string frameworksPhaseID = ObjectID(ObjectKind::FrameworksPhase, p, t);
+
+        /* Target configuration, based on the head of the configuration file chain. */
+        std::string baseConfiguration;
+        if (parameters.xcconfigDepth() > 0) {
+            baseConfiguration = "baseConfigurationReference = " + ObjectID(ObjectKind::ConfigurationFileReference, p, 0) + "; ";
+        }
+        objects += "        " + targetConfigurationListID + " = { isa = XCConfigurationList; buildConfigurations = ( " + targetConfigurationID + " ); defaultConfigurationIsVisible = 0; defaultConfigurationName = Debug; };\n";
+        objects += "        " + targetConfigurationID + " = { isa = XCBuildConfiguration; " + baseConfiguration + "buildSettings = { PRODUCT_NAME = \"$(TARGET_NAME)\"; OTHER_CFLAGS = \"$(inherited) -DSYNTHETIC_TARGET=" + std::to_string(t) + "\"; }; name = Debug; };\n";
+
+        /* Source files. */
+        std::string sourceBuildFiles;
+        for (size_t f = 0; f < parameters.filesPerTarget(); f++) {
+            std::string fileReferenceID = ObjectID(ObjectKind::SourceFileReference, p, t, f);
+            std::string buildFileID = ObjectID(ObjectKind::SourceBuildFile, p, t, f);
+            objects += "        " + fileReferenceID + " = { isa = PBXFileReference; lastKnownFileType = sourcecode.c.c; path = " + Quote(SourceFileName(t, f)) + "; sourceTree = \"<group>\"; };\n";
+            objects += "        " + buildFileID + " = { isa = PBXBuildFile; fileRef = " + fileReferenceID + "; };\n";
+            mainGroupChildren += fileReferenceID + ", ";
+            sourceBuildFiles += buildFileID + ", ";
+        }
+        objects += "        " + sourcesPhaseID + " = { isa = PBXSourcesBuildPhase; buildActionMask = 2147483647; files = ( " + sourceBuildFiles + "); runOnlyForDeploymentPostprocessing = 0; };\n";
+        objects += "        " + frameworksPhaseID + " = { isa = PBXFrameworksBuildPhase; buildActionMask = 2147483647; files = ( ); runOnlyForDeploymentPostprocessing = 0; };\n";
+
+        /* Product. */
+        objects += "        " + productReferenceID + " = { isa = PBXFileReference; explicitFileType = archive.ar; includeInIndex = 0; path = " + Quote(ProductName(p, t)) + "; sourceTree = BUILT_PRODUCTS_DIR; };\n";
+        productsGroupChildren += productReferenceID + ", ";
+
+        /* Dependencies: the previous target in this project, and the same target in other projects. */
+        std::string dependencies;
+        if (t > 0) {
+            std::string dependencyID = ObjectID(ObjectKind::TargetDependency, p, t, 0);
+            std::string proxyID = ObjectID(ObjectKind::ContainerItemProxy, p, t, 0);
+            objects += "        " + proxyID + " = { isa = PBXContainerItemProxy; containerPortal = " + projectID + "; proxyType = 1; remoteGlobalIDString = " + ObjectID(ObjectKind::Target, p, t - 1) + "; remoteInfo = " + TargetName(p, t - 1) + "; };\n";
+            objects += "        " + dependencyID + " = { isa = PBXTargetDependency; target = " + ObjectID(ObjectKind::Target, p, t - 1) + "; targetProxy = " + proxyID + "; };\n";
+            dependencies += dependencyID + ", ";
+        }
+        for (size_t q : dependencyProjects) {
+            std::string dependencyID = ObjectID(ObjectKind::TargetDependency, p, t, q + 1);
+            std::string proxyID = ObjectID(ObjectKind::ContainerItemProxy, p, t, q + 1);
+            objects += "        " + proxyID + " = { isa = PBXContainerItemProxy; containerPortal = " + ObjectID(ObjectKind::ProjectFileReference, p, q) + "; proxyType = 1; remoteGlobalIDString = " + ObjectID(ObjectKind::Target, q, t) + "; remoteInfo = " + TargetName(q, t) + "; };\n";
+            objects += "        " + dependencyID + " = { isa = PBXTargetDependency; name = " + TargetName(q, t) + "; targetProxy = " + proxyID + "; };\n";
+            dependencies += dependencyID + ", ";
+        }
+
+        objects += "        " + targetID + " = { isa = PBXNativeTarget; buildConfigurationList = " + targetConfigurationListID + "; buildPhases = ( " + sourcesPhaseID + ", " + frameworksPhaseID + " ); buildRules = ( ); dependencies = ( " + dependencies + "); name = " + TargetName(p, t) + "; productName = " + TargetName(p, t) + "; productReference = " + productReferenceID + "; productType = \"com.apple.product-type.library.static\"; };\n";
+        targets += targetID + ", ";
+    }
+
+    mainGroupChildren += productsGroupID + ", ";
+    objects += "        " + productsGroupID + " = { isa = PBXGroup; children = ( " + productsGroupChildren + "); name = Products; sourceTree = \"<group>\"; };\n";
+    objects += "        " + mainGroupID + " = { isa = PBXGroup; children = ( " + mainGroupChildren + "); sourceTree = \"<group>\"; };\n";
+    objects += "        " + projectID + " = { isa = PBXProject; attributes = { }; buildConfigurationList = " + projectConfigurationListID + "; compatibilityVersion = \"Xcode 3.2\"; developmentRegion = English; hasScannedForEncodings = 0; knownRegions = ( en ); mainGroup = " + mainGroupID + "; productRefGroup = " + productsGroupID + "; projectDirPath = \"\"; projectRoot = \"\"; targets = ( " + targets + "); };\n";
+
+    std::string contents;
+    contents += "// !$*UTF8*$!\n";
+    contents += "{\n";
+    contents += "    archiveVersion = 1;\n";
+    contents += "    classes = { };\n";
+    contents += "    objectVersion = 46;\n";
+    contents += "    objects = {\n";
+    contents += objects;
+    contents += "    };\n";
+    contents += "    rootObject = " + projectID + ";\n";
+    contents += "}\n";
+    return contents;
+}
+
+bool SyntheticWorkspace::
+write(Filesystem *filesystem, Filesystem const *specificationsFilesystem, std::string const &specificationsPath) const
+{
+    /*
+     * Developer directory: the build specifications, a single platform and
+     * SDK, and a default toolchain.
+     */
+    std::string specificationsDirectory = developerRoot() + "/Library/Xcode/Specifications";
+    bool specificationsSuccess = true;
+    bool specificationsFound = specificationsFilesystem->readDirectory(specificationsPath, true, [&](std::string const &path) {
+        std::string extension = FSUtil::GetFileExtension(path);
+        if (extension != "xcspec" && extension != "plist") {
+            return;
+        }
+
+        std::vector<uint8_t> contents;
+        if (!specificationsFilesystem->read(&contents, specificationsPath + "/" + path)) {
+            specificationsSuccess = false;
+            return;
+        }
+
+        /* Install flattens the specifications into a single directory. */
+        std::string name = FSUtil::GetBaseName(path);
+        if (!WriteFile(filesystem, specificationsDirectory + "/" + name, std::string(contents.begin(), contents.end()))) {
+            specificationsSuccess = false;
+        }
+    });
+    if (!specificationsFound || !specificationsSuccess) {
+        fprintf(stderr, "error: unable to copy specifications from %s\n", specificationsPath.c_str());
+        return false;
+    }
+
+    std::string platformPath = developerRoot() + "/Platforms/MacOSX.platform";
+    if (!WriteFile(filesystem, platformPath + "/Info.plist", PlatformInfo()) ||
+        !WriteFile(filesystem, platformPath + "/Developer/Library/Xcode/Specifications/Synthetic.xcspec", PlatformSpecifications()) ||
+        !WriteFile(filesystem, platformPath + "/Developer/SDKs/MacOSX.sdk/SDKSettings.plist", SDKSettings())) {
+        return false;
+    }
+
+    std::string toolchainPath = developerRoot() + "/Toolchains/XcodeDefault.xctoolchain";
+    if (!WriteFile(filesystem, toolchainPath + "/ToolchainInfo.plist", ToolchainInfo())) {
+        return false;
+    }
+    for (std::string const &tool : ToolchainToolNames()) {
+        if (!WriteFile(filesystem, toolchainPath + "/usr/bin/" + tool, "#!/bin/sh\n", true)) {
+            return false;
+        }
+    }
+
+    /*
+     * Placeholder build tool, and the tools it expects beside it.
+     */
+    if (!WriteFile(filesystem, executablePath(), "#!/bin/sh\n", true)) {
+        return false;
+    }
+    for (std::string const &tool : BuildToolNames()) {
+        if (!WriteFile(filesystem, FSUtil::GetDirectoryName(executablePath()) + "/" + tool, "#!/bin/sh\n", true)) {
+            return false;
+        }
+    }
+
+    /*
+     * Workspace and its shared scheme.
+     */
+    std::string workspaceDirectory = FSUtil::GetDirectoryName(workspacePath());
+    if (!WriteFile(filesystem, workspacePath() + "/contents.xcworkspacedata", WorkspaceContents(_parameters.projects())) ||
+        !WriteFile(filesystem, workspacePath() + "/xcshareddata/xcschemes/" + schemeName() + ".xcscheme", SchemeContents(_parameters))) {
+        return false;
+    }
+
+    /*
+     * Projects, with their configuration files and sources.
+     */
+    for (size_t p = 0; p < _parameters.projects(); p++) {
+        std::string projectDirectory = workspaceDirectory + "/" + ProjectName(p);
+
+        if (!WriteFile(filesystem, projectDirectory + "/" + ProjectName(p) + ".xcodeproj/project.pbxproj", ProjectContents(_parameters, p))) {
+            return false;
+        }
+
+        for (size_t d = 0; d < _parameters.xcconfigDepth(); d++) {
+            if (!WriteFile(filesystem, projectDirectory + "/Config/" + ConfigurationFileName(d), ConfigurationFileContents(d, _parameters.xcconfigDepth()))) {
+                return false;
+            }
+        }
+
+        for (size_t t = 0; t < _parameters.targets(); t++) {
+            for (size_t f = 0; f < _parameters.filesPerTarget(); f++) {
+                if (!WriteFile(filesystem, projectDirectory + "/" + SourceFileName(t, f), SourceFileContents(p, t, f))) {
+                    return false;
+                }
+            }
+        }
+    }
+
+    return true;
+}
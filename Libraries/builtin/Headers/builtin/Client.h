@@ -0,0 +1,53 @@
+/**
+ Copyright (c) 2015-present, Facebook, Inc.
+ All rights reserved.
+
+ This source code is licensed under the BSD-style license found in the
+ LICENSE file in the root directory of this source tree. An additional grant
+ of patent rights can be found in the PATENTS file in the same directory.
+ */
+
+#ifndef __builtin_Client_h
+#define __builtin_Client_h
+
+#include <string>
+#include <ext/optional>
+
+namespace builtin {
+
+class Request;
+
+/*
+ * Runs builtin drivers in a builtin server. The client deliberately does
+ * not depend on the drivers themselves, so it stays cheap to launch.
+ */
+class Client {
+private:
+    Client();
+    ~Client();
+
+public:
+    /*
+     * Run a request in the server listening on a socket, passing the
+     * standard streams of this process. Returns the exit status of the
+     * driver, or nothing if no server could be reached; in that case,
+     * the request was not run and can be run elsewhere.
+     *
+     * Interrupts received while the request runs are forwarded to the
+     * server process running it; once it exits, this process receives
+     * the interrupt too.
+     */
+    static ext::optional<int>
+    Run(std::string const &socketPath, Request const &request);
+
+public:
+    /*
+     * The environment variable with the path to the server socket.
+     */
+    static std::string
+    SocketEnvironmentVariable();
+};
+
+}
+
+#endif // !__builtin_Client_h
@@ -0,0 +1,78 @@
+/**
+ Copyright (c) 2015-present, Facebook, Inc.
+ All rights reserved.
+
+ This source code is licensed under the BSD-style license found in the
+ LICENSE file in the root directory of this source tree. An additional grant
+ of patent rights can be found in the PATENTS file in the same directory.
+ */
+
+#ifndef __builtin_Request_h
+#define __builtin_Request_h
+
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <ext/optional>
+
+namespace builtin {
+
+/*
+ * A request to run a builtin driver, sent from a client to a server.
+ */
+class Request {
+private:
+    std::string                                  _name;
+    std::string                                  _currentDirectory;
+    std::vector<std::string>                     _arguments;
+    std::unordered_map<std::string, std::string> _environmentVariables;
+
+public:
+    Request(
+        std::string const &name,
+        std::string const &currentDirectory,
+        std::vector<std::string> const &arguments,
+        std::unordered_map<std::string, std::string> const &environmentVariables);
+
+public:
+    /*
+     * The name of the driver to run.
+     */
+    std::string const &name() const
+    { return _name; }
+
+    /*
+     * The directory to run the driver in.
+     */
+    std::string const &currentDirectory() const
+    { return _currentDirectory; }
+
+    /*
+     * Arguments to the driver, not including the driver name.
+     */
+    std::vector<std::string> const &arguments() const
+    { return _arguments; }
+
+    /*
+     * Environment for the driver.
+     */
+    std::unordered_map<std::string, std::string> const &environmentVariables() const
+    { return _environmentVariables; }
+
+public:
+    /*
+     * Serialize the request to send to the server.
+     */
+    std::string serialize() const;
+
+public:
+    /*
+     * Parse a serialized request.
+     */
+    static ext::optional<Request>
+    Deserialize(std::string const &contents);
+};
+
+}
+
+#endif // !__builtin_Request_h
@@ -0,0 +1,59 @@
+/**
+ Copyright (c) 2015-present, Facebook, Inc.
+ All rights reserved.
+
+ This source code is licensed under the BSD-style license found in the
+ LICENSE file in the root directory of this source tree. An additional grant
+ of patent rights can be found in the PATENTS file in the same directory.
+ */
+
+#ifndef __builtin_Server_h
+#define __builtin_Server_h
+
+#include <string>
+
+namespace process { class Context; }
+
+namespace builtin {
+
+class Registry;
+
+/*
+ * Long-lived process hosting the builtin drivers. Clients connect over a
+ * local socket and pass their standard streams, so running a builtin
+ * only costs a fork rather than launching and linking a new executable.
+ */
+class Server {
+private:
+    Registry   *_registry;
+    std::string _socketPath;
+    int         _socket;
+
+public:
+    Server(Registry *registry, std::string const &socketPath);
+    ~Server();
+
+public:
+    /*
+     * The path of the socket clients connect to.
+     */
+    std::string const &socketPath() const
+    { return _socketPath; }
+
+public:
+    /*
+     * Create the socket and start listening. Clients can connect once
+     * this returns, even before the server starts serving.
+     */
+    bool listen();
+
+    /*
+     * Serve requests until an error occurs. Each request runs in a new
+     * child process, so requests run in parallel and cannot interfere.
+     */
+    bool serve(process::Context const *processContext);
+};
+
+}
+
+#endif // !__builtin_Server_h
@@ -0,0 +1,220 @@
+/**
+ Copyright (c) 2015-present, Facebook, Inc.
+ All rights reserved.
+
+ This source code is licensed under the BSD-style license found in the
+ LICENSE file in the root directory of this source tree. An additional grant
+ of patent rights can be found in the PATENTS file in the same directory.
+ */
+
+#include <builtin/Client.h>
+#include <builtin/Request.h>
+
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+
+#if !_WIN32
+#include <signal.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+
+using builtin::Client;
+using builtin::Request;
+
+#if !_WIN32
+static int
+ClientConnect(std::string const &socketPath)
+{
+    struct sockaddr_un address;
+    memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    if (socketPath.size() >= sizeof(address.sun_path)) {
+        return -1;
+    }
+    strncpy(address.sun_path, socketPath.c_str(), sizeof(address.sun_path) - 1);
+
+    int fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd == -1) {
+        return -1;
+    }
+
+    int result;
+    do {
+        result = ::connect(fd, reinterpret_cast<struct sockaddr *>(&address), sizeof(address));
+    } while (result != 0 && errno == EINTR);
+
+    if (result != 0) {
+        ::close(fd);
+        return -1;
+    }
+
+    return fd;
+}
+
+static bool
+ClientSend(int fd, std::string const &contents)
+{
+    /*
+     * Send the request length along with the standard streams, which the
+     * server uses for the driver's input and output.
+     */
+    uint32_t length = static_cast<uint32_t>(contents.size());
+    int descriptors[3] = { STDIN_FILENO, STDOUT_FILENO, STDERR_FILENO };
+    char control[CMSG_SPACE(sizeof(descriptors))];
+    memset(control, 0, sizeof(control));
+
+    struct iovec iov;
+    iov.iov_base = &length;
+    iov.iov_len = sizeof(length);
+
+    struct msghdr message;
+    memset(&message, 0, sizeof(message));
+    message.msg_iov = &iov;
+    message.msg_iovlen = 1;
+    message.msg_control = control;
+    message.msg_controllen = sizeof(control);
+
+    struct cmsghdr *header = CMSG_FIRSTHDR(&message);
+    header->cmsg_level = SOL_SOCKET;
+    header->cmsg_type = SCM_RIGHTS;
+    header->cmsg_len = CMSG_LEN(sizeof(descriptors));
+    memcpy(CMSG_DATA(header), descriptors, sizeof(descriptors));
+
+    ssize_t sent;
+    do {
+        sent = ::sendmsg(fd, &message, 0);
+    } while (sent < 0 && errno == EINTR);
+    if (sent != sizeof(length)) {
+        return false;
+    }
+
+    char const *buffer = contents.data();
+    size_t size = contents.size();
+    while (size > 0) {
+        ssize_t result = ::write(fd, buffer, size);
+        if (result < 0 && errno == EINTR) {
+            continue;
+        } else if (result <= 0) {
+            return false;
+        }
+
+        buffer += result;
+        size -= result;
+    }
+
+    return true;
+}
+
+static bool
+ClientReceive(int fd, int32_t *value)
+{
+    char *buffer = reinterpret_cast<char *>(value);
+    size_t size = sizeof(*value);
+    while (size > 0) {
+        ssize_t result = ::read(fd, buffer, size);
+        if (result < 0 && errno == EINTR) {
+            continue;
+        } else if (result <= 0) {
+            return false;
+        }
+
+        buffer += result;
+        size -= result;
+    }
+
+    return true;
+}
+
+/*
+ * The server process running the request, and the interrupt this process
+ * received while it runs, if any.
+ */
+static volatile sig_atomic_t ClientServerProcess = 0;
+static volatile sig_atomic_t ClientInterrupt = 0;
+
+static int const ClientInterruptSignals[] = { SIGINT, SIGTERM, SIGHUP };
+static size_t const ClientInterruptSignalCount = sizeof(ClientInterruptSignals) / sizeof(*ClientInterruptSignals);
+
+static void
+ClientForwardInterrupt(int signal)
+{
+    ClientInterrupt = signal;
+    if (ClientServerProcess > 0) {
+        ::kill(-ClientServerProcess, signal);
+    }
+}
+#endif
+
+ext::optional<int> Client::
+Run(std::string const &socketPath, Request const &request)
+{
+#if _WIN32
+    return ext::nullopt;
+#else
+    int fd = ClientConnect(socketPath);
+    if (fd == -1) {
+        return ext::nullopt;
+    }
+
+    /*
+     * Forward interrupts to the server process running the request, so it
+     * stops along with the build. It is waited for before this process is
+     * interrupted itself.
+     */
+    ClientServerProcess = 0;
+    ClientInterrupt = 0;
+
+    struct sigaction forward;
+    memset(&forward, 0, sizeof(forward));
+    forward.sa_handler = &ClientForwardInterrupt;
+    sigemptyset(&forward.sa_mask);
+
+    struct sigaction previous[ClientInterruptSignalCount];
+    for (size_t i = 0; i < ClientInterruptSignalCount; i++) {
+        ::sigaction(ClientInterruptSignals[i], &forward, &previous[i]);
+    }
+
+    /*
+     * Once the request is sent the driver may have started, so it
+     * can't be retried elsewhere. Report failure instead. The server
+     * first sends the process running the request, then its status.
+     */
+    int32_t server;
+    int32_t status;
+    bool success = ClientSend(fd, request.serialize()) && ClientReceive(fd, &server);
+    if (success) {
+        ClientServerProcess = server;
+        if (ClientInterrupt != 0) {
+            ::kill(-server, ClientInterrupt);
+        }
+
+        success = ClientReceive(fd, &status);
+    }
+    ::close(fd);
+
+    ClientServerProcess = 0;
+    for (size_t i = 0; i < ClientInterruptSignalCount; i++) {
+        ::sigaction(ClientInterruptSignals[i], &previous[i], nullptr);
+    }
+
+    if (ClientInterrupt != 0) {
+        ::raise(ClientInterrupt);
+    }
+
+    if (!success) {
+        fprintf(stderr, "error: builtin server failed to run %s\n", request.name().c_str());
+        return 1;
+    }
+
+    return static_cast<int>(status);
+#endif
+}
+
+std::string Client::
+SocketEnvironmentVariable()
+{
+    return "XCBUILD_BUILTIN_SERVER";
+}
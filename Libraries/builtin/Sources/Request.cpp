@@ -0,0 +1,136 @@
+/**
+ Copyright (c) 2015-present, Facebook, Inc.
+ All rights reserved.
+
+ This source code is licensed under the BSD-style license found in the
+ LICENSE file in the root directory of this source tree. An additional grant
+ of patent rights can be found in the PATENTS file in the same directory.
+ */
+
+#include <builtin/Request.h>
+
+#include <cstring>
+
+using builtin::Request;
+
+Request::
+Request(
+    std::string const &name,
+    std::string const &currentDirectory,
+    std::vector<std::string> const &arguments,
+    std::unordered_map<std::string, std::string> const &environmentVariables) :
+    _name                (name),
+    _currentDirectory    (currentDirectory),
+    _arguments           (arguments),
+    _environmentVariables(environmentVariables)
+{
+}
+
+static void
+SerializeLength(std::string *result, size_t length)
+{
+    uint32_t value = static_cast<uint32_t>(length);
+    result->append(reinterpret_cast<char const *>(&value), sizeof(value));
+}
+
+static void
+SerializeString(std::string *result, std::string const &string)
+{
+    SerializeLength(result, string.size());
+    result->append(string);
+}
+
+static bool
+DeserializeLength(std::string const &contents, size_t *offset, size_t *length)
+{
+    uint32_t value;
+    if (contents.size() - *offset < sizeof(value)) {
+        return false;
+    }
+
+    memcpy(&value, contents.data() + *offset, sizeof(value));
+    *offset += sizeof(value);
+    *length = value;
+    return true;
+}
+
+static bool
+DeserializeString(std::string const &contents, size_t *offset, std::string *string)
+{
+    size_t length;
+    if (!DeserializeLength(contents, offset, &length) || contents.size() - *offset < length) {
+        return false;
+    }
+
+    *string = contents.substr(*offset, length);
+    *offset += length;
+    return true;
+}
+
+std::string Request::
+serialize() const
+{
+    std::string result;
+    SerializeString(&result, _name);
+    SerializeString(&result, _currentDirectory);
+
+    SerializeLength(&result, _arguments.size());
+    for (std::string const &argument : _arguments) {
+        SerializeString(&result, argument);
+    }
+
+    SerializeLength(&result, _environmentVariables.size());
+    for (auto const &variable : _environmentVariables) {
+        SerializeString(&result, variable.first);
+        SerializeString(&result, variable.second);
+    }
+
+    return result;
+}
+
+ext::optional<Request> Request::
+Deserialize(std::string const &contents)
+{
+    size_t offset = 0;
+
+    std::string name;
+    std::string currentDirectory;
+    if (!DeserializeString(contents, &offset, &name) || !DeserializeString(contents, &offset, &currentDirectory)) {
+        return ext::nullopt;
+    }
+
+    size_t argumentsCount;
+    if (!DeserializeLength(contents, &offset, &argumentsCount)) {
+        return ext::nullopt;
+    }
+
+    std::vector<std::string> arguments;
+    for (size_t i = 0; i < argumentsCount; i++) {
+        std::string argument;
+        if (!DeserializeString(contents, &offset, &argument)) {
+            return ext::nullopt;
+        }
+        arguments.push_back(argument);
+    }
+
+    size_t environmentVariablesCount;
+    if (!DeserializeLength(contents, &offset, &environmentVariablesCount)) {
+        return ext::nullopt;
+    }
+
+    std::unordered_map<std::string, std::string> environmentVariables;
+    for (size_t i = 0; i < environmentVariablesCount; i++) {
+        std::string variable;
+        std::string value;
+        if (!DeserializeString(contents, &offset, &variable) || !DeserializeString(contents, &offset, &value)) {
+            return ext::nullopt;
+        }
+        environmentVariables[variable] = value;
+    }
+
+    if (offset != contents.size()) {
+        return ext::nullopt;
+    }
+
+    return Request(name, currentDirectory, arguments, environmentVariables);
+}
@@ -0,0 +1,276 @@
+/**
+ Copyright (c) 2015-present, Facebook, Inc.
+ All rights reserved.
+
+ This source code is licensed under the BSD-style license found in the
+ LICENSE file in the root directory of this source tree. An additional grant
+ of patent rights can be found in the PATENTS file in the same directory.
+ */
+
+#include <builtin/Server.h>
+#include <builtin/Request.h>
+#include <builtin/Registry.h>
+#include <builtin/Driver.h>
+#include <libutil/DefaultFilesystem.h>
+#include <process/Context.h>
+#include <process/MemoryContext.h>
+
+#include <cerrno>
+#include <cstring>
+
+#if !_WIN32
+#include <fcntl.h>
+#include <signal.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+
+using builtin::Server;
+using builtin::Request;
+using builtin::Registry;
+using builtin::Driver;
+using libutil::DefaultFilesystem;
+
+Server::
+Server(Registry *registry, std::string const &socketPath) :
+    _registry  (registry),
+    _socketPath(socketPath),
+    _socket    (-1)
+{
+}
+
+Server::
+~Server()
+{
+#if !_WIN32
+    if (_socket != -1) {
+        ::close(_socket);
+        ::unlink(_socketPath.c_str());
+    }
+#endif
+}
+
+bool Server::
+listen()
+{
+#if _WIN32
+    fprintf(stderr, "error: builtin server is not supported on this platform\n");
+    return false;
+#else
+    struct sockaddr_un address;
+    memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    if (_socketPath.size() >= sizeof(address.sun_path)) {
+        fprintf(stderr, "error: socket path too long: %s\n", _socketPath.c_str());
+        return false;
+    }
+    strncpy(address.sun_path, _socketPath.c_str(), sizeof(address.sun_path) - 1);
+
+    int fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd == -1) {
+        fprintf(stderr, "error: unable to create socket: %s\n", strerror(errno));
+        return false;
+    }
+
+    /* Replace any socket left behind by a previous server. */
+    ::unlink(_socketPath.c_str());
+
+    /* Only allow the current user to connect. */
+    mode_t mask = ::umask(0077);
+    int result = ::bind(fd, reinterpret_cast<struct sockaddr *>(&address), sizeof(address));
+    ::umask(mask);
+
+    if (result != 0 || ::listen(fd, SOMAXCONN) != 0) {
+        fprintf(stderr, "error: unable to listen on %s: %s\n", _socketPath.c_str(), strerror(errno));
+        ::close(fd);
+        return false;
+    }
+
+    _socket = fd;
+    return true;
+#endif
+}
+
+#if !_WIN32
+static bool
+ReadFully(int fd, void *data, size_t size)
+{
+    char *buffer = static_cast<char *>(data);
+    while (size > 0) {
+        ssize_t result = ::read(fd, buffer, size);
+        if (result < 0 && errno == EINTR) {
+            continue;
+        } else if (result <= 0) {
+            return false;
+        }
+
+        buffer += result;
+        size -= result;
+    }
+
+    return true;
+}
+
+static bool
+WriteFully(int fd, void const *data, size_t size)
+{
+    char const *buffer = static_cast<char const *>(data);
+    while (size > 0) {
+        ssize_t result = ::write(fd, buffer, size);
+        if (result < 0 && errno == EINTR) {
+            continue;
+        } else if (result <= 0) {
+            return false;
+        }
+
+        buffer += result;
+        size -= result;
+    }
+
+    return true;
+}
+
+static bool
+ServerHandleRequest(Registry *registry, process::Context const *processContext, int connection, int32_t *status)
+{
+    /*
+     * The request length arrives together with the client's standard streams.
+     */
+    uint32_t length;
+    int descriptors[3];
+    char control[CMSG_SPACE(sizeof(descriptors))];
+
+    struct iovec iov;
+    iov.iov_base = &length;
+    iov.iov_len = sizeof(length);
+
+    struct msghdr message;
+    memset(&message, 0, sizeof(message));
+    message.msg_iov = &iov;
+    message.msg_iovlen = 1;
+    message.msg_control = control;
+    message.msg_controllen = sizeof(control);
+
+    ssize_t received;
+    do {
+        received = ::recvmsg(connection, &message, 0);
+    } while (received < 0 && errno == EINTR);
+
+    struct cmsghdr *header = CMSG_FIRSTHDR(&message);
+    if (received != sizeof(length) || header == nullptr || header->cmsg_type != SCM_RIGHTS || header->cmsg_len != CMSG_LEN(sizeof(descriptors))) {
+        return false;
+    }
+    memcpy(descriptors, CMSG_DATA(header), sizeof(descriptors));
+
+    std::string contents;
+    contents.resize(length);
+    if (!ReadFully(connection, &contents[0], contents.size())) {
+        return false;
+    }
+
+    ext::optional<Request> request = Request::Deserialize(contents);
+    if (!request) {
+        return false;
+    }
+
+    /*
+     * Take over the client's streams and directory, so the driver behaves
+     * exactly as if the client had run it.
+     */
+    for (int i = 0; i < 3; i++) {
+        if (::dup2(descriptors[i], i) == -1) {
+            return false;
+        }
+        ::close(descriptors[i]);
+    }
+
+    if (::chdir(request->currentDirectory().c_str()) != 0) {
+        fprintf(stderr, "error: unable to change directory to %s\n", request->currentDirectory().c_str());
+        *status = 1;
+        return true;
+    }
+
+    std::shared_ptr<Driver> driver = registry->driver(request->name());
+    if (driver == nullptr) {
+        fprintf(stderr, "error: unknown builtin tool '%s'\n", request->name().c_str());
+        *status = 1;
+        return true;
+    }
+
+    process::MemoryContext context = process::MemoryContext(
+        processContext->executablePath(),
+        request->currentDirectory(),
+        request->arguments(),
+        request->environmentVariables());
+    DefaultFilesystem filesystem = DefaultFilesystem();
+    *status = driver->run(&context, &filesystem);
+
+    fflush(stdout);
+    fflush(stderr);
+    return true;
+}
+#endif
+
+bool Server::
+serve(process::Context const *processContext)
+{
+#if _WIN32
+    return false;
+#else
+    if (_socket == -1) {
+        return false;
+    }
+
+    /* Child processes are never waited for. */
+    ::signal(SIGCHLD, SIG_IGN);
+
+    while (true) {
+        int connection = ::accept(_socket, nullptr, nullptr);
+        if (connection == -1) {
+            if (errno == EINTR || errno == ECONNABORTED) {
+                continue;
+            }
+
+            fprintf(stderr, "error: unable to accept connection: %s\n", strerror(errno));
+            return false;
+        }
+
+        /* Nothing buffered should be duplicated into the child. */
+        fflush(stdout);
+        fflush(stderr);
+
+        pid_t pid = ::fork();
+        if (pid == 0) {
+            ::close(_socket);
+
+            /* Drivers wait for processes of their own; ignoring them would lose their status. */
+            ::signal(SIGCHLD, SIG_DFL);
+
+            /*
+             * The client forwards interrupts to this process's group, which
+             * includes processes the driver runs. They don't hold the
+             * connection, so the client sees it close once this exits.
+             */
+            ::setpgid(0, 0);
+            ::fcntl(connection, F_SETFD, FD_CLOEXEC);
+
+            int32_t self = static_cast<int32_t>(::getpid());
+            if (!WriteFully(connection, &self, sizeof(self))) {
+                ::_exit(1);
+            }
+
+            int32_t status;
+            if (ServerHandleRequest(_registry, processContext, connection, &status)) {
+                WriteFully(connection, &status, sizeof(status));
+            }
+            ::_exit(0);
+        } else if (pid == -1) {
+            fprintf(stderr, "warning: unable to fork: %s\n", strerror(errno));
+        }
+
+        ::close(connection);
+    }
+#endif
+}
@@ -0,0 +1,209 @@
+/**
+ Copyright (c) 2015-present, Facebook, Inc.
+ All rights reserved.
+
+ This source code is licensed under the BSD-style license found in the
+ LICENSE file in the root directory of this source tree. An additional grant
+ of patent rights can be found in the PATENTS file in the same directory.
+ */
+
+#include <gtest/gtest.h>
+#include <builtin/Server.h>
+#include <builtin/Client.h>
+#include <builtin/Request.h>
+#include <builtin/Registry.h>
+#include <builtin/Driver.h>
+#include <libutil/DefaultFilesystem.h>
+#include <libutil/Filesystem.h>
+#include <process/Context.h>
+#include <process/MemoryContext.h>
+
+#if !_WIN32
+#include <signal.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
+using builtin::Server;
+using builtin::Client;
+using builtin::Request;
+using builtin::Registry;
+using libutil::DefaultFilesystem;
+using libutil::Filesystem;
+
+/*
+ * Writes the environment variable named by the first argument to the
+ * file named by the second argument, relative to the current directory.
+ */
+class TestDriver : public builtin::Driver {
+public:
+    virtual std::string name()
+    { return "builtin-test"; }
+
+    virtual int run(process::Context const *processContext, Filesystem *filesystem)
+    {
+        std::vector<std::string> const &arguments = processContext->commandLineArguments();
+        if (arguments.size() != 2) {
+            return 2;
+        }
+
+        std::string value = processContext->environmentVariable(arguments[0]).value_or("");
+        std::string path = processContext->currentDirectory() + "/" + arguments[1];
+        return filesystem->write(std::vector<uint8_t>(value.begin(), value.end()), path) ? 0 : 1;
+    }
+};
+
+#if !_WIN32
+/*
+ * Waits for a process of its own, returning its exit status.
+ */
+class WaitDriver : public builtin::Driver {
+public:
+    virtual std::string name()
+    { return "builtin-wait"; }
+
+    virtual int run(process::Context const *processContext, Filesystem *filesystem)
+    {
+        pid_t pid = fork();
+        if (pid == 0) {
+            _exit(7);
+        }
+
+        int status;
+        if (pid == -1 || waitpid(pid, &status, 0) != pid) {
+            return 1;
+        }
+        return WEXITSTATUS(status);
+    }
+};
+
+/*
+ * Writes its process ID to the file named by its argument, then waits to
+ * be interrupted.
+ */
+class SleepDriver : public builtin::Driver {
+public:
+    virtual std::string name()
+    { return "builtin-sleep"; }
+
+    virtual int run(process::Context const *processContext, Filesystem *filesystem)
+    {
+        std::string pid = std::to_string(getpid());
+        std::string path = processContext->currentDirectory() + "/" + processContext->commandLineArguments().front();
+        if (!filesystem->write(std::vector<uint8_t>(pid.begin(), pid.end()), path)) {
+            return 1;
+        }
+
+        sleep(30);
+        return 0;
+    }
+};
+#endif
+
+TEST(Server, RequestRoundTrip)
+{
+    Request request = Request("builtin-test", "/dir", { "a", "", "b c" }, { { "KEY", "value" }, { "EMPTY", "" } });
+
+    auto parsed = Request::Deserialize(request.serialize());
+    ASSERT_TRUE(parsed);
+    EXPECT_EQ(request.name(), parsed->name());
+    EXPECT_EQ(request.currentDirectory(), parsed->currentDirectory());
+    EXPECT_EQ(request.arguments(), parsed->arguments());
+    EXPECT_EQ(request.environmentVariables(), parsed->environmentVariables());
+}
+
+TEST(Server, RequestInvalid)
+{
+    std::string contents = Request("builtin-test", "/dir", { "a" }, { }).serialize();
+
+    EXPECT_FALSE(Request::Deserialize(contents.substr(0, contents.size() - 1)));
+    EXPECT_FALSE(Request::Deserialize(contents + "x"));
+    EXPECT_FALSE(Request::Deserialize(""));
+}
+
+TEST(Server, ClientNoServer)
+{
+    /* Nothing is run without a server, so the caller can run it instead. */
+    Request request = Request("builtin-test", "/", { }, { });
+    EXPECT_FALSE(Client::Run("/nonexistent/socket", request));
+}
+
+#if !_WIN32
+TEST(Server, ClientServer)
+{
+    DefaultFilesystem filesystem = DefaultFilesystem();
+    Registry registry = Registry::Create({ std::make_shared<TestDriver>(), std::make_shared<WaitDriver>(), std::make_shared<SleepDriver>() });
+
+    char directory[] = "/tmp/builtin-server-XXXXXX";
+    ASSERT_NE(nullptr, mkdtemp(directory));
+
+    std::string socketPath = std::string(directory) + "/socket";
+    Server server = Server(&registry, socketPath);
+    ASSERT_TRUE(server.listen());
+
+    pid_t pid = fork();
+    ASSERT_NE(-1, pid);
+    if (pid == 0) {
+        auto serverProcess = process::MemoryContext("server", directory, { }, { });
+        server.serve(&serverProcess);
+        _exit(1);
+    }
+
+    /* The client's environment and directory are used, not the server's. */
+    Request request = Request("builtin-test", directory, { "KEY", "out" }, { { "KEY", "served" } });
+    EXPECT_EQ(0, Client::Run(socketPath, request));
+
+    std::vector<uint8_t> contents;
+    EXPECT_TRUE(filesystem.read(&contents, std::string(directory) + "/out"));
+    EXPECT_EQ("served", std::string(contents.begin(), contents.end()));
+
+    /* Driver failures are passed back to the client. */
+    Request failing = Request("builtin-test", directory, { }, { });
+    EXPECT_EQ(2, Client::Run(socketPath, failing));
+
+    /* As are unknown tools. */
+    Request unknown = Request("builtin-unknown", directory, { }, { });
+    EXPECT_EQ(1, Client::Run(socketPath, unknown));
+
+    /* Drivers can wait for processes of their own. */
+    Request waiting = Request("builtin-wait", directory, { }, { });
+    EXPECT_EQ(7, Client::Run(socketPath, waiting));
+
+    /* Interrupting the client stops the request in the server, too. */
+    std::string pidPath = std::string(directory) + "/pid";
+    pid_t client = fork();
+    ASSERT_NE(-1, client);
+    if (client == 0) {
+        Request sleeping = Request("builtin-sleep", directory, { "pid" }, { });
+        Client::Run(socketPath, sleeping);
+        _exit(0);
+    }
+
+    std::vector<uint8_t> pidContents;
+    for (int i = 0; i < 500 && !(filesystem.read(&pidContents, pidPath) && !pidContents.empty()); i++) {
+        usleep(10000);
+    }
+    ASSERT_FALSE(pidContents.empty());
+    pid_t driver = std::stoi(std::string(pidContents.begin(), pidContents.end()));
+
+    kill(client, SIGINT);
+    int clientStatus;
+    ASSERT_EQ(client, waitpid(client, &clientStatus, 0));
+    EXPECT_TRUE(WIFSIGNALED(clientStatus));
+    EXPECT_EQ(SIGINT, WTERMSIG(clientStatus));
+
+    /* The driver was interrupted. It closes the connection just before it exits. */
+    for (int i = 0; i < 100 && kill(driver, 0) == 0; i++) {
+        usleep(10000);
+    }
+    EXPECT_NE(0, kill(driver, 0));
+
+    kill(pid, SIGTERM);
+    waitpid(pid, nullptr, 0);
+
+    filesystem.removeFile(std::string(directory) + "/out");
+    filesystem.removeFile(pidPath);
+    filesystem.removeFile(socketPath);
+    filesystem.removeDirectory(directory, false);
+}
+#endif
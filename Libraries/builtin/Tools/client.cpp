@@ -0,0 +1,92 @@
+/**
+ Copyright (c) 2015-present, Facebook, Inc.
+ All rights reserved.
+
+ This source code is licensed under the BSD-style license found in the
+ LICENSE file in the root directory of this source tree. An additional grant
+ of patent rights can be found in the PATENTS file in the same directory.
+ */
+
+#include <builtin/Client.h>
+#include <builtin/Request.h>
+#include <libutil/DefaultFilesystem.h>
+#include <libutil/FSUtil.h>
+#include <process/DefaultContext.h>
+#include <process/DefaultLauncher.h>
+#include <process/MemoryContext.h>
+
+#include <cerrno>
+#include <cstring>
+
+#if !_WIN32
+#include <unistd.h>
+#endif
+
+using libutil::DefaultFilesystem;
+using libutil::FSUtil;
+
+int
+main(int argc, char **argv, char **envp)
+{
+    DefaultFilesystem filesystem = DefaultFilesystem();
+    process::DefaultContext processContext = process::DefaultContext();
+
+    /*
+     * Usage: builtin-client <builtin-name> [arguments]
+     */
+    std::vector<std::string> const &arguments = processContext.commandLineArguments();
+    if (arguments.empty()) {
+        fprintf(stderr, "usage: builtin-client <builtin-name> [arguments]\n");
+        return 1;
+    }
+
+    std::string const &name = arguments.front();
+    std::vector<std::string> builtinArguments = std::vector<std::string>(arguments.begin() + 1, arguments.end());
+
+    /*
+     * Run the builtin in the server, if there is one.
+     */
+    if (ext::optional<std::string> socketPath = processContext.environmentVariable(builtin::Client::SocketEnvironmentVariable())) {
+        builtin::Request request = builtin::Request(name, processContext.currentDirectory(), builtinArguments, processContext.environmentVariables());
+        if (ext::optional<int> status = builtin::Client::Run(*socketPath, request)) {
+            return *status;
+        }
+    }
+
+    /*
+     * Otherwise, run the builtin executable installed alongside the client.
+     */
+    ext::optional<std::string> executable = filesystem.findExecutable(name, { FSUtil::GetDirectoryName(processContext.executablePath()) });
+    if (!executable) {
+        fprintf(stderr, "error: unknown builtin tool '%s'\n", name.c_str());
+        return 1;
+    }
+
+#if _WIN32
+    process::DefaultLauncher processLauncher = process::DefaultLauncher();
+    process::MemoryContext context = process::MemoryContext(
+        *executable,
+        processContext.currentDirectory(),
+        builtinArguments,
+        processContext.environmentVariables());
+    ext::optional<int> status = processLauncher.launch(&filesystem, &context);
+    if (!status) {
+        fprintf(stderr, "error: unable to run %s\n", executable->c_str());
+        return 1;
+    }
+
+    return *status;
+#else
+    /* Replace this process, rather than waiting on another one. */
+    std::vector<char *> execArguments;
+    execArguments.push_back(const_cast<char *>(executable->c_str()));
+    for (int i = 2; i < argc; i++) {
+        execArguments.push_back(argv[i]);
+    }
+    execArguments.push_back(nullptr);
+
+    ::execve(executable->c_str(), execArguments.data(), envp);
+    fprintf(stderr, "error: unable to run %s: %s\n", executable->c_str(), strerror(errno));
+    return 1;
+#endif
+}
@@ -0,0 +1,121 @@
+/**
+ Copyright (c) 2015-present, Facebook, Inc.
+ All rights reserved.
+
+ This source code is licensed under the BSD-style license found in the
+ LICENSE file in the root directory of this source tree. An additional grant
+ of patent rights can be found in the PATENTS file in the same directory.
+ */
+
+#include <builtin/Server.h>
+#include <builtin/Client.h>
+#include <builtin/Registry.h>
+#include <libutil/Options.h>
+#include <process/DefaultContext.h>
+
+class Options {
+private:
+    ext::optional<bool>        _help;
+    ext::optional<std::string> _socket;
+
+public:
+    Options();
+    ~Options();
+
+public:
+    bool help() const
+    { return _help.value_or(false); }
+    ext::optional<std::string> const &socket() const
+    { return _socket; }
+
+private:
+    friend class libutil::Options;
+    std::pair<bool, std::string>
+    parseArgument(std::vector<std::string> const &args, std::vector<std::string>::const_iterator *it);
+};
+
+Options::
+Options()
+{
+}
+
+Options::
+~Options()
+{
+}
+
+std::pair<bool, std::string> Options::
+parseArgument(std::vector<std::string> const &args, std::vector<std::string>::const_iterator *it)
+{
+    std::string const &arg = **it;
+
+    if (arg == "-h" || arg == "--help") {
+        return libutil::Options::Current<bool>(&_help, arg);
+    } else if (arg == "-s" || arg == "--socket") {
+        return libutil::Options::Next<std::string>(&_socket, args, it);
+    } else {
+        return std::make_pair(false, "unknown argument " + arg);
+    }
+}
+
+static int
+Help(std::string const &error = std::string())
+{
+    if (!error.empty()) {
+        fprintf(stderr, "error: %s\n", error.c_str());
+        fprintf(stderr, "\n");
+    }
+
+    fprintf(stderr, "Usage: builtin-server [options]\n\n");
+    fprintf(stderr, "Runs builtin tools for builtin-client.\n\n");
+
+#define INDENT "  "
+    fprintf(stderr, "Information:\n");
+    fprintf(stderr, INDENT "-h, --help\n");
+    fprintf(stderr, "\n");
+
+    fprintf(stderr, "Server Options:\n");
+    fprintf(stderr, INDENT "-s, --socket <path> (default: $%s)\n", builtin::Client::SocketEnvironmentVariable().c_str());
+    fprintf(stderr, "\n");
+#undef INDENT
+
+    return (error.empty() ? EXIT_SUCCESS : EXIT_FAILURE);
+}
+
+int
+main(int argc, char **argv)
+{
+    process::DefaultContext processContext = process::DefaultContext();
+
+    /*
+     * Parse out the options, or print help & exit.
+     */
+    Options options;
+    std::pair<bool, std::string> result = libutil::Options::Parse<Options>(&options, processContext.commandLineArguments());
+    if (!result.first) {
+        return Help(result.second);
+    }
+
+    if (options.help()) {
+        return Help();
+    }
+
+    ext::optional<std::string> socket = options.socket();
+    if (!socket) {
+        socket = processContext.environmentVariable(builtin::Client::SocketEnvironmentVariable());
+    }
+    if (!socket) {
+        return Help("missing socket path");
+    }
+
+    /*
+     * Serve until killed.
+     */
+    builtin::Registry registry = builtin::Registry::Default();
+    builtin::Server server = builtin::Server(&registry, *socket);
+    if (!server.listen() || !server.serve(&processContext)) {
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,82 @@
+/**
+ Copyright (c) 2015-present, Facebook, Inc.
+ All rights reserved.
+
+ This source code is licensed under the BSD-style license found in the
+ LICENSE file in the root directory of this source tree. An additional grant
+ of patent rights can be found in the PATENTS file in the same directory.
+ */
+
+#ifndef __dependency_DependencyInfoConversion_h
+#define __dependency_DependencyInfoConversion_h
+
+#include <dependency/DependencyInfoFormat.h>
+
+#include <string>
+#include <vector>
+#include <utility>
+#include <ext/optional>
+
+namespace dependency {
+
+/*
+ * A request to convert dependency info from other formats into a single
+ * Makefile-format dependency file. Lists of conversions can be serialized
+ * so that many can be converted at once by one process.
+ */
+class DependencyInfoConversion {
+private:
+    std::string                                                 _name;
+    std::string                                                 _output;
+    std::string                                                 _directory;
+    std::vector<std::pair<DependencyInfoFormat, std::string>>   _inputs;
+
+public:
+    DependencyInfoConversion(
+        std::string const &name,
+        std::string const &output,
+        std::string const &directory,
+        std::vector<std::pair<DependencyInfoFormat, std::string>> const &inputs);
+
+public:
+    /*
+     * The name of the output the dependencies are for.
+     */
+    std::string const &name() const
+    { return _name; }
+
+    /*
+     * Where to write the converted dependency info.
+     */
+    std::string const &output() const
+    { return _output; }
+
+    /*
+     * The directory relative input paths are resolved against.
+     */
+    std::string const &directory() const
+    { return _directory; }
+
+    /*
+     * The dependency info to convert, and its format.
+     */
+    std::vector<std::pair<DependencyInfoFormat, std::string>> const &inputs() const
+    { return _inputs; }
+
+public:
+    /*
+     * Serialize a list of conversions.
+     */
+    static std::string
+    Serialize(std::vector<DependencyInfoConversion> const &conversions);
+
+    /*
+     * Parse a serialized list of conversions.
+     */
+    static ext::optional<std::vector<DependencyInfoConversion>>
+    Deserialize(std::string const &contents);
+};
+
+}
+
+#endif /* __dependency_DependencyInfoConversion_h */
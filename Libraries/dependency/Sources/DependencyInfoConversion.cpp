@@ -0,0 +1,131 @@
+/**
+ Copyright (c) 2015-present, Facebook, Inc.
+ All rights reserved.
+
+ This source code is licensed under the BSD-style license found in the
+ LICENSE file in the root directory of this source tree. An additional grant
+ of patent rights can be found in the PATENTS file in the same directory.
+ */
+
+#include <dependency/DependencyInfoConversion.h>
+
+using dependency::DependencyInfoConversion;
+using dependency::DependencyInfoFormat;
+using dependency::DependencyInfoFormats;
+
+DependencyInfoConversion::
+DependencyInfoConversion(
+    std::string const &name,
+    std::string const &output,
+    std::string const &directory,
+    std::vector<std::pair<DependencyInfoFormat, std::string>> const &inputs) :
+    _name     (name),
+    _output   (output),
+    _directory(directory),
+    _inputs   (inputs)
+{
+}
+
+/*
+ * The serialized format has one field per line, as "key value". Each
+ * conversion starts with its name and ends with an empty line. Paths
+ * can contain spaces, but not newlines; neither can Makefile rules.
+ */
+
+std::string DependencyInfoConversion::
+Serialize(std::vector<DependencyInfoConversion> const &conversions)
+{
+    std::string result;
+
+    for (DependencyInfoConversion const &conversion : conversions) {
+        result += "name " + conversion.name() + "\n";
+        result += "output " + conversion.output() + "\n";
+        result += "directory " + conversion.directory() + "\n";
+
+        for (std::pair<DependencyInfoFormat, std::string> const &input : conversion.inputs()) {
+            std::string format;
+            if (!DependencyInfoFormats::Name(input.first, &format)) {
+                continue;
+            }
+
+            result += "input " + format + ":" + input.second + "\n";
+        }
+
+        result += "\n";
+    }
+
+    return result;
+}
+
+ext::optional<std::vector<DependencyInfoConversion>> DependencyInfoConversion::
+Deserialize(std::string const &contents)
+{
+    std::vector<DependencyInfoConversion> conversions;
+
+    ext::optional<std::string> name;
+    ext::optional<std::string> output;
+    ext::optional<std::string> directory;
+    std::vector<std::pair<DependencyInfoFormat, std::string>> inputs;
+
+    std::string::size_type offset = 0;
+    while (offset < contents.size()) {
+        std::string::size_type end = contents.find('\n', offset);
+        if (end == std::string::npos) {
+            end = contents.size();
+        }
+
+        std::string line = contents.substr(offset, end - offset);
+        offset = end + 1;
+
+        if (line.empty()) {
+            /* End of a conversion. */
+            if (!name || !output || !directory) {
+                return ext::nullopt;
+            }
+
+            conversions.push_back(DependencyInfoConversion(*name, *output, *directory, inputs));
+            name = ext::nullopt;
+            output = ext::nullopt;
+            directory = ext::nullopt;
+            inputs.clear();
+            continue;
+        }
+
+        std::string::size_type space = line.find(' ');
+        if (space == std::string::npos) {
+            return ext::nullopt;
+        }
+
+        std::string key = line.substr(0, space);
+        std::string value = line.substr(space + 1);
+
+        if (key == "name") {
+            name = value;
+        } else if (key == "output") {
+            output = value;
+        } else if (key == "directory") {
+            directory = value;
+        } else if (key == "input") {
+            std::string::size_type colon = value.find(':');
+            if (colon == std::string::npos) {
+                return ext::nullopt;
+            }
+
+            DependencyInfoFormat format;
+            if (!DependencyInfoFormats::Parse(value.substr(0, colon), &format)) {
+                return ext::nullopt;
+            }
+
+            inputs.push_back({ format, value.substr(colon + 1) });
+        } else {
+            return ext::nullopt;
+        }
+    }
+
+    /* Unterminated conversion. */
+    if (name || output || directory || !inputs.empty()) {
+        return ext::nullopt;
+    }
+
+    return conversions;
+}
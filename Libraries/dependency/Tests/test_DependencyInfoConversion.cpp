@@ -0,0 +1,70 @@
+/**
+ Copyright (c) 2015-present, Facebook, Inc.
+ All rights reserved.
+
+ This source code is licensed under the BSD-style license found in the
+ LICENSE file in the root directory of this source tree. An additional grant
+ of patent rights can be found in the PATENTS file in the same directory.
+ */
+
+#include <gtest/gtest.h>
+#include <dependency/DependencyInfoConversion.h>
+
+using dependency::DependencyInfoConversion;
+using dependency::DependencyInfoFormat;
+
+TEST(DependencyInfoConversion, Empty)
+{
+    EXPECT_EQ(DependencyInfoConversion::Serialize({ }), "");
+
+    auto conversions = DependencyInfoConversion::Deserialize("");
+    ASSERT_TRUE(conversions);
+    EXPECT_TRUE(conversions->empty());
+}
+
+TEST(DependencyInfoConversion, RoundTrip)
+{
+    std::vector<DependencyInfoConversion> conversions = {
+        DependencyInfoConversion("/out/binary", "/tmp/binary.d", "/src", {
+            { DependencyInfoFormat::Binary, "/tmp/binary_dependency_info.dat" },
+        }),
+        DependencyInfoConversion("/out/With Space", "/tmp/copy.d", "/src dir", {
+            { DependencyInfoFormat::Directory, "relative/Resources" },
+            { DependencyInfoFormat::Makefile, "/tmp/file.d" },
+        }),
+    };
+
+    std::string serialized = DependencyInfoConversion::Serialize(conversions);
+    auto deserialized = DependencyInfoConversion::Deserialize(serialized);
+    ASSERT_TRUE(deserialized);
+    ASSERT_EQ(deserialized->size(), 2);
+
+    EXPECT_EQ(deserialized->at(0).name(), "/out/binary");
+    EXPECT_EQ(deserialized->at(0).output(), "/tmp/binary.d");
+    EXPECT_EQ(deserialized->at(0).directory(), "/src");
+    ASSERT_EQ(deserialized->at(0).inputs().size(), 1);
+    EXPECT_EQ(deserialized->at(0).inputs()[0].first, DependencyInfoFormat::Binary);
+    EXPECT_EQ(deserialized->at(0).inputs()[0].second, "/tmp/binary_dependency_info.dat");
+
+    EXPECT_EQ(deserialized->at(1).name(), "/out/With Space");
+    EXPECT_EQ(deserialized->at(1).directory(), "/src dir");
+    ASSERT_EQ(deserialized->at(1).inputs().size(), 2);
+    EXPECT_EQ(deserialized->at(1).inputs()[0].first, DependencyInfoFormat::Directory);
+    EXPECT_EQ(deserialized->at(1).inputs()[0].second, "relative/Resources");
+    EXPECT_EQ(deserialized->at(1).inputs()[1].first, DependencyInfoFormat::Makefile);
+}
+
+TEST(DependencyInfoConversion, Invalid)
+{
+    /* Unknown key. */
+    EXPECT_FALSE(DependencyInfoConversion::Deserialize("unknown value\n\n"));
+
+    /* Missing fields. */
+    EXPECT_FALSE(DependencyInfoConversion::Deserialize("name output\n\n"));
+
+    /* Unknown format. */
+    EXPECT_FALSE(DependencyInfoConversion::Deserialize("name n\noutput o\ndirectory d\ninput unknown:path\n\n"));
+
+    /* Unterminated. */
+    EXPECT_FALSE(DependencyInfoConversion::Deserialize("name n\noutput o\ndirectory d\n"));
+}
@@ -16,6 +16,7 @@
 #include <process/Context.h>
 
 #include <dependency/DependencyInfo.h>
+#include <dependency/DependencyInfoConversion.h>
 #include <dependency/BinaryDependencyInfo.h>
 #include <dependency/DirectoryDependencyInfo.h>
 #include <dependency/MakefileDependencyInfo.h>
@@ -37,6 +38,7 @@ private:
     std::vector<std::pair<dependency::DependencyInfoFormat, std::string>> _inputs;
     ext::optional<std::string> _output;
     ext::optional<std::string> _name;
+    ext::optional<std::string> _batch;
 
 public:
     Options();
@@ -55,6 +57,8 @@ public:
     { return _output; }
     ext::optional<std::string> const &name() const
     { return _name; }
+    ext::optional<std::string> const &batch() const
+    { return _batch; }
 
 private:
     friend class libutil::Options;
@@ -85,6 +89,8 @@ parseArgument(std::vector<std::string> const &args, std::vector<std::string>::co
         return libutil::Options::Next<std::string>(&_output, args, it);
     } else if (arg == "-n" || arg == "--name") {
         return libutil::Options::Next<std::string>(&_name, args, it);
+    } else if (arg == "-b" || arg == "--batch") {
+        return libutil::Options::Next<std::string>(&_batch, args, it);
     } else if (!arg.empty() && arg[0] != '-') {
         std::string::size_type offset = arg.find(':');
         if (offset != std::string::npos && offset != 0 && offset != arg.size() - 1) {
@@ -126,6 +132,7 @@ Help(std::string const &error = std::string())
     fprintf(stderr, "Conversion Options:\n");
     fprintf(stderr, INDENT "-o, --output\n");
     fprintf(stderr, INDENT "-n, --name\n");
+    fprintf(stderr, INDENT "-b, --batch <conversions>\n");
     fprintf(stderr, "\n");
 
     fprintf(stderr, "Inputs:\n");
@@ -216,6 +223,45 @@ SerializeMakefileDependencyInfo(std::string const &currentDirectory, std::string
     return makefileInfo.serialize();
 }
 
+static bool
+Convert(
+    Filesystem *filesystem,
+    std::string const &currentDirectory,
+    std::string const &name,
+    std::vector<std::pair<dependency::DependencyInfoFormat, std::string>> const &inputs,
+    std::string const &output)
+{
+    std::vector<std::string> paths;
+    for (std::pair<dependency::DependencyInfoFormat, std::string> const &input : inputs) {
+        /*
+         * Load the dependency info.
+         */
+        std::vector<dependency::DependencyInfo> info;
+        if (!LoadDependencyInfo(filesystem, FSUtil::ResolveRelativePath(input.second, currentDirectory), input.first, &info)) {
+            return false;
+        }
+
+        for (dependency::DependencyInfo const &dependencyInfo : info) {
+            paths.insert(paths.end(), dependencyInfo.inputs().begin(), dependencyInfo.inputs().end());
+        }
+    }
+
+    /*
+     * Serialize the output.
+     */
+    std::string contents = SerializeMakefileDependencyInfo(currentDirectory, name, paths);
+
+    /*
+     * Write out the output.
+     */
+    std::vector<uint8_t> makefileContents = std::vector<uint8_t>(contents.begin(), contents.end());
+    if (!filesystem->write(makefileContents, output)) {
+        return false;
+    }
+
+    return true;
+}
+
 int
 main(int argc, char **argv)
 {
@@ -241,37 +287,42 @@ main(int argc, char **argv)
     }
 
     /*
-     * Diagnose missing options.
+     * Convert a list of dependency info at once.
      */
-    if (options.inputs().empty() || !options.output() || !options.name()) {
-        return Help("missing option(s)");
-    }
+    if (options.batch()) {
+        if (!options.inputs().empty() || options.output() || options.name()) {
+            return Help("batch conversion cannot be combined with other inputs");
+        }
 
-    std::vector<std::string> inputs;
-    for (std::pair<dependency::DependencyInfoFormat, std::string> const &input : options.inputs()) {
-        /*
-         * Load the dependency info.
-         */
-        std::vector<dependency::DependencyInfo> info;
-        if (!LoadDependencyInfo(&filesystem, input.second, input.first, &info)) {
+        std::vector<uint8_t> contents;
+        if (!filesystem.read(&contents, *options.batch())) {
+            fprintf(stderr, "error: failed to open %s\n", options.batch()->c_str());
             return EXIT_FAILURE;
         }
 
-        for (dependency::DependencyInfo const &dependencyInfo : info) {
-            inputs.insert(inputs.end(), dependencyInfo.inputs().begin(), dependencyInfo.inputs().end());
+        auto conversions = dependency::DependencyInfoConversion::Deserialize(std::string(contents.begin(), contents.end()));
+        if (!conversions) {
+            fprintf(stderr, "error: invalid batch conversions\n");
+            return EXIT_FAILURE;
         }
+
+        for (dependency::DependencyInfoConversion const &conversion : *conversions) {
+            if (!Convert(&filesystem, conversion.directory(), conversion.name(), conversion.inputs(), conversion.output())) {
+                return EXIT_FAILURE;
+            }
+        }
+
+        return EXIT_SUCCESS;
     }
 
     /*
-     * Serialize the output.
+     * Diagnose missing options.
      */
-    std::string contents = SerializeMakefileDependencyInfo(processContext.currentDirectory(), *options.name(), inputs);
+    if (options.inputs().empty() || !options.output() || !options.name()) {
+        return Help("missing option(s)");
+    }
 
-    /*
-     * Write out the output.
-     */
-    std::vector<uint8_t> makefileContents = std::vector<uint8_t>(contents.begin(), contents.end());
-    if (!filesystem.write(makefileContents, *options.output())) {
+    if (!Convert(&filesystem, processContext.currentDirectory(), *options.name(), options.inputs(), *options.output())) {
         return EXIT_FAILURE;
     }
 
@@ -0,0 +1,260 @@
+/**
+ Copyright (c) 2015-present, Facebook, Inc.
+ All rights reserved.
+
+ This source code is licensed under the BSD-style license found in the
+ LICENSE file in the root directory of this source tree. An additional grant
+ of patent rights can be found in the PATENTS file in the same directory.
+ */
+
+#include <benchmark/Harness.h>
+#include <graphics/Format/PNG.h>
+#include <graphics/Image.h>
+#include <graphics/PixelFormat.h>
+#include <libutil/Options.h>
+#include <process/DefaultContext.h>
+
+#include <cstdio>
+#include <cstdlib>
+#include <thread>
+
+using benchmark::Harness;
+using graphics::Format::PNG;
+using graphics::Image;
+using graphics::PixelFormat;
+
+class Options {
+private:
+    ext::optional<bool>        _help;
+
+private:
+    ext::optional<int>         _width;
+    ext::optional<int>         _height;
+    ext::optional<int>         _images;
+    ext::optional<int>         _level;
+    ext::optional<int>         _threads;
+
+private:
+    ext::optional<bool>        _csv;
+
+public:
+    Options();
+    ~Options();
+
+public:
+    bool help() const
+    { return _help.value_or(false); }
+
+public:
+    int width() const
+    { return _width.value_or(2048); }
+    int height() const
+    { return _height.value_or(2048); }
+    int images() const
+    { return _images.value_or(64); }
+    int level() const
+    { return _level.value_or(6); }
+    int threads() const
+    { return _threads.value_or(static_cast<int>(std::thread::hardware_concurrency())); }
+
+public:
+    bool csv() const
+    { return _csv.value_or(false); }
+
+private:
+    friend class libutil::Options;
+    std::pair<bool, std::string>
+    parseArgument(std::vector<std::string> const &args, std::vector<std::string>::const_iterator *it);
+};
+
+Options::
+Options()
+{
+}
+
+Options::
+~Options()
+{
+}
+
+std::pair<bool, std::string> Options::
+parseArgument(std::vector<std::string> const &args, std::vector<std::string>::const_iterator *it)
+{
+    std::string const &arg = **it;
+
+    if (arg == "-h" || arg == "--help") {
+        return libutil::Options::Current<bool>(&_help, arg);
+    } else if (arg == "--width") {
+        return libutil::Options::Next<int>(&_width, args, it);
+    } else if (arg == "--height") {
+        return libutil::Options::Next<int>(&_height, args, it);
+    } else if (arg == "--images") {
+        return libutil::Options::Next<int>(&_images, args, it);
+    } else if (arg == "--level") {
+        return libutil::Options::Next<int>(&_level, args, it);
+    } else if (arg == "--threads") {
+        return libutil::Options::Next<int>(&_threads, args, it);
+    } else if (arg == "--csv") {
+        return libutil::Options::Current<bool>(&_csv, arg);
+    } else {
+        return std::make_pair(false, "unknown argument " + arg);
+    }
+}
+
+static int
+Help(std::string const &error = std::string())
+{
+    if (!error.empty()) {
+        fprintf(stderr, "error: %s\n", error.c_str());
+        fprintf(stderr, "\n");
+    }
+
+    fprintf(stderr, "Usage: bench_graphics_PNG [options]\n\n");
+    fprintf(stderr, "Measures writing one large PNG and reading a batch of small PNGs,\n");
+    fprintf(stderr, "on one thread and in parallel.\n\n");
+
+#define INDENT "  "
+    fprintf(stderr, "Options:\n");
+    fprintf(stderr, INDENT "--width <pixels> (of written image)\n");
+    fprintf(stderr, INDENT "--height <pixels> (of written image)\n");
+    fprintf(stderr, INDENT "--images <count> (in read batch)\n");
+    fprintf(stderr, INDENT "--level <0-9>\n");
+    fprintf(stderr, INDENT "--threads <count>\n");
+    fprintf(stderr, INDENT "--csv\n");
+    fprintf(stderr, "\n");
+#undef INDENT
+
+    return (error.empty() ? EXIT_SUCCESS : EXIT_FAILURE);
+}
+
+/*
+ * Generate an image with gradients and some noise, similar to artwork.
+ */
+static Image
+Generate(size_t width, size_t height, uint32_t seed)
+{
+    PixelFormat format = PixelFormat(PixelFormat::Color::RGB, PixelFormat::Order::Forward, PixelFormat::Alpha::Last);
+
+    std::vector<uint8_t> pixels;
+    pixels.reserve(width * height * format.bytesPerPixel());
+    for (size_t y = 0; y < height; y++) {
+        for (size_t x = 0; x < width; x++) {
+            seed = seed * 1103515245 + 12345;
+            uint8_t noise = static_cast<uint8_t>((seed >> 24) & 0x7);
+            pixels.push_back(static_cast<uint8_t>(x * 255 / width) ^ noise);
+            pixels.push_back(static_cast<uint8_t>(y * 255 / height) ^ noise);
+            pixels.push_back(static_cast<uint8_t>((x + y) / 4));
+            pixels.push_back(static_cast<uint8_t>(x < width / 2 ? 0xFF : 0x80));
+        }
+    }
+
+    return Image(width, height, format, pixels);
+}
+
+static std::string
+Threads(int threads)
+{
+    return std::to_string(threads) + (threads == 1 ? " thread" : " threads");
+}
+
+int
+main(int argc, char **argv)
+{
+    process::DefaultContext processContext = process::DefaultContext();
+
+    Options options;
+    std::pair<bool, std::string> result = libutil::Options::Parse<Options>(&options, processContext.commandLineArguments());
+    if (!result.first) {
+        return Help(result.second);
+    }
+
+    if (options.help()) {
+        return Help();
+    }
+
+    if (options.width() <= 0 || options.height() <= 0 || options.images() <= 0 || options.threads() <= 0) {
+        return Help("invalid count");
+    }
+    if (options.level() < 0 || options.level() > 9) {
+        return Help("invalid level");
+    }
+
+    Harness harness = Harness("graphics PNG " + std::to_string(options.width()) + "x" + std::to_string(options.height()) + " level=" + std::to_string(options.level()) + " threads=" + std::to_string(options.threads()));
+
+    ext::optional<Image> image;
+    harness.stage("Generate", [&]() -> bool {
+        image = Generate(options.width(), options.height(), 1);
+        return true;
+    });
+
+    std::vector<uint8_t> serial;
+    harness.stage("Write (1 thread)", [&]() -> bool {
+        auto write = PNG::Write(*image, options.level(), PNG::Filter::Adaptive, 1);
+        if (write.first) {
+            serial = std::move(*write.first);
+        }
+        return static_cast<bool>(write.first);
+    });
+
+    std::vector<uint8_t> parallel;
+    harness.stage("Write (" + Threads(options.threads()) + ")", [&]() -> bool {
+        auto write = PNG::Write(*image, options.level(), PNG::Filter::Adaptive, options.threads());
+        if (write.first) {
+            parallel = std::move(*write.first);
+        }
+        return static_cast<bool>(write.first);
+    });
+
+    std::vector<uint8_t> unfiltered;
+    harness.stage("Write (unfiltered)", [&]() -> bool {
+        auto write = PNG::Write(*image, options.level(), PNG::Filter::None, options.threads());
+        if (write.first) {
+            unfiltered = std::move(*write.first);
+        }
+        return static_cast<bool>(write.first);
+    });
+
+    harness.stage("Read", [&]() -> bool {
+        auto read = PNG::Read(parallel);
+        return read.first && read.first->data() == PixelFormat::Convert(image->data(), image->format(), read.first->format());
+    });
+
+    /* Icon sized images, as in an asset catalog. */
+    std::vector<std::vector<uint8_t>> batch;
+    harness.stage("Generate batch", [&]() -> bool {
+        for (int i = 0; i < options.images(); i++) {
+            auto write = PNG::Write(Generate(180, 180, i), options.level(), PNG::Filter::Adaptive, 1);
+            if (!write.first) {
+                return false;
+            }
+            batch.push_back(std::move(*write.first));
+        }
+        return true;
+    });
+
+    for (int threads : { 1, options.threads() }) {
+        harness.stage("Read batch (" + Threads(threads) + ")", [&]() -> bool {
+            for (auto const &read : PNG::ReadBatch(batch, threads)) {
+                if (!read.first) {
+                    return false;
+                }
+            }
+            return true;
+        });
+    }
+
+    if (options.csv()) {
+        harness.reportCSV(stdout, true);
+    } else {
+        harness.report(stdout);
+        fprintf(stdout, "Size: %zu bytes (adaptive), %zu bytes (unfiltered), output %s\n", parallel.size(), unfiltered.size(), (serial == parallel ? "matches" : "differs"));
+    }
+
+    for (Harness::Result const &result : harness.results()) {
+        if (!result.success()) {
+            return EXIT_FAILURE;
+        }
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -25,6 +25,20 @@ namespace Format {
  * Utilities for PNG images.
  */
 class PNG {
+public:
+    /*
+     * Filter applied to each row of pixels before it's compressed.
+     */
+    enum class Filter {
+        None,
+        Sub,
+        Up,
+        Average,
+        Paeth,
+        /* Pick the filter likely to compress best for each row. */
+        Adaptive,
+    };
+
 private:
     PNG();
     ~PNG();
@@ -36,12 +50,28 @@ public:
     static std::pair<ext::optional<Image>, std::string>
     Read(std::vector<uint8_t> const &contents);
 
+    /*
+     * Read PNG images on up to `threads` threads, by default one per
+     * processor. Results are in the same order as the contents.
+     */
+    static std::vector<std::pair<ext::optional<Image>, std::string>>
+    ReadBatch(std::vector<std::vector<uint8_t>> const &contents, ext::optional<size_t> threads = ext::nullopt);
+
 public:
     /*
-     * Write a PNG image.
+     * Write a PNG image, unfiltered and with the default compression.
      */
     static std::pair<ext::optional<std::vector<uint8_t>>, std::string>
     Write(Image const &image);
+
+    /*
+     * Write a PNG image with a zlib compression level, from 0 to 9 or -1
+     * for the default, and a row filter. Large images are compressed in
+     * chunks on up to `threads` threads, by default one per processor.
+     * The result is the same for any number of threads.
+     */
+    static std::pair<ext::optional<std::vector<uint8_t>>, std::string>
+    Write(Image const &image, int level, Filter filter, ext::optional<size_t> threads = ext::nullopt);
 };
 
 }
@@ -528,9 +528,236 @@ Read(std::vector<uint8_t> const &contents)
 
 #include <zlib.h>
 
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <thread>
+
+/*
+ * Run a function for each index, spread across up to `threads` threads.
+ */
+static void
+PNGParallel(size_t count, ext::optional<size_t> threads, std::function<void(size_t)> const &function)
+{
+    size_t jobs = std::min<size_t>(count, threads.value_or(std::max<size_t>(std::thread::hardware_concurrency(), 1)));
+
+    std::atomic<size_t> next = ATOMIC_VAR_INIT(0);
+    auto work = [&]() {
+        for (size_t index = next++; index < count; index = next++) {
+            function(index);
+        }
+    };
+
+    /* This thread is one of the jobs. */
+    std::vector<std::thread> workers;
+    for (size_t n = 1; n < jobs; n++) {
+        workers.emplace_back(work);
+    }
+    work();
+
+    for (std::thread &worker : workers) {
+        worker.join();
+    }
+}
+
+std::vector<std::pair<ext::optional<Image>, std::string>> PNG::
+ReadBatch(std::vector<std::vector<uint8_t>> const &contents, ext::optional<size_t> threads)
+{
+    std::vector<std::pair<ext::optional<Image>, std::string>> results = std::vector<std::pair<ext::optional<Image>, std::string>>(contents.size());
+    PNGParallel(contents.size(), threads, [&](size_t index) {
+        results[index] = Read(contents[index]);
+    });
+    return results;
+}
+
+/*
+ * Pixel data is compressed in chunks of about this many bytes, each on its
+ * own thread. Each chunk is primed with the end of the previous one, so it
+ * compresses about as well as if it were compressed all at once.
+ */
+static size_t const PNGChunkSize = 128 * 1024;
+
+/*
+ * The most of a previous chunk DEFLATE can refer back to.
+ */
+static size_t const PNGDictionarySize = 32 * 1024;
+
+static inline uint8_t
+PNGPaeth(uint8_t a, uint8_t b, uint8_t c)
+{
+    int p = a + b - c;
+    int pa = abs(p - a);
+    int pb = abs(p - b);
+    int pc = abs(p - c);
+
+    if (pa <= pb && pa <= pc) {
+        return a;
+    } else if (pb <= pc) {
+        return b;
+    } else {
+        return c;
+    }
+}
+
+/*
+ * Filter a row with one filter type, writing the type then the row.
+ * The prior row is null for the first row in the image.
+ */
+static void
+PNGFilterRow(uint8_t type, uint8_t const *row, uint8_t const *prior, size_t length, size_t bpp, uint8_t *out)
+{
+    out[0] = type;
+    out++;
+
+    for (size_t i = 0; i < length; i++) {
+        uint8_t a = (i >= bpp ? row[i - bpp] : 0);
+        uint8_t b = (prior != NULL ? prior[i] : 0);
+        uint8_t c = (i >= bpp && prior != NULL ? prior[i - bpp] : 0);
+
+        switch (type) {
+            case 0: out[i] = row[i]; break;
+            case 1: out[i] = row[i] - a; break;
+            case 2: out[i] = row[i] - b; break;
+            case 3: out[i] = row[i] - static_cast<uint8_t>((a + b) / 2); break;
+            case 4: out[i] = row[i] - PNGPaeth(a, b, c); break;
+            default: abort();
+        }
+    }
+}
+
+static void
+PNGFilter(PNG::Filter filter, uint8_t const *row, uint8_t const *prior, size_t length, size_t bpp, uint8_t *out, std::vector<uint8_t> *scratch)
+{
+    switch (filter) {
+        case PNG::Filter::None:
+            PNGFilterRow(0, row, prior, length, bpp, out);
+            break;
+        case PNG::Filter::Sub:
+            PNGFilterRow(1, row, prior, length, bpp, out);
+            break;
+        case PNG::Filter::Up:
+            PNGFilterRow(2, row, prior, length, bpp, out);
+            break;
+        case PNG::Filter::Average:
+            PNGFilterRow(3, row, prior, length, bpp, out);
+            break;
+        case PNG::Filter::Paeth:
+            PNGFilterRow(4, row, prior, length, bpp, out);
+            break;
+        case PNG::Filter::Adaptive: {
+            /*
+             * Like libpng, pick the filter with the smallest sum of its
+             * output as signed bytes: small values compress best.
+             */
+            scratch->resize(length + 1);
+
+            uint64_t best = UINT64_MAX;
+            for (uint8_t type = 0; type <= 4; type++) {
+                PNGFilterRow(type, row, prior, length, bpp, scratch->data());
+
+                uint64_t sum = 0;
+                for (size_t i = 1; i <= length; i++) {
+                    sum += abs(static_cast<int8_t>((*scratch)[i]));
+                }
+
+                if (sum < best) {
+                    best = sum;
+                    memcpy(out, scratch->data(), length + 1);
+                }
+            }
+            break;
+        }
+        default: abort();
+    }
+}
+
+/*
+ * The zlib header for a compression level, as `deflate()` writes it.
+ */
+static void
+PNGZlibHeader(int level, uint8_t *header)
+{
+    if (level == Z_DEFAULT_COMPRESSION) {
+        level = 6;
+    }
+
+    unsigned int flags = (level < 2 ? 0 : level < 6 ? 1 : level == 6 ? 2 : 3);
+    unsigned int value = ((Z_DEFLATED + ((MAX_WBITS - 8) << 4)) << 8) | (flags << 6);
+    value += 31 - (value % 31);
+
+    header[0] = static_cast<uint8_t>(value >> 8);
+    header[1] = static_cast<uint8_t>(value & 0xff);
+}
+
+/*
+ * Compress data with DEFLATE, into a zlib stream. If `raw`, there is no
+ * zlib header or checksum, and the stream is only finished if `last`. Data
+ * before `input` is used as the dictionary, to refer back to.
+ */
+static bool
+PNGDeflate(uint8_t const *input, size_t length, size_t dictionary, int level, int strategy, bool raw, bool last, std::vector<uint8_t> *output)
+{
+    z_stream strm;
+    strm.zalloc = Z_NULL;
+    strm.zfree = Z_NULL;
+    strm.opaque = Z_NULL;
+
+    int ret = deflateInit2(&strm, level, Z_DEFLATED, (raw ? -MAX_WBITS : MAX_WBITS), 8, strategy);
+    if (ret != Z_OK) {
+        return false;
+    }
+
+    if (dictionary > 0) {
+        if (deflateSetDictionary(&strm, input - dictionary, dictionary) != Z_OK) {
+            deflateEnd(&strm);
+            return false;
+        }
+    }
+
+    /* Room for the compressed data and a sync flush. */
+    *output = std::vector<uint8_t>(deflateBound(&strm, length) + 16);
+
+    strm.avail_in = length;
+    strm.next_in = const_cast<Bytef *>(input);
+
+    int flush = (last ? Z_FINISH : Z_SYNC_FLUSH);
+    do {
+        if (strm.total_out == output->size()) {
+            output->resize(output->size() * 2);
+        }
+
+        strm.avail_out = output->size() - strm.total_out;
+        strm.next_out = output->data() + strm.total_out;
+
+        ret = deflate(&strm, flush);
+        if (ret != Z_OK && ret != Z_STREAM_END && ret != Z_BUF_ERROR) {
+            deflateEnd(&strm);
+            return false;
+        }
+    } while (last ? ret != Z_STREAM_END : (strm.avail_in != 0 || strm.avail_out == 0));
+
+    /* Shrink down to compressed size. */
+    output->resize(strm.total_out);
+
+    deflateEnd(&strm);
+    return true;
+}
+
 std::pair<ext::optional<std::vector<uint8_t>>, std::string> PNG::
 Write(Image const &image)
 {
+    return Write(image, Z_DEFAULT_COMPRESSION, Filter::None);
+}
+
+std::pair<ext::optional<std::vector<uint8_t>>, std::string> PNG::
+Write(Image const &image, int level, Filter filter, ext::optional<size_t> threads)
+{
+    if (level < Z_DEFAULT_COMPRESSION || level > Z_BEST_COMPRESSION) {
+        return std::make_pair(ext::nullopt, "invalid compression level");
+    }
+
     std::vector<uint8_t> png;
 
     uint32_t const crc32_initial = crc32(0, NULL, 0);
@@ -617,52 +844,81 @@ Write(Image const &image)
     png.insert(png.end(), std::begin(ihdr_crc32), std::end(ihdr_crc32));
 
     /*
-     * Compress the pixel data with DEFLATE.
+     * Filter each row, prefixed with the filter it used.
      */
-    z_stream strm;
-    strm.zalloc = Z_NULL;
-    strm.zfree = Z_NULL;
-    strm.opaque = Z_NULL;
-
-    int ret = deflateInit2(&strm, Z_DEFAULT_COMPRESSION, 8, 15, 8, Z_DEFAULT_STRATEGY);
-    if (ret != Z_OK) {
-        return std::make_pair(ext::nullopt, "deflate init failed");
-    }
-
-    /* Add filter bytes between rows in the image. */
-    uint32_t filter_stride = image.width() * format.bytesPerPixel();
-    size_t filter_size = (data.size() / filter_stride);
-    std::vector<uint8_t> buffer = std::vector<uint8_t>(data.size() + filter_size);
-    for (size_t i = 0; i < image.height(); i++) {
-        size_t offset = (i * filter_stride);
-        size_t filter_offset = i;
+    size_t bpp = format.bytesPerPixel();
+    size_t stride = image.width() * bpp;
+    size_t rows = image.height();
+    std::vector<uint8_t> buffer = std::vector<uint8_t>(rows * (stride + 1));
+
+    size_t rowsPerChunk = std::max<size_t>(PNGChunkSize / (stride + 1), 1);
+    size_t chunks = std::max<size_t>((rows + rowsPerChunk - 1) / rowsPerChunk, 1);
+
+    PNGParallel(chunks, threads, [&](size_t chunk) {
+        std::vector<uint8_t> scratch;
+        for (size_t row = chunk * rowsPerChunk; row < std::min(rows, (chunk + 1) * rowsPerChunk); row++) {
+            uint8_t const *prior = (row > 0 ? data.data() + (row - 1) * stride : NULL);
+            PNGFilter(filter, data.data() + row * stride, prior, stride, bpp, buffer.data() + row * (stride + 1), &scratch);
+        }
+    });
 
-        *(buffer.data() + offset + filter_offset) = 0; // filter format
-        memcpy(buffer.data() + offset + filter_offset + 1, data.data() + offset, filter_stride);
-    }
+    /* Like libpng, use the strategy zlib has for filtered data. */
+    int strategy = (filter == Filter::None ? Z_DEFAULT_STRATEGY : Z_FILTERED);
 
-    strm.avail_in = buffer.size();
-    strm.next_in = buffer.data();
+    /*
+     * Compress the pixel data with DEFLATE.
+     */
+    std::vector<uint8_t> compressed;
+    if (chunks == 1) {
+        if (!PNGDeflate(buffer.data(), buffer.size(), 0, level, strategy, false, true, &compressed)) {
+            return std::make_pair(ext::nullopt, "deflate failed");
+        }
+    } else {
+        /*
+         * Compress chunks in parallel, like pigz. Each chunk but the last
+         * ends with a sync flush, so they join into a single stream.
+         */
+        std::vector<std::vector<uint8_t>> deflated = std::vector<std::vector<uint8_t>>(chunks);
+        std::vector<uLong> checksums = std::vector<uLong>(chunks);
+        std::vector<size_t> lengths = std::vector<size_t>(chunks);
+        std::atomic<bool> failed = ATOMIC_VAR_INIT(false);
+
+        PNGParallel(chunks, threads, [&](size_t chunk) {
+            size_t begin = chunk * rowsPerChunk * (stride + 1);
+            size_t end = std::min(buffer.size(), (chunk + 1) * rowsPerChunk * (stride + 1));
+            size_t dictionary = std::min(begin, PNGDictionarySize);
+
+            if (!PNGDeflate(buffer.data() + begin, end - begin, dictionary, level, strategy, true, chunk == chunks - 1, &deflated[chunk])) {
+                failed = true;
+            }
+            checksums[chunk] = adler32(adler32(0, NULL, 0), buffer.data() + begin, end - begin);
+            lengths[chunk] = end - begin;
+        });
+
+        if (failed) {
+            return std::make_pair(ext::nullopt, "deflate failed");
+        }
 
-    /* Maximum compressed size is x1.01 + 12 the uncompressed size. */
-    std::vector<uint8_t> compressed = std::vector<uint8_t>(static_cast<size_t>(buffer.size() * 1.01) + 12);
+        uint8_t zlib_header[2];
+        PNGZlibHeader(level, zlib_header);
+        compressed.insert(compressed.end(), std::begin(zlib_header), std::end(zlib_header));
 
-    do {
-        strm.avail_out = compressed.size() - strm.total_out;
-        strm.next_out = (Bytef *)(compressed.data() + strm.total_out);
+        uLong checksum = checksums[0];
+        for (size_t chunk = 0; chunk < chunks; chunk++) {
+            compressed.insert(compressed.end(), deflated[chunk].begin(), deflated[chunk].end());
 
-        ret = deflate(&strm, Z_FINISH);
-        if (ret != Z_OK && ret != Z_STREAM_END) {
-            return std::make_pair(ext::nullopt, "deflate failed");
+            if (chunk > 0) {
+                checksum = adler32_combine(checksum, checksums[chunk], lengths[chunk]);
+            }
         }
-    } while (ret != Z_STREAM_END);
 
-    /* Shrink down to compressed size. */
-    compressed.resize(strm.total_out);
-
-    ret = deflateEnd(&strm);
-    if (ret != Z_OK) {
-        return std::make_pair(ext::nullopt, "deflate end failed");
+        uint8_t const zlib_checksum[] = {
+            static_cast<uint8_t>(checksum >> 24),
+            static_cast<uint8_t>(checksum >> 16),
+            static_cast<uint8_t>(checksum >> 8),
+            static_cast<uint8_t>(checksum),
+        };
+        compressed.insert(compressed.end(), std::begin(zlib_checksum), std::end(zlib_checksum));
     }
 
     /*
@@ -156,3 +156,129 @@ TEST(PNG, Write)
         EXPECT_EQ(*result.first, png);
     }
 }
+
+/*
+ * An image large enough to be compressed in several chunks, with both
+ * smooth gradients and noise so every filter has something to do.
+ */
+static Image
+LargeImage(PixelFormat const &format, size_t width, size_t height)
+{
+    std::vector<uint8_t> pixels;
+    uint32_t noise = 1;
+    for (size_t y = 0; y < height; y++) {
+        for (size_t x = 0; x < width; x++) {
+            for (size_t c = 0; c < format.bytesPerPixel(); c++) {
+                noise = noise * 1103515245 + 12345;
+                uint8_t value = static_cast<uint8_t>(x + y * (c + 1));
+                if ((x / 16 + y / 16) % 2 == 0) {
+                    value ^= static_cast<uint8_t>(noise >> 24);
+                }
+                pixels.push_back(value);
+            }
+        }
+    }
+
+    return Image(width, height, format, pixels);
+}
+
+static std::vector<PixelFormat>
+RoundTripFormats()
+{
+    return {
+        PixelFormat(PixelFormat::Color::Grayscale, PixelFormat::Order::Forward, PixelFormat::Alpha::None),
+        PixelFormat(PixelFormat::Color::Grayscale, PixelFormat::Order::Forward, PixelFormat::Alpha::Last),
+        PixelFormat(PixelFormat::Color::RGB, PixelFormat::Order::Forward, PixelFormat::Alpha::None),
+        PixelFormat(PixelFormat::Color::RGB, PixelFormat::Order::Forward, PixelFormat::Alpha::Last),
+    };
+}
+
+TEST(PNG, RoundTrip)
+{
+    std::vector<PNG::Filter> filters = {
+        PNG::Filter::None,
+        PNG::Filter::Sub,
+        PNG::Filter::Up,
+        PNG::Filter::Average,
+        PNG::Filter::Paeth,
+        PNG::Filter::Adaptive,
+    };
+
+    for (PixelFormat const &format : RoundTripFormats()) {
+        Image image = LargeImage(format, 301, 257);
+
+        for (PNG::Filter filter : filters) {
+            for (int level : { 0, 1, -1 }) {
+                /* Should write the same PNG on any number of threads. */
+                auto serial = PNG::Write(image, level, filter, 1);
+                ASSERT_NE(serial.first, ext::nullopt);
+                auto parallel = PNG::Write(image, level, filter, 4);
+                ASSERT_NE(parallel.first, ext::nullopt);
+                EXPECT_EQ(*serial.first, *parallel.first);
+
+                /* Should read back exactly the same pixels. */
+                auto result = PNG::Read(*parallel.first);
+                ASSERT_NE(result.first, ext::nullopt) << result.second;
+                EXPECT_EQ(image.width(), result.first->width());
+                EXPECT_EQ(image.height(), result.first->height());
+                EXPECT_EQ(image.data(), PixelFormat::Convert(result.first->data(), result.first->format(), format));
+            }
+        }
+    }
+}
+
+TEST(PNG, RoundTripLevels)
+{
+    PixelFormat format = RoundTripFormats().back();
+    Image image = LargeImage(format, 512, 300);
+
+    /* Higher levels should not compress worse. */
+    size_t previous = SIZE_MAX;
+    for (int level : { 0, 1, 6, 9 }) {
+        auto write = PNG::Write(image, level, PNG::Filter::Adaptive);
+        ASSERT_NE(write.first, ext::nullopt);
+        EXPECT_LE(write.first->size(), previous);
+        previous = write.first->size();
+
+        auto result = PNG::Read(*write.first);
+        ASSERT_NE(result.first, ext::nullopt) << result.second;
+        EXPECT_EQ(image.data(), PixelFormat::Convert(result.first->data(), result.first->format(), format));
+    }
+
+    /* Invalid levels are an error. */
+    EXPECT_EQ(ext::nullopt, PNG::Write(image, 10, PNG::Filter::None).first);
+    EXPECT_EQ(ext::nullopt, PNG::Write(image, -2, PNG::Filter::None).first);
+}
+
+TEST(PNG, ReadBatch)
+{
+    std::vector<Image> images;
+    std::vector<std::vector<uint8_t>> contents;
+    for (PixelFormat const &format : RoundTripFormats()) {
+        for (size_t size : { 1, 17, 200 }) {
+            Image image = LargeImage(format, size, size + 3);
+            auto write = PNG::Write(image, -1, PNG::Filter::Paeth);
+            ASSERT_NE(write.first, ext::nullopt);
+
+            images.push_back(image);
+            contents.push_back(*write.first);
+        }
+    }
+
+    /* Not a PNG. */
+    contents.push_back(std::vector<uint8_t>({ 'n', 'o', 't' }));
+
+    auto results = PNG::ReadBatch(contents, 3);
+    ASSERT_EQ(contents.size(), results.size());
+
+    /* Results should be in order. */
+    for (size_t i = 0; i < images.size(); i++) {
+        ASSERT_NE(results[i].first, ext::nullopt) << results[i].second;
+        EXPECT_EQ(images[i].width(), results[i].first->width());
+        EXPECT_EQ(images[i].height(), results[i].first->height());
+        EXPECT_EQ(images[i].data(), PixelFormat::Convert(results[i].first->data(), results[i].first->format(), images[i].format()));
+    }
+
+    EXPECT_EQ(ext::nullopt, results.back().first);
+    EXPECT_FALSE(results.back().second.empty());
+}
@@ -118,6 +118,13 @@ bom_tree_reserve(struct bom_tree_context *tree, size_t count);
 void
 bom_tree_add(struct bom_tree_context *tree, const void *key, size_t key_len, const void *value, size_t value_len);
 
+/*
+ * Add an entry whose value is already in the BOM, at an index. Entries
+ * can share a value this way.
+ */
+void
+bom_tree_add_index(struct bom_tree_context *tree, const void *key, size_t key_len, uint32_t value_index);
+
 
 #ifdef __cplusplus
 }
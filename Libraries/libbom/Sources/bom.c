@@ -163,6 +163,11 @@ _bom_address_update(uint32_t address, uint32_t point, ptrdiff_t delta)
 static void
 _bom_address_update_all(struct bom_context *context, uint32_t point, ptrdiff_t delta)
 {
+    /* Nothing starts past the end, so appending doesn't move anything. */
+    if (point >= context->memory.size) {
+        return;
+    }
+
     struct bom_header *header = (struct bom_header *)context->memory.data;
 
     /* Update offsets for each index. */
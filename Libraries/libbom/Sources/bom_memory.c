@@ -95,7 +95,7 @@ _bom_context_memory_mremap(struct bom_context_memory *memory, size_t size)
     assert(memory->data != NULL);
 #else
     munmap(memory->data, memory->size);
-    if (size > memory->size) {
+    if (size != memory->size) {
         int ret = ftruncate(context->fd, size);
         assert(ret == 0);
         (void)ret;
@@ -187,6 +187,81 @@ bom_tree_iterate(struct bom_tree_context *tree_context, bom_tree_iterator iterat
     tree_context->tree_iterating--;
 }
 
+/*
+ * Trees have at most two levels. The root is either a single leaf, or
+ * points to leaves that are linked to each other in key order. In that
+ * case each root entry holds a leaf and the last key in that leaf.
+ *
+ * Leaves hold as many entries as fit in the tree's node size. A full leaf
+ * is split in two, so adding an entry moves at most one leaf of entries.
+ * Once the root can't point to any more leaves, leaves grow instead.
+ */
+
+static size_t
+_bom_tree_node_capacity(struct bom_tree *tree)
+{
+    size_t node_size = ntohl(tree->node_size);
+    if (node_size < sizeof(struct bom_tree_entry) + sizeof(struct bom_tree_entry_indexes) * 2) {
+        return UINT16_MAX;
+    }
+
+    size_t capacity = (node_size - sizeof(struct bom_tree_entry)) / sizeof(struct bom_tree_entry_indexes);
+    return capacity < UINT16_MAX ? capacity : UINT16_MAX;
+}
+
+/*
+ * Compare a key with the key at an index. Keys are ordered by their bytes,
+ * then shorter keys first.
+ */
+static int
+_bom_tree_key_compare(struct bom_context *context, const void *key, size_t key_len, uint32_t other_index)
+{
+    size_t other_len;
+    void *other_key = bom_index_get(context, other_index, &other_len);
+    if (other_key == NULL) {
+        return -1;
+    }
+
+    int result = memcmp(key, other_key, other_len < key_len ? other_len : key_len);
+    if (result == 0 && key_len != other_len) {
+        result = key_len < other_len ? -1 : 1;
+    }
+    return result;
+}
+
+/*
+ * Add a leaf holding entries copied from another, linked after it.
+ */
+static uint32_t
+_bom_tree_leaf_add(struct bom_context *context, size_t capacity, uint32_t previous_index, struct bom_tree_entry_indexes const *indexes, size_t count)
+{
+    size_t leaf_len = sizeof(struct bom_tree_entry) + sizeof(struct bom_tree_entry_indexes) * capacity;
+    struct bom_tree_entry *leaf = calloc(1, leaf_len);
+    if (leaf == NULL) {
+        return 0;
+    }
+
+    struct bom_tree_entry *previous = (struct bom_tree_entry *)bom_index_get(context, previous_index, NULL);
+    leaf->is_leaf = htons(1);
+    leaf->count = htons(count);
+    leaf->forward = previous->forward;
+    leaf->backward = htonl(previous_index);
+    memcpy(leaf->indexes, indexes, sizeof(struct bom_tree_entry_indexes) * count);
+
+    uint32_t leaf_index = bom_index_add(context, leaf, leaf_len);
+    free(leaf);
+
+    /* Re-fetch after add invalidation. */
+    previous = (struct bom_tree_entry *)bom_index_get(context, previous_index, NULL);
+    if (previous->forward != htonl(0)) {
+        struct bom_tree_entry *next = (struct bom_tree_entry *)bom_index_get(context, ntohl(previous->forward), NULL);
+        next->backward = htonl(leaf_index);
+    }
+    previous->forward = htonl(leaf_index);
+
+    return leaf_index;
+}
+
 void
 bom_tree_reserve(struct bom_tree_context *tree_context, size_t count)
 {
@@ -196,36 +271,105 @@ bom_tree_reserve(struct bom_tree_context *tree_context, size_t count)
     uint32_t tree_index = bom_variable_get(tree_context->context, tree_context->variable_name);
     struct bom_tree *tree = (struct bom_tree *)bom_index_get(tree_context->context, tree_index, NULL);
 
+    /* Entries past one leaf go in new leaves. */
+    size_t capacity = _bom_tree_node_capacity(tree);
+    if (count > capacity) {
+        count = capacity;
+    }
+
     uint32_t paths_index = ntohl(tree->child);
     bom_index_append(tree_context->context, paths_index, sizeof(struct bom_tree_entry_indexes) * count);
 }
 
-void
-bom_tree_add(struct bom_tree_context *tree_context, const void *key, size_t key_len, const void *value, size_t value_len)
+static void
+_bom_tree_insert(struct bom_tree_context *tree_context, const void *key, size_t key_len, uint32_t key_index, uint32_t value_index)
 {
-    assert(tree_context != NULL);
-    assert(key != NULL);
-    assert(value != NULL);
-    assert(tree_context->tree_iterating == 0);
-
-    uint32_t key_index = bom_index_add(tree_context->context, key, key_len);
-    uint32_t value_index = bom_index_add(tree_context->context, value, value_len);
-
-    uint32_t tree_index = bom_variable_get(tree_context->context, tree_context->variable_name);
-    struct bom_tree *tree = (struct bom_tree *)bom_index_get(tree_context->context, tree_index, NULL);
+    struct bom_context *context = tree_context->context;
+
+    uint32_t tree_index = bom_variable_get(context, tree_context->variable_name);
+    struct bom_tree *tree = (struct bom_tree *)bom_index_get(context, tree_index, NULL);
+    size_t capacity = _bom_tree_node_capacity(tree);
+
+    uint32_t root_index = ntohl(tree->child);
+    size_t root_length;
+    struct bom_tree_entry *root = (struct bom_tree_entry *)bom_index_get(context, root_index, &root_length);
+
+    /* Find the leaf for the key: the first whose last key isn't before it. */
+    uint32_t paths_index = root_index;
+    size_t slot = 0;
+    if (!root->is_leaf) {
+        size_t start_range = 0;
+        size_t end_range = ntohs(root->count) - 1;
+        while (start_range < end_range) {
+            size_t middle = (end_range - start_range) / 2 + start_range;
+            if (_bom_tree_key_compare(context, key, key_len, ntohl(root->indexes[middle].key_index)) <= 0) {
+                end_range = middle;
+            } else {
+                start_range = middle + 1;
+            }
+        }
 
-    uint32_t paths_index = ntohl(tree->child);
+        slot = start_range;
+        paths_index = ntohl(root->indexes[slot].value_index);
+    }
 
     size_t paths_length;
-    struct bom_tree_entry *paths = (struct bom_tree_entry *)bom_index_get(tree_context->context, paths_index, &paths_length);
+    struct bom_tree_entry *paths = (struct bom_tree_entry *)bom_index_get(context, paths_index, &paths_length);
+
+    if (ntohs(paths->count) >= capacity && (root->is_leaf || ntohs(root->count) < capacity)) {
+        if (root->is_leaf) {
+            /* Move the root's entries to a leaf, and point the root to it. */
+            uint32_t leaf_index = _bom_tree_leaf_add(context, capacity, root_index, root->indexes, 0);
+
+            root = (struct bom_tree_entry *)bom_index_get(context, root_index, NULL);
+            struct bom_tree_entry *leaf = (struct bom_tree_entry *)bom_index_get(context, leaf_index, NULL);
+            memcpy(leaf->indexes, root->indexes, sizeof(struct bom_tree_entry_indexes) * ntohs(root->count));
+            leaf->count = root->count;
+            leaf->forward = htonl(0);
+            leaf->backward = htonl(0);
+
+            root->is_leaf = htons(0);
+            root->forward = htonl(0);
+            root->indexes[0].value_index = htonl(leaf_index);
+            root->indexes[0].key_index = leaf->indexes[ntohs(leaf->count) - 1].key_index;
+            root->count = htons(1);
+
+            slot = 0;
+            paths_index = leaf_index;
+            paths = leaf;
+        }
 
-    if ((ntohs(paths->count) + 1) * sizeof(struct bom_tree_entry_indexes) > paths_length) {
+        /* Split the leaf, moving its second half to a new leaf after it. */
+        size_t count = ntohs(paths->count);
+        size_t half = count / 2;
+        uint32_t next_index = _bom_tree_leaf_add(context, capacity, paths_index, &paths->indexes[half], count - half);
+
+        /* Re-fetch after add invalidation. */
+        root = (struct bom_tree_entry *)bom_index_get(context, root_index, NULL);
+        paths = (struct bom_tree_entry *)bom_index_get(context, paths_index, &paths_length);
+        paths->count = htons(half);
+
+        /* The root has room; it was a full leaf when it became the root. */
+        size_t root_count = ntohs(root->count);
+        memmove(&root->indexes[slot + 2], &root->indexes[slot + 1], (root_count - slot - 1) * sizeof(struct bom_tree_entry_indexes));
+        root->indexes[slot + 1].value_index = htonl(next_index);
+        root->indexes[slot + 1].key_index = root->indexes[slot].key_index;
+        root->indexes[slot].key_index = paths->indexes[half - 1].key_index;
+        root->count = htons(root_count + 1);
+
+        if (_bom_tree_key_compare(context, key, key_len, ntohl(root->indexes[slot].key_index)) > 0) {
+            slot++;
+            paths_index = next_index;
+            paths = (struct bom_tree_entry *)bom_index_get(context, paths_index, &paths_length);
+        }
+    }
+
+    if (sizeof(struct bom_tree_entry) + (ntohs(paths->count) + 1) * sizeof(struct bom_tree_entry_indexes) > paths_length) {
         /* Make room for the new index, extending the size as necessary. */
-        bom_index_append(tree_context->context, paths_index, sizeof(struct bom_tree_entry_indexes));
+        bom_index_append(context, paths_index, sizeof(struct bom_tree_entry_indexes));
 
         /* Re-fetch after append invalidation. */
-        tree = (struct bom_tree *)bom_index_get(tree_context->context, tree_index, NULL);
-        paths = (struct bom_tree_entry *)bom_index_get(tree_context->context, paths_index, &paths_length);
+        paths = (struct bom_tree_entry *)bom_index_get(context, paths_index, &paths_length);
     }
 
     size_t last_index = ntohs(paths->count);
@@ -240,15 +384,9 @@ bom_tree_add(struct bom_tree_context *tree_context, const void *key, size_t key_
         entry_index = delta / 2 + start_range;
         struct bom_tree_entry_indexes *other_index = &paths->indexes[entry_index];
 
-        size_t other_len;
-        void *other_key = bom_index_get(tree_context->context, ntohl(other_index->key_index), &other_len);
-
         /* Check the ordering for the candidate key and the existing key value. If the values are
            seemingly identical, order shorter keys first. */
-        int result = other_key == NULL ? -1 : memcmp(key, other_key, other_len < key_len ? other_len : key_len);
-        if (result == 0 && key_len != other_len) {
-            result = key_len < other_len ? -1 : 1;
-        }
+        int result = _bom_tree_key_compare(context, key, key_len, ntohl(other_index->key_index));
 
         if (result < 0) {
             /* If comparing c in [a,b,c,d,e], then choose [a,b,c] as the
@@ -265,6 +403,11 @@ bom_tree_add(struct bom_tree_context *tree_context, const void *key, size_t key_
         }
     }
 
+    /* Past the end of the range, when the range is empty or the key sorts last. */
+    if (start_range == end_range) {
+        entry_index = start_range;
+    }
+
     /* Set the indexes for the inserted entry after shifting all other data */
     struct bom_tree_entry_indexes *indexes = &paths->indexes[entry_index];
     if (entry_index < last_index) {
@@ -272,8 +415,39 @@ bom_tree_add(struct bom_tree_context *tree_context, const void *key, size_t key_
     }
     indexes->key_index = htonl(key_index);
     indexes->value_index = htonl(value_index);
+    paths->count = htons(ntohs(paths->count) + 1);
+
+    /* A new last key of a leaf is its key in the root. */
+    root = (struct bom_tree_entry *)bom_index_get(context, root_index, NULL);
+    if (!root->is_leaf && entry_index == last_index) {
+        root->indexes[slot].key_index = htonl(key_index);
+    }
 
     /* Update counts for inserted entry. */
+    tree = (struct bom_tree *)bom_index_get(context, tree_index, NULL);
     tree->path_count = htonl(ntohl(tree->path_count) + 1);
-    paths->count = htons(ntohs(paths->count) + 1);
+}
+
+void
+bom_tree_add(struct bom_tree_context *tree_context, const void *key, size_t key_len, const void *value, size_t value_len)
+{
+    assert(tree_context != NULL);
+    assert(key != NULL);
+    assert(value != NULL);
+    assert(tree_context->tree_iterating == 0);
+
+    uint32_t key_index = bom_index_add(tree_context->context, key, key_len);
+    uint32_t value_index = bom_index_add(tree_context->context, value, value_len);
+    _bom_tree_insert(tree_context, key, key_len, key_index, value_index);
+}
+
+void
+bom_tree_add_index(struct bom_tree_context *tree_context, const void *key, size_t key_len, uint32_t value_index)
+{
+    assert(tree_context != NULL);
+    assert(key != NULL);
+    assert(tree_context->tree_iterating == 0);
+
+    uint32_t key_index = bom_index_add(tree_context->context, key, key_len);
+    _bom_tree_insert(tree_context, key, key_len, key_index, value_index);
 }
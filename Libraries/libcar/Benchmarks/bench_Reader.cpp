@@ -0,0 +1,269 @@
+/**
+ Copyright (c) 2015-present, Facebook, Inc.
+ All rights reserved.
+
+ This source code is licensed under the BSD-style license found in the
+ LICENSE file in the root directory of this source tree. An additional grant
+ of patent rights can be found in the PATENTS file in the same directory.
+ */
+
+#include <benchmark/Harness.h>
+#include <bom/bom.h>
+#include <car/AttributeList.h>
+#include <car/Facet.h>
+#include <car/Reader.h>
+#include <car/Rendition.h>
+#include <car/Writer.h>
+#include <libutil/DefaultFilesystem.h>
+#include <libutil/FSUtil.h>
+#include <libutil/Options.h>
+#include <process/DefaultContext.h>
+
+#include <random>
+
+#include <cstdio>
+#include <cstdlib>
+
+using benchmark::Harness;
+using libutil::DefaultFilesystem;
+using libutil::FSUtil;
+
+class Options {
+private:
+    ext::optional<bool>        _help;
+
+private:
+    ext::optional<int>         _renditions;
+    ext::optional<int>         _lookups;
+
+private:
+    ext::optional<bool>        _csv;
+
+public:
+    Options();
+    ~Options();
+
+public:
+    bool help() const
+    { return _help.value_or(false); }
+
+public:
+    int renditions() const
+    { return _renditions.value_or(100000); }
+    int lookups() const
+    { return _lookups.value_or(100000); }
+
+public:
+    bool csv() const
+    { return _csv.value_or(false); }
+
+private:
+    friend class libutil::Options;
+    std::pair<bool, std::string>
+    parseArgument(std::vector<std::string> const &args, std::vector<std::string>::const_iterator *it);
+};
+
+Options::
+Options()
+{
+}
+
+Options::
+~Options()
+{
+}
+
+std::pair<bool, std::string> Options::
+parseArgument(std::vector<std::string> const &args, std::vector<std::string>::const_iterator *it)
+{
+    std::string const &arg = **it;
+
+    if (arg == "-h" || arg == "--help") {
+        return libutil::Options::Current<bool>(&_help, arg);
+    } else if (arg == "--renditions") {
+        return libutil::Options::Next<int>(&_renditions, args, it);
+    } else if (arg == "--lookups") {
+        return libutil::Options::Next<int>(&_lookups, args, it);
+    } else if (arg == "--csv") {
+        return libutil::Options::Current<bool>(&_csv, arg);
+    } else {
+        return std::make_pair(false, "unknown argument " + arg);
+    }
+}
+
+static int
+Help(std::string const &error = std::string())
+{
+    if (!error.empty()) {
+        fprintf(stderr, "error: %s\n", error.c_str());
+        fprintf(stderr, "\n");
+    }
+
+    fprintf(stderr, "Usage: bench_car_Reader [options]\n\n");
+    fprintf(stderr, "Measures opening a large generated asset archive, looking up\n");
+    fprintf(stderr, "renditions by attributes, and iterating all of them.\n\n");
+
+#define INDENT "  "
+    fprintf(stderr, "Options:\n");
+    fprintf(stderr, INDENT "--renditions <count> (in generated archive)\n");
+    fprintf(stderr, INDENT "--lookups <count> (of random renditions)\n");
+    fprintf(stderr, INDENT "--csv\n");
+    fprintf(stderr, "\n");
+#undef INDENT
+
+    return (error.empty() ? EXIT_SUCCESS : EXIT_FAILURE);
+}
+
+/* Each facet has a rendition at each scale. */
+static int const ScaleCount = 4;
+
+static car::AttributeList
+Attributes(int identifier, int scale)
+{
+    return car::AttributeList({
+        { car_attribute_identifier_idiom, car_attribute_identifier_idiom_value_universal },
+        { car_attribute_identifier_scale, static_cast<uint16_t>(scale) },
+        { car_attribute_identifier_identifier, static_cast<uint16_t>(identifier) },
+        { car_attribute_identifier_element, static_cast<uint16_t>(identifier >> 16) },
+    });
+}
+
+/*
+ * Generate an archive of small renditions. Identifiers are 16 bits, so
+ * the element attribute holds the rest.
+ */
+static std::vector<uint8_t>
+Archive(int renditions)
+{
+    auto bom = car::Writer::unique_ptr_bom(bom_alloc_empty(bom_context_memory(NULL, 0)), bom_free);
+    auto writer = car::Writer::Create(std::move(bom));
+
+    std::vector<uint8_t> pixels = std::vector<uint8_t>(4 * 4 * 4, 0x7f);
+    for (int i = 0; i < renditions; i++) {
+        int identifier = i / ScaleCount + 1;
+        int scale = i % ScaleCount + 1;
+        std::string name = "Image" + std::to_string(identifier);
+
+        if (scale == 1) {
+            writer->addFacet(car::Facet::Create(name, Attributes(identifier, scale)));
+        }
+
+        car::Rendition rendition = car::Rendition::Create(Attributes(identifier, scale), car::Rendition::Data(pixels, car::Rendition::Data::Format::PremultipliedBGRA8));
+        rendition.width() = 4;
+        rendition.height() = 4;
+        rendition.scale() = static_cast<double>(scale);
+        rendition.fileName() = name + "@" + std::to_string(scale) + "x.png";
+        rendition.layout() = car_rendition_value_layout_one_part_scale;
+        writer->addRendition(rendition);
+    }
+
+    writer->write();
+
+    struct bom_context_memory const *memory = bom_memory(writer->bom());
+    uint8_t const *data = static_cast<uint8_t const *>(memory->data);
+    return std::vector<uint8_t>(data, data + memory->size);
+}
+
+int
+main(int argc, char **argv)
+{
+    process::DefaultContext processContext = process::DefaultContext();
+
+    Options options;
+    std::pair<bool, std::string> result = libutil::Options::Parse<Options>(&options, processContext.commandLineArguments());
+    if (!result.first) {
+        return Help(result.second);
+    }
+
+    if (options.help()) {
+        return Help();
+    }
+
+    if (options.renditions() <= 0 || options.lookups() < 0) {
+        return Help("invalid count");
+    }
+
+    DefaultFilesystem filesystem;
+
+    char temporary[] = "/tmp/bench_car_Reader-XXXXXX";
+    if (mkdtemp(temporary) == nullptr) {
+        return Help("unable to create temporary directory");
+    }
+    std::string path = std::string(temporary) + "/Assets.car";
+
+    Harness harness = Harness("car reader renditions=" + std::to_string(options.renditions()));
+
+    size_t size = 0;
+    harness.stage("Write", [&]() -> bool {
+        std::vector<uint8_t> archive = Archive(options.renditions());
+        size = archive.size();
+        return filesystem.write(archive, path);
+    });
+
+    ext::optional<car::Reader> reader;
+    harness.stage("Open", [&]() -> bool {
+        reader = car::Reader::Open(path);
+        return (reader != ext::nullopt);
+    });
+
+    /* The first lookup indexes the renditions tree. */
+    size_t found = 0;
+    harness.stage("Lookup", [&]() -> bool {
+        if (!reader) {
+            return false;
+        }
+
+        std::mt19937 random = std::mt19937(1);
+        std::uniform_int_distribution<int> index = std::uniform_int_distribution<int>(0, options.renditions() - 1);
+        for (int i = 0; i < options.lookups(); i++) {
+            int rendition = index(random);
+            if (reader->lookupRendition(Attributes(rendition / ScaleCount + 1, rendition % ScaleCount + 1))) {
+                found++;
+            }
+        }
+        return (found == static_cast<size_t>(options.lookups()));
+    });
+
+    size_t iterated = 0;
+    harness.stage("Iterate", [&]() -> bool {
+        if (!reader) {
+            return false;
+        }
+
+        reader->renditionIterate([&](car::Rendition const &rendition) {
+            iterated += !rendition.fileName().empty();
+        });
+        return (iterated == static_cast<size_t>(options.renditions()));
+    });
+
+    /* Facets and their renditions, as dump_car reads them. */
+    size_t grouped = 0;
+    harness.stage("Facets", [&]() -> bool {
+        if (!reader) {
+            return false;
+        }
+
+        reader->facetIterate([&](car::Facet const &facet) {
+            grouped += reader->lookupRenditions(facet).size();
+        });
+        return (grouped == static_cast<size_t>(options.renditions()));
+    });
+
+    reader = ext::nullopt;
+    filesystem.removeDirectory(temporary, true);
+
+    if (options.csv()) {
+        harness.reportCSV(stdout, true);
+    } else {
+        harness.report(stdout);
+        fprintf(stdout, "Archive: %zu bytes, %zu found, %zu iterated, %zu grouped\n", size, found, iterated, grouped);
+    }
+
+    for (Harness::Result const &result : harness.results()) {
+        if (!result.success()) {
+            return EXIT_FAILURE;
+        }
+    }
+
+    return EXIT_SUCCESS;
+}
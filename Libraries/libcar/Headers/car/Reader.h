@@ -27,6 +27,12 @@ class Rendition;
 
 /*
  * An archive within a BOM file holding facets and their renditions.
+ *
+ * Facets and renditions are read from the BOM in place. Iterating reads
+ * the trees directly; the indexes used for lookups are built the first
+ * time they are needed, and hold only pointers into the BOM. As those
+ * indexes are built by const methods, a reader should not be used from
+ * more than one thread at a time.
  */
 class Reader {
 public:
@@ -41,19 +47,51 @@ private:
         size_t value_len;
     } KeyValuePair;
 
+    /*
+     * A packed attribute key, in the BOM.
+     */
+    typedef struct {
+        void const *data;
+        size_t length;
+    } RenditionKey;
+
+    struct RenditionKeyHash {
+        size_t operator()(RenditionKey const &key) const;
+    };
+
+    struct RenditionKeyEqual {
+        bool operator()(RenditionKey const &a, RenditionKey const &b) const;
+    };
+
 private:
     unique_ptr_bom                                  _bom;
     ext::optional<struct car_key_format *>          _keyfmt;
-    std::unordered_map<std::string, void *>         _facetValues;
-    std::unordered_multimap<uint16_t, KeyValuePair> _renditionValues;
+
+private:
+    mutable bool                                    _facetsIndexed;
+    mutable std::unordered_map<std::string, void *> _facetValues;
+    mutable bool                                    _renditionsIndexed;
+    mutable std::unordered_multimap<uint16_t, KeyValuePair> _renditionValues;
+    mutable bool                                    _renditionKeysIndexed;
+    mutable std::unordered_map<RenditionKey, KeyValuePair, RenditionKeyHash, RenditionKeyEqual> _renditionKeys;
 
 private:
     Reader(unique_ptr_bom bom);
 
+private:
+    void indexFacets() const;
+    void indexRenditions() const;
+    void indexRenditionKeys() const;
+
 public:
     void facetFastIterate(std::function<void(void *key, size_t key_len, void *value, size_t value_len)> const &facet) const;
     void renditionFastIterate(std::function<void(void *key, size_t key_len, void *value, size_t value_len)> const &iterator) const;
 
+    /*
+     * Iterate the renditions of a facet without decoding them.
+     */
+    void renditionFastIterate(Facet const &facet, std::function<void(void *key, size_t key_len, void *value, size_t value_len)> const &iterator) const;
+
 public:
     /*
      * The BOM backing this archive.
@@ -70,14 +108,12 @@ public:
     /*
      * The number of Facets read
      */
-    int facetCount() const
-    { return _facetValues.size(); }
+    int facetCount() const;
 
     /*
      * The number of Renditions read
      */
-     int renditionCount() const
-     { return _renditionValues.size(); }
+    int renditionCount() const;
 
 public:
     /*
@@ -101,6 +137,14 @@ public:
      */
     std::vector<car::Rendition> lookupRenditions(Facet const &) const;
 
+    /*
+     * Lookup a Rendition by its attributes. Attributes not in the key
+     * format are ignored, and those missing are taken to be zero. The
+     * attributes are packed into a key, which is hashed against the keys
+     * in the renditions tree without reading any rendition values.
+     */
+    ext::optional<car::Rendition> lookupRendition(AttributeList const &attributes) const;
+
 public:
     /*
      * Print debug information about the archive.
@@ -112,6 +156,12 @@ public:
      * Load an existing archive from a BOM.
      */
     static ext::optional<Reader> Load(unique_ptr_bom bom);
+
+    /*
+     * Load an existing archive from a file, mapping it into memory. Only
+     * the parts of the file that are used are read.
+     */
+    static ext::optional<Reader> Open(std::string const &path);
 };
 
 }
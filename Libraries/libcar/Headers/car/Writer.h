@@ -34,17 +34,33 @@ class Writer {
 public:
     typedef std::unique_ptr<struct bom_context, decltype(&bom_free)> unique_ptr_bom;
 
+    /*
+     * Counts from the last write. Renditions whose encoded contents are
+     * the same as an earlier rendition's share its value in the archive.
+     */
+    struct Statistics {
+        size_t renditions;
+        size_t deduplicated;
+        size_t deduplicatedBytes;
+    };
+
 private:
     typedef struct {
         void *key; size_t keyLength; void *value; size_t valueLength;
     } KeyValuePair;
 
+    typedef struct {
+        AttributeList attributes; void const *value; size_t valueLength;
+    } EncodedRendition;
+
 private:
     unique_ptr_bom _bom;
     ext::optional<struct car_key_format *> _keyfmt;
     std::unordered_map<std::string, Facet> _facets;
     std::unordered_multimap<uint16_t, Rendition> _renditions;
     std::vector<KeyValuePair> _rawRenditions;
+    std::vector<EncodedRendition> _encodedRenditions;
+    mutable Statistics _statistics;
 
 private:
     Writer(unique_ptr_bom bom);
@@ -72,12 +88,25 @@ public:
      */
     void addRendition(void *key, size_t keyLength, void *value, size_t valueLength);
 
+    /*
+     * Add a rendition whose value is already encoded, such as one read from
+     * another archive. Unlike a raw rendition, the key is packed using this
+     * archive's key format. The value must remain valid until written.
+     */
+    void addRendition(AttributeList const &attributes, void const *value, size_t valueLength);
+
     /*
      * The key format, optional and determined automatically if omitted.
      */
     ext::optional<struct car_key_format *> &keyfmt()
     { return _keyfmt; }
 
+    /*
+     * Counts from the last write.
+     */
+    Statistics const &statistics() const
+    { return _statistics; }
+
 public:
     /*
      * Create a new archive inside a BOM.
@@ -86,7 +115,9 @@ public:
 
 public:
     /*
-     * Serialize and write to BOM.
+     * Serialize and write to BOM. Facets are written in name order and
+     * renditions in key order, so the same contents always produce the
+     * same archive no matter the order they were added in.
      */
      void write() const;
 };
@@ -12,6 +12,7 @@
 #include <car/Rendition.h>
 #include <car/car_format.h>
 
+#include <algorithm>
 #include <limits>
 #include <random>
 
@@ -27,11 +28,32 @@ Reader::
 Reader(unique_ptr_bom bom) :
     _bom(std::move(bom)),
     _keyfmt(ext::nullopt),
+    _facetsIndexed(false),
     _facetValues({ }),
-    _renditionValues({ })
+    _renditionsIndexed(false),
+    _renditionValues({ }),
+    _renditionKeysIndexed(false),
+    _renditionKeys({ })
 {
 }
 
+size_t Reader::RenditionKeyHash::
+operator()(RenditionKey const &key) const
+{
+    /* FNV-1a; keys are short and mostly zero. */
+    size_t hash = 2166136261u;
+    for (size_t i = 0; i < key.length; i++) {
+        hash = (hash ^ static_cast<uint8_t const *>(key.data)[i]) * 16777619u;
+    }
+    return hash;
+}
+
+bool Reader::RenditionKeyEqual::
+operator()(RenditionKey const &a, RenditionKey const &b) const
+{
+    return a.length == b.length && memcmp(a.data, b.data, a.length) == 0;
+}
+
 struct _car_iterator_ctx {
     Reader const *reader;
     void *iterator;
@@ -56,10 +78,11 @@ _car_tree_iterator(Reader const *reader, const char *tree_variable, bom_tree_ite
 void Reader::
 facetIterate(std::function<void(Facet const &)> const &iterator) const
 {
-    for (const auto &item : _facetValues) {
-        Facet facet = Facet::Load(item.first, (struct car_facet_value *)item.second);
+    facetFastIterate([&iterator](void *key, size_t key_len, void *value, size_t value_len) {
+        auto name = std::string(static_cast<char *>(key), key_len);
+        Facet facet = Facet::Load(name, (struct car_facet_value *)value);
         iterator(facet);
-    }
+    });
 }
 
 static void
@@ -79,14 +102,13 @@ void Reader::
 renditionIterate(std::function<void(Rendition const &)> const &iterator) const
 {
     auto keyfmt = *_keyfmt;
-    for (const auto &it : _renditionValues) {
-        KeyValuePair kv = (KeyValuePair)it.second;
-        car_rendition_key *rendition_key = (car_rendition_key *)kv.key;
-        struct car_rendition_value *rendition_value = (struct car_rendition_value *)kv.value;
+    renditionFastIterate([keyfmt, &iterator](void *key, size_t key_len, void *value, size_t value_len) {
+        car_rendition_key *rendition_key = (car_rendition_key *)key;
+        struct car_rendition_value *rendition_value = (struct car_rendition_value *)value;
         AttributeList attributes = AttributeList::Load(keyfmt->num_identifiers, keyfmt->identifier_list, rendition_key);
         Rendition rendition = Rendition::Load(attributes, rendition_value);
         iterator(rendition);
-    }
+    });
 }
 
 static void
@@ -102,6 +124,23 @@ renditionFastIterate(std::function<void(void *key, size_t key_len, void *value,
     _car_tree_iterator(this, car_renditions_variable, _car_rendition_fast_iterator, const_cast<void *>(reinterpret_cast<void const *>(&iterator)));
 }
 
+void Reader::
+renditionFastIterate(Facet const &facet, std::function<void(void *key, size_t key_len, void *value, size_t value_len)> const &iterator) const
+{
+    ext::optional<uint16_t> facet_identifier = facet.attributes().get(car_attribute_identifier_identifier);
+    if (!facet_identifier) {
+        return;
+    }
+
+    indexRenditions();
+
+    auto lookupRendition = _renditionValues.equal_range(*facet_identifier);
+    for (auto it = lookupRendition.first; it != lookupRendition.second; ++it) {
+        KeyValuePair const &value = it->second;
+        iterator(value.key, value.key_len, value.value, value.value_len);
+    }
+}
+
 void Reader::
 dump() const
 {
@@ -168,35 +207,32 @@ dump() const
     }
 }
 
-ext::optional<Reader> Reader::
-Load(unique_ptr_bom bom)
+void Reader::
+indexFacets() const
 {
-    int header_index = bom_variable_get(bom.get(), car_header_variable);
-
-    size_t header_len;
-    struct car_header *header = (struct car_header *)bom_index_get(bom.get(), header_index, &header_len);
-    if (header_len < sizeof(struct car_header) || strncmp(header->magic, "RATC", 4) || header->storage_version < 8) {
-        return ext::nullopt;
+    if (_facetsIndexed) {
+        return;
     }
-
-    auto reader = Reader(std::move(bom));
+    _facetsIndexed = true;
 
     /*
      * Iterate through the facets as fast as possible just save the name and value pointer for lookups later.
      */
-    reader.facetFastIterate([&reader](void *key, size_t key_len, void *value, size_t value_len) {
+    facetFastIterate([this](void *key, size_t key_len, void *value, size_t value_len) {
         auto name = std::string(static_cast<char *>(key), key_len);
-        reader._facetValues.insert({ name, value });
+        _facetValues.insert({ name, value });
     });
+}
 
-    /* Load the key format from the BOM. */
-    int key_format_index = bom_variable_get(reader.bom(), car_key_format_variable);
-    struct car_key_format *keyfmt = (struct car_key_format *)bom_index_get(reader.bom(), key_format_index, NULL);
-    if (!keyfmt) {
-        return ext::nullopt;
+void Reader::
+indexRenditions() const
+{
+    if (_renditionsIndexed) {
+        return;
     }
+    _renditionsIndexed = true;
 
-    reader._keyfmt = ext::optional<struct car_key_format*>(keyfmt);
+    auto keyfmt = *_keyfmt;
 
     /*
      * The index into the attribute list for the identifer for the matching facet.
@@ -213,24 +249,102 @@ Load(unique_ptr_bom bom)
     }
 
     /* Iterate through the renditions as fast as possible. Save the key and value pointers, indexed by the Facet identifier. */
-    reader.renditionFastIterate([identifier_index,&reader](void *key, size_t key_len, void *value, size_t value_len) {
+    renditionFastIterate([identifier_index, this](void *key, size_t key_len, void *value, size_t value_len) {
         KeyValuePair kv;
         kv.key = key;
         kv.key_len = key_len;
         kv.value = value;
         kv.value_len = value_len;
         car_rendition_key *rendition_key = (car_rendition_key *)key;
-        reader._renditionValues.insert({ rendition_key[identifier_index], kv });
+        _renditionValues.insert({ rendition_key[identifier_index], kv });
     });
+}
+
+void Reader::
+indexRenditionKeys() const
+{
+    if (_renditionKeysIndexed) {
+        return;
+    }
+    _renditionKeysIndexed = true;
 
+    /* Only the attributes in the key format are compared. */
+    auto keyfmt = *_keyfmt;
+    size_t length = keyfmt->num_identifiers * sizeof(car_rendition_key);
+
+    renditionFastIterate([length, this](void *key, size_t key_len, void *value, size_t value_len) {
+        KeyValuePair kv;
+        kv.key = key;
+        kv.key_len = key_len;
+        kv.value = value;
+        kv.value_len = value_len;
+        RenditionKey rendition_key = { key, std::min(key_len, length) };
+        _renditionKeys.insert({ rendition_key, kv });
+    });
+}
+
+int Reader::
+facetCount() const
+{
+    indexFacets();
+    return _facetValues.size();
+}
+
+int Reader::
+renditionCount() const
+{
+    indexRenditions();
+    return _renditionValues.size();
+}
+
+ext::optional<Reader> Reader::
+Load(unique_ptr_bom bom)
+{
+    int header_index = bom_variable_get(bom.get(), car_header_variable);
+
+    size_t header_len = 0;
+    struct car_header *header = (struct car_header *)bom_index_get(bom.get(), header_index, &header_len);
+    if (header == NULL || header_len < sizeof(struct car_header) || strncmp(header->magic, "RATC", 4) || header->storage_version < 8) {
+        return ext::nullopt;
+    }
+
+    auto reader = Reader(std::move(bom));
+
+    /* Load the key format from the BOM. */
+    int key_format_index = bom_variable_get(reader.bom(), car_key_format_variable);
+    struct car_key_format *keyfmt = (struct car_key_format *)bom_index_get(reader.bom(), key_format_index, NULL);
+    if (!keyfmt) {
+        return ext::nullopt;
+    }
+
+    reader._keyfmt = ext::optional<struct car_key_format*>(keyfmt);
+
+    /* Facets and renditions are indexed when first looked up. */
     return std::move(reader);
 }
 
+ext::optional<Reader> Reader::
+Open(std::string const &path)
+{
+    struct bom_context_memory memory = bom_context_memory_file(path.c_str(), false, 0);
+    if (memory.data == NULL) {
+        return ext::nullopt;
+    }
+
+    auto bom = unique_ptr_bom(bom_alloc_load(memory), bom_free);
+    if (bom == nullptr) {
+        return ext::nullopt;
+    }
+
+    return Load(std::move(bom));
+}
+
 ext::optional<Facet>
 Reader::lookupFacet(std::string name) const
 {
     ext::optional<Facet> result;
 
+    indexFacets();
     auto lookup = _facetValues.find(name);
 
     if (lookup == _facetValues.end()) {
@@ -259,6 +373,8 @@ lookupRenditions(Facet const &facet) const
         return result;
     }
 
+    indexRenditions();
+
     auto keyfmt = *_keyfmt;
     auto lookupRendition = _renditionValues.equal_range(*facet_identifier);
     for (auto it = lookupRendition.first; it != lookupRendition.second; ++it) {
@@ -272,3 +388,25 @@ lookupRenditions(Facet const &facet) const
     return result;
 }
 
+ext::optional<Rendition> Reader::
+lookupRendition(AttributeList const &attributes) const
+{
+    if (!_keyfmt) {
+        return ext::nullopt;
+    }
+
+    indexRenditionKeys();
+
+    auto keyfmt = *_keyfmt;
+    std::vector<uint8_t> key = attributes.write(keyfmt->num_identifiers, keyfmt->identifier_list);
+    auto lookup = _renditionKeys.find({ key.data(), key.size() });
+    if (lookup == _renditionKeys.end()) {
+        return ext::nullopt;
+    }
+
+    KeyValuePair const &value = lookup->second;
+    car_rendition_key *rendition_key = (car_rendition_key *)value.key;
+    struct car_rendition_value *rendition_value = (struct car_rendition_value *)value.value;
+    AttributeList rendition_attributes = AttributeList::Load(keyfmt->num_identifiers, keyfmt->identifier_list, rendition_key);
+    return Rendition::Load(rendition_attributes, rendition_value);
+}
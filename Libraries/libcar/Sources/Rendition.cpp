@@ -65,7 +65,9 @@ Rendition(AttributeList const &attributes, std::function<ext::optional<Data>(Ren
     _scale       (1.0),
     _isVector    (false),
     _isOpaque    (false),
-    _isResizable (false)
+    _isResizable (false),
+    _resizeMode  (ResizeMode::FixedSize),
+    _layout      (car_rendition_value_layout_one_part_scale)
 {
 }
 
@@ -78,7 +80,9 @@ Rendition(AttributeList const &attributes, ext::optional<Data> const &data) :
     _scale      (1.0),
     _isVector   (false),
     _isOpaque   (false),
-    _isResizable(false)
+    _isResizable(false),
+    _resizeMode (ResizeMode::FixedSize),
+    _layout     (car_rendition_value_layout_one_part_scale)
 {
 }
 
@@ -9,9 +9,11 @@
 
 #include <car/Writer.h>
 #include <car/car_format.h>
+#include <libutil/Hash.h>
 
-#include <random>
+#include <algorithm>
 #include <set>
+#include <unordered_map>
 #include <unordered_set>
 #include <vector>
 
@@ -24,7 +26,8 @@ using car::Rendition;
 
 Writer::
 Writer(unique_ptr_bom bom) :
-    _bom(std::move(bom))
+    _bom       (std::move(bom)),
+    _statistics({ 0, 0, 0 })
 {
 }
 
@@ -56,10 +59,19 @@ addRendition(void *key, size_t key_len, void *value, size_t value_len)
     _rawRenditions.emplace_back(kv);
 }
 
+void Writer::
+addRendition(AttributeList const &attributes, void const *value, size_t value_len)
+{
+    EncodedRendition encoded = { attributes, value, value_len };
+    _encodedRenditions.push_back(encoded);
+}
+
+template<typename T>
 static std::vector<enum car_attribute_identifier>
 DetermineKeyFormat(
     std::unordered_map<std::string, Facet> const &facets,
-    std::unordered_multimap<uint16_t, Rendition> const &renditions)
+    std::unordered_multimap<uint16_t, Rendition> const &renditions,
+    std::vector<T> const &encodedRenditions)
 {
     std::unordered_set<enum car_attribute_identifier> format;
     auto insert = [&format](enum car_attribute_identifier identifier, uint16_t value) {
@@ -74,11 +86,37 @@ DetermineKeyFormat(
         item.second.attributes().iterate(insert);
     }
 
+    for (auto const &item : encodedRenditions) {
+        item.attributes.iterate(insert);
+    }
+
     /* Sort attributes to preserve ordering. */
     auto ordered = std::set<enum car_attribute_identifier>(format.begin(), format.end());
     return std::vector<enum car_attribute_identifier>(ordered.begin(), ordered.end());
 }
 
+/*
+ * A rendition to write, by its packed key. The value is either encoded
+ * from the rendition when written, or was already encoded.
+ */
+struct WriterRendition {
+    std::vector<uint8_t> key;
+    Rendition const *rendition;
+    void const *value;
+    size_t valueLength;
+};
+
+static bool
+WriterRenditionCompare(WriterRendition const &a, WriterRendition const &b)
+{
+    /* The same order as keys in the BOM tree. */
+    int result = memcmp(a.key.data(), b.key.data(), std::min(a.key.size(), b.key.size()));
+    if (result == 0) {
+        return a.key.size() < b.key.size();
+    }
+    return result < 0;
+}
+
 void Writer::
 write() const
 {
@@ -88,7 +126,7 @@ write() const
      * Each tree entry (facet or rendition) requires 2: one key index, one value index.
      */
     uint32_t facet_count = _facets.size();
-    uint32_t rendition_count = _renditions.size() + _rawRenditions.size();
+    uint32_t rendition_count = _renditions.size() + _rawRenditions.size() + _encodedRenditions.size();
     uint32_t bom_index_count = 8 + facet_count * 2 + rendition_count * 2;
     bom_index_reserve(_bom.get(), bom_index_count);
 
@@ -106,11 +144,8 @@ write() const
     strncpy(header->file_creator, "asset catalog compiler\n", sizeof(header->file_creator));
     strncpy(header->other_creator, "version 1.0", sizeof(header->other_creator));
 
-    std::random_device device;
-    std::uniform_int_distribution<int> distribution = std::uniform_int_distribution<int>(std::numeric_limits<uint8_t>::min(), std::numeric_limits<uint8_t>::max());
-    for (size_t i = 0; i < sizeof(header->uuid); i++) {
-        header->uuid[i] = distribution(device);
-    }
+    /* Filled in from the contents once they are written. */
+    memset(header->uuid, 0, sizeof(header->uuid));
 
     header->associated_checksum = 0; // TODO
     header->schema_version = 4; // TODO
@@ -125,7 +160,7 @@ write() const
     struct car_key_format *keyfmt;
     size_t keyfmt_size;
     if (_keyfmt == ext::nullopt) {
-      std::vector<enum car_attribute_identifier> format = DetermineKeyFormat(_facets, _renditions);
+      std::vector<enum car_attribute_identifier> format = DetermineKeyFormat(_facets, _renditions, _encodedRenditions);
       keyfmt_size = sizeof(struct car_key_format) + (format.size() * sizeof(uint32_t));
       keyfmt = (struct car_key_format *)malloc(keyfmt_size);
       strncpy(keyfmt->magic, "tmfk", 4);
@@ -142,16 +177,33 @@ write() const
     int key_format_index = bom_index_add(_bom.get(), keyfmt, keyfmt_size);
     bom_variable_add(_bom.get(), car_key_format_variable, key_format_index);
 
+    /*
+     * The archive's UUID identifies its contents: archives with the same
+     * facets and renditions have the same UUID.
+     */
+    libutil::Hash::Stream contents;
+
     /* Write facets. */
+    std::vector<std::pair<std::string const, Facet> const *> facets;
+    facets.reserve(_facets.size());
+    for (auto const &item : _facets) {
+        facets.push_back(&item);
+    }
+    std::sort(facets.begin(), facets.end(), [](std::pair<std::string const, Facet> const *a, std::pair<std::string const, Facet> const *b) {
+        return a->first < b->first;
+    });
+
     struct bom_tree_context *facets_tree_context = bom_tree_alloc_empty(_bom.get(), car_facet_keys_variable);
     bom_tree_reserve(facets_tree_context, facet_count);
     if (facets_tree_context != NULL) {
-        for (auto const &item : _facets) {
-            auto facet_value = item.second.write();
+        for (auto const *item : facets) {
+            auto facet_value = item->second.write();
+            contents.update(item->first.c_str(), item->first.size() + 1);
+            contents.update(facet_value.data(), facet_value.size());
             bom_tree_add(
                 facets_tree_context,
-                reinterpret_cast<void const *>(item.first.c_str()),
-                item.first.size(),
+                reinterpret_cast<void const *>(item->first.c_str()),
+                item->first.size(),
                 reinterpret_cast<void const *>(facet_value.data()),
                 facet_value.size());
         }
@@ -159,30 +211,89 @@ write() const
     }
 
     /* Write renditions. */
+    _statistics = { 0, 0, 0 };
     struct bom_tree_context *renditions_tree_context = bom_tree_alloc_empty(_bom.get(), car_renditions_variable);
     bom_tree_reserve(renditions_tree_context, rendition_count);
     if (renditions_tree_context != NULL) {
+        /*
+         * Renditions with the same encoded contents, such as the same image
+         * for several idioms, point to a single copy of the value.
+         */
+        std::unordered_multimap<libutil::Hash, uint32_t> values;
+        auto add = [this, &values, &contents, renditions_tree_context](void const *key, size_t key_len, void const *value, size_t value_len) {
+            libutil::Hash hash = libutil::Hash::Data(value, value_len);
+
+            uint64_t digest[2] = { hash.low(), hash.high() };
+            contents.update(key, key_len);
+            contents.update(digest, sizeof(digest));
+
+            _statistics.renditions++;
+            auto range = values.equal_range(hash);
+            for (auto it = range.first; it != range.second; ++it) {
+                size_t existing_len;
+                void const *existing = bom_index_get(_bom.get(), it->second, &existing_len);
+                if (existing != NULL && existing_len == value_len && memcmp(existing, value, value_len) == 0) {
+                    _statistics.deduplicated++;
+                    _statistics.deduplicatedBytes += value_len;
+                    bom_tree_add_index(renditions_tree_context, key, key_len, it->second);
+                    return;
+                }
+            }
+
+            uint32_t value_index = bom_index_add(_bom.get(), value, value_len);
+            values.insert({ hash, value_index });
+            bom_tree_add_index(renditions_tree_context, key, key_len, value_index);
+        };
+
+        /*
+         * Pack every key first, and write in key order. Values are only
+         * encoded as they are written.
+         */
+        std::vector<WriterRendition> renditions;
+        renditions.reserve(rendition_count);
         for (auto const &item : _renditions) {
-            auto attributes_value = item.second.attributes().write(keyfmt->num_identifiers, keyfmt->identifier_list);
-            auto rendition_value = item.second.write();
-            bom_tree_add(
-                renditions_tree_context,
-                reinterpret_cast<void const *>(attributes_value.data()),
-                attributes_value.size(),
-                reinterpret_cast<void const *>(rendition_value.data()),
-                rendition_value.size());
+            WriterRendition rendition = { item.second.attributes().write(keyfmt->num_identifiers, keyfmt->identifier_list), &item.second, NULL, 0 };
+            renditions.push_back(std::move(rendition));
+        }
+        for (auto const &item : _encodedRenditions) {
+            WriterRendition rendition = { item.attributes.write(keyfmt->num_identifiers, keyfmt->identifier_list), NULL, item.value, item.valueLength };
+            renditions.push_back(std::move(rendition));
         }
         for (auto const &item : _rawRenditions) {
-            bom_tree_add(
-                renditions_tree_context,
-                item.key,
-                item.keyLength,
-                item.value,
-                item.valueLength);
+            uint8_t const *key = static_cast<uint8_t const *>(item.key);
+            WriterRendition rendition = { std::vector<uint8_t>(key, key + item.keyLength), NULL, item.value, item.valueLength };
+            renditions.push_back(std::move(rendition));
+        }
+        std::stable_sort(renditions.begin(), renditions.end(), WriterRenditionCompare);
+
+        for (WriterRendition const &item : renditions) {
+            if (item.rendition != NULL) {
+                auto rendition_value = item.rendition->write();
+                add(
+                    reinterpret_cast<void const *>(item.key.data()),
+                    item.key.size(),
+                    reinterpret_cast<void const *>(rendition_value.data()),
+                    rendition_value.size());
+            } else {
+                add(
+                    reinterpret_cast<void const *>(item.key.data()),
+                    item.key.size(),
+                    item.value,
+                    item.valueLength);
+            }
         }
         bom_tree_free(renditions_tree_context);
     }
 
+    /* Fill in the UUID. */
+    struct car_header *written_header = (struct car_header *)bom_index_get(_bom.get(), header_index, NULL);
+    if (written_header != NULL) {
+        libutil::Hash hash = contents.finish();
+        uint64_t digest[2] = { hash.low(), hash.high() };
+        static_assert(sizeof(digest) == sizeof(written_header->uuid), "uuid is 16 bytes");
+        memcpy(written_header->uuid, digest, sizeof(written_header->uuid));
+    }
+
     /* Add freelist entries. */
     bom_free_indices_add(_bom.get(), 2);
 
@@ -0,0 +1,151 @@
+/**
+ Copyright (c) 2015-present, Facebook, Inc.
+ All rights reserved.
+
+ This source code is licensed under the BSD-style license found in the
+ LICENSE file in the root directory of this source tree. An additional grant
+ of patent rights can be found in the PATENTS file in the same directory.
+ */
+
+#include <gtest/gtest.h>
+#include <bom/bom.h>
+#include <car/car_format.h>
+#include <car/AttributeList.h>
+#include <car/Facet.h>
+#include <car/Rendition.h>
+#include <car/Writer.h>
+#include <car/Reader.h>
+
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+#include <unistd.h>
+
+/* Enough renditions to fill more than one leaf of the renditions tree. */
+static int const facet_count = 400;
+static int const scale_count = 3;
+
+static car::AttributeList
+Attributes(int facet_identifier, int scale)
+{
+    return car::AttributeList({
+        { car_attribute_identifier_idiom, car_attribute_identifier_idiom_value_universal },
+        { car_attribute_identifier_scale, static_cast<uint16_t>(scale) },
+        { car_attribute_identifier_identifier, static_cast<uint16_t>(facet_identifier) },
+    });
+}
+
+/*
+ * Write an archive with a facet for each identifier, and a rendition of
+ * each facet at each scale.
+ */
+static std::vector<uint8_t>
+Archive()
+{
+    auto writer_bom = car::Writer::unique_ptr_bom(bom_alloc_empty(bom_context_memory(NULL, 0)), bom_free);
+    auto writer = car::Writer::Create(std::move(writer_bom));
+
+    for (int facet_identifier = 1; facet_identifier <= facet_count; facet_identifier++) {
+        std::string name = "image_" + std::to_string(facet_identifier);
+        writer->addFacet(car::Facet::Create(name, Attributes(facet_identifier, 1)));
+
+        for (int scale = 1; scale <= scale_count; scale++) {
+            std::vector<uint8_t> pixels = std::vector<uint8_t>(4 * 4 * 4, static_cast<uint8_t>(facet_identifier * scale));
+            auto data = car::Rendition::Data(pixels, car::Rendition::Data::Format::PremultipliedBGRA8);
+            car::Rendition rendition = car::Rendition::Create(Attributes(facet_identifier, scale), data);
+            rendition.width() = 4;
+            rendition.height() = 4;
+            rendition.scale() = static_cast<double>(scale);
+            rendition.fileName() = name + "@" + std::to_string(scale) + "x.png";
+            rendition.layout() = car_rendition_value_layout_one_part_scale;
+            writer->addRendition(rendition);
+        }
+    }
+
+    writer->write();
+
+    struct bom_context_memory const *memory = bom_memory(writer->bom());
+    uint8_t const *data = static_cast<uint8_t const *>(memory->data);
+    return std::vector<uint8_t>(data, data + memory->size);
+}
+
+TEST(Reader, LookupRendition)
+{
+    std::vector<uint8_t> archive = Archive();
+    auto bom = car::Reader::unique_ptr_bom(bom_alloc_load(bom_context_memory(archive.data(), archive.size())), bom_free);
+    ASSERT_NE(nullptr, bom);
+
+    ext::optional<car::Reader> reader = car::Reader::Load(std::move(bom));
+    ASSERT_NE(ext::nullopt, reader);
+
+    for (int facet_identifier = 1; facet_identifier <= facet_count; facet_identifier++) {
+        for (int scale = 1; scale <= scale_count; scale++) {
+            ext::optional<car::Rendition> rendition = reader->lookupRendition(Attributes(facet_identifier, scale));
+            ASSERT_NE(ext::nullopt, rendition);
+
+            EXPECT_EQ("image_" + std::to_string(facet_identifier) + "@" + std::to_string(scale) + "x.png", rendition->fileName());
+            EXPECT_EQ(scale, *rendition->attributes().get(car_attribute_identifier_scale));
+            EXPECT_EQ(std::vector<uint8_t>(4 * 4 * 4, static_cast<uint8_t>(facet_identifier * scale)), rendition->data()->data());
+        }
+    }
+
+    /* Attributes that don't match any rendition. */
+    EXPECT_EQ(ext::nullopt, reader->lookupRendition(Attributes(facet_count + 1, 1)));
+    EXPECT_EQ(ext::nullopt, reader->lookupRendition(Attributes(1, scale_count + 1)));
+
+    /* Attributes not in the key format are ignored. */
+    car::AttributeList extra = Attributes(2, 2);
+    extra.set(car_attribute_identifier_display_gamut, 1);
+    ext::optional<car::Rendition> rendition = reader->lookupRendition(extra);
+    ASSERT_NE(ext::nullopt, rendition);
+    EXPECT_EQ("image_2@2x.png", rendition->fileName());
+
+    /* Renditions are stored in key order. */
+    std::vector<uint8_t> previous;
+    reader->renditionFastIterate([&previous](void *key, size_t key_len, void *value, size_t value_len) {
+        std::vector<uint8_t> current = std::vector<uint8_t>(static_cast<uint8_t *>(key), static_cast<uint8_t *>(key) + key_len);
+        EXPECT_LT(previous, current);
+        previous = current;
+    });
+
+    /* The indexes built for lookups agree with iteration. */
+    EXPECT_EQ(facet_count, reader->facetCount());
+    EXPECT_EQ(facet_count * scale_count, reader->renditionCount());
+
+    int iterated = 0;
+    reader->renditionIterate([&iterated](car::Rendition const &rendition) {
+        iterated++;
+    });
+    EXPECT_EQ(facet_count * scale_count, iterated);
+
+    ext::optional<car::Facet> facet = reader->lookupFacet("image_7");
+    ASSERT_NE(ext::nullopt, facet);
+    EXPECT_EQ(scale_count, reader->lookupRenditions(*facet).size());
+    EXPECT_EQ(ext::nullopt, reader->lookupFacet("missing"));
+}
+
+TEST(Reader, Open)
+{
+    std::vector<uint8_t> archive = Archive();
+
+    char path[] = "/tmp/test_car_Reader-XXXXXX";
+    int fd = mkstemp(path);
+    ASSERT_NE(-1, fd);
+    ASSERT_EQ(static_cast<ssize_t>(archive.size()), write(fd, archive.data(), archive.size()));
+    close(fd);
+
+    {
+        ext::optional<car::Reader> reader = car::Reader::Open(path);
+        ASSERT_NE(ext::nullopt, reader);
+
+        ext::optional<car::Rendition> rendition = reader->lookupRendition(Attributes(facet_count, scale_count));
+        ASSERT_NE(ext::nullopt, rendition);
+        EXPECT_EQ("image_" + std::to_string(facet_count) + "@" + std::to_string(scale_count) + "x.png", rendition->fileName());
+    }
+
+    unlink(path);
+
+    EXPECT_EQ(ext::nullopt, car::Reader::Open(path));
+}
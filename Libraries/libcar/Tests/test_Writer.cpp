@@ -254,3 +254,94 @@ TEST(Writer, TestWriter100Optimal)
     EXPECT_EQ(rendition_count, create_rendition_count);
 }
 
+
+/*
+ * Write the test pattern for each facet, once for each idiom. Returns the
+ * size of the archive and the writer's statistics.
+ */
+static std::pair<size_t, car::Writer::Statistics>
+WriteIdioms(std::vector<uint16_t> const &idioms, std::vector<uint8_t> *contents)
+{
+    auto writer_bom = car::Writer::unique_ptr_bom(bom_alloc_empty(bom_context_memory(NULL, 0)), bom_free);
+    auto writer = car::Writer::Create(std::move(writer_bom));
+
+    for (int facet_identifier = 1; facet_identifier <= 10; facet_identifier++) {
+        std::string name = "testpattern_" + std::to_string(facet_identifier);
+        std::vector<uint8_t> pixels = test_pixels;
+        pixels[0] = static_cast<uint8_t>(facet_identifier);
+
+        for (uint16_t idiom : idioms) {
+            car::AttributeList attributes = car::AttributeList({
+                { car_attribute_identifier_idiom, idiom },
+                { car_attribute_identifier_scale, 2 },
+                { car_attribute_identifier_identifier, static_cast<uint16_t>(facet_identifier) },
+            });
+
+            if (idiom == idioms.front()) {
+                writer->addFacet(car::Facet::Create(name, attributes));
+            }
+
+            auto data = car::Rendition::Data(pixels, car::Rendition::Data::Format::PremultipliedBGRA8);
+            car::Rendition rendition = car::Rendition::Create(attributes, data);
+            rendition.width() = 8;
+            rendition.height() = 8;
+            rendition.scale() = 2;
+            rendition.fileName() = name + ".png";
+            rendition.layout() = car_rendition_value_layout_one_part_scale;
+            writer->addRendition(rendition);
+        }
+    }
+
+    writer->write();
+
+    struct bom_context_memory const *memory = bom_memory(writer->bom());
+    *contents = std::vector<uint8_t>(static_cast<uint8_t *>(memory->data), static_cast<uint8_t *>(memory->data) + memory->size);
+    return std::make_pair(contents->size(), writer->statistics());
+}
+
+TEST(Writer, Deduplicate)
+{
+    std::vector<uint8_t> single;
+    auto universal = WriteIdioms({ car_attribute_identifier_idiom_value_universal }, &single);
+    EXPECT_EQ(10, universal.second.renditions);
+    EXPECT_EQ(0, universal.second.deduplicated);
+
+    /* The same images for three idioms. */
+    std::vector<uint8_t> contents;
+    std::vector<uint16_t> idioms = {
+        car_attribute_identifier_idiom_value_universal,
+        car_attribute_identifier_idiom_value_phone,
+        car_attribute_identifier_idiom_value_pad,
+    };
+    auto shared = WriteIdioms(idioms, &contents);
+    EXPECT_EQ(30, shared.second.renditions);
+    EXPECT_EQ(20, shared.second.deduplicated);
+
+    /* Only the keys are added, not another copy of each image. */
+    EXPECT_GT(shared.second.deduplicatedBytes, 0);
+    EXPECT_LT(shared.first - universal.first, shared.second.deduplicatedBytes);
+
+    auto reader_bom = car::Reader::unique_ptr_bom(bom_alloc_load(bom_context_memory(contents.data(), contents.size())), bom_free);
+    ASSERT_NE(nullptr, reader_bom);
+    ext::optional<car::Reader> reader = car::Reader::Load(std::move(reader_bom));
+    ASSERT_NE(ext::nullopt, reader);
+    EXPECT_EQ(30, reader->renditionCount());
+
+    for (int facet_identifier = 1; facet_identifier <= 10; facet_identifier++) {
+        std::vector<uint8_t> pixels = test_pixels;
+        pixels[0] = static_cast<uint8_t>(facet_identifier);
+
+        for (uint16_t idiom : idioms) {
+            ext::optional<car::Rendition> rendition = reader->lookupRendition(car::AttributeList({
+                { car_attribute_identifier_idiom, idiom },
+                { car_attribute_identifier_scale, 2 },
+                { car_attribute_identifier_identifier, static_cast<uint16_t>(facet_identifier) },
+            }));
+            ASSERT_NE(ext::nullopt, rendition);
+
+            EXPECT_EQ(idiom, *rendition->attributes().get(car_attribute_identifier_idiom));
+            EXPECT_EQ("testpattern_" + std::to_string(facet_identifier) + ".png", rendition->fileName());
+            EXPECT_EQ(pixels, rendition->data()->data());
+        }
+    }
+}
@@ -0,0 +1,254 @@
+/**
+ Copyright (c) 2015-present, Facebook, Inc.
+ All rights reserved.
+
+ This source code is licensed under the BSD-style license found in the
+ LICENSE file in the root directory of this source tree. An additional grant
+ of patent rights can be found in the PATENTS file in the same directory.
+ */
+
+#include <benchmark/Harness.h>
+#include <libutil/DefaultFilesystem.h>
+#include <libutil/Options.h>
+#include <process/DefaultContext.h>
+
+#include <cstdlib>
+#include <thread>
+
+#if !_WIN32
+#include <unistd.h>
+#endif
+
+using benchmark::Harness;
+using libutil::DefaultFilesystem;
+using libutil::Filesystem;
+
+class Options {
+private:
+    ext::optional<bool>        _help;
+
+private:
+    ext::optional<int>         _depth;
+    ext::optional<int>         _directories;
+    ext::optional<int>         _files;
+    ext::optional<int>         _threads;
+
+private:
+    ext::optional<std::string> _root;
+    ext::optional<bool>        _csv;
+
+public:
+    Options();
+    ~Options();
+
+public:
+    bool help() const
+    { return _help.value_or(false); }
+
+public:
+    int depth() const
+    { return _depth.value_or(3); }
+    int directories() const
+    { return _directories.value_or(8); }
+    int files() const
+    { return _files.value_or(20); }
+    int threads() const
+    { return _threads.value_or(static_cast<int>(std::thread::hardware_concurrency())); }
+
+public:
+    ext::optional<std::string> const &root() const
+    { return _root; }
+    bool csv() const
+    { return _csv.value_or(false); }
+
+private:
+    friend class libutil::Options;
+    std::pair<bool, std::string>
+    parseArgument(std::vector<std::string> const &args, std::vector<std::string>::const_iterator *it);
+};
+
+Options::
+Options()
+{
+}
+
+Options::
+~Options()
+{
+}
+
+std::pair<bool, std::string> Options::
+parseArgument(std::vector<std::string> const &args, std::vector<std::string>::const_iterator *it)
+{
+    std::string const &arg = **it;
+
+    if (arg == "-h" || arg == "--help") {
+        return libutil::Options::Current<bool>(&_help, arg);
+    } else if (arg == "--depth") {
+        return libutil::Options::Next<int>(&_depth, args, it);
+    } else if (arg == "--directories") {
+        return libutil::Options::Next<int>(&_directories, args, it);
+    } else if (arg == "--files") {
+        return libutil::Options::Next<int>(&_files, args, it);
+    } else if (arg == "--threads") {
+        return libutil::Options::Next<int>(&_threads, args, it);
+    } else if (arg == "--root") {
+        return libutil::Options::Next<std::string>(&_root, args, it);
+    } else if (arg == "--csv") {
+        return libutil::Options::Current<bool>(&_csv, arg);
+    } else {
+        return std::make_pair(false, "unknown argument " + arg);
+    }
+}
+
+static int
+Help(std::string const &error = std::string())
+{
+    if (!error.empty()) {
+        fprintf(stderr, "error: %s\n", error.c_str());
+        fprintf(stderr, "\n");
+    }
+
+    fprintf(stderr, "Usage: bench_util_DirectoryWalk [options]\n\n");
+    fprintf(stderr, "Measures recursively listing a directory tree along with entry types.\n\n");
+
+#define INDENT "  "
+    fprintf(stderr, "Options:\n");
+    fprintf(stderr, INDENT "--depth <count> (levels of directories)\n");
+    fprintf(stderr, INDENT "--directories <count> (per directory)\n");
+    fprintf(stderr, INDENT "--files <count> (per directory)\n");
+    fprintf(stderr, INDENT "--threads <count> (for the parallel walk)\n");
+    fprintf(stderr, INDENT "--root <path> (default: temporary directory)\n");
+    fprintf(stderr, INDENT "--csv\n");
+    fprintf(stderr, "\n");
+#undef INDENT
+
+    return (error.empty() ? EXIT_SUCCESS : EXIT_FAILURE);
+}
+
+/*
+ * Create a tree shaped like an asset catalog or header directory: a few
+ * levels of directories, each holding a number of small files.
+ */
+static bool
+CreateTree(Filesystem *filesystem, std::string const &path, int depth, int directories, int files, size_t *entries)
+{
+    if (!filesystem->createDirectory(path, true)) {
+        return false;
+    }
+
+    for (int i = 0; i < files; i++) {
+        if (!filesystem->write(std::vector<uint8_t>(), path + "/file" + std::to_string(i) + ".json")) {
+            return false;
+        }
+        *entries += 1;
+    }
+
+    if (depth > 0) {
+        for (int i = 0; i < directories; i++) {
+            if (!CreateTree(filesystem, path + "/directory" + std::to_string(i), depth - 1, directories, files, entries)) {
+                return false;
+            }
+            *entries += 1;
+        }
+    }
+
+    return true;
+}
+
+int
+main(int argc, char **argv)
+{
+    process::DefaultContext processContext = process::DefaultContext();
+
+    Options options;
+    std::pair<bool, std::string> result = libutil::Options::Parse<Options>(&options, processContext.commandLineArguments());
+    if (!result.first) {
+        return Help(result.second);
+    }
+
+    if (options.help()) {
+        return Help();
+    }
+
+    if (options.depth() < 0 || options.directories() < 0 || options.files() < 0 || options.threads() <= 0) {
+        return Help("invalid tree shape");
+    }
+
+    DefaultFilesystem filesystem;
+
+    std::string root;
+    if (options.root()) {
+        root = *options.root();
+    } else {
+#if _WIN32
+        return Help("missing root path");
+#else
+        char const *tmpdir = getenv("TMPDIR");
+        root = std::string(tmpdir != nullptr ? tmpdir : "/tmp") + "/bench_util_DirectoryWalk." + std::to_string(getpid());
+#endif
+    }
+
+    Harness harness = Harness("directory walk depth=" + std::to_string(options.depth()) + " directories=" + std::to_string(options.directories()) + " files=" + std::to_string(options.files()));
+
+    size_t expected = 0;
+    harness.stage("Create", [&]() -> bool {
+        return CreateTree(&filesystem, root, options.depth(), options.directories(), options.files(), &expected);
+    });
+
+    /* What callers did before walking: list names, then check each type. */
+    harness.stage("readDirectory + type", [&]() -> bool {
+        size_t directories = 0;
+        size_t entries = 0;
+        bool success = filesystem.readDirectory(root, true, [&](std::string const &name) {
+            if (filesystem.type(root + "/" + name) == Filesystem::Type::Directory) {
+                directories++;
+            }
+            entries++;
+        });
+        return success && entries == expected && directories > 0;
+    });
+
+    harness.stage("walkDirectory", [&]() -> bool {
+        size_t directories = 0;
+        size_t entries = 0;
+        bool success = filesystem.walkDirectory(root, true, [&](std::string const &name, Filesystem::Type type) {
+            if (type == Filesystem::Type::Directory) {
+                directories++;
+            }
+            entries++;
+        });
+        return success && entries == expected && directories > 0;
+    });
+
+    harness.stage("walkDirectoryParallel (" + std::to_string(options.threads()) + " threads)", [&]() -> bool {
+        size_t directories = 0;
+        size_t entries = 0;
+        bool success = filesystem.walkDirectoryParallel(root, options.threads(), [&](std::string const &name, Filesystem::Type type) {
+            if (type == Filesystem::Type::Directory) {
+                directories++;
+            }
+            entries++;
+        });
+        return success && entries == expected && directories > 0;
+    });
+
+    if (!options.root()) {
+        filesystem.removeDirectory(root, true);
+    }
+
+    if (options.csv()) {
+        harness.reportCSV(stdout, true);
+    } else {
+        harness.report(stdout);
+        fprintf(stdout, "Entries: %zu\n", expected);
+    }
+
+    for (Harness::Result const &result : harness.results()) {
+        if (!result.success()) {
+            return EXIT_FAILURE;
+        }
+    }
+
+    return EXIT_SUCCESS;
+}
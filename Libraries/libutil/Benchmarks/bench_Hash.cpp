@@ -0,0 +1,262 @@
+/**
+ Copyright (c) 2015-present, Facebook, Inc.
+ All rights reserved.
+
+ This source code is licensed under the BSD-style license found in the
+ LICENSE file in the root directory of this source tree. An additional grant
+ of patent rights can be found in the PATENTS file in the same directory.
+ */
+
+#include <benchmark/Harness.h>
+#include <libutil/DefaultFilesystem.h>
+#include <libutil/FileHasher.h>
+#include <libutil/Hash.h>
+#include <libutil/Options.h>
+#include <libutil/md5.h>
+#include <process/DefaultContext.h>
+
+#include <chrono>
+#include <cstdlib>
+#include <thread>
+
+#if !_WIN32
+#include <unistd.h>
+#endif
+
+using benchmark::Harness;
+using libutil::DefaultFilesystem;
+using libutil::FileHasher;
+using libutil::Filesystem;
+using libutil::Hash;
+
+class Options {
+private:
+    ext::optional<bool>        _help;
+
+private:
+    ext::optional<int>         _files;
+    ext::optional<int>         _size;
+    ext::optional<int>         _threads;
+    ext::optional<std::string> _root;
+
+private:
+    ext::optional<bool>        _csv;
+
+public:
+    Options();
+    ~Options();
+
+public:
+    bool help() const
+    { return _help.value_or(false); }
+
+public:
+    int files() const
+    { return _files.value_or(64); }
+    int size() const
+    { return _size.value_or(4 * 1024 * 1024); }
+    int threads() const
+    { return _threads.value_or(static_cast<int>(std::thread::hardware_concurrency())); }
+    ext::optional<std::string> const &root() const
+    { return _root; }
+
+public:
+    bool csv() const
+    { return _csv.value_or(false); }
+
+private:
+    friend class libutil::Options;
+    std::pair<bool, std::string>
+    parseArgument(std::vector<std::string> const &args, std::vector<std::string>::const_iterator *it);
+};
+
+Options::
+Options()
+{
+}
+
+Options::
+~Options()
+{
+}
+
+std::pair<bool, std::string> Options::
+parseArgument(std::vector<std::string> const &args, std::vector<std::string>::const_iterator *it)
+{
+    std::string const &arg = **it;
+
+    if (arg == "-h" || arg == "--help") {
+        return libutil::Options::Current<bool>(&_help, arg);
+    } else if (arg == "--files") {
+        return libutil::Options::Next<int>(&_files, args, it);
+    } else if (arg == "--size") {
+        return libutil::Options::Next<int>(&_size, args, it);
+    } else if (arg == "--threads") {
+        return libutil::Options::Next<int>(&_threads, args, it);
+    } else if (arg == "--root") {
+        return libutil::Options::Next<std::string>(&_root, args, it);
+    } else if (arg == "--csv") {
+        return libutil::Options::Current<bool>(&_csv, arg);
+    } else {
+        return std::make_pair(false, "unknown argument " + arg);
+    }
+}
+
+static int
+Help(std::string const &error = std::string())
+{
+    if (!error.empty()) {
+        fprintf(stderr, "error: %s\n", error.c_str());
+        fprintf(stderr, "\n");
+    }
+
+    fprintf(stderr, "Usage: bench_util_Hash [options]\n\n");
+    fprintf(stderr, "Measures hashing the contents of files.\n\n");
+
+#define INDENT "  "
+    fprintf(stderr, "Options:\n");
+    fprintf(stderr, INDENT "--files <count>\n");
+    fprintf(stderr, INDENT "--size <bytes per file>\n");
+    fprintf(stderr, INDENT "--threads <count>\n");
+    fprintf(stderr, INDENT "--root <path> (default: temporary directory)\n");
+    fprintf(stderr, INDENT "--csv\n");
+    fprintf(stderr, "\n");
+#undef INDENT
+
+    return (error.empty() ? EXIT_SUCCESS : EXIT_FAILURE);
+}
+
+int
+main(int argc, char **argv)
+{
+    process::DefaultContext processContext = process::DefaultContext();
+
+    Options options;
+    std::pair<bool, std::string> result = libutil::Options::Parse<Options>(&options, processContext.commandLineArguments());
+    if (!result.first) {
+        return Help(result.second);
+    }
+
+    if (options.help()) {
+        return Help();
+    }
+
+    if (options.files() <= 0 || options.size() < 0 || options.threads() <= 0) {
+        return Help("invalid count");
+    }
+
+    DefaultFilesystem filesystem;
+
+    std::string root;
+    if (options.root()) {
+        root = *options.root();
+    } else {
+#if _WIN32
+        return Help("missing root path");
+#else
+        char const *tmpdir = getenv("TMPDIR");
+        root = std::string(tmpdir != nullptr ? tmpdir : "/tmp") + "/bench_util_Hash." + std::to_string(getpid());
+#endif
+    }
+
+    Harness harness = Harness("hash files=" + std::to_string(options.files()) + " size=" + std::to_string(options.size()));
+
+    std::vector<std::string> paths;
+    harness.stage("Create", [&]() -> bool {
+        if (!filesystem.createDirectory(root, true)) {
+            return false;
+        }
+
+        std::vector<uint8_t> contents = std::vector<uint8_t>(options.size());
+        for (int i = 0; i < options.files(); i++) {
+            for (size_t j = 0; j < contents.size(); j++) {
+                contents[j] = static_cast<uint8_t>(i + j * 7);
+            }
+
+            paths.push_back(root + "/file" + std::to_string(i));
+            if (!filesystem.write(contents, paths.back())) {
+                return false;
+            }
+        }
+        return true;
+    });
+
+    /* How files were hashed before: read, then MD5. */
+    harness.stage("read + md5", [&]() -> bool {
+        for (std::string const &path : paths) {
+            std::vector<uint8_t> contents;
+            if (!filesystem.read(&contents, path)) {
+                return false;
+            }
+
+            md5_state_t state;
+            md5_init(&state);
+            md5_append(&state, reinterpret_cast<const md5_byte_t *>(contents.data()), contents.size());
+            uint8_t digest[16];
+            md5_finish(&state, reinterpret_cast<md5_byte_t *>(&digest));
+        }
+        return true;
+    });
+
+    harness.stage("read + Hash", [&]() -> bool {
+        for (std::string const &path : paths) {
+            std::vector<uint8_t> contents;
+            if (!filesystem.read(&contents, path)) {
+                return false;
+            }
+
+            Hash::Data(contents);
+        }
+        return true;
+    });
+
+    harness.stage("FileHasher::Contents", [&]() -> bool {
+        for (std::string const &path : paths) {
+            if (!FileHasher::Contents(&filesystem, path)) {
+                return false;
+            }
+        }
+        return true;
+    });
+
+    FileHasher hasher;
+    harness.stage("FileHasher (" + std::to_string(options.threads()) + " threads)", [&]() -> bool {
+        for (ext::optional<Hash> const &hash : hasher.hash(&filesystem, paths, options.threads())) {
+            if (!hash) {
+                return false;
+            }
+        }
+        return true;
+    });
+
+    /* Files were just written, so their hashes aren't trusted until they are older. */
+    std::this_thread::sleep_for(std::chrono::seconds(2));
+    hasher.hash(&filesystem, paths, options.threads());
+
+    harness.stage("FileHasher (remembered)", [&]() -> bool {
+        for (ext::optional<Hash> const &hash : hasher.hash(&filesystem, paths, options.threads())) {
+            if (!hash) {
+                return false;
+            }
+        }
+        return true;
+    });
+
+    if (!options.root()) {
+        filesystem.removeDirectory(root, true);
+    }
+
+    if (options.csv()) {
+        harness.reportCSV(stdout, true);
+    } else {
+        harness.report(stdout);
+    }
+
+    for (Harness::Result const &result : harness.results()) {
+        if (!result.success()) {
+            return EXIT_FAILURE;
+        }
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,280 @@
+/**
+ Copyright (c) 2015-present, Facebook, Inc.
+ All rights reserved.
+
+ This source code is licensed under the BSD-style license found in the
+ LICENSE file in the root directory of this source tree. An additional grant
+ of patent rights can be found in the PATENTS file in the same directory.
+ */
+
+#include <benchmark/Harness.h>
+#include <libutil/Wildcard.h>
+#include <libutil/WildcardSet.h>
+#include <libutil/Options.h>
+#include <process/DefaultContext.h>
+
+#include <algorithm>
+#include <cstdlib>
+
+using benchmark::Harness;
+using libutil::Wildcard;
+using libutil::WildcardSet;
+
+class Options {
+private:
+    ext::optional<bool>        _help;
+
+private:
+    ext::optional<int>         _strings;
+    ext::optional<int>         _iterations;
+
+private:
+    ext::optional<bool>        _csv;
+
+public:
+    Options();
+    ~Options();
+
+public:
+    bool help() const
+    { return _help.value_or(false); }
+
+public:
+    int strings() const
+    { return _strings.value_or(10000); }
+    int iterations() const
+    { return _iterations.value_or(20); }
+
+public:
+    bool csv() const
+    { return _csv.value_or(false); }
+
+private:
+    friend class libutil::Options;
+    std::pair<bool, std::string>
+    parseArgument(std::vector<std::string> const &args, std::vector<std::string>::const_iterator *it);
+};
+
+Options::
+Options()
+{
+}
+
+Options::
+~Options()
+{
+}
+
+std::pair<bool, std::string> Options::
+parseArgument(std::vector<std::string> const &args, std::vector<std::string>::const_iterator *it)
+{
+    std::string const &arg = **it;
+
+    if (arg == "-h" || arg == "--help") {
+        return libutil::Options::Current<bool>(&_help, arg);
+    } else if (arg == "--strings") {
+        return libutil::Options::Next<int>(&_strings, args, it);
+    } else if (arg == "--iterations") {
+        return libutil::Options::Next<int>(&_iterations, args, it);
+    } else if (arg == "--csv") {
+        return libutil::Options::Current<bool>(&_csv, arg);
+    } else {
+        return std::make_pair(false, "unknown argument " + arg);
+    }
+}
+
+static int
+Help(std::string const &error = std::string())
+{
+    if (!error.empty()) {
+        fprintf(stderr, "error: %s\n", error.c_str());
+        fprintf(stderr, "\n");
+    }
+
+    fprintf(stderr, "Usage: bench_util_Wildcard [options]\n\n");
+    fprintf(stderr, "Measures matching file names and flags against a list of patterns.\n\n");
+
+#define INDENT "  "
+    fprintf(stderr, "Options:\n");
+    fprintf(stderr, INDENT "--strings <count>\n");
+    fprintf(stderr, INDENT "--iterations <count>\n");
+    fprintf(stderr, INDENT "--csv\n");
+    fprintf(stderr, "\n");
+#undef INDENT
+
+    return (error.empty() ? EXIT_SUCCESS : EXIT_FAILURE);
+}
+
+/*
+ * The matcher before patterns were compiled, for comparison. It does not
+ * backtrack, so its results differ for some strings.
+ */
+static bool
+PreviousMatch(std::string const &pattern, std::string const &string)
+{
+    std::string::const_iterator sit = string.begin();
+    for (std::string::const_iterator fit = pattern.begin(); fit != pattern.end(); ++fit) {
+        std::string::const_iterator fend;
+        if (*fit == '*') {
+            if (++fit == pattern.end() || sit == string.end()) {
+                return true;
+            }
+
+            while (*sit++ != *fit) {
+                if (sit == string.end()) {
+                    return false;
+                }
+            }
+        } else if (*fit == '[' && (fend = std::find(fit, pattern.end(), ']')) != pattern.end()) {
+            std::string allowed = std::string(std::next(fit), fend);
+            if (sit == string.end() || allowed.find(*sit++) == std::string::npos) {
+                return false;
+            }
+            fit = fend;
+        } else if (sit == string.end() || *fit != *sit++) {
+            return false;
+        }
+    }
+
+    return (sit == string.end());
+}
+
+/*
+ * Patterns like those in file type and compiler specifications.
+ */
+static std::vector<std::string> const Patterns = {
+    "Jamfile", "*Jambase", "Makefile", "makefile", "*Info*.plist", "project.pbxproj",
+    "-v", "-###", "-H", "-fcolor-diagnostics", "-fmessage-length=*", "-fmacro-backtrace-limit=*", "-w", "-W*",
+    "*.[cC]", "*.[mM]", "*.mm", "*.cpp", "*.swift", "*.xcassets", "*.storyboard", "*.xib", "*.strings", "*.tar.gz",
+};
+
+static std::vector<std::string>
+Strings(int count)
+{
+    static std::vector<std::string> const extensions = {
+        "m", "h", "c", "swift", "png", "json", "strings", "plist", "xib", "gz",
+    };
+
+    std::vector<std::string> strings;
+    for (int i = 0; i < count; i++) {
+        switch (i % 4) {
+            case 0:
+                strings.push_back("Source" + std::to_string(i) + "." + extensions[i % extensions.size()]);
+                break;
+            case 1:
+                strings.push_back("Module" + std::to_string(i) + "-Info.plist");
+                break;
+            case 2:
+                strings.push_back("-Wno-warning-" + std::to_string(i));
+                break;
+            case 3:
+                strings.push_back("-I/src/Project/Headers/Group" + std::to_string(i));
+                break;
+        }
+    }
+    return strings;
+}
+
+int
+main(int argc, char **argv)
+{
+    process::DefaultContext processContext = process::DefaultContext();
+
+    Options options;
+    std::pair<bool, std::string> result = libutil::Options::Parse<Options>(&options, processContext.commandLineArguments());
+    if (!result.first) {
+        return Help(result.second);
+    }
+
+    if (options.help()) {
+        return Help();
+    }
+
+    if (options.strings() <= 0 || options.iterations() <= 0) {
+        return Help("invalid count");
+    }
+
+    std::vector<std::string> strings = Strings(options.strings());
+    Harness harness = Harness("wildcard patterns=" + std::to_string(Patterns.size()) + " strings=" + std::to_string(strings.size()) + " iterations=" + std::to_string(options.iterations()));
+
+    /* Each stage finds the first pattern matching each string. */
+    size_t expected = 0;
+    harness.stage("Previous", [&]() -> bool {
+        size_t matched = 0;
+        for (int i = 0; i < options.iterations(); i++) {
+            for (std::string const &string : strings) {
+                for (std::string const &pattern : Patterns) {
+                    if (PreviousMatch(pattern, string)) {
+                        matched++;
+                        break;
+                    }
+                }
+            }
+        }
+        return matched > 0;
+    });
+
+    harness.stage("Wildcard::Match", [&]() -> bool {
+        size_t matched = 0;
+        for (int i = 0; i < options.iterations(); i++) {
+            for (std::string const &string : strings) {
+                for (std::string const &pattern : Patterns) {
+                    if (Wildcard::Match(pattern, string)) {
+                        matched++;
+                        break;
+                    }
+                }
+            }
+        }
+        expected = matched;
+        return matched > 0;
+    });
+
+    harness.stage("Wildcard", [&]() -> bool {
+        std::vector<Wildcard> wildcards;
+        for (std::string const &pattern : Patterns) {
+            wildcards.push_back(Wildcard(pattern));
+        }
+
+        size_t matched = 0;
+        for (int i = 0; i < options.iterations(); i++) {
+            for (std::string const &string : strings) {
+                for (Wildcard const &wildcard : wildcards) {
+                    if (wildcard.match(string)) {
+                        matched++;
+                        break;
+                    }
+                }
+            }
+        }
+        return matched == expected;
+    });
+
+    harness.stage("WildcardSet", [&]() -> bool {
+        WildcardSet set = WildcardSet(Patterns);
+
+        size_t matched = 0;
+        for (int i = 0; i < options.iterations(); i++) {
+            for (std::string const &string : strings) {
+                if (set.match(string)) {
+                    matched++;
+                }
+            }
+        }
+        return matched == expected;
+    });
+
+    if (options.csv()) {
+        harness.reportCSV(stdout, true);
+    } else {
+        harness.report(stdout);
+    }
+
+    for (Harness::Result const &result : harness.results()) {
+        if (!result.success()) {
+            return EXIT_FAILURE;
+        }
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,115 @@
+/**
+ Copyright (c) 2015-present, Facebook, Inc.
+ All rights reserved.
+
+ This source code is licensed under the BSD-style license found in the
+ LICENSE file in the root directory of this source tree. An additional grant
+ of patent rights can be found in the PATENTS file in the same directory.
+ */
+
+#ifndef __libutil_CachingFilesystem_h
+#define __libutil_CachingFilesystem_h
+
+#include <libutil/Filesystem.h>
+
+#include <map>
+
+namespace libutil {
+
+/*
+ * Filesystem that remembers metadata queries made against another
+ * filesystem. Entry types, existence, readability, directory listings
+ * and resolved paths are only looked up once, until invalidated.
+ *
+ * Changes made through this filesystem invalidate the affected paths.
+ * Changes made any other way, such as by running a tool, must be
+ * explicitly invalidated. Paths are cached exactly as passed in.
+ */
+class CachingFilesystem : public Filesystem {
+private:
+    Filesystem *_filesystem;
+
+private:
+    typedef std::pair<bool, std::vector<std::string>> DirectoryEntries;
+    typedef std::pair<bool, std::vector<std::pair<std::string, Type>>> DirectoryWalk;
+
+private:
+    mutable std::map<std::string, bool>                _exists;
+    mutable std::map<std::string, ext::optional<Type>> _types;
+    mutable std::map<std::string, bool>                _readable;
+    mutable std::map<std::string, DirectoryEntries>    _directories;
+    mutable std::map<std::string, DirectoryEntries>    _recursiveDirectories;
+    mutable std::map<std::string, DirectoryWalk>       _walks;
+    mutable std::map<std::string, DirectoryWalk>       _recursiveWalks;
+    mutable std::map<std::string, std::string>         _resolvedPaths;
+
+public:
+    explicit CachingFilesystem(Filesystem *filesystem);
+    ~CachingFilesystem();
+
+public:
+    /*
+     * The filesystem queries are forwarded to.
+     */
+    Filesystem *filesystem() const
+    { return _filesystem; }
+
+public:
+    /*
+     * Forget cached information about a path, everything inside it, and
+     * the listings of the directories containing it.
+     */
+    void invalidate(std::string const &path);
+
+    /*
+     * Forget all cached information.
+     */
+    void invalidateAll();
+
+public:
+    virtual bool exists(std::string const &path) const;
+    virtual ext::optional<Type> type(std::string const &path) const;
+    virtual ext::optional<Identity> identity(std::string const &path) const;
+
+public:
+    virtual bool isReadable(std::string const &path) const;
+    virtual bool isWritable(std::string const &path) const;
+    virtual bool isExecutable(std::string const &path) const;
+
+public:
+    virtual ext::optional<Permissions> readFilePermissions(std::string const &path) const;
+    virtual bool writeFilePermissions(std::string const &path, Permissions::Operation operation, Permissions permissions);
+    virtual bool createFile(std::string const &path);
+    virtual bool read(std::vector<uint8_t> *contents, std::string const &path, size_t offset = 0, ext::optional<size_t> length = ext::nullopt) const;
+    virtual bool readContents(std::string const &path, std::function<void(uint8_t const *, size_t)> const &cb) const;
+    virtual std::unique_ptr<Mapping> map(std::string const &path) const;
+    virtual bool write(std::vector<uint8_t> const &contents, std::string const &path);
+    virtual std::unique_ptr<Output> openOutput(std::string const &path);
+    virtual bool copyFile(std::string const &from, std::string const &to);
+    virtual bool cloneFile(std::string const &from, std::string const &to);
+    virtual bool removeFile(std::string const &path);
+
+public:
+    virtual ext::optional<Permissions> readSymbolicLinkPermissions(std::string const &path) const;
+    virtual bool writeSymbolicLinkPermissions(std::string const &path, Permissions::Operation operation, Permissions permissions);
+    virtual ext::optional<std::string> readSymbolicLink(std::string const &path, bool *directory = nullptr) const;
+    virtual bool writeSymbolicLink(std::string const &target, std::string const &path, bool directory);
+    virtual bool copySymbolicLink(std::string const &from, std::string const &to);
+    virtual bool removeSymbolicLink(std::string const &path);
+
+public:
+    virtual ext::optional<Permissions> readDirectoryPermissions(std::string const &path) const;
+    virtual bool writeDirectoryPermissions(std::string const &path, Permissions::Operation operation, Permissions permissions, bool recursive);
+    virtual bool createDirectory(std::string const &path, bool recursive);
+    virtual bool readDirectory(std::string const &path, bool recursive, std::function<void(std::string const &)> const &cb) const;
+    virtual bool walkDirectory(std::string const &path, bool recursive, std::function<void(std::string const &, Type)> const &cb) const;
+    virtual bool copyDirectory(std::string const &from, std::string const &to, bool recursive);
+    virtual bool removeDirectory(std::string const &path, bool recursive);
+
+public:
+    virtual std::string resolvePath(std::string const &path) const;
+};
+
+}
+
+#endif  // !__libutil_CachingFilesystem_h
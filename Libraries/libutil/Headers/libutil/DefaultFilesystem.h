@@ -18,6 +18,7 @@ class DefaultFilesystem : public Filesystem {
 public:
     virtual bool exists(std::string const &path) const;
     virtual ext::optional<Type> type(std::string const &path) const;
+    virtual ext::optional<Identity> identity(std::string const &path) const;
 
 public:
     virtual bool isReadable(std::string const &path) const;
@@ -29,8 +30,12 @@ public:
     virtual bool writeFilePermissions(std::string const &path, Permissions::Operation operation, Permissions permissions);
     virtual bool createFile(std::string const &path);
     virtual bool read(std::vector<uint8_t> *contents, std::string const &path, size_t offset = 0, ext::optional<size_t> length = ext::nullopt) const;
+    virtual bool readContents(std::string const &path, std::function<void(uint8_t const *, size_t)> const &cb) const;
+    virtual std::unique_ptr<Mapping> map(std::string const &path) const;
     virtual bool write(std::vector<uint8_t> const &contents, std::string const &path);
+    virtual std::unique_ptr<Output> openOutput(std::string const &path);
     virtual bool copyFile(std::string const &from, std::string const &to);
+    virtual bool cloneFile(std::string const &from, std::string const &to);
     virtual bool removeFile(std::string const &path);
 
 public:
@@ -46,11 +51,21 @@ public:
     virtual bool writeDirectoryPermissions(std::string const &path, Permissions::Operation operation, Permissions permissions, bool recursive);
     virtual bool createDirectory(std::string const &path, bool recursive);
     virtual bool readDirectory(std::string const &path, bool recursive, std::function<void(std::string const &)> const &cb) const;
+    virtual bool walkDirectory(std::string const &path, bool recursive, std::function<void(std::string const &, Type)> const &cb) const;
     virtual bool copyDirectory(std::string const &from, std::string const &to, bool recursive);
     virtual bool removeDirectory(std::string const &path, bool recursive);
 
 public:
     virtual std::string resolvePath(std::string const &path) const;
+
+public:
+    /*
+     * Recursively walk a directory like `walkDirectory()`, reading
+     * directories on multiple threads. Worthwhile for wide trees. The
+     * callback is never called concurrently, but entries from different
+     * directories are reported in no particular order.
+     */
+    bool walkDirectoryParallel(std::string const &path, size_t threads, std::function<void(std::string const &, Type)> const &cb) const;
 };
 
 }
@@ -31,6 +31,13 @@ public:
      */
     static std::string
     Makefile(std::string const &value);
+
+    /*
+     * Escape an argument for a response file read by LLVM-based tools,
+     * which split on whitespace and handle quotes and backslashes.
+     */
+    static std::string
+    ResponseFile(std::string const &value);
 };
 
 }
@@ -0,0 +1,94 @@
+/**
+ Copyright (c) 2015-present, Facebook, Inc.
+ All rights reserved.
+
+ This source code is licensed under the BSD-style license found in the
+ LICENSE file in the root directory of this source tree. An additional grant
+ of patent rights can be found in the PATENTS file in the same directory.
+ */
+
+#ifndef __libutil_FileHasher_h
+#define __libutil_FileHasher_h
+
+#include <libutil/Filesystem.h>
+#include <libutil/Hash.h>
+
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include <ext/optional>
+
+namespace libutil {
+
+/*
+ * Hashes the contents of files, remembering the hash of each file along
+ * with its identity (device, inode, size and modification time). A file
+ * whose identity hasn't changed is not read again. The remembered hashes
+ * can be saved and loaded, so they are reused across builds.
+ *
+ * A file modified within a few seconds of being hashed could be modified
+ * again without changing its identity, so its hash is not trusted until
+ * it is hashed again later. Filesystems that can't identify files, like
+ * `MemoryFilesystem`, are always read.
+ *
+ * Thread safe.
+ */
+class FileHasher {
+private:
+    class Entry {
+    public:
+        Filesystem::Identity identity;
+        Hash                 hash;
+        uint64_t             hashed;
+        bool                 loaded;
+    };
+
+private:
+    mutable std::mutex                     _mutex;
+    std::unordered_map<std::string, Entry> _entries;
+
+public:
+    FileHasher();
+    ~FileHasher();
+
+public:
+    /*
+     * Hash the contents of a file. Returns nothing if it can't be read.
+     */
+    ext::optional<Hash> hash(Filesystem const *filesystem, std::string const &path);
+
+    /*
+     * Hash the contents of many files at once, on up to `jobs` threads
+     * (or one per processor, if zero). Results are in the same order.
+     */
+    std::vector<ext::optional<Hash>> hash(Filesystem const *filesystem, std::vector<std::string> const &paths, size_t jobs = 0);
+
+public:
+    /*
+     * The number of files with remembered hashes.
+     */
+    size_t size() const;
+
+    /*
+     * Load remembered hashes from a file, adding to those already known.
+     */
+    bool load(Filesystem const *filesystem, std::string const &path);
+
+    /*
+     * Save remembered hashes to a file. If `found`, only hashes found by
+     * reading files are saved, not those loaded.
+     */
+    bool save(Filesystem *filesystem, std::string const &path, bool found = false) const;
+
+public:
+    /*
+     * Hash the contents of a file, without remembering it.
+     */
+    static ext::optional<Hash>
+    Contents(Filesystem const *filesystem, std::string const &path);
+};
+
+}
+
+#endif // !__libutil_FileHasher_h
@@ -13,6 +13,7 @@
 #include <libutil/Permissions.h>
 
 #include <functional>
+#include <memory>
 #include <string>
 #include <vector>
 #include <ext/optional>
@@ -50,6 +51,38 @@ public:
      */
     virtual ext::optional<Type> type(std::string const &path) const = 0;
 
+public:
+    /*
+     * Identifies the contents of a file without reading it. If the contents
+     * change, so does the identity, as long as the change isn't within the
+     * filesystem's timestamp resolution.
+     */
+    class Identity {
+    public:
+        uint64_t device;
+        uint64_t inode;
+        uint64_t size;
+        /*
+         * Modification time, in nanoseconds since the epoch.
+         */
+        uint64_t modified;
+
+    public:
+        Identity();
+
+    public:
+        bool operator==(Identity const &rhs) const
+        { return device == rhs.device && inode == rhs.inode && size == rhs.size && modified == rhs.modified; }
+        bool operator!=(Identity const &rhs) const
+        { return !(*this == rhs); }
+    };
+
+    /*
+     * Get the identity of a file, following symbolic links. Not supported
+     * by all filesystems: by default, returns nothing.
+     */
+    virtual ext::optional<Identity> identity(std::string const &path) const;
+
 public:
     /*
      * Test if a file is readable.
@@ -88,16 +121,81 @@ public:
      */
     virtual bool read(std::vector<uint8_t> *contents, std::string const &path, size_t offset = 0, ext::optional<size_t> length = ext::nullopt) const = 0;
 
+    /*
+     * Read all of a file, passing the contents to a callback in one or more
+     * consecutive pieces. The pieces are only valid during the callback.
+     * Avoids copying where possible, such as by mapping large files into
+     * memory. By default, reads the file with `read()`.
+     */
+    virtual bool readContents(std::string const &path, std::function<void(uint8_t const *, size_t)> const &cb) const;
+
+    /*
+     * The contents of a file, available in memory until destroyed.
+     */
+    class Mapping {
+    public:
+        virtual ~Mapping();
+
+    public:
+        /*
+         * The contents of the file.
+         */
+        virtual uint8_t const *data() const = 0;
+        virtual size_t size() const = 0;
+    };
+
+    /*
+     * Make all of a file available in memory, for reading parts of it in
+     * any order. Returns null on failure. Avoids reading parts that are
+     * not used where possible, such as by mapping the file into memory.
+     * By default, reads the file with `read()`.
+     */
+    virtual std::unique_ptr<Mapping> map(std::string const &path) const;
+
     /*
      * Write to a file.
      */
     virtual bool write(std::vector<uint8_t> const &contents, std::string const &path) = 0;
 
+    /*
+     * A file being written incrementally. The contents do not appear at
+     * the path until committed, when they atomically replace any existing
+     * file. An output destroyed without being committed changes nothing.
+     */
+    class Output {
+    public:
+        virtual ~Output();
+
+    public:
+        /*
+         * Append to the contents of the file.
+         */
+        virtual bool write(uint8_t const *data, size_t size) = 0;
+
+        /*
+         * Finish writing and move the file into place.
+         */
+        virtual bool commit() = 0;
+    };
+
+    /*
+     * Open a file for incremental writing. Returns null on failure. By
+     * default, contents are buffered and written in full on commit.
+     */
+    virtual std::unique_ptr<Output> openOutput(std::string const &path);
+
     /*
      * Copy a file to a new path.
      */
     virtual bool copyFile(std::string const &from, std::string const &to);
 
+    /*
+     * Copy a file to a new path, sharing its storage with the original if
+     * the filesystem can. Later changes to either file are not seen in the
+     * other. By default, copies the file.
+     */
+    virtual bool cloneFile(std::string const &from, std::string const &to);
+
     /*
      * Delete a file.
      */
@@ -155,6 +253,14 @@ public:
      */
     virtual bool readDirectory(std::string const &path, bool recursive, std::function<void(std::string const &)> const &cb) const = 0;
 
+    /*
+     * Enumerate contents of a directory along with the type of each entry.
+     * Symbolic links are reported as links and not followed. Entries of
+     * unsupported types, such as devices, are skipped. Prefer this over
+     * checking the type of each entry from `readDirectory()`.
+     */
+    virtual bool walkDirectory(std::string const &path, bool recursive, std::function<void(std::string const &, Type)> const &cb) const;
+
     /*
      * Copy a directory to a new path, optionally recursively.
      */
@@ -171,6 +277,19 @@ public:
      */
     virtual std::string resolvePath(std::string const &path) const = 0;
 
+public:
+    /*
+     * Write a file only if its contents would change, so an unchanged file
+     * keeps its modification time. Changed files are replaced atomically.
+     * If provided, `changed` is set to whether the file was written.
+     */
+    bool writeIfChanged(std::vector<uint8_t> const &contents, std::string const &path, bool *changed = nullptr);
+
+    /*
+     * Test if a file exists with exactly the given contents.
+     */
+    bool hasContents(std::vector<uint8_t> const &contents, std::string const &path) const;
+
 public:
     /*
      * Finds a file in the given directories.
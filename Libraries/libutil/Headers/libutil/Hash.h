@@ -0,0 +1,130 @@
+/**
+ Copyright (c) 2015-present, Facebook, Inc.
+ All rights reserved.
+
+ This source code is licensed under the BSD-style license found in the
+ LICENSE file in the root directory of this source tree. An additional grant
+ of patent rights can be found in the PATENTS file in the same directory.
+ */
+
+#ifndef __libutil_Hash_h
+#define __libutil_Hash_h
+
+#include <functional>
+#include <string>
+#include <vector>
+#include <ext/optional>
+
+#include <cstddef>
+#include <cstdint>
+
+namespace libutil {
+
+/*
+ * A fast 128-bit hash, for identifying contents like files and cache keys.
+ * The hash is not cryptographic: use it to notice changes, not to defend
+ * against deliberate collisions. It is the same on every platform, so it
+ * can be stored and compared across runs.
+ *
+ * Input is processed 64 bytes at a time, using SIMD instructions where
+ * available. Contents can be hashed in one call or incrementally.
+ */
+class Hash {
+public:
+    /*
+     * Hashes contents incrementally. The result is the same as hashing
+     * all of the contents at once, no matter how they are split up.
+     */
+    class Stream {
+    private:
+        uint64_t _accumulators[8];
+        uint8_t  _buffer[1024];
+        size_t   _buffered;
+        uint64_t _length;
+
+    public:
+        Stream();
+
+    public:
+        /*
+         * Add contents to the hash.
+         */
+        void update(void const *data, size_t size);
+        void update(std::string const &string)
+        { update(string.data(), string.size()); }
+
+        /*
+         * The hash of the contents so far. More can be added afterwards.
+         */
+        Hash finish() const;
+
+    private:
+        void block(uint8_t const *data);
+    };
+
+private:
+    uint64_t _low;
+    uint64_t _high;
+
+public:
+    /*
+     * The hash of no contents.
+     */
+    Hash();
+    Hash(uint64_t low, uint64_t high);
+
+public:
+    bool operator==(Hash const &rhs) const
+    { return _low == rhs._low && _high == rhs._high; }
+    bool operator!=(Hash const &rhs) const
+    { return !(*this == rhs); }
+    bool operator<(Hash const &rhs) const
+    { return _high < rhs._high || (_high == rhs._high && _low < rhs._low); }
+
+public:
+    uint64_t low() const
+    { return _low; }
+    uint64_t high() const
+    { return _high; }
+
+public:
+    /*
+     * The hash as 32 lowercase hexadecimal digits.
+     */
+    std::string hex() const;
+
+    /*
+     * Parse a hash from its hexadecimal form.
+     */
+    static ext::optional<Hash>
+    Parse(std::string const &hex);
+
+public:
+    /*
+     * Hash contents in one call.
+     */
+    static Hash
+    Data(void const *data, size_t size);
+
+    static Hash
+    String(std::string const &string)
+    { return Data(string.data(), string.size()); }
+
+    static Hash
+    Data(std::vector<uint8_t> const &data)
+    { return Data(data.data(), data.size()); }
+};
+
+}
+
+namespace std {
+
+template<>
+struct hash<libutil::Hash> {
+    size_t operator()(libutil::Hash const &hash) const
+    { return static_cast<size_t>(hash.low()); }
+};
+
+}
+
+#endif // !__libutil_Hash_h
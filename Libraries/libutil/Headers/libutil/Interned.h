@@ -0,0 +1,153 @@
+/**
+ Copyright (c) 2015-present, Facebook, Inc.
+ All rights reserved.
+
+ This source code is licensed under the BSD-style license found in the
+ LICENSE file in the root directory of this source tree. An additional grant
+ of patent rights can be found in the PATENTS file in the same directory.
+ */
+
+#ifndef __libutil_Interned_h
+#define __libutil_Interned_h
+
+#include <functional>
+#include <string>
+
+#include <cstddef>
+
+namespace libutil {
+namespace Path {
+
+/*
+ * A file path stored once in a process-wide table. Copies share the same
+ * storage, and comparing or hashing two paths is a pointer comparison.
+ *
+ * Paths are stored as a tree: each path is the path before its last
+ * separator plus its last component, and components are shared between
+ * every path that contains them. Paths in the same directory only store
+ * their own names. The parent directory is the path before the last
+ * separator, and the normalized form is found from the normalized parent
+ * the first time it is used. The full path string is not kept; it is
+ * built from the components each time it is used.
+ *
+ * The path is kept exactly as written. Interned paths are never freed,
+ * so they should be used for paths that are likely to be repeated, like
+ * the inputs and outputs of build invocations.
+ *
+ * Interning is thread safe.
+ */
+class Interned {
+public:
+    struct Entry;
+
+private:
+    Entry const *_entry;
+
+private:
+    explicit Interned(Entry const *entry);
+
+private:
+    static Entry const *Intern(std::string const &raw);
+    static Entry const *Child(Entry const *entry, std::string const &name);
+    static Entry const *Normalized(Entry const *entry);
+
+public:
+    /*
+     * The empty path.
+     */
+    Interned();
+
+    /*
+     * Intern a path. Implicit so interned paths can be used where paths
+     * are built up as strings.
+     */
+    Interned(std::string const &raw);
+    Interned(char const *raw);
+
+public:
+    bool operator==(Interned const &rhs) const
+    { return _entry == rhs._entry; }
+    bool operator!=(Interned const &rhs) const
+    { return _entry != rhs._entry; }
+    bool operator<(Interned const &rhs) const
+    { return raw() < rhs.raw(); }
+
+public:
+    /*
+     * The path string, exactly as interned. Built each time, so keep the
+     * result rather than calling this repeatedly.
+     */
+    std::string raw() const;
+
+    /*
+     * Interned paths are usable as strings.
+     */
+    operator std::string() const
+    { return raw(); }
+
+    /*
+     * If the path is empty. Does not allocate.
+     */
+    bool empty() const;
+
+public:
+    /*
+     * The normalized path, as `Relative::normalized()`. Cached, so
+     * normalizing again is constant time.
+     */
+    Interned normalized() const;
+
+    /*
+     * The parent directory of this path, as `Relative::parent()`.
+     */
+    Interned parent() const;
+
+    /*
+     * A child of this path.
+     */
+    Interned child(std::string const &name) const;
+
+public:
+    /*
+     * The base name of the path. Does not allocate.
+     */
+    std::string const &base(bool extension = true) const;
+
+    /*
+     * The file extension of the path. Does not allocate.
+     */
+    std::string const &extension() const;
+
+    /*
+     * If the path's file extension matches. Does not allocate.
+     */
+    bool extension(std::string const &extension, bool insensitive = true) const;
+
+public:
+    /*
+     * A hash of the path. Equal paths have equal hashes.
+     */
+    size_t hash() const
+    { return std::hash<Entry const *>()(_entry); }
+
+public:
+    /*
+     * The number of distinct paths interned so far.
+     */
+    static size_t Count();
+};
+
+}
+}
+
+namespace std {
+
+template<>
+struct hash<libutil::Path::Interned> {
+    size_t operator()(libutil::Path::Interned const &path) const
+    { return path.hash(); }
+};
+
+}
+
+#endif // !__libutil_Interned_h
@@ -101,6 +101,7 @@ public:
     virtual bool writeDirectoryPermissions(std::string const &path, Permissions::Operation operation, Permissions permissions, bool recursive);
     virtual bool createDirectory(std::string const &path, bool recursive);
     virtual bool readDirectory(std::string const &path, bool recursive, std::function<void(std::string const &)> const &cb) const;
+    virtual bool walkDirectory(std::string const &path, bool recursive, std::function<void(std::string const &, Type)> const &cb) const;
     virtual bool copyDirectory(std::string const &from, std::string const &to, bool recursive);
     virtual bool removeDirectory(std::string const &path, bool recursive);
 
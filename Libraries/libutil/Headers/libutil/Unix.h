@@ -21,6 +21,8 @@ class BaseAbsolute;
 template<typename Traits>
 class BaseRelative;
 
+class Interned;
+
 class Unix {
 public:
     Unix() = delete;
@@ -29,6 +31,7 @@ public:
 public:
     friend class BaseAbsolute<Unix>;
     friend class BaseRelative<Unix>;
+    friend class Interned;
 
 private:
     static char Separator;
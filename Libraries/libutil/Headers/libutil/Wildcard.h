@@ -10,12 +10,92 @@
 #ifndef __libutil_Wildcard_h
 #define __libutil_Wildcard_h
 
+#include <bitset>
 #include <string>
+#include <vector>
+
+#include <cstddef>
+#include <cstdint>
 
 namespace libutil {
 
-struct Wildcard {
+class WildcardSet;
+
+/*
+ * A shell-style pattern. A `*` matches any run of characters, including
+ * none, and `[abc]` matches any one of the characters in the brackets.
+ * Other characters, including a `[` without a closing `]`, match only
+ * themselves.
+ *
+ * Patterns are compiled once on creation to be matched many times.
+ */
+class Wildcard {
+private:
+    /*
+     * A run of characters between stars. Each position is either a literal
+     * character or a character class, so a segment always matches a fixed
+     * number of characters.
+     */
+    struct Segment {
+        size_t offset;
+        size_t length;
+        bool   literal;
+    };
+
+private:
+    std::string                    _pattern;
+
+private:
+    std::string                    _text;
+    std::vector<int32_t>           _positionClasses;
+    std::vector<std::bitset<256>>  _classes;
+    std::vector<Segment>           _segments;
+    size_t                         _length;
+
+public:
+    explicit Wildcard(std::string const &pattern);
+
+public:
+    /*
+     * The pattern as written.
+     */
+    std::string const &pattern() const
+    { return _pattern; }
+
+public:
+    /*
+     * If the pattern has no stars or classes, so only matches itself.
+     */
+    bool literal() const
+    { return _segments.size() == 1 && _segments.front().literal; }
+
+    /*
+     * The fewest characters a matching string can have.
+     */
+    size_t minimumLength() const
+    { return _length; }
+
+public:
+    /*
+     * If the whole string matches the pattern.
+     */
+    bool match(std::string const &string) const
+    { return match(string.data(), string.size()); }
+    bool match(char const *data, size_t size) const;
+
+public:
+    /*
+     * Match a pattern against a string once, without compiling it. For
+     * matching the same pattern repeatedly, create a `Wildcard` instead.
+     */
     static bool Match(std::string const &pattern, std::string const &string);
+
+private:
+    bool matchSegment(Segment const &segment, char const *data) const;
+    size_t findSegment(Segment const &segment, char const *data, size_t begin, size_t end) const;
+
+private:
+    friend class WildcardSet;
 };
 
 }
@@ -0,0 +1,56 @@
+/**
+ Copyright (c) 2015-present, Facebook, Inc.
+ All rights reserved.
+
+ This source code is licensed under the BSD-style license found in the
+ LICENSE file in the root directory of this source tree. An additional grant
+ of patent rights can be found in the PATENTS file in the same directory.
+ */
+
+#ifndef __libutil_WildcardSet_h
+#define __libutil_WildcardSet_h
+
+#include <libutil/Wildcard.h>
+
+#include <string>
+#include <utility>
+#include <vector>
+#include <ext/optional>
+
+namespace libutil {
+
+/*
+ * A list of patterns to match a string against together. Patterns are
+ * indexed by the character they require a string to end with, if any,
+ * so only the patterns that could match are checked.
+ */
+class WildcardSet {
+private:
+    std::vector<Wildcard>                       _wildcards;
+
+private:
+    std::vector<std::pair<char, size_t>>        _lastCharacters;
+    std::vector<size_t>                         _others;
+
+public:
+    explicit WildcardSet(std::vector<std::string> const &patterns);
+
+public:
+    /*
+     * The compiled patterns, in order.
+     */
+    std::vector<Wildcard> const &wildcards() const
+    { return _wildcards; }
+
+public:
+    /*
+     * The index of the first pattern matching the string, if any.
+     */
+    ext::optional<size_t> match(std::string const &string) const
+    { return match(string.data(), string.size()); }
+    ext::optional<size_t> match(char const *data, size_t size) const;
+};
+
+}
+
+#endif  // !__libutil_WildcardSet_h
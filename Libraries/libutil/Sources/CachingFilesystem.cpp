@@ -0,0 +1,379 @@
+/**
+ Copyright (c) 2015-present, Facebook, Inc.
+ All rights reserved.
+
+ This source code is licensed under the BSD-style license found in the
+ LICENSE file in the root directory of this source tree. An additional grant
+ of patent rights can be found in the PATENTS file in the same directory.
+ */
+
+#include <libutil/CachingFilesystem.h>
+#include <libutil/FSUtil.h>
+
+using libutil::CachingFilesystem;
+using libutil::Filesystem;
+using libutil::FSUtil;
+using libutil::Permissions;
+
+CachingFilesystem::
+CachingFilesystem(Filesystem *filesystem) :
+    _filesystem(filesystem)
+{
+}
+
+CachingFilesystem::
+~CachingFilesystem()
+{
+}
+
+template<typename T>
+static void
+CachingFilesystemErase(std::map<std::string, T> *cache, std::string const &path, bool descendants)
+{
+    cache->erase(path);
+
+    if (descendants) {
+        /* Entries inside the path sort immediately after it and its separator. */
+        std::string prefix = path + "/";
+        auto it = cache->lower_bound(prefix);
+        while (it != cache->end() && it->first.compare(0, prefix.size(), prefix) == 0) {
+            it = cache->erase(it);
+        }
+    }
+}
+
+void CachingFilesystem::
+invalidate(std::string const &path)
+{
+    CachingFilesystemErase(&_exists, path, true);
+    CachingFilesystemErase(&_types, path, true);
+    CachingFilesystemErase(&_readable, path, true);
+    CachingFilesystemErase(&_directories, path, true);
+    CachingFilesystemErase(&_recursiveDirectories, path, true);
+    CachingFilesystemErase(&_walks, path, true);
+    CachingFilesystemErase(&_recursiveWalks, path, true);
+    CachingFilesystemErase(&_resolvedPaths, path, true);
+
+    /*
+     * Containing directories have different contents now, and could also
+     * have been created along with the path.
+     */
+    std::string current = path;
+    while (true) {
+        std::string parent = FSUtil::GetDirectoryName(current);
+        if (parent.empty() || parent == current) {
+            break;
+        }
+
+        CachingFilesystemErase(&_exists, parent, false);
+        CachingFilesystemErase(&_types, parent, false);
+        CachingFilesystemErase(&_readable, parent, false);
+        CachingFilesystemErase(&_directories, parent, false);
+        CachingFilesystemErase(&_recursiveDirectories, parent, false);
+        CachingFilesystemErase(&_walks, parent, false);
+        CachingFilesystemErase(&_recursiveWalks, parent, false);
+        CachingFilesystemErase(&_resolvedPaths, parent, false);
+
+        current = parent;
+    }
+}
+
+void CachingFilesystem::
+invalidateAll()
+{
+    _exists.clear();
+    _types.clear();
+    _readable.clear();
+    _directories.clear();
+    _recursiveDirectories.clear();
+    _walks.clear();
+    _recursiveWalks.clear();
+    _resolvedPaths.clear();
+}
+
+bool CachingFilesystem::
+exists(std::string const &path) const
+{
+    auto it = _exists.find(path);
+    if (it == _exists.end()) {
+        it = _exists.insert({ path, _filesystem->exists(path) }).first;
+    }
+    return it->second;
+}
+
+ext::optional<Filesystem::Type> CachingFilesystem::
+type(std::string const &path) const
+{
+    auto it = _types.find(path);
+    if (it == _types.end()) {
+        it = _types.insert({ path, _filesystem->type(path) }).first;
+    }
+    return it->second;
+}
+
+ext::optional<Filesystem::Identity> CachingFilesystem::
+identity(std::string const &path) const
+{
+    /* Not cached: identities are for noticing changes. */
+    return _filesystem->identity(path);
+}
+
+bool CachingFilesystem::
+isReadable(std::string const &path) const
+{
+    auto it = _readable.find(path);
+    if (it == _readable.end()) {
+        it = _readable.insert({ path, _filesystem->isReadable(path) }).first;
+    }
+    return it->second;
+}
+
+bool CachingFilesystem::
+isWritable(std::string const &path) const
+{
+    return _filesystem->isWritable(path);
+}
+
+bool CachingFilesystem::
+isExecutable(std::string const &path) const
+{
+    return _filesystem->isExecutable(path);
+}
+
+ext::optional<Permissions> CachingFilesystem::
+readFilePermissions(std::string const &path) const
+{
+    return _filesystem->readFilePermissions(path);
+}
+
+bool CachingFilesystem::
+writeFilePermissions(std::string const &path, Permissions::Operation operation, Permissions permissions)
+{
+    invalidate(path);
+    return _filesystem->writeFilePermissions(path, operation, permissions);
+}
+
+bool CachingFilesystem::
+createFile(std::string const &path)
+{
+    invalidate(path);
+    return _filesystem->createFile(path);
+}
+
+bool CachingFilesystem::
+read(std::vector<uint8_t> *contents, std::string const &path, size_t offset, ext::optional<size_t> length) const
+{
+    return _filesystem->read(contents, path, offset, length);
+}
+
+bool CachingFilesystem::
+readContents(std::string const &path, std::function<void(uint8_t const *, size_t)> const &cb) const
+{
+    return _filesystem->readContents(path, cb);
+}
+
+std::unique_ptr<Filesystem::Mapping> CachingFilesystem::
+map(std::string const &path) const
+{
+    return _filesystem->map(path);
+}
+
+bool CachingFilesystem::
+write(std::vector<uint8_t> const &contents, std::string const &path)
+{
+    invalidate(path);
+    return _filesystem->write(contents, path);
+}
+
+/*
+ * Invalidates the output path once the output is in place.
+ */
+class CachingFilesystemOutput : public Filesystem::Output {
+private:
+    CachingFilesystem                  *_filesystem;
+    std::string                         _path;
+    std::unique_ptr<Filesystem::Output> _output;
+
+public:
+    CachingFilesystemOutput(CachingFilesystem *filesystem, std::string const &path, std::unique_ptr<Filesystem::Output> output) :
+        _filesystem(filesystem),
+        _path      (path),
+        _output    (std::move(output))
+    {
+    }
+
+public:
+    virtual bool write(uint8_t const *data, size_t size)
+    {
+        return _output->write(data, size);
+    }
+
+    virtual bool commit()
+    {
+        bool result = _output->commit();
+        _filesystem->invalidate(_path);
+        return result;
+    }
+};
+
+std::unique_ptr<Filesystem::Output> CachingFilesystem::
+openOutput(std::string const &path)
+{
+    std::unique_ptr<Filesystem::Output> output = _filesystem->openOutput(path);
+    if (output == nullptr) {
+        return nullptr;
+    }
+
+    invalidate(path);
+    return std::unique_ptr<Filesystem::Output>(new CachingFilesystemOutput(this, path, std::move(output)));
+}
+
+bool CachingFilesystem::
+copyFile(std::string const &from, std::string const &to)
+{
+    invalidate(to);
+    return _filesystem->copyFile(from, to);
+}
+
+bool CachingFilesystem::
+cloneFile(std::string const &from, std::string const &to)
+{
+    invalidate(to);
+    return _filesystem->cloneFile(from, to);
+}
+
+bool CachingFilesystem::
+removeFile(std::string const &path)
+{
+    invalidate(path);
+    return _filesystem->removeFile(path);
+}
+
+ext::optional<Permissions> CachingFilesystem::
+readSymbolicLinkPermissions(std::string const &path) const
+{
+    return _filesystem->readSymbolicLinkPermissions(path);
+}
+
+bool CachingFilesystem::
+writeSymbolicLinkPermissions(std::string const &path, Permissions::Operation operation, Permissions permissions)
+{
+    invalidate(path);
+    return _filesystem->writeSymbolicLinkPermissions(path, operation, permissions);
+}
+
+ext::optional<std::string> CachingFilesystem::
+readSymbolicLink(std::string const &path, bool *directory) const
+{
+    return _filesystem->readSymbolicLink(path, directory);
+}
+
+bool CachingFilesystem::
+writeSymbolicLink(std::string const &target, std::string const &path, bool directory)
+{
+    invalidate(path);
+    return _filesystem->writeSymbolicLink(target, path, directory);
+}
+
+bool CachingFilesystem::
+copySymbolicLink(std::string const &from, std::string const &to)
+{
+    invalidate(to);
+    return _filesystem->copySymbolicLink(from, to);
+}
+
+bool CachingFilesystem::
+removeSymbolicLink(std::string const &path)
+{
+    invalidate(path);
+    return _filesystem->removeSymbolicLink(path);
+}
+
+ext::optional<Permissions> CachingFilesystem::
+readDirectoryPermissions(std::string const &path) const
+{
+    return _filesystem->readDirectoryPermissions(path);
+}
+
+bool CachingFilesystem::
+writeDirectoryPermissions(std::string const &path, Permissions::Operation operation, Permissions permissions, bool recursive)
+{
+    invalidate(path);
+    return _filesystem->writeDirectoryPermissions(path, operation, permissions, recursive);
+}
+
+bool CachingFilesystem::
+createDirectory(std::string const &path, bool recursive)
+{
+    invalidate(path);
+    return _filesystem->createDirectory(path, recursive);
+}
+
+bool CachingFilesystem::
+readDirectory(std::string const &path, bool recursive, std::function<void(std::string const &)> const &cb) const
+{
+    std::map<std::string, DirectoryEntries> *directories = (recursive ? &_recursiveDirectories : &_directories);
+
+    auto it = directories->find(path);
+    if (it == directories->end()) {
+        DirectoryEntries entries;
+        entries.first = _filesystem->readDirectory(path, recursive, [&](std::string const &name) {
+            entries.second.push_back(name);
+        });
+        it = directories->insert({ path, std::move(entries) }).first;
+    }
+
+    for (std::string const &name : it->second.second) {
+        cb(name);
+    }
+
+    return it->second.first;
+}
+
+bool CachingFilesystem::
+walkDirectory(std::string const &path, bool recursive, std::function<void(std::string const &, Type)> const &cb) const
+{
+    std::map<std::string, DirectoryWalk> *walks = (recursive ? &_recursiveWalks : &_walks);
+
+    auto it = walks->find(path);
+    if (it == walks->end()) {
+        DirectoryWalk walk;
+        walk.first = _filesystem->walkDirectory(path, recursive, [&](std::string const &name, Type type) {
+            walk.second.push_back({ name, type });
+
+            /* The walk found the type of each entry, so remember it too. */
+            _types.insert({ path + "/" + name, type });
+        });
+        it = walks->insert({ path, std::move(walk) }).first;
+    }
+
+    for (std::pair<std::string, Type> const &entry : it->second.second) {
+        cb(entry.first, entry.second);
+    }
+
+    return it->second.first;
+}
+
+bool CachingFilesystem::
+copyDirectory(std::string const &from, std::string const &to, bool recursive)
+{
+    invalidate(to);
+    return _filesystem->copyDirectory(from, to, recursive);
+}
+
+bool CachingFilesystem::
+removeDirectory(std::string const &path, bool recursive)
+{
+    invalidate(path);
+    return _filesystem->removeDirectory(path, recursive);
+}
+
+std::string CachingFilesystem::
+resolvePath(std::string const &path) const
+{
+    auto it = _resolvedPaths.find(path);
+    if (it == _resolvedPaths.end()) {
+        it = _resolvedPaths.insert({ path, _filesystem->resolvePath(path) }).first;
+    }
+    return it->second;
+}
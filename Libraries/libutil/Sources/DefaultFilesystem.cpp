@@ -10,7 +10,12 @@
 #include <libutil/DefaultFilesystem.h>
 #include <libutil/FSUtil.h>
 
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
 #include <stack>
+#include <thread>
 #include <climits>
 #include <cstdlib>
 #include <cstdio>
@@ -21,12 +26,18 @@
 #include <windows.h>
 #else
 #include <unistd.h>
+#include <fcntl.h>
 #include <libgen.h>
 #include <dirent.h>
 #include <sys/stat.h>
+#include <sys/mman.h>
 #if defined(__APPLE__) || defined(__FreeBSD__)
 #include <copyfile.h>
 #endif
+#if defined(__linux__)
+#include <sys/ioctl.h>
+#include <linux/fs.h>
+#endif
 #endif
 
 using libutil::DefaultFilesystem;
@@ -180,6 +191,55 @@ type(std::string const &path) const
 #endif
 }
 
+ext::optional<Filesystem::Identity> DefaultFilesystem::
+identity(std::string const &path) const
+{
+#if _WIN32
+    WideString wide = StringToWideString(path);
+
+    static DWORD const share = (FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE);
+    HANDLE handle = CreateFileW(wide.c_str(), 0, share, nullptr, OPEN_EXISTING, FILE_FLAG_BACKUP_SEMANTICS, nullptr);
+    if (handle == INVALID_HANDLE_VALUE) {
+        return ext::nullopt;
+    }
+
+    BY_HANDLE_FILE_INFORMATION information;
+    if (!GetFileInformationByHandle(handle, &information)) {
+        CloseHandle(handle);
+        return ext::nullopt;
+    }
+    CloseHandle(handle);
+
+    /* File times are in 100 nanosecond intervals since 1601. */
+    uint64_t modified = (static_cast<uint64_t>(information.ftLastWriteTime.dwHighDateTime) << 32) | information.ftLastWriteTime.dwLowDateTime;
+
+    Identity identity;
+    identity.device = information.dwVolumeSerialNumber;
+    identity.inode = (static_cast<uint64_t>(information.nFileIndexHigh) << 32) | information.nFileIndexLow;
+    identity.size = (static_cast<uint64_t>(information.nFileSizeHigh) << 32) | information.nFileSizeLow;
+    identity.modified = (modified - 116444736000000000ULL) * 100;
+    return identity;
+#else
+    struct stat st;
+    if (::stat(path.c_str(), &st) != 0) {
+        return ext::nullopt;
+    }
+
+#if defined(__APPLE__)
+    struct timespec modified = st.st_mtimespec;
+#else
+    struct timespec modified = st.st_mtim;
+#endif
+
+    Identity identity;
+    identity.device = static_cast<uint64_t>(st.st_dev);
+    identity.inode = static_cast<uint64_t>(st.st_ino);
+    identity.size = static_cast<uint64_t>(st.st_size);
+    identity.modified = static_cast<uint64_t>(modified.tv_sec) * 1000000000ULL + static_cast<uint64_t>(modified.tv_nsec);
+    return identity;
+#endif
+}
+
 bool DefaultFilesystem::
 isReadable(std::string const &path) const
 {
@@ -238,6 +298,38 @@ isExecutable(std::string const &path) const
 }
 
 #if !_WIN32
+/*
+ * Files at least this large are mapped into memory rather than read.
+ */
+static size_t const DefaultFilesystemMapSize = 256 * 1024;
+
+/*
+ * A file mapped into memory.
+ */
+class DefaultFilesystemMapping : public Filesystem::Mapping {
+private:
+    void   *_data;
+    size_t  _size;
+
+public:
+    DefaultFilesystemMapping(void *data, size_t size) :
+        _data(data),
+        _size(size)
+    {
+    }
+
+    virtual ~DefaultFilesystemMapping()
+    {
+        ::munmap(_data, _size);
+    }
+
+public:
+    virtual uint8_t const *data() const
+    { return static_cast<uint8_t const *>(_data); }
+    virtual size_t size() const
+    { return _size; }
+};
+
 static Permissions
 ModePermissions(mode_t mode)
 {
@@ -400,15 +492,10 @@ writeDirectoryPermissions(std::string const &path, Permissions::Operation operat
     if (recursive) {
         bool success = true;
 
-        success &= this->readDirectory(path, recursive, [this, &path, &operation, &permissions, &success](std::string const &name) {
+        success &= this->walkDirectory(path, recursive, [this, &path, &operation, &permissions, &success](std::string const &name, Type type) {
             std::string full = path + "/" + name;
 
-            ext::optional<Type> type = this->type(full);
-            if (!type) {
-                return false;
-            }
-
-            switch (*type) {
+            switch (type) {
                 case Type::File:
                     if (!this->writeFilePermissions(full, operation, permissions)) {
                         success = false;
@@ -558,6 +645,96 @@ read(std::vector<uint8_t> *contents, std::string const &path, size_t offset, ext
 #endif
 }
 
+bool DefaultFilesystem::
+readContents(std::string const &path, std::function<void(uint8_t const *, size_t)> const &cb) const
+{
+#if _WIN32
+    return Filesystem::readContents(path, cb);
+#else
+    int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        return false;
+    }
+
+    struct stat st;
+    if (::fstat(fd, &st) != 0 || !S_ISREG(st.st_mode)) {
+        ::close(fd);
+        return false;
+    }
+
+    /*
+     * Map large files rather than copying them. Small files are cheaper
+     * to read than to map and unmap.
+     */
+    size_t size = static_cast<size_t>(st.st_size);
+    if (size >= DefaultFilesystemMapSize) {
+        void *mapped = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (mapped != MAP_FAILED) {
+#if defined(POSIX_MADV_SEQUENTIAL)
+            ::posix_madvise(mapped, size, POSIX_MADV_SEQUENTIAL);
+#endif
+            cb(static_cast<uint8_t const *>(mapped), size);
+            ::munmap(mapped, size);
+            ::close(fd);
+            return true;
+        }
+    }
+
+    /* Stream through a fixed buffer, which also handles mapping failures. */
+    std::vector<uint8_t> buffer = std::vector<uint8_t>(std::min<size_t>(std::max<size_t>(size, 1), 64 * 1024));
+    while (true) {
+        ssize_t count = ::read(fd, buffer.data(), buffer.size());
+        if (count < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+
+            ::close(fd);
+            return false;
+        } else if (count == 0) {
+            break;
+        }
+
+        cb(buffer.data(), static_cast<size_t>(count));
+    }
+
+    ::close(fd);
+    return true;
+#endif
+}
+
+std::unique_ptr<Filesystem::Mapping> DefaultFilesystem::
+map(std::string const &path) const
+{
+#if _WIN32
+    return Filesystem::map(path);
+#else
+    int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        return nullptr;
+    }
+
+    struct stat st;
+    if (::fstat(fd, &st) != 0 || !S_ISREG(st.st_mode)) {
+        ::close(fd);
+        return nullptr;
+    }
+
+    /* Pages are only read as they're used. */
+    size_t size = static_cast<size_t>(st.st_size);
+    if (size >= DefaultFilesystemMapSize) {
+        void *mapped = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (mapped != MAP_FAILED) {
+            ::close(fd);
+            return std::unique_ptr<Filesystem::Mapping>(new DefaultFilesystemMapping(mapped, size));
+        }
+    }
+
+    ::close(fd);
+    return Filesystem::map(path);
+#endif
+}
+
 bool DefaultFilesystem::
 write(std::vector<uint8_t> const &contents, std::string const &path)
 {
@@ -598,6 +775,158 @@ write(std::vector<uint8_t> const &contents, std::string const &path)
 #endif
 }
 
+/*
+ * Streams contents to a temporary file beside the destination, then
+ * renames it into place so readers never observe a partial file.
+ */
+class DefaultFilesystemOutput : public Filesystem::Output {
+private:
+    std::string _path;
+    std::string _temporaryPath;
+#if _WIN32
+    HANDLE      _handle;
+#else
+    int         _fd;
+#endif
+
+public:
+#if _WIN32
+    DefaultFilesystemOutput(std::string const &path, std::string const &temporaryPath, HANDLE handle) :
+        _path         (path),
+        _temporaryPath(temporaryPath),
+        _handle       (handle)
+    {
+    }
+#else
+    DefaultFilesystemOutput(std::string const &path, std::string const &temporaryPath, int fd) :
+        _path         (path),
+        _temporaryPath(temporaryPath),
+        _fd           (fd)
+    {
+    }
+#endif
+
+    virtual ~DefaultFilesystemOutput()
+    {
+        /* Not committed: discard the partial file. */
+        if (close()) {
+#if _WIN32
+            DeleteFileW(StringToWideString(_temporaryPath).c_str());
+#else
+            ::unlink(_temporaryPath.c_str());
+#endif
+        }
+    }
+
+public:
+    virtual bool write(uint8_t const *data, size_t size)
+    {
+#if _WIN32
+        while (size > 0) {
+            DWORD written = 0;
+            DWORD chunk = (size > MAXDWORD ? MAXDWORD : static_cast<DWORD>(size));
+            if (_handle == INVALID_HANDLE_VALUE || !WriteFile(_handle, data, chunk, &written, nullptr)) {
+                return false;
+            }
+
+            data += written;
+            size -= written;
+        }
+#else
+        while (size > 0) {
+            ssize_t written = (_fd < 0 ? -1 : ::write(_fd, data, size));
+            if (written < 0) {
+                if (_fd >= 0 && errno == EINTR) {
+                    continue;
+                }
+                return false;
+            }
+
+            data += written;
+            size -= written;
+        }
+#endif
+
+        return true;
+    }
+
+    virtual bool commit()
+    {
+        if (!close()) {
+            return false;
+        }
+
+#if _WIN32
+        if (!MoveFileExW(StringToWideString(_temporaryPath).c_str(), StringToWideString(_path).c_str(), MOVEFILE_REPLACE_EXISTING)) {
+            DeleteFileW(StringToWideString(_temporaryPath).c_str());
+            return false;
+        }
+#else
+        if (::rename(_temporaryPath.c_str(), _path.c_str()) != 0) {
+            ::unlink(_temporaryPath.c_str());
+            return false;
+        }
+#endif
+
+        return true;
+    }
+
+private:
+    /*
+     * Close the temporary file. Returns false if it was already closed.
+     */
+    bool close()
+    {
+#if _WIN32
+        if (_handle == INVALID_HANDLE_VALUE) {
+            return false;
+        }
+
+        CloseHandle(_handle);
+        _handle = INVALID_HANDLE_VALUE;
+#else
+        if (_fd < 0) {
+            return false;
+        }
+
+        ::close(_fd);
+        _fd = -1;
+#endif
+        return true;
+    }
+};
+
+std::unique_ptr<Filesystem::Output> DefaultFilesystem::
+openOutput(std::string const &path)
+{
+    /*
+     * The temporary file must be on the same volume as the destination for
+     * the rename to be atomic; put it in the same directory.
+     */
+    static std::atomic<unsigned int> counter(0);
+
+#if _WIN32
+    std::string temporaryPath = path + ".tmp" + std::to_string(GetCurrentProcessId()) + "." + std::to_string(counter++);
+
+    HANDLE handle = CreateFileW(StringToWideString(temporaryPath).c_str(), GENERIC_WRITE, 0, nullptr, CREATE_NEW, 0, nullptr);
+    if (handle == INVALID_HANDLE_VALUE) {
+        return nullptr;
+    }
+
+    return std::unique_ptr<Filesystem::Output>(new DefaultFilesystemOutput(path, temporaryPath, handle));
+#else
+    std::string temporaryPath = path + ".tmp" + std::to_string(::getpid()) + "." + std::to_string(counter++);
+
+    /* Create with default permissions (subject to umask), like fopen(). */
+    int fd = ::open(temporaryPath.c_str(), O_WRONLY | O_CREAT | O_EXCL | O_TRUNC, 0666);
+    if (fd < 0) {
+        return nullptr;
+    }
+
+    return std::unique_ptr<Filesystem::Output>(new DefaultFilesystemOutput(path, temporaryPath, fd));
+#endif
+}
+
 bool DefaultFilesystem::
 copyFile(std::string const &from, std::string const &to)
 {
@@ -659,6 +988,69 @@ copyFile(std::string const &from, std::string const &to)
 #endif
 }
 
+bool DefaultFilesystem::
+cloneFile(std::string const &from, std::string const &to)
+{
+#if defined(__APPLE__)
+    ext::optional<Type> fromType = this->type(from);
+    if (fromType != Type::File) {
+        return false;
+    }
+
+    ext::optional<Type> toType = this->type(to);
+    if (toType == Type::File && !this->removeFile(to)) {
+        return false;
+    } else if (toType == Type::SymbolicLink && !this->removeSymbolicLink(to)) {
+        return false;
+    } else if (toType == Type::Directory) {
+        return false;
+    }
+
+    /* Clones where the volume supports it, and copies otherwise. */
+    if (::copyfile(from.c_str(), to.c_str(), nullptr, COPYFILE_CLONE | COPYFILE_NOFOLLOW) == 0) {
+        return true;
+    }
+
+    return this->copyFile(from, to);
+#elif defined(__linux__) && defined(FICLONE)
+    int fromFd = ::open(from.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fromFd < 0) {
+        return false;
+    }
+
+    struct stat st;
+    if (::fstat(fromFd, &st) != 0 || !S_ISREG(st.st_mode)) {
+        ::close(fromFd);
+        return false;
+    }
+
+    /* Replace the file rather than writing into it, in case it has other links. */
+    if (::unlink(to.c_str()) != 0 && errno != ENOENT) {
+        ::close(fromFd);
+        return false;
+    }
+
+    int toFd = ::open(to.c_str(), O_WRONLY | O_CREAT | O_EXCL | O_CLOEXEC, st.st_mode & 0777);
+    if (toFd < 0) {
+        ::close(fromFd);
+        return false;
+    }
+
+    bool cloned = (::ioctl(toFd, FICLONE, fromFd) == 0);
+    ::close(toFd);
+    ::close(fromFd);
+    if (cloned) {
+        return true;
+    }
+
+    /* Not supported by the filesystem, or across filesystems. */
+    ::unlink(to.c_str());
+    return this->copyFile(from, to);
+#else
+    return this->copyFile(from, to);
+#endif
+}
+
 bool DefaultFilesystem::
 removeFile(std::string const &path)
 {
@@ -904,12 +1296,97 @@ createDirectory(std::string const &path, bool recursive)
     return true;
 }
 
+#if !_WIN32
+/*
+ * Type of a directory entry. The directory usually records the type with
+ * the entry, so a system call per entry is only needed when it does not.
+ */
+static ext::optional<Filesystem::Type>
+DirectoryEntryType(int fd, struct dirent const *entry)
+{
+#if defined(DT_UNKNOWN)
+    switch (entry->d_type) {
+        case DT_REG:
+            return Filesystem::Type::File;
+        case DT_LNK:
+            return Filesystem::Type::SymbolicLink;
+        case DT_DIR:
+            return Filesystem::Type::Directory;
+        case DT_UNKNOWN:
+            break;
+        default:
+            /* Unsupported file type, e.g. character or block device. */
+            return ext::nullopt;
+    }
+#endif
+
+    struct stat st;
+    if (::fstatat(fd, entry->d_name, &st, AT_SYMLINK_NOFOLLOW) != 0) {
+        return ext::nullopt;
+    }
+
+    if (S_ISREG(st.st_mode)) {
+        return Filesystem::Type::File;
+    } else if (S_ISLNK(st.st_mode)) {
+        return Filesystem::Type::SymbolicLink;
+    } else if (S_ISDIR(st.st_mode)) {
+        return Filesystem::Type::Directory;
+    } else {
+        return ext::nullopt;
+    }
+}
+
+/*
+ * Walk the open directory `fd`, which is closed when done. Entries are
+ * reported before recursing into subdirectories, which are opened relative
+ * to their parent rather than by building and resolving a full path.
+ */
+static bool
+WalkDirectory(int fd, ext::optional<std::string> const &relative, bool recursive, std::function<void(std::string const &, ext::optional<Filesystem::Type>)> const &cb)
+{
+    DIR *dp = ::fdopendir(fd);
+    if (dp == nullptr) {
+        ::close(fd);
+        return false;
+    }
+
+    std::vector<std::string> subdirectories;
+    while (struct dirent *entry = ::readdir(dp)) {
+        char const *name = entry->d_name;
+        if (::strcmp(name, ".") == 0 || ::strcmp(name, "..") == 0) {
+            continue;
+        }
+
+        std::string path = (relative ? *relative + "/" + name : name);
+        ext::optional<Filesystem::Type> type = DirectoryEntryType(::dirfd(dp), entry);
+
+        cb(path, type);
+
+        if (recursive && type == Filesystem::Type::Directory) {
+            subdirectories.push_back(name);
+        }
+    }
+
+    for (std::string const &name : subdirectories) {
+        int child = ::openat(::dirfd(dp), name.c_str(), O_RDONLY | O_DIRECTORY | O_NOFOLLOW | O_CLOEXEC);
+        std::string path = (relative ? *relative + "/" + name : name);
+        if (child < 0 || !WalkDirectory(child, path, recursive, cb)) {
+            ::closedir(dp);
+            return false;
+        }
+    }
+
+    ::closedir(dp);
+    return true;
+}
+#endif
+
 bool DefaultFilesystem::
 readDirectory(std::string const &path, bool recursive, std::function<void(std::string const &)> const &cb) const
 {
+#if _WIN32
     std::function<bool(std::string const &, ext::optional<std::string> const &)> process =
         [this, &recursive, &cb, &process](std::string const &absolute, ext::optional<std::string> const &relative) -> bool {
-#if _WIN32
         WideString wide = StringToWideString(absolute);
         wide += static_cast<wchar_t>('\\');
         wide += static_cast<wchar_t>('*');
@@ -919,22 +1396,11 @@ readDirectory(std::string const &path, bool recursive, std::function<void(std::s
         if (handle == INVALID_HANDLE_VALUE) {
             return false;
         }
-#else
-        DIR *dp = ::opendir(absolute.c_str());
-        if (dp == nullptr) {
-            return false;
-        }
-#endif
 
         /* Report children. */
-#if _WIN32
         do {
             std::string name_ = WideStringToString(WideString(data.cFileName));
             char const *name = name_.c_str();
-#else
-        while (struct dirent *entry = ::readdir(dp)) {
-            char const *name = entry->d_name;
-#endif
             if (::strcmp(name, ".") == 0 || ::strcmp(name, "..") == 0) {
                 continue;
             }
@@ -943,33 +1409,22 @@ readDirectory(std::string const &path, bool recursive, std::function<void(std::s
 
             cb(path);
         }
-#if _WIN32
         while (FindNextFileW(handle, &data));
         if (GetLastError() != ERROR_NO_MORE_FILES) {
             return false;
         }
-#endif
 
         /* Process subdirectories. */
         if (recursive) {
-#if _WIN32
             FindClose(handle);
             handle = FindFirstFileW(wide.c_str(), &data);
             if (handle == INVALID_HANDLE_VALUE) {
                 return false;
             }
-#else
-            ::rewinddir(dp);
-#endif
 
-#if _WIN32
             do {
                 std::string name_ = WideStringToString(WideString(data.cFileName));
                 char const *name = name_.c_str();
-#else
-            while (struct dirent *entry = ::readdir(dp)) {
-                char const *name = entry->d_name;
-#endif
                 if (::strcmp(name, ".") == 0 || ::strcmp(name, "..") == 0) {
                     continue;
                 }
@@ -979,33 +1434,132 @@ readDirectory(std::string const &path, bool recursive, std::function<void(std::s
                 if (this->type(full) == Type::Directory) {
                     std::string path = (relative ? *relative + "/" + name : name);
                     if (!process(full, path)) {
-#if _WIN32
                         FindClose(handle);
-#else
-                        ::closedir(dp);
-#endif
                         return false;
                     }
                 }
             }
-
-#if _WIN32
             while (FindNextFileW(handle, &data));
             if (GetLastError() != ERROR_NO_MORE_FILES) {
                 return false;
             }
-#endif
         }
 
-#if _WIN32
         FindClose(handle);
-#else
-        ::closedir(dp);
-#endif
         return true;
     };
 
     return process(path, ext::nullopt);
+#else
+    int fd = ::open(path.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    if (fd < 0) {
+        return false;
+    }
+
+    return WalkDirectory(fd, ext::nullopt, recursive, [&cb](std::string const &name, ext::optional<Type> type) {
+        cb(name);
+    });
+#endif
+}
+
+bool DefaultFilesystem::
+walkDirectory(std::string const &path, bool recursive, std::function<void(std::string const &, Type)> const &cb) const
+{
+#if _WIN32
+    return Filesystem::walkDirectory(path, recursive, cb);
+#else
+    int fd = ::open(path.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    if (fd < 0) {
+        return false;
+    }
+
+    return WalkDirectory(fd, ext::nullopt, recursive, [&cb](std::string const &name, ext::optional<Type> type) {
+        if (type) {
+            cb(name, *type);
+        }
+    });
+#endif
+}
+
+bool DefaultFilesystem::
+walkDirectoryParallel(std::string const &path, size_t threads, std::function<void(std::string const &, Type)> const &cb) const
+{
+#if _WIN32
+    return this->walkDirectory(path, true, cb);
+#else
+    if (threads <= 1) {
+        return this->walkDirectory(path, true, cb);
+    }
+
+    int root = ::open(path.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    if (root < 0) {
+        return false;
+    }
+
+    /*
+     * Directories waiting to be read, relative to the root. Pending counts
+     * those waiting plus those being read, which may find more.
+     */
+    std::mutex mutex;
+    std::condition_variable condition;
+    std::vector<std::string> directories = { "" };
+    size_t pending = 1;
+    bool success = true;
+
+    auto worker = [&]() {
+        std::unique_lock<std::mutex> lock(mutex);
+
+        while (true) {
+            condition.wait(lock, [&]() { return !directories.empty() || pending == 0 || !success; });
+            if (pending == 0 || !success) {
+                break;
+            }
+
+            std::string relative = directories.back();
+            directories.pop_back();
+            lock.unlock();
+
+            /* Read the directory without holding the lock. */
+            std::vector<std::pair<std::string, Type>> entries;
+            int fd = ::openat(root, relative.empty() ? "." : relative.c_str(), O_RDONLY | O_DIRECTORY | O_NOFOLLOW | O_CLOEXEC);
+            bool read = (fd >= 0 && WalkDirectory(fd, relative.empty() ? ext::nullopt : ext::optional<std::string>(relative), false, [&entries](std::string const &name, ext::optional<Type> type) {
+                if (type) {
+                    entries.push_back({ name, *type });
+                }
+            }));
+
+            lock.lock();
+
+            /* Report entries one directory at a time, so callers need not synchronize. */
+            if (success && read) {
+                for (std::pair<std::string, Type> const &entry : entries) {
+                    cb(entry.first, entry.second);
+
+                    if (entry.second == Type::Directory) {
+                        directories.push_back(entry.first);
+                        pending++;
+                    }
+                }
+            }
+
+            success &= read;
+            pending--;
+            condition.notify_all();
+        }
+    };
+
+    std::vector<std::thread> workers;
+    for (size_t i = 1; i < threads; i++) {
+        workers.push_back(std::thread(worker));
+    }
+    worker();
+    for (std::thread &thread : workers) {
+        thread.join();
+    }
+
+    ::close(root);
+    return success;
+#endif
 }
 
 bool DefaultFilesystem::
@@ -1041,15 +1595,13 @@ removeDirectory(std::string const &path, bool recursive)
     if (recursive) {
         bool success = true;
 
-        success &= this->readDirectory(path, recursive, [this, &path, &success](std::string const &name) {
-            std::string full = path + "/" + name;
+        /* Directories are walked before their contents, so remove them after. */
+        std::vector<std::string> directories;
 
-            ext::optional<Type> type = this->type(full);
-            if (!type) {
-                return false;
-            }
+        success &= this->walkDirectory(path, recursive, [this, &path, &success, &directories](std::string const &name, Type type) {
+            std::string full = path + "/" + name;
 
-            switch (*type) {
+            switch (type) {
                 case Type::File:
                     if (!this->removeFile(full)) {
                         success = false;
@@ -1063,16 +1615,17 @@ removeDirectory(std::string const &path, bool recursive)
                     }
                     break;
                 case Type::Directory:
-                    if (!this->removeDirectory(full, false)) {
-                        success = false;
-                        return false;
-                    }
+                    directories.push_back(full);
                     break;
             }
 
             return true;
         });
 
+        for (auto it = directories.rbegin(); success && it != directories.rend(); ++it) {
+            success &= this->removeDirectory(*it, false);
+        }
+
         if (!success) {
             return false;
         }
@@ -60,3 +60,26 @@ Makefile(std::string const &value)
 
     return result;
 }
+
+std::string Escape::
+ResponseFile(std::string const &value)
+{
+    if (!value.empty() && value.find_first_of(" \t\n\r\f\v'\"\\") == std::string::npos) {
+        return value;
+    }
+
+    std::string result;
+    result.reserve(value.size() + 2);
+    result += '"';
+
+    for (char c : value) {
+        if (c == '"' || c == '\\') {
+            result += '\\';
+        }
+
+        result += c;
+    }
+
+    result += '"';
+    return result;
+}
@@ -0,0 +1,220 @@
+/**
+ Copyright (c) 2015-present, Facebook, Inc.
+ All rights reserved.
+
+ This source code is licensed under the BSD-style license found in the
+ LICENSE file in the root directory of this source tree. An additional grant
+ of patent rights can be found in the PATENTS file in the same directory.
+ */
+
+#include <libutil/FileHasher.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <sstream>
+#include <thread>
+
+using libutil::FileHasher;
+using libutil::Filesystem;
+using libutil::Hash;
+
+/*
+ * Longest timestamp resolution of common filesystems (FAT), in nanoseconds.
+ */
+static uint64_t const FileHasherRacyInterval = 2000000000ULL;
+
+static char const FileHasherHeader[] = "file-hashes 1";
+
+static uint64_t
+FileHasherNow()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+FileHasher::
+FileHasher()
+{
+}
+
+FileHasher::
+~FileHasher()
+{
+}
+
+ext::optional<Hash> FileHasher::
+Contents(Filesystem const *filesystem, std::string const &path)
+{
+    Hash::Stream stream;
+    if (!filesystem->readContents(path, [&stream](uint8_t const *data, size_t size) {
+        stream.update(data, size);
+    })) {
+        return ext::nullopt;
+    }
+
+    return stream.finish();
+}
+
+ext::optional<Hash> FileHasher::
+hash(Filesystem const *filesystem, std::string const &path)
+{
+    ext::optional<Filesystem::Identity> identity = filesystem->identity(path);
+    if (!identity) {
+        return Contents(filesystem, path);
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        auto it = _entries.find(path);
+        if (it != _entries.end() && it->second.identity == *identity && it->second.hashed >= identity->modified + FileHasherRacyInterval) {
+            return it->second.hash;
+        }
+    }
+
+    uint64_t hashed = FileHasherNow();
+    ext::optional<Hash> hash = Contents(filesystem, path);
+    if (!hash) {
+        return ext::nullopt;
+    }
+
+    /* The file could have changed while it was read. */
+    if (filesystem->identity(path) == identity) {
+        Entry entry;
+        entry.identity = *identity;
+        entry.hash = *hash;
+        entry.hashed = hashed;
+        entry.loaded = false;
+
+        std::lock_guard<std::mutex> lock(_mutex);
+        _entries[path] = entry;
+    }
+
+    return hash;
+}
+
+std::vector<ext::optional<Hash>> FileHasher::
+hash(Filesystem const *filesystem, std::vector<std::string> const &paths, size_t jobs)
+{
+    std::vector<ext::optional<Hash>> hashes = std::vector<ext::optional<Hash>>(paths.size());
+
+    if (jobs == 0) {
+        jobs = std::max<size_t>(std::thread::hardware_concurrency(), 1);
+    }
+    jobs = std::min(jobs, paths.size());
+
+    /* Threads take the next path as they finish, so large files don't hold up the rest. */
+    std::atomic<size_t> next = ATOMIC_VAR_INIT(0);
+    auto worker = [&]() {
+        for (size_t index = next++; index < paths.size(); index = next++) {
+            hashes[index] = hash(filesystem, paths[index]);
+        }
+    };
+
+    std::vector<std::thread> threads;
+    for (size_t i = 1; i < jobs; i++) {
+        threads.push_back(std::thread(worker));
+    }
+    worker();
+
+    for (std::thread &thread : threads) {
+        thread.join();
+    }
+
+    return hashes;
+}
+
+size_t FileHasher::
+size() const
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _entries.size();
+}
+
+bool FileHasher::
+load(Filesystem const *filesystem, std::string const &path)
+{
+    std::vector<uint8_t> contents;
+    if (!filesystem->read(&contents, path)) {
+        return false;
+    }
+
+    std::istringstream stream(std::string(contents.begin(), contents.end()));
+
+    std::string header;
+    if (!std::getline(stream, header) || header != FileHasherHeader) {
+        return false;
+    }
+
+    std::unordered_map<std::string, Entry> entries;
+    std::string line;
+    while (std::getline(stream, line)) {
+        std::istringstream fields(line);
+
+        std::string hex;
+        Entry entry;
+        if (!(fields >> hex >> entry.identity.device >> entry.identity.inode >> entry.identity.size >> entry.identity.modified >> entry.hashed)) {
+            return false;
+        }
+
+        ext::optional<Hash> hash = Hash::Parse(hex);
+        if (!hash) {
+            return false;
+        }
+        entry.hash = *hash;
+        entry.loaded = true;
+
+        /* The path is the rest of the line, after one space. */
+        if (fields.get() != ' ') {
+            return false;
+        }
+
+        std::string file;
+        std::getline(fields, file);
+        if (file.empty()) {
+            return false;
+        }
+
+        entries[file] = entry;
+    }
+
+    std::lock_guard<std::mutex> lock(_mutex);
+    for (auto const &entry : entries) {
+        _entries.insert(entry);
+    }
+    return true;
+}
+
+bool FileHasher::
+save(Filesystem *filesystem, std::string const &path, bool found) const
+{
+    std::string contents = std::string(FileHasherHeader) + "\n";
+
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        for (auto const &entry : _entries) {
+            if (entry.first.find('\n') != std::string::npos || (found && entry.second.loaded)) {
+                continue;
+            }
+
+            Filesystem::Identity const &identity = entry.second.identity;
+            contents += entry.second.hash.hex() + " " +
+                std::to_string(identity.device) + " " +
+                std::to_string(identity.inode) + " " +
+                std::to_string(identity.size) + " " +
+                std::to_string(identity.modified) + " " +
+                std::to_string(entry.second.hashed) + " " +
+                entry.first + "\n";
+        }
+    }
+
+    std::unique_ptr<Filesystem::Output> output = filesystem->openOutput(path);
+    if (output == nullptr) {
+        return false;
+    }
+
+    if (!output->write(reinterpret_cast<uint8_t const *>(contents.data()), contents.size())) {
+        return false;
+    }
+
+    return output->commit();
+}
@@ -10,12 +10,110 @@
 #include <libutil/Filesystem.h>
 #include <libutil/FSUtil.h>
 
+#include <algorithm>
 #include <unordered_set>
 #include <sstream>
 
 using libutil::Filesystem;
 using libutil::FSUtil;
 
+Filesystem::Output::
+~Output()
+{
+}
+
+/*
+ * Collects contents in memory, then writes them in one operation.
+ */
+class FilesystemBufferedOutput : public Filesystem::Output {
+private:
+    Filesystem          *_filesystem;
+    std::string          _path;
+    std::vector<uint8_t> _contents;
+
+public:
+    FilesystemBufferedOutput(Filesystem *filesystem, std::string const &path) :
+        _filesystem(filesystem),
+        _path      (path)
+    {
+    }
+
+public:
+    virtual bool write(uint8_t const *data, size_t size)
+    {
+        _contents.insert(_contents.end(), data, data + size);
+        return true;
+    }
+
+    virtual bool commit()
+    {
+        return _filesystem->write(_contents, _path);
+    }
+};
+
+/*
+ * Contents read into memory.
+ */
+class FilesystemBufferedMapping : public Filesystem::Mapping {
+public:
+    std::vector<uint8_t> contents;
+
+public:
+    virtual uint8_t const *data() const
+    { return contents.data(); }
+    virtual size_t size() const
+    { return contents.size(); }
+};
+
+Filesystem::Identity::
+Identity() :
+    device  (0),
+    inode   (0),
+    size    (0),
+    modified(0)
+{
+}
+
+ext::optional<Filesystem::Identity> Filesystem::
+identity(std::string const &path) const
+{
+    return ext::nullopt;
+}
+
+bool Filesystem::
+readContents(std::string const &path, std::function<void(uint8_t const *, size_t)> const &cb) const
+{
+    std::vector<uint8_t> contents;
+    if (!this->read(&contents, path)) {
+        return false;
+    }
+
+    cb(contents.data(), contents.size());
+    return true;
+}
+
+Filesystem::Mapping::
+~Mapping()
+{
+}
+
+std::unique_ptr<Filesystem::Mapping> Filesystem::
+map(std::string const &path) const
+{
+    std::unique_ptr<FilesystemBufferedMapping> mapping = std::unique_ptr<FilesystemBufferedMapping>(new FilesystemBufferedMapping());
+    if (!this->read(&mapping->contents, path)) {
+        return nullptr;
+    }
+
+    return std::move(mapping);
+}
+
+std::unique_ptr<Filesystem::Output> Filesystem::
+openOutput(std::string const &path)
+{
+    return std::unique_ptr<Filesystem::Output>(new FilesystemBufferedOutput(this, path));
+}
+
 bool Filesystem::
 copyFile(std::string const &from, std::string const &to)
 {
@@ -32,6 +130,60 @@ copyFile(std::string const &from, std::string const &to)
     return true;
 }
 
+bool Filesystem::
+cloneFile(std::string const &from, std::string const &to)
+{
+    return this->copyFile(from, to);
+}
+
+bool Filesystem::
+hasContents(std::vector<uint8_t> const &contents, std::string const &path) const
+{
+    ext::optional<Identity> identity = this->identity(path);
+    if (identity && identity->size != contents.size()) {
+        return false;
+    }
+
+    /* Compare as the file is read, rather than reading all of it first. */
+    size_t offset = 0;
+    bool equal = true;
+    if (!this->readContents(path, [&](uint8_t const *data, size_t size) {
+        if (equal) {
+            equal = (size <= contents.size() - offset && std::equal(data, data + size, contents.begin() + offset));
+            offset += size;
+        }
+    })) {
+        return false;
+    }
+
+    return equal && offset == contents.size();
+}
+
+bool Filesystem::
+writeIfChanged(std::vector<uint8_t> const &contents, std::string const &path, bool *changed)
+{
+    if (this->hasContents(contents, path)) {
+        if (changed != nullptr) {
+            *changed = false;
+        }
+        return true;
+    }
+
+    std::unique_ptr<Output> output = this->openOutput(path);
+    if (output == nullptr) {
+        return false;
+    }
+
+    if (!output->write(contents.data(), contents.size()) || !output->commit()) {
+        return false;
+    }
+
+    if (changed != nullptr) {
+        *changed = true;
+    }
+    return true;
+}
+
 bool Filesystem::
 copySymbolicLink(std::string const &from, std::string const &to)
 {
@@ -58,6 +210,17 @@ copySymbolicLink(std::string const &from, std::string const &to)
     return true;
 }
 
+bool Filesystem::
+walkDirectory(std::string const &path, bool recursive, std::function<void(std::string const &, Type)> const &cb) const
+{
+    return this->readDirectory(path, recursive, [this, &path, &cb](std::string const &name) {
+        ext::optional<Type> type = this->type(path + "/" + name);
+        if (type) {
+            cb(name, *type);
+        }
+    });
+}
+
 bool Filesystem::
 copyDirectory(std::string const &from, std::string const &to, bool recursive)
 {
@@ -82,16 +245,11 @@ copyDirectory(std::string const &from, std::string const &to, bool recursive)
     if (recursive) {
         bool success = true;
 
-        success &= this->readDirectory(from, recursive, [this, &from, &to, &success](std::string const &path) {
+        success &= this->walkDirectory(from, recursive, [this, &from, &to, &success](std::string const &path, Type type) {
             std::string fromPath = from + "/" + path;
             std::string toPath = to + "/" + path;
 
-            ext::optional<Type> type = this->type(fromPath);
-            if (!type) {
-                return false;
-            }
-
-            switch (*type) {
+            switch (type) {
                 case Type::File:
                     if (!this->copyFile(fromPath, toPath)) {
                         success = false;
@@ -0,0 +1,344 @@
+/**
+ Copyright (c) 2015-present, Facebook, Inc.
+ All rights reserved.
+
+ This source code is licensed under the BSD-style license found in the
+ LICENSE file in the root directory of this source tree. An additional grant
+ of patent rights can be found in the PATENTS file in the same directory.
+ */
+
+#include <libutil/Hash.h>
+
+#include <algorithm>
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define HASH_SSE2 1
+#include <emmintrin.h>
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#define HASH_NEON 1
+#include <arm_neon.h>
+#endif
+
+using libutil::Hash;
+
+/*
+ * The hash is structured like XXH3: each 64-byte stripe is combined with
+ * a key into eight 64-bit lanes with a 32x32-bit multiply, which maps
+ * directly to SIMD instructions. After every 16 stripes (a block), the
+ * lanes are scrambled so that later input can't cancel out earlier input.
+ * The lanes are folded into the result with full 64x64-bit multiplies.
+ *
+ * All values are read as little endian.
+ */
+
+static size_t const HashStripeSize = 64;
+static size_t const HashBlockStripes = 16;
+static size_t const HashBlockSize = HashStripeSize * HashBlockStripes;
+
+static uint64_t const HashPrime32_1 = 0x9E3779B1ULL;
+static uint64_t const HashPrime32_2 = 0x85EBCA77ULL;
+static uint64_t const HashPrime32_3 = 0xC2B2AE3DULL;
+static uint64_t const HashPrime64_1 = 0x9E3779B185EBCA87ULL;
+static uint64_t const HashPrime64_2 = 0xC2B2AE3D27D4EB4FULL;
+static uint64_t const HashPrime64_3 = 0x165667B19E3779F9ULL;
+static uint64_t const HashPrime64_4 = 0x85EBCA77C2B2AE63ULL;
+static uint64_t const HashPrime64_5 = 0x27D4EB2F165667C5ULL;
+
+/*
+ * Arbitrary constants, from splitmix64. Stripes use words 0-23 (offset by
+ * the stripe's position in its block), scrambling uses words 24-31.
+ */
+static uint64_t const HashSecret[32] = {
+    0x2CB0F69F4ABEA221ULL, 0x9417034723148989ULL, 0xDD555950609DFE03ULL, 0xDBAFB150DEB12800ULL,
+    0x7E789B2E6C442CB6ULL, 0xF41E5636C7E4F8C4ULL, 0x0959D150F8FBA7E4ULL, 0xA97316F13CDB9EEAULL,
+    0x74CD8258F9520068ULL, 0x55C74A62E116868BULL, 0xD2F4C799A2023CBDULL, 0xDF98CB79A37B51B9ULL,
+    0x396F5885524F3905ULL, 0xAF1D56386CA3B276ULL, 0xA9FFBE6B5104E85AULL, 0x6BD0C51B9FD533B3ULL,
+    0x980CE91C50AB4B56ULL, 0x28AC395780FE62C5ULL, 0x768912E3A6BCEDC7ULL, 0x50B3E8C9332C7C88ULL,
+    0xCE3BBFE520BD47DAULL, 0xCBA6C8E8E0BB7C4FULL, 0xBF194DB8434A346DULL, 0x7D8F2A7B60416D7FULL,
+    0x0849D1F6E0E10A5EULL, 0x7654B590D064E22FULL, 0x16D1DA9507DF3AF2ULL, 0xF63AEF1089EA30E4ULL,
+    0x9ADE6673CC6C522BULL, 0x4C75BC274E37087CULL, 0xD35E12B49F51F27BULL, 0x22DDF2FFCEE481EAULL,
+};
+
+static inline uint64_t
+HashRead64(uint8_t const *data)
+{
+    uint64_t value;
+    memcpy(&value, data, sizeof(value));
+    return value;
+}
+
+/*
+ * Combine consecutive stripes into the lanes. Each lane adds the product
+ * of the halves of its keyed input, and the unkeyed input of its neighbor.
+ */
+static void
+HashAccumulate(uint64_t *accumulators, uint8_t const *data, size_t first, size_t count)
+{
+#if HASH_SSE2
+    __m128i acc[4];
+    for (size_t i = 0; i < 4; i++) {
+        acc[i] = _mm_loadu_si128(reinterpret_cast<__m128i const *>(accumulators) + i);
+    }
+
+    for (size_t s = 0; s < count; s++) {
+        uint8_t const *stripe = data + s * HashStripeSize;
+        uint64_t const *secret = HashSecret + first + s;
+        for (size_t i = 0; i < 4; i++) {
+            __m128i input = _mm_loadu_si128(reinterpret_cast<__m128i const *>(stripe) + i);
+            __m128i key = _mm_loadu_si128(reinterpret_cast<__m128i const *>(secret) + i);
+            __m128i keyed = _mm_xor_si128(input, key);
+            __m128i product = _mm_mul_epu32(keyed, _mm_shuffle_epi32(keyed, _MM_SHUFFLE(0, 3, 0, 1)));
+            __m128i swapped = _mm_shuffle_epi32(input, _MM_SHUFFLE(1, 0, 3, 2));
+            acc[i] = _mm_add_epi64(acc[i], _mm_add_epi64(product, swapped));
+        }
+    }
+
+    for (size_t i = 0; i < 4; i++) {
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(accumulators) + i, acc[i]);
+    }
+#elif HASH_NEON
+    uint64x2_t acc[4];
+    for (size_t i = 0; i < 4; i++) {
+        acc[i] = vld1q_u64(accumulators + i * 2);
+    }
+
+    for (size_t s = 0; s < count; s++) {
+        uint8_t const *stripe = data + s * HashStripeSize;
+        uint64_t const *secret = HashSecret + first + s;
+        for (size_t i = 0; i < 4; i++) {
+            uint64x2_t input = vreinterpretq_u64_u8(vld1q_u8(stripe + i * 16));
+            uint64x2_t keyed = veorq_u64(input, vld1q_u64(secret + i * 2));
+            acc[i] = vaddq_u64(acc[i], vextq_u64(input, input, 1));
+            acc[i] = vmlal_u32(acc[i], vmovn_u64(keyed), vshrn_n_u64(keyed, 32));
+        }
+    }
+
+    for (size_t i = 0; i < 4; i++) {
+        vst1q_u64(accumulators + i * 2, acc[i]);
+    }
+#else
+    for (size_t s = 0; s < count; s++) {
+        uint8_t const *stripe = data + s * HashStripeSize;
+        uint64_t const *secret = HashSecret + first + s;
+        for (size_t i = 0; i < 8; i++) {
+            uint64_t input = HashRead64(stripe + i * 8);
+            uint64_t keyed = input ^ secret[i];
+            accumulators[i ^ 1] += input;
+            accumulators[i] += (keyed & 0xFFFFFFFFULL) * (keyed >> 32);
+        }
+    }
+#endif
+}
+
+static void
+HashScramble(uint64_t *accumulators)
+{
+    for (size_t i = 0; i < 8; i++) {
+        uint64_t acc = accumulators[i];
+        acc ^= acc >> 47;
+        acc ^= HashSecret[24 + i];
+        acc *= HashPrime32_1;
+        accumulators[i] = acc;
+    }
+}
+
+static void
+HashInitialize(uint64_t *accumulators)
+{
+    accumulators[0] = HashPrime32_3;
+    accumulators[1] = HashPrime64_1;
+    accumulators[2] = HashPrime64_2;
+    accumulators[3] = HashPrime64_3;
+    accumulators[4] = HashPrime64_4;
+    accumulators[5] = HashPrime32_2;
+    accumulators[6] = HashPrime64_5;
+    accumulators[7] = HashPrime32_1;
+}
+
+/*
+ * Multiply to 128 bits, then fold the halves together.
+ */
+static inline uint64_t
+HashMultiplyFold(uint64_t lhs, uint64_t rhs)
+{
+#if defined(__SIZEOF_INT128__)
+    unsigned __int128 product = static_cast<unsigned __int128>(lhs) * rhs;
+    return static_cast<uint64_t>(product) ^ static_cast<uint64_t>(product >> 64);
+#else
+    uint64_t lo_lo = (lhs & 0xFFFFFFFFULL) * (rhs & 0xFFFFFFFFULL);
+    uint64_t hi_lo = (lhs >> 32) * (rhs & 0xFFFFFFFFULL);
+    uint64_t lo_hi = (lhs & 0xFFFFFFFFULL) * (rhs >> 32);
+    uint64_t hi_hi = (lhs >> 32) * (rhs >> 32);
+    uint64_t cross = (lo_lo >> 32) + (hi_lo & 0xFFFFFFFFULL) + lo_hi;
+    uint64_t upper = (hi_lo >> 32) + (cross >> 32) + hi_hi;
+    uint64_t lower = (cross << 32) | (lo_lo & 0xFFFFFFFFULL);
+    return lower ^ upper;
+#endif
+}
+
+static inline uint64_t
+HashAvalanche(uint64_t hash)
+{
+    hash ^= hash >> 37;
+    hash *= 0x165667919E3779F9ULL;
+    hash ^= hash >> 32;
+    return hash;
+}
+
+/*
+ * Add the remaining input, less than a block, and produce the result.
+ * The last partial stripe is padded with zeros; the total length is mixed
+ * in so that the padding can't be confused with input.
+ */
+static Hash
+HashFinish(uint64_t *accumulators, uint8_t const *data, size_t size, uint64_t length)
+{
+    size_t stripes = size / HashStripeSize;
+    HashAccumulate(accumulators, data, 0, stripes);
+
+    size_t remaining = size - stripes * HashStripeSize;
+    if (remaining > 0) {
+        uint8_t stripe[HashStripeSize] = { 0 };
+        memcpy(stripe, data + stripes * HashStripeSize, remaining);
+        HashAccumulate(accumulators, stripe, stripes, 1);
+    }
+
+    uint64_t low = length * HashPrime64_1;
+    uint64_t high = ~length * HashPrime64_2;
+    for (size_t i = 0; i < 4; i++) {
+        low += HashMultiplyFold(accumulators[i * 2] ^ HashSecret[i * 2], accumulators[i * 2 + 1] ^ HashSecret[i * 2 + 1]);
+        high += HashMultiplyFold(accumulators[i * 2] ^ HashSecret[i * 2 + 11], accumulators[i * 2 + 1] ^ HashSecret[i * 2 + 12]);
+    }
+
+    return Hash(HashAvalanche(low), HashAvalanche(high));
+}
+
+Hash::Stream::
+Stream() :
+    _buffered(0),
+    _length  (0)
+{
+    HashInitialize(_accumulators);
+}
+
+void Hash::Stream::
+block(uint8_t const *data)
+{
+    HashAccumulate(_accumulators, data, 0, HashBlockStripes);
+    HashScramble(_accumulators);
+}
+
+void Hash::Stream::
+update(void const *data, size_t size)
+{
+    uint8_t const *bytes = static_cast<uint8_t const *>(data);
+    _length += size;
+
+    /* Complete a partial block first. */
+    if (_buffered > 0) {
+        size_t copy = std::min(size, HashBlockSize - _buffered);
+        memcpy(_buffer + _buffered, bytes, copy);
+        _buffered += copy;
+        bytes += copy;
+        size -= copy;
+
+        if (_buffered < HashBlockSize) {
+            return;
+        }
+
+        block(_buffer);
+        _buffered = 0;
+    }
+
+    /* Whole blocks are hashed in place, without copying. */
+    while (size >= HashBlockSize) {
+        block(bytes);
+        bytes += HashBlockSize;
+        size -= HashBlockSize;
+    }
+
+    memcpy(_buffer, bytes, size);
+    _buffered = size;
+}
+
+Hash Hash::Stream::
+finish() const
+{
+    uint64_t accumulators[8];
+    memcpy(accumulators, _accumulators, sizeof(accumulators));
+    return HashFinish(accumulators, _buffer, _buffered, _length);
+}
+
+Hash::
+Hash() :
+    Hash(Stream().finish())
+{
+}
+
+Hash::
+Hash(uint64_t low, uint64_t high) :
+    _low (low),
+    _high(high)
+{
+}
+
+std::string Hash::
+hex() const
+{
+    static char const digits[] = "0123456789abcdef";
+
+    std::string result = std::string(32, '0');
+    for (size_t i = 0; i < 16; i++) {
+        result[15 - i] = digits[(_high >> (i * 4)) & 0xF];
+        result[31 - i] = digits[(_low >> (i * 4)) & 0xF];
+    }
+    return result;
+}
+
+ext::optional<Hash> Hash::
+Parse(std::string const &hex)
+{
+    if (hex.size() != 32) {
+        return ext::nullopt;
+    }
+
+    uint64_t words[2] = { 0, 0 };
+    for (size_t i = 0; i < 32; i++) {
+        char c = hex[i];
+
+        uint64_t digit;
+        if (c >= '0' && c <= '9') {
+            digit = c - '0';
+        } else if (c >= 'a' && c <= 'f') {
+            digit = c - 'a' + 10;
+        } else if (c >= 'A' && c <= 'F') {
+            digit = c - 'A' + 10;
+        } else {
+            return ext::nullopt;
+        }
+
+        words[i / 16] = (words[i / 16] << 4) | digit;
+    }
+
+    return Hash(words[1], words[0]);
+}
+
+Hash Hash::
+Data(void const *data, size_t size)
+{
+    uint8_t const *bytes = static_cast<uint8_t const *>(data);
+    uint64_t length = size;
+
+    uint64_t accumulators[8];
+    HashInitialize(accumulators);
+
+    while (size >= HashBlockSize) {
+        HashAccumulate(accumulators, bytes, 0, HashBlockStripes);
+        HashScramble(accumulators);
+        bytes += HashBlockSize;
+        size -= HashBlockSize;
+    }
+
+    return HashFinish(accumulators, bytes, size, length);
+}
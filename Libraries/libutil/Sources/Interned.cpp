@@ -0,0 +1,491 @@
+/**
+ Copyright (c) 2015-present, Facebook, Inc.
+ All rights reserved.
+
+ This source code is licensed under the BSD-style license found in the
+ LICENSE file in the root directory of this source tree. An additional grant
+ of patent rights can be found in the PATENTS file in the same directory.
+ */
+
+#include <libutil/Interned.h>
+#include <libutil/Relative.h>
+#include <libutil/Unix.h>
+#include <libutil/Windows.h>
+
+#include <atomic>
+#include <deque>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+#if _WIN32
+#include <cstring>
+#else
+#include <strings.h>
+#endif
+
+namespace Path = libutil::Path;
+
+/*
+ * Split paths the same way `Relative` does, with the platform's traits.
+ */
+#if _WIN32
+typedef Path::Windows InternedTraits;
+#else
+typedef Path::Unix InternedTraits;
+#endif
+
+/*
+ * One path component, shared between every path that contains it. The
+ * base name without its extension and the extension are split out once,
+ * so accessing them does not allocate.
+ */
+struct InternedComponent {
+    /*
+     * Owned by the table, which never removes components.
+     */
+    std::string const *name;
+
+    /*
+     * Both empty if the name has no extension.
+     */
+    std::string        stem;
+    std::string        extension;
+    bool               hasExtension;
+};
+
+struct Path::Interned::Entry {
+    /*
+     * The path before the last separator, or null for the empty path.
+     */
+    Entry const             *prefix;
+
+    /*
+     * The separator between the prefix and the component, or zero for a
+     * component directly after the prefix, like the first component of a
+     * relative path or the one after the root of an absolute path.
+     */
+    char                     separator;
+
+    /*
+     * If the component is the root of an absolute path, like "/". Roots
+     * have no base name.
+     */
+    bool                     root;
+
+    InternedComponent const *component;
+
+    /*
+     * Found when first used. Racing threads find the same value, and
+     * only the first to finish stores its result.
+     */
+    mutable std::atomic<Entry const *> normalized;
+
+    Entry(Entry const *prefix, char separator, bool root, InternedComponent const *component) :
+        prefix    (prefix),
+        separator (separator),
+        root      (root),
+        component (component),
+        normalized(nullptr)
+    {
+    }
+};
+
+/*
+ * The key for a path in the table: the path before its last separator, the
+ * separator, and the last component. Components are interned first, so they
+ * compare by identity.
+ */
+struct InternedKey {
+    Path::Interned::Entry const *prefix;
+    char                         separator;
+    InternedComponent const     *component;
+
+    bool operator==(InternedKey const &rhs) const
+    { return prefix == rhs.prefix && separator == rhs.separator && component == rhs.component; }
+};
+
+struct InternedKeyHash {
+    size_t operator()(InternedKey const &key) const
+    {
+        size_t hash = std::hash<Path::Interned::Entry const *>()(key.prefix);
+        hash ^= std::hash<InternedComponent const *>()(key.component) + 0x9e3779b9 + (hash << 6) + (hash >> 2);
+        hash ^= std::hash<char>()(key.separator) + 0x9e3779b9 + (hash << 6) + (hash >> 2);
+        return hash;
+    }
+};
+
+/*
+ * Every interned path and component. The table is split into shards, each
+ * with its own lock, so threads interning unrelated paths rarely wait for
+ * each other. Entries are in deques so pointers to them stay valid as more
+ * are added.
+ */
+class InternedTable {
+private:
+    static size_t const Shards = 16;
+
+    struct ComponentShard {
+        std::mutex                                           mutex;
+        std::unordered_map<std::string, InternedComponent *> components;
+        std::deque<InternedComponent>                        storage;
+    };
+
+    struct EntryShard {
+        std::mutex                                                                  mutex;
+        std::unordered_map<InternedKey, Path::Interned::Entry *, InternedKeyHash> entries;
+        std::deque<Path::Interned::Entry>                                           storage;
+    };
+
+private:
+    ComponentShard               _components[Shards];
+    EntryShard                   _entries[Shards];
+    Path::Interned::Entry const *_empty;
+
+private:
+    InternedTable()
+    {
+        static std::string const empty;
+        _empty = entry(nullptr, '\0', false, component(empty));
+    }
+
+public:
+    static InternedTable *
+    Shared()
+    {
+        /* Intentionally leaked, so interned paths are valid during exit. */
+        static InternedTable *table = new InternedTable();
+        return table;
+    }
+
+public:
+    Path::Interned::Entry const *
+    empty() const
+    {
+        return _empty;
+    }
+
+    InternedComponent const *
+    component(std::string const &name)
+    {
+        ComponentShard *shard = &_components[std::hash<std::string>()(name) % Shards];
+        std::lock_guard<std::mutex> lock(shard->mutex);
+
+        auto it = shard->components.find(name);
+        if (it != shard->components.end()) {
+            return it->second;
+        }
+
+        shard->storage.push_back(InternedComponent());
+        InternedComponent *component = &shard->storage.back();
+        it = shard->components.insert({ name, component }).first;
+        component->name = &it->first;
+
+        /* As `Relative::base(false)` and `Relative::extension()`. */
+        size_t dot = name.rfind('.');
+        component->hasExtension = (dot != std::string::npos);
+        if (component->hasExtension) {
+            component->stem = name.substr(0, dot);
+            component->extension = name.substr(dot + 1);
+        }
+
+        return component;
+    }
+
+    Path::Interned::Entry const *
+    entry(Path::Interned::Entry const *prefix, char separator, bool root, InternedComponent const *component)
+    {
+        InternedKey key = { prefix, separator, component };
+        EntryShard *shard = &_entries[InternedKeyHash()(key) % Shards];
+        std::lock_guard<std::mutex> lock(shard->mutex);
+
+        auto it = shard->entries.find(key);
+        if (it != shard->entries.end()) {
+            return it->second;
+        }
+
+        shard->storage.emplace_back(prefix, separator, root, component);
+        Path::Interned::Entry *entry = &shard->storage.back();
+        shard->entries.insert({ key, entry });
+        return entry;
+    }
+
+    size_t
+    count()
+    {
+        size_t count = 0;
+        for (EntryShard &shard : _entries) {
+            std::lock_guard<std::mutex> lock(shard.mutex);
+            count += shard.entries.size();
+        }
+        return count;
+    }
+};
+
+Path::Interned::Entry const *Path::Interned::
+Intern(std::string const &raw)
+{
+    InternedTable *table = InternedTable::Shared();
+    Entry const *entry = table->empty();
+
+    /* The root of an absolute path is a single component. */
+    size_t start = 0;
+    InternedTraits::IsAbsolute(raw, &start);
+    if (start > 0) {
+        entry = table->entry(entry, '\0', true, table->component(raw.substr(0, start)));
+    }
+
+    /* Reused between components to avoid allocating for each. */
+    std::string name;
+
+    char separator = '\0';
+    size_t begin = start;
+    for (size_t i = start; i <= raw.size(); i++) {
+        if (i < raw.size() && !InternedTraits::IsSeparator(raw[i])) {
+            continue;
+        }
+
+        /* Nothing before a separator directly after the root. */
+        if (i > begin || separator != '\0') {
+            name.assign(raw, begin, i - begin);
+            entry = table->entry(entry, separator, false, table->component(name));
+        }
+
+        if (i < raw.size()) {
+            separator = raw[i];
+            begin = i + 1;
+        }
+    }
+
+    return entry;
+}
+
+Path::Interned::Entry const *Path::Interned::
+Child(Entry const *entry, std::string const &name)
+{
+    /*
+     * Without separators in the name, the child is one more component
+     * after this path; or, if this path ends with a separator, replaces
+     * the empty component after it. Anything else is split again.
+     */
+    if (entry->prefix == nullptr || entry->root || name.empty()) {
+        return nullptr;
+    }
+    for (char c : name) {
+        if (InternedTraits::IsSeparator(c)) {
+            return nullptr;
+        }
+    }
+
+    InternedTable *table = InternedTable::Shared();
+    if (entry->component->name->empty() && entry->separator != '\0') {
+        return table->entry(entry->prefix, entry->separator, false, table->component(name));
+    } else {
+        return table->entry(entry, InternedTraits::Separator, false, table->component(name));
+    }
+}
+
+/*
+ * Stores a value found for an entry, unless another thread already has.
+ */
+template<typename T>
+static T const *
+InternedStore(std::atomic<T const *> *field, T const *value)
+{
+    T const *expected = nullptr;
+    if (field->compare_exchange_strong(expected, value, std::memory_order_acq_rel)) {
+        return value;
+    } else {
+        return expected;
+    }
+}
+
+Path::Interned::
+Interned() :
+    _entry(InternedTable::Shared()->empty())
+{
+}
+
+Path::Interned::
+Interned(Entry const *entry) :
+    _entry(entry)
+{
+}
+
+Path::Interned::
+Interned(std::string const &raw) :
+    _entry(Intern(raw))
+{
+}
+
+Path::Interned::
+Interned(char const *raw) :
+    _entry(Intern(std::string(raw)))
+{
+}
+
+std::string Path::Interned::
+raw() const
+{
+    /* Components from the last, to size the string before building it. */
+    std::vector<Entry const *> entries;
+    size_t size = 0;
+    for (Entry const *entry = _entry; entry->prefix != nullptr; entry = entry->prefix) {
+        entries.push_back(entry);
+        size += (entry->separator != '\0' ? 1 : 0) + entry->component->name->size();
+    }
+
+    std::string raw;
+    raw.reserve(size);
+    for (auto it = entries.rbegin(); it != entries.rend(); ++it) {
+        if ((*it)->separator != '\0') {
+            raw.push_back((*it)->separator);
+        }
+        raw.append(*(*it)->component->name);
+    }
+    return raw;
+}
+
+bool Path::Interned::
+empty() const
+{
+    return _entry->prefix == nullptr;
+}
+
+/*
+ * The normalized form of a path, from the normalized form of the path before
+ * its last separator. Follows the same rules as `Relative::normalized()`.
+ */
+Path::Interned::Entry const *Path::Interned::
+Normalized(Entry const *entry)
+{
+    Entry const *normalized = entry->normalized.load(std::memory_order_acquire);
+    if (normalized != nullptr) {
+        return normalized;
+    }
+
+    if (entry->prefix == nullptr) {
+        normalized = entry;
+    } else if (entry->root) {
+        /* Roots only have their separators replaced. */
+        normalized = Intern(Path::Relative(*entry->component->name).normalized());
+    } else {
+        InternedTable *table = InternedTable::Shared();
+        Entry const *prefix = Normalized(entry->prefix);
+        std::string const &name = *entry->component->name;
+
+        if (name.empty() || name == ".") {
+            /* Repeated and trailing separators, and the current directory. */
+            normalized = prefix;
+        } else if (name == "..") {
+            if (prefix->prefix == nullptr) {
+                /* Nothing to go up from, so kept in a relative path. */
+                normalized = table->entry(prefix, '\0', false, table->component(name));
+            } else if (prefix->root) {
+                /* Nothing above the root. */
+                normalized = prefix;
+            } else {
+                /* The normalized prefix only has names and leading parents. */
+                normalized = prefix->prefix;
+            }
+        } else if (prefix->prefix == nullptr || prefix->root) {
+            normalized = table->entry(prefix, '\0', false, entry->component);
+        } else {
+            normalized = table->entry(prefix, InternedTraits::Separator, false, entry->component);
+        }
+    }
+
+    return InternedStore(&entry->normalized, normalized);
+}
+
+Path::Interned Path::Interned::
+normalized() const
+{
+    return Interned(Normalized(_entry));
+}
+
+Path::Interned Path::Interned::
+parent() const
+{
+    /* A trailing separator is skipped, as if the path did not have it. */
+    Entry const *entry = _entry;
+    if (entry->prefix != nullptr && entry->separator != '\0' && entry->component->name->empty()) {
+        entry = entry->prefix;
+    }
+
+    /* The parent of the root or the empty path is itself. */
+    if (entry->prefix == nullptr || entry->root) {
+        return Interned(entry);
+    }
+
+#if !_WIN32
+    /* `Relative::parent()` also splits at backslashes, which `Unix` does not. */
+    if (entry->component->name->find('\\') != std::string::npos) {
+        return Interned(Path::Relative(raw()).parent().raw());
+    }
+#endif
+
+    return Interned(entry->prefix);
+}
+
+Path::Interned Path::Interned::
+child(std::string const &name) const
+{
+    if (Entry const *child = Child(_entry, name)) {
+        return Interned(child);
+    }
+
+    return Interned(Path::Relative(raw()).child(name).raw());
+}
+
+std::string const &Path::Interned::
+base(bool extension) const
+{
+    static std::string const empty;
+    if (_entry->root) {
+        return empty;
+    }
+
+    InternedComponent const *component = _entry->component;
+    if (!extension && component->hasExtension) {
+        return component->stem;
+    } else {
+        return *component->name;
+    }
+}
+
+std::string const &Path::Interned::
+extension() const
+{
+    static std::string const empty;
+    if (_entry->root) {
+        return empty;
+    }
+
+    return _entry->component->extension;
+}
+
+bool Path::Interned::
+extension(std::string const &extension, bool insensitive) const
+{
+    std::string const &existing = this->extension();
+    if (existing.size() != extension.size()) {
+        return false;
+    }
+
+    if (insensitive) {
+#if _WIN32
+        return ::_strnicmp(existing.c_str(), extension.c_str(), existing.size()) == 0;
+#else
+        return ::strncasecmp(existing.c_str(), extension.c_str(), existing.size()) == 0;
+#endif
+    } else {
+        return existing == extension;
+    }
+}
+
+size_t Path::Interned::
+Count()
+{
+    return InternedTable::Shared()->count();
+}
@@ -443,6 +443,34 @@ readDirectory(std::string const &path, bool recursive, std::function<void(std::s
     });
 }
 
+bool MemoryFilesystem::
+walkDirectory(std::string const &path, bool recursive, std::function<void(std::string const &, Type)> const &cb) const
+{
+    std::function<void(ext::optional<std::string> const &, MemoryFilesystem::Entry const *)> process =
+        [&recursive, &cb, &process](ext::optional<std::string> const &subpath, MemoryFilesystem::Entry const *entry) {
+        /* Report children. */
+        for (MemoryFilesystem::Entry const &child : entry->children()) {
+            std::string path = (subpath ? *subpath + "/" + child.name() : child.name());
+
+            /* Process subdirectories first. */
+            if (recursive) {
+                process(path, &child);
+            }
+
+            cb(path, child.type());
+        }
+    };
+
+    return WalkPath<MemoryFilesystem::Entry const>(this, path, false, [&process](MemoryFilesystem::Entry const *parent, std::string const &name, MemoryFilesystem::Entry const *entry) -> MemoryFilesystem::Entry const * {
+        if (entry != nullptr && entry->type() == Type::Directory) {
+            process(ext::nullopt, entry);
+            return entry;
+        } else {
+            return nullptr;
+        }
+    });
+}
+
 bool MemoryFilesystem::
 removeDirectory(std::string const &path, bool recursive)
 {
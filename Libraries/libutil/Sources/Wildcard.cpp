@@ -10,36 +10,185 @@
 #include <libutil/Wildcard.h>
 
 #include <algorithm>
+#include <cstring>
 
 using libutil::Wildcard;
 
-bool Wildcard::
-Match(std::string const &pattern, std::string const &string)
+/*
+ * If the pattern has a character class starting at `position`, the
+ * position of its closing bracket. Otherwise, the `[` is a literal.
+ */
+static size_t
+WildcardClassEnd(char const *pattern, size_t size, size_t position)
 {
-    std::string::const_iterator sit = string.begin();
-    for (std::string::const_iterator fit = pattern.begin(); fit != pattern.end(); ++fit) {
-        std::string::const_iterator fend;
-        if (*fit == '*') {
-            if (++fit == pattern.end() || sit == string.end()) {
-                return true;
-            }
+    if (pattern[position] != '[') {
+        return std::string::npos;
+    }
 
-            while (*sit++ != *fit) {
-                if (sit == string.end()) {
-                    return false;
-                }
+    void const *end = ::memchr(pattern + position + 1, ']', size - position - 1);
+    return (end != nullptr ? static_cast<char const *>(end) - pattern : std::string::npos);
+}
+
+Wildcard::
+Wildcard(std::string const &pattern) :
+    _pattern(pattern),
+    _length (0)
+{
+    Segment segment = { 0, 0, true };
+
+    for (size_t i = 0; i < pattern.size(); i++) {
+        if (pattern[i] == '*') {
+            _segments.push_back(segment);
+            segment = { _text.size(), 0, true };
+            continue;
+        }
+
+        size_t end = WildcardClassEnd(pattern.data(), pattern.size(), i);
+        if (end != std::string::npos) {
+            std::bitset<256> characters;
+            for (size_t j = i + 1; j < end; j++) {
+                characters.set(static_cast<uint8_t>(pattern[j]));
             }
-        } else if (*fit == '[' && (fend = std::find(fit, pattern.end(), ']')) != pattern.end()) {
-            std::string allowed = std::string(std::next(fit), fend);
-            if (allowed.find(*sit++) == std::string::npos) {
+
+            _text.push_back('\0');
+            _positionClasses.push_back(static_cast<int32_t>(_classes.size()));
+            _classes.push_back(characters);
+            segment.literal = false;
+            i = end;
+        } else {
+            _text.push_back(pattern[i]);
+            _positionClasses.push_back(-1);
+        }
+
+        segment.length++;
+        _length++;
+    }
+
+    _segments.push_back(segment);
+}
+
+bool Wildcard::
+matchSegment(Segment const &segment, char const *data) const
+{
+    if (segment.literal) {
+        return ::memcmp(_text.data() + segment.offset, data, segment.length) == 0;
+    }
+
+    for (size_t i = 0; i < segment.length; i++) {
+        int32_t index = _positionClasses[segment.offset + i];
+        if (index < 0) {
+            if (_text[segment.offset + i] != data[i]) {
                 return false;
             }
-            fit = fend;
-        } else if (*fit != *sit++) {
+        } else if (!_classes[index].test(static_cast<uint8_t>(data[i]))) {
             return false;
         }
     }
 
-    return (sit == string.end());
+    return true;
+}
+
+size_t Wildcard::
+findSegment(Segment const &segment, char const *data, size_t begin, size_t end) const
+{
+    if (segment.literal) {
+        char const *text = _text.data() + segment.offset;
+        char const *found = std::search(data + begin, data + end, text, text + segment.length);
+        return (found != data + end || segment.length == 0 ? found - data : std::string::npos);
+    }
+
+    for (size_t position = begin; position + segment.length <= end; position++) {
+        if (matchSegment(segment, data + position)) {
+            return position;
+        }
+    }
+
+    return std::string::npos;
 }
 
+bool Wildcard::
+match(char const *data, size_t size) const
+{
+    if (size < _length) {
+        return false;
+    }
+
+    Segment const &first = _segments.front();
+    if (_segments.size() == 1) {
+        return size == first.length && matchSegment(first, data);
+    }
+
+    /*
+     * The first segment is anchored at the start and the last at the end.
+     * As each segment matches a fixed length, matching the ones between
+     * at their earliest position leaves the most room for those after.
+     */
+    Segment const &last = _segments.back();
+    if (!matchSegment(first, data) || !matchSegment(last, data + size - last.length)) {
+        return false;
+    }
+
+    size_t position = first.length;
+    size_t end = size - last.length;
+    for (size_t i = 1; i + 1 < _segments.size(); i++) {
+        Segment const &segment = _segments[i];
+
+        size_t found = findSegment(segment, data, position, end);
+        if (found == std::string::npos) {
+            return false;
+        }
+
+        position = found + segment.length;
+    }
+
+    return true;
+}
+
+bool Wildcard::
+Match(std::string const &pattern, std::string const &string)
+{
+    /*
+     * Match directly from the pattern. On a mismatch, let the most recent
+     * star consume one more character and try again from after it.
+     */
+    size_t p = 0;
+    size_t s = 0;
+    size_t star = std::string::npos;
+    size_t starString = 0;
+
+    while (s < string.size()) {
+        if (p < pattern.size() && pattern[p] == '*') {
+            star = ++p;
+            starString = s;
+            continue;
+        }
+
+        if (p < pattern.size()) {
+            size_t end = WildcardClassEnd(pattern.data(), pattern.size(), p);
+            if (end != std::string::npos) {
+                if (::memchr(pattern.data() + p + 1, string[s], end - p - 1) != nullptr) {
+                    p = end + 1;
+                    s++;
+                    continue;
+                }
+            } else if (pattern[p] == string[s]) {
+                p++;
+                s++;
+                continue;
+            }
+        }
+
+        if (star == std::string::npos) {
+            return false;
+        }
+
+        p = star;
+        s = ++starString;
+    }
+
+    while (p < pattern.size() && pattern[p] == '*') {
+        p++;
+    }
+
+    return p == pattern.size();
+}
@@ -0,0 +1,78 @@
+/**
+ Copyright (c) 2015-present, Facebook, Inc.
+ All rights reserved.
+
+ This source code is licensed under the BSD-style license found in the
+ LICENSE file in the root directory of this source tree. An additional grant
+ of patent rights can be found in the PATENTS file in the same directory.
+ */
+
+#include <libutil/WildcardSet.h>
+
+#include <algorithm>
+
+using libutil::Wildcard;
+using libutil::WildcardSet;
+
+WildcardSet::
+WildcardSet(std::vector<std::string> const &patterns)
+{
+    _wildcards.reserve(patterns.size());
+
+    for (std::string const &pattern : patterns) {
+        size_t index = _wildcards.size();
+        _wildcards.push_back(Wildcard(pattern));
+        Wildcard const &wildcard = _wildcards.back();
+
+        /*
+         * A pattern ending in a literal character can only match strings
+         * ending in that character. Those ending in a star or a class are
+         * always checked.
+         */
+        Wildcard::Segment const &last = wildcard._segments.back();
+        if (last.length > 0 && wildcard._positionClasses[last.offset + last.length - 1] < 0) {
+            _lastCharacters.push_back({ wildcard._text[last.offset + last.length - 1], index });
+        } else {
+            _others.push_back(index);
+        }
+    }
+
+    /* Sorted by character, then index, to find the first match soonest. */
+    std::sort(_lastCharacters.begin(), _lastCharacters.end());
+}
+
+ext::optional<size_t> WildcardSet::
+match(char const *data, size_t size) const
+{
+    size_t best = _wildcards.size();
+
+    if (size > 0) {
+        auto range = std::equal_range(_lastCharacters.begin(), _lastCharacters.end(), std::make_pair(data[size - 1], size_t(0)), [](std::pair<char, size_t> const &lhs, std::pair<char, size_t> const &rhs) {
+            return lhs.first < rhs.first;
+        });
+
+        for (auto it = range.first; it != range.second && it->second < best; ++it) {
+            if (_wildcards[it->second].match(data, size)) {
+                best = it->second;
+                break;
+            }
+        }
+    }
+
+    for (size_t index : _others) {
+        if (index >= best) {
+            break;
+        }
+
+        if (_wildcards[index].match(data, size)) {
+            best = index;
+            break;
+        }
+    }
+
+    if (best == _wildcards.size()) {
+        return ext::nullopt;
+    }
+
+    return best;
+}
@@ -0,0 +1,161 @@
+/**
+ Copyright (c) 2015-present, Facebook, Inc.
+ All rights reserved.
+
+ This source code is licensed under the BSD-style license found in the
+ LICENSE file in the root directory of this source tree. An additional grant
+ of patent rights can be found in the PATENTS file in the same directory.
+ */
+
+#include <gtest/gtest.h>
+#include <libutil/CachingFilesystem.h>
+#include <libutil/MemoryFilesystem.h>
+
+#include <algorithm>
+
+using libutil::CachingFilesystem;
+using libutil::MemoryFilesystem;
+using libutil::Filesystem;
+
+typedef std::vector<std::pair<std::string, Filesystem::Type>> WalkEntries;
+
+static std::vector<uint8_t>
+Contents(std::string const &string)
+{
+    return std::vector<uint8_t>(string.begin(), string.end());
+}
+
+static MemoryFilesystem
+BasicFilesystem()
+{
+    return MemoryFilesystem({
+        MemoryFilesystem::Entry::File("file1", Contents("one")),
+        MemoryFilesystem::Entry::Directory("dir1", {
+            MemoryFilesystem::Entry::File("file2", Contents("two")),
+            MemoryFilesystem::Entry::Directory("dir2", { }),
+        }),
+    });
+}
+
+static std::vector<std::string>
+Entries(Filesystem const *filesystem, std::string const &path, bool recursive)
+{
+    std::vector<std::string> entries;
+    filesystem->readDirectory(path, recursive, [&](std::string const &name) {
+        entries.push_back(name);
+    });
+    std::sort(entries.begin(), entries.end());
+    return entries;
+}
+
+TEST(CachingFilesystem, Forwards)
+{
+    auto base = BasicFilesystem();
+    auto filesystem = CachingFilesystem(&base);
+
+    EXPECT_TRUE(filesystem.exists(base.path("file1")));
+    EXPECT_FALSE(filesystem.exists(base.path("invalid")));
+    EXPECT_EQ(Filesystem::Type::Directory, filesystem.type(base.path("dir1")));
+    EXPECT_EQ(ext::nullopt, filesystem.type(base.path("invalid")));
+    EXPECT_TRUE(filesystem.isReadable(base.path("dir1/file2")));
+    EXPECT_EQ(std::vector<std::string>({ "dir2", "file2" }), Entries(&filesystem, base.path("dir1"), false));
+    EXPECT_EQ(std::vector<std::string>({ "dir1", "dir1/dir2", "dir1/file2", "file1" }), Entries(&filesystem, base.path(""), true));
+
+    std::vector<uint8_t> contents;
+    EXPECT_TRUE(filesystem.read(&contents, base.path("file1")));
+    EXPECT_EQ(Contents("one"), contents);
+}
+
+TEST(CachingFilesystem, Caches)
+{
+    auto base = BasicFilesystem();
+    auto filesystem = CachingFilesystem(&base);
+
+    EXPECT_FALSE(filesystem.exists(base.path("dir1/file3")));
+    EXPECT_EQ(ext::nullopt, filesystem.type(base.path("dir1/file3")));
+    EXPECT_EQ(std::vector<std::string>({ "dir2", "file2" }), Entries(&filesystem, base.path("dir1"), false));
+
+    /* Changes made behind the cache's back are not seen. */
+    EXPECT_TRUE(base.write(Contents("three"), base.path("dir1/file3")));
+    EXPECT_FALSE(filesystem.exists(base.path("dir1/file3")));
+    EXPECT_EQ(ext::nullopt, filesystem.type(base.path("dir1/file3")));
+    EXPECT_EQ(std::vector<std::string>({ "dir2", "file2" }), Entries(&filesystem, base.path("dir1"), false));
+
+    /* Until they are invalidated. */
+    filesystem.invalidate(base.path("dir1/file3"));
+    EXPECT_TRUE(filesystem.exists(base.path("dir1/file3")));
+    EXPECT_EQ(Filesystem::Type::File, filesystem.type(base.path("dir1/file3")));
+    EXPECT_EQ(std::vector<std::string>({ "dir2", "file2", "file3" }), Entries(&filesystem, base.path("dir1"), false));
+}
+
+TEST(CachingFilesystem, WalkDirectory)
+{
+    auto base = BasicFilesystem();
+    auto filesystem = CachingFilesystem(&base);
+
+    WalkEntries entries;
+    auto accumulate = [&entries](std::string const &name, Filesystem::Type type) {
+        entries.push_back({ name, type });
+    };
+
+    EXPECT_TRUE(filesystem.walkDirectory(base.path("dir1"), false, accumulate));
+    EXPECT_EQ(2, entries.size());
+
+    /* Walks are cached, and remember the types they found. */
+    EXPECT_TRUE(base.removeDirectory(base.path("dir1/dir2"), false));
+    EXPECT_EQ(Filesystem::Type::Directory, filesystem.type(base.path("dir1/dir2")));
+    entries.clear();
+    EXPECT_TRUE(filesystem.walkDirectory(base.path("dir1"), false, accumulate));
+    EXPECT_EQ(2, entries.size());
+
+    filesystem.invalidate(base.path("dir1/dir2"));
+    EXPECT_EQ(ext::nullopt, filesystem.type(base.path("dir1/dir2")));
+    entries.clear();
+    EXPECT_TRUE(filesystem.walkDirectory(base.path("dir1"), false, accumulate));
+    EXPECT_EQ(WalkEntries({ { "file2", Filesystem::Type::File } }), entries);
+}
+
+TEST(CachingFilesystem, InvalidateDescendants)
+{
+    auto base = BasicFilesystem();
+    auto filesystem = CachingFilesystem(&base);
+
+    EXPECT_TRUE(filesystem.exists(base.path("dir1/file2")));
+    EXPECT_TRUE(filesystem.exists(base.path("dir1/dir2")));
+    EXPECT_TRUE(filesystem.exists(base.path("file1")));
+
+    EXPECT_TRUE(base.removeDirectory(base.path("dir1"), true));
+    EXPECT_TRUE(base.removeFile(base.path("file1")));
+    filesystem.invalidate(base.path("dir1"));
+
+    EXPECT_FALSE(filesystem.exists(base.path("dir1/file2")));
+    EXPECT_FALSE(filesystem.exists(base.path("dir1/dir2")));
+
+    /* Unrelated paths are still cached. */
+    EXPECT_TRUE(filesystem.exists(base.path("file1")));
+
+    filesystem.invalidateAll();
+    EXPECT_FALSE(filesystem.exists(base.path("file1")));
+}
+
+TEST(CachingFilesystem, WritesInvalidate)
+{
+    auto base = BasicFilesystem();
+    auto filesystem = CachingFilesystem(&base);
+
+    EXPECT_FALSE(filesystem.exists(base.path("dir1/dir2/file4")));
+    EXPECT_EQ(std::vector<std::string>({ "dir1", "dir1/dir2", "dir1/file2", "file1" }), Entries(&filesystem, base.path(""), true));
+
+    EXPECT_TRUE(filesystem.write(Contents("four"), base.path("dir1/dir2/file4")));
+    EXPECT_TRUE(filesystem.exists(base.path("dir1/dir2/file4")));
+    EXPECT_EQ(std::vector<std::string>({ "dir1", "dir1/dir2", "dir1/dir2/file4", "dir1/file2", "file1" }), Entries(&filesystem, base.path(""), true));
+
+    EXPECT_TRUE(filesystem.removeFile(base.path("file1")));
+    EXPECT_FALSE(filesystem.exists(base.path("file1")));
+
+    std::unique_ptr<Filesystem::Output> output = filesystem.openOutput(base.path("file5"));
+    ASSERT_NE(nullptr, output);
+    EXPECT_FALSE(filesystem.exists(base.path("file5")));
+    EXPECT_TRUE(output->commit());
+    EXPECT_TRUE(filesystem.exists(base.path("file5")));
+}
@@ -0,0 +1,221 @@
+/**
+ Copyright (c) 2015-present, Facebook, Inc.
+ All rights reserved.
+
+ This source code is licensed under the BSD-style license found in the
+ LICENSE file in the root directory of this source tree. An additional grant
+ of patent rights can be found in the PATENTS file in the same directory.
+ */
+
+#include <gtest/gtest.h>
+#include <libutil/DefaultFilesystem.h>
+
+#include <algorithm>
+#include <cstdlib>
+
+using libutil::DefaultFilesystem;
+using libutil::Filesystem;
+
+typedef std::vector<std::pair<std::string, Filesystem::Type>> Entries;
+
+#if !_WIN32
+/*
+ * Create a temporary directory containing:
+ *
+ *     file1
+ *     dir1/file2
+ *     dir1/dir2/file3
+ *     link1 -> dir1
+ */
+static std::string
+CreateTree(DefaultFilesystem *filesystem)
+{
+    char directory[] = "/tmp/libutil-DefaultFilesystem-XXXXXX";
+    if (mkdtemp(directory) == nullptr) {
+        return std::string();
+    }
+
+    std::string root = directory;
+    std::vector<uint8_t> contents = { 'x' };
+    if (!filesystem->write(contents, root + "/file1") ||
+        !filesystem->createDirectory(root + "/dir1/dir2", true) ||
+        !filesystem->write(contents, root + "/dir1/file2") ||
+        !filesystem->write(contents, root + "/dir1/dir2/file3") ||
+        !filesystem->writeSymbolicLink("dir1", root + "/link1", true)) {
+        return std::string();
+    }
+
+    return root;
+}
+
+static Entries
+Sorted(Entries entries)
+{
+    std::sort(entries.begin(), entries.end());
+    return entries;
+}
+
+TEST(DefaultFilesystem, WalkDirectory)
+{
+    DefaultFilesystem filesystem;
+    std::string root = CreateTree(&filesystem);
+    ASSERT_FALSE(root.empty());
+
+    Entries entries;
+    auto accumulate = [&entries](std::string const &name, Filesystem::Type type) {
+        entries.push_back({ name, type });
+    };
+
+    EXPECT_TRUE(filesystem.walkDirectory(root, false, accumulate));
+    EXPECT_EQ(Entries({
+        { "dir1", Filesystem::Type::Directory },
+        { "file1", Filesystem::Type::File },
+        { "link1", Filesystem::Type::SymbolicLink },
+    }), Sorted(entries));
+
+    /* Symbolic links are not followed. */
+    Entries recursive = {
+        { "dir1", Filesystem::Type::Directory },
+        { "dir1/dir2", Filesystem::Type::Directory },
+        { "dir1/dir2/file3", Filesystem::Type::File },
+        { "dir1/file2", Filesystem::Type::File },
+        { "file1", Filesystem::Type::File },
+        { "link1", Filesystem::Type::SymbolicLink },
+    };
+
+    entries.clear();
+    EXPECT_TRUE(filesystem.walkDirectory(root, true, accumulate));
+    EXPECT_EQ(recursive, Sorted(entries));
+
+    entries.clear();
+    EXPECT_TRUE(filesystem.walkDirectoryParallel(root, 4, accumulate));
+    EXPECT_EQ(recursive, Sorted(entries));
+
+    /* Reading reports the same names. */
+    std::vector<std::string> names;
+    EXPECT_TRUE(filesystem.readDirectory(root, true, [&names](std::string const &name) {
+        names.push_back(name);
+    }));
+    std::sort(names.begin(), names.end());
+    EXPECT_EQ(std::vector<std::string>({ "dir1", "dir1/dir2", "dir1/dir2/file3", "dir1/file2", "file1", "link1" }), names);
+
+    /* Can't walk a file or nonexistent directory. */
+    entries.clear();
+    EXPECT_FALSE(filesystem.walkDirectory(root + "/file1", true, accumulate));
+    EXPECT_FALSE(filesystem.walkDirectory(root + "/invalid", true, accumulate));
+    EXPECT_FALSE(filesystem.walkDirectoryParallel(root + "/invalid", 4, accumulate));
+    EXPECT_TRUE(entries.empty());
+
+    /* Walking removes nested contents. */
+    EXPECT_TRUE(filesystem.removeDirectory(root, true));
+    EXPECT_FALSE(filesystem.exists(root));
+}
+
+TEST(DefaultFilesystem, WriteIfChanged)
+{
+    DefaultFilesystem filesystem;
+    std::string root = CreateTree(&filesystem);
+    ASSERT_FALSE(root.empty());
+    std::string path = root + "/file1";
+
+    ext::optional<Filesystem::Identity> identity = filesystem.identity(path);
+    ASSERT_NE(ext::nullopt, identity);
+
+    /* Same contents: not written, so the identity is the same. */
+    bool changed = true;
+    EXPECT_TRUE(filesystem.hasContents({ 'x' }, path));
+    EXPECT_TRUE(filesystem.writeIfChanged({ 'x' }, path, &changed));
+    EXPECT_FALSE(changed);
+    EXPECT_EQ(identity, filesystem.identity(path));
+
+    /* Different contents, including only a longer or shorter file. */
+    for (std::vector<uint8_t> const &contents : std::vector<std::vector<uint8_t>>({ { 'x', 'y' }, { 'x' }, { }, { 'z' } })) {
+        EXPECT_FALSE(filesystem.hasContents(contents, path));
+        EXPECT_TRUE(filesystem.writeIfChanged(contents, path, &changed));
+        EXPECT_TRUE(changed);
+        EXPECT_TRUE(filesystem.hasContents(contents, path));
+    }
+
+    /* Missing files are created. */
+    EXPECT_FALSE(filesystem.hasContents({ }, root + "/new"));
+    EXPECT_TRUE(filesystem.writeIfChanged({ }, root + "/new", &changed));
+    EXPECT_TRUE(changed);
+    EXPECT_TRUE(filesystem.hasContents({ }, root + "/new"));
+
+    EXPECT_TRUE(filesystem.removeDirectory(root, true));
+}
+
+TEST(DefaultFilesystem, ReadContents)
+{
+    DefaultFilesystem filesystem;
+    std::string root = CreateTree(&filesystem);
+    ASSERT_FALSE(root.empty());
+
+    /* Large enough to be mapped. */
+    std::vector<uint8_t> large;
+    for (size_t i = 0; i < 1024 * 1024; i++) {
+        large.push_back(static_cast<uint8_t>(i * 13));
+    }
+
+    for (std::vector<uint8_t> const &contents : std::vector<std::vector<uint8_t>>({ { }, { 'x' }, large })) {
+        ASSERT_TRUE(filesystem.write(contents, root + "/contents"));
+
+        std::vector<uint8_t> read;
+        EXPECT_TRUE(filesystem.readContents(root + "/contents", [&read](uint8_t const *data, size_t size) {
+            read.insert(read.end(), data, data + size);
+        }));
+        EXPECT_EQ(contents, read);
+    }
+
+    EXPECT_FALSE(filesystem.readContents(root + "/missing", [](uint8_t const *data, size_t size) { }));
+    EXPECT_FALSE(filesystem.readContents(root + "/dir1", [](uint8_t const *data, size_t size) { }));
+
+    EXPECT_TRUE(filesystem.removeDirectory(root, true));
+}
+
+TEST(DefaultFilesystem, Map)
+{
+    DefaultFilesystem filesystem;
+    std::string root = CreateTree(&filesystem);
+    ASSERT_FALSE(root.empty());
+
+    /* Large enough to be mapped. */
+    std::vector<uint8_t> large;
+    for (size_t i = 0; i < 1024 * 1024; i++) {
+        large.push_back(static_cast<uint8_t>(i * 7));
+    }
+
+    for (std::vector<uint8_t> const &contents : std::vector<std::vector<uint8_t>>({ { }, { 'x' }, large })) {
+        ASSERT_TRUE(filesystem.write(contents, root + "/contents"));
+
+        std::unique_ptr<Filesystem::Mapping> mapping = filesystem.map(root + "/contents");
+        ASSERT_NE(nullptr, mapping);
+        EXPECT_EQ(contents, std::vector<uint8_t>(mapping->data(), mapping->data() + mapping->size()));
+    }
+
+    EXPECT_EQ(nullptr, filesystem.map(root + "/missing"));
+    EXPECT_EQ(nullptr, filesystem.map(root + "/dir1"));
+
+    EXPECT_TRUE(filesystem.removeDirectory(root, true));
+}
+
+TEST(DefaultFilesystem, CloneFile)
+{
+    DefaultFilesystem filesystem;
+    std::string root = CreateTree(&filesystem);
+    ASSERT_FALSE(root.empty());
+
+    /* Replaces an existing file, and is independent of the original. */
+    ASSERT_TRUE(filesystem.write({ 'o', 'l', 'd' }, root + "/clone"));
+    EXPECT_TRUE(filesystem.cloneFile(root + "/file1", root + "/clone"));
+    EXPECT_TRUE(filesystem.hasContents({ 'x' }, root + "/clone"));
+
+    ASSERT_TRUE(filesystem.write({ 'y' }, root + "/clone"));
+    EXPECT_TRUE(filesystem.hasContents({ 'x' }, root + "/file1"));
+
+    EXPECT_FALSE(filesystem.cloneFile(root + "/missing", root + "/clone"));
+    EXPECT_FALSE(filesystem.cloneFile(root + "/dir1", root + "/clone"));
+
+    EXPECT_TRUE(filesystem.removeDirectory(root, true));
+}
+#endif
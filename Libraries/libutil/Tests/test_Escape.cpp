@@ -37,3 +37,14 @@ TEST(Escape, Makefile)
     EXPECT_EQ(Escape::Makefile("per%cent"), "per\\%cent");
     EXPECT_EQ(Escape::Makefile("'\"\\"), "'\"\\");
 }
+
+TEST(Escape, ResponseFile)
+{
+    EXPECT_EQ(Escape::ResponseFile(""), "\"\"");
+    EXPECT_EQ(Escape::ResponseFile("alpha"), "alpha");
+    EXPECT_EQ(Escape::ResponseFile("dollar$"), "dollar$");
+    EXPECT_EQ(Escape::ResponseFile("spa ce"), "\"spa ce\"");
+    EXPECT_EQ(Escape::ResponseFile("back\\slash"), "\"back\\\\slash\"");
+    EXPECT_EQ(Escape::ResponseFile("quo\"te"), "\"quo\\\"te\"");
+    EXPECT_EQ(Escape::ResponseFile("sin'gle"), "\"sin'gle\"");
+}
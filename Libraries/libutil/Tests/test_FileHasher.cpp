@@ -0,0 +1,173 @@
+/**
+ Copyright (c) 2015-present, Facebook, Inc.
+ All rights reserved.
+
+ This source code is licensed under the BSD-style license found in the
+ LICENSE file in the root directory of this source tree. An additional grant
+ of patent rights can be found in the PATENTS file in the same directory.
+ */
+
+#include <gtest/gtest.h>
+#include <libutil/FileHasher.h>
+#include <libutil/MemoryFilesystem.h>
+
+#include <atomic>
+#include <chrono>
+#include <map>
+
+using libutil::FileHasher;
+using libutil::Filesystem;
+using libutil::Hash;
+using libutil::MemoryFilesystem;
+
+/*
+ * An in-memory filesystem with identities set by the test, which counts
+ * how many times files are read.
+ */
+class IdentityFilesystem : public MemoryFilesystem {
+public:
+    std::map<std::string, Identity> identities;
+    mutable std::atomic<size_t>     reads;
+
+public:
+    IdentityFilesystem(std::vector<Entry> const &entries) :
+        MemoryFilesystem(entries),
+        reads           (0)
+    {
+    }
+
+public:
+    virtual ext::optional<Identity> identity(std::string const &path) const
+    {
+        auto it = identities.find(path);
+        if (it == identities.end()) {
+            return ext::nullopt;
+        }
+        return it->second;
+    }
+
+    virtual bool readContents(std::string const &path, std::function<void(uint8_t const *, size_t)> const &cb) const
+    {
+        reads++;
+        return MemoryFilesystem::readContents(path, cb);
+    }
+};
+
+static std::vector<uint8_t>
+Contents(std::string const &string)
+{
+    return std::vector<uint8_t>(string.begin(), string.end());
+}
+
+static Filesystem::Identity
+OldIdentity(uint64_t inode, uint64_t size)
+{
+    Filesystem::Identity identity;
+    identity.inode = inode;
+    identity.size = size;
+    identity.modified = 1;
+    return identity;
+}
+
+TEST(FileHasher, Contents)
+{
+    auto filesystem = MemoryFilesystem({
+        MemoryFilesystem::Entry::File("file", Contents("contents")),
+    });
+
+    EXPECT_EQ(Hash::String("contents"), FileHasher::Contents(&filesystem, filesystem.path("file")));
+    EXPECT_EQ(ext::nullopt, FileHasher::Contents(&filesystem, filesystem.path("missing")));
+}
+
+TEST(FileHasher, Memo)
+{
+    IdentityFilesystem filesystem({
+        MemoryFilesystem::Entry::File("file", Contents("contents")),
+        MemoryFilesystem::Entry::File("recent", Contents("contents")),
+        MemoryFilesystem::Entry::File("unidentified", Contents("contents")),
+    });
+    filesystem.identities[filesystem.path("file")] = OldIdentity(1, 8);
+
+    /* Files modified just now could change again without changing identity. */
+    Filesystem::Identity recent = OldIdentity(2, 8);
+    recent.modified = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::system_clock::now().time_since_epoch()).count();
+    filesystem.identities[filesystem.path("recent")] = recent;
+
+    FileHasher hasher;
+    for (int i = 0; i < 3; i++) {
+        EXPECT_EQ(Hash::String("contents"), hasher.hash(&filesystem, filesystem.path("file")));
+        EXPECT_EQ(Hash::String("contents"), hasher.hash(&filesystem, filesystem.path("recent")));
+        EXPECT_EQ(Hash::String("contents"), hasher.hash(&filesystem, filesystem.path("unidentified")));
+    }
+    EXPECT_EQ(1 + 3 + 3, filesystem.reads);
+
+    /* A changed identity is read again. */
+    ASSERT_TRUE(filesystem.write(Contents("changed"), filesystem.path("file")));
+    filesystem.identities[filesystem.path("file")] = OldIdentity(1, 7);
+    EXPECT_EQ(Hash::String("changed"), hasher.hash(&filesystem, filesystem.path("file")));
+    EXPECT_EQ(Hash::String("changed"), hasher.hash(&filesystem, filesystem.path("file")));
+    EXPECT_EQ(1 + 3 + 3 + 1, filesystem.reads);
+}
+
+TEST(FileHasher, SaveLoad)
+{
+    IdentityFilesystem filesystem({
+        MemoryFilesystem::Entry::File("a", Contents("a")),
+        MemoryFilesystem::Entry::File("with space", Contents("b")),
+    });
+    filesystem.identities[filesystem.path("a")] = OldIdentity(1, 1);
+    filesystem.identities[filesystem.path("with space")] = OldIdentity(2, 1);
+
+    FileHasher hasher;
+    EXPECT_EQ(Hash::String("a"), hasher.hash(&filesystem, filesystem.path("a")));
+    EXPECT_EQ(Hash::String("b"), hasher.hash(&filesystem, filesystem.path("with space")));
+    ASSERT_TRUE(hasher.save(&filesystem, filesystem.path("hashes")));
+
+    /* Loaded hashes are used without reading the files. */
+    size_t reads = filesystem.reads;
+    FileHasher loaded;
+    ASSERT_TRUE(loaded.load(&filesystem, filesystem.path("hashes")));
+    EXPECT_EQ(2, loaded.size());
+    EXPECT_EQ(Hash::String("a"), loaded.hash(&filesystem, filesystem.path("a")));
+    EXPECT_EQ(Hash::String("b"), loaded.hash(&filesystem, filesystem.path("with space")));
+    EXPECT_EQ(reads, filesystem.reads);
+
+    /* Only found hashes are saved, leaving out those loaded. */
+    ASSERT_TRUE(filesystem.write(Contents("c"), filesystem.path("c")));
+    filesystem.identities[filesystem.path("c")] = OldIdentity(3, 1);
+    EXPECT_EQ(Hash::String("c"), loaded.hash(&filesystem, filesystem.path("c")));
+    ASSERT_TRUE(loaded.save(&filesystem, filesystem.path("found"), true));
+
+    FileHasher found;
+    ASSERT_TRUE(found.load(&filesystem, filesystem.path("found")));
+    EXPECT_EQ(1, found.size());
+
+    ASSERT_TRUE(filesystem.write(Contents("garbage"), filesystem.path("hashes")));
+    EXPECT_FALSE(FileHasher().load(&filesystem, filesystem.path("hashes")));
+    EXPECT_FALSE(FileHasher().load(&filesystem, filesystem.path("missing")));
+}
+
+TEST(FileHasher, Parallel)
+{
+    std::vector<MemoryFilesystem::Entry> entries;
+    for (int i = 0; i < 100; i++) {
+        entries.push_back(MemoryFilesystem::Entry::File(std::to_string(i), Contents(std::string(i * 100, 'x'))));
+    }
+    IdentityFilesystem filesystem(entries);
+
+    std::vector<std::string> paths;
+    for (int i = 0; i < 100; i++) {
+        paths.push_back(filesystem.path(std::to_string(i)));
+        filesystem.identities[paths.back()] = OldIdentity(i, i * 100);
+    }
+    paths.push_back(filesystem.path("missing"));
+
+    FileHasher hasher;
+    std::vector<ext::optional<Hash>> hashes = hasher.hash(&filesystem, paths, 4);
+    ASSERT_EQ(paths.size(), hashes.size());
+    for (int i = 0; i < 100; i++) {
+        EXPECT_EQ(Hash::String(std::string(i * 100, 'x')), hashes[i]);
+    }
+    EXPECT_EQ(ext::nullopt, hashes.back());
+    EXPECT_EQ(100, hasher.size());
+}
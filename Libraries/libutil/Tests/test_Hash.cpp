@@ -0,0 +1,89 @@
+/**
+ Copyright (c) 2015-present, Facebook, Inc.
+ All rights reserved.
+
+ This source code is licensed under the BSD-style license found in the
+ LICENSE file in the root directory of this source tree. An additional grant
+ of patent rights can be found in the PATENTS file in the same directory.
+ */
+
+#include <gtest/gtest.h>
+#include <libutil/Hash.h>
+
+#include <unordered_set>
+
+using libutil::Hash;
+
+static std::vector<uint8_t>
+Pattern(size_t size)
+{
+    std::vector<uint8_t> data;
+    for (size_t i = 0; i < size; i++) {
+        data.push_back(static_cast<uint8_t>((i * 31 + 7) ^ (i >> 8)));
+    }
+    return data;
+}
+
+TEST(Hash, Stable)
+{
+    /* Hashes are stored, so they must not change between versions. */
+    EXPECT_EQ("800aba12d42e9d399d451fb5d1e1b3f3", Hash::String("").hex());
+    EXPECT_EQ("be7a4ab3dd0e4c846cc61f53961f5c0e", Hash::String("xcbuild").hex());
+    EXPECT_EQ("d9b0daab9731374cb3b37e5096ffbeea", Hash::Data(Pattern(5000)).hex());
+    EXPECT_EQ(Hash::String(""), Hash());
+}
+
+TEST(Hash, Stream)
+{
+    for (size_t size : { 0, 1, 63, 64, 65, 1023, 1024, 1025, 2048, 5000 }) {
+        std::vector<uint8_t> data = Pattern(size);
+        Hash expected = Hash::Data(data);
+
+        for (size_t piece : { 1, 7, 64, 1000, 4096 }) {
+            Hash::Stream stream;
+            for (size_t offset = 0; offset < data.size(); offset += piece) {
+                stream.update(data.data() + offset, std::min(piece, data.size() - offset));
+            }
+            EXPECT_EQ(expected, stream.finish());
+        }
+    }
+}
+
+TEST(Hash, Distinct)
+{
+    std::unordered_set<std::string> hashes;
+    std::vector<uint8_t> data = Pattern(3000);
+
+    /* Every prefix, including ones only differing by trailing zeros. */
+    for (size_t size = 0; size <= data.size(); size++) {
+        hashes.insert(Hash::Data(data.data(), size).hex());
+    }
+    for (size_t size = 0; size <= 130; size++) {
+        hashes.insert(Hash::String(std::string(size, '\0')).hex());
+    }
+    EXPECT_EQ(3001 + 130, hashes.size());
+
+    /* Every single bit flip. */
+    std::vector<uint8_t> small = Pattern(200);
+    hashes.clear();
+    hashes.insert(Hash::Data(small).hex());
+    for (size_t bit = 0; bit < small.size() * 8; bit++) {
+        std::vector<uint8_t> flipped = small;
+        flipped[bit / 8] ^= (1 << (bit % 8));
+        hashes.insert(Hash::Data(flipped).hex());
+    }
+    EXPECT_EQ(small.size() * 8 + 1, hashes.size());
+}
+
+TEST(Hash, Hex)
+{
+    Hash hash = Hash::String("xcbuild");
+    EXPECT_EQ(32, hash.hex().size());
+    EXPECT_EQ(hash, Hash::Parse(hash.hex()));
+    EXPECT_EQ(Hash(0x0123456789abcdefULL, 0xfedcba9876543210ULL), Hash::Parse("FEDCBA98765432100123456789ABCDEF"));
+    EXPECT_EQ("fedcba98765432100123456789abcdef", Hash(0x0123456789abcdefULL, 0xfedcba9876543210ULL).hex());
+
+    EXPECT_EQ(ext::nullopt, Hash::Parse(""));
+    EXPECT_EQ(ext::nullopt, Hash::Parse(hash.hex() + "0"));
+    EXPECT_EQ(ext::nullopt, Hash::Parse("g" + hash.hex().substr(1)));
+}
@@ -0,0 +1,121 @@
+/**
+ Copyright (c) 2015-present, Facebook, Inc.
+ All rights reserved.
+
+ This source code is licensed under the BSD-style license found in the
+ LICENSE file in the root directory of this source tree. An additional grant
+ of patent rights can be found in the PATENTS file in the same directory.
+ */
+
+#include <gtest/gtest.h>
+#include <libutil/Interned.h>
+#include <libutil/Relative.h>
+
+#include <thread>
+#include <unordered_set>
+
+using libutil::Path::Interned;
+using libutil::Path::Relative;
+
+TEST(Interned, Identity)
+{
+    Interned a = Interned("/tmp/objects/a.o");
+    Interned b = Interned(std::string("/tmp/objects/") + "a.o");
+    EXPECT_EQ(a, b);
+    EXPECT_EQ(a.raw(), b.raw());
+    EXPECT_EQ(a.hash(), b.hash());
+    EXPECT_NE(a, Interned("/tmp/objects/b.o"));
+
+    /* Paths are not normalized when interned. */
+    EXPECT_NE(Interned("/tmp//objects/a.o"), a);
+    EXPECT_EQ("/tmp//objects/a.o", Interned("/tmp//objects/a.o").raw());
+
+    EXPECT_TRUE(Interned().empty());
+    EXPECT_EQ(Interned(), Interned(""));
+}
+
+TEST(Interned, Components)
+{
+    Interned path = Interned("/tmp/objects/a.o");
+    EXPECT_EQ(Interned("/tmp/objects"), path.parent());
+    EXPECT_EQ(Interned("/tmp"), path.parent().parent());
+    EXPECT_EQ(Interned("/"), path.parent().parent().parent());
+    EXPECT_EQ(Interned("/"), Interned("/").parent());
+    EXPECT_EQ(Interned(""), Interned("a").parent());
+    EXPECT_EQ(Interned("/tmp/objects/b.o"), path.parent().child("b.o"));
+    EXPECT_EQ(Interned("/tmp/objects/b.o"), Interned("/tmp/objects/").child("b.o"));
+    EXPECT_EQ(Interned("/tmp/objects/b.o"), Interned("/tmp").child("objects/b.o"));
+    EXPECT_EQ(Interned("/tmp"), Interned("/").child("tmp"));
+    EXPECT_EQ(Interned("tmp"), Interned("").child("tmp"));
+    EXPECT_EQ(path, path.child(""));
+
+    EXPECT_EQ("a.o", path.base());
+    EXPECT_EQ("a", path.base(false));
+    EXPECT_EQ("o", path.extension());
+    EXPECT_TRUE(path.extension("o"));
+    EXPECT_TRUE(path.extension("O"));
+    EXPECT_FALSE(path.extension("O", false));
+    EXPECT_FALSE(path.extension("oo"));
+
+    EXPECT_EQ("", Interned("/tmp.d/file").extension());
+    EXPECT_FALSE(Interned("/tmp.d/file").extension("d"));
+    EXPECT_TRUE(Interned("/tmp.d/file").extension(""));
+
+    /* Components are shared between paths. */
+    EXPECT_EQ(&path.base(), &Interned("/other/a.o").base());
+    EXPECT_EQ(&path.extension(), &Interned("b/a.o").extension());
+}
+
+TEST(Interned, MatchesRelative)
+{
+    for (char const *raw : {
+        "", "/", "a", "a/", "/a", "a.b.c", ".hidden", "/x/./y/../z.tar.gz", "../up", "a//b", "/tmp/a.",
+        "//x", "a/b/", "a\\b.c", "/x/..", "./", "a/b//", "/a/", "//", "a/./", "a/../..", "../..", "/..",
+        "a/.", "x/y/z/", "a\\", "a/b\\", "a/../../b/..", "/x/../../y", "./a/./b/"
+    }) {
+        Relative relative = Relative(raw);
+        Interned interned = Interned(raw);
+
+        EXPECT_EQ(relative.raw(), interned.raw());
+        EXPECT_EQ(relative.normalized(), interned.normalized().raw());
+        EXPECT_EQ(relative.parent().raw(), interned.parent().raw());
+        EXPECT_EQ(relative.base(), interned.base());
+        EXPECT_EQ(relative.base(false), interned.base(false));
+        EXPECT_EQ(relative.extension(), interned.extension());
+        EXPECT_EQ(relative.extension("gz"), interned.extension("gz"));
+    }
+}
+
+TEST(Interned, Normalized)
+{
+    Interned path = Interned("/tmp/./objects//../a.o");
+    EXPECT_EQ(Interned("/tmp/a.o"), path.normalized());
+    EXPECT_EQ(path.normalized(), path.normalized().normalized());
+
+    /* The parent is the path as written, before normalizing. */
+    EXPECT_EQ(Interned("/tmp/./objects//.."), path.parent());
+    EXPECT_EQ(Interned("/tmp"), path.parent().normalized());
+}
+
+TEST(Interned, Threads)
+{
+    std::vector<std::thread> threads;
+    std::vector<std::vector<Interned>> results = std::vector<std::vector<Interned>>(4);
+    for (size_t n = 0; n < results.size(); n++) {
+        threads.push_back(std::thread([n, &results]() {
+            for (int i = 0; i < 1000; i++) {
+                results[n].push_back(Interned("/threads/" + std::to_string(i % 100) + "/file.c"));
+            }
+        }));
+    }
+    for (std::thread &thread : threads) {
+        thread.join();
+    }
+
+    for (size_t n = 1; n < results.size(); n++) {
+        EXPECT_EQ(results[0], results[n]);
+    }
+
+    std::unordered_set<Interned> unique = std::unordered_set<Interned>(results[0].begin(), results[0].end());
+    EXPECT_EQ(100, unique.size());
+}
@@ -13,6 +13,8 @@
 using libutil::MemoryFilesystem;
 using libutil::Filesystem;
 
+typedef std::vector<std::pair<std::string, Filesystem::Type>> Entries;
+
 static std::vector<uint8_t>
 Contents(std::string const &string)
 {
@@ -196,6 +198,32 @@ TEST(MemoryFilesystem, Write)
     EXPECT_FALSE(filesystem.exists(filesystem.path("invalid/new")));
 }
 
+TEST(MemoryFilesystem, OpenOutput)
+{
+    auto filesystem = BasicFilesystem();
+    std::vector<uint8_t> contents;
+
+    /* Contents only appear once committed. */
+    std::unique_ptr<Filesystem::Output> output = filesystem.openOutput(filesystem.path("file1"));
+    ASSERT_NE(output, nullptr);
+    EXPECT_TRUE(output->write(reinterpret_cast<uint8_t const *>("new "), 4));
+    EXPECT_TRUE(output->write(reinterpret_cast<uint8_t const *>("one"), 3));
+    contents.clear();
+    EXPECT_TRUE(filesystem.read(&contents, filesystem.path("file1")));
+    EXPECT_EQ(contents, Contents("one"));
+    EXPECT_TRUE(output->commit());
+    contents.clear();
+    EXPECT_TRUE(filesystem.read(&contents, filesystem.path("file1")));
+    EXPECT_EQ(contents, Contents("new one"));
+
+    /* Abandoned outputs leave no file. */
+    output = filesystem.openOutput(filesystem.path("file3"));
+    ASSERT_NE(output, nullptr);
+    EXPECT_TRUE(output->write(reinterpret_cast<uint8_t const *>("three"), 5));
+    output.reset();
+    EXPECT_FALSE(filesystem.exists(filesystem.path("file3")));
+}
+
 TEST(MemoryFilesystem, CopyFile)
 {
     std::vector<uint8_t> contents;
@@ -342,6 +370,41 @@ TEST(MemoryFilesystem, ReadDirectory)
     EXPECT_EQ(files, std::vector<std::string>());
 }
 
+TEST(MemoryFilesystem, WalkDirectory)
+{
+    auto filesystem = BasicFilesystem();
+
+    Entries entries;
+    auto accumulate = [&entries](std::string const &name, Filesystem::Type type) {
+        entries.push_back({ name, type });
+    };
+
+    /* Types are reported along with names. */
+    EXPECT_TRUE(filesystem.walkDirectory(filesystem.path("dir2"), false, accumulate));
+    EXPECT_EQ(entries, Entries({
+        { "file2", Filesystem::Type::File },
+        { "dir3", Filesystem::Type::Directory },
+    }));
+
+    /* Same order as reading the directory. */
+    entries.clear();
+    EXPECT_TRUE(filesystem.walkDirectory(filesystem.path(""), true, accumulate));
+    EXPECT_EQ(entries, Entries({
+        { "file1", Filesystem::Type::File },
+        { "dir1/file2", Filesystem::Type::File },
+        { "dir1", Filesystem::Type::Directory },
+        { "dir2/file2", Filesystem::Type::File },
+        { "dir2/dir3", Filesystem::Type::Directory },
+        { "dir2", Filesystem::Type::Directory },
+    }));
+
+    /* Can't walk file or nonexistent directory. */
+    entries.clear();
+    EXPECT_FALSE(filesystem.walkDirectory(filesystem.path("file1"), true, accumulate));
+    EXPECT_FALSE(filesystem.walkDirectory(filesystem.path("invalid"), true, accumulate));
+    EXPECT_TRUE(entries.empty());
+}
+
 TEST(MemoryFilesystem, CopyDirectory)
 {
     auto filesystem = BasicFilesystem();
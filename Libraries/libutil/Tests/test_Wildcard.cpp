@@ -10,42 +10,150 @@
 #include <gtest/gtest.h>
 #include <libutil/Wildcard.h>
 
+#include <random>
+
 using libutil::Wildcard;
 
+/*
+ * Match both without compiling and with a compiled pattern, which must
+ * always agree.
+ */
+static bool
+Match(std::string const &pattern, std::string const &string)
+{
+    bool direct = Wildcard::Match(pattern, string);
+    bool compiled = Wildcard(pattern).match(string);
+    EXPECT_EQ(direct, compiled) << "pattern '" << pattern << "' string '" << string << "'";
+    return direct && compiled;
+}
+
 TEST(Wildcard, Basic)
 {
-    EXPECT_TRUE(Wildcard::Match("", ""));
-    EXPECT_TRUE(Wildcard::Match("a", "a"));
-    EXPECT_TRUE(Wildcard::Match("abcd", "abcd"));
-    EXPECT_FALSE(Wildcard::Match("abc", "abcd"));
-    EXPECT_FALSE(Wildcard::Match("abcd", "bcd"));
+    EXPECT_TRUE(Match("", ""));
+    EXPECT_TRUE(Match("a", "a"));
+    EXPECT_TRUE(Match("abcd", "abcd"));
+    EXPECT_FALSE(Match("abc", "abcd"));
+    EXPECT_FALSE(Match("abcd", "bcd"));
+    EXPECT_FALSE(Match("a", ""));
+    EXPECT_FALSE(Match("", "a"));
 }
 
 TEST(Wildcard, Star)
 {
-    EXPECT_TRUE(Wildcard::Match("*", ""));
-    EXPECT_TRUE(Wildcard::Match("*", "a"));
-    EXPECT_TRUE(Wildcard::Match("a*", "a"));
-    EXPECT_TRUE(Wildcard::Match("*a", "a"));
-    EXPECT_TRUE(Wildcard::Match("*a*", "a"));
-    EXPECT_TRUE(Wildcard::Match("*", "abcd"));
-    EXPECT_TRUE(Wildcard::Match("a*de", "abcde"));
-    EXPECT_FALSE(Wildcard::Match("a*d", "abcde"));
-    EXPECT_FALSE(Wildcard::Match("a*dce", "abcde"));
-    EXPECT_FALSE(Wildcard::Match("*a", "b"));
+    EXPECT_TRUE(Match("*", ""));
+    EXPECT_TRUE(Match("*", "a"));
+    EXPECT_TRUE(Match("a*", "a"));
+    EXPECT_TRUE(Match("*a", "a"));
+    EXPECT_TRUE(Match("*a*", "a"));
+    EXPECT_TRUE(Match("*", "abcd"));
+    EXPECT_TRUE(Match("a*de", "abcde"));
+    EXPECT_FALSE(Match("a*d", "abcde"));
+    EXPECT_FALSE(Match("a*dce", "abcde"));
+    EXPECT_FALSE(Match("*a", "b"));
+    EXPECT_FALSE(Match("*a", ""));
+}
+
+TEST(Wildcard, Backtrack)
+{
+    /* The first occurrence after a star is not always the right one. */
+    EXPECT_TRUE(Match("*.m", "a.b.m"));
+    EXPECT_TRUE(Match("*.tar.gz", "file.tar.tar.gz"));
+    EXPECT_TRUE(Match("*a*b", "xaxb"));
+    EXPECT_TRUE(Match("*ab*ab", "aabaab"));
+    EXPECT_TRUE(Match("a**b", "ab"));
+    EXPECT_FALSE(Match("*.m", "a.m.h"));
+    EXPECT_FALSE(Match("*ab*ab", "abab "));
+    EXPECT_FALSE(Match("a*b*c", "acb"));
 }
 
 TEST(Wildcard, One)
 {
-    EXPECT_TRUE(Wildcard::Match("[", "["));
-    EXPECT_TRUE(Wildcard::Match("[a]", "a"));
-    EXPECT_TRUE(Wildcard::Match("[aA]", "A"));
-    EXPECT_TRUE(Wildcard::Match("b[aA]d", "bAd"));
-    EXPECT_TRUE(Wildcard::Match("b[aA]d", "bad"));
-    EXPECT_TRUE(Wildcard::Match("b[aei][dn]", "ban"));
-    EXPECT_TRUE(Wildcard::Match("b[aei][dn]", "bid"));
+    EXPECT_TRUE(Match("[", "["));
+    EXPECT_TRUE(Match("[a]", "a"));
+    EXPECT_TRUE(Match("[aA]", "A"));
+    EXPECT_TRUE(Match("b[aA]d", "bAd"));
+    EXPECT_TRUE(Match("b[aA]d", "bad"));
+    EXPECT_TRUE(Match("b[aei][dn]", "ban"));
+    EXPECT_TRUE(Match("b[aei][dn]", "bid"));
+    EXPECT_TRUE(Match("*.[cm]", "a.b.m"));
+    EXPECT_TRUE(Match("[*]", "*"));
+
+    EXPECT_FALSE(Match("[aA]", "aA"));
+    EXPECT_FALSE(Match("[aA]", "b"));
+    EXPECT_FALSE(Match("[aA]", ""));
+    EXPECT_FALSE(Match("[]", ""));
+    EXPECT_FALSE(Match("[*]", "a"));
+}
+
+TEST(Wildcard, Compiled)
+{
+    Wildcard literal = Wildcard("Info.plist");
+    EXPECT_EQ("Info.plist", literal.pattern());
+    EXPECT_TRUE(literal.literal());
+    EXPECT_EQ(10, literal.minimumLength());
 
-    EXPECT_FALSE(Wildcard::Match("[aA]", "aA"));
-    EXPECT_FALSE(Wildcard::Match("[aA]", "b"));
+    Wildcard wildcard = Wildcard("*.[hm]*");
+    EXPECT_FALSE(wildcard.literal());
+    EXPECT_EQ(2, wildcard.minimumLength());
+    EXPECT_TRUE(wildcard.match("a.h"));
+    EXPECT_TRUE(wildcard.match(".mm"));
+    EXPECT_FALSE(wildcard.match("a.c"));
 }
 
+/*
+ * Straightforward recursive matcher, to check the others against.
+ */
+static bool
+ReferenceMatch(std::string const &pattern, size_t p, std::string const &string, size_t s)
+{
+    if (p == pattern.size()) {
+        return s == string.size();
+    }
+
+    if (pattern[p] == '*') {
+        for (size_t i = s; i <= string.size(); i++) {
+            if (ReferenceMatch(pattern, p + 1, string, i)) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    if (s == string.size()) {
+        return false;
+    }
+
+    size_t end = (pattern[p] == '[' ? pattern.find(']', p + 1) : std::string::npos);
+    if (end != std::string::npos) {
+        std::string characters = pattern.substr(p + 1, end - p - 1);
+        return characters.find(string[s]) != std::string::npos && ReferenceMatch(pattern, end + 1, string, s + 1);
+    } else {
+        return pattern[p] == string[s] && ReferenceMatch(pattern, p + 1, string, s + 1);
+    }
+}
+
+TEST(Wildcard, Fuzz)
+{
+    /* Small alphabets so patterns often nearly match. */
+    std::string const patternAlphabet = "ab.*[]";
+    std::string const stringAlphabet = "ab.[]*";
+
+    std::mt19937 random = std::mt19937(1);
+    for (int i = 0; i < 20000; i++) {
+        std::string pattern;
+        size_t patternLength = random() % 9;
+        for (size_t j = 0; j < patternLength; j++) {
+            pattern += patternAlphabet[random() % patternAlphabet.size()];
+        }
+
+        std::string string;
+        size_t stringLength = random() % 9;
+        for (size_t j = 0; j < stringLength; j++) {
+            string += stringAlphabet[random() % stringAlphabet.size()];
+        }
+
+        bool expected = ReferenceMatch(pattern, 0, string, 0);
+        EXPECT_EQ(expected, Wildcard::Match(pattern, string)) << "pattern '" << pattern << "' string '" << string << "'";
+        EXPECT_EQ(expected, Wildcard(pattern).match(string)) << "pattern '" << pattern << "' string '" << string << "'";
+    }
+}
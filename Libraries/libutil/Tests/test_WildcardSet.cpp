@@ -0,0 +1,80 @@
+/**
+ Copyright (c) 2015-present, Facebook, Inc.
+ All rights reserved.
+
+ This source code is licensed under the BSD-style license found in the
+ LICENSE file in the root directory of this source tree. An additional grant
+ of patent rights can be found in the PATENTS file in the same directory.
+ */
+
+#include <gtest/gtest.h>
+#include <libutil/WildcardSet.h>
+
+#include <random>
+
+using libutil::Wildcard;
+using libutil::WildcardSet;
+
+TEST(WildcardSet, Match)
+{
+    WildcardSet set = WildcardSet({ "Info.plist", "*.[ch]", "*.m", "*", "*.m" });
+    EXPECT_EQ(5, set.wildcards().size());
+
+    EXPECT_EQ(ext::optional<size_t>(0), set.match("Info.plist"));
+    EXPECT_EQ(ext::optional<size_t>(1), set.match("main.c"));
+    EXPECT_EQ(ext::optional<size_t>(2), set.match("main.m"));
+    EXPECT_EQ(ext::optional<size_t>(3), set.match("main.swift"));
+    EXPECT_EQ(ext::optional<size_t>(3), set.match(""));
+}
+
+TEST(WildcardSet, First)
+{
+    /* Earlier patterns win, even when later ones are more specific. */
+    WildcardSet set = WildcardSet({ "*.[mh]", "*.h", "a.h", "" });
+    EXPECT_EQ(ext::optional<size_t>(0), set.match("a.h"));
+    EXPECT_EQ(ext::optional<size_t>(3), set.match(""));
+    EXPECT_EQ(ext::nullopt, set.match("a.c"));
+
+    WildcardSet empty = WildcardSet({ });
+    EXPECT_EQ(ext::nullopt, empty.match("a"));
+}
+
+TEST(WildcardSet, Fuzz)
+{
+    std::string const alphabet = "ab.*[]";
+
+    std::mt19937 random = std::mt19937(2);
+    for (int i = 0; i < 2000; i++) {
+        std::vector<std::string> patterns;
+        size_t count = random() % 6;
+        for (size_t j = 0; j < count; j++) {
+            std::string pattern;
+            size_t length = random() % 6;
+            for (size_t k = 0; k < length; k++) {
+                pattern += alphabet[random() % alphabet.size()];
+            }
+            patterns.push_back(pattern);
+        }
+
+        WildcardSet set = WildcardSet(patterns);
+
+        for (int j = 0; j < 10; j++) {
+            std::string string;
+            size_t length = random() % 6;
+            for (size_t k = 0; k < length; k++) {
+                string += alphabet[random() % alphabet.size()];
+            }
+
+            /* Same as checking each pattern in order. */
+            ext::optional<size_t> expected;
+            for (size_t k = 0; k < patterns.size(); k++) {
+                if (Wildcard::Match(patterns[k], string)) {
+                    expected = k;
+                    break;
+                }
+            }
+
+            EXPECT_EQ(expected, set.match(string)) << "string '" << string << "'";
+        }
+    }
+}
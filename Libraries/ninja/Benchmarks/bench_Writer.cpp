@@ -0,0 +1,250 @@
+/**
+ Copyright (c) 2015-present, Facebook, Inc.
+ All rights reserved.
+
+ This source code is licensed under the BSD-style license found in the
+ LICENSE file in the root directory of this source tree. An additional grant
+ of patent rights can be found in the PATENTS file in the same directory.
+ */
+
+#include <benchmark/Harness.h>
+#include <ninja/Writer.h>
+#include <ninja/Value.h>
+#include <libutil/DefaultFilesystem.h>
+#include <libutil/Options.h>
+#include <process/DefaultContext.h>
+
+#include <cstdlib>
+
+#if !_WIN32
+#include <unistd.h>
+#endif
+
+using benchmark::Harness;
+using libutil::DefaultFilesystem;
+using libutil::Filesystem;
+
+class Options {
+private:
+    ext::optional<bool>        _help;
+
+private:
+    ext::optional<int>         _edges;
+    ext::optional<int>         _inputs;
+
+private:
+    ext::optional<std::string> _output;
+    ext::optional<bool>        _csv;
+
+public:
+    Options();
+    ~Options();
+
+public:
+    bool help() const
+    { return _help.value_or(false); }
+
+public:
+    int edges() const
+    { return _edges.value_or(100000); }
+    int inputs() const
+    { return _inputs.value_or(4); }
+
+public:
+    ext::optional<std::string> const &output() const
+    { return _output; }
+    bool csv() const
+    { return _csv.value_or(false); }
+
+private:
+    friend class libutil::Options;
+    std::pair<bool, std::string>
+    parseArgument(std::vector<std::string> const &args, std::vector<std::string>::const_iterator *it);
+};
+
+Options::
+Options()
+{
+}
+
+Options::
+~Options()
+{
+}
+
+std::pair<bool, std::string> Options::
+parseArgument(std::vector<std::string> const &args, std::vector<std::string>::const_iterator *it)
+{
+    std::string const &arg = **it;
+
+    if (arg == "-h" || arg == "--help") {
+        return libutil::Options::Current<bool>(&_help, arg);
+    } else if (arg == "--edges") {
+        return libutil::Options::Next<int>(&_edges, args, it);
+    } else if (arg == "--inputs") {
+        return libutil::Options::Next<int>(&_inputs, args, it);
+    } else if (arg == "--output") {
+        return libutil::Options::Next<std::string>(&_output, args, it);
+    } else if (arg == "--csv") {
+        return libutil::Options::Current<bool>(&_csv, arg);
+    } else {
+        return std::make_pair(false, "unknown argument " + arg);
+    }
+}
+
+static int
+Help(std::string const &error = std::string())
+{
+    if (!error.empty()) {
+        fprintf(stderr, "error: %s\n", error.c_str());
+        fprintf(stderr, "\n");
+    }
+
+    fprintf(stderr, "Usage: bench_ninja_Writer [options]\n\n");
+    fprintf(stderr, "Measures writing a large Ninja file, in memory and streamed to disk.\n\n");
+
+#define INDENT "  "
+    fprintf(stderr, "Options:\n");
+    fprintf(stderr, INDENT "--edges <count>\n");
+    fprintf(stderr, INDENT "--inputs <count> (per edge)\n");
+    fprintf(stderr, INDENT "--output <path> (default: temporary file)\n");
+    fprintf(stderr, INDENT "--csv\n");
+    fprintf(stderr, "\n");
+#undef INDENT
+
+    return (error.empty() ? EXIT_SUCCESS : EXIT_FAILURE);
+}
+
+/*
+ * Write edges shaped like those the Ninja executor writes for each
+ * compiler invocation, including values that need escaping.
+ */
+static void
+WriteEdges(ninja::Writer *writer, int edges, int inputs)
+{
+    writer->comment("xcbuild ninja");
+    writer->binding({ "builddir", ninja::Value::String("/tmp/Build Products/Intermediates") });
+    writer->newline();
+    writer->rule("invoke", ninja::Value::Expression("cd $dir && env $env $exec && $depexec"));
+
+    for (int i = 0; i < edges; i++) {
+        std::string target = "Target" + std::to_string(i / 1000);
+        std::string file = "File" + std::to_string(i);
+
+        std::vector<ninja::Value> inputValues;
+        for (int j = 0; j < inputs; j++) {
+            inputValues.push_back(ninja::Value::String("/src/My Project/" + target + "/" + file + "." + std::to_string(j) + ".h"));
+        }
+
+        writer->build(
+            { ninja::Value::String("/tmp/Build Products/Intermediates/" + target + ".build/Objects-normal/x86_64/" + file + ".o") },
+            "invoke",
+            inputValues,
+            {
+                { "dir", ninja::Value::String("/src/My Project") },
+                { "exec", ninja::Value::String("clang -x c -c /src/My\\ Project/" + target + "/" + file + ".c -o " + file + ".o -MMD -MF " + file + ".d") },
+                { "env", ninja::Value::String("PATH=/usr/bin:/bin") },
+                { "depexec", ninja::Value::String("true") },
+            },
+            { },
+            { ninja::Value::String("xcbuild-phase-begin-" + target) });
+    }
+}
+
+/*
+ * Streams Ninja output to a file. Output held in memory never exceeds
+ * the writer's buffer size.
+ */
+class OutputSink : public ninja::Writer::Sink {
+private:
+    Filesystem::Output *_output;
+
+public:
+    explicit OutputSink(Filesystem::Output *output) :
+        _output(output)
+    {
+    }
+
+public:
+    virtual bool write(char const *data, size_t size)
+    {
+        return _output->write(reinterpret_cast<uint8_t const *>(data), size);
+    }
+};
+
+int
+main(int argc, char **argv)
+{
+    process::DefaultContext processContext = process::DefaultContext();
+
+    Options options;
+    std::pair<bool, std::string> result = libutil::Options::Parse<Options>(&options, processContext.commandLineArguments());
+    if (!result.first) {
+        return Help(result.second);
+    }
+
+    if (options.help()) {
+        return Help();
+    }
+
+    if (options.edges() <= 0 || options.inputs() < 0) {
+        return Help("invalid edge count");
+    }
+
+    DefaultFilesystem filesystem;
+
+    std::string outputPath;
+    if (options.output()) {
+        outputPath = *options.output();
+    } else {
+#if _WIN32
+        return Help("missing output path");
+#else
+        char const *tmpdir = getenv("TMPDIR");
+        outputPath = std::string(tmpdir != nullptr ? tmpdir : "/tmp") + "/bench_ninja_Writer." + std::to_string(getpid()) + ".ninja";
+#endif
+    }
+
+    Harness harness = Harness("ninja writer edges=" + std::to_string(options.edges()) + " inputs=" + std::to_string(options.inputs()));
+
+    size_t size = 0;
+    harness.stage("Memory", [&]() -> bool {
+        ninja::Writer writer;
+        WriteEdges(&writer, options.edges(), options.inputs());
+        size = writer.serialize().size();
+        return size > 0;
+    });
+
+    Harness::ResetPeakResidentBytes();
+
+    harness.stage("Stream", [&]() -> bool {
+        std::unique_ptr<Filesystem::Output> output = filesystem.openOutput(outputPath);
+        if (output == nullptr) {
+            return false;
+        }
+
+        OutputSink sink = OutputSink(output.get());
+        ninja::Writer writer = ninja::Writer(&sink);
+        WriteEdges(&writer, options.edges(), options.inputs());
+        return writer.flush() && output->commit();
+    });
+
+    if (!options.output()) {
+        filesystem.removeFile(outputPath);
+    }
+
+    if (options.csv()) {
+        harness.reportCSV(stdout, true);
+    } else {
+        harness.report(stdout);
+        fprintf(stdout, "Ninja file size: %zu bytes\n", size);
+    }
+
+    for (Harness::Result const &result : harness.results()) {
+        if (!result.success()) {
+            return EXIT_FAILURE;
+        }
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -80,6 +80,12 @@ public:
      */
     std::string resolve(EscapeMode mode) const;
 
+    /*
+     * Append the value to put in the Ninja file to an existing string,
+     * escaping in a single pass without intermediate copies.
+     */
+    void resolve(EscapeMode mode, std::string *result) const;
+
 public:
     /*
      * Create an empty Ninja value.
@@ -13,7 +13,6 @@
 #include <ninja/Value.h>
 
 #include <string>
-#include <sstream>
 #include <vector>
 
 namespace ninja {
@@ -21,13 +20,42 @@ namespace ninja {
 /*
  * Writes a Ninja file. Attempts to be reasonably type-safe to avoid the
  * most common escaping and syntax errors, but remains quite low-level.
+ *
+ * By default, output accumulates in memory until serialized. If a sink is
+ * provided, output is instead streamed to the sink in buffer-sized blocks
+ * so large files never need to be held in memory at once.
  */
 class Writer {
+public:
+    /*
+     * Receives serialized Ninja output as it is written.
+     */
+    class Sink {
+    public:
+        virtual ~Sink();
+
+    public:
+        /*
+         * Write a block of output. Returns false on failure.
+         */
+        virtual bool write(char const *data, size_t size) = 0;
+    };
+
+public:
+    /*
+     * The default size of the buffer before output is passed to a sink.
+     */
+    static size_t const DefaultBufferSize = 64 * 1024;
+
 private:
-    std::ostringstream _buffer;
+    Sink       *_sink;
+    size_t      _bufferSize;
+    std::string _buffer;
+    bool        _failed;
 
 public:
     Writer();
+    explicit Writer(Sink *sink, size_t bufferSize = DefaultBufferSize);
     ~Writer();
 
 public:
@@ -85,9 +113,21 @@ public:
 
 public:
     /*
-     * Serialize what's been written so far.
+     * Pass any buffered output to the sink. Returns false if writing
+     * to the sink has failed at any point. Without a sink, does nothing.
+     */
+    bool flush();
+
+    /*
+     * Serialize what's been written so far. With a sink, this is only
+     * the output that has not yet been flushed.
      */
     std::string serialize() const;
+
+private:
+    void bindings(std::vector<Binding> const &bindings);
+    void paths(std::vector<Value> const &paths, Value::EscapeMode mode);
+    void written();
 };
 
 }
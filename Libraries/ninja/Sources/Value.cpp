@@ -9,8 +9,6 @@
 
 #include <ninja/Value.h>
 
-#include <sstream>
-
 using ninja::Value;
 
 Value::
@@ -40,62 +38,89 @@ operator+(Value const &rhs) const
     return Value(chunks);
 }
 
-static std::string
-Replace(std::string string, std::string const &search, std::string const &replace)
+static void
+AppendString(std::string const &string, Value::EscapeMode mode, std::string *result)
 {
-    size_t pos = 0;
+    for (char c : string) {
+        switch (c) {
+            case '$':
+                /* Always escape variables. */
+                result->append("$$", 2);
+                break;
+            case ' ':
+                /* Escape spaces in path lists. */
+                if (mode != Value::EscapeMode::Value) {
+                    result->push_back('$');
+                }
+                result->push_back(c);
+                break;
+            case ':':
+                /* Escape colons only in build path lists. */
+                if (mode == Value::EscapeMode::BuildPathList) {
+                    result->push_back('$');
+                }
+                result->push_back(c);
+                break;
+            default:
+                result->push_back(c);
+                break;
+        }
+    }
+}
 
-    while ((pos = string.find(search, pos)) != std::string::npos) {
-         string.replace(pos, search.length(), replace);
-         pos += replace.length();
+static void
+AppendExpression(std::string const &expression, Value::EscapeMode mode, std::string *result)
+{
+    if (mode == Value::EscapeMode::Value) {
+        /* Expression, value: no need to escape. Allow variables. */
+        result->append(expression);
+        return;
     }
 
-    return string;
+    for (size_t i = 0; i < expression.size(); i++) {
+        char c = expression[i];
+
+        if (c == '$' && i + 1 < expression.size()) {
+            char next = expression[i + 1];
+
+            /* Already-escaped spaces and colons keep their dollar sign literal. */
+            if (next == ' ' || (next == ':' && mode == Value::EscapeMode::BuildPathList)) {
+                result->append("$$$", 3);
+                result->push_back(next);
+                i++;
+                continue;
+            }
+        }
+
+        /* Expression, path list: escape spaces and, for build path lists, colons. */
+        if (c == ' ' || (c == ':' && mode == Value::EscapeMode::BuildPathList)) {
+            result->push_back('$');
+        }
+        result->push_back(c);
+    }
 }
 
 std::string Value::
 resolve(Value::EscapeMode mode) const
 {
-    std::ostringstream result;
+    std::string result;
+    resolve(mode, &result);
+    return result;
+}
 
+void Value::
+resolve(Value::EscapeMode mode, std::string *result) const
+{
     for (Value::Chunk const &chunk : _chunks) {
         switch (chunk.type()) {
             case Value::Chunk::Type::String:
-                switch (mode) {
-                    case Value::EscapeMode::Value:
-                        /* String, value: just escape variables. Spaces are allowed. */
-                        result << Replace(chunk.value(), "$", "$$");
-                        break;
-                    case Value::EscapeMode::PathList:
-                        /* String, path list: escape variables and spaces, not colons. */
-                        result << Replace(Replace(chunk.value(), "$", "$$"), " ", "$ ");
-                        break;
-                    case Value::EscapeMode::BuildPathList:
-                        /* String, build path list: escape variables, spaces, and, colons. */
-                        result << Replace(Replace(Replace(chunk.value(), "$", "$$"), " ", "$ "), ":", "$:");
-                        break;
-                }
+                AppendString(chunk.value(), mode, result);
                 break;
             case Value::Chunk::Type::Expression:
-                switch (mode) {
-                    case Value::EscapeMode::Value:
-                        /* Expression, value: no need to escape. Allow variables. */
-                        result << chunk.value();
-                        break;
-                    case Value::EscapeMode::PathList:
-                        /* Expression, path list: just escape spaces. */
-                        result << Replace(Replace(chunk.value(), "$ ", "$$ "), " ", "$ ");
-                        break;
-                    case Value::EscapeMode::BuildPathList:
-                        /* Expression, path list: escape spaces and colons. */
-                        result << Replace(Replace(Replace(Replace(chunk.value(), "$ ", "$$ "), " ", "$ "), "$:", "$$:"), ":", "$:");
-                        break;
-                }
+                AppendExpression(chunk.value(), mode, result);
                 break;
         }
     }
-
-    return result.str();
 }
 
 Value Value::
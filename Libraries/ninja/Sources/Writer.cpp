@@ -13,11 +13,31 @@ using ninja::Writer;
 using ninja::Binding;
 using ninja::Value;
 
+size_t const Writer::DefaultBufferSize;
+
+Writer::Sink::
+~Sink()
+{
+}
+
 Writer::
-Writer()
+Writer() :
+    _sink      (nullptr),
+    _bufferSize(0),
+    _failed    (false)
 {
 }
 
+Writer::
+Writer(Sink *sink, size_t bufferSize) :
+    _sink      (sink),
+    _bufferSize(bufferSize),
+    _failed    (false)
+{
+    /* Leave room for the statement that crosses the flush threshold. */
+    _buffer.reserve(_bufferSize + _bufferSize / 4);
+}
+
 Writer::
 ~Writer()
 {
@@ -26,65 +46,94 @@ Writer::
 void Writer::
 newline()
 {
-    _buffer << std::endl;
+    _buffer += '\n';
+    written();
 }
 
 void Writer::
 binding(Binding const &binding, int indent)
 {
     for (int i = 0; i < indent; i++) {
-        _buffer << "  ";
+        _buffer += "  ";
     }
 
-    _buffer << binding.first << " = " << binding.second.resolve(Value::EscapeMode::Value) << std::endl;
+    _buffer += binding.first;
+    _buffer += " = ";
+    binding.second.resolve(Value::EscapeMode::Value, &_buffer);
+    _buffer += '\n';
+    written();
 }
 
 void Writer::
-command(std::string const &command, std::string const &remaining, std::vector<Binding> const &bindings)
+bindings(std::vector<Binding> const &bindings)
 {
-    _buffer << command;
-    if (!remaining.empty()) {
-        _buffer << " " << remaining;
-    }
-    _buffer << std::endl;
-
     for (Binding const &binding : bindings) {
         this->binding(binding, 1);
     }
 
-    _buffer << std::endl;
+    _buffer += '\n';
+    written();
+}
+
+void Writer::
+paths(std::vector<Value> const &paths, Value::EscapeMode mode)
+{
+    for (Value const &path : paths) {
+        _buffer += ' ';
+        path.resolve(mode, &_buffer);
+    }
+}
+
+void Writer::
+command(std::string const &command, std::string const &remaining, std::vector<Binding> const &bindings)
+{
+    _buffer += command;
+    if (!remaining.empty()) {
+        _buffer += ' ';
+        _buffer += remaining;
+    }
+    _buffer += '\n';
+
+    this->bindings(bindings);
 }
 
 void Writer::
 comment(std::string const &text)
 {
-    _buffer << "#" << " " << text << std::endl;
+    _buffer += "# ";
+    _buffer += text;
+    _buffer += '\n';
+    written();
 }
 
 void Writer::
 subninja(Value const &path)
 {
-    command("subninja", path.resolve(Value::EscapeMode::PathList));
+    _buffer += "subninja ";
+    path.resolve(Value::EscapeMode::PathList, &_buffer);
+    _buffer += '\n';
+
+    bindings({ });
 }
 
 void Writer::
 include(Value const &path)
 {
-    command("include", path.resolve(Value::EscapeMode::PathList));
+    _buffer += "include ";
+    path.resolve(Value::EscapeMode::PathList, &_buffer);
+    _buffer += '\n';
+
+    bindings({ });
 }
 
 void Writer::
 default_(std::vector<Value> const &paths)
 {
-    std::string remaining;
-    for (Value const &path : paths) {
-        if (&path != &paths[0]) {
-            remaining += " ";
-        }
-        remaining += path.resolve(Value::EscapeMode::PathList);
-    }
+    _buffer += "default";
+    this->paths(paths, Value::EscapeMode::PathList);
+    _buffer += '\n';
 
-    command("default", remaining);
+    bindings({ });
 }
 
 void Writer::
@@ -98,50 +147,68 @@ pool(std::string const &name, int depth)
 void Writer::
 rule(std::string const &name, Value const &command, std::vector<Binding> const &bindings)
 {
-    std::vector<Binding> bindingList = bindings;
-    bindingList.insert(bindingList.begin(), { "command", command });
+    _buffer += "rule ";
+    _buffer += name;
+    _buffer += '\n';
 
-    this->command("rule", name, bindingList);
+    binding({ "command", command }, 1);
+    this->bindings(bindings);
 }
 
 void Writer::
 build(std::vector<Value> const &outputs, std::string const &rule, std::vector<Value> const &inputs, std::vector<Binding> const &bindings, std::vector<Value> const &dependencies, std::vector<Value> const &orders)
 {
-    std::ostringstream remaining;
+    _buffer += "build";
 
-    for (Value const &output : outputs) {
-        if (&output != &outputs[0]) {
-            remaining << " ";
-        }
-        remaining << output.resolve(Value::EscapeMode::BuildPathList);
+    paths(outputs, Value::EscapeMode::BuildPathList);
+    _buffer += ": ";
+    _buffer += rule;
+
+    paths(inputs, Value::EscapeMode::BuildPathList);
+
+    if (!dependencies.empty()) {
+        _buffer += " |";
+        paths(dependencies, Value::EscapeMode::BuildPathList);
+    }
+
+    if (!orders.empty()) {
+        _buffer += " ||";
+        paths(orders, Value::EscapeMode::BuildPathList);
     }
 
-    remaining << ":" << " " << rule;
+    _buffer += '\n';
+
+    this->bindings(bindings);
+}
 
-    for (Value const &input : inputs) {
-        remaining << " " << input.resolve(Value::EscapeMode::BuildPathList);
+void Writer::
+written()
+{
+    if (_sink != nullptr && _buffer.size() >= _bufferSize) {
+        flush();
     }
+}
 
-    if (!dependencies.empty()) {
-        remaining << " " << "|";
-        for (Value const &dependency : dependencies) {
-            remaining << " " << dependency.resolve(Value::EscapeMode::BuildPathList);
-        }
+bool Writer::
+flush()
+{
+    if (_sink == nullptr) {
+        return !_failed;
     }
 
-    if (!orders.empty()) {
-        remaining << " " << "||";
-        for (Value const &order : orders) {
-            remaining << " " << order.resolve(Value::EscapeMode::BuildPathList);
+    if (!_buffer.empty()) {
+        if (!_failed && !_sink->write(_buffer.data(), _buffer.size())) {
+            _failed = true;
         }
+
+        _buffer.clear();
     }
 
-    command("build", remaining.str(), bindings);
+    return !_failed;
 }
 
 std::string Writer::
 serialize() const
 {
-    return _buffer.str();
+    return _buffer;
 }
-
@@ -160,3 +160,71 @@ TEST(Writer, Pool)
     EXPECT_EQ(writer.serialize(), "pool name\n  depth = 4\n\n");
 }
 
+
+/*
+ * Collects output passed to the sink.
+ */
+class StringSink : public Writer::Sink {
+public:
+    std::string contents;
+    size_t      writes;
+    bool        fail;
+
+public:
+    StringSink() :
+        writes(0),
+        fail  (false)
+    {
+    }
+
+public:
+    virtual bool write(char const *data, size_t size)
+    {
+        contents.append(data, size);
+        writes++;
+        return !fail;
+    }
+};
+
+static void
+WriteSample(Writer *writer)
+{
+    writer->comment("comment");
+    writer->binding({ "variable", Value::String("value") });
+    writer->rule("name", Value::Expression("echo $in"), {
+        { "description", Value::String("echo$ing") },
+    });
+    for (int i = 0; i < 10; i++) {
+        writer->build({ Value::String("out " + std::to_string(i)) }, "name", { Value::String("in:" + std::to_string(i)) });
+    }
+    writer->default_({ Value::String("out 0") });
+}
+
+TEST(Writer, Sink)
+{
+    Writer memory;
+    WriteSample(&memory);
+
+    StringSink sink;
+    Writer streaming = Writer(&sink, 16);
+    WriteSample(&streaming);
+    EXPECT_TRUE(streaming.flush());
+
+    /* Output is identical, but was written in multiple blocks. */
+    EXPECT_EQ(memory.serialize(), sink.contents);
+    EXPECT_GT(sink.writes, 1u);
+    EXPECT_EQ(streaming.serialize(), "");
+}
+
+TEST(Writer, SinkFailure)
+{
+    StringSink sink;
+    sink.fail = true;
+
+    Writer writer = Writer(&sink, 16);
+    WriteSample(&writer);
+    EXPECT_FALSE(writer.flush());
+
+    /* No more output is passed to a failed sink. */
+    EXPECT_EQ(sink.writes, 1u);
+}
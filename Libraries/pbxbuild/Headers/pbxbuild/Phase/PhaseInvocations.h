@@ -14,6 +14,8 @@
 #include <pbxbuild/Tool/AuxiliaryFile.h>
 #include <pbxbuild/Tool/Invocation.h>
 
+namespace libutil { class Filesystem; }
+
 namespace pbxbuild {
 namespace Phase {
 
@@ -37,8 +39,12 @@ public:
     { return _auxiliaryFiles; }
 
 public:
+    /*
+     * Resolve the invocations to build a target. The filesystem is queried
+     * heavily, so it should cache when the same paths are resolved often.
+     */
     static PhaseInvocations
-    Create(Phase::Environment const &phaseEnvironment, pbxproj::PBX::Target::shared_ptr const &target);
+    Create(libutil::Filesystem const *filesystem, Phase::Environment const &phaseEnvironment, pbxproj::PBX::Target::shared_ptr const &target);
 };
 
 }
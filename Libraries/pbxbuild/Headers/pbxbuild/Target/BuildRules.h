@@ -11,6 +11,7 @@
 #define __pbxbuild_Target_BuildRules_h
 
 #include <pbxbuild/Base.h>
+#include <libutil/Wildcard.h>
 
 namespace pbxbuild {
 namespace Target {
@@ -27,6 +28,7 @@ public:
 
     private:
         std::string                    _filePatterns;
+        libutil::Wildcard              _filePatternsWildcard;
         pbxspec::PBX::FileType::vector _fileTypes;
         pbxspec::PBX::Tool::shared_ptr _tool;
         std::string                    _script;
@@ -38,6 +40,8 @@ public:
     public:
         inline std::string const &filePatterns() const
         { return _filePatterns; }
+        inline libutil::Wildcard const &filePatternsWildcard() const
+        { return _filePatternsWildcard; }
         inline pbxspec::PBX::FileType::vector const &fileTypes() const
         { return _fileTypes; }
 
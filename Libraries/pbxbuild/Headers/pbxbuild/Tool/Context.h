@@ -24,6 +24,8 @@
 #include <string>
 #include <vector>
 
+namespace libutil { class Filesystem; }
+
 #define PHASE_INVOCATION_PRIORITY_BASE 0x100
 #define PHASE_INVOCATION_PRIORITY_INCREMENT 0x100
 
@@ -32,6 +34,7 @@ namespace Tool {
 
 class Context {
 private:
+    libutil::Filesystem const       *_filesystem;
     xcsdk::SDK::Target::shared_ptr   _sdk;
     std::vector<xcsdk::SDK::Toolchain::shared_ptr> _toolchains;
     std::string                      _workingDirectory;
@@ -45,6 +48,8 @@ private:
     CompilationInfo                  _compilationInfo;
     std::vector<SwiftModuleInfo>     _swiftModuleInfo;
     std::vector<std::string>         _additionalInfoPlistContents;
+    std::shared_ptr<std::unordered_map<std::string, std::string> const> _scriptEnvironmentBase;
+    std::map<std::pair<std::string, std::string>, std::unordered_map<std::string, std::string>> _scriptEnvironmentVariantArchitectureValues;
 
 private:
     std::vector<Tool::Invocation>    _invocations;
@@ -58,6 +63,7 @@ private:
 
 public:
     Context(
+        libutil::Filesystem const *filesystem,
         xcsdk::SDK::Target::shared_ptr const &sdk,
         std::vector<xcsdk::SDK::Toolchain::shared_ptr> const &toolchains,
         std::string const &workingDirectory,
@@ -65,6 +71,8 @@ public:
     ~Context();
 
 public:
+    libutil::Filesystem const *filesystem() const
+    { return _filesystem; }
     xcsdk::SDK::Target::shared_ptr const &sdk() const
     { return _sdk; }
     std::vector<xcsdk::SDK::Toolchain::shared_ptr> const &toolchains() const
@@ -87,6 +95,12 @@ public:
     { return _swiftModuleInfo; }
     std::vector<std::string> const &additionalInfoPlistContents() const
     { return _additionalInfoPlistContents; }
+    /* Build settings shared by the environments of script invocations. */
+    std::shared_ptr<std::unordered_map<std::string, std::string> const> const &scriptEnvironmentBase() const
+    { return _scriptEnvironmentBase; }
+    /* Script environment variables that differ from the base, for each variant and architecture. */
+    std::map<std::pair<std::string, std::string>, std::unordered_map<std::string, std::string>> const &scriptEnvironmentVariantArchitectureValues() const
+    { return _scriptEnvironmentVariantArchitectureValues; }
 
 public:
     HeadermapInfo &headermapInfo()
@@ -99,6 +113,10 @@ public:
     { return _swiftModuleInfo; }
     std::vector<std::string> &additionalInfoPlistContents()
     { return _additionalInfoPlistContents; }
+    std::shared_ptr<std::unordered_map<std::string, std::string> const> &scriptEnvironmentBase()
+    { return _scriptEnvironmentBase; }
+    std::map<std::pair<std::string, std::string>, std::unordered_map<std::string, std::string>> &scriptEnvironmentVariantArchitectureValues()
+    { return _scriptEnvironmentVariantArchitectureValues; }
 
 public:
     std::vector<Tool::Invocation> const &invocations() const
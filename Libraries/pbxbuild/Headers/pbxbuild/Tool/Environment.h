@@ -46,8 +46,8 @@ public:
     { return _outputs; }
 
 public:
-    std::vector<std::string> inputs(std::string const &workingDirectory) const;
-    std::vector<std::string> outputs(std::string const &workingDirectory) const;
+    std::vector<libutil::Path::Interned> inputs(std::string const &workingDirectory) const;
+    std::vector<libutil::Path::Interned> outputs(std::string const &workingDirectory) const;
 
 public:
     static Tool::Environment
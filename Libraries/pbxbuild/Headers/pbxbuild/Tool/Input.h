@@ -11,6 +11,7 @@
 #define __pbxbuild_Tool_Input_h
 
 #include <pbxbuild/Target/BuildRules.h>
+#include <libutil/Interned.h>
 
 #include <string>
 #include <ext/optional>
@@ -28,7 +29,7 @@ class Environment;
  */
 class Input {
 private:
-    std::string                               _path;
+    libutil::Path::Interned                   _path;
     pbxspec::PBX::FileType::shared_ptr        _fileType;
 
 private:
@@ -60,7 +61,7 @@ public:
     /*
      * The resolved absolute path to the file.
      */
-    std::string const &path() const
+    libutil::Path::Interned const &path() const
     { return _path; }
 
     /*
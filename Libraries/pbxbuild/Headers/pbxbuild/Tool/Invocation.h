@@ -11,7 +11,9 @@
 #define __pbxbuild_Tool_Invocation_h
 
 #include <dependency/DependencyInfoFormat.h>
+#include <libutil/Interned.h>
 
+#include <memory>
 #include <string>
 #include <vector>
 #include <unordered_map>
@@ -89,16 +91,17 @@ private:
     ext::optional<Executable>                    _executable;
     std::vector<std::string>                     _arguments;
     std::unordered_map<std::string, std::string> _environment;
+    std::shared_ptr<std::unordered_map<std::string, std::string> const> _environmentBase;
     std::string                                  _workingDirectory;
 
 private:
-    std::vector<std::string>                     _inputs;
-    std::vector<std::string>                     _outputs;
-    std::vector<std::string>                     _phonyInputs;
+    std::vector<libutil::Path::Interned>         _inputs;
+    std::vector<libutil::Path::Interned>         _outputs;
+    std::vector<libutil::Path::Interned>         _phonyInputs;
 
 private:
-    std::vector<std::string>                     _inputDependencies;
-    std::vector<std::string>                     _orderDependencies;
+    std::vector<libutil::Path::Interned>         _inputDependencies;
+    std::vector<libutil::Path::Interned>         _orderDependencies;
 
 private:
     std::vector<DependencyInfo>                  _dependencyInfo;
@@ -116,6 +119,9 @@ private:
 private:
     uint32_t                                     _priority;
 
+private:
+    bool                                         _jobserver;
+
 public:
     Invocation();
     ~Invocation();
@@ -127,9 +133,19 @@ public:
     { return _arguments; }
     std::unordered_map<std::string, std::string> const &environment() const
     { return _environment; }
+    /* Variables shared with other invocations, overridden by `environment()`. Optional. */
+    std::shared_ptr<std::unordered_map<std::string, std::string> const> const &environmentBase() const
+    { return _environmentBase; }
     std::string const &workingDirectory() const
     { return _workingDirectory; }
 
+public:
+    /*
+     * The complete environment, combining the shared base and the
+     * invocation's own variables.
+     */
+    std::unordered_map<std::string, std::string> fullEnvironment() const;
+
 public:
     ext::optional<Executable> &executable()
     { return _executable; }
@@ -137,40 +153,52 @@ public:
     { return _arguments; }
     std::unordered_map<std::string, std::string> &environment()
     { return _environment; }
+    std::shared_ptr<std::unordered_map<std::string, std::string> const> &environmentBase()
+    { return _environmentBase; }
     std::string &workingDirectory()
     { return _workingDirectory; }
 
 public:
-    std::vector<std::string> const &inputs() const
+    /*
+     * Set the complete environment, sharing the variables that match the
+     * base. If the environment is missing any variables from the base, the
+     * base is not used and the environment is stored directly.
+     */
+    void shareEnvironment(
+        std::unordered_map<std::string, std::string> const &environment,
+        std::shared_ptr<std::unordered_map<std::string, std::string> const> const &base);
+
+public:
+    std::vector<libutil::Path::Interned> const &inputs() const
     { return _inputs; }
-    std::vector<std::string> const &outputs() const
+    std::vector<libutil::Path::Interned> const &outputs() const
     { return _outputs; }
 
 public:
     /* Inputs that may not exist or be generated by an invocation. */
-    std::vector<std::string> const &phonyInputs() const
+    std::vector<libutil::Path::Interned> const &phonyInputs() const
     { return _phonyInputs; }
 
 public:
-    std::vector<std::string> &inputs()
+    std::vector<libutil::Path::Interned> &inputs()
     { return _inputs; }
-    std::vector<std::string> &outputs()
+    std::vector<libutil::Path::Interned> &outputs()
     { return _outputs; }
 
 public:
-    std::vector<std::string> &phonyInputs()
+    std::vector<libutil::Path::Interned> &phonyInputs()
     { return _phonyInputs; }
 
 public:
-    std::vector<std::string> const &inputDependencies() const
+    std::vector<libutil::Path::Interned> const &inputDependencies() const
     { return _inputDependencies; }
-    std::vector<std::string> const &orderDependencies() const
+    std::vector<libutil::Path::Interned> const &orderDependencies() const
     { return _orderDependencies; }
 
 public:
-    std::vector<std::string> &inputDependencies()
+    std::vector<libutil::Path::Interned> &inputDependencies()
     { return _inputDependencies; }
-    std::vector<std::string> &orderDependencies()
+    std::vector<libutil::Path::Interned> &orderDependencies()
     { return _orderDependencies; }
 
 public:
@@ -216,6 +244,18 @@ public:
 public:
     uint32_t &priority()
     { return _priority; }
+
+public:
+    /*
+     * If the invocation may run parallel jobs of its own, like a script
+     * running make. It's passed the build's jobserver, if any, to share.
+     */
+    bool jobserver() const
+    { return _jobserver; }
+
+public:
+    bool &jobserver()
+    { return _jobserver; }
 };
 
 }
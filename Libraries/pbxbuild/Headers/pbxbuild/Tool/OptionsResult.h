@@ -17,6 +17,7 @@
 #include <unordered_map>
 #include <vector>
 
+namespace libutil { class Filesystem; }
 namespace pbxsetting { class Environment; }
 
 namespace pbxbuild {
@@ -44,6 +45,7 @@ public:
 
 public:
     static OptionsResult Create(
+        libutil::Filesystem const *filesystem,
         pbxsetting::Environment const &environment,
         std::string const &workingDirectory,
         std::vector<pbxspec::PBX::PropertyOption::shared_ptr> const &options,
@@ -51,6 +53,7 @@ public:
         std::unordered_set<std::string> const &deletedSettings = std::unordered_set<std::string>());
 
     static OptionsResult Create(
+        libutil::Filesystem const *filesystem,
         Tool::Environment const &toolEnvironment,
         std::string const &workingDirectory,
         pbxspec::PBX::FileType::shared_ptr const &fileType);
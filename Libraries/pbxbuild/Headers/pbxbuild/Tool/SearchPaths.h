@@ -13,6 +13,7 @@
 #include <string>
 #include <vector>
 
+namespace libutil { class Filesystem; }
 namespace pbxsetting { class Environment; }
 
 namespace pbxbuild {
@@ -44,11 +45,11 @@ public:
 
 public:
     static Tool::SearchPaths
-    Create(pbxsetting::Environment const &environment, std::string const &workingDirectory);
+    Create(libutil::Filesystem const *filesystem, pbxsetting::Environment const &environment, std::string const &workingDirectory);
 
 public:
     static std::vector<std::string>
-    ExpandRecursive(std::vector<std::string> const &paths, pbxsetting::Environment const &environment, std::string const &workingDirectory);
+    ExpandRecursive(libutil::Filesystem const *filesystem, std::vector<std::string> const &paths, pbxsetting::Environment const &environment, std::string const &workingDirectory);
 };
 
 }
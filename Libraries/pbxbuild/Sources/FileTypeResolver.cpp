@@ -12,7 +12,6 @@
 #include <libutil/Filesystem.h>
 #include <libutil/FSUtil.h>
 #include <libutil/Strings.h>
-#include <libutil/Wildcard.h>
 
 #include <cassert>
 
@@ -20,7 +19,6 @@ using pbxbuild::FileTypeResolver;
 using pbxbuild::DirectedGraph;
 using libutil::Filesystem;
 using libutil::FSUtil;
-using libutil::Wildcard;
 
 static ext::optional<std::vector<pbxspec::PBX::FileType::shared_ptr>>
 SortedFileTypes(std::vector<pbxspec::PBX::FileType::shared_ptr> const &fileTypes)
@@ -97,17 +95,10 @@ Resolve(Filesystem const *filesystem, pbxspec::Manager::shared_ptr const &specMa
             }
         }
 
-        if (fileType->filenamePatterns()) {
+        if (fileType->filenamePatternSet()) {
             empty = false;
-            bool matched = false;
-
-            for (std::string const &pattern : *fileType->filenamePatterns()) {
-                if (Wildcard::Match(pattern, fileName)) {
-                    matched = true;
-                }
-            }
 
-            if (!matched) {
+            if (!fileType->filenamePatternSet()->match(fileName)) {
                 continue;
             }
         }
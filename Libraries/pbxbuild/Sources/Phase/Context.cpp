@@ -160,6 +160,15 @@ scriptResolver(Phase::Environment const &phaseEnvironment)
         _scriptResolver = Tool::ScriptResolver::Create(buildEnvironment.specManager(), targetEnvironment.specDomains());
     }
 
+    /*
+     * Scripts share the target's build settings in their environments.
+     * Computed once, without any variant or architecture.
+     */
+    if (_toolContext.scriptEnvironmentBase() == nullptr) {
+        Target::Environment const &targetEnvironment = phaseEnvironment.targetEnvironment();
+        _toolContext.scriptEnvironmentBase() = std::make_shared<std::unordered_map<std::string, std::string> const>(targetEnvironment.environment().computeValues(pbxsetting::Condition::Empty()));
+    }
+
     return _scriptResolver.get();
 }
 
@@ -353,7 +362,7 @@ resolveBuildFiles(
         Target::BuildRules::BuildRule::shared_ptr const &buildRule = first.buildRule();
         if (buildRule == nullptr && fallbackToolIdentifier.empty()) {
             std::string fileTypeName = (first.fileType() != nullptr ? first.fileType()->identifier() : "unknown");
-            fprintf(stderr, "warning: no matching build rule for %s (type %s)\n", first.path().c_str(), fileTypeName.c_str());
+            fprintf(stderr, "warning: no matching build rule for %s (type %s)\n", first.path().raw().c_str(), fileTypeName.c_str());
             continue;
         }
 
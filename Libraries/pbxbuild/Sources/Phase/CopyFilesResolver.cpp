@@ -85,7 +85,7 @@ resolve(Phase::Environment const &phaseEnvironment, Phase::Context *phaseContext
     std::string path = environment.expand(_buildPhase->dstPath());
     std::string outputDirectory = root + "/" + path;
 
-    std::vector<Tool::Input> files = Phase::File::ResolveBuildFiles(Filesystem::GetDefaultUNSAFE(), phaseEnvironment, environment, _buildPhase->files());
+    std::vector<Tool::Input> files = Phase::File::ResolveBuildFiles(phaseContext->toolContext().filesystem(), phaseEnvironment, environment, _buildPhase->files());
     std::vector<std::vector<Tool::Input>> groups = Phase::Context::Group(files);
 
     if (pbxsetting::Type::ParseBoolean(environment.resolve("APPLY_RULES_IN_COPY_FILES"))) {
@@ -44,7 +44,7 @@ resolve(Phase::Environment const &phaseEnvironment, Phase::Context *phaseContext
     std::string publicOutputDirectory = targetBuildDirectory + "/" + environment.resolve("PUBLIC_HEADERS_FOLDER_PATH");
     std::string privateOutputDirectory = targetBuildDirectory + "/" + environment.resolve("PRIVATE_HEADERS_FOLDER_PATH");
 
-    std::vector<Tool::Input> files = Phase::File::ResolveBuildFiles(Filesystem::GetDefaultUNSAFE(), phaseEnvironment, environment, _buildPhase->files());
+    std::vector<Tool::Input> files = Phase::File::ResolveBuildFiles(phaseContext->toolContext().filesystem(), phaseEnvironment, environment, _buildPhase->files());
 
     for (Tool::Input const &file : files) {
         std::vector<std::string> const &attributes = file.attributes().value_or(std::vector<std::string>());
@@ -41,16 +41,18 @@ Phase::PhaseInvocations::
 }
 
 Phase::PhaseInvocations Phase::PhaseInvocations::
-Create(Phase::Environment const &phaseEnvironment, pbxproj::PBX::Target::shared_ptr const &target)
+Create(libutil::Filesystem const *filesystem, Phase::Environment const &phaseEnvironment, pbxproj::PBX::Target::shared_ptr const &target)
 {
     Target::Environment const &targetEnvironment = phaseEnvironment.targetEnvironment();
     pbxsetting::Environment const &environment = targetEnvironment.environment();
 
     /* Create the tool context for building. */
     Tool::SearchPaths searchPaths = Tool::SearchPaths::Create(
+        filesystem,
         targetEnvironment.environment(),
         targetEnvironment.workingDirectory());
     Tool::Context toolContext = Tool::Context(
+        filesystem,
         targetEnvironment.sdk(),
         targetEnvironment.toolchains(),
         targetEnvironment.workingDirectory(),
@@ -68,7 +68,7 @@ resolve(Phase::Environment const &phaseEnvironment, Phase::Context *phaseContext
     pbxsetting::Environment const &environment = phaseEnvironment.targetEnvironment().environment();
     std::string resourcesDirectory = environment.resolve("BUILT_PRODUCTS_DIR") + "/" + environment.resolve("UNLOCALIZED_RESOURCES_FOLDER_PATH");
 
-    std::vector<Tool::Input> files = Phase::File::ResolveBuildFiles(Filesystem::GetDefaultUNSAFE(), phaseEnvironment, environment, _buildPhase->files());
+    std::vector<Tool::Input> files = Phase::File::ResolveBuildFiles(phaseContext->toolContext().filesystem(), phaseEnvironment, environment, _buildPhase->files());
     std::vector<std::vector<Tool::Input>> groups = Phase::Context::Group(files);
     if (!phaseContext->resolveBuildFiles(phaseEnvironment, environment, _buildPhase, groups, resourcesDirectory, Tool::CopyResolver::ToolIdentifier())) {
         return false;
@@ -130,7 +130,7 @@ resolve(Phase::Environment const &phaseEnvironment, Phase::Context *phaseContext
         fprintf(stderr, "error: unable to resolve module map\n");
     }
 
-    std::vector<Tool::Input> files = Phase::File::ResolveBuildFiles(Filesystem::GetDefaultUNSAFE(), phaseEnvironment, targetEnvironment.environment(), _buildPhase->files());
+    std::vector<Tool::Input> files = Phase::File::ResolveBuildFiles(phaseContext->toolContext().filesystem(), phaseEnvironment, targetEnvironment.environment(), _buildPhase->files());
 
     /*
      * Split files based on whether their tool is architecture-neutral.
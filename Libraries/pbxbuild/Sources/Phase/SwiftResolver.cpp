@@ -73,6 +73,7 @@ ShouldBundleSwiftRuntime(Tool::Context const *toolContext, pbxsetting::Environme
 
 static std::vector<std::string>
 CollectScanDirectories(
+    Filesystem const *filesystem,
     Phase::Environment const &phaseEnvironment,
     pbxsetting::Environment const &environment,
     xcsdk::SDK::Target::shared_ptr const &sdk,
@@ -107,7 +108,7 @@ CollectScanDirectories(
             continue;
         }
 
-        std::vector<Tool::Input> files = Phase::File::ResolveBuildFiles(Filesystem::GetDefaultUNSAFE(), phaseEnvironment, environment, buildPhase->files());
+        std::vector<Tool::Input> files = Phase::File::ResolveBuildFiles(filesystem, phaseEnvironment, environment, buildPhase->files());
         for (Tool::Input const &file : files) {
             if (file.fileType() != nullptr && file.fileType()->isFrameworkWrapper()) {
                 directories.push_back(file.path());
@@ -146,7 +147,7 @@ resolve(Phase::Environment const &phaseEnvironment, Phase::Context *phaseContext
      */
     std::string executablePath = environment.resolve("TARGET_BUILD_DIR") + "/" + environment.resolve("EXECUTABLE_PATH");
     Tool::Input executableInput = Tool::Input(executablePath, nullptr);
-    std::vector<std::string> directories = CollectScanDirectories(phaseEnvironment, environment, targetEnvironment.sdk(), phaseEnvironment.target());
+    std::vector<std::string> directories = CollectScanDirectories(phaseContext->toolContext().filesystem(), phaseEnvironment, environment, targetEnvironment.sdk(), phaseEnvironment.target());
 
     /*
      * Copy the standard library.
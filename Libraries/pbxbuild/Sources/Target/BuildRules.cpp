@@ -9,19 +9,18 @@
 
 #include <pbxbuild/Target/BuildRules.h>
 #include <libutil/FSUtil.h>
-#include <libutil/Wildcard.h>
 
 namespace Target = pbxbuild::Target;
 using libutil::FSUtil;
-using libutil::Wildcard;
 
 Target::BuildRules::BuildRule::
 BuildRule(std::string const &filePatterns, pbxspec::PBX::FileType::vector const &fileTypes, pbxspec::PBX::Tool::shared_ptr const &tool, std::string const &script, std::vector<pbxsetting::Value> const &outputFiles) :
-    _filePatterns(filePatterns),
-    _fileTypes   (fileTypes),
-    _tool        (tool),
-    _script      (script),
-    _outputFiles (outputFiles)
+    _filePatterns        (filePatterns),
+    _filePatternsWildcard(filePatterns),
+    _fileTypes           (fileTypes),
+    _tool                (tool),
+    _script              (script),
+    _outputFiles         (outputFiles)
 {
 }
 
@@ -36,7 +35,7 @@ resolve(pbxspec::PBX::FileType::shared_ptr const &fileType, std::string const &f
 {
     for (BuildRule::shared_ptr const &buildRule : _buildRules) {
         if (!buildRule->filePatterns().empty()) {
-            if (Wildcard::Match(buildRule->filePatterns(), FSUtil::GetBaseName(filePath))) {
+            if (buildRule->filePatternsWildcard().match(FSUtil::GetBaseName(filePath))) {
                 return buildRule;
             }
         } else {
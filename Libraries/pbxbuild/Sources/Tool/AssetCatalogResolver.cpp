@@ -31,7 +31,7 @@ resolve(
     pbxsetting::Environment const &baseEnvironment,
     std::vector<Tool::Input> const &inputs) const
 {
-    std::vector<std::string> absoluteInputPaths;
+    std::vector<libutil::Path::Interned> absoluteInputPaths;
     std::vector<std::string> assetPaths;
     std::vector<std::string> stickerPackStrings;
     for (Tool::Input const &input : inputs) {
@@ -66,7 +66,7 @@ resolve(
      * Resolve the tool options.
      */
     Tool::Environment toolEnvironment = Tool::Environment::Create(_tool, assetCatalogEnvironment, toolContext->workingDirectory(), std::vector<Tool::Input>());
-    Tool::OptionsResult options = Tool::OptionsResult::Create(toolEnvironment, toolContext->workingDirectory(), nullptr);
+    Tool::OptionsResult options = Tool::OptionsResult::Create(toolContext->filesystem(), toolEnvironment, toolContext->workingDirectory(), nullptr);
     Tool::Tokens::ToolExpansions tokens = Tool::Tokens::ExpandTool(toolEnvironment, options);
 
     pbxsetting::Environment const &environment = toolEnvironment.environment();
@@ -74,7 +74,7 @@ resolve(
     /*
      * Create tool outputs.
      */
-    std::vector<std::string> outputs = {
+    std::vector<libutil::Path::Interned> outputs = {
         /* Creates the asset catalog, always in the resources dir. */
         environment.expand(pbxsetting::Value::Parse("$(ProductResourcesDir)/Assets.car")),
     };
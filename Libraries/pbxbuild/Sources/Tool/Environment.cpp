@@ -29,20 +29,20 @@ Tool::Environment::
 {
 }
 
-std::vector<std::string> Tool::Environment::
+std::vector<libutil::Path::Interned> Tool::Environment::
 inputs(std::string const &workingDirectory) const
 {
-    std::vector<std::string> inputs;
+    std::vector<libutil::Path::Interned> inputs;
     for (std::string const &input : _inputs) {
         inputs.push_back(FSUtil::ResolveRelativePath(input, workingDirectory));
     }
     return inputs;
 }
 
-std::vector<std::string> Tool::Environment::
+std::vector<libutil::Path::Interned> Tool::Environment::
 outputs(std::string const &workingDirectory) const
 {
-    std::vector<std::string> outputs;
+    std::vector<libutil::Path::Interned> outputs;
     for (std::string const &output : _outputs) {
         outputs.push_back(FSUtil::ResolveRelativePath(output, workingDirectory));
     }
@@ -107,7 +107,7 @@ resolve(
 
     std::vector<std::string> headermapSearchPaths = HeadermapSearchPaths(_specManager, compilerEnvironment, target, toolContext->searchPaths(), toolContext->workingDirectory());
     for (std::string const &path : headermapSearchPaths) {
-        Filesystem::GetDefaultUNSAFE()->readDirectory(path, false, [&](std::string const &fileName) -> bool {
+        toolContext->filesystem()->readDirectory(path, false, [&](std::string const &fileName) -> bool {
             // TODO(grp): Use FileTypeResolver when reliable.
             std::string extension = FSUtil::GetFileExtension(fileName);
             if (extension != "h" && extension != "hpp") {
@@ -121,7 +121,7 @@ resolve(
 
     for (pbxproj::PBX::FileReference::shared_ptr const &fileReference : project->fileReferences()) {
         std::string filePath = compilerEnvironment.expand(fileReference->resolve());
-        pbxspec::PBX::FileType::shared_ptr fileType = FileTypeResolver::Resolve(Filesystem::GetDefaultUNSAFE(), _specManager, { pbxspec::Manager::AnyDomain() }, fileReference, filePath);
+        pbxspec::PBX::FileType::shared_ptr fileType = FileTypeResolver::Resolve(toolContext->filesystem(), _specManager, { pbxspec::Manager::AnyDomain() }, fileReference, filePath);
         if (fileType == nullptr || (fileType->identifier() != "sourcecode.c.h" && fileType->identifier() != "sourcecode.cpp.h")) {
             continue;
         }
@@ -148,7 +148,7 @@ resolve(
 
                 pbxproj::PBX::FileReference::shared_ptr const &fileReference = std::static_pointer_cast <pbxproj::PBX::FileReference> (buildFile->fileRef());
                 std::string filePath = compilerEnvironment.expand(fileReference->resolve());
-                pbxspec::PBX::FileType::shared_ptr fileType = FileTypeResolver::Resolve(Filesystem::GetDefaultUNSAFE(), _specManager, { pbxspec::Manager::AnyDomain() }, fileReference, filePath);
+                pbxspec::PBX::FileType::shared_ptr fileType = FileTypeResolver::Resolve(toolContext->filesystem(), _specManager, { pbxspec::Manager::AnyDomain() }, fileReference, filePath);
                 if (fileType == nullptr || (fileType->identifier() != "sourcecode.c.h" && fileType->identifier() != "sourcecode.cpp.h")) {
                     continue;
                 }
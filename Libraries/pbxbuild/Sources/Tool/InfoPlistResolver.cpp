@@ -54,7 +54,7 @@ resolve(
     std::string infoPlistPath = environment.resolve("TARGET_BUILD_DIR") + "/" + environment.resolve("INFOPLIST_PATH");
 
     Tool::Environment toolEnvironment = Tool::Environment::Create(_tool, env, toolContext->workingDirectory(), { input }, { infoPlistPath });
-    Tool::OptionsResult options = Tool::OptionsResult::Create(toolEnvironment, toolContext->workingDirectory(), nullptr);
+    Tool::OptionsResult options = Tool::OptionsResult::Create(toolContext->filesystem(), toolEnvironment, toolContext->workingDirectory(), nullptr);
     Tool::Tokens::ToolExpansions tokens = Tool::Tokens::ExpandTool(toolEnvironment, options);
 
     /* Pass all build settings for expansion. */
@@ -69,7 +69,7 @@ resolve(
     invocation.workingDirectory() = toolContext->workingDirectory();
     invocation.inputs() = toolEnvironment.inputs(toolContext->workingDirectory());
     invocation.outputs() = toolEnvironment.outputs(toolContext->workingDirectory());
-    invocation.inputDependencies() = toolContext->additionalInfoPlistContents();
+    invocation.inputDependencies() = std::vector<libutil::Path::Interned>(toolContext->additionalInfoPlistContents().begin(), toolContext->additionalInfoPlistContents().end());
     invocation.logMessage() = tokens.logMessage();
     invocation.showEnvironmentInLog() = false; /* Hide build settings from log. */
     invocation.priority() = toolContext->currentPhaseInvocationPriority();
@@ -40,7 +40,7 @@ resolve(
     for (Tool::Input const &input : inputs) {
         if (input.fileType() != nullptr && input.fileType()->identifier() == "text.plist.strings") {
             /* The format here is as expected by ibtool. */
-            localizationStringsFiles.push_back(input.localization().value_or("") + ":" + input.path());
+            localizationStringsFiles.push_back(input.localization().value_or("") + ":" + input.path().raw());
         } else {
             primaryInputs.push_back(input);
         }
@@ -60,7 +60,7 @@ resolve(
      * Resolve the tool options.
      */
     Tool::Environment toolEnvironment = Tool::Environment::Create(_tool, interfaceBuilderEnvironment, toolContext->workingDirectory(), primaryInputs);
-    Tool::OptionsResult options = Tool::OptionsResult::Create(toolEnvironment, toolContext->workingDirectory(), nullptr);
+    Tool::OptionsResult options = Tool::OptionsResult::Create(toolContext->filesystem(), toolEnvironment, toolContext->workingDirectory(), nullptr);
     Tool::Tokens::ToolExpansions tokens = Tool::Tokens::ExpandTool(toolEnvironment, options);
 
     pbxsetting::Environment const &environment = toolEnvironment.environment();
@@ -95,7 +95,7 @@ resolve(
     invocation.environment() = options.environment();
     invocation.workingDirectory() = toolContext->workingDirectory();
     invocation.inputs() = toolEnvironment.inputs(toolContext->workingDirectory());
-    invocation.outputs() = outputs;
+    invocation.outputs() = std::vector<libutil::Path::Interned>(outputs.begin(), outputs.end());
     invocation.logMessage() = tokens.logMessage();
     invocation.priority() = toolContext->currentPhaseInvocationPriority();
     toolContext->invocations().push_back(invocation);
@@ -67,7 +67,9 @@ Tool::Invocation::
 Invocation() :
     _showEnvironmentInLog   (true),
     _createsProductStructure(false),
-    _waitForSwiftArtifacts  (false)
+    _waitForSwiftArtifacts  (false),
+    _priority               (0),
+    _jobserver              (false)
 {
 }
 
@@ -76,3 +78,50 @@ Tool::Invocation::
 {
 }
 
+std::unordered_map<std::string, std::string> Tool::Invocation::
+fullEnvironment() const
+{
+    if (_environmentBase == nullptr) {
+        return _environment;
+    }
+
+    /* Insert doesn't replace, so the invocation's own variables win. */
+    std::unordered_map<std::string, std::string> environment = _environment;
+    environment.insert(_environmentBase->begin(), _environmentBase->end());
+    return environment;
+}
+
+void Tool::Invocation::
+shareEnvironment(
+    std::unordered_map<std::string, std::string> const &environment,
+    std::shared_ptr<std::unordered_map<std::string, std::string> const> const &base)
+{
+    _environment.clear();
+    _environmentBase = nullptr;
+
+    if (base == nullptr) {
+        _environment = environment;
+        return;
+    }
+
+    /* Only variables that differ from the base need to be stored. */
+    size_t found = 0;
+    for (auto const &entry : environment) {
+        auto it = base->find(entry.first);
+        if (it != base->end()) {
+            found++;
+        }
+
+        if (it == base->end() || it->second != entry.second) {
+            _environment.insert(entry);
+        }
+    }
+
+    if (found == base->size()) {
+        _environmentBase = base;
+    } else {
+        /* The base has extra variables; there's no way to unset them. */
+        _environment = environment;
+    }
+}
+
@@ -80,13 +80,13 @@ AddOptionArgumentValue(std::vector<std::string> *arguments, pbxsetting::Environm
 }
 
 static void
-AddOptionArgumentValues(std::vector<std::string> *arguments, pbxsetting::Environment const &environment, std::string const &workingDirectory, std::vector<pbxsetting::Value> const &args, pbxspec::PBX::PropertyOption::shared_ptr const &option)
+AddOptionArgumentValues(libutil::Filesystem const *filesystem, std::vector<std::string> *arguments, pbxsetting::Environment const &environment, std::string const &workingDirectory, std::vector<pbxsetting::Value> const &args, pbxspec::PBX::PropertyOption::shared_ptr const &option)
 {
     if ((option->type() == "StringList" || option->type() == "stringlist") ||
         (option->type() == "PathList" || option->type() == "pathlist")) {
         std::vector<std::string> values = pbxsetting::Type::ParseList(environment.resolve(option->name()));
         if (option->flattenRecursiveSearchPathsInValue()) {
-            values = Tool::SearchPaths::ExpandRecursive(values, environment, workingDirectory);
+            values = Tool::SearchPaths::ExpandRecursive(filesystem, values, environment, workingDirectory);
         }
 
         for (std::string const &value : values) {
@@ -111,7 +111,7 @@ ArgumentValuesFromArray(plist::Array const *args)
 }
 
 static void
-AddOptionValuesArguments(std::vector<std::string> *arguments, pbxsetting::Environment const &environment, std::string const &workingDirectory, plist::Array const *values, std::string const &value, pbxspec::PBX::PropertyOption::shared_ptr const &option)
+AddOptionValuesArguments(libutil::Filesystem const *filesystem, std::vector<std::string> *arguments, pbxsetting::Environment const &environment, std::string const &workingDirectory, plist::Array const *values, std::string const &value, pbxspec::PBX::PropertyOption::shared_ptr const &option)
 {
     if (values == nullptr) {
         return;
@@ -128,10 +128,10 @@ AddOptionValuesArguments(std::vector<std::string> *arguments, pbxsetting::Enviro
                 if (entryValue->value() == value) {
                     if (auto entryFlag = entry->value <plist::String> ("CommandLineFlag")) {
                         std::vector<pbxsetting::Value> argsValues = { pbxsetting::Value::Parse(entryFlag->value()) };
-                        AddOptionArgumentValues(arguments, environment, workingDirectory, argsValues, option);
+                        AddOptionArgumentValues(filesystem, arguments, environment, workingDirectory, argsValues, option);
                     } else if (auto entryArgs = entry->value <plist::Array> ("CommandLineArgs")) {
                         std::vector<pbxsetting::Value> argsValues = ArgumentValuesFromArray(entryArgs);
-                        AddOptionArgumentValues(arguments, environment, workingDirectory, argsValues, option);
+                        AddOptionArgumentValues(filesystem, arguments, environment, workingDirectory, argsValues, option);
                     }
                 }
             }
@@ -140,7 +140,7 @@ AddOptionValuesArguments(std::vector<std::string> *arguments, pbxsetting::Enviro
 }
 
 static void
-AddOptionArgsArguments(std::vector<std::string> *arguments, pbxsetting::Environment const &environment, std::string const &workingDirectory, plist::Object const *argsValue, std::string const &value, pbxspec::PBX::PropertyOption::shared_ptr const &option)
+AddOptionArgsArguments(libutil::Filesystem const *filesystem, std::vector<std::string> *arguments, pbxsetting::Environment const &environment, std::string const &workingDirectory, plist::Object const *argsValue, std::string const &value, pbxspec::PBX::PropertyOption::shared_ptr const &option)
 {
     /*
      * `CommandLineArgs` and `AdditionalLinkerArgs` are either arrays of arguments or dictionaries
@@ -149,20 +149,21 @@ AddOptionArgsArguments(std::vector<std::string> *arguments, pbxsetting::Environm
 
     if (auto args = plist::CastTo <plist::Array> (argsValue)) {
         std::vector<pbxsetting::Value> argsValues = ArgumentValuesFromArray(args);
-        AddOptionArgumentValues(arguments, environment, workingDirectory, argsValues, option);
+        AddOptionArgumentValues(filesystem, arguments, environment, workingDirectory, argsValues, option);
     } else if (auto argsValues = plist::CastTo <plist::Dictionary> (argsValue)) {
         if (auto args = argsValues->value <plist::Array> (value)) {
             std::vector<pbxsetting::Value> argsValues = ArgumentValuesFromArray(args);
-            AddOptionArgumentValues(arguments, environment, workingDirectory, argsValues, option);
+            AddOptionArgumentValues(filesystem, arguments, environment, workingDirectory, argsValues, option);
         } else if (auto args = argsValues->value <plist::Array> ("<<otherwise>>")) {
             std::vector<pbxsetting::Value> argsValues = ArgumentValuesFromArray(args);
-            AddOptionArgumentValues(arguments, environment, workingDirectory, argsValues, option);
+            AddOptionArgumentValues(filesystem, arguments, environment, workingDirectory, argsValues, option);
         }
     }
 }
 
 Tool::OptionsResult Tool::OptionsResult::
 Create(
+    libutil::Filesystem const *filesystem,
     pbxsetting::Environment const &environment,
     std::string const &workingDirectory,
     std::vector<pbxspec::PBX::PropertyOption::shared_ptr> const &options,
@@ -213,25 +214,25 @@ Create(
 
                     /* Pass both the command line flag and the option value itself. */
                     std::vector<pbxsetting::Value> values = { flag, pbxsetting::Value::Variable("value") };
-                    AddOptionArgumentValues(&arguments, environment, workingDirectory, values, option);
+                    AddOptionArgumentValues(filesystem, &arguments, environment, workingDirectory, values, option);
                 }
             }
         }
 
-        AddOptionValuesArguments(&arguments, environment, workingDirectory, plist::CastTo<plist::Array>(option->values()), value, option);
-        AddOptionValuesArguments(&arguments, environment, workingDirectory, plist::CastTo<plist::Array>(option->allowedValues()), value, option);
+        AddOptionValuesArguments(filesystem, &arguments, environment, workingDirectory, plist::CastTo<plist::Array>(option->values()), value, option);
+        AddOptionValuesArguments(filesystem, &arguments, environment, workingDirectory, plist::CastTo<plist::Array>(option->allowedValues()), value, option);
 
         if (!value.empty()) {
             /* Pass the prefix then the option value in the same argument. */
             if (option->commandLinePrefixFlag()) {
                 pbxsetting::Value const &prefix = *option->commandLinePrefixFlag();
                 pbxsetting::Value prefixValue = prefix + pbxsetting::Value::Variable("value");
-                AddOptionArgumentValues(&arguments, environment, workingDirectory, { prefixValue }, option);
+                AddOptionArgumentValues(filesystem, &arguments, environment, workingDirectory, { prefixValue }, option);
             }
         }
 
-        AddOptionArgsArguments(&arguments, environment, workingDirectory, option->commandLineArgs(), value, option);
-        AddOptionArgsArguments(&linkerArgs, environment, workingDirectory, option->additionalLinkerArgs(), value, option);
+        AddOptionArgsArguments(filesystem, &arguments, environment, workingDirectory, option->commandLineArgs(), value, option);
+        AddOptionArgsArguments(filesystem, &linkerArgs, environment, workingDirectory, option->additionalLinkerArgs(), value, option);
 
         if (option->setValueInEnvironmentVariable()) {
             std::string const &variable = environment.expand(*option->setValueInEnvironmentVariable());
@@ -249,11 +250,13 @@ Create(
 
 Tool::OptionsResult Tool::OptionsResult::
 Create(
+    libutil::Filesystem const *filesystem,
     Tool::Environment const &toolEnvironment,
     std::string const &workingDirectory,
     pbxspec::PBX::FileType::shared_ptr const &fileType)
 {
     Tool::OptionsResult optionsResult = Create(
+        filesystem,
         toolEnvironment.environment(),
         workingDirectory,
         toolEnvironment.tool()->options().value_or(pbxspec::PBX::PropertyOption::vector()),
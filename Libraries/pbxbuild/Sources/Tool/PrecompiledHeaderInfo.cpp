@@ -9,15 +9,12 @@
 
 #include <pbxbuild/Tool/PrecompiledHeaderInfo.h>
 #include <libutil/FSUtil.h>
-#include <libutil/Wildcard.h>
-#include <libutil/md5.h>
-
-#include <sstream>
-#include <iomanip>
+#include <libutil/WildcardSet.h>
+#include <libutil/Hash.h>
 
 namespace Tool = pbxbuild::Tool;
 using libutil::FSUtil;
-using libutil::Wildcard;
+using libutil::WildcardSet;
 
 Tool::PrecompiledHeaderInfo::
 PrecompiledHeaderInfo(std::string const &prefixHeader, pbxspec::PBX::FileType::shared_ptr const &fileType, std::vector<std::string> const &arguments, std::vector<std::string> const &relevantArguments) :
@@ -56,20 +53,7 @@ std::string Tool::PrecompiledHeaderInfo::
 hash() const
 {
     // TODO(grp): Generate this hash properly.
-    std::vector<uint8_t> content = serialize();
-
-    md5_state_t state;
-    md5_init(&state);
-    md5_append(&state, reinterpret_cast<const md5_byte_t *>(content.data()), content.size());
-    uint8_t digest[16];
-    md5_finish(&state, reinterpret_cast<md5_byte_t *>(&digest));
-
-    std::ostringstream ss;
-    ss << std::hex << std::setfill('0');
-    for (uint8_t c : digest) {
-        ss << std::setw(2) << static_cast<int>(c);
-    }
-    return ss.str();
+    return libutil::Hash::Data(serialize()).hex();
 }
 
 std::vector<uint8_t> Tool::PrecompiledHeaderInfo::
@@ -92,18 +76,14 @@ serialize() const
 Tool::PrecompiledHeaderInfo Tool::PrecompiledHeaderInfo::
 Create(pbxspec::PBX::Compiler::shared_ptr const &compiler, std::string const &prefixHeader, pbxspec::PBX::FileType::shared_ptr const &fileType, std::vector<std::string> const &arguments)
 {
+    ext::optional<WildcardSet> ignored;
+    if (compiler->patternsOfFlagsNotAffectingPrecomps()) {
+        ignored = WildcardSet(*compiler->patternsOfFlagsNotAffectingPrecomps());
+    }
+
     std::vector<std::string> relevantArguments;
     for (std::string const &argument : arguments) {
-        bool ignore = false;
-        if (compiler->patternsOfFlagsNotAffectingPrecomps()) {
-            for (std::string const &pattern : *compiler->patternsOfFlagsNotAffectingPrecomps()) {
-                if (Wildcard::Match(pattern, argument)) {
-                    ignore = true;
-                    break;
-                }
-            }
-        }
-
+        bool ignore = (ignored && ignored->match(argument));
         if (!ignore) {
             relevantArguments.push_back(argument);
         }
@@ -53,6 +53,60 @@ ScriptInputOutputLevel(std::vector<std::string> const &inputFiles, std::vector<s
     return pbxsetting::Level(settings);
 }
 
+/*
+ * Scripts get every build setting in their environment, and most are the
+ * same for each script in a target. Those are computed once, from the
+ * target's settings, and shared between the invocations. Each invocation
+ * only computes what can differ: settings for its variant and architecture,
+ * computed once for each, and its own script settings.
+ */
+static void
+ScriptShareEnvironment(
+    Tool::Context *toolContext,
+    pbxsetting::Environment const &environment,
+    pbxsetting::Environment const &scriptEnvironment,
+    std::vector<pbxsetting::Level> const &scriptLevels,
+    Tool::Invocation *invocation)
+{
+    std::shared_ptr<std::unordered_map<std::string, std::string> const> const &base = toolContext->scriptEnvironmentBase();
+    if (base == nullptr) {
+        invocation->environment() = scriptEnvironment.computeValues(pbxsetting::Condition::Empty());
+        invocation->environmentBase() = nullptr;
+        return;
+    }
+
+    std::unordered_map<std::string, std::string> values;
+
+    auto baseVariant = base->find("variant");
+    auto baseArch = base->find("arch");
+    std::pair<std::string, std::string> variantArchitecture = std::make_pair(environment.resolve("variant"), environment.resolve("arch"));
+    if ((baseVariant != base->end() ? baseVariant->second : std::string()) != variantArchitecture.first ||
+        (baseArch != base->end() ? baseArch->second : std::string()) != variantArchitecture.second) {
+        auto &variantArchitectureValues = toolContext->scriptEnvironmentVariantArchitectureValues();
+        auto it = variantArchitectureValues.find(variantArchitecture);
+        if (it == variantArchitectureValues.end()) {
+            std::unordered_map<std::string, std::string> differences;
+            for (auto const &entry : environment.computeValues(pbxsetting::Condition::Empty())) {
+                auto baseEntry = base->find(entry.first);
+                if (baseEntry == base->end() || baseEntry->second != entry.second) {
+                    differences.insert(entry);
+                }
+            }
+            it = variantArchitectureValues.insert({ variantArchitecture, differences }).first;
+        }
+        values = it->second;
+    }
+
+    for (pbxsetting::Level const &level : scriptLevels) {
+        for (pbxsetting::Setting const &setting : level.settings()) {
+            values[setting.name()] = scriptEnvironment.resolve(setting.name());
+        }
+    }
+
+    invocation->environment() = values;
+    invocation->environmentBase() = base;
+}
+
 void Tool::ScriptResolver::
 resolve(
     Tool::Context *toolContext,
@@ -63,20 +117,18 @@ resolve(
 
     std::string script = environment.expand(legacyTarget->buildArgumentsString());
 
-    std::unordered_map<std::string, std::string> environmentVariables;
-    if (legacyTarget->passBuildSettingsInEnvironment()) {
-        environmentVariables = environment.computeValues(pbxsetting::Condition::Empty());
-    }
-
     std::string fullWorkingDirectory = FSUtil::ResolveRelativePath(legacyTarget->buildWorkingDirectory(), toolContext->workingDirectory());
 
     Tool::Invocation invocation;
     invocation.executable() = Tool::Invocation::Executable::Determine(legacyTarget->buildToolPath());
     invocation.arguments() = pbxsetting::Type::ParseList(script);
-    invocation.environment() = environmentVariables;
+    if (legacyTarget->passBuildSettingsInEnvironment()) {
+        ScriptShareEnvironment(toolContext, environment, environment, { }, &invocation);
+    }
     invocation.workingDirectory() = fullWorkingDirectory;
     invocation.logMessage() = logMessage;
     invocation.priority() = toolContext->currentPhaseInvocationPriority();
+    invocation.jobserver() = true;
     toolContext->invocations().push_back(invocation);
 }
 
@@ -113,20 +165,21 @@ resolve(
     std::string contents = (!buildPhase->shellPath().empty() ? "#!" + buildPhase->shellPath() + "\n" : "") + buildPhase->shellScript();
     auto scriptFile = Tool::AuxiliaryFile::Data(scriptFilePath, std::vector<uint8_t>(contents.begin(), contents.end()), true);
 
+    pbxsetting::Level scriptLevel = ScriptInputOutputLevel(inputFiles, outputFiles, true);
     pbxsetting::Environment scriptEnvironment = pbxsetting::Environment(environment);
-    scriptEnvironment.insertFront(ScriptInputOutputLevel(inputFiles, outputFiles, true), false);
-    std::unordered_map<std::string, std::string> environmentVariables = scriptEnvironment.computeValues(pbxsetting::Condition::Empty());
+    scriptEnvironment.insertFront(scriptLevel, false);
 
     Tool::Invocation invocation;
     invocation.executable() = Tool::Invocation::Executable::External("/bin/sh");
     invocation.arguments() = { "-c", Escape::Shell(scriptFilePath) };
-    invocation.environment() = environmentVariables;
+    ScriptShareEnvironment(toolContext, environment, scriptEnvironment, { scriptLevel }, &invocation);
     invocation.workingDirectory() = toolContext->workingDirectory();
-    invocation.phonyInputs() = inputFiles; /* User-specified, may not exist. */
-    invocation.outputs() = outputFiles;
+    invocation.phonyInputs() = std::vector<libutil::Path::Interned>(inputFiles.begin(), inputFiles.end()); /* User-specified, may not exist. */
+    invocation.outputs() = std::vector<libutil::Path::Interned>(outputFiles.begin(), outputFiles.end());
     invocation.logMessage() = phaseEnvironment.expand(logMessage);
     invocation.showEnvironmentInLog() = buildPhase->showEnvVarsInLog();
     invocation.priority() = toolContext->currentPhaseInvocationPriority();
+    invocation.jobserver() = true;
     toolContext->invocations().push_back(invocation);
 
     toolContext->auxiliaryFiles().push_back(scriptFile);
@@ -178,16 +231,16 @@ resolve(
     /*
      * Compute the final environment by adding the standard script levels.
      */
-    ruleEnvironment.insertFront(ScriptInputOutputLevel({ inputAbsolutePath }, outputFiles, false), false);
-    std::unordered_map<std::string, std::string> environmentVariables = ruleEnvironment.computeValues(pbxsetting::Condition::Empty());
+    pbxsetting::Level scriptLevel = ScriptInputOutputLevel({ inputAbsolutePath }, outputFiles, false);
+    ruleEnvironment.insertFront(scriptLevel, false);
 
     Tool::Invocation invocation;
     invocation.executable() = Tool::Invocation::Executable::External("/bin/sh");
     invocation.arguments() = { "-c", buildRule->script() };
-    invocation.environment() = environmentVariables;
+    ScriptShareEnvironment(toolContext, environment, ruleEnvironment, { level, scriptLevel }, &invocation);
     invocation.workingDirectory() = toolContext->workingDirectory();
     invocation.inputs() = { inputAbsolutePath };
-    invocation.outputs() = outputFiles;
+    invocation.outputs() = std::vector<libutil::Path::Interned>(outputFiles.begin(), outputFiles.end());
     invocation.logMessage() = ruleEnvironment.expand(logMessage);
     invocation.showEnvironmentInLog() = true;
     invocation.priority() = toolContext->currentPhaseInvocationPriority();
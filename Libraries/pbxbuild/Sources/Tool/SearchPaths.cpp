@@ -32,10 +32,8 @@ SearchPaths(
 }
 
 static void
-AppendPaths(std::vector<std::string> *args, pbxsetting::Environment const &environment, std::string const &workingDirectory, std::vector<std::string> const &paths)
+AppendPaths(Filesystem const *filesystem, std::vector<std::string> *args, pbxsetting::Environment const &environment, std::string const &workingDirectory, std::vector<std::string> const &paths)
 {
-    Filesystem const *filesystem = Filesystem::GetDefaultUNSAFE();
-
     for (std::string path : paths) {
         // TODO(grp): Is this the right place to insert the SDKROOT? Should all path lists have this, or just *_SEARCH_PATHS?
         std::string const system = "/System";
@@ -56,14 +54,13 @@ AppendPaths(std::vector<std::string> *args, pbxsetting::Environment const &envir
             args->push_back(root);
 
             std::string absoluteRoot = FSUtil::ResolveRelativePath(root, workingDirectory);
-            filesystem->readDirectory(absoluteRoot, true, [&](std::string const &relative) -> bool {
+            filesystem->walkDirectory(absoluteRoot, true, [&](std::string const &relative, Filesystem::Type type) -> bool {
                 // TODO(grp): Use build settings for included and excluded recursive paths.
                 // Included: INCLUDED_RECURSIVE_SEARCH_PATH_SUBDIRECTORIES
                 // Excluded: EXCLUDED_RECURSIVE_SEARCH_PATH_SUBDIRECTORIES
                 // Follow: RECURSIVE_SEARCH_PATHS_FOLLOW_SYMLINKS
 
-                std::string absolute = absoluteRoot + "/" + relative;
-                if (filesystem->type(absolute) == Filesystem::Type::Directory) {
+                if (type == Filesystem::Type::Directory) {
                     args->push_back(root + "/" + relative);
                 }
                 return true;
@@ -75,29 +72,29 @@ AppendPaths(std::vector<std::string> *args, pbxsetting::Environment const &envir
 }
 
 std::vector<std::string> Tool::SearchPaths::
-ExpandRecursive(std::vector<std::string> const &paths, pbxsetting::Environment const &environment, std::string const &workingDirectory)
+ExpandRecursive(Filesystem const *filesystem, std::vector<std::string> const &paths, pbxsetting::Environment const &environment, std::string const &workingDirectory)
 {
     std::vector<std::string> result;
-    AppendPaths(&result, environment, workingDirectory, paths);
+    AppendPaths(filesystem, &result, environment, workingDirectory, paths);
     return result;
 }
 
 Tool::SearchPaths Tool::SearchPaths::
-Create(pbxsetting::Environment const &environment, std::string const &workingDirectory)
+Create(Filesystem const *filesystem, pbxsetting::Environment const &environment, std::string const &workingDirectory)
 {
     std::vector<std::string> headerSearchPaths;
-    AppendPaths(&headerSearchPaths, environment, workingDirectory, pbxsetting::Type::ParseList(environment.resolve("PRODUCT_TYPE_HEADER_SEARCH_PATHS")));
-    AppendPaths(&headerSearchPaths, environment, workingDirectory, pbxsetting::Type::ParseList(environment.resolve("HEADER_SEARCH_PATHS")));
+    AppendPaths(filesystem, &headerSearchPaths, environment, workingDirectory, pbxsetting::Type::ParseList(environment.resolve("PRODUCT_TYPE_HEADER_SEARCH_PATHS")));
+    AppendPaths(filesystem, &headerSearchPaths, environment, workingDirectory, pbxsetting::Type::ParseList(environment.resolve("HEADER_SEARCH_PATHS")));
 
     std::vector<std::string> userHeaderSearchPaths;
-    AppendPaths(&userHeaderSearchPaths, environment, workingDirectory, pbxsetting::Type::ParseList(environment.resolve("USER_HEADER_SEARCH_PATHS")));
+    AppendPaths(filesystem, &userHeaderSearchPaths, environment, workingDirectory, pbxsetting::Type::ParseList(environment.resolve("USER_HEADER_SEARCH_PATHS")));
 
     std::vector<std::string> frameworkSearchPaths;
-    AppendPaths(&frameworkSearchPaths, environment, workingDirectory, pbxsetting::Type::ParseList(environment.resolve("FRAMEWORK_SEARCH_PATHS")));
-    AppendPaths(&frameworkSearchPaths, environment, workingDirectory, pbxsetting::Type::ParseList(environment.resolve("PRODUCT_TYPE_FRAMEWORK_SEARCH_PATHS")));
+    AppendPaths(filesystem, &frameworkSearchPaths, environment, workingDirectory, pbxsetting::Type::ParseList(environment.resolve("FRAMEWORK_SEARCH_PATHS")));
+    AppendPaths(filesystem, &frameworkSearchPaths, environment, workingDirectory, pbxsetting::Type::ParseList(environment.resolve("PRODUCT_TYPE_FRAMEWORK_SEARCH_PATHS")));
 
     std::vector<std::string> librarySearchPaths;
-    AppendPaths(&librarySearchPaths, environment, workingDirectory, pbxsetting::Type::ParseList(environment.resolve("LIBRARY_SEARCH_PATHS")));
+    AppendPaths(filesystem, &librarySearchPaths, environment, workingDirectory, pbxsetting::Type::ParseList(environment.resolve("LIBRARY_SEARCH_PATHS")));
 
     return Tool::SearchPaths(headerSearchPaths, userHeaderSearchPaths, frameworkSearchPaths, librarySearchPaths);
 }
@@ -34,7 +34,7 @@ SwiftResolver(pbxspec::PBX::Compiler::shared_ptr const &compiler) :
 }
 
 static std::string
-SwiftLibraryPath(pbxsetting::Environment const &environment, xcsdk::SDK::Target::shared_ptr const &sdk, std::vector<xcsdk::SDK::Toolchain::shared_ptr> const &toolchains)
+SwiftLibraryPath(Filesystem const *filesystem, pbxsetting::Environment const &environment, xcsdk::SDK::Target::shared_ptr const &sdk, std::vector<xcsdk::SDK::Toolchain::shared_ptr> const &toolchains)
 {
     std::string path = environment.resolve("SWIFT_LIBRARY_PATH");
     if (!path.empty()) {
@@ -62,7 +62,7 @@ SwiftLibraryPath(pbxsetting::Environment const &environment, xcsdk::SDK::Target:
             std::string path = toolchain->path() + "/" + "usr" + "/" + "lib" + "/" + subpath;
 
             /* If the Swift library exists, return the directory containing it. */
-            if (Filesystem::GetDefaultUNSAFE()->exists(path)) {
+            if (filesystem->exists(path)) {
                 return FSUtil::GetDirectoryName(path);
             }
         }
@@ -313,7 +313,7 @@ resolve(
      * Resolve the tool options.
      */
     Tool::Environment toolEnvironment = Tool::Environment::Create(_compiler, baseEnvironment, toolContext->workingDirectory(), inputs);
-    Tool::OptionsResult options = Tool::OptionsResult::Create(toolEnvironment, toolContext->workingDirectory(), nullptr);
+    Tool::OptionsResult options = Tool::OptionsResult::Create(toolContext->filesystem(), toolEnvironment, toolContext->workingDirectory(), nullptr);
     Tool::Tokens::ToolExpansions tokens = Tool::Tokens::ExpandTool(toolEnvironment, options);
 
     pbxsetting::Environment const &environment = toolEnvironment.environment();
@@ -401,7 +401,7 @@ resolve(
     invocation.environment() = options.environment();
     invocation.workingDirectory() = toolContext->workingDirectory();
     invocation.inputs() = toolEnvironment.inputs(toolContext->workingDirectory());
-    invocation.outputs() = outputs;
+    invocation.outputs() = std::vector<libutil::Path::Interned>(outputs.begin(), outputs.end());
     invocation.dependencyInfo() = dependencyInfo;
     invocation.logMessage() = logMessage;
     invocation.priority() = toolContext->currentPhaseInvocationPriority();
@@ -440,7 +440,7 @@ resolve(
     // TODO(grp): For multi-arch builds the below flags get added twice.
 
     /* Add Swift libraries to linker arguments. */
-    std::string swiftLibraryPath = SwiftLibraryPath(environment, toolContext->sdk(), toolContext->toolchains());
+    std::string swiftLibraryPath = SwiftLibraryPath(toolContext->filesystem(), environment, toolContext->sdk(), toolContext->toolchains());
     if (!swiftLibraryPath.empty()) {
         compilationInfo->linkerArguments().push_back("-L" + swiftLibraryPath);
     } else {
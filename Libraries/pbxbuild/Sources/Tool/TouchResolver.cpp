@@ -36,7 +36,7 @@ resolve(
     /* Treat the input as an output since it's what gets modified by the touch. */
     std::string output = FSUtil::ResolveRelativePath(input, toolContext->workingDirectory());
 
-    std::vector<std::string> inputDependencies;
+    std::vector<libutil::Path::Interned> inputDependencies;
     for (std::string const &dependency : dependencies) {
         inputDependencies.push_back(FSUtil::ResolveRelativePath(dependency, toolContext->workingDirectory()));
     }
@@ -12,6 +12,7 @@
 #include <pbxsetting/Environment.h>
 #include <pbxsetting/Level.h>
 #include <pbxsetting/Setting.h>
+#include <libutil/MemoryFilesystem.h>
 #include <plist/Dictionary.h>
 #include <plist/Format/ASCII.h>
 #include <plist/Format/Encoding.h>
@@ -56,6 +57,9 @@ Environment(std::vector<pbxsetting::Setting> const &settings)
     return environment;
 }
 
+/* Default filesystem, empty. */
+static libutil::MemoryFilesystem const Filesystem = libutil::MemoryFilesystem({ });
+
 /* Default working directory. */
 static std::string const WorkingDirectory = "";
 
@@ -107,7 +111,7 @@ TEST(OptionsResult, Boolean)
         pbxsetting::Setting::Create("FLAG", "flag"),
     });
 
-    auto result = Tool::OptionsResult::Create(environment, WorkingDirectory, options, FileType);
+    auto result = Tool::OptionsResult::Create(&Filesystem, environment, WorkingDirectory, options, FileType);
     EXPECT_EQ(result.arguments(), std::vector<std::string>({
         "true",
         "lower",
@@ -176,7 +180,7 @@ TEST(OptionsResult, String)
         pbxsetting::Setting::Create("FLAG", "flag"),
     });
 
-    auto result = Tool::OptionsResult::Create(environment, WorkingDirectory, options, FileType);
+    auto result = Tool::OptionsResult::Create(&Filesystem, environment, WorkingDirectory, options, FileType);
     EXPECT_EQ(result.arguments(), std::vector<std::string>({
         "--string-normal", "string-normal",
         "--string-lower", "string-lower",
@@ -229,7 +233,7 @@ TEST(OptionsResult, StringList)
         pbxsetting::Setting::Create("STRINGLIST_EMPTY", ""),
     });
 
-    auto result = Tool::OptionsResult::Create(environment, WorkingDirectory, options, FileType);
+    auto result = Tool::OptionsResult::Create(&Filesystem, environment, WorkingDirectory, options, FileType);
     EXPECT_EQ(result.arguments(), std::vector<std::string>({
         "--stringlist-normal", "stringlist-normal1", "--stringlist-normal", "stringlist-normal2",
         "--stringlist-lower", "stringlist-lower1", "--stringlist-lower", "stringlist-lower2",
@@ -280,7 +284,7 @@ TEST(OptionsResult, FlagIfFalse)
         pbxsetting::Setting::Create("FLAG", "flag"),
     });
 
-    auto result = Tool::OptionsResult::Create(environment, WorkingDirectory, options, FileType);
+    auto result = Tool::OptionsResult::Create(&Filesystem, environment, WorkingDirectory, options, FileType);
     EXPECT_EQ(result.arguments(), std::vector<std::string>({
         "false",
         "expand-flag",
@@ -337,7 +341,7 @@ TEST(OptionsResult, PrefixFlag)
         pbxsetting::Setting::Create("FLAG", "flag"),
     });
 
-    auto result = Tool::OptionsResult::Create(environment, WorkingDirectory, options, FileType);
+    auto result = Tool::OptionsResult::Create(&Filesystem, environment, WorkingDirectory, options, FileType);
     EXPECT_EQ(result.arguments(), std::vector<std::string>({
         "--prefix=prefix",
         "empty-prefix",
@@ -390,7 +394,7 @@ TEST(OptionsResult, CommandLineArgsArray)
         pbxsetting::Setting::Create("FLAG", "flag"),
     });
 
-    auto result = Tool::OptionsResult::Create(environment, WorkingDirectory, options, FileType);
+    auto result = Tool::OptionsResult::Create(&Filesystem, environment, WorkingDirectory, options, FileType);
     EXPECT_EQ(result.arguments(), std::vector<std::string>({
         "yes", "yes-YES",
         "no", "no-NO",
@@ -449,7 +453,7 @@ TEST(OptionsResult, CommandLineArgsDictionary)
         pbxsetting::Setting::Create("FLAG", "flag"),
     });
 
-    auto result = Tool::OptionsResult::Create(environment, WorkingDirectory, options, FileType);
+    auto result = Tool::OptionsResult::Create(&Filesystem, environment, WorkingDirectory, options, FileType);
     EXPECT_EQ(result.arguments(), std::vector<std::string>({
         "yes", "yes-flag",
         "value", "value-flag",
@@ -505,7 +509,7 @@ TEST(OptionsResult, ValuesArguments)
         pbxsetting::Setting::Create("ALLOWED_VALUES_FLAG", "flag"),
     });
 
-    auto result = Tool::OptionsResult::Create(environment, WorkingDirectory, options, FileType);
+    auto result = Tool::OptionsResult::Create(&Filesystem, environment, WorkingDirectory, options, FileType);
     EXPECT_EQ(result.arguments(), std::vector<std::string>({
         "array", "array-array",
         "flag-flag",
@@ -549,7 +553,7 @@ TEST(OptionsResult, AdditionalLinkerArgs)
         pbxsetting::Setting::Create("ARGS_DICT_DICT_INVALID", "other"),
     });
 
-    auto result = Tool::OptionsResult::Create(environment, WorkingDirectory, options, FileType);
+    auto result = Tool::OptionsResult::Create(&Filesystem, environment, WorkingDirectory, options, FileType);
     EXPECT_EQ(result.linkerArgs(), std::vector<std::string>({
         "array",
         "value", "value-value",
@@ -588,7 +592,7 @@ TEST(OptionsResult, EnvironmentVariables)
         pbxsetting::Setting::Create("ENVIRONMENT_VARIABLE_EMPTY", ""),
     });
 
-    auto result = Tool::OptionsResult::Create(environment, WorkingDirectory, options, FileType);
+    auto result = Tool::OptionsResult::Create(&Filesystem, environment, WorkingDirectory, options, FileType);
     std::unordered_map<std::string, std::string> expectedEnvironmentVariables = {
         { "DIRECT", "direct" },
         { "INDIRECT", "indirect" },
@@ -626,7 +630,7 @@ TEST(OptionsResult, Architectures)
         pbxsetting::Setting::Create("arch", "armv7"),
     });
 
-    auto result = Tool::OptionsResult::Create(environment, WorkingDirectory, options, FileType);
+    auto result = Tool::OptionsResult::Create(&Filesystem, environment, WorkingDirectory, options, FileType);
     EXPECT_EQ(result.arguments(), std::vector<std::string>({
         "arm",
     }));
@@ -0,0 +1,90 @@
+/**
+ Copyright (c) 2015-present, Facebook, Inc.
+ All rights reserved.
+
+ This source code is licensed under the BSD-style license found in the
+ LICENSE file in the root directory of this source tree. An additional grant
+ of patent rights can be found in the PATENTS file in the same directory.
+ */
+
+#include <gtest/gtest.h>
+#include <pbxbuild/Tool/ScriptResolver.h>
+#include <pbxbuild/Tool/Context.h>
+#include <pbxbuild/Phase/Environment.h>
+#include <pbxspec/Manager.h>
+#include <pbxsetting/Environment.h>
+#include <pbxsetting/Level.h>
+#include <pbxsetting/Setting.h>
+#include <libutil/MemoryFilesystem.h>
+
+namespace Tool = pbxbuild::Tool;
+using libutil::MemoryFilesystem;
+
+static std::vector<uint8_t>
+Contents(std::string const &string)
+{
+    return std::vector<uint8_t>(string.begin(), string.end());
+}
+
+TEST(ScriptResolver, ArchitectureEnvironments)
+{
+    auto filesystem = MemoryFilesystem({
+        MemoryFilesystem::Entry::Directory("Specifications", {
+            MemoryFilesystem::Entry::File("Script.xcspec", Contents("{ Type = Tool; Identifier = com.apple.commands.shell-script; Name = \"Shell Script\"; }")),
+        }),
+    });
+
+    auto specManager = pbxspec::Manager::Create();
+    specManager->registerDomains(&filesystem, { { "test", filesystem.path("Specifications") } });
+    std::unique_ptr<Tool::ScriptResolver> scriptResolver = Tool::ScriptResolver::Create(specManager, { "test" });
+    ASSERT_NE(nullptr, scriptResolver);
+
+    pbxsetting::Environment targetEnvironment;
+    targetEnvironment.insertFront(pbxsetting::Level({
+        pbxsetting::Setting::Create("TARGET_NAME", "Target"),
+        pbxsetting::Setting::Create("arch", "undefined_arch"),
+        pbxsetting::Setting::Parse("OBJECT_FILE_DIR_normal", "/build/$(TARGET_NAME).build/Objects-normal"),
+    }), false);
+
+    /* The base is computed once for the target, as `Phase::Context` does. */
+    Tool::Context toolContext = Tool::Context(&filesystem, nullptr, { }, filesystem.path(""), Tool::SearchPaths({ }, { }, { }, { }));
+    toolContext.scriptEnvironmentBase() = std::make_shared<std::unordered_map<std::string, std::string> const>(targetEnvironment.computeValues(pbxsetting::Condition::Empty()));
+
+    auto buildRule = std::make_shared<pbxbuild::Target::BuildRules::BuildRule>(
+        "*.in",
+        pbxspec::PBX::FileType::vector(),
+        nullptr,
+        "cp \"$INPUT_FILE_PATH\" \"$SCRIPT_OUTPUT_FILE_0\"",
+        std::vector<pbxsetting::Value>({ pbxsetting::Value::Parse("$(OBJECT_FILE_DIR_normal)/$(arch)/$(INPUT_FILE_BASE).out") }));
+    Tool::Input input = Tool::Input(filesystem.path("file.in"), nullptr, buildRule, ext::nullopt, ext::nullopt, ext::nullopt, ext::nullopt, ext::nullopt);
+
+    std::vector<std::string> const architectures = { "x86_64", "arm64" };
+    for (std::string const &arch : architectures) {
+        pbxsetting::Environment environment = pbxsetting::Environment(targetEnvironment);
+        environment.insertFront(pbxbuild::Phase::Environment::VariantLevel("normal"), false);
+        environment.insertFront(pbxbuild::Phase::Environment::ArchitectureLevel(arch), false);
+        scriptResolver->resolve(&toolContext, environment, input);
+    }
+
+    /* Both architectures share the target's base, and only store their own settings. */
+    ASSERT_EQ(2, toolContext.invocations().size());
+    for (size_t i = 0; i < architectures.size(); i++) {
+        Tool::Invocation const &invocation = toolContext.invocations()[i];
+        EXPECT_EQ(toolContext.scriptEnvironmentBase(), invocation.environmentBase());
+        EXPECT_EQ(0, invocation.environment().count("TARGET_NAME"));
+
+        std::unordered_map<std::string, std::string> environment = invocation.fullEnvironment();
+        EXPECT_EQ("Target", environment["TARGET_NAME"]);
+        EXPECT_EQ(architectures[i], environment["arch"]);
+        EXPECT_EQ(architectures[i], environment["CURRENT_ARCH"]);
+        EXPECT_EQ("normal", environment["variant"]);
+        EXPECT_EQ(filesystem.path("file.in"), environment["INPUT_FILE_PATH"]);
+        EXPECT_EQ("file", environment["INPUT_FILE_BASE"]);
+        EXPECT_EQ("/build/Target.build/Objects-normal/" + architectures[i] + "/file.out", environment["SCRIPT_OUTPUT_FILE_0"]);
+    }
+
+    /* The base is not specific to either architecture. */
+    EXPECT_EQ("undefined_arch", toolContext.scriptEnvironmentBase()->at("arch"));
+    EXPECT_EQ(0, toolContext.scriptEnvironmentBase()->count("INPUT_FILE_PATH"));
+    EXPECT_EQ(2, toolContext.scriptEnvironmentVariantArchitectureValues().size());
+}
@@ -12,6 +12,7 @@
 #include <pbxproj/PBX/LegacyTarget.h>
 #include <pbxproj/PBX/NativeTarget.h>
 #include <pbxproj/Context.h>
+#include <plist/Arena.h>
 #include <plist/Array.h>
 #include <plist/Boolean.h>
 #include <plist/Integer.h>
@@ -211,9 +212,14 @@ Open(Filesystem const *filesystem, std::string const &path)
     }
 
     //
-    // Parse property list
+    // Parse property list. Project files can have many thousands of objects
+    // repeating the same keys and identifiers, so allocate them together.
     //
-    auto result = plist::Format::Any::Deserialize(contents);
+    std::pair<std::unique_ptr<plist::Object>, std::string> result;
+    {
+        plist::Arena::Scope scope;
+        result = plist::Format::Any::Deserialize(contents);
+    }
     if (result.first == nullptr) {
         fprintf(stderr, "error: project file %s is not parseable: %s\n", projectFileName.c_str(), result.second.c_str());
         return nullptr;
@@ -10,15 +10,45 @@
 #ifndef __pbxsetting_Condition_h
 #define __pbxsetting_Condition_h
 
+#include <libutil/Wildcard.h>
+
 #include <string>
 #include <unordered_map>
+#include <vector>
+
+#include <cstdint>
 
 namespace pbxsetting {
 
+/*
+ * Conditions on a build setting, like `[sdk=iphoneos*,arch=arm64]`. The
+ * same type holds the concrete values conditions are matched against.
+ */
 class Condition {
-public:
+private:
+    /*
+     * The common condition keys, compared without comparing names.
+     */
+    enum class Key : uint8_t {
+        SDK,
+        Arch,
+        Variant,
+        Config,
+        Other,
+    };
+
+    /*
+     * A condition key with its value compiled as a pattern.
+     */
+    struct Clause {
+        Key               key;
+        std::string       name;
+        libutil::Wildcard wildcard;
+    };
+
 private:
     std::unordered_map<std::string, std::string> _values;
+    std::vector<Clause>                          _clauses;
 
 public:
     Condition(std::unordered_map<std::string, std::string> const &values);
@@ -32,6 +62,17 @@ public:
     values() const { return _values; }
 
 public:
+    /*
+     * If the condition has no values, so matches anything.
+     */
+    bool empty() const
+    { return _clauses.empty(); }
+
+public:
+    /*
+     * If every value in this condition, as a pattern, matches the value
+     * for the same key in the other condition. Does not allocate.
+     */
     bool
     match(Condition const &condition) const;
 
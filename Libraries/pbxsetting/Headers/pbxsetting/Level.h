@@ -14,9 +14,12 @@
 #include <pbxsetting/Setting.h>
 #include <pbxsetting/Value.h>
 
+#include <string>
+#include <unordered_map>
 #include <vector>
 #include <utility>
 #include <memory>
+#include <ext/optional>
 
 namespace pbxsetting {
 
@@ -27,7 +30,19 @@ namespace pbxsetting {
  */
 class Level {
 private:
-    std::shared_ptr<std::vector<Setting>> _settings;
+    /*
+     * The settings that could be bound for a name. Later settings
+     * override earlier ones, so conditional settings before the last
+     * unconditional setting can never be used.
+     */
+    struct Candidates {
+        ext::optional<size_t> unconditional;
+        std::vector<size_t>   conditional;
+    };
+
+private:
+    std::shared_ptr<std::vector<Setting>>                        _settings;
+    std::shared_ptr<std::unordered_map<std::string, Candidates>> _candidates;
 
 public:
     /*
@@ -50,6 +65,13 @@ public:
      */
     std::pair<bool, Value>
     get(std::string const &setting, Condition const &condition) const;
+
+    /*
+     * Like `get()`, but returns the bound value without copying it, or
+     * null if there is none.
+     */
+    Value const *
+    find(std::string const &setting, Condition const &condition) const;
 };
 
 }
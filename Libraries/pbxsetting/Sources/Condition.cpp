@@ -8,7 +8,6 @@
  */
 
 #include <pbxsetting/Condition.h>
-#include <libutil/Wildcard.h>
 
 using pbxsetting::Condition;
 using libutil::Wildcard;
@@ -17,6 +16,23 @@ Condition::
 Condition(std::unordered_map<std::string, std::string> const &values) :
     _values(values)
 {
+    _clauses.reserve(values.size());
+
+    for (auto const &entry : values) {
+        Key key = Key::Other;
+        if (entry.first == "sdk") {
+            key = Key::SDK;
+        } else if (entry.first == "arch") {
+            key = Key::Arch;
+        } else if (entry.first == "variant") {
+            key = Key::Variant;
+        } else if (entry.first == "config") {
+            key = Key::Config;
+        }
+
+        /* Only uncommon keys need their name to compare. */
+        _clauses.push_back({ key, (key == Key::Other ? entry.first : std::string()), Wildcard(entry.second) });
+    }
 }
 
 Condition::
@@ -27,14 +43,16 @@ Condition::
 bool Condition::
 match(Condition const &condition) const
 {
-    auto OV = condition._values;
-    for (auto const &TE : _values) {
-        auto OE = OV.find(TE.first);
-        if (OE == OV.end()) {
-            return false;
+    for (Clause const &clause : _clauses) {
+        Clause const *value = nullptr;
+        for (Clause const &other : condition._clauses) {
+            if (other.key == clause.key && (clause.key != Key::Other || other.name == clause.name)) {
+                value = &other;
+                break;
+            }
         }
 
-        if (!Wildcard::Match(TE.second, OE->second)) {
+        if (value == nullptr || !clause.wildcard.match(value->wildcard.pattern())) {
             return false;
         }
     }
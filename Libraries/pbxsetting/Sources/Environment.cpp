@@ -161,9 +161,8 @@ resolveInheritance(Condition const &condition, InheritanceContext const &context
 {
     InheritanceContext ctx = context;
     for (++ctx.it; ctx.it != _levels.end(); ++ctx.it) {
-        auto result = ctx.it->get(ctx.setting, condition);
-        if (result.first) {
-            return resolveValue(condition, result.second, ctx);
+        if (Value const *value = ctx.it->find(ctx.setting, condition)) {
+            return resolveValue(condition, *value, ctx);
         }
     }
 
@@ -177,17 +176,16 @@ resolveAssignment(Condition const &condition, std::string const &setting) const
 
     for (context.it = _levels.begin(); context.it != _levels.end(); ++context.it) {
         Level const &level = *context.it;
-        auto result = level.get(setting, condition);
-        if (result.first) {
-            return resolveValue(condition, result.second, context);
+        if (Value const *value = level.find(setting, condition)) {
+            return resolveValue(condition, *value, context);
         }
     }
 
-    if (condition.values().empty()) {
-        return "";
-    } else {
-        return resolveAssignment(Condition::Empty(), setting);
-    }
+    /*
+     * Unconditional settings match any condition, so there is no need to
+     * look again without the condition: nothing more could be found.
+     */
+    return "";
 }
 
 std::string Environment::
@@ -16,8 +16,21 @@ using pbxsetting::Value;
 
 Level::
 Level(std::vector<Setting> const &settings) :
-    _settings(std::make_shared<std::vector<Setting>>(settings))
+    _settings  (std::make_shared<std::vector<Setting>>(settings)),
+    _candidates(std::make_shared<std::unordered_map<std::string, Candidates>>())
 {
+    for (size_t i = 0; i < _settings->size(); i++) {
+        Setting const &setting = (*_settings)[i];
+        Candidates &candidates = (*_candidates)[setting.name()];
+
+        if (setting.condition().empty()) {
+            /* Overrides everything before it. */
+            candidates.unconditional = i;
+            candidates.conditional.clear();
+        } else {
+            candidates.conditional.push_back(i);
+        }
+    }
 }
 
 Level::
@@ -28,12 +41,35 @@ Level::
 std::pair<bool, Value> Level::
 get(std::string const &setting, Condition const &condition) const
 {
-    for (auto it = _settings->rbegin(); it != _settings->rend(); ++it) {
-        if (it->match(setting, condition)) {
-            return std::make_pair(true, it->value());
-        }
+    if (Value const *value = find(setting, condition)) {
+        return std::make_pair(true, *value);
     }
 
     return std::make_pair(false, Value::Empty());
 }
 
+Value const *Level::
+find(std::string const &setting, Condition const &condition) const
+{
+    auto it = _candidates->find(setting);
+    if (it == _candidates->end()) {
+        return nullptr;
+    }
+
+    Candidates const &candidates = it->second;
+
+    /* Only the most recent matching conditional setting applies. */
+    for (auto cit = candidates.conditional.rbegin(); cit != candidates.conditional.rend(); ++cit) {
+        Setting const &conditional = (*_settings)[*cit];
+        if (conditional.condition().match(condition)) {
+            return &conditional.value();
+        }
+    }
+
+    if (candidates.unconditional) {
+        return &(*_settings)[*candidates.unconditional].value();
+    }
+
+    return nullptr;
+}
+
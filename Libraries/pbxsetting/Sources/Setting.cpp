@@ -31,7 +31,7 @@ Setting::
 bool Setting::
 match(std::string const &name, Condition const &condition) const
 {
-    return _name == name && _condition.match(condition);
+    return _name == name && (_condition.empty() || _condition.match(condition));
 }
 
 Setting Setting::
@@ -54,6 +54,21 @@ TEST(Condition, MatchSingle)
     EXPECT_FALSE(arch_some4.match(arch_i386));
 }
 
+TEST(Condition, MatchOther)
+{
+    /* Keys other than the common ones are compared by name. */
+    Condition other = Condition(std::unordered_map<std::string, std::string>({ { "other", "a*" } }));
+    Condition another = Condition(std::unordered_map<std::string, std::string>({ { "another", "a*" } }));
+    Condition value = Condition(std::unordered_map<std::string, std::string>({ { "other", "abc" }, { "arch", "arm64" } }));
+    EXPECT_TRUE(other.match(value));
+    EXPECT_FALSE(another.match(value));
+
+    EXPECT_TRUE(Condition::Empty().empty());
+    EXPECT_FALSE(other.empty());
+    EXPECT_TRUE(Condition::Empty().match(value));
+    EXPECT_FALSE(other.match(Condition::Empty()));
+}
+
 TEST(Condition, MatchMultiple)
 {
     Condition arch = Condition(std::unordered_map<std::string, std::string>({ { "arch", "armv7" } }));
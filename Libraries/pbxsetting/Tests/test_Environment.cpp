@@ -2,6 +2,7 @@
 #include <gtest/gtest.h>
 #include <pbxsetting/Environment.h>
 
+using pbxsetting::Condition;
 using pbxsetting::Environment;
 using pbxsetting::Level;
 using pbxsetting::Setting;
@@ -105,6 +106,32 @@ TEST(Environment, InheritedWithLevelInFront)
     EXPECT_EQ(inherited.resolve("OTHER_LDFLAGS"), "-ObjC -framework Security");
 }
 
+TEST(Environment, Conditional)
+{
+    Environment conditional;
+    conditional.insertBack(Level({
+        *Setting::Parse("OTHER_CFLAGS[arch=arm64] = $(inherited) -DARM64"),
+    }), false);
+    conditional.insertBack(Level({
+        *Setting::Parse("OTHER_CFLAGS[arch=x86_64] = -DOLD"),
+        Setting::Parse("OTHER_CFLAGS", "-DBASE"),
+        *Setting::Parse("OTHER_CFLAGS[arch=x86_64] = -DX86_64"),
+        *Setting::Parse("OTHER_CFLAGS[sdk=iphoneos*,arch=arm*] = -DIOS"),
+    }), false);
+
+    Condition arm64 = Condition(std::unordered_map<std::string, std::string>({ { "arch", "arm64" } }));
+    Condition iosArm64 = Condition(std::unordered_map<std::string, std::string>({ { "arch", "arm64" }, { "sdk", "iphoneos10.0" } }));
+    Condition x86_64 = Condition(std::unordered_map<std::string, std::string>({ { "arch", "x86_64" } }));
+    Condition i386 = Condition(std::unordered_map<std::string, std::string>({ { "arch", "i386" } }));
+
+    EXPECT_EQ("-DBASE", conditional.resolve("OTHER_CFLAGS"));
+    EXPECT_EQ("-DBASE -DARM64", conditional.resolve("OTHER_CFLAGS", arm64));
+    EXPECT_EQ("-DIOS -DARM64", conditional.resolve("OTHER_CFLAGS", iosArm64));
+    EXPECT_EQ("-DX86_64", conditional.resolve("OTHER_CFLAGS", x86_64));
+    EXPECT_EQ("-DBASE", conditional.resolve("OTHER_CFLAGS", i386));
+    EXPECT_EQ("", conditional.resolve("MISSING", x86_64));
+}
+
 TEST(Environment, Operations)
 {
     Environment environment;
@@ -12,6 +12,7 @@
 
 #include <pbxspec/PBX/Specification.h>
 #include <pbxspec/PBX/BuildPhaseInjection.h>
+#include <libutil/WildcardSet.h>
 
 #include <memory>
 #include <string>
@@ -79,6 +80,7 @@ protected:
     ext::optional<std::vector<std::string>> _mimeTypes;
     ext::optional<std::vector<std::string>> _typeCodes;
     ext::optional<std::vector<std::string>> _filenamePatterns;
+    ext::optional<libutil::WildcardSet>     _filenamePatternSet;
     ext::optional<std::vector<std::vector<uint8_t>>> _magicWords;
     ext::optional<std::vector<std::string>> _extraPropertyNames;
     ext::optional<std::vector<std::string>> _prefix;
@@ -144,6 +146,8 @@ public:
     { return _typeCodes; }
     inline ext::optional<std::vector<std::string>> const &filenamePatterns() const
     { return _filenamePatterns; }
+    inline ext::optional<libutil::WildcardSet> const &filenamePatternSet() const
+    { return _filenamePatternSet; }
     inline ext::optional<std::vector<std::vector<uint8_t>>> const &magicWords() const
     { return _magicWords; }
 
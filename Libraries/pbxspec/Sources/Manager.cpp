@@ -389,7 +389,7 @@ registerDomains(Filesystem const *filesystem, std::vector<std::pair<std::string,
 
         switch (*type) {
             case Filesystem::Type::Directory: {
-                filesystem->readDirectory(realPath, true, [&](std::string const &filename) -> bool {
+                filesystem->walkDirectory(realPath, true, [&](std::string const &filename, Filesystem::Type type) -> bool {
                     std::string path = realPath + "/" + filename;
 
                     /* Support both *.xcspec and *.pbfilespec as a few of the latter remain in use. */
@@ -403,7 +403,7 @@ registerDomains(Filesystem const *filesystem, std::vector<std::pair<std::string,
                         defaultType = SpecificationType::FileType;
                     }
 
-                    if (filesystem->type(path) != Filesystem::Type::Directory) {
+                    if (type != Filesystem::Type::Directory) {
 #if 0
                         fprintf(stderr, "importing specification '%s'\n", path.c_str());
 #endif
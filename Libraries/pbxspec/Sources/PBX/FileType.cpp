@@ -40,6 +40,19 @@ inherit(Specification::shared_ptr const &base)
     return inherit(std::static_pointer_cast<FileType>(base));
 }
 
+/*
+ * Compile the patterns once, as they are matched against every file.
+ */
+static ext::optional<libutil::WildcardSet>
+FilenamePatternSet(ext::optional<std::vector<std::string>> const &patterns)
+{
+    if (!patterns) {
+        return ext::nullopt;
+    }
+
+    return libutil::WildcardSet(*patterns);
+}
+
 bool FileType::
 inherit(FileType::shared_ptr const &b)
 {
@@ -53,6 +66,7 @@ inherit(FileType::shared_ptr const &b)
     _mimeTypes                               = Inherit::Combine(_mimeTypes, base->_mimeTypes);
     _typeCodes                               = Inherit::Combine(_typeCodes, base->_typeCodes);
     _filenamePatterns                        = Inherit::Combine(_filenamePatterns, base->_filenamePatterns);
+    _filenamePatternSet                      = FilenamePatternSet(_filenamePatterns);
     _magicWords                              = Inherit::Combine(_magicWords, base->_magicWords);
     _language                                = Inherit::Override(_language, base->_language);
     _computerLanguage                        = Inherit::Override(_computerLanguage, base->_computerLanguage);
@@ -218,6 +232,8 @@ parse(Context *context, plist::Dictionary const *dict, std::unordered_set<std::s
                 _filenamePatterns->push_back(FP->value());
             }
         }
+
+        _filenamePatternSet = FilenamePatternSet(_filenamePatterns);
     }
 
     if (MWs != nullptr) {
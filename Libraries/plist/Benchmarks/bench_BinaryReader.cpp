@@ -0,0 +1,252 @@
+/**
+ Copyright (c) 2015-present, Facebook, Inc.
+ All rights reserved.
+
+ This source code is licensed under the BSD-style license found in the
+ LICENSE file in the root directory of this source tree. An additional grant
+ of patent rights can be found in the PATENTS file in the same directory.
+ */
+
+#include <benchmark/Harness.h>
+#include <plist/Objects.h>
+#include <plist/Format/Binary.h>
+#include <plist/Format/BinaryReader.h>
+#include <libutil/DefaultFilesystem.h>
+#include <libutil/FSUtil.h>
+#include <libutil/Options.h>
+#include <process/DefaultContext.h>
+
+#include <cstdio>
+#include <cstdlib>
+
+using benchmark::Harness;
+using libutil::DefaultFilesystem;
+using libutil::FSUtil;
+
+class Options {
+private:
+    ext::optional<bool>        _help;
+
+private:
+    ext::optional<std::string> _file;
+    ext::optional<std::string> _key;
+    ext::optional<int>         _megabytes;
+
+private:
+    ext::optional<bool>        _csv;
+
+public:
+    Options();
+    ~Options();
+
+public:
+    bool help() const
+    { return _help.value_or(false); }
+
+public:
+    ext::optional<std::string> const &file() const
+    { return _file; }
+    std::string key() const
+    { return _key.value_or("CFBundleIdentifier"); }
+    int megabytes() const
+    { return _megabytes.value_or(50); }
+
+public:
+    bool csv() const
+    { return _csv.value_or(false); }
+
+private:
+    friend class libutil::Options;
+    std::pair<bool, std::string>
+    parseArgument(std::vector<std::string> const &args, std::vector<std::string>::const_iterator *it);
+};
+
+Options::
+Options()
+{
+}
+
+Options::
+~Options()
+{
+}
+
+std::pair<bool, std::string> Options::
+parseArgument(std::vector<std::string> const &args, std::vector<std::string>::const_iterator *it)
+{
+    std::string const &arg = **it;
+
+    if (arg == "-h" || arg == "--help") {
+        return libutil::Options::Current<bool>(&_help, arg);
+    } else if (arg == "--file") {
+        return libutil::Options::Next<std::string>(&_file, args, it);
+    } else if (arg == "--key") {
+        return libutil::Options::Next<std::string>(&_key, args, it);
+    } else if (arg == "--megabytes") {
+        return libutil::Options::Next<int>(&_megabytes, args, it);
+    } else if (arg == "--csv") {
+        return libutil::Options::Current<bool>(&_csv, arg);
+    } else {
+        return std::make_pair(false, "unknown argument " + arg);
+    }
+}
+
+static int
+Help(std::string const &error = std::string())
+{
+    if (!error.empty()) {
+        fprintf(stderr, "error: %s\n", error.c_str());
+        fprintf(stderr, "\n");
+    }
+
+    fprintf(stderr, "Usage: bench_plist_BinaryReader [options]\n\n");
+    fprintf(stderr, "Measures reading one key from a large binary property list,\n");
+    fprintf(stderr, "in place and by decoding all of it.\n\n");
+
+#define INDENT "  "
+    fprintf(stderr, "Options:\n");
+    fprintf(stderr, INDENT "--file <path> (default: generated property list)\n");
+    fprintf(stderr, INDENT "--key <key> (in the root dictionary)\n");
+    fprintf(stderr, INDENT "--megabytes <size> (of generated property list)\n");
+    fprintf(stderr, INDENT "--csv\n");
+    fprintf(stderr, "\n");
+#undef INDENT
+
+    return (error.empty() ? EXIT_SUCCESS : EXIT_FAILURE);
+}
+
+/*
+ * Generate a property list with many entries, and the key to look up
+ * after all of them.
+ */
+static std::unique_ptr<plist::Dictionary>
+Document(int megabytes, std::string const &key)
+{
+    auto root = plist::Dictionary::New();
+
+    /* Each entry is roughly 200 bytes. */
+    int entries = megabytes * 1024 * 1024 / 200;
+    for (int i = 0; i < entries; i++) {
+        std::string name = "Entry" + std::to_string(i);
+
+        auto entry = plist::Dictionary::New();
+        entry->set("Name", plist::String::New(name + ".png"));
+        entry->set("Path", plist::String::New("/Applications/Example.app/Contents/Resources/" + name + ".png"));
+        entry->set("Size", plist::Integer::New(i));
+        entry->set("Hash", plist::Data::New(std::vector<uint8_t>(64, static_cast<uint8_t>(i))));
+        root->set(name, std::move(entry));
+    }
+
+    root->set(key, plist::String::New("com.example.app"));
+    return root;
+}
+
+int
+main(int argc, char **argv)
+{
+    process::DefaultContext processContext = process::DefaultContext();
+
+    Options options;
+    std::pair<bool, std::string> result = libutil::Options::Parse<Options>(&options, processContext.commandLineArguments());
+    if (!result.first) {
+        return Help(result.second);
+    }
+
+    if (options.help()) {
+        return Help();
+    }
+
+    if (options.megabytes() <= 0) {
+        return Help("invalid size");
+    }
+
+    DefaultFilesystem filesystem;
+
+    std::string path;
+    if (options.file()) {
+        path = *options.file();
+    } else {
+        char temporary[] = "/tmp/bench_plist_BinaryReader-XXXXXX";
+        if (mkdtemp(temporary) == nullptr) {
+            return Help("unable to create temporary directory");
+        }
+        path = std::string(temporary) + "/Info.plist";
+    }
+
+    std::string source = (options.file() ? *options.file() : "megabytes=" + std::to_string(options.megabytes()));
+    Harness harness = Harness("plist binary reader " + source);
+
+    size_t size = 0;
+    harness.stage("Write", [&]() -> bool {
+        if (options.file()) {
+            return true;
+        }
+
+        auto root = Document(options.megabytes(), options.key());
+        auto serialize = plist::Format::Binary::Serialize(root.get(), plist::Format::Binary::Create());
+        if (serialize.first == nullptr) {
+            return false;
+        }
+
+        size = serialize.first->size();
+        return filesystem.write(*serialize.first, path);
+    });
+
+    /* In place first, so the peak memory of decoding doesn't hide it. */
+    std::string lazy;
+    harness.stage("Lookup", [&]() -> bool {
+        auto open = plist::Format::BinaryReader::Open(&filesystem, path);
+        if (open.first == nullptr) {
+            return false;
+        }
+
+        plist::Format::BinaryReader::Reference reference;
+        if (!open.first->value(open.first->root(), options.key(), &reference)) {
+            return false;
+        }
+
+        auto object = open.first->object(reference);
+        if (plist::String const *string = plist::CastTo<plist::String>(object.first.get())) {
+            lazy = string->value();
+        }
+        return (object.first != nullptr);
+    });
+
+    std::string full;
+    harness.stage("Deserialize", [&]() -> bool {
+        std::vector<uint8_t> contents;
+        if (!filesystem.read(&contents, path)) {
+            return false;
+        }
+
+        auto deserialize = plist::Format::Binary::Deserialize(contents, plist::Format::Binary::Create());
+        plist::Dictionary const *root = plist::CastTo<plist::Dictionary>(deserialize.first.get());
+        if (root == nullptr || root->value(options.key()) == nullptr) {
+            return false;
+        }
+
+        if (plist::String const *string = root->value<plist::String>(options.key())) {
+            full = string->value();
+        }
+        return true;
+    });
+
+    if (!options.file()) {
+        filesystem.removeDirectory(FSUtil::GetDirectoryName(path), true);
+    }
+
+    if (options.csv()) {
+        harness.reportCSV(stdout, true);
+    } else {
+        harness.report(stdout);
+        fprintf(stdout, "Property list: %zu bytes, values %s\n", size, (lazy == full ? "match" : "differ"));
+    }
+
+    for (Harness::Result const &result : harness.results()) {
+        if (!result.success()) {
+            return EXIT_FAILURE;
+        }
+    }
+
+    return EXIT_SUCCESS;
+}
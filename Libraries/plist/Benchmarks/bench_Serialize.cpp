@@ -0,0 +1,228 @@
+/**
+ Copyright (c) 2015-present, Facebook, Inc.
+ All rights reserved.
+
+ This source code is licensed under the BSD-style license found in the
+ LICENSE file in the root directory of this source tree. An additional grant
+ of patent rights can be found in the PATENTS file in the same directory.
+ */
+
+#include <benchmark/Harness.h>
+#include <plist/Objects.h>
+#include <plist/Format/Any.h>
+#include <plist/Format/Binary.h>
+#include <libutil/DefaultFilesystem.h>
+#include <libutil/Options.h>
+#include <process/DefaultContext.h>
+
+#include <cstdio>
+#include <cstdlib>
+
+using benchmark::Harness;
+using libutil::DefaultFilesystem;
+
+class Options {
+private:
+    ext::optional<bool>        _help;
+
+private:
+    ext::optional<std::string> _file;
+    ext::optional<int>         _files;
+    ext::optional<int>         _iterations;
+    ext::optional<bool>        _containers;
+
+private:
+    ext::optional<bool>        _csv;
+
+public:
+    Options();
+    ~Options();
+
+public:
+    bool help() const
+    { return _help.value_or(false); }
+
+public:
+    ext::optional<std::string> const &file() const
+    { return _file; }
+    int files() const
+    { return _files.value_or(50000); }
+    int iterations() const
+    { return _iterations.value_or(10); }
+    bool containers() const
+    { return _containers.value_or(false); }
+
+public:
+    bool csv() const
+    { return _csv.value_or(false); }
+
+private:
+    friend class libutil::Options;
+    std::pair<bool, std::string>
+    parseArgument(std::vector<std::string> const &args, std::vector<std::string>::const_iterator *it);
+};
+
+Options::
+Options()
+{
+}
+
+Options::
+~Options()
+{
+}
+
+std::pair<bool, std::string> Options::
+parseArgument(std::vector<std::string> const &args, std::vector<std::string>::const_iterator *it)
+{
+    std::string const &arg = **it;
+
+    if (arg == "-h" || arg == "--help") {
+        return libutil::Options::Current<bool>(&_help, arg);
+    } else if (arg == "--file") {
+        return libutil::Options::Next<std::string>(&_file, args, it);
+    } else if (arg == "--files") {
+        return libutil::Options::Next<int>(&_files, args, it);
+    } else if (arg == "--iterations") {
+        return libutil::Options::Next<int>(&_iterations, args, it);
+    } else if (arg == "--containers") {
+        return libutil::Options::Current<bool>(&_containers, arg);
+    } else if (arg == "--csv") {
+        return libutil::Options::Current<bool>(&_csv, arg);
+    } else {
+        return std::make_pair(false, "unknown argument " + arg);
+    }
+}
+
+static int
+Help(std::string const &error = std::string())
+{
+    if (!error.empty()) {
+        fprintf(stderr, "error: %s\n", error.c_str());
+        fprintf(stderr, "\n");
+    }
+
+    fprintf(stderr, "Usage: bench_plist_Serialize [options]\n\n");
+    fprintf(stderr, "Measures writing a large property list, like a project file,\n");
+    fprintf(stderr, "in the binary format.\n\n");
+
+#define INDENT "  "
+    fprintf(stderr, "Options:\n");
+    fprintf(stderr, INDENT "--file <path> (default: generated project file)\n");
+    fprintf(stderr, INDENT "--files <count> (in generated project file)\n");
+    fprintf(stderr, INDENT "--iterations <count>\n");
+    fprintf(stderr, INDENT "--containers (write repeated containers once)\n");
+    fprintf(stderr, INDENT "--csv\n");
+    fprintf(stderr, "\n");
+#undef INDENT
+
+    return (error.empty() ? EXIT_SUCCESS : EXIT_FAILURE);
+}
+
+static std::string
+ProjectIdentifier(int kind, int index)
+{
+    char identifier[25];
+    snprintf(identifier, sizeof(identifier), "%02X%014X%08X", kind, 0, index);
+    return identifier;
+}
+
+/*
+ * Generate a project file with a file reference and build file for each
+ * source file, shaped like the project files Xcode writes.
+ */
+static std::vector<uint8_t>
+ProjectContents(int files)
+{
+    std::string contents = "// !$*UTF8*$!\n{\n\tarchiveVersion = 1;\n\tclasses = {\n\t};\n\tobjectVersion = 46;\n\tobjects = {\n";
+
+    std::string children;
+    std::string buildFiles;
+    for (int i = 0; i < files; i++) {
+        std::string fileReference = ProjectIdentifier(0x0E, i);
+        std::string buildFile = ProjectIdentifier(0x0F, i);
+        std::string name = "File" + std::to_string(i) + ".m";
+
+        contents += "\t\t" + buildFile + " /* " + name + " in Sources */ = {isa = PBXBuildFile; fileRef = " + fileReference + " /* " + name + " */; settings = {COMPILER_FLAGS = \"-fobjc-arc\"; }; };\n";
+        contents += "\t\t" + fileReference + " /* " + name + " */ = {isa = PBXFileReference; fileEncoding = 4; lastKnownFileType = sourcecode.c.objc; path = " + name + "; sourceTree = \"<group>\"; };\n";
+
+        children += "\t\t\t\t" + fileReference + " /* " + name + " */,\n";
+        buildFiles += "\t\t\t\t" + buildFile + " /* " + name + " in Sources */,\n";
+    }
+
+    contents += "\t\t" + ProjectIdentifier(0x04, 0) + " = {\n\t\t\tisa = PBXGroup;\n\t\t\tchildren = (\n" + children + "\t\t\t);\n\t\t\tsourceTree = \"<group>\";\n\t\t};\n";
+    contents += "\t\t" + ProjectIdentifier(0x0C, 0) + " /* Sources */ = {\n\t\t\tisa = PBXSourcesBuildPhase;\n\t\t\tbuildActionMask = 2147483647;\n\t\t\tfiles = (\n" + buildFiles + "\t\t\t);\n\t\t\trunOnlyForDeploymentPostprocessing = 0;\n\t\t};\n";
+    contents += "\t};\n\trootObject = " + ProjectIdentifier(0x01, 0) + ";\n}\n";
+
+    return std::vector<uint8_t>(contents.begin(), contents.end());
+}
+
+int
+main(int argc, char **argv)
+{
+    process::DefaultContext processContext = process::DefaultContext();
+
+    Options options;
+    std::pair<bool, std::string> result = libutil::Options::Parse<Options>(&options, processContext.commandLineArguments());
+    if (!result.first) {
+        return Help(result.second);
+    }
+
+    if (options.help()) {
+        return Help();
+    }
+
+    if (options.files() <= 0) {
+        return Help("invalid file count");
+    }
+
+    if (options.iterations() <= 0) {
+        return Help("invalid iteration count");
+    }
+
+    DefaultFilesystem filesystem;
+
+    std::string source = (options.file() ? *options.file() : "files=" + std::to_string(options.files()));
+    Harness harness = Harness("plist serialize " + source + (options.containers() ? " containers" : ""));
+
+    std::unique_ptr<plist::Object> root;
+    harness.stage("Read", [&]() -> bool {
+        std::vector<uint8_t> contents;
+        if (options.file()) {
+            if (!filesystem.read(&contents, *options.file())) {
+                return false;
+            }
+        } else {
+            contents = ProjectContents(options.files());
+        }
+
+        root = plist::Format::Any::Deserialize(contents).first;
+        return (root != nullptr);
+    });
+
+    std::unique_ptr<std::vector<uint8_t>> serialized;
+    harness.stage("Serialize", [&]() -> bool {
+        for (int i = 0; i < options.iterations(); i++) {
+            serialized = plist::Format::Binary::Serialize(root.get(), plist::Format::Binary::Create(options.containers())).first;
+            if (serialized == nullptr) {
+                return false;
+            }
+        }
+        return true;
+    });
+
+    if (options.csv()) {
+        harness.reportCSV(stdout, true);
+    } else {
+        harness.report(stdout);
+        fprintf(stdout, "Output: %zu bytes, %d iterations\n", (serialized != nullptr ? serialized->size() : 0), options.iterations());
+    }
+
+    for (Harness::Result const &result : harness.results()) {
+        if (!result.success()) {
+            return EXIT_FAILURE;
+        }
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,124 @@
+/**
+ Copyright (c) 2015-present, Facebook, Inc.
+ All rights reserved.
+
+ This source code is licensed under the BSD-style license found in the
+ LICENSE file in the root directory of this source tree. An additional grant
+ of patent rights can be found in the PATENTS file in the same directory.
+ */
+
+#ifndef __plist_Arena_h
+#define __plist_Arena_h
+
+#include <plist/Base.h>
+
+#include <atomic>
+#include <deque>
+#include <string>
+#include <vector>
+
+namespace plist {
+
+/*
+ * Allocates the objects of a property list document from large blocks,
+ * rather than individually, and interns the strings they repeat.
+ *
+ * Objects created on a thread while an `Arena::Scope` is active there
+ * are allocated from the scope's arena, and dictionary keys and short
+ * string values are interned in it. The objects are otherwise ordinary:
+ * they can be modified, moved between documents and released on any
+ * thread. Each block is freed once every object in it is released, and
+ * the interned strings once every block is.
+ *
+ * Only the thread the scope is active on allocates from or interns into
+ * an arena, so neither needs a lock.
+ */
+class Arena {
+public:
+    /*
+     * Allocates objects created on this thread from a new arena until the
+     * scope ends. Scopes can be nested; the innermost one is used.
+     */
+    class Scope {
+    private:
+        Arena *_arena;
+        Arena *_previous;
+
+    public:
+        Scope();
+        ~Scope();
+
+    private:
+        Scope(Scope const &) = delete;
+        Scope &operator=(Scope const &) = delete;
+
+    public:
+        Arena *arena() const
+        { return _arena; }
+    };
+
+private:
+    class Block;
+
+public:
+    /*
+     * Sizes of released objects kept for reuse.
+     */
+    static size_t const ReuseClasses = 32;
+
+private:
+    std::atomic<size_t>  _references;
+    Block               *_block;
+    void                *_reuse[ReuseClasses];
+
+private:
+    std::deque<std::string>                             _strings;
+    std::vector<std::pair<size_t, std::string const *>> _stringIndex;
+
+private:
+    Arena();
+    ~Arena();
+
+private:
+    Arena(Arena const &) = delete;
+    Arena &operator=(Arena const &) = delete;
+
+private:
+    void release();
+    void *allocate(size_t size);
+
+public:
+    /*
+     * Intern a string, returning storage shared by equal strings and
+     * alive as long as any object allocated from this arena.
+     */
+    std::string const *intern(std::string const &string);
+
+public:
+    /*
+     * The arena of the innermost scope on this thread, if any.
+     */
+    static Arena *Current();
+
+    /*
+     * Intern a string value in the current arena. Returns nothing if
+     * there is no current arena, or if the string is too long to be
+     * worth sharing.
+     */
+    static std::string const *Intern(std::string const &string);
+
+public:
+    /*
+     * Allocate memory for an object, from the current arena if any.
+     */
+    static void *Allocate(size_t size);
+
+    /*
+     * Release memory of `size` bytes from `Allocate()`.
+     */
+    static void Deallocate(void *pointer, size_t size);
+};
+
+}
+
+#endif  // !__plist_Arena_h
@@ -14,18 +14,75 @@
 #include <plist/Object.h>
 
 #include <algorithm>
+#include <iterator>
 #include <vector>
 #include <unordered_map>
 
 namespace plist {
 
+class Arena;
+
+/*
+ * Entries are kept in insertion order. Larger dictionaries also keep an
+ * index to find entries by key; smaller ones are searched in order.
+ */
 class Dictionary : public Object {
 private:
-    std::vector<std::string>                                 _keys;
-    std::unordered_map<std::string, std::unique_ptr<Object>> _map;
+    class Entry {
+    public:
+        std::string const       *key;
+        bool                     owned;
+        std::unique_ptr<Object>  value;
+    };
+
+public:
+    /*
+     * Iterates the keys of the dictionary, in order.
+     */
+    class const_iterator {
+    public:
+        typedef std::forward_iterator_tag iterator_category;
+        typedef std::string               value_type;
+        typedef std::ptrdiff_t            difference_type;
+        typedef std::string const        *pointer;
+        typedef std::string const        &reference;
+
+    private:
+        std::vector<Entry>::const_iterator _it;
+
+    public:
+        explicit const_iterator(std::vector<Entry>::const_iterator it) :
+            _it(it)
+        {
+        }
+
+    public:
+        inline reference operator*() const
+        { return *_it->key; }
+        inline pointer operator->() const
+        { return _it->key; }
+
+    public:
+        inline const_iterator &operator++()
+        { ++_it; return *this; }
+        inline const_iterator operator++(int)
+        { const_iterator it = *this; ++_it; return it; }
+
+    public:
+        inline bool operator==(const_iterator const &rhs) const
+        { return _it == rhs._it; }
+        inline bool operator!=(const_iterator const &rhs) const
+        { return _it != rhs._it; }
+    };
+
+private:
+    Arena                 *_arena;
+    std::vector<Entry>     _entries;
+    std::vector<uint32_t>  _index;
 
 public:
-    Dictionary()
+    Dictionary() :
+        _arena(nullptr)
     {
     }
 
@@ -40,27 +97,27 @@ public:
 public:
     inline bool empty() const
     {
-        return _map.empty();
+        return _entries.empty();
     }
 
     inline size_t count() const
     {
-        return _map.size();
+        return _entries.size();
     }
 
     inline std::string const &key(size_t index) const
     {
-        return _keys[index];
+        return *_entries[index].key;
     }
 
     inline Object const *value(size_t index) const
     {
-        return (index < _keys.size()) ? value(_keys[index]) : nullptr;
+        return (index < _entries.size()) ? _entries[index].value.get() : nullptr;
     }
 
     inline Object *value(size_t index)
     {
-        return (index < _keys.size()) ? value(_keys[index]) : nullptr;
+        return (index < _entries.size()) ? _entries[index].value.get() : nullptr;
     }
 
     template <typename T>
@@ -77,14 +134,14 @@ public:
 
     inline Object const *value(std::string const &key) const
     {
-        auto it = _map.find(key);
-        return (it != _map.end() ? it->second.get() : nullptr);
+        size_t index = find(key);
+        return (index != npos ? _entries[index].value.get() : nullptr);
     }
 
     inline Object *value(std::string const &key)
     {
-        auto it = _map.find(key);
-        return (it != _map.end() ? it->second.get() : nullptr);
+        size_t index = find(key);
+        return (index != npos ? _entries[index].value.get() : nullptr);
     }
 
     template <typename T>
@@ -100,41 +157,31 @@ public:
     }
 
 public:
-    inline void clear()
-    {
-        _keys.clear();
-        _map.clear();
-    }
+    void clear();
 
 public:
-    inline void set(std::string const &key, std::unique_ptr<Object> obj)
-    {
-        remove(key);
-        _keys.push_back(key);
-        _map.insert(std::make_pair(key, std::move(obj)));
-    }
-
-    inline void remove(std::string const &key)
-    {
-        auto it = _map.find(key);
-
-        if (it != _map.end()) {
-            _map.erase(it);
-            _keys.erase(std::find(_keys.begin(), _keys.end(), key));
-        }
-    }
+    void set(std::string const &key, std::unique_ptr<Object> obj);
+    void remove(std::string const &key);
 
 public:
-    inline std::vector<std::string>::const_iterator begin() const
+    inline const_iterator begin() const
     {
-        return _keys.begin();
+        return const_iterator(_entries.begin());
     }
 
-    inline std::vector<std::string>::const_iterator end() const
+    inline const_iterator end() const
     {
-        return _keys.end();
+        return const_iterator(_entries.end());
     }
 
+private:
+    static size_t const npos = static_cast<size_t>(-1);
+
+    size_t find(std::string const &key) const;
+    void insertIndex(size_t index);
+    void removeIndex(size_t index);
+    void rebuildIndex();
+
 public:
     static std::unique_ptr<Dictionary> Coerce(Object const *obj);
 
@@ -174,8 +221,8 @@ public:
         if (count() != obj->count())
             return false;
 
-        for (auto const &it : _map) {
-            if (!value(it.first)->equals(obj->value(it.first)))
+        for (Entry const &entry : _entries) {
+            if (!entry.value->equals(obj->value(*entry.key)))
                 return false;
         }
 
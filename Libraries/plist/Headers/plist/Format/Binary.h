@@ -18,13 +18,25 @@ namespace Format {
 
 class Binary : public Format<Binary> {
 private:
-    Binary();
+    bool _uniqueContainers;
+
+private:
+    Binary(bool uniqueContainers);
 
 public:
     static Type FormatType();
 
 public:
-    static Binary Create();
+    /*
+     * Values with the same contents are always written once. This also
+     * writes arrays and dictionaries with the same contents once, which
+     * makes smaller output but takes longer to write.
+     */
+    inline bool uniqueContainers() const
+    { return _uniqueContainers; }
+
+public:
+    static Binary Create(bool uniqueContainers = false);
 };
 
 }
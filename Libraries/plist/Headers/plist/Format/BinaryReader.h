@@ -0,0 +1,126 @@
+/**
+ Copyright (c) 2015-present, Facebook, Inc.
+ All rights reserved.
+
+ This source code is licensed under the BSD-style license found in the
+ LICENSE file in the root directory of this source tree. An additional grant
+ of patent rights can be found in the PATENTS file in the same directory.
+ */
+
+#ifndef __plist_Format_BinaryReader_h
+#define __plist_Format_BinaryReader_h
+
+#include <plist/Object.h>
+#include <libutil/Filesystem.h>
+
+#include <memory>
+#include <string>
+#include <vector>
+#include <cstdint>
+
+namespace plist {
+namespace Format {
+
+/*
+ * Reads a binary property list in place, decoding only the objects asked
+ * for. Looking up a few values in a large property list doesn't decode
+ * the rest of it, unlike `Binary::Deserialize()`.
+ *
+ * Objects are identified by reference, starting from the root object.
+ * References are checked before they are used, so a corrupt property list
+ * fails the lookups that reach the corruption rather than all of them.
+ */
+class BinaryReader {
+public:
+    /*
+     * Identifies an object in the property list.
+     */
+    typedef uint64_t Reference;
+
+private:
+    std::unique_ptr<libutil::Filesystem::Mapping> _mapping;
+    uint8_t const                                *_data;
+    size_t                                        _size;
+
+private:
+    size_t                                        _offsetSize;
+    size_t                                        _referenceSize;
+    uint64_t                                      _count;
+    uint64_t                                      _root;
+    size_t                                        _offsetTable;
+
+private:
+    BinaryReader(std::unique_ptr<libutil::Filesystem::Mapping> mapping, uint8_t const *data, size_t size);
+
+public:
+    ~BinaryReader();
+
+private:
+    BinaryReader(BinaryReader const &) = delete;
+    BinaryReader &operator=(BinaryReader const &) = delete;
+
+public:
+    /*
+     * The root object.
+     */
+    Reference root() const
+    { return _root; }
+
+public:
+    /*
+     * The type of an object, or none if it can't be read.
+     */
+    ObjectType type(Reference reference) const;
+
+    /*
+     * The number of values in an array or dictionary. Zero for other
+     * objects, or if the object can't be read.
+     */
+    size_t count(Reference reference) const;
+
+    /*
+     * Look up a value of an array by index. Returns false if the object
+     * isn't an array, or has no such value.
+     */
+    bool value(Reference array, size_t index, Reference *result) const;
+
+    /*
+     * Look up a value of a dictionary by key. Only keys are compared, so
+     * other values are not read. Returns false if the object isn't a
+     * dictionary, or has no such key.
+     */
+    bool value(Reference dictionary, std::string const &key, Reference *result) const;
+
+public:
+    /*
+     * Decode an object, including any objects it contains.
+     */
+    std::pair<std::unique_ptr<Object>, std::string> object(Reference reference) const;
+
+private:
+    bool offset(Reference reference, size_t *offset) const;
+    bool word(size_t offset, size_t nbytes, uint64_t *result) const;
+    bool marker(Reference reference, uint8_t *marker, size_t *length, size_t *start) const;
+    bool reference(size_t start, size_t index, Reference *result) const;
+    std::unique_ptr<Object> decode(Reference reference, std::vector<Reference> *parents, std::string *error) const;
+
+public:
+    /*
+     * Read a binary property list in memory. The contents must outlive
+     * the reader.
+     */
+    static std::pair<std::unique_ptr<BinaryReader>, std::string>
+    Open(uint8_t const *data, size_t size);
+
+    /*
+     * Read a binary property list file, mapping it into memory so that
+     * only the parts used are read.
+     */
+    static std::pair<std::unique_ptr<BinaryReader>, std::string>
+    Open(libutil::Filesystem const *filesystem, std::string const &path);
+};
+
+}
+}
+
+#endif  // !__plist_Format_BinaryReader_h
@@ -0,0 +1,155 @@
+/**
+ Copyright (c) 2015-present, Facebook, Inc.
+ All rights reserved.
+
+ This source code is licensed under the BSD-style license found in the
+ LICENSE file in the root directory of this source tree. An additional grant
+ of patent rights can be found in the PATENTS file in the same directory.
+ */
+
+#ifndef __plist_Format_JSONReader_h
+#define __plist_Format_JSONReader_h
+
+#include <plist/Object.h>
+
+#include <memory>
+#include <string>
+#include <vector>
+#include <cstdint>
+
+struct ASCIIPListLexer;
+
+namespace plist {
+namespace Format {
+
+/*
+ * Reads JSON one token at a time, without building objects for it. Callers
+ * pull tokens with `next()` and handle the values they are interested in,
+ * skipping the rest. This accepts the same input as `JSON::Deserialize()`.
+ *
+ * The input is not copied, so it must outlive the reader.
+ */
+class JSONReader {
+public:
+    enum class Token {
+        DictionaryStart,
+        DictionaryEnd,
+        ArrayStart,
+        ArrayEnd,
+        /* A dictionary key; the next token is its value. */
+        Key,
+        String,
+        Integer,
+        Real,
+        Boolean,
+        Null,
+        /* The end of the input, after the root value. */
+        End,
+        /* Invalid input; see `error()`. No more tokens are read. */
+        Error,
+    };
+
+private:
+    std::unique_ptr<ASCIIPListLexer> _lexer;
+
+private:
+    enum class State {
+        Value,
+        Key,
+        KeyValueSeparator,
+        EntrySeparator,
+        Done,
+    };
+
+    State                            _state;
+    std::vector<bool>                _containers;
+
+private:
+    Token                            _token;
+    std::string                      _string;
+    int64_t                          _integer;
+    double                           _real;
+    std::string                      _error;
+
+public:
+    JSONReader(uint8_t const *data, size_t size);
+    ~JSONReader();
+
+private:
+    JSONReader(JSONReader const &) = delete;
+    JSONReader &operator=(JSONReader const &) = delete;
+
+public:
+    /*
+     * Read the next token.
+     */
+    Token next();
+
+    /*
+     * The last token read.
+     */
+    Token token() const
+    { return _token; }
+
+public:
+    /*
+     * The value of a key or string token.
+     */
+    std::string const &string() const
+    { return _string; }
+
+    /*
+     * The value of an integer token.
+     */
+    int64_t integer() const
+    { return _integer; }
+
+    /*
+     * The value of a real token.
+     */
+    double real() const
+    { return _real; }
+
+    /*
+     * The value of a boolean token.
+     */
+    bool boolean() const
+    { return _integer != 0; }
+
+    /*
+     * Why the input is invalid, after an error token.
+     */
+    std::string const &error() const
+    { return _error; }
+
+public:
+    /*
+     * The type of the value starting at the last token, or none if the
+     * last token does not start a value.
+     */
+    ObjectType type() const;
+
+    /*
+     * Skip past the value starting at the last token. After skipping a
+     * container, the last token is its end. False if the input is invalid.
+     */
+    bool skip();
+
+    /*
+     * Read the value starting at the last token into an object, for values
+     * more easily handled that way. Null if the input is invalid.
+     */
+    std::unique_ptr<Object> object();
+
+private:
+    Token fail(std::string const &error);
+    Token value(Token token);
+    Token close(bool dictionary);
+    void copyString();
+    void copyToken();
+};
+
+}
+}
+
+#endif  // !__plist_Format_JSONReader_h
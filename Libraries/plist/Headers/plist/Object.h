@@ -32,6 +32,13 @@ public:
 public:
     virtual ObjectType type() const = 0;
 
+public:
+    /*
+     * Objects are allocated from the current `Arena`, if any.
+     */
+    static void *operator new(size_t size);
+    static void operator delete(void *pointer, size_t size);
+
 public:
     virtual void release() const
     {
@@ -17,32 +17,80 @@ namespace plist {
 
 class String : public Object {
 private:
-    std::string _value;
+    std::string const *_interned;
+    std::string        _value;
 
 public:
     String(std::string const &value = std::string()) :
-        _value(value)
+        _interned(nullptr),
+        _value   (value)
     {
     }
 
     String(std::string &&value) :
-        _value(std::move(value))
+        _interned(nullptr),
+        _value   (std::move(value))
+    {
+    }
+
+    /*
+     * Interned values belong to the arena this string was allocated from,
+     * which a copy may outlive, so copies own their value. Use `copy()`
+     * to share the value in the current arena instead.
+     */
+    String(String const &other) :
+        Object   (other),
+        _interned(nullptr),
+        _value   (other.value())
+    {
+    }
+
+    String(String &&other) :
+        Object   (other),
+        _interned(nullptr),
+        _value   (other._interned != nullptr ? *other._interned : std::move(other._value))
+    {
+    }
+
+    String &operator=(String const &other)
+    {
+        setValue(other.value());
+        return *this;
+    }
+
+    String &operator=(String &&other)
+    {
+        if (this == &other) {
+            return *this;
+        } else if (other._interned != nullptr) {
+            setValue(*other._interned);
+        } else {
+            setValue(std::move(other._value));
+        }
+        return *this;
+    }
+
+private:
+    explicit String(std::string const *interned) :
+        _interned(interned)
     {
     }
 
 public:
     inline std::string const &value() const
     {
-        return _value;
+        return (_interned != nullptr ? *_interned : _value);
     }
 
     inline void setValue(std::string const &value)
     {
+        _interned = nullptr;
         _value = value;
     }
 
     inline void setValue(std::string &&value)
     {
+        _interned = nullptr;
         _value = std::move(value);
     }
 
@@ -14,22 +14,25 @@
 #include <plist/Format/ABPRecordType.h>
 #include <plist/Objects.h>
 
+#include <string>
 #include <vector>
 #include <unordered_map>
 #include <unordered_set>
 
 class ABPWriter : public ABPContext {
 private:
+    bool                                                             _uniqueContainers;
     std::unordered_map<plist::Object const *, int>                   _references;
     std::unordered_map<plist::Object const *, plist::Object const *> _mappings;
+    std::unordered_map<std::string, plist::Object const *>           _unique;
     std::unordered_set<plist::Object const *>                        _written;
-    std::unordered_map<plist::Dictionary const *, std::unordered_map<int, plist::String *>> _keyStrings;
+    std::unordered_map<plist::Dictionary const *, std::vector<std::unique_ptr<plist::String>>> _keyStrings;
 
 public:
     std::vector<uint8_t>                                            *_mutableContents;
 
 public:
-    ABPWriter(std::vector<uint8_t> *contents);
+    ABPWriter(std::vector<uint8_t> *contents, bool uniqueContainers = false);
 
 public:
     bool open();
@@ -42,7 +45,17 @@ public:
     int write(void const *data, size_t length);
 
 private:
-    bool writeByte(uint8_t byte);
+    inline bool writeByte(uint8_t byte)
+    {
+        if (static_cast<size_t>(this->_offset) == this->_mutableContents->size()) {
+            this->_mutableContents->push_back(byte);
+            this->_offset++;
+            return true;
+        }
+
+        return (this->write(&byte, sizeof(byte)) == sizeof(byte));
+    }
+
     bool writeWord0(size_t nbytes, uint64_t value, bool swap);
     bool writeWord(size_t nbytes, uint64_t value);
 
@@ -82,6 +95,7 @@ private:
     bool writePreflightDictionary(plist::Dictionary const *dict);
 
 private:
+    plist::Object const *uniqueObject(plist::Object const *object);
     bool processObject(plist::Object const **object, uint32_t *refno, bool userProcess);
 };
 
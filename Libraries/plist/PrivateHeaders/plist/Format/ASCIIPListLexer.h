@@ -24,6 +24,7 @@ typedef struct ASCIIPListLexer {
     int         line;
     int         tokenBegin;
     int         tokenLength;
+    int         vectorized;
 } ASCIIPListLexer;
 
 enum {
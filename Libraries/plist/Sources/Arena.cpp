@@ -0,0 +1,276 @@
+/**
+ Copyright (c) 2015-present, Facebook, Inc.
+ All rights reserved.
+
+ This source code is licensed under the BSD-style license found in the
+ LICENSE file in the root directory of this source tree. An additional grant
+ of patent rights can be found in the PATENTS file in the same directory.
+ */
+
+#include <plist/Arena.h>
+
+#include <algorithm>
+#include <functional>
+#include <new>
+
+using plist::Arena;
+
+/*
+ * Each allocation is preceded by a pointer to the block it came from, or
+ * null if it was allocated individually. This is also the alignment of
+ * allocations, which is enough for any object.
+ */
+static size_t const ArenaHeaderSize = 8;
+
+/*
+ * Blocks are large enough that most documents need few of them. Larger
+ * objects get a block to themselves so little of a shared block is wasted.
+ */
+static size_t const ArenaBlockSize = 64 * 1024;
+static size_t const ArenaLargeSize = 4 * 1024;
+
+/*
+ * Parsers release many small objects, like dictionary keys, while they
+ * build a document. Released objects up to this size are reused for new
+ * objects while the arena is still allocated from.
+ */
+static size_t const ArenaReuseSize = ArenaHeaderSize * Arena::ReuseClasses;
+
+/*
+ * Longer string values, like paths and scripts, are rarely repeated, so
+ * are not interned. Identifiers and file types often are.
+ */
+static size_t const ArenaInternLength = 64;
+
+static thread_local Arena *ArenaCurrent = nullptr;
+
+static inline size_t
+ArenaRound(size_t size)
+{
+    return (size + ArenaHeaderSize - 1) & ~(ArenaHeaderSize - 1);
+}
+
+class Arena::Block {
+public:
+    Arena              *arena;
+    std::atomic<size_t> live;
+    size_t              used;
+    size_t              capacity;
+
+public:
+    Block(Arena *arena, size_t capacity, size_t live) :
+        arena   (arena),
+        live    (live),
+        used    (0),
+        capacity(capacity)
+    {
+    }
+
+public:
+    inline char *data()
+    { return reinterpret_cast<char *>(this) + ArenaRound(sizeof(Block)); }
+
+public:
+    /*
+     * Allocate a block, which holds a reference to its arena. Its live
+     * count is the objects in it, plus one while it's allocated from.
+     */
+    static Block *Create(Arena *arena, size_t capacity, size_t live)
+    {
+        void *memory = ::operator new(ArenaRound(sizeof(Block)) + capacity);
+        arena->_references++;
+        return new (memory) Block(arena, capacity, live);
+    }
+
+    void release()
+    {
+        if (--live == 0) {
+            Arena *arena = this->arena;
+            this->~Block();
+            ::operator delete(this);
+            arena->release();
+        }
+    }
+};
+
+Arena::Scope::
+Scope() :
+    _arena   (new Arena()),
+    _previous(ArenaCurrent)
+{
+    ArenaCurrent = _arena;
+}
+
+Arena::Scope::
+~Scope()
+{
+    ArenaCurrent = _previous;
+
+    /* Nothing more is allocated from the arena. */
+    for (void *&reuse : _arena->_reuse) {
+        while (reuse != nullptr) {
+            void *pointer = reuse;
+            reuse = *static_cast<void **>(pointer);
+
+            char *header = static_cast<char *>(pointer) - ArenaHeaderSize;
+            (*reinterpret_cast<Block **>(header))->release();
+        }
+    }
+
+    if (_arena->_block != nullptr) {
+        _arena->_block->release();
+        _arena->_block = nullptr;
+    }
+
+    _arena->release();
+}
+
+Arena::
+Arena() :
+    _references(1),
+    _block     (nullptr)
+{
+    for (void *&reuse : _reuse) {
+        reuse = nullptr;
+    }
+}
+
+Arena::
+~Arena()
+{
+}
+
+void Arena::
+release()
+{
+    if (--_references == 0) {
+        delete this;
+    }
+}
+
+void *Arena::
+allocate(size_t size)
+{
+    size_t rounded = ArenaRound(size);
+    if (rounded <= ArenaReuseSize) {
+        void *&reuse = _reuse[rounded / ArenaHeaderSize - 1];
+        if (reuse != nullptr) {
+            void *pointer = reuse;
+            reuse = *static_cast<void **>(pointer);
+            return pointer;
+        }
+    }
+
+    size_t needed = ArenaHeaderSize + rounded;
+
+    Block *block;
+    if (needed > ArenaLargeSize) {
+        block = Block::Create(this, needed, 0);
+    } else {
+        if (_block == nullptr || _block->capacity - _block->used < needed) {
+            if (_block != nullptr) {
+                _block->release();
+            }
+            _block = Block::Create(this, ArenaBlockSize, 1);
+        }
+        block = _block;
+    }
+
+    char *header = block->data() + block->used;
+    block->used += needed;
+    block->live++;
+
+    *reinterpret_cast<Block **>(header) = block;
+    return header + ArenaHeaderSize;
+}
+
+std::string const *Arena::
+intern(std::string const &string)
+{
+    /* Keep the index at most half full. */
+    if (_stringIndex.size() < (_strings.size() + 1) * 2) {
+        std::vector<std::pair<size_t, std::string const *>> index = std::vector<std::pair<size_t, std::string const *>>(std::max<size_t>(_stringIndex.size() * 2, 64));
+        size_t mask = index.size() - 1;
+        for (auto const &entry : _stringIndex) {
+            if (entry.second != nullptr) {
+                size_t slot = entry.first & mask;
+                while (index[slot].second != nullptr) {
+                    slot = (slot + 1) & mask;
+                }
+                index[slot] = entry;
+            }
+        }
+        _stringIndex.swap(index);
+    }
+
+    size_t hash = std::hash<std::string>()(string);
+    size_t mask = _stringIndex.size() - 1;
+    for (size_t slot = hash & mask; ; slot = (slot + 1) & mask) {
+        std::pair<size_t, std::string const *> &entry = _stringIndex[slot];
+        if (entry.second == nullptr) {
+            _strings.push_back(string);
+            entry = std::make_pair(hash, &_strings.back());
+            return entry.second;
+        } else if (entry.first == hash && *entry.second == string) {
+            return entry.second;
+        }
+    }
+}
+
+Arena *Arena::
+Current()
+{
+    return ArenaCurrent;
+}
+
+std::string const *Arena::
+Intern(std::string const &string)
+{
+    Arena *arena = ArenaCurrent;
+    if (arena == nullptr || string.size() > ArenaInternLength) {
+        return nullptr;
+    }
+
+    /* Short strings are stored inline, so sharing them saves nothing. */
+    if (string.size() <= std::string().capacity()) {
+        return nullptr;
+    }
+
+    return arena->intern(string);
+}
+
+void *Arena::
+Allocate(size_t size)
+{
+    if (Arena *arena = ArenaCurrent) {
+        return arena->allocate(size);
+    }
+
+    char *header = static_cast<char *>(::operator new(ArenaHeaderSize + size));
+    *reinterpret_cast<Block **>(header) = nullptr;
+    return header + ArenaHeaderSize;
+}
+
+void Arena::
+Deallocate(void *pointer, size_t size)
+{
+    if (pointer == nullptr) {
+        return;
+    }
+
+    char *header = static_cast<char *>(pointer) - ArenaHeaderSize;
+    if (Block *block = *reinterpret_cast<Block **>(header)) {
+        /* Still part of its block, so the block isn't released. */
+        size_t rounded = ArenaRound(size);
+        if (block->arena == ArenaCurrent && rounded <= ArenaReuseSize) {
+            void *&reuse = block->arena->_reuse[rounded / ArenaHeaderSize - 1];
+            *static_cast<void **>(pointer) = reuse;
+            reuse = pointer;
+            return;
+        }
+
+        block->release();
+    } else {
+        ::operator delete(header);
+    }
+}
@@ -8,14 +8,176 @@
  */
 
 #include <plist/Dictionary.h>
+#include <plist/Arena.h>
+
+#include <functional>
 
 using plist::Object;
+using plist::Arena;
 using plist::Dictionary;
 
+/*
+ * Dictionaries with more entries than this are indexed.
+ */
+static size_t const DictionaryIndexThreshold = 8;
+
 std::unique_ptr<Dictionary> Dictionary::
 New()
 {
-    return std::unique_ptr<Dictionary>(new Dictionary());
+    auto dictionary = std::unique_ptr<Dictionary>(new Dictionary());
+    dictionary->_arena = Arena::Current();
+    return dictionary;
+}
+
+void Dictionary::
+clear()
+{
+    for (Entry const &entry : _entries) {
+        if (entry.owned) {
+            delete entry.key;
+        }
+    }
+
+    _entries.clear();
+    std::vector<uint32_t>().swap(_index);
+}
+
+void Dictionary::
+set(std::string const &key, std::unique_ptr<Object> obj)
+{
+    /* Copy the key first, in case it's an existing key being removed. */
+    Entry entry;
+    if (_arena != nullptr && _arena == Arena::Current()) {
+        entry.key = _arena->intern(key);
+        entry.owned = false;
+    } else {
+        entry.key = new std::string(key);
+        entry.owned = true;
+    }
+    entry.value = std::move(obj);
+
+    remove(*entry.key);
+    _entries.push_back(std::move(entry));
+    insertIndex(_entries.size() - 1);
+}
+
+void Dictionary::
+remove(std::string const &key)
+{
+    size_t index = find(key);
+    if (index == npos) {
+        return;
+    }
+
+    removeIndex(index);
+    if (_entries[index].owned) {
+        delete _entries[index].key;
+    }
+    _entries.erase(_entries.begin() + index);
+}
+
+size_t Dictionary::
+find(std::string const &key) const
+{
+    if (_index.empty()) {
+        for (size_t index = 0; index < _entries.size(); index++) {
+            if (*_entries[index].key == key) {
+                return index;
+            }
+        }
+        return npos;
+    }
+
+    size_t mask = _index.size() - 1;
+    for (size_t slot = std::hash<std::string>()(key) & mask; _index[slot] != 0; slot = (slot + 1) & mask) {
+        size_t index = _index[slot] - 1;
+        if (*_entries[index].key == key) {
+            return index;
+        }
+    }
+    return npos;
+}
+
+void Dictionary::
+insertIndex(size_t index)
+{
+    if (_entries.size() <= DictionaryIndexThreshold) {
+        return;
+    }
+
+    /* Keep the index at most half full. */
+    if (_index.size() < _entries.size() * 2) {
+        rebuildIndex();
+        return;
+    }
+
+    size_t mask = _index.size() - 1;
+    size_t slot = std::hash<std::string>()(*_entries[index].key) & mask;
+    while (_index[slot] != 0) {
+        slot = (slot + 1) & mask;
+    }
+    _index[slot] = static_cast<uint32_t>(index + 1);
+}
+
+void Dictionary::
+removeIndex(size_t index)
+{
+    if (_index.empty()) {
+        return;
+    }
+
+    /* Small enough to search in order. */
+    if (_entries.size() - 1 <= DictionaryIndexThreshold) {
+        std::vector<uint32_t>().swap(_index);
+        return;
+    }
+
+    size_t mask = _index.size() - 1;
+    size_t hole = std::hash<std::string>()(*_entries[index].key) & mask;
+    while (_index[hole] != index + 1) {
+        hole = (hole + 1) & mask;
+    }
+
+    /*
+     * Move later entries in the same run back into the hole, unless that
+     * would put them before the slot they hash to.
+     */
+    for (size_t slot = (hole + 1) & mask; _index[slot] != 0; slot = (slot + 1) & mask) {
+        size_t home = std::hash<std::string>()(*_entries[_index[slot] - 1].key) & mask;
+        if (((slot - home) & mask) >= ((slot - hole) & mask)) {
+            _index[hole] = _index[slot];
+            hole = slot;
+        }
+    }
+    _index[hole] = 0;
+
+    /* Entries after the removed one move back by one. */
+    if (index + 1 < _entries.size()) {
+        for (uint32_t &slot : _index) {
+            if (slot > index + 1) {
+                slot--;
+            }
+        }
+    }
+}
+
+void Dictionary::
+rebuildIndex()
+{
+    if (_entries.size() <= DictionaryIndexThreshold) {
+        std::vector<uint32_t>().swap(_index);
+        return;
+    }
+
+    size_t size = 2 * DictionaryIndexThreshold;
+    while (size < _entries.size() * 4) {
+        size *= 2;
+    }
+
+    _index.assign(size, 0);
+    for (size_t index = 0; index < _entries.size(); index++) {
+        insertIndex(index);
+    }
 }
 
 std::unique_ptr<Object> Dictionary::
@@ -35,7 +197,7 @@ merge(Dictionary const *dict, bool replace)
         return;
 
     for (auto const &key : *dict) {
-        if (replace || _map.find(key) == _map.end()) {
+        if (replace || find(key) == npos) {
             set(key, dict->value(key)->copy());
         }
     }
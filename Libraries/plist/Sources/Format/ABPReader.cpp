@@ -73,9 +73,11 @@ readDate()
         return NULL;
     }
 
-    /* Reference time is 2001/1/1 */
-    static uint64_t const ReferenceTimestamp = 978307200;
-    return plist::Date::New(date - ReferenceTimestamp).release();
+    /* Seconds since the reference time, 2001/1/1. */
+    static double const ReferenceTimestamp = 978307200;
+    double converted;
+    memcpy(&converted, &date, sizeof(converted));
+    return plist::Date::New(static_cast<uint64_t>(converted + ReferenceTimestamp)).release();
 }
 
 plist::Integer *ABPReader::
@@ -57,14 +57,17 @@ writeOffsetTable()
         this->_trailer.offsetIntByteSize = sizeof(uint8_t);
     }
 
-    /* Write out the offsets. */
+    /* Write out the offsets at once. */
+    size_t nbytes = this->_trailer.offsetIntByteSize;
+    std::vector<uint8_t> table = std::vector<uint8_t>(static_cast<size_t>(this->_trailer.objectsCount) * nbytes);
+    uint8_t *p = table.data();
     for (n = 0; n < this->_trailer.objectsCount; n++) {
-        if (!this->writeOffset(this->_offsets[n])) {
-            return false;
+        for (size_t m = nbytes; m > 0; m--) {
+            *p++ = static_cast<uint8_t>(this->_offsets[n] >> ((m - 1) << 3));
         }
     }
 
-    return true;
+    return (table.empty() || this->write(table.data(), table.size()) == static_cast<int>(table.size()));
 }
 
 bool ABPWriter::
@@ -269,16 +272,16 @@ writeArray(Array const *array)
 String const *ABPWriter::
 dictionaryKeyString(Dictionary const *dict, int key)
 {
-    std::unordered_map<int, String *> *map = &this->_keyStrings[dict];
+    std::vector<std::unique_ptr<String>> *strings = &this->_keyStrings[dict];
 
-    auto it = map->find(key);
-    if (it != map->end()) {
-        return it->second;
-    } else {
-        auto string = String::New(dict->key(key));
-        map->insert({ key, string.get() });
-        return string.release();
+    if (strings->empty()) {
+        strings->reserve(dict->count());
+        for (size_t i = 0; i < dict->count(); ++i) {
+            strings->push_back(String::New(dict->key(i)));
+        }
     }
+
+    return (*strings)[key].get();
 }
 
 void ABPWriter::
@@ -364,49 +367,78 @@ writePreflightDictionary(Dictionary const *dict)
     return true;
 }
 
+template<typename T>
+static inline void
+ABPWriterAppendKey(std::string *key, T value)
+{
+    key->append(reinterpret_cast<char const *>(&value), sizeof(value));
+}
+
 /*
- * Process an object, calls the user callback in order to
- * return a suitable object for the encoding; the object
- * is added to the mapping table if different from the original
- * and a reference is associated with the object; valid references
- * are always non-zero.
- * If 'userProcess' is set, when an object is cached, the object
- * field is set to null and only the reference number is returned.
+ * Map an object to the first object seen with the same contents, so it's
+ * written once and referenced everywhere it appears. Objects are keyed on
+ * their type and contents; containers, if unique, on the unique objects
+ * they contain.
  */
-bool ABPWriter::
-processObject(Object const **object, uint32_t *refno, bool userProcess)
+Object const *ABPWriter::
+uniqueObject(Object const *object)
 {
-    Object const *newObject;
-    Object const *origObject = *object;
-
-    /* Is this object already mapped? */
-    auto mit = this->_mappings.find(origObject);
+    auto mit = this->_mappings.find(object);
     if (mit != this->_mappings.end()) {
-        newObject = mit->second;
-    } else {
-        newObject = origObject;
+        return mit->second;
+    }
 
-        /* Process the object for mapping. */
-        if (userProcess) {
-            ObjectType type = newObject->type();
-            /*
-             * Cache mapping, but do so only if newObject is different
-             * than the origObject or origObject is not a container.
-             */
-            if (newObject != origObject || (type != Array::Type() &&
-                                            type != Dictionary::Type() &&
-                                            type != Null::Type() &&
-                                            type != Boolean::Type())) {
-                this->_mappings.insert({ origObject, newObject });
-            }
-        } else {
-            /*
-             * The user callback can't handle this object, supposedly because
-             * we can.
-             */
+    std::string key;
+    key.push_back(static_cast<char>(object->type()));
+
+    bool unique = true;
+    if (auto string = plist::CastTo<String>(object)) {
+        key += string->value();
+    } else if (auto integer = plist::CastTo<Integer>(object)) {
+        ABPWriterAppendKey(&key, integer->value());
+    } else if (auto real = plist::CastTo<Real>(object)) {
+        ABPWriterAppendKey(&key, real->value());
+    } else if (auto boolean = plist::CastTo<Boolean>(object)) {
+        ABPWriterAppendKey(&key, boolean->value());
+    } else if (auto date = plist::CastTo<Date>(object)) {
+        ABPWriterAppendKey(&key, date->unixTimeValue());
+    } else if (auto data = plist::CastTo<Data>(object)) {
+        key.append(reinterpret_cast<char const *>(data->value().data()), data->value().size());
+    } else if (auto uid = plist::CastTo<UID>(object)) {
+        ABPWriterAppendKey(&key, uid->value());
+    } else if (auto array = plist::CastTo<Array>(object)) {
+        unique = this->_uniqueContainers;
+        for (size_t i = 0; unique && i < array->count(); ++i) {
+            ABPWriterAppendKey(&key, this->uniqueObject(array->value(i)));
         }
+    } else if (auto dict = plist::CastTo<Dictionary>(object)) {
+        unique = this->_uniqueContainers;
+        for (size_t i = 0; unique && i < dict->count(); ++i) {
+            ABPWriterAppendKey(&key, this->uniqueObject(this->dictionaryKeyString(dict, i)));
+            ABPWriterAppendKey(&key, this->uniqueObject(dict->value(i)));
+        }
+    }
+
+    Object const *result = object;
+    if (unique) {
+        result = this->_unique.insert({ std::move(key), object }).first->second;
     }
 
+    this->_mappings.insert({ object, result });
+    return result;
+}
+
+/*
+ * Process an object, mapping it to the unique object with the same
+ * contents; a reference is associated with the unique object; valid
+ * references are always non-zero.
+ * If 'userProcess' is set, when an object is cached, the object
+ * field is set to null and only the reference number is returned.
+ */
+bool ABPWriter::
+processObject(Object const **object, uint32_t *refno, bool userProcess)
+{
+    Object const *newObject = this->uniqueObject(*object);
     assert(newObject != NULL);
 
     /* Is this new object already written? */
@@ -548,9 +580,10 @@ writeObject(Object const *object, uint32_t flags)
  */
 
 ABPWriter::
-ABPWriter(std::vector<uint8_t> *contents) :
-    ABPContext      (contents),
-    _mutableContents(contents)
+ABPWriter(std::vector<uint8_t> *contents, bool uniqueContainers) :
+    ABPContext       (contents),
+    _uniqueContainers(uniqueContainers),
+    _mutableContents (contents)
 {
 }
 
@@ -611,11 +644,7 @@ close()
             return false;
     }
 
-    for (auto const &map : this->_keyStrings) {
-        for (auto const &item : map.second) {
-            item.second->release();
-        }
-    }
+    this->_keyStrings.clear();
 
     return true;
 }
@@ -651,9 +680,10 @@ writeTopLevelObject(Object const *object)
         }
 
         /* Allocate enough space for the offsets table. */
-        this->_offsets = static_cast<uint64_t *>(calloc(static_cast<size_t>(this->_trailer.objectsCount), sizeof(uint64_t)));
-        if (this->_offsets == NULL)
-            return false;
+        this->_offsets = new uint64_t[static_cast<size_t>(this->_trailer.objectsCount)]();
+
+        /* Most objects are small; avoid growing the output many times. */
+        this->_mutableContents->reserve(this->_mutableContents->size() + static_cast<size_t>(this->_trailer.objectsCount) * 16);
 
         /* Write all the objects. */
         success = this->writeObject(object, kABPWriteObjectTopLevel);
@@ -668,9 +698,17 @@ writeTopLevelObject(Object const *object)
 int ABPWriter::
 write(void const *data, size_t length)
 {
-    int needed = (this->_mutableContents->size() - this->_offset + length);
-    if (needed > 0) {
-        this->_mutableContents->resize(this->_mutableContents->size() + needed);
+    uint8_t const *bytes = static_cast<uint8_t const *>(data);
+
+    /* Output is almost always appended. */
+    if (static_cast<size_t>(this->_offset) == this->_mutableContents->size()) {
+        this->_mutableContents->insert(this->_mutableContents->end(), bytes, bytes + length);
+        this->_offset += length;
+        return length;
+    }
+
+    if (this->_offset + length > this->_mutableContents->size()) {
+        this->_mutableContents->resize(this->_offset + length);
     }
 
     /* Copy into write buffer. */
@@ -680,12 +718,6 @@ write(void const *data, size_t length)
     return length;
 }
 
-bool ABPWriter::
-writeByte(uint8_t byte)
-{
-    return (this->write(&byte, sizeof(byte)) == sizeof(byte));
-}
-
 bool ABPWriter::
 writeWord0(size_t nbytes, uint64_t value, bool swap)
 {
@@ -12,6 +12,8 @@
 #include <plist/Format/ASCIIWriter.h>
 #include <plist/Objects.h>
 
+#include <algorithm>
+
 using plist::Format::Type;
 using plist::Format::Encoding;
 using plist::Format::Format;
@@ -225,11 +227,28 @@ Deserialize(std::vector<uint8_t> const &contents, ASCII const &format)
     std::unique_ptr<Object> root = nullptr;
     std::string             error;
 
-    std::vector<uint8_t> const data = Encodings::Convert(contents, format.encoding(), Encoding::UTF8);
+    /*
+     * UTF-8 contents are lexed in place, after any BOM; other encodings
+     * are converted first.
+     */
+    std::vector<uint8_t> data;
+    uint8_t const *begin = contents.data();
+    size_t size = contents.size();
+    if (format.encoding() == Encoding::UTF8) {
+        std::vector<uint8_t> const BOM = Encodings::BOM(Encoding::UTF8);
+        if (size >= BOM.size() && std::equal(BOM.begin(), BOM.end(), contents.begin())) {
+            begin += BOM.size();
+            size -= BOM.size();
+        }
+    } else {
+        data = Encodings::Convert(contents, format.encoding(), Encoding::UTF8);
+        begin = data.data();
+        size = data.size();
+    }
 
     /* Create lexer. */
     ASCIIPListLexer lexer;
-    ASCIIPListLexerInit(&lexer, reinterpret_cast<char const *>(data.data()), data.size(), kASCIIPListLexerStyleASCII);
+    ASCIIPListLexerInit(&lexer, reinterpret_cast<char const *>(begin), size, kASCIIPListLexerStyleASCII);
 
     /* Parse contents. */
     ASCIIParser parser;
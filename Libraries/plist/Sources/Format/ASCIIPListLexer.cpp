@@ -14,6 +14,14 @@
 #include <string.h>
 #include <stdlib.h>
 
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define ASCIIPLIST_LEXER_SSE2 1
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+#endif
+
 /*
  * Syntax:
  *
@@ -82,6 +90,151 @@ istokenseparator(char ch, ASCIIPListLexer *lexer)
              (ch == ',' || ch == ';' || ch == ')' || ch == '=')));
 }
 
+/** Vectorized scanning **/
+
+/*
+ * Most of a document is runs of identifier characters, whitespace, quoted
+ * strings and comments. These skip over whole runs 16 bytes at a time,
+ * stopping exactly where the run ends. Each returns where it stopped; the
+ * scalar code always continues from there, so it handles the last bytes
+ * of the buffer and anything these don't.
+ */
+
+#if ASCIIPLIST_LEXER_SSE2
+static inline int
+ASCIIPListLexerFirstBit(unsigned mask)
+{
+#if defined(_MSC_VER)
+    unsigned long index;
+    _BitScanForward(&index, mask);
+    return (int)index;
+#else
+    return __builtin_ctz(mask);
+#endif
+}
+
+static inline int
+ASCIIPListLexerLastBit(unsigned mask)
+{
+#if defined(_MSC_VER)
+    unsigned long index;
+    _BitScanReverse(&index, mask);
+    return (int)index;
+#else
+    return 31 - __builtin_clz(mask);
+#endif
+}
+
+static inline int
+ASCIIPListLexerBitCount(unsigned mask)
+{
+#if defined(_MSC_VER)
+    return (int)__popcnt(mask);
+#else
+    return __builtin_popcount(mask);
+#endif
+}
+
+static inline __m128i
+ASCIIPListLexerEqual(__m128i bytes, char ch)
+{
+    return _mm_cmpeq_epi8(bytes, _mm_set1_epi8(ch));
+}
+
+/*
+ * Bytes between `low` and `high`, inclusive. Bytes with the high bit set
+ * compare as negative, so are never in a range of ASCII characters.
+ */
+static inline __m128i
+ASCIIPListLexerRange(__m128i bytes, char low, char high)
+{
+    return _mm_and_si128(_mm_cmpgt_epi8(bytes, _mm_set1_epi8(low - 1)),
+                         _mm_cmplt_epi8(bytes, _mm_set1_epi8(high + 1)));
+}
+#endif
+
+/*
+ * Find the first of up to four characters.
+ */
+static inline char const *
+ASCIIPListLexerFind(ASCIIPListLexer const *lexer, char const *p, char a, char b, char c, char d)
+{
+#if ASCIIPLIST_LEXER_SSE2
+    if (lexer->vectorized) {
+        while (lexer->endBuffer - p >= 16) {
+            __m128i bytes = _mm_loadu_si128((__m128i const *)p);
+            __m128i match = _mm_or_si128(_mm_or_si128(ASCIIPListLexerEqual(bytes, a), ASCIIPListLexerEqual(bytes, b)),
+                                         _mm_or_si128(ASCIIPListLexerEqual(bytes, c), ASCIIPListLexerEqual(bytes, d)));
+            unsigned mask = (unsigned)_mm_movemask_epi8(match);
+            if (mask != 0) {
+                return p + ASCIIPListLexerFirstBit(mask);
+            }
+            p += 16;
+        }
+    }
+#endif
+    return p;
+}
+
+/*
+ * Skip the characters of an unquoted string: alphanumerics and any of
+ * "_.$-:/". The range '-' to ':' covers "-./", the digits and ':'.
+ */
+static inline char const *
+ASCIIPListLexerSkipIdentifier(ASCIIPListLexer const *lexer, char const *p)
+{
+#if ASCIIPLIST_LEXER_SSE2
+    if (lexer->vectorized) {
+        while (lexer->endBuffer - p >= 16) {
+            __m128i bytes = _mm_loadu_si128((__m128i const *)p);
+            __m128i identifier = _mm_or_si128(_mm_or_si128(ASCIIPListLexerRange(bytes, '-', ':'), ASCIIPListLexerRange(bytes, 'A', 'Z')),
+                                              _mm_or_si128(ASCIIPListLexerRange(bytes, 'a', 'z'),
+                                                           _mm_or_si128(ASCIIPListLexerEqual(bytes, '_'), ASCIIPListLexerEqual(bytes, '$'))));
+            unsigned mask = ~(unsigned)_mm_movemask_epi8(identifier) & 0xffff;
+            if (mask != 0) {
+                return p + ASCIIPListLexerFirstBit(mask);
+            }
+            p += 16;
+        }
+    }
+#endif
+    return p;
+}
+
+/*
+ * Skip whitespace between tokens, counting lines.
+ */
+static inline char const *
+ASCIIPListLexerSkipSpace(ASCIIPListLexer *lexer, char const *p)
+{
+#if ASCIIPLIST_LEXER_SSE2
+    if (lexer->vectorized) {
+        while (lexer->endBuffer - p >= 16) {
+            __m128i bytes = _mm_loadu_si128((__m128i const *)p);
+            __m128i newline = ASCIIPListLexerEqual(bytes, '\n');
+            __m128i space = _mm_or_si128(_mm_or_si128(newline, ASCIIPListLexerEqual(bytes, ' ')),
+                                         _mm_or_si128(ASCIIPListLexerEqual(bytes, '\t'),
+                                                      _mm_or_si128(ASCIIPListLexerEqual(bytes, '\r'), ASCIIPListLexerEqual(bytes, '\f'))));
+
+            unsigned other = ~(unsigned)_mm_movemask_epi8(space) & 0xffff;
+            int length = (other != 0 ? ASCIIPListLexerFirstBit(other) : 16);
+
+            unsigned lines = (unsigned)_mm_movemask_epi8(newline) & ((1u << length) - 1);
+            if (lines != 0) {
+                lexer->line += ASCIIPListLexerBitCount(lines);
+                lexer->lineStart = p + ASCIIPListLexerLastBit(lines) + 1;
+            }
+
+            p += length;
+            if (other != 0) {
+                break;
+            }
+        }
+    }
+#endif
+    return p;
+}
+
 static inline bool
 isodigit(char ch)
 { return (ch >= '0' && ch <= '7'); }
@@ -107,7 +260,9 @@ ASCIIPListLexerReadInlineComment(ASCIIPListLexer *lexer)
     char const *b, *p = lexer->pointer + 2;
 
     lexer->tokenBegin = (p - lexer->inputBuffer);
-    for (b = p; *p != '\0' && *p != '\n' && *p != '\r'; p++)
+    b = p;
+    p = ASCIIPListLexerFind(lexer, p, '\0', '\n', '\r', '\r');
+    for (; p < lexer->endBuffer && *p != '\0' && *p != '\n' && *p != '\r'; p++)
         ;
     lexer->tokenLength = p - b;
     lexer->pointer = p;
@@ -121,11 +276,14 @@ ASCIIPListLexerReadLongComment(ASCIIPListLexer *lexer)
     char const *b, *p = lexer->pointer + 2;
 
     lexer->tokenBegin = (p - lexer->inputBuffer);
-    for (b = p; *p != '\0'; p++) {
-        if (p[0] == '\n') {
+    for (b = p; p < lexer->endBuffer; p++) {
+        p = ASCIIPListLexerFind(lexer, p, '\0', '\n', '*', '*');
+        if (p >= lexer->endBuffer || *p == '\0') {
+            break;
+        } else if (p[0] == '\n') {
             lexer->line++;
             lexer->lineStart = p + 1;
-        } else if (p[0] == '*' && p[1] == '/') {
+        } else if (p[0] == '*' && p + 1 < lexer->endBuffer && p[1] == '/') {
             lexer->tokenLength = p - b;
             lexer->pointer = p + 2;
             return kASCIIPListLexerTokenLongComment;
@@ -141,14 +299,17 @@ ASCIIPListLexerReadSingleQuotedString(ASCIIPListLexer *lexer)
     char const *b, *p = lexer->pointer + 1;
 
     lexer->tokenBegin = (p - lexer->inputBuffer);
-    for (b = p; *p != '\'' && *p != '\0'; p++) {
-        if (*p == '\n') {
+    for (b = p; p < lexer->endBuffer; p++) {
+        p = ASCIIPListLexerFind(lexer, p, '\'', '\0', '\n', '\n');
+        if (p >= lexer->endBuffer || *p == '\'' || *p == '\0') {
+            break;
+        } else if (*p == '\n') {
             lexer->line++;
             lexer->lineStart = p + 1;
         }
     }
 
-    if (*p != '\'') {
+    if (p >= lexer->endBuffer || *p != '\'') {
         return kASCIIPListLexerUnterminatedQuotedString;
     }
 
@@ -164,8 +325,11 @@ ASCIIPListLexerReadDoubleQuotedString(ASCIIPListLexer *lexer)
     char const *b, *p = lexer->pointer + 1;
 
     lexer->tokenBegin = (p - lexer->inputBuffer);
-    for (b = p; *p != '\"' && *p != '\0'; p++) {
-        if (*p == '\n') {
+    for (b = p; p < lexer->endBuffer; p++) {
+        p = ASCIIPListLexerFind(lexer, p, '\"', '\0', '\n', '\\');
+        if (p >= lexer->endBuffer || *p == '\"' || *p == '\0') {
+            break;
+        } else if (*p == '\n') {
             lexer->line++;
             lexer->lineStart = p + 1;
         } else if (*p == '\\') {
@@ -173,7 +337,7 @@ ASCIIPListLexerReadDoubleQuotedString(ASCIIPListLexer *lexer)
         }
     }
 
-    if (*p != '\"') {
+    if (p >= lexer->endBuffer || *p != '\"') {
         return kASCIIPListLexerUnterminatedQuotedString;
     }
 
@@ -316,8 +480,10 @@ ASCIIPListLexerReadKeyword(ASCIIPListLexer *lexer)
         /*
             * '$' is encountered in pbxproj files.
             */
-        while (isalnum(*p) || *p == '_' || *p == '.' || *p == '$' ||
-                              *p == '-' || *p == ':' || *p == '/') {
+        p = ASCIIPListLexerSkipIdentifier(lexer, p);
+        while (p < lexer->endBuffer &&
+               (isalnum(*p) || *p == '_' || *p == '.' || *p == '$' ||
+                              *p == '-' || *p == ':' || *p == '/')) {
             if (*p & 0x80) {
                 rc = kASCIIPListLexerInvalidToken;
                 break;
@@ -444,10 +610,12 @@ ASCIIPListLexerReadToken(ASCIIPListLexer *lexer)
 
             case ' ': case '\f': case '\t': case '\r':
                  p++;
+                 p = ASCIIPListLexerSkipSpace(lexer, p);
                  break;
 
             case '\n':
                  p++, lexer->line++; lexer->lineStart = p;
+                 p = ASCIIPListLexerSkipSpace(lexer, p);
                  break;
 
             default:
@@ -481,6 +649,9 @@ ASCIIPListLexerInit(ASCIIPListLexer *lexer, char const *buffer, int length,
     lexer->endBuffer = lexer->inputBuffer + length;
     lexer->style = style;
     lexer->line = 1;
+#if ASCIIPLIST_LEXER_SSE2
+    lexer->vectorized = 1;
+#endif
 }
 
 /* Convert sequence \xXX */
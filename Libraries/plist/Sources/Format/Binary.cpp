@@ -22,7 +22,8 @@ using plist::Format::Binary;
 using plist::Object;
 
 Binary::
-Binary()
+Binary(bool uniqueContainers) :
+    _uniqueContainers(uniqueContainers)
 {
 }
 
@@ -76,7 +77,7 @@ Serialize(Object const *object, Binary const &format)
     bool success;
 
     auto contents = std::unique_ptr<std::vector<uint8_t>>(new std::vector<uint8_t>());
-    ABPWriter writer = ABPWriter(contents.get());
+    ABPWriter writer = ABPWriter(contents.get(), format.uniqueContainers());
 
     success = writer.open();
     if (!success) {
@@ -104,7 +105,7 @@ Serialize(Object const *object, Binary const &format)
 } }
 
 Binary Binary::
-Create()
+Create(bool uniqueContainers)
 {
-    return Binary();
+    return Binary(uniqueContainers);
 }
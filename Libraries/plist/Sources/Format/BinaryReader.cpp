@@ -0,0 +1,497 @@
+/**
+ Copyright (c) 2015-present, Facebook, Inc.
+ All rights reserved.
+
+ This source code is licensed under the BSD-style license found in the
+ LICENSE file in the root directory of this source tree. An additional grant
+ of patent rights can be found in the PATENTS file in the same directory.
+ */
+
+#include <plist/Format/BinaryReader.h>
+#include <plist/Format/ABPRecordType.h>
+#include <plist/Format/Encoding.h>
+#include <plist/Format/abplist-format.h>
+#include <plist/Objects.h>
+
+#include <algorithm>
+#include <cstring>
+
+using plist::Format::BinaryReader;
+using plist::Format::Encoding;
+using plist::Format::Encodings;
+using plist::Object;
+using plist::ObjectType;
+using libutil::Filesystem;
+
+/*
+ * Reference time of dates is 2001/1/1.
+ */
+static double const BinaryReaderReferenceTimestamp = 978307200;
+
+BinaryReader::
+BinaryReader(std::unique_ptr<Filesystem::Mapping> mapping, uint8_t const *data, size_t size) :
+    _mapping      (std::move(mapping)),
+    _data         (data),
+    _size         (size),
+    _offsetSize   (0),
+    _referenceSize(0),
+    _count        (0),
+    _root         (0),
+    _offsetTable  (0)
+{
+}
+
+BinaryReader::
+~BinaryReader()
+{
+}
+
+bool BinaryReader::
+word(size_t offset, size_t nbytes, uint64_t *result) const
+{
+    if (nbytes > 8 || offset > _size || nbytes > _size - offset) {
+        return false;
+    }
+
+    uint64_t value = 0;
+    for (size_t n = 0; n < nbytes; n++) {
+        value = (value << 8) | _data[offset + n];
+    }
+
+    *result = value;
+    return true;
+}
+
+bool BinaryReader::
+offset(Reference reference, size_t *offset) const
+{
+    if (reference >= _count) {
+        return false;
+    }
+
+    uint64_t value;
+    if (!this->word(_offsetTable + static_cast<size_t>(reference) * _offsetSize, _offsetSize, &value)) {
+        return false;
+    }
+
+    /* Objects are between the header and the offset table. */
+    if (value < sizeof(abplist_header_t) || value >= _offsetTable) {
+        return false;
+    }
+
+    *offset = static_cast<size_t>(value);
+    return true;
+}
+
+/*
+ * Read the marker byte of an object, and the length in its low bits or
+ * following it, if any. The object's contents follow at `start`.
+ */
+bool BinaryReader::
+marker(Reference reference, uint8_t *marker, size_t *length, size_t *start) const
+{
+    size_t offset;
+    if (!this->offset(reference, &offset)) {
+        return false;
+    }
+
+    /* Skip any fill bytes. */
+    while (offset < _offsetTable && __ABPByteToRecordType(_data[offset]) == kABPRecordTypeFill) {
+        offset++;
+    }
+    if (offset >= _offsetTable) {
+        return false;
+    }
+
+    uint8_t byte = _data[offset];
+    size_t count = (byte & 0x0f);
+    offset++;
+
+    switch (__ABPByteToRecordType(byte)) {
+        case kABPRecordTypeData:
+        case kABPRecordTypeStringASCII:
+        case kABPRecordTypeStringUnicode:
+        case kABPRecordTypeArray:
+        case kABPRecordTypeDictionary:
+            if (count == 0x0f) {
+                /* Longer lengths follow as an integer. */
+                if (offset >= _offsetTable || (_data[offset] & 0xf0) != 0x10) {
+                    return false;
+                }
+
+                uint64_t value;
+                size_t nbytes = (static_cast<size_t>(1) << (_data[offset] & 0x0f));
+                if (!this->word(offset + 1, nbytes, &value) || value > _size) {
+                    return false;
+                }
+
+                count = static_cast<size_t>(value);
+                offset += 1 + nbytes;
+            }
+            break;
+        case kABPRecordTypeInvalid:
+            return false;
+        default:
+            break;
+    }
+
+    if (offset > _offsetTable) {
+        return false;
+    }
+
+    *marker = byte;
+    *length = count;
+    *start = offset;
+    return true;
+}
+
+bool BinaryReader::
+reference(size_t start, size_t index, Reference *result) const
+{
+    if (index >= (_offsetTable - start) / _referenceSize) {
+        return false;
+    }
+
+    return this->word(start + index * _referenceSize, _referenceSize, result);
+}
+
+ObjectType BinaryReader::
+type(Reference reference) const
+{
+    uint8_t marker;
+    size_t length, start;
+    if (!this->marker(reference, &marker, &length, &start)) {
+        return ObjectType::None;
+    }
+
+    switch (__ABPByteToRecordType(marker)) {
+        case kABPRecordTypeNull:          return ObjectType::Null;
+        case kABPRecordTypeBoolTrue:      return ObjectType::Boolean;
+        case kABPRecordTypeBoolFalse:     return ObjectType::Boolean;
+        case kABPRecordTypeDate:          return ObjectType::Date;
+        case kABPRecordTypeInteger:       return ObjectType::Integer;
+        case kABPRecordTypeReal:          return ObjectType::Real;
+        case kABPRecordTypeData:          return ObjectType::Data;
+        case kABPRecordTypeStringASCII:   return ObjectType::String;
+        case kABPRecordTypeStringUnicode: return ObjectType::String;
+        case kABPRecordTypeUid:           return ObjectType::UID;
+        case kABPRecordTypeArray:         return ObjectType::Array;
+        case kABPRecordTypeDictionary:    return ObjectType::Dictionary;
+        default:                          return ObjectType::None;
+    }
+}
+
+size_t BinaryReader::
+count(Reference reference) const
+{
+    uint8_t marker;
+    size_t length, start;
+    if (!this->marker(reference, &marker, &length, &start)) {
+        return 0;
+    }
+
+    ABPRecordType type = __ABPByteToRecordType(marker);
+    if (type != kABPRecordTypeArray && type != kABPRecordTypeDictionary) {
+        return 0;
+    }
+
+    return length;
+}
+
+bool BinaryReader::
+value(Reference array, size_t index, Reference *result) const
+{
+    uint8_t marker;
+    size_t length, start;
+    if (!this->marker(array, &marker, &length, &start)) {
+        return false;
+    }
+
+    if (__ABPByteToRecordType(marker) != kABPRecordTypeArray || index >= length) {
+        return false;
+    }
+
+    return this->reference(start, index, result);
+}
+
+bool BinaryReader::
+value(Reference dictionary, std::string const &key, Reference *result) const
+{
+    uint8_t marker;
+    size_t length, start;
+    if (!this->marker(dictionary, &marker, &length, &start)) {
+        return false;
+    }
+
+    if (__ABPByteToRecordType(marker) != kABPRecordTypeDictionary) {
+        return false;
+    }
+
+    /* Only converted if there are non-ASCII keys. */
+    std::vector<uint8_t> unicode;
+
+    /* Keys are all before values. */
+    for (size_t n = 0; n < length; n++) {
+        Reference keyReference;
+        if (!this->reference(start, n, &keyReference)) {
+            return false;
+        }
+
+        uint8_t keyMarker;
+        size_t keyLength, keyStart;
+        if (!this->marker(keyReference, &keyMarker, &keyLength, &keyStart)) {
+            return false;
+        }
+
+        bool match = false;
+        switch (__ABPByteToRecordType(keyMarker)) {
+            case kABPRecordTypeStringASCII:
+                match = (keyLength == key.size() &&
+                         keyLength <= _offsetTable - keyStart &&
+                         std::memcmp(_data + keyStart, key.data(), keyLength) == 0);
+                break;
+            case kABPRecordTypeStringUnicode:
+                if (unicode.empty() && !key.empty()) {
+                    unicode = Encodings::Convert(std::vector<uint8_t>(key.begin(), key.end()), Encoding::UTF8, Encoding::UTF16BE);
+                }
+                match = (keyLength * sizeof(uint16_t) == unicode.size() &&
+                         unicode.size() <= _offsetTable - keyStart &&
+                         std::equal(unicode.begin(), unicode.end(), _data + keyStart));
+                break;
+            default:
+                break;
+        }
+
+        if (match) {
+            return this->reference(start, length + n, result);
+        }
+    }
+
+    return false;
+}
+
+std::unique_ptr<Object> BinaryReader::
+decode(Reference reference, std::vector<Reference> *parents, std::string *error) const
+{
+    uint8_t marker;
+    size_t length, start;
+    if (!this->marker(reference, &marker, &length, &start)) {
+        *error = "invalid object reference";
+        return nullptr;
+    }
+
+    size_t available = _offsetTable - start;
+
+    switch (__ABPByteToRecordType(marker)) {
+        case kABPRecordTypeNull:
+            return plist::Null::New();
+        case kABPRecordTypeBoolTrue:
+            return plist::Boolean::New(true);
+        case kABPRecordTypeBoolFalse:
+            return plist::Boolean::New(false);
+        case kABPRecordTypeDate: {
+            uint64_t value;
+            if (!this->word(start, 8, &value)) {
+                *error = "EOF reading date value";
+                return nullptr;
+            }
+
+            double converted;
+            std::memcpy(&converted, &value, sizeof(converted));
+            return plist::Date::New(static_cast<uint64_t>(converted + BinaryReaderReferenceTimestamp));
+        }
+        case kABPRecordTypeInteger: {
+            uint64_t value;
+            if (!this->word(start, static_cast<size_t>(1) << length, &value)) {
+                *error = "EOF reading integer value";
+                return nullptr;
+            }
+
+            return plist::Integer::New(static_cast<int64_t>(value));
+        }
+        case kABPRecordTypeReal: {
+            uint64_t value;
+            size_t nbytes = (static_cast<size_t>(1) << length);
+            if (!this->word(start, nbytes, &value)) {
+                *error = "EOF reading real value";
+                return nullptr;
+            }
+
+            if (nbytes == 4) {
+                uint32_t bits = static_cast<uint32_t>(value);
+                float converted;
+                std::memcpy(&converted, &bits, sizeof(converted));
+                return plist::Real::New(converted);
+            } else if (nbytes == 8) {
+                double converted;
+                std::memcpy(&converted, &value, sizeof(converted));
+                return plist::Real::New(converted);
+            } else {
+                return plist::Real::New(0.0);
+            }
+        }
+        case kABPRecordTypeData: {
+            if (length > available) {
+                *error = "EOF reading data value";
+                return nullptr;
+            }
+
+            return plist::Data::New(_data + start, length);
+        }
+        case kABPRecordTypeUid: {
+            uint64_t value;
+            if (length + 1 > 4 || !this->word(start, length + 1, &value)) {
+                *error = "invalid UID value";
+                return nullptr;
+            }
+
+            return plist::UID::New(static_cast<uint32_t>(value));
+        }
+        case kABPRecordTypeStringASCII: {
+            if (length > available) {
+                *error = "EOF reading ASCII string value";
+                return nullptr;
+            }
+
+            return plist::String::New(std::string(reinterpret_cast<char const *>(_data + start), length));
+        }
+        case kABPRecordTypeStringUnicode: {
+            if (length > available / sizeof(uint16_t)) {
+                *error = "EOF reading Unicode string value";
+                return nullptr;
+            }
+
+            std::vector<uint8_t> buffer = std::vector<uint8_t>(_data + start, _data + start + length * sizeof(uint16_t));
+            buffer = Encodings::Convert(buffer, Encoding::UTF16BE, Encoding::UTF8);
+            return plist::String::New(std::string(buffer.begin(), buffer.end()));
+        }
+        case kABPRecordTypeArray:
+        case kABPRecordTypeDictionary:
+            break;
+        default:
+            *error = "unsupported type id";
+            return nullptr;
+    }
+
+    /* Containers can't contain themselves. */
+    if (std::find(parents->begin(), parents->end(), reference) != parents->end()) {
+        *error = "object contains itself";
+        return nullptr;
+    }
+    parents->push_back(reference);
+
+    std::unique_ptr<Object> result;
+    if (__ABPByteToRecordType(marker) == kABPRecordTypeArray) {
+        std::unique_ptr<plist::Array> array = plist::Array::New();
+        for (size_t n = 0; n < length; n++) {
+            Reference valueReference;
+            if (!this->reference(start, n, &valueReference)) {
+                *error = "corrupted array's object references table";
+                return nullptr;
+            }
+
+            std::unique_ptr<Object> value = this->decode(valueReference, parents, error);
+            if (value == nullptr) {
+                return nullptr;
+            }
+
+            array->append(std::move(value));
+        }
+        result = std::move(array);
+    } else {
+        std::unique_ptr<plist::Dictionary> dictionary = plist::Dictionary::New();
+        for (size_t n = 0; n < length; n++) {
+            Reference keyReference, valueReference;
+            if (!this->reference(start, n, &keyReference) || !this->reference(start, length + n, &valueReference)) {
+                *error = "corrupted dictionary's references table";
+                return nullptr;
+            }
+
+            std::unique_ptr<Object> key = this->decode(keyReference, parents, error);
+            if (key == nullptr) {
+                return nullptr;
+            }
+
+            plist::String const *keyString = plist::CastTo<plist::String>(key.get());
+            if (keyString == nullptr) {
+                *error = "dictionary key is not a string";
+                return nullptr;
+            }
+
+            std::unique_ptr<Object> value = this->decode(valueReference, parents, error);
+            if (value == nullptr) {
+                return nullptr;
+            }
+
+            dictionary->set(keyString->value(), std::move(value));
+        }
+        result = std::move(dictionary);
+    }
+
+    parents->pop_back();
+    return result;
+}
+
+std::pair<std::unique_ptr<Object>, std::string> BinaryReader::
+object(Reference reference) const
+{
+    std::vector<Reference> parents;
+    std::string error;
+
+    std::unique_ptr<Object> object = this->decode(reference, &parents, &error);
+    return std::make_pair(std::move(object), error);
+}
+
+std::pair<std::unique_ptr<BinaryReader>, std::string> BinaryReader::
+Open(uint8_t const *data, size_t size)
+{
+    std::unique_ptr<BinaryReader> reader = std::unique_ptr<BinaryReader>(new BinaryReader(nullptr, data, size));
+
+    if (size < sizeof(abplist_header_t) + sizeof(abplist_trailer_t) ||
+        std::memcmp(data, ABPLIST_MAGIC ABPLIST_VERSION, sizeof(abplist_header_t)) != 0) {
+        return std::make_pair(nullptr, "not a binary property list or corrupted header");
+    }
+
+    /* Only the trailer and the offset table it points to are checked now. */
+    size_t trailer = size - sizeof(abplist_trailer_t);
+    uint64_t offsetSize, referenceSize, offsetTable;
+    if (!reader->word(trailer + 6, 1, &offsetSize) ||
+        !reader->word(trailer + 7, 1, &referenceSize) ||
+        !reader->word(trailer + 8, 8, &reader->_count) ||
+        !reader->word(trailer + 16, 8, &reader->_root) ||
+        !reader->word(trailer + 24, 8, &offsetTable)) {
+        return std::make_pair(nullptr, "corrupted trailer");
+    }
+
+    if (offsetSize < 1 || offsetSize > 8 || referenceSize < 1 || referenceSize > 8 ||
+        reader->_count == 0 || reader->_root >= reader->_count) {
+        return std::make_pair(nullptr, "corrupted trailer");
+    }
+
+    if (offsetTable < sizeof(abplist_header_t) || offsetTable > trailer ||
+        reader->_count > (trailer - offsetTable) / offsetSize) {
+        return std::make_pair(nullptr, "corrupted offsets table");
+    }
+
+    reader->_offsetSize = static_cast<size_t>(offsetSize);
+    reader->_referenceSize = static_cast<size_t>(referenceSize);
+    reader->_offsetTable = static_cast<size_t>(offsetTable);
+
+    return std::make_pair(std::move(reader), std::string());
+}
+
+std::pair<std::unique_ptr<BinaryReader>, std::string> BinaryReader::
+Open(Filesystem const *filesystem, std::string const &path)
+{
+    std::unique_ptr<Filesystem::Mapping> mapping = filesystem->map(path);
+    if (mapping == nullptr) {
+        return std::make_pair(nullptr, "unable to read " + path);
+    }
+
+    std::pair<std::unique_ptr<BinaryReader>, std::string> result = Open(mapping->data(), mapping->size());
+    if (result.first != nullptr) {
+        result.first->_mapping = std::move(mapping);
+    }
+
+    return result;
+}
@@ -0,0 +1,286 @@
+/**
+ Copyright (c) 2015-present, Facebook, Inc.
+ All rights reserved.
+
+ This source code is licensed under the BSD-style license found in the
+ LICENSE file in the root directory of this source tree. An additional grant
+ of patent rights can be found in the PATENTS file in the same directory.
+ */
+
+#include <plist/Format/JSONReader.h>
+#include <plist/Format/ASCIIPListLexer.h>
+#include <plist/Objects.h>
+
+#include <cstdlib>
+#include <cstring>
+
+using plist::Format::JSONReader;
+using plist::Object;
+using plist::ObjectType;
+
+JSONReader::
+JSONReader(uint8_t const *data, size_t size) :
+    _lexer   (new ASCIIPListLexer()),
+    _state   (State::Value),
+    _token   (Token::Null),
+    _integer (0),
+    _real    (0.0)
+{
+    ASCIIPListLexerInit(_lexer.get(), reinterpret_cast<char const *>(data), size, kASCIIPListLexerStyleJSON);
+}
+
+JSONReader::
+~JSONReader()
+{
+}
+
+JSONReader::Token JSONReader::
+fail(std::string const &error)
+{
+    _error = error;
+    _token = Token::Error;
+    return _token;
+}
+
+void JSONReader::
+copyString()
+{
+    char const *begin = _lexer->inputBuffer + _lexer->tokenBegin;
+    size_t length = _lexer->tokenLength;
+
+    if (memchr(begin, '\\', length) == NULL) {
+        /* Nothing to unescape: skip the copy. */
+        char const *nul = static_cast<char const *>(memchr(begin, '\0', length));
+        _string.assign(begin, nul != NULL ? nul - begin : length);
+    } else {
+        char *contents = ASCIIPListCopyUnquotedString(_lexer.get(), '?');
+        _string.assign(contents);
+        free(contents);
+    }
+}
+
+void JSONReader::
+copyToken()
+{
+    /* Numbers have no escapes, so just terminate them for parsing. */
+    _string.assign(_lexer->inputBuffer + _lexer->tokenBegin, _lexer->tokenLength);
+}
+
+JSONReader::Token JSONReader::
+close(bool dictionary)
+{
+    if (_containers.empty() || _containers.back() != dictionary) {
+        return fail("Closing array/dictionary in wrong state.");
+    }
+
+    _containers.pop_back();
+    _state = (_containers.empty() ? State::Done : State::EntrySeparator);
+    _token = (dictionary ? Token::DictionaryEnd : Token::ArrayEnd);
+    return _token;
+}
+
+JSONReader::Token JSONReader::
+value(Token token)
+{
+    _state = (_containers.empty() ? State::Done : State::EntrySeparator);
+    _token = token;
+    return _token;
+}
+
+JSONReader::Token JSONReader::
+next()
+{
+    if (_token == Token::Error || _token == Token::End) {
+        return _token;
+    }
+
+    for (;;) {
+        int token = ASCIIPListLexerReadToken(_lexer.get());
+        if (token < 0) {
+            if (token == kASCIIPListLexerEndOfFile && _state == State::Done) {
+                _token = Token::End;
+                return _token;
+            } else if (token == kASCIIPListLexerEndOfFile) {
+                return fail("Encountered premature EOF");
+            } else if (token == kASCIIPListLexerInvalidToken) {
+                return fail("Encountered invalid token");
+            } else if (token == kASCIIPListLexerUnterminatedQuotedString) {
+                return fail("Encountered unterminated quoted string");
+            } else {
+                return fail("Encountered unrecognized token error code");
+            }
+        }
+
+        switch (_state) {
+            case State::Done:
+                return fail("Encountered token when finished.");
+
+            case State::KeyValueSeparator:
+                if (token != kASCIIPListLexerTokenDictionaryKeyValSeparator) {
+                    return fail("Expected key-value separator; found something else");
+                }
+                _state = State::Value;
+                break;
+
+            case State::EntrySeparator:
+                if (token == ',') {
+                    _state = (_containers.back() ? State::Key : State::Value);
+                } else if (token == kASCIIPListLexerTokenDictionaryEnd) {
+                    return close(true);
+                } else if (token == kASCIIPListLexerTokenArrayEnd) {
+                    return close(false);
+                } else {
+                    return fail("Unexpected token");
+                }
+                break;
+
+            case State::Key:
+                if (token == kASCIIPListLexerTokenQuotedString) {
+                    copyString();
+                    _state = State::KeyValueSeparator;
+                    _token = Token::Key;
+                    return _token;
+                } else if (token == kASCIIPListLexerTokenDictionaryEnd) {
+                    /* Empty dictionary, or a trailing separator. */
+                    return close(true);
+                } else if (token == kASCIIPListLexerTokenBoolTrue || token == kASCIIPListLexerTokenBoolFalse) {
+                    return fail("Boolean cannot be dictionary key");
+                } else if (token == kASCIIPListLexerTokenNull) {
+                    return fail("Null cannot be dictionary key");
+                } else if (token == kASCIIPListLexerTokenNumberInteger) {
+                    return fail("Integer cannot be dictionary key");
+                } else if (token == kASCIIPListLexerTokenNumberReal) {
+                    return fail("Real cannot be dictionary key");
+                } else {
+                    return fail("Unexpected token");
+                }
+
+            case State::Value:
+                if (token == kASCIIPListLexerTokenDictionaryStart) {
+                    _containers.push_back(true);
+                    _state = State::Key;
+                    _token = Token::DictionaryStart;
+                    return _token;
+                } else if (token == kASCIIPListLexerTokenArrayStart) {
+                    _containers.push_back(false);
+                    _state = State::Value;
+                    _token = Token::ArrayStart;
+                    return _token;
+                } else if (token == kASCIIPListLexerTokenArrayEnd && !_containers.empty() && !_containers.back()) {
+                    /* Empty array, or a trailing separator. */
+                    return close(false);
+                } else if (token == kASCIIPListLexerTokenQuotedString) {
+                    copyString();
+                    return value(Token::String);
+                } else if (token == kASCIIPListLexerTokenNumberInteger) {
+                    char *end = NULL;
+                    copyToken();
+                    _integer = ::strtoll(_string.c_str(), &end, 0);
+                    if (end == _string.c_str()) {
+                        return fail("Unable to parse integer");
+                    }
+                    return value(Token::Integer);
+                } else if (token == kASCIIPListLexerTokenNumberReal) {
+                    char *end = NULL;
+                    copyToken();
+                    _real = ::strtod(_string.c_str(), &end);
+                    if (end == _string.c_str()) {
+                        return fail("Unable to parse real");
+                    }
+                    return value(Token::Real);
+                } else if (token == kASCIIPListLexerTokenBoolTrue || token == kASCIIPListLexerTokenBoolFalse) {
+                    _integer = (token == kASCIIPListLexerTokenBoolTrue);
+                    return value(Token::Boolean);
+                } else if (token == kASCIIPListLexerTokenNull) {
+                    return value(Token::Null);
+                } else if (token == kASCIIPListLexerTokenDictionaryEnd || token == kASCIIPListLexerTokenArrayEnd) {
+                    return fail("Closing array/dictionary in wrong state.");
+                } else {
+                    return fail("Unknown token found: " + std::to_string(token));
+                }
+        }
+    }
+}
+
+ObjectType JSONReader::
+type() const
+{
+    switch (_token) {
+        case Token::DictionaryStart: return ObjectType::Dictionary;
+        case Token::ArrayStart:      return ObjectType::Array;
+        case Token::String:          return ObjectType::String;
+        case Token::Integer:         return ObjectType::Integer;
+        case Token::Real:            return ObjectType::Real;
+        case Token::Boolean:         return ObjectType::Boolean;
+        case Token::Null:            return ObjectType::Null;
+        default:                     return ObjectType::None;
+    }
+}
+
+bool JSONReader::
+skip()
+{
+    if (_token != Token::DictionaryStart && _token != Token::ArrayStart) {
+        return (_token != Token::Error);
+    }
+
+    size_t depth = _containers.size();
+    while (_containers.size() >= depth) {
+        if (next() == Token::Error) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+std::unique_ptr<Object> JSONReader::
+object()
+{
+    switch (_token) {
+        case Token::String:
+            return plist::String::New(_string);
+        case Token::Integer:
+            return plist::Integer::New(_integer);
+        case Token::Real:
+            return plist::Real::New(_real);
+        case Token::Boolean:
+            return plist::Boolean::New(boolean());
+        case Token::Null:
+            return plist::Null::New();
+
+        case Token::DictionaryStart: {
+            std::unique_ptr<plist::Dictionary> dict = plist::Dictionary::New();
+            while (next() == Token::Key) {
+                std::string key = _string;
+                next();
+
+                std::unique_ptr<Object> value = object();
+                if (value == nullptr) {
+                    return nullptr;
+                }
+                dict->set(key, std::move(value));
+            }
+
+            if (_token != Token::DictionaryEnd) {
+                return nullptr;
+            }
+            return plist::static_unique_pointer_cast<Object>(std::move(dict));
+        }
+
+        case Token::ArrayStart: {
+            std::unique_ptr<plist::Array> array = plist::Array::New();
+            while (next() != Token::ArrayEnd) {
+                std::unique_ptr<Object> value = object();
+                if (value == nullptr) {
+                    return nullptr;
+                }
+                array->append(std::move(value));
+            }
+            return plist::static_unique_pointer_cast<Object>(std::move(array));
+        }
+
+        default:
+            return nullptr;
+    }
+}
@@ -8,8 +8,22 @@
  */
 
 #include <plist/Object.h>
+#include <plist/Arena.h>
 
 using plist::Object;
+using plist::Arena;
+
+void *Object::
+operator new(size_t size)
+{
+    return Arena::Allocate(size);
+}
+
+void Object::
+operator delete(void *pointer, size_t size)
+{
+    Arena::Deallocate(pointer, size);
+}
 
 std::unique_ptr<Object> Object::
 Coerce(Object const *obj)
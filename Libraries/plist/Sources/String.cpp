@@ -8,6 +8,7 @@
  */
 
 #include <plist/String.h>
+#include <plist/Arena.h>
 #include <plist/Boolean.h>
 #include <plist/Date.h>
 #include <plist/Real.h>
@@ -17,6 +18,7 @@
 #include <iomanip>
 
 using plist::Object;
+using plist::Arena;
 using plist::String;
 using plist::Boolean;
 using plist::Integer;
@@ -25,12 +27,20 @@ using plist::Real;
 std::unique_ptr<String> String::
 New(std::string const &value)
 {
+    if (std::string const *interned = Arena::Intern(value)) {
+        return std::unique_ptr<String>(new String(interned));
+    }
+
     return std::unique_ptr<String>(new String(value));
 }
 
 std::unique_ptr<String> String::
 New(std::string &&value)
 {
+    if (std::string const *interned = Arena::Intern(value)) {
+        return std::unique_ptr<String>(new String(interned));
+    }
+
     return std::unique_ptr<String>(new String(std::move(value)));
 }
 
@@ -0,0 +1,100 @@
+/**
+ Copyright (c) 2015-present, Facebook, Inc.
+ All rights reserved.
+
+ This source code is licensed under the BSD-style license found in the
+ LICENSE file in the root directory of this source tree. An additional grant
+ of patent rights can be found in the PATENTS file in the same directory.
+ */
+
+#include <gtest/gtest.h>
+#include <plist/Format/ASCIIPListLexer.h>
+
+#include <random>
+#include <string>
+
+/*
+ * Lex the contents twice, once skipping runs of characters 16 bytes at a
+ * time and once a byte at a time, and expect the same tokens.
+ */
+static void
+ExpectSameTokens(std::string const &contents, int style)
+{
+    /* Terminated past the end, as documents may not be. */
+    std::string buffer = contents + '\0';
+
+    ASCIIPListLexer vectorized;
+    ASCIIPListLexerInit(&vectorized, buffer.data(), contents.size(), style);
+
+    ASCIIPListLexer scalar;
+    ASCIIPListLexerInit(&scalar, buffer.data(), contents.size(), style);
+    scalar.vectorized = 0;
+
+    for (;;) {
+        char const *pointer = scalar.pointer;
+        int token = ASCIIPListLexerReadToken(&vectorized);
+        ASSERT_EQ(ASCIIPListLexerReadToken(&scalar), token) << contents;
+
+        EXPECT_EQ(scalar.pointer - scalar.inputBuffer, vectorized.pointer - vectorized.inputBuffer) << contents;
+        EXPECT_EQ(scalar.lineStart - scalar.inputBuffer, vectorized.lineStart - vectorized.inputBuffer) << contents;
+        EXPECT_EQ(scalar.line, vectorized.line) << contents;
+        EXPECT_EQ(scalar.tokenBegin, vectorized.tokenBegin) << contents;
+        EXPECT_EQ(scalar.tokenLength, vectorized.tokenLength) << contents;
+
+        /* Stop on errors, and on tokens the lexer can't get past. */
+        if (token < 0 || scalar.pointer == pointer) {
+            break;
+        }
+    }
+}
+
+TEST(ASCIIPListLexer, Document)
+{
+    std::string document =
+        "// !$*UTF8*$!\n"
+        "{\n"
+        "\tarchiveVersion = 1;\n"
+        "\tobjects = {\n"
+        "\n"
+        "/* Begin PBXBuildFile section */\n"
+        "\t\t0F0000000000000000000001 /* main.c in Sources */ = {isa = PBXBuildFile; fileRef = 0F0000000000000000000002 /* main.c */; };\n"
+        "/* End PBXBuildFile section */\n"
+        "\t\t0F0000000000000000000002 = {isa = PBXFileReference; path = \"Sources/with spaces/and \\\"quotes\\\"/main.c\"; sourceTree = \"<group>\"; };\n"
+        "\t\t0F0000000000000000000003 = {isa = XCBuildConfiguration; buildSettings = { OTHER_LDFLAGS = ( \"-framework\", Foundation, '$(inherited)' ); }; };\n"
+        "\t\t0F0000000000000000000004 = {data = <0fbd777f 1e2a>; value = 3.25; };\n"
+        "\t};\n"
+        "\trootObject = 0F0000000000000000000001 /* Project object */;\n"
+        "}\n";
+
+    ExpectSameTokens(document, kASCIIPListLexerStyleASCII);
+    ExpectSameTokens(document + document, kASCIIPListLexerStyleASCII);
+
+    /* Ending inside each kind of token. */
+    for (size_t length = 0; length <= document.size(); length++) {
+        ExpectSameTokens(document.substr(0, length), kASCIIPListLexerStyleASCII);
+    }
+}
+
+TEST(ASCIIPListLexer, Random)
+{
+    static char const characters[] = {
+        'a', 'Z', '0', '9', '_', '$', '-', '.', '/', ':', '*', '\\',
+        ' ', '\t', '\r', '\n', '\f', '"', '\'', '{', '}', '(', ')',
+        '<', '>', '=', ';', ',', '\0', '\x7f', '\xc3', '\xa9',
+    };
+
+    std::mt19937 random = std::mt19937(42);
+    std::uniform_int_distribution<size_t> character = std::uniform_int_distribution<size_t>(0, sizeof(characters) - 1);
+    std::uniform_int_distribution<size_t> run = std::uniform_int_distribution<size_t>(1, 40);
+
+    for (int i = 0; i < 2000; i++) {
+        /* Runs of one character, so that runs cross 16 byte boundaries. */
+        std::string contents;
+        while (contents.size() < 256) {
+            contents.append(run(random) % 4 == 0 ? run(random) : 1, characters[character(random)]);
+        }
+
+        ExpectSameTokens(contents, kASCIIPListLexerStyleASCII);
+        ExpectSameTokens(contents, kASCIIPListLexerStyleJSON);
+    }
+}
@@ -12,6 +12,12 @@
 #include <plist/Objects.h>
 
 using plist::Format::Binary;
+using plist::Array;
+using plist::Boolean;
+using plist::Data;
+using plist::Date;
+using plist::Integer;
+using plist::Real;
 using plist::String;
 using plist::Dictionary;
 
@@ -57,3 +63,86 @@ TEST(Binary, UnicodeString)
     EXPECT_EQ(*serialize.first, contents);
 }
 
+
+TEST(Binary, Serialize)
+{
+    auto dictionary = Dictionary::New();
+    dictionary->set("name", String::New("xcbuild"));
+    dictionary->set("count", Integer::New(42));
+    dictionary->set("ratio", Real::New(0.5));
+    dictionary->set("enabled", Boolean::New(true));
+    dictionary->set("data", Data::New(std::vector<uint8_t>({ 0x01, 0x02, 0x03 })));
+    auto list = Array::New();
+    list->append(String::New("a"));
+    list->append(String::New("b"));
+    list->append(Integer::New(7));
+    dictionary->set("list", std::move(list));
+
+    /*
+     * Binary property list of the above, without any repeated values.
+     */
+    std::vector<uint8_t> contents = {
+        0x62, 0x70, 0x6c, 0x69, 0x73, 0x74, 0x30, 0x30, 0xd6, 0x01, 0x02, 0x03,
+        0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0a, 0x0b, 0x0c, 0x54, 0x6e, 0x61,
+        0x6d, 0x65, 0x55, 0x63, 0x6f, 0x75, 0x6e, 0x74, 0x55, 0x72, 0x61, 0x74,
+        0x69, 0x6f, 0x57, 0x65, 0x6e, 0x61, 0x62, 0x6c, 0x65, 0x64, 0x54, 0x64,
+        0x61, 0x74, 0x61, 0x54, 0x6c, 0x69, 0x73, 0x74, 0x57, 0x78, 0x63, 0x62,
+        0x75, 0x69, 0x6c, 0x64, 0x10, 0x2a, 0x22, 0x3f, 0x00, 0x00, 0x00, 0x09,
+        0x43, 0x01, 0x02, 0x03, 0xa3, 0x0d, 0x0e, 0x0f, 0x51, 0x61, 0x51, 0x62,
+        0x10, 0x07, 0x08, 0x15, 0x1a, 0x20, 0x26, 0x2e, 0x33, 0x38, 0x40, 0x42,
+        0x47, 0x48, 0x4c, 0x50, 0x52, 0x54, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+        0x01, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x10, 0x00, 0x00,
+        0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+        0x00, 0x56,
+    };
+
+    auto serialize = Binary::Serialize(dictionary.get(), Binary::Create());
+    ASSERT_NE(serialize.first, nullptr);
+    EXPECT_EQ(contents, *serialize.first);
+}
+
+TEST(Binary, SerializeUnique)
+{
+    /* Each entry repeats the values of the others. */
+    auto array = Array::New();
+    for (int i = 0; i < 10; i++) {
+        auto entry = Dictionary::New();
+        entry->set("isa", String::New("PBXFileReference"));
+        entry->set("fileEncoding", Integer::New(4));
+        entry->set("scale", Real::New(2.0));
+        entry->set("hash", Data::New(std::vector<uint8_t>(32, 0xab)));
+        entry->set("path", String::New("File" + std::to_string(i) + ".m"));
+        array->append(std::move(entry));
+    }
+
+    auto values = Binary::Serialize(array.get(), Binary::Create());
+    ASSERT_NE(values.first, nullptr);
+
+    /* Repeated values are written once: 10 entries, 10 paths, and one of each other key and value. */
+    auto deserialize = Binary::Deserialize(*values.first, Binary::Create());
+    ASSERT_NE(deserialize.first, nullptr);
+    EXPECT_TRUE(deserialize.first->equals(array.get()));
+    EXPECT_EQ(1 + 10 + 10 + 5 + 4, values.first->at(values.first->size() - 17));
+
+    auto dates = Array::New();
+    dates->append(Date::New(static_cast<uint64_t>(1500000000)));
+    dates->append(Date::New(static_cast<uint64_t>(1500000000)));
+    auto date = Binary::Serialize(dates.get(), Binary::Create());
+    ASSERT_NE(date.first, nullptr);
+    EXPECT_EQ(2, date.first->at(date.first->size() - 17));
+
+    /* Repeated containers are written once too, if asked. */
+    auto copy = array->copy();
+    plist::CastTo<Array>(copy.get())->append(array->value(0)->copy());
+    plist::CastTo<Array>(copy.get())->append(array->value(0)->copy());
+
+    auto containers = Binary::Serialize(copy.get(), Binary::Create(true));
+    ASSERT_NE(containers.first, nullptr);
+    auto plain = Binary::Serialize(copy.get(), Binary::Create());
+    ASSERT_NE(plain.first, nullptr);
+    EXPECT_LT(containers.first->size(), plain.first->size());
+
+    deserialize = Binary::Deserialize(*containers.first, Binary::Create());
+    ASSERT_NE(deserialize.first, nullptr);
+    EXPECT_TRUE(deserialize.first->equals(copy.get()));
+}
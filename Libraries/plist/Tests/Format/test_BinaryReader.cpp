@@ -0,0 +1,160 @@
+/**
+ Copyright (c) 2015-present, Facebook, Inc.
+ All rights reserved.
+
+ This source code is licensed under the BSD-style license found in the
+ LICENSE file in the root directory of this source tree. An additional grant
+ of patent rights can be found in the PATENTS file in the same directory.
+ */
+
+#include <gtest/gtest.h>
+#include <plist/Format/Binary.h>
+#include <plist/Format/BinaryReader.h>
+#include <plist/Objects.h>
+#include <libutil/MemoryFilesystem.h>
+
+using plist::Format::Binary;
+using plist::Format::BinaryReader;
+using plist::Array;
+using plist::Date;
+using plist::Dictionary;
+using plist::Integer;
+using plist::ObjectType;
+using plist::Real;
+using plist::String;
+using libutil::MemoryFilesystem;
+
+static std::unique_ptr<Dictionary>
+Document()
+{
+    auto info = Dictionary::New();
+    info->set("CFBundleIdentifier", String::New("com.example.app"));
+    info->set("CFBundleVersion", Integer::New(42));
+    info->set("Scale", Real::New(2.5));
+    info->set("Modified", Date::New(static_cast<uint64_t>(1500000000)));
+    info->set("Name \xc3\xa9t\xc3\xa9", String::New("summer"));
+
+    auto architectures = Array::New();
+    architectures->append(String::New("arm64"));
+    architectures->append(String::New("x86_64"));
+    info->set("Architectures", std::move(architectures));
+
+    auto document = Dictionary::New();
+    document->set("Info", std::move(info));
+    document->set("Count", Integer::New(-1));
+    return document;
+}
+
+TEST(BinaryReader, Lookup)
+{
+    auto document = Document();
+    auto contents = Binary::Serialize(document.get(), Binary::Create());
+    ASSERT_NE(nullptr, contents.first);
+
+    auto open = BinaryReader::Open(contents.first->data(), contents.first->size());
+    ASSERT_NE(nullptr, open.first);
+    BinaryReader const *reader = open.first.get();
+
+    EXPECT_EQ(ObjectType::Dictionary, reader->type(reader->root()));
+    EXPECT_EQ(2, reader->count(reader->root()));
+
+    BinaryReader::Reference info;
+    ASSERT_TRUE(reader->value(reader->root(), "Info", &info));
+    EXPECT_EQ(ObjectType::Dictionary, reader->type(info));
+
+    BinaryReader::Reference identifier;
+    ASSERT_TRUE(reader->value(info, "CFBundleIdentifier", &identifier));
+    EXPECT_EQ(ObjectType::String, reader->type(identifier));
+    auto object = reader->object(identifier);
+    ASSERT_NE(nullptr, object.first);
+    EXPECT_EQ("com.example.app", plist::CastTo<String>(object.first.get())->value());
+
+    /* Keys that aren't ASCII. */
+    BinaryReader::Reference name;
+    ASSERT_TRUE(reader->value(info, "Name \xc3\xa9t\xc3\xa9", &name));
+    EXPECT_EQ("summer", plist::CastTo<String>(reader->object(name).first.get())->value());
+
+    BinaryReader::Reference architectures, architecture;
+    ASSERT_TRUE(reader->value(info, "Architectures", &architectures));
+    EXPECT_EQ(2, reader->count(architectures));
+    ASSERT_TRUE(reader->value(architectures, 1, &architecture));
+    EXPECT_EQ("x86_64", plist::CastTo<String>(reader->object(architecture).first.get())->value());
+
+    /* Missing values, and lookups in the wrong type of object. */
+    BinaryReader::Reference missing;
+    EXPECT_FALSE(reader->value(info, "Missing", &missing));
+    EXPECT_FALSE(reader->value(architectures, 2, &missing));
+    EXPECT_FALSE(reader->value(architectures, "arm64", &missing));
+    EXPECT_FALSE(reader->value(info, 0, &missing));
+    EXPECT_EQ(ObjectType::None, reader->type(1000));
+
+    /* Decoding everything matches the full reader. */
+    auto root = reader->object(reader->root());
+    ASSERT_NE(nullptr, root.first);
+    EXPECT_TRUE(root.first->equals(document.get()));
+
+    auto deserialize = Binary::Deserialize(*contents.first, Binary::Create());
+    ASSERT_NE(nullptr, deserialize.first);
+    EXPECT_TRUE(deserialize.first->equals(root.first.get()));
+}
+
+TEST(BinaryReader, File)
+{
+    auto document = Document();
+    auto contents = Binary::Serialize(document.get(), Binary::Create());
+    ASSERT_NE(nullptr, contents.first);
+
+    MemoryFilesystem filesystem = MemoryFilesystem({
+        MemoryFilesystem::Entry::File("Info.plist", *contents.first),
+    });
+
+    auto open = BinaryReader::Open(&filesystem, "/Info.plist");
+    ASSERT_NE(nullptr, open.first);
+
+    BinaryReader::Reference count;
+    ASSERT_TRUE(open.first->value(open.first->root(), "Count", &count));
+    EXPECT_EQ(-1, plist::CastTo<Integer>(open.first->object(count).first.get())->value());
+
+    EXPECT_EQ(nullptr, BinaryReader::Open(&filesystem, "/Missing.plist").first);
+}
+
+TEST(BinaryReader, Corrupt)
+{
+    auto document = Document();
+    auto contents = Binary::Serialize(document.get(), Binary::Create());
+    ASSERT_NE(nullptr, contents.first);
+
+    /* Truncated. */
+    std::vector<uint8_t> truncated = std::vector<uint8_t>(contents.first->begin(), contents.first->end() - 8);
+    EXPECT_EQ(nullptr, BinaryReader::Open(truncated.data(), truncated.size()).first);
+    EXPECT_EQ(nullptr, BinaryReader::Open(contents.first->data(), 8).first);
+
+    /*
+     * An array containing itself, as object 0: a one element array
+     * referring to object 0.
+     */
+    std::vector<uint8_t> cycle = {
+        0x62, 0x70, 0x6c, 0x69, 0x73, 0x74, 0x30, 0x30, 0xa1, 0x00, 0x08,
+        0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x01, 0x01, 0x00, 0x00, 0x00, 0x00,
+        0x00, 0x00, 0x00, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+        0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x0a,
+    };
+    auto open = BinaryReader::Open(cycle.data(), cycle.size());
+    ASSERT_NE(nullptr, open.first);
+    EXPECT_EQ(ObjectType::Array, open.first->type(open.first->root()));
+
+    BinaryReader::Reference element;
+    ASSERT_TRUE(open.first->value(open.first->root(), 0, &element));
+    EXPECT_EQ(open.first->root(), element);
+
+    auto object = open.first->object(open.first->root());
+    EXPECT_EQ(nullptr, object.first);
+    EXPECT_FALSE(object.second.empty());
+
+    /* An offset past the objects. */
+    cycle[10] = 0x20;
+    open = BinaryReader::Open(cycle.data(), cycle.size());
+    ASSERT_NE(nullptr, open.first);
+    EXPECT_EQ(ObjectType::None, open.first->type(open.first->root()));
+    EXPECT_EQ(nullptr, open.first->object(open.first->root()).first);
+}
@@ -0,0 +1,148 @@
+/**
+ Copyright (c) 2015-present, Facebook, Inc.
+ All rights reserved.
+
+ This source code is licensed under the BSD-style license found in the
+ LICENSE file in the root directory of this source tree. An additional grant
+ of patent rights can be found in the PATENTS file in the same directory.
+ */
+
+#include <gtest/gtest.h>
+#include <plist/Format/JSON.h>
+#include <plist/Format/JSONReader.h>
+#include <plist/Objects.h>
+
+using plist::Format::JSON;
+using plist::Format::JSONReader;
+using plist::ObjectType;
+
+static std::vector<uint8_t>
+Contents(std::string const &string)
+{
+    return std::vector<uint8_t>(string.begin(), string.end());
+}
+
+/*
+ * Read the root object, checking nothing follows it.
+ */
+static std::unique_ptr<plist::Object>
+Read(std::vector<uint8_t> const &contents)
+{
+    JSONReader reader(contents.data(), contents.size());
+    reader.next();
+
+    std::unique_ptr<plist::Object> object = reader.object();
+    if (object == nullptr || reader.next() != JSONReader::Token::End) {
+        return nullptr;
+    }
+
+    return object;
+}
+
+TEST(JSONReader, Tokens)
+{
+    auto contents = Contents("{ \"a\" : [ 1, -2.5, \"s\\n\", true, null ], \"b\" : {} }");
+    JSONReader reader(contents.data(), contents.size());
+
+    EXPECT_EQ(JSONReader::Token::DictionaryStart, reader.next());
+    EXPECT_EQ(ObjectType::Dictionary, reader.type());
+    EXPECT_EQ(JSONReader::Token::Key, reader.next());
+    EXPECT_EQ("a", reader.string());
+    EXPECT_EQ(ObjectType::None, reader.type());
+    EXPECT_EQ(JSONReader::Token::ArrayStart, reader.next());
+    EXPECT_EQ(JSONReader::Token::Integer, reader.next());
+    EXPECT_EQ(1, reader.integer());
+    EXPECT_EQ(JSONReader::Token::Real, reader.next());
+    EXPECT_EQ(-2.5, reader.real());
+    EXPECT_EQ(JSONReader::Token::String, reader.next());
+    EXPECT_EQ("s\n", reader.string());
+    EXPECT_EQ(JSONReader::Token::Boolean, reader.next());
+    EXPECT_TRUE(reader.boolean());
+    EXPECT_EQ(JSONReader::Token::Null, reader.next());
+    EXPECT_EQ(JSONReader::Token::ArrayEnd, reader.next());
+    EXPECT_EQ(JSONReader::Token::Key, reader.next());
+    EXPECT_EQ("b", reader.string());
+    EXPECT_EQ(JSONReader::Token::DictionaryStart, reader.next());
+    EXPECT_EQ(JSONReader::Token::DictionaryEnd, reader.next());
+    EXPECT_EQ(JSONReader::Token::DictionaryEnd, reader.next());
+    EXPECT_EQ(JSONReader::Token::End, reader.next());
+    EXPECT_EQ(JSONReader::Token::End, reader.next());
+}
+
+TEST(JSONReader, Skip)
+{
+    auto contents = Contents("{ \"skip\" : { \"a\" : [ [], {} ], \"b\" : 1 }, \"keep\" : \"value\" }");
+    JSONReader reader(contents.data(), contents.size());
+
+    EXPECT_EQ(JSONReader::Token::DictionaryStart, reader.next());
+    EXPECT_EQ(JSONReader::Token::Key, reader.next());
+    EXPECT_EQ(JSONReader::Token::DictionaryStart, reader.next());
+    EXPECT_TRUE(reader.skip());
+    EXPECT_EQ(JSONReader::Token::DictionaryEnd, reader.token());
+    EXPECT_EQ(JSONReader::Token::Key, reader.next());
+    EXPECT_EQ("keep", reader.string());
+    EXPECT_EQ(JSONReader::Token::String, reader.next());
+    EXPECT_TRUE(reader.skip());
+    EXPECT_EQ(JSONReader::Token::DictionaryEnd, reader.next());
+    EXPECT_EQ(JSONReader::Token::End, reader.next());
+}
+
+TEST(JSONReader, SameAsDeserialize)
+{
+    std::vector<std::string> documents = {
+        "\"str*ng\"",
+        "{}",
+        "[]",
+        "{ \"images\" : [ { \"idiom\" : \"universal\", \"scale\" : \"2x\" } ], \"info\" : { \"version\" : 1 } }",
+        "{ \"escaped\" : \"\\u0041\\t\\\\\", \"real\" : 1e3, \"nested\" : [ [ 1 ], { \"a\" : false } ] }",
+        /* Trailing separators are accepted. */
+        "{ \"a\" : [ 1, 2, ], }",
+        /* Later duplicate keys win. */
+        "{ \"a\" : 1, \"a\" : 2 }",
+    };
+
+    for (std::string const &document : documents) {
+        auto contents = Contents(document);
+
+        auto deserialize = JSON::Deserialize(contents, JSON::Create());
+        ASSERT_NE(nullptr, deserialize.first) << document;
+
+        auto read = Read(contents);
+        ASSERT_NE(nullptr, read) << document;
+        EXPECT_TRUE(read->equals(deserialize.first.get())) << document;
+    }
+}
+
+TEST(JSONReader, Invalid)
+{
+    std::vector<std::string> documents = {
+        "",
+        "\n\n",
+        "{ 'one': 1 }",
+        "{ \"key\" : 01 }",
+        "{ \"key\" 1 }",
+        "{ \"key\" : }",
+        "{ true : 1 }",
+        "[ 1 }",
+        "[ 1 2 ]",
+        "{ \"key\" : \"value",
+        "{} {}",
+        "{",
+    };
+
+    for (std::string const &document : documents) {
+        auto contents = Contents(document);
+
+        auto deserialize = JSON::Deserialize(contents, JSON::Create());
+        EXPECT_EQ(nullptr, deserialize.first) << document;
+
+        JSONReader reader(contents.data(), contents.size());
+        JSONReader::Token token;
+        do {
+            token = reader.next();
+        } while (token != JSONReader::Token::End && token != JSONReader::Token::Error);
+
+        EXPECT_EQ(JSONReader::Token::Error, token) << document;
+        EXPECT_FALSE(reader.error().empty()) << document;
+    }
+}
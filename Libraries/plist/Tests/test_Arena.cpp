@@ -0,0 +1,157 @@
+/**
+ Copyright (c) 2015-present, Facebook, Inc.
+ All rights reserved.
+
+ This source code is licensed under the BSD-style license found in the
+ LICENSE file in the root directory of this source tree. An additional grant
+ of patent rights can be found in the PATENTS file in the same directory.
+ */
+
+#include <gtest/gtest.h>
+#include <plist/Arena.h>
+#include <plist/Objects.h>
+#include <plist/Format/ASCII.h>
+
+#include <thread>
+
+using plist::Arena;
+using plist::Array;
+using plist::Dictionary;
+using plist::String;
+using plist::Format::ASCII;
+using plist::Format::Encoding;
+
+static std::vector<uint8_t>
+Contents(std::string const &string)
+{
+    return std::vector<uint8_t>(string.begin(), string.end());
+}
+
+TEST(Arena, Scope)
+{
+    EXPECT_EQ(nullptr, Arena::Current());
+
+    {
+        Arena::Scope outer;
+        EXPECT_EQ(outer.arena(), Arena::Current());
+
+        {
+            Arena::Scope inner;
+            EXPECT_EQ(inner.arena(), Arena::Current());
+        }
+
+        EXPECT_EQ(outer.arena(), Arena::Current());
+    }
+
+    EXPECT_EQ(nullptr, Arena::Current());
+}
+
+TEST(Arena, Intern)
+{
+    std::unique_ptr<String> a;
+    std::unique_ptr<String> b;
+    std::unique_ptr<String> unique;
+    {
+        Arena::Scope scope;
+        a = String::New("0F0000000000000000000001");
+        b = String::New(std::string("0F0000000000000000000001"));
+        unique = String::New(std::string(100, 'x'));
+    }
+
+    /* Equal values share storage, which outlives the scope. */
+    EXPECT_EQ(&a->value(), &b->value());
+    EXPECT_EQ("0F0000000000000000000001", a->value());
+    EXPECT_EQ(std::string(100, 'x'), unique->value());
+
+    /* Changing a value doesn't change the others. */
+    a->setValue("0E0000000000000000000001");
+    EXPECT_EQ("0E0000000000000000000001", a->value());
+    EXPECT_EQ("0F0000000000000000000001", b->value());
+
+    /* Outside of a scope, values aren't shared. */
+    auto c = String::New("0F0000000000000000000001");
+    auto d = String::New("0F0000000000000000000001");
+    EXPECT_NE(&c->value(), &d->value());
+}
+
+TEST(Arena, CopyString)
+{
+    std::unique_ptr<String> copy;
+    String value;
+    {
+        Arena::Scope scope;
+        auto interned = String::New("0F0000000000000000000001");
+        value = *interned;
+        String constructed = *interned;
+        EXPECT_NE(&interned->value(), &constructed.value());
+
+        /* Copies in the same arena still share the value. */
+        copy = interned->copy();
+        EXPECT_EQ(&interned->value(), &copy->value());
+    }
+
+    /* Copies made outside of the arena own their value. */
+    copy.reset();
+    EXPECT_EQ("0F0000000000000000000001", value.value());
+}
+
+TEST(Arena, Document)
+{
+    auto contents = Contents("{ objects = { A = { isa = PBXBuildFile; fileRef = B; }; B = { isa = PBXFileReference; path = a.c; }; }; list = ( A, B ); }");
+
+    std::unique_ptr<plist::Object> root;
+    {
+        Arena::Scope scope;
+        auto deserialize = ASCII::Deserialize(contents, ASCII::Create(false, Encoding::UTF8));
+        ASSERT_NE(nullptr, deserialize.first);
+        root = std::move(deserialize.first);
+    }
+
+    /* The same document, without an arena. */
+    auto expected = ASCII::Deserialize(contents, ASCII::Create(false, Encoding::UTF8));
+    ASSERT_NE(nullptr, expected.first);
+    EXPECT_TRUE(root->equals(expected.first.get()));
+
+    /* Documents can be modified after the scope. */
+    Dictionary *dictionary = plist::CastTo<Dictionary>(root.get());
+    ASSERT_NE(nullptr, dictionary);
+    dictionary->set("added", String::New("value"));
+    dictionary->remove("list");
+    EXPECT_EQ("value", dictionary->value<String>("added")->value());
+    EXPECT_EQ(nullptr, dictionary->value("list"));
+
+    /* Objects can be released on another thread, in any order. */
+    Dictionary *objects = dictionary->value<Dictionary>("objects");
+    ASSERT_NE(nullptr, objects);
+    std::unique_ptr<plist::Object> copy;
+    {
+        Arena::Scope scope;
+        copy = objects->copy();
+    }
+    root.reset();
+
+    std::thread thread([&]() {
+        Dictionary const *A = plist::CastTo<Dictionary>(copy.get())->value<Dictionary>("A");
+        ASSERT_NE(nullptr, A);
+        EXPECT_EQ("PBXBuildFile", A->value<String>("isa")->value());
+        copy.reset();
+    });
+    thread.join();
+}
+
+TEST(Arena, Large)
+{
+    std::unique_ptr<Array> array;
+    {
+        Arena::Scope scope;
+        array = Array::New();
+        for (int i = 0; i < 10000; i++) {
+            array->append(String::New(std::to_string(i % 100)));
+        }
+        array->append(String::New(std::string(100000, 'x')));
+    }
+
+    EXPECT_EQ(10001, array->count());
+    EXPECT_EQ("42", array->value<String>(142)->value());
+    EXPECT_EQ(100000, array->value<String>(10000)->value().size());
+}
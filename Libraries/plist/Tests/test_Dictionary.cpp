@@ -0,0 +1,104 @@
+/**
+ Copyright (c) 2015-present, Facebook, Inc.
+ All rights reserved.
+
+ This source code is licensed under the BSD-style license found in the
+ LICENSE file in the root directory of this source tree. An additional grant
+ of patent rights can be found in the PATENTS file in the same directory.
+ */
+
+#include <gtest/gtest.h>
+#include <plist/Objects.h>
+
+using plist::Dictionary;
+using plist::Integer;
+using plist::String;
+
+TEST(Dictionary, Order)
+{
+    auto dictionary = Dictionary::New();
+    dictionary->set("b", String::New("1"));
+    dictionary->set("a", String::New("2"));
+    dictionary->set("c", String::New("3"));
+
+    std::vector<std::string> keys = std::vector<std::string>(dictionary->begin(), dictionary->end());
+    EXPECT_EQ(std::vector<std::string>({ "b", "a", "c" }), keys);
+
+    /* Replacing a value moves it to the end. */
+    dictionary->set("b", String::New("4"));
+    EXPECT_EQ(3, dictionary->count());
+    EXPECT_EQ("a", dictionary->key(0));
+    EXPECT_EQ("b", dictionary->key(2));
+    EXPECT_EQ("4", dictionary->value<String>(2)->value());
+
+    dictionary->remove("a");
+    dictionary->remove("missing");
+    EXPECT_EQ(2, dictionary->count());
+    EXPECT_EQ("c", dictionary->key(0));
+    EXPECT_EQ(nullptr, dictionary->value("a"));
+
+    /* Keys from the dictionary itself can be used to modify it. */
+    dictionary->set(dictionary->key(0), String::New("5"));
+    EXPECT_EQ("c", dictionary->key(1));
+    EXPECT_EQ("5", dictionary->value<String>("c")->value());
+
+    dictionary->clear();
+    EXPECT_TRUE(dictionary->empty());
+    EXPECT_EQ(dictionary->begin(), dictionary->end());
+}
+
+TEST(Dictionary, Large)
+{
+    auto dictionary = Dictionary::New();
+    for (int i = 0; i < 1000; i++) {
+        dictionary->set("key" + std::to_string(i), Integer::New(i));
+    }
+    ASSERT_EQ(1000, dictionary->count());
+
+    for (int i = 0; i < 1000; i++) {
+        Integer const *integer = dictionary->value<Integer>("key" + std::to_string(i));
+        ASSERT_NE(nullptr, integer);
+        EXPECT_EQ(i, integer->value());
+        EXPECT_EQ("key" + std::to_string(i), dictionary->key(i));
+    }
+    EXPECT_EQ(nullptr, dictionary->value("key1000"));
+
+    /* Lookups still work as entries are removed and replaced. */
+    for (int i = 0; i < 1000; i += 2) {
+        dictionary->remove("key" + std::to_string(i));
+    }
+    dictionary->set("key1", Integer::New(-1));
+    ASSERT_EQ(500, dictionary->count());
+    EXPECT_EQ(nullptr, dictionary->value("key0"));
+    EXPECT_EQ(3, dictionary->value<Integer>("key3")->value());
+    EXPECT_EQ(-1, dictionary->value<Integer>("key1")->value());
+    EXPECT_EQ("key1", dictionary->key(499));
+    for (int i = 3; i < 1000; i += 2) {
+        Integer const *integer = dictionary->value<Integer>("key" + std::to_string(i));
+        ASSERT_NE(nullptr, integer);
+        EXPECT_EQ(i, integer->value());
+        EXPECT_EQ(nullptr, dictionary->value("key" + std::to_string(i - 1)));
+    }
+
+    for (int i = 0; i < 500; i++) {
+        dictionary->remove(dictionary->key(0));
+    }
+    EXPECT_TRUE(dictionary->empty());
+}
+
+TEST(Dictionary, Equals)
+{
+    auto a = Dictionary::New();
+    auto b = Dictionary::New();
+    for (int i = 0; i < 20; i++) {
+        a->set("key" + std::to_string(i), Integer::New(i));
+        b->set("key" + std::to_string(19 - i), Integer::New(19 - i));
+    }
+
+    /* Order does not matter. */
+    EXPECT_TRUE(a->equals(b.get()));
+    EXPECT_TRUE(a->copy()->equals(b.get()));
+
+    b->set("key0", Integer::New(1));
+    EXPECT_FALSE(a->equals(b.get()));
+}
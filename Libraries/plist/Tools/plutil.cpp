@@ -19,6 +19,7 @@
 #include <plist/Format/Any.h>
 #include <plist/Format/ASCII.h>
 #include <plist/Format/Binary.h>
+#include <plist/Format/BinaryReader.h>
 #include <plist/Format/Encoding.h>
 #include <plist/Format/JSON.h>
 #include <plist/Format/XML.h>
@@ -600,6 +601,36 @@ PerformAdjustment(plist::Object *object, plist::Object **rootObject, std::string
     }
 }
 
+static bool
+Save(Filesystem *filesystem, Options const &options, std::string const &file, plist::Object const *writeObject, Options::Format const &inputFormat)
+{
+    /* Convert to desired format. */
+    std::pair<std::unique_ptr<std::vector<uint8_t>>, std::string> serialize;
+
+    Options::Format outputFormat = options.convert().value_or(inputFormat);
+    if (ext::optional<plist::Format::Any> any = outputFormat.any()) {
+        serialize = plist::Format::Any::Serialize(writeObject, *any);
+    } else if (ext::optional<plist::Format::JSON> json = outputFormat.json()) {
+        serialize = plist::Format::JSON::Serialize(writeObject, *json);
+    } else {
+        abort();
+    }
+
+    if (serialize.first == nullptr) {
+        fprintf(stderr, "error: %s\n", serialize.second.c_str());
+        return false;
+    }
+
+    /* Write to output. */
+    std::string output = OutputPath(options, file);
+    if (!Write(filesystem, *serialize.first, output)) {
+        fprintf(stderr, "error: unable to write\n");
+        return false;
+    }
+
+    return true;
+}
+
 static bool
 Modify(Filesystem *filesystem, Options const &options, std::string const &file, std::unique_ptr<plist::Object> object, Options::Format const &inputFormat)
 {
@@ -639,31 +670,61 @@ Modify(Filesystem *filesystem, Options const &options, std::string const &file,
         } while (end != std::string::npos);
     }
 
-    /* Convert to desired format. */
-    std::pair<std::unique_ptr<std::vector<uint8_t>>, std::string> serialize;
+    return Save(filesystem, options, file, writeObject, inputFormat);
+}
 
-    Options::Format outputFormat = options.convert().value_or(inputFormat);
-    if (ext::optional<plist::Format::Any> any = outputFormat.any()) {
-        serialize = plist::Format::Any::Serialize(writeObject, *any);
-    } else if (ext::optional<plist::Format::JSON> json = outputFormat.json()) {
-        serialize = plist::Format::JSON::Serialize(writeObject, *json);
-    } else {
-        abort();
+/*
+ * Extract a value from a binary property list, decoding only that value.
+ * Returns nothing if the file isn't a binary property list or there are
+ * other adjustments, to read and modify the file in full instead.
+ */
+static ext::optional<bool>
+ExtractBinary(Filesystem *filesystem, Options const &options, std::string const &file)
+{
+    if (file == "-" || options.adjustments().size() != 1 || options.adjustments().front().type() != Options::Adjustment::Type::Extract) {
+        return ext::nullopt;
     }
 
-    if (serialize.first == nullptr) {
-        fprintf(stderr, "error: %s\n", serialize.second.c_str());
-        return false;
+    auto open = plist::Format::BinaryReader::Open(filesystem, file);
+    if (open.first == nullptr) {
+        return ext::nullopt;
     }
 
-    /* Write to output. */
-    std::string output = OutputPath(options, file);
-    if (!Write(filesystem, *serialize.first, output)) {
-        fprintf(stderr, "error: unable to write\n");
+    plist::Format::BinaryReader const *reader = open.first.get();
+    plist::Format::BinaryReader::Reference reference = reader->root();
+
+    std::string const &path = options.adjustments().front().path();
+    std::string::size_type start = 0;
+    std::string::size_type end = 0;
+
+    do {
+        end = path.find('.', start);
+        std::string key = (end != std::string::npos ? path.substr(start, end - start) : path.substr(start));
+
+        bool found;
+        if (reader->type(reference) == plist::ObjectType::Array) {
+            uint64_t index = std::stoull(key.c_str(), NULL, 0);
+            found = reader->value(reference, static_cast<size_t>(index), &reference);
+        } else {
+            found = reader->value(reference, key, &reference);
+        }
+
+        if (!found) {
+            fprintf(stderr, "error: invalid key path\n");
+            return false;
+        }
+
+        start = end + 1;
+    } while (end != std::string::npos);
+
+    auto object = reader->object(reference);
+    if (object.first == nullptr) {
+        fprintf(stderr, "error: %s\n", object.second.c_str());
         return false;
     }
 
-    return true;
+    Options::Format format = Options::Format(plist::Format::Any::Create(plist::Format::Binary::Create()));
+    return Save(filesystem, options, file, object.first.get(), format);
 }
 
 int
@@ -701,6 +762,11 @@ main(int argc, char **argv)
 
         /* Actions applied to each input file separately. */
         for (std::string const &file : options.inputs()) {
+            if (ext::optional<bool> extracted = ExtractBinary(&filesystem, options, file)) {
+                success &= *extracted;
+                continue;
+            }
+
             std::pair<bool, std::vector<uint8_t>> result = Read(&filesystem, file);
             if (!result.first) {
                 fprintf(stderr, "error: unable to read %s\n", file.c_str());
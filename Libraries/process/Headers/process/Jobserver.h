@@ -0,0 +1,135 @@
+/**
+ Copyright (c) 2015-present, Facebook, Inc.
+ All rights reserved.
+
+ This source code is licensed under the BSD-style license found in the
+ LICENSE file in the root directory of this source tree. An additional grant
+ of patent rights can be found in the PATENTS file in the same directory.
+ */
+
+#ifndef __process_Jobserver_h
+#define __process_Jobserver_h
+
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include <ext/optional>
+
+namespace process {
+
+/*
+ * A GNU make jobserver: a pool of tokens, one for each job that may run at
+ * once. Child processes that understand the protocol, like make, ninja and
+ * cargo, find the pool through `MAKEFLAGS` and take a token for each job
+ * they run beyond their first, so nested parallel builds share one limit.
+ *
+ * Like make, the process creating the pool holds one token implicitly, and
+ * passes it on to the first child it runs. The pool holds the rest.
+ *
+ * Tokens are bytes in a pipe, which children inherit, or in a named pipe,
+ * which children open by path. Newer tools prefer the named pipe. The
+ * pipe is closed on exec, except in children given the pool through their
+ * environment. Not available on Windows. Thread safe.
+ */
+class Jobserver {
+public:
+    enum class Style {
+        /* Anonymous pipe; children given the pool inherit it. */
+        Pipe,
+        /* Named pipe; children open it by path. */
+        Fifo,
+    };
+
+private:
+    Style       _style;
+    size_t      _jobs;
+    int         _read;
+    int         _write;
+    std::string _path;
+
+private:
+    std::mutex  _mutex;
+    bool        _implicit;
+    size_t      _acquired;
+
+private:
+    Jobserver(Style style, size_t jobs, int read, int write, std::string const &path);
+
+public:
+    ~Jobserver();
+
+private:
+    Jobserver(Jobserver const &) = delete;
+    Jobserver &operator=(Jobserver const &) = delete;
+
+public:
+    /*
+     * How children connect to the pool.
+     */
+    Style style() const
+    { return _style; }
+
+    /*
+     * The number of jobs that may run at once, including this process.
+     */
+    size_t jobs() const
+    { return _jobs; }
+
+    /*
+     * The named pipe holding the tokens, for the fifo style.
+     */
+    std::string const &path() const
+    { return _path; }
+
+public:
+    /*
+     * Take a token for a job, waiting until one is free. The implicit token
+     * is used first. False if the pool can't be read.
+     */
+    bool acquire();
+
+    /*
+     * Return a token taken with `acquire()`.
+     */
+    void release();
+
+public:
+    /*
+     * Flags describing the pool, in the form make passes them to its
+     * children in `MAKEFLAGS`.
+     */
+    std::string makeflags() const;
+
+    /*
+     * Add the pool to an environment for a child process, keeping any
+     * flags already in its `MAKEFLAGS`.
+     */
+    void environment(std::unordered_map<std::string, std::string> *environment) const;
+
+public:
+    /*
+     * Create a pool for a number of jobs. Named pipes are created in the
+     * temporary directory, and removed when the pool is destroyed.
+     */
+    static std::unique_ptr<Jobserver>
+    Create(Style style, size_t jobs, std::string const &temporaryDirectory);
+
+    /*
+     * File descriptors a child with an environment from `environment()`
+     * must inherit to use the pool: the pipe's, for the pipe style.
+     */
+    static std::vector<int>
+    Inherited(std::unordered_map<std::string, std::string> const &environment);
+
+    /*
+     * Parse the name of a style: "pipe" or "fifo".
+     */
+    static ext::optional<Style>
+    ParseStyle(std::string const &name);
+};
+
+}
+
+#endif  // !__process_Jobserver_h
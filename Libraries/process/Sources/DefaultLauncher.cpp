@@ -9,6 +9,7 @@
 
 #include <process/DefaultLauncher.h>
 #include <process/Context.h>
+#include <process/Jobserver.h>
 #include <libutil/Filesystem.h>
 
 #if _WIN32
@@ -24,6 +25,7 @@
 
 using process::DefaultLauncher;
 using process::Context;
+using process::Jobserver;
 using libutil::Filesystem;
 
 #if _WIN32
@@ -198,6 +200,9 @@ launch(Filesystem *filesystem, Context const *context)
     execEnv.push_back(nullptr);
     char *const *cExecEnv = const_cast<char *const *>(execEnv.data());
 
+    /* Keep open the jobserver pipe, if any, for a child given it. */
+    std::vector<int> inherited = Jobserver::Inherited(context->environmentVariables());
+
     /* Setup parent-child stdout/stderr pipe. */
     int pfd[2];
     bool pipe_setup_success = true;
@@ -238,6 +243,10 @@ launch(Filesystem *filesystem, Context const *context)
             ::_exit(1);
         }
 
+        for (int fd : inherited) {
+            ::fcntl(fd, F_SETFD, 0);
+        }
+
         ::execve(cPath, cExecArgs, cExecEnv);
         ::_exit(-1);
 
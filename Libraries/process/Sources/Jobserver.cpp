@@ -0,0 +1,237 @@
+/**
+ Copyright (c) 2015-present, Facebook, Inc.
+ All rights reserved.
+
+ This source code is licensed under the BSD-style license found in the
+ LICENSE file in the root directory of this source tree. An additional grant
+ of patent rights can be found in the PATENTS file in the same directory.
+ */
+
+#include <process/Jobserver.h>
+
+#include <cerrno>
+#include <cstdio>
+
+#if !_WIN32
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+using process::Jobserver;
+
+/* The byte make uses for tokens. */
+static char const JobserverToken = '+';
+
+Jobserver::
+Jobserver(Style style, size_t jobs, int read, int write, std::string const &path) :
+    _style   (style),
+    _jobs    (jobs),
+    _read    (read),
+    _write   (write),
+    _path    (path),
+    _implicit(true),
+    _acquired(0)
+{
+}
+
+Jobserver::
+~Jobserver()
+{
+#if !_WIN32
+    ::close(_read);
+    if (_write != _read) {
+        ::close(_write);
+    }
+    if (!_path.empty()) {
+        ::unlink(_path.c_str());
+    }
+#endif
+}
+
+bool Jobserver::
+acquire()
+{
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        if (_implicit) {
+            _implicit = false;
+            return true;
+        }
+    }
+
+#if _WIN32
+    return false;
+#else
+    /* Wait outside the lock, so releases can happen meanwhile. */
+    for (;;) {
+        char token;
+        ssize_t size = ::read(_read, &token, 1);
+        if (size == 1) {
+            break;
+        } else if (size < 0 && errno == EINTR) {
+            continue;
+        } else {
+            return false;
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(_mutex);
+    _acquired++;
+    return true;
+#endif
+}
+
+void Jobserver::
+release()
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    /* Like make, give back tokens from the pool before the implicit one. */
+    if (_acquired == 0) {
+        _implicit = true;
+        return;
+    }
+
+#if !_WIN32
+    while (::write(_write, &JobserverToken, 1) < 0 && errno == EINTR) {
+    }
+#endif
+    _acquired--;
+}
+
+std::string Jobserver::
+makeflags() const
+{
+    std::string auth;
+    switch (_style) {
+        case Style::Pipe:
+            auth = std::to_string(_read) + "," + std::to_string(_write);
+            break;
+        case Style::Fifo:
+            auth = "fifo:" + _path;
+            break;
+    }
+
+    return "-j" + std::to_string(_jobs) + " --jobserver-auth=" + auth;
+}
+
+void Jobserver::
+environment(std::unordered_map<std::string, std::string> *environment) const
+{
+    /*
+     * The first word of `MAKEFLAGS` is for single letter flags, so it is
+     * empty (a leading space) when make has none to pass.
+     */
+    std::string &makeflags = (*environment)["MAKEFLAGS"];
+    makeflags += " " + this->makeflags();
+}
+
+std::unique_ptr<Jobserver> Jobserver::
+Create(Style style, size_t jobs, std::string const &temporaryDirectory)
+{
+    if (jobs == 0) {
+        return nullptr;
+    }
+
+#if _WIN32
+    return nullptr;
+#else
+    int read = -1;
+    int write = -1;
+    std::string path;
+
+    switch (style) {
+        case Style::Pipe: {
+            /*
+             * Closed on exec, so only children given the pool inherit it;
+             * the launcher keeps it open for them. See `Inherited()`.
+             */
+            int fds[2];
+            if (::pipe(fds) != 0) {
+                ::perror("pipe");
+                return nullptr;
+            }
+            read = fds[0];
+            write = fds[1];
+
+            if (::fcntl(read, F_SETFD, FD_CLOEXEC) != 0 || ::fcntl(write, F_SETFD, FD_CLOEXEC) != 0) {
+                ::perror("fcntl");
+                ::close(read);
+                ::close(write);
+                return nullptr;
+            }
+            break;
+        }
+        case Style::Fifo: {
+            path = temporaryDirectory + "/xcbuild-jobserver-" + std::to_string(::getpid());
+            ::unlink(path.c_str());
+            if (::mkfifo(path.c_str(), S_IRUSR | S_IWUSR) != 0) {
+                ::perror("mkfifo");
+                return nullptr;
+            }
+
+            /* Open for both, so reads wait for tokens rather than writers. */
+            read = write = ::open(path.c_str(), O_RDWR | O_CLOEXEC);
+            if (read < 0) {
+                ::perror("open");
+                ::unlink(path.c_str());
+                return nullptr;
+            }
+            break;
+        }
+    }
+
+    std::unique_ptr<Jobserver> jobserver = std::unique_ptr<Jobserver>(new Jobserver(style, jobs, read, write, path));
+
+    /* This process holds one token, so the pool starts with the rest. */
+    for (size_t i = 1; i < jobs; i++) {
+        if (::write(write, &JobserverToken, 1) != 1) {
+            ::perror("write");
+            return nullptr;
+        }
+    }
+
+    return jobserver;
+#endif
+}
+
+std::vector<int> Jobserver::
+Inherited(std::unordered_map<std::string, std::string> const &environment)
+{
+    auto it = environment.find("MAKEFLAGS");
+    if (it == environment.end()) {
+        return std::vector<int>();
+    }
+
+    /* Like make, the last pool in the flags is the one used. */
+    std::string const &makeflags = it->second;
+    std::string::size_type start = makeflags.rfind("--jobserver-auth=");
+    if (start == std::string::npos) {
+        return std::vector<int>();
+    }
+    start += sizeof("--jobserver-auth=") - 1;
+
+    /* Pipes are two numbers, "read,write"; named pipes are "fifo:path". */
+    int read;
+    int write;
+    char end;
+    std::string auth = makeflags.substr(start, makeflags.find(' ', start) - start);
+    if (::sscanf(auth.c_str(), "%d,%d%c", &read, &write, &end) != 2 || read < 0 || write < 0) {
+        return std::vector<int>();
+    }
+
+    return { read, write };
+}
+
+ext::optional<Jobserver::Style> Jobserver::
+ParseStyle(std::string const &name)
+{
+    if (name == "pipe") {
+        return Style::Pipe;
+    } else if (name == "fifo") {
+        return Style::Fifo;
+    } else {
+        return ext::nullopt;
+    }
+}
@@ -0,0 +1,320 @@
+/**
+ Copyright (c) 2015-present, Facebook, Inc.
+ All rights reserved.
+
+ This source code is licensed under the BSD-style license found in the
+ LICENSE file in the root directory of this source tree. An additional grant
+ of patent rights can be found in the PATENTS file in the same directory.
+ */
+
+#include <gtest/gtest.h>
+#include <process/Jobserver.h>
+#include <process/DefaultLauncher.h>
+#include <process/MemoryContext.h>
+#include <libutil/DefaultFilesystem.h>
+
+#if !_WIN32
+#include <atomic>
+#include <cstring>
+#include <deque>
+
+#include <fcntl.h>
+#include <signal.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/time.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
+using process::Jobserver;
+using libutil::DefaultFilesystem;
+
+TEST(Jobserver, ParseStyle)
+{
+    EXPECT_EQ(ext::optional<Jobserver::Style>(Jobserver::Style::Pipe), Jobserver::ParseStyle("pipe"));
+    EXPECT_EQ(ext::optional<Jobserver::Style>(Jobserver::Style::Fifo), Jobserver::ParseStyle("fifo"));
+    EXPECT_EQ(ext::nullopt, Jobserver::ParseStyle("sem"));
+}
+
+#if !_WIN32
+TEST(Jobserver, Environment)
+{
+    auto jobserver = Jobserver::Create(Jobserver::Style::Pipe, 4, "/tmp");
+    ASSERT_NE(nullptr, jobserver);
+    EXPECT_EQ(0, jobserver->makeflags().find("-j4 --jobserver-auth="));
+
+    /* Make's first word is single letter flags, empty if there are none. */
+    std::unordered_map<std::string, std::string> environment;
+    jobserver->environment(&environment);
+    EXPECT_EQ(" " + jobserver->makeflags(), environment["MAKEFLAGS"]);
+
+    std::unordered_map<std::string, std::string> existing = { { "MAKEFLAGS", "k" } };
+    jobserver->environment(&existing);
+    EXPECT_EQ("k " + jobserver->makeflags(), existing["MAKEFLAGS"]);
+}
+
+TEST(Jobserver, Inherited)
+{
+    auto jobserver = Jobserver::Create(Jobserver::Style::Pipe, 2, "/tmp");
+    ASSERT_NE(nullptr, jobserver);
+
+    std::unordered_map<std::string, std::string> environment = { { "MAKEFLAGS", "k --jobserver-auth=fifo:/tmp/other" } };
+    EXPECT_TRUE(Jobserver::Inherited(environment).empty());
+    jobserver->environment(&environment);
+
+    std::vector<int> inherited = Jobserver::Inherited(environment);
+    ASSERT_EQ(2, inherited.size());
+    EXPECT_EQ("k --jobserver-auth=fifo:/tmp/other -j2 --jobserver-auth=" + std::to_string(inherited[0]) + "," + std::to_string(inherited[1]), environment["MAKEFLAGS"]);
+
+    /* The pipe is closed on exec... */
+    for (int fd : inherited) {
+        EXPECT_NE(0, fcntl(fd, F_GETFD) & FD_CLOEXEC);
+    }
+
+    /* ...except in children given the pool. */
+    DefaultFilesystem filesystem;
+    process::DefaultLauncher launcher;
+    std::string check = "{ : <&" + std::to_string(inherited[0]) + "; } 2>/dev/null";
+
+    process::MemoryContext without = process::MemoryContext("/bin/sh", "/", { "-c", check }, { });
+    EXPECT_NE(ext::optional<int>(0), launcher.launch(&filesystem, &without));
+
+    process::MemoryContext with = process::MemoryContext("/bin/sh", "/", { "-c", check }, environment);
+    EXPECT_EQ(ext::optional<int>(0), launcher.launch(&filesystem, &with));
+
+    /* Named pipes are opened by path. */
+    auto fifo = Jobserver::Create(Jobserver::Style::Fifo, 2, "/tmp");
+    ASSERT_NE(nullptr, fifo);
+    std::unordered_map<std::string, std::string> named;
+    fifo->environment(&named);
+    EXPECT_TRUE(Jobserver::Inherited(named).empty());
+}
+
+TEST(Jobserver, Fifo)
+{
+    std::string path;
+    {
+        auto jobserver = Jobserver::Create(Jobserver::Style::Fifo, 2, "/tmp");
+        ASSERT_NE(nullptr, jobserver);
+
+        path = jobserver->path();
+        EXPECT_EQ("-j2 --jobserver-auth=fifo:" + path, jobserver->makeflags());
+
+        struct stat st;
+        ASSERT_EQ(0, stat(path.c_str(), &st));
+        EXPECT_TRUE(S_ISFIFO(st.st_mode));
+    }
+
+    /* Removed with the pool. */
+    struct stat st;
+    EXPECT_NE(0, stat(path.c_str(), &st));
+}
+
+TEST(Jobserver, AcquireRelease)
+{
+    auto jobserver = Jobserver::Create(Jobserver::Style::Pipe, 3, "/tmp");
+    ASSERT_NE(nullptr, jobserver);
+
+    /* The implicit token, then the two in the pool. */
+    for (int i = 0; i < 3; i++) {
+        EXPECT_TRUE(jobserver->acquire());
+    }
+    for (int i = 0; i < 3; i++) {
+        jobserver->release();
+    }
+
+    /* All of them are available again. */
+    for (int i = 0; i < 3; i++) {
+        EXPECT_TRUE(jobserver->acquire());
+    }
+    for (int i = 0; i < 3; i++) {
+        jobserver->release();
+    }
+}
+
+/*
+ * Jobs running at once, across processes.
+ */
+struct JobserverCounts {
+    std::atomic<int> running;
+    std::atomic<int> peak;
+};
+
+/*
+ * A job in a fake make: counts itself as running for a while.
+ */
+static int
+FakeJob(JobserverCounts *counts)
+{
+    int running = ++counts->running;
+    int peak = counts->peak.load();
+    while (running > peak && !counts->peak.compare_exchange_weak(peak, running)) {
+    }
+
+    usleep(20 * 1000);
+    --counts->running;
+    return 0;
+}
+
+static void
+FakeMakeAlarm(int signal)
+{
+}
+
+/*
+ * A fake make, run in a child process: runs a number of jobs, as many at
+ * once as it has tokens for. Like make, the first job uses the token the
+ * child was started with, and the rest take one from the pool described in
+ * `MAKEFLAGS`, returning it when they finish.
+ */
+static int
+FakeMake(std::string const &makeflags, JobserverCounts *counts, size_t jobs)
+{
+    std::string::size_type start = makeflags.rfind("--jobserver-auth=");
+    if (start == std::string::npos) {
+        return 1;
+    }
+    start += strlen("--jobserver-auth=");
+    std::string auth = makeflags.substr(start, makeflags.find(' ', start) - start);
+
+    int read = -1;
+    int write = -1;
+    if (auth.compare(0, 5, "fifo:") == 0) {
+        read = write = open(auth.substr(5).c_str(), O_RDWR);
+    } else if (sscanf(auth.c_str(), "%d,%d", &read, &write) != 2) {
+        return 1;
+    }
+    if (read < 0 || write < 0) {
+        return 1;
+    }
+
+    /* Interrupt waiting for a token now and then, to notice finished jobs. */
+    struct sigaction action;
+    memset(&action, 0, sizeof(action));
+    action.sa_handler = &FakeMakeAlarm;
+    sigaction(SIGALRM, &action, nullptr);
+
+    bool implicit = true;
+    size_t started = 0;
+    std::unordered_map<pid_t, bool> running;
+    while (started < jobs || !running.empty()) {
+        /* Finished jobs give back their tokens. */
+        int status;
+        pid_t pid;
+        while ((pid = waitpid(-1, &status, WNOHANG)) > 0) {
+            if (running[pid]) {
+                char token = '+';
+                if (::write(write, &token, 1) != 1) {
+                    return 1;
+                }
+            } else {
+                implicit = true;
+            }
+            running.erase(pid);
+        }
+
+        if (started == jobs) {
+            usleep(1000);
+            continue;
+        }
+
+        bool token = false;
+        if (implicit) {
+            implicit = false;
+        } else {
+            struct itimerval timer;
+            memset(&timer, 0, sizeof(timer));
+            timer.it_value.tv_usec = timer.it_interval.tv_usec = 5000;
+            setitimer(ITIMER_REAL, &timer, nullptr);
+
+            char byte;
+            token = (::read(read, &byte, 1) == 1);
+
+            memset(&timer, 0, sizeof(timer));
+            setitimer(ITIMER_REAL, &timer, nullptr);
+
+            if (!token) {
+                continue;
+            }
+        }
+
+        pid = fork();
+        if (pid == 0) {
+            _exit(FakeJob(counts));
+        } else if (pid < 0) {
+            return 1;
+        }
+
+        running[pid] = token;
+        started++;
+    }
+
+    return 0;
+}
+
+static void
+JobserverPeak(Jobserver::Style style)
+{
+    auto jobserver = Jobserver::Create(style, 3, "/tmp");
+    ASSERT_NE(nullptr, jobserver);
+
+    std::unordered_map<std::string, std::string> environment;
+    jobserver->environment(&environment);
+
+    void *memory = mmap(nullptr, sizeof(JobserverCounts), PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+    ASSERT_NE(MAP_FAILED, memory);
+    JobserverCounts *counts = new (memory) JobserverCounts();
+    counts->running = 0;
+    counts->peak = 0;
+
+    /*
+     * Run more children than there are jobs, each wanting to run more jobs
+     * than there are in total. Like an executor, each child holds a token
+     * while it runs, and at most three run at once.
+     */
+    std::deque<pid_t> children;
+    for (int i = 0; i < 5; i++) {
+        if (children.size() == 3) {
+            int status;
+            ASSERT_EQ(children.front(), waitpid(children.front(), &status, 0));
+            EXPECT_EQ(0, WEXITSTATUS(status));
+            children.pop_front();
+            jobserver->release();
+        }
+
+        ASSERT_TRUE(jobserver->acquire());
+
+        pid_t pid = fork();
+        ASSERT_NE(-1, pid);
+        if (pid == 0) {
+            _exit(FakeMake(environment["MAKEFLAGS"], counts, 4));
+        }
+        children.push_back(pid);
+    }
+
+    for (pid_t pid : children) {
+        int status;
+        ASSERT_EQ(pid, waitpid(pid, &status, 0));
+        EXPECT_EQ(0, WEXITSTATUS(status));
+        jobserver->release();
+    }
+
+    /* Never more than the jobs in the pool, but some at once. */
+    EXPECT_LE(counts->peak.load(), 3);
+    EXPECT_GE(counts->peak.load(), 2);
+    EXPECT_EQ(0, counts->running.load());
+
+    munmap(memory, sizeof(JobserverCounts));
+}
+
+TEST(Jobserver, PipePeak)
+{
+    JobserverPeak(Jobserver::Style::Pipe);
+}
+
+TEST(Jobserver, FifoPeak)
+{
+    JobserverPeak(Jobserver::Style::Fifo);
+}
+#endif
@@ -0,0 +1,306 @@
+/**
+ Copyright (c) 2015-present, Facebook, Inc.
+ All rights reserved.
+
+ This source code is licensed under the BSD-style license found in the
+ LICENSE file in the root directory of this source tree. An additional grant
+ of patent rights can be found in the PATENTS file in the same directory.
+ */
+
+#include <benchmark/Harness.h>
+#include <xcassets/Asset/Catalog.h>
+#include <plist/Format/JSON.h>
+#include <plist/Format/JSONReader.h>
+#include <libutil/DefaultFilesystem.h>
+#include <libutil/Options.h>
+#include <process/DefaultContext.h>
+
+#include <cstdio>
+#include <cstdlib>
+#include <thread>
+
+using benchmark::Harness;
+using libutil::DefaultFilesystem;
+
+class Options {
+private:
+    ext::optional<bool>        _help;
+
+private:
+    ext::optional<int>         _assets;
+    ext::optional<int>         _groups;
+    ext::optional<int>         _threads;
+
+private:
+    ext::optional<std::string> _catalog;
+    ext::optional<bool>        _csv;
+
+public:
+    Options();
+    ~Options();
+
+public:
+    bool help() const
+    { return _help.value_or(false); }
+
+public:
+    int assets() const
+    { return _assets.value_or(20000); }
+    int groups() const
+    { return _groups.value_or(100); }
+    int threads() const
+    { return _threads.value_or(static_cast<int>(std::thread::hardware_concurrency())); }
+
+public:
+    ext::optional<std::string> const &catalog() const
+    { return _catalog; }
+    bool csv() const
+    { return _csv.value_or(false); }
+
+private:
+    friend class libutil::Options;
+    std::pair<bool, std::string>
+    parseArgument(std::vector<std::string> const &args, std::vector<std::string>::const_iterator *it);
+};
+
+Options::
+Options()
+{
+}
+
+Options::
+~Options()
+{
+}
+
+std::pair<bool, std::string> Options::
+parseArgument(std::vector<std::string> const &args, std::vector<std::string>::const_iterator *it)
+{
+    std::string const &arg = **it;
+
+    if (arg == "-h" || arg == "--help") {
+        return libutil::Options::Current<bool>(&_help, arg);
+    } else if (arg == "--assets") {
+        return libutil::Options::Next<int>(&_assets, args, it);
+    } else if (arg == "--groups") {
+        return libutil::Options::Next<int>(&_groups, args, it);
+    } else if (arg == "--threads") {
+        return libutil::Options::Next<int>(&_threads, args, it);
+    } else if (arg == "--catalog") {
+        return libutil::Options::Next<std::string>(&_catalog, args, it);
+    } else if (arg == "--csv") {
+        return libutil::Options::Current<bool>(&_csv, arg);
+    } else {
+        return std::make_pair(false, "unknown argument " + arg);
+    }
+}
+
+static int
+Help(std::string const &error = std::string())
+{
+    if (!error.empty()) {
+        fprintf(stderr, "error: %s\n", error.c_str());
+        fprintf(stderr, "\n");
+    }
+
+    fprintf(stderr, "Usage: bench_xcassets_Catalog [options]\n\n");
+    fprintf(stderr, "Measures loading an asset catalog on one thread and in parallel,\n");
+    fprintf(stderr, "and parsing its contents files into dictionaries and streamed.\n\n");
+
+#define INDENT "  "
+    fprintf(stderr, "Options:\n");
+    fprintf(stderr, INDENT "--assets <count> (image sets in generated catalog)\n");
+    fprintf(stderr, INDENT "--groups <count> (groups in generated catalog)\n");
+    fprintf(stderr, INDENT "--threads <count>\n");
+    fprintf(stderr, INDENT "--catalog <path> (default: generated catalog)\n");
+    fprintf(stderr, INDENT "--csv\n");
+    fprintf(stderr, "\n");
+#undef INDENT
+
+    return (error.empty() ? EXIT_SUCCESS : EXIT_FAILURE);
+}
+
+static std::vector<uint8_t>
+Contents(std::string const &string)
+{
+    return std::vector<uint8_t>(string.begin(), string.end());
+}
+
+/*
+ * Generate a catalog of groups of image sets, like Xcode writes them.
+ */
+static bool
+Generate(DefaultFilesystem *filesystem, std::string const &catalog, int assets, int groups)
+{
+    std::vector<uint8_t> info = Contents("{\n  \"info\" : {\n    \"version\" : 1,\n    \"author\" : \"xcode\"\n  }\n}");
+    if (!filesystem->createDirectory(catalog, true) || !filesystem->write(info, catalog + "/Contents.json")) {
+        return false;
+    }
+
+    for (int i = 0; i < assets; i++) {
+        std::string group = catalog + "/Group" + std::to_string(i % groups);
+        std::string name = "Image" + std::to_string(i);
+        std::string path = group + "/" + name + ".imageset";
+
+        if (i < groups && (!filesystem->createDirectory(group, true) || !filesystem->write(info, group + "/Contents.json"))) {
+            return false;
+        }
+
+        std::string contents = "{\n  \"images\" : [\n";
+        contents += "    {\n      \"idiom\" : \"universal\",\n      \"filename\" : \"" + name + ".png\",\n      \"scale\" : \"1x\"\n    },\n";
+        contents += "    {\n      \"idiom\" : \"universal\",\n      \"filename\" : \"" + name + "@2x.png\",\n      \"scale\" : \"2x\"\n    },\n";
+        contents += "    {\n      \"idiom\" : \"universal\",\n      \"filename\" : \"" + name + "@3x.png\",\n      \"scale\" : \"3x\"\n    }\n";
+        contents += "  ],\n  \"info\" : {\n    \"version\" : 1,\n    \"author\" : \"xcode\"\n  }\n}";
+
+        if (!filesystem->createDirectory(path, false) || !filesystem->write(Contents(contents), path + "/Contents.json")) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+static void
+AssetNames(xcassets::Asset::Asset const *asset, std::vector<std::string> *names)
+{
+    for (auto const &child : asset->children()) {
+        names->push_back(child->name().string());
+        AssetNames(child.get(), names);
+    }
+}
+
+static void
+ContentsFiles(xcassets::Asset::Asset const *asset, std::vector<std::string> *paths)
+{
+    paths->push_back(asset->path() + "/Contents.json");
+    for (auto const &child : asset->children()) {
+        ContentsFiles(child.get(), paths);
+    }
+}
+
+int
+main(int argc, char **argv)
+{
+    process::DefaultContext processContext = process::DefaultContext();
+
+    Options options;
+    std::pair<bool, std::string> result = libutil::Options::Parse<Options>(&options, processContext.commandLineArguments());
+    if (!result.first) {
+        return Help(result.second);
+    }
+
+    if (options.help()) {
+        return Help();
+    }
+
+    if (options.assets() <= 0 || options.groups() <= 0 || options.threads() <= 0) {
+        return Help("invalid count");
+    }
+
+    DefaultFilesystem filesystem;
+
+    std::string root;
+    std::string catalog;
+    if (options.catalog()) {
+        catalog = *options.catalog();
+    } else {
+        char temporary[] = "/tmp/bench_xcassets_Catalog-XXXXXX";
+        if (mkdtemp(temporary) == nullptr) {
+            return Help("unable to create temporary directory");
+        }
+        root = temporary;
+        catalog = root + "/Assets.xcassets";
+    }
+
+    std::string source = (options.catalog() ? *options.catalog() : "assets=" + std::to_string(options.assets()) + " groups=" + std::to_string(options.groups()));
+    Harness harness = Harness("xcassets catalog " + source + " threads=" + std::to_string(options.threads()));
+
+    harness.stage("Generate", [&]() -> bool {
+        return options.catalog() || Generate(&filesystem, catalog, options.assets(), options.groups());
+    });
+
+    /* Load once first, so both loads find the files cached. */
+    std::vector<std::string> paths;
+    harness.stage("Warm", [&]() -> bool {
+        auto loaded = xcassets::Asset::Catalog::Load(&filesystem, catalog, 1);
+        if (loaded != nullptr) {
+            ContentsFiles(loaded.get(), &paths);
+        }
+        return (loaded != nullptr);
+    });
+
+    std::vector<std::string> serialNames;
+    harness.stage("Load (1 thread)", [&]() -> bool {
+        auto loaded = xcassets::Asset::Catalog::Load(&filesystem, catalog, 1);
+        if (loaded != nullptr) {
+            AssetNames(loaded.get(), &serialNames);
+        }
+        return (loaded != nullptr);
+    });
+
+    std::vector<std::string> parallelNames;
+    harness.stage("Load (" + std::to_string(options.threads()) + " threads)", [&]() -> bool {
+        auto loaded = xcassets::Asset::Catalog::Load(&filesystem, catalog, options.threads());
+        if (loaded != nullptr) {
+            AssetNames(loaded.get(), &parallelNames);
+        }
+        return (loaded != nullptr);
+    });
+
+    /* Parsing alone, without the filesystem. */
+    std::vector<std::vector<uint8_t>> contents;
+    harness.stage("Read contents", [&]() -> bool {
+        for (std::string const &path : paths) {
+            std::vector<uint8_t> data;
+            if (filesystem.read(&data, path)) {
+                contents.push_back(std::move(data));
+            }
+        }
+        return !contents.empty();
+    });
+
+    harness.stage("Parse contents (dictionary)", [&]() -> bool {
+        for (std::vector<uint8_t> const &data : contents) {
+            auto deserialize = plist::Format::JSON::Deserialize(data, plist::Format::JSON::Create());
+            if (deserialize.first == nullptr) {
+                return false;
+            }
+        }
+        return true;
+    });
+
+    harness.stage("Parse contents (streamed)", [&]() -> bool {
+        for (std::vector<uint8_t> const &data : contents) {
+            plist::Format::JSONReader reader(data.data(), data.size());
+
+            plist::Format::JSONReader::Token token;
+            do {
+                token = reader.next();
+            } while (token != plist::Format::JSONReader::Token::End && token != plist::Format::JSONReader::Token::Error);
+
+            if (token == plist::Format::JSONReader::Token::Error) {
+                return false;
+            }
+        }
+        return true;
+    });
+
+    if (!root.empty()) {
+        filesystem.removeDirectory(root, true);
+    }
+
+    if (options.csv()) {
+        harness.reportCSV(stdout, true);
+    } else {
+        harness.report(stdout);
+        fprintf(stdout, "Assets: %zu, order %s\n", serialNames.size(), (serialNames == parallelNames ? "matches" : "differs"));
+    }
+
+    for (Harness::Result const &result : harness.results()) {
+        if (!result.success()) {
+            return EXIT_FAILURE;
+        }
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -22,6 +22,7 @@
 #include <ext/optional>
 
 namespace libutil { class Filesystem; }
+namespace plist { namespace Format { class JSONReader; } }
 
 namespace xcassets {
 namespace Asset {
@@ -97,13 +98,17 @@ public:
 
 public:
     /*
-     * Load an asset from a directory.
+     * Load an asset from a directory. Sibling assets within it are loaded
+     * in parallel on up to `jobs` threads, by default on threads shared by
+     * all loads, one per processor. Children, and what they print, are
+     * always in directory order.
      */
     static std::unique_ptr<Asset> Load(
         libutil::Filesystem const *filesystem,
         std::string const &path,
         std::vector<std::string> const &groups,
-        ext::optional<std::string> const &overrideExtension = ext::nullopt);
+        ext::optional<std::string> const &overrideExtension = ext::nullopt,
+        ext::optional<size_t> jobs = ext::nullopt);
 
 protected:
     /*
@@ -115,6 +120,28 @@ protected:
      * Override to parse the contents, which can be null.
      */
     virtual bool parse(plist::Dictionary const *dict, std::unordered_set<std::string> *seen, bool check);
+
+protected:
+    /*
+     * If the contents should be parsed with `stream()` as they are read,
+     * rather than read into a dictionary for `parse()`. Streamed contents
+     * are parsed after the children are loaded, so can't affect them.
+     */
+    virtual bool streamable() const
+    { return false; }
+
+    /*
+     * Override to parse the contents from a reader positioned at the start
+     * of the contents dictionary, through to its end. The default reads the
+     * dictionary and parses it.
+     */
+    virtual bool stream(plist::Format::JSONReader *reader);
+
+protected:
+    /*
+     * Parse the `info` dictionary from the contents.
+     */
+    bool parseInfo(plist::Dictionary const *info);
 };
 
 }
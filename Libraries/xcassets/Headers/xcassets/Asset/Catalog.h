@@ -32,9 +32,9 @@ public:
 
 public:
     /*
-     * Load an asset catalog from a directory.
+     * Load an asset catalog from a directory, on up to `jobs` threads.
      */
-    static std::unique_ptr<Catalog> Load(libutil::Filesystem const *filesystem, std::string const &path);
+    static std::unique_ptr<Catalog> Load(libutil::Filesystem const *filesystem, std::string const &path, ext::optional<size_t> jobs = ext::nullopt);
 
 protected:
     virtual bool parse(plist::Dictionary const *dict, std::unordered_set<std::string> *seen, bool check);
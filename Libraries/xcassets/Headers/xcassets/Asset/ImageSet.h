@@ -95,6 +95,7 @@ public:
     private:
         friend class ImageSet;
         bool parse(plist::Dictionary const *dict);
+        bool stream(plist::Format::JSONReader *reader);
     };
 
 private:
@@ -126,6 +127,14 @@ public:
 
 protected:
     virtual bool parse(plist::Dictionary const *dict, std::unordered_set<std::string> *seen, bool check);
+
+protected:
+    virtual bool streamable() const
+    { return true; }
+    virtual bool stream(plist::Format::JSONReader *reader);
+
+private:
+    void parseProperties(plist::Dictionary const *dict);
 };
 
 }
@@ -0,0 +1,56 @@
+/**
+ Copyright (c) 2015-present, Facebook, Inc.
+ All rights reserved.
+
+ This source code is licensed under the BSD-style license found in the
+ LICENSE file in the root directory of this source tree. An additional grant
+ of patent rights can be found in the PATENTS file in the same directory.
+ */
+
+#ifndef __xcassets_Diagnostics_h
+#define __xcassets_Diagnostics_h
+
+#include <string>
+
+namespace xcassets {
+
+/*
+ * Warnings and errors found while loading assets. Sibling assets load on
+ * different threads, so what each one prints is collected, and printed by
+ * its parent in directory order once they have all loaded.
+ */
+class Diagnostics {
+public:
+    /*
+     * Collects what is printed on this thread until the scope ends,
+     * rather than printing it. Scopes can be nested; the innermost one
+     * collects.
+     */
+    class Collect {
+    private:
+        std::string *_output;
+        std::string *_previous;
+
+    public:
+        explicit Collect(std::string *output);
+        ~Collect();
+
+    private:
+        Collect(Collect const &) = delete;
+        Collect &operator=(Collect const &) = delete;
+    };
+
+public:
+    /*
+     * Print a diagnostic, like `fprintf(stderr, ...)`.
+     */
+    static void Print(char const *format, ...)
+#if defined(__GNUC__)
+        __attribute__((format(printf, 1, 2)))
+#endif
+        ;
+};
+
+}
+
+#endif // !__xcassets_Diagnostics_h
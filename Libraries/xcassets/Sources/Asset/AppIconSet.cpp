@@ -8,6 +8,7 @@
  */
 
 #include <xcassets/Asset/AppIconSet.h>
+#include <xcassets/Diagnostics.h>
 #include <plist/Keys/Unpack.h>
 #include <plist/Array.h>
 #include <plist/Boolean.h>
@@ -15,6 +16,7 @@
 #include <plist/String.h>
 
 using xcassets::Asset::AppIconSet;
+using xcassets::Diagnostics;
 
 bool AppIconSet::Image::
 parse(plist::Dictionary const *dict)
@@ -32,7 +34,7 @@ parse(plist::Dictionary const *dict)
     auto MS = unpack.cast <plist::String> ("matching-style");
 
     if (!unpack.complete(true)) {
-        fprintf(stderr, "%s", unpack.errorText().c_str());
+        Diagnostics::Print("%s", unpack.errorText().c_str());
     }
 
     if (FN != nullptr) {
@@ -74,7 +76,7 @@ bool AppIconSet::
 parse(plist::Dictionary const *dict, std::unordered_set<std::string> *seen, bool check)
 {
     if (!this->children().empty()) {
-        fprintf(stderr, "warning: unexpected child assets\n");
+        Diagnostics::Print("warning: unexpected child assets\n");
     }
 
     if (!Asset::parse(dict, seen, false)) {
@@ -92,7 +94,7 @@ parse(plist::Dictionary const *dict, std::unordered_set<std::string> *seen, bool
     auto I = unpack.cast <plist::Array> ("images");
 
     if (!unpack.complete(check)) {
-        fprintf(stderr, "%s", unpack.errorText().c_str());
+        Diagnostics::Print("%s", unpack.errorText().c_str());
     }
 
     if (P != nullptr) {
@@ -102,7 +104,7 @@ parse(plist::Dictionary const *dict, std::unordered_set<std::string> *seen, bool
         auto PR = unpack.cast <plist::Boolean> ("pre-rendered");
 
         if (!unpack.complete(check)) {
-            fprintf(stderr, "%s", unpack.errorText().c_str());
+            Diagnostics::Print("%s", unpack.errorText().c_str());
         }
 
         if (PR != nullptr) {
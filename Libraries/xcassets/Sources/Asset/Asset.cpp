@@ -31,17 +31,27 @@
 #include <xcassets/Asset/StickersIconSet.h>
 #include <xcassets/Asset/SpriteAtlas.h>
 #include <xcassets/Asset/TextureSet.h>
+#include <xcassets/Diagnostics.h>
 #include <plist/Keys/Unpack.h>
 #include <plist/Format/JSON.h>
+#include <plist/Format/JSONReader.h>
 #include <plist/Boolean.h>
 #include <plist/String.h>
 #include <plist/Integer.h>
 #include <libutil/Filesystem.h>
 #include <libutil/FSUtil.h>
 
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+
 using xcassets::Asset::Asset;
 using xcassets::Asset::AssetType;
 using xcassets::FullyQualifiedName;
+using xcassets::Diagnostics;
 using libutil::Filesystem;
 using libutil::FSUtil;
 
@@ -109,40 +119,204 @@ parse(plist::Dictionary const *dict, std::unordered_set<std::string> *seen, bool
     auto I = unpack.cast <plist::Dictionary> ("info");
 
     if (!unpack.complete(check)) {
-        fprintf(stderr, "%s", unpack.errorText().c_str());
+        Diagnostics::Print("%s", unpack.errorText().c_str());
     }
 
     if (I != nullptr) {
-        std::unordered_set<std::string> seen;
-        auto unpack = plist::Keys::Unpack("Info", I, &seen);
+        if (!parseInfo(I)) {
+            return false;
+        }
+    }
 
-        auto A = unpack.cast <plist::String> ("author");
-        auto V = unpack.cast <plist::Integer> ("version");
+    return true;
+}
 
-        if (!unpack.complete(true)) {
-            fprintf(stderr, "%s", unpack.errorText().c_str());
+bool Asset::
+parseInfo(plist::Dictionary const *info)
+{
+    std::unordered_set<std::string> seen;
+    auto unpack = plist::Keys::Unpack("Info", info, &seen);
+
+    auto A = unpack.cast <plist::String> ("author");
+    auto V = unpack.cast <plist::Integer> ("version");
+
+    if (!unpack.complete(true)) {
+        Diagnostics::Print("%s", unpack.errorText().c_str());
+    }
+
+    if (A != nullptr) {
+        _author = A->value();
+    }
+
+    if (V != nullptr) {
+        _version = static_cast<int>(V->value());
+
+        if (_version != 1) {
+            Diagnostics::Print("warning: unknown version: %d", *_version);
+            return false;
         }
+    }
+
+    return true;
+}
+
+bool Asset::
+stream(plist::Format::JSONReader *reader)
+{
+    std::unique_ptr<plist::Object> contents = reader->object();
+    if (contents == nullptr) {
+        return false;
+    }
+
+    std::unordered_set<std::string> seen;
+    return this->parse(static_cast<plist::Dictionary const *>(contents.get()), &seen, true);
+}
 
-        if (A != nullptr) {
-            _author = A->value();
+/*
+ * Loads sibling assets in parallel. Each directory queues its children as
+ * a batch, then loads them alongside the pool's threads until the whole
+ * batch is loaded. While waiting, a thread only loads assets from its own
+ * batch, so nested directories can't deadlock the pool or nest deeper on
+ * the stack than the directories themselves.
+ */
+class AssetLoadPool {
+private:
+    class Batch {
+    public:
+        std::vector<std::function<void()>> tasks;
+        size_t                             next;
+        size_t                             remaining;
+    };
+
+private:
+    std::mutex               _mutex;
+    std::condition_variable  _condition;
+    std::deque<Batch *>      _pending;
+    std::vector<std::thread> _threads;
+    bool                     _stop;
+
+public:
+    static thread_local AssetLoadPool *Current;
+
+public:
+    /*
+     * One thread per processor, shared by every load that doesn't ask
+     * for a number of jobs, so loads of many catalogs at once don't each
+     * start a thread per processor. Intentionally leaked, so its threads
+     * keep waiting for work rather than being joined during exit.
+     */
+    static AssetLoadPool *Shared()
+    {
+        static AssetLoadPool *pool = new AssetLoadPool(std::max<size_t>(std::thread::hardware_concurrency(), 1));
+        return pool;
+    }
+
+public:
+    explicit AssetLoadPool(size_t jobs) :
+        _stop(false)
+    {
+        /* The thread loading the outermost asset is one of the jobs. */
+        for (size_t n = 1; n < jobs; n++) {
+            _threads.emplace_back([this] { work(); });
+        }
+    }
+
+    ~AssetLoadPool()
+    {
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _stop = true;
+        }
+        _condition.notify_all();
+
+        for (std::thread &thread : _threads) {
+            thread.join();
+        }
+    }
+
+public:
+    /*
+     * Run the tasks, returning once all of them have finished.
+     */
+    void run(std::vector<std::function<void()>> tasks)
+    {
+        if (tasks.empty()) {
+            return;
         }
 
-        if (V != nullptr) {
-            _version = static_cast<int>(V->value());
+        Batch batch;
+        batch.tasks = std::move(tasks);
+        batch.next = 0;
+        batch.remaining = batch.tasks.size();
+
+        std::unique_lock<std::mutex> lock(_mutex);
+        _pending.push_back(&batch);
+        _condition.notify_all();
 
-            if (_version != 1) {
-                fprintf(stderr, "warning: unknown version: %d", *_version);
-                return false;
+        while (batch.remaining != 0) {
+            if (batch.next < batch.tasks.size()) {
+                perform(&batch, &lock);
+            } else {
+                _condition.wait(lock);
             }
         }
     }
 
-    return true;
-}
+private:
+    void work()
+    {
+        Current = this;
+
+        std::unique_lock<std::mutex> lock(_mutex);
+        for (;;) {
+            _condition.wait(lock, [this] { return _stop || !_pending.empty(); });
+            if (_pending.empty()) {
+                break;
+            }
+
+            perform(_pending.front(), &lock);
+        }
+    }
+
+    void perform(Batch *batch, std::unique_lock<std::mutex> *lock)
+    {
+        size_t index = batch->next++;
+        if (batch->next == batch->tasks.size()) {
+            _pending.erase(std::find(_pending.begin(), _pending.end(), batch));
+        }
+
+        lock->unlock();
+        batch->tasks[index]();
+        lock->lock();
+
+        if (--batch->remaining == 0) {
+            _condition.notify_all();
+        }
+    }
+};
+
+thread_local AssetLoadPool *AssetLoadPool::Current = nullptr;
 
 std::unique_ptr<Asset> Asset::
-Load(Filesystem const *filesystem, std::string const &path, std::vector<std::string> const &groups, ext::optional<std::string> const &overrideExtension)
+Load(Filesystem const *filesystem, std::string const &path, std::vector<std::string> const &groups, ext::optional<std::string> const &overrideExtension, ext::optional<size_t> jobs)
 {
+    if (AssetLoadPool::Current == nullptr) {
+        /*
+         * Loading the outermost asset: children within it load on a pool,
+         * shared unless a number of jobs is given.
+         */
+        std::unique_ptr<AssetLoadPool> owned;
+        if (jobs) {
+            owned = std::unique_ptr<AssetLoadPool>(new AssetLoadPool(std::max<size_t>(*jobs, 1)));
+        }
+
+        AssetLoadPool::Current = (owned != nullptr ? owned.get() : AssetLoadPool::Shared());
+        std::unique_ptr<Asset> asset = Load(filesystem, path, groups, overrideExtension, jobs);
+        AssetLoadPool::Current = nullptr;
+
+        return asset;
+    }
+
     std::string resolvedPath = filesystem->resolvePath(path);
     FullyQualifiedName name = FullyQualifiedName(groups, FSUtil::GetBaseNameWithoutExtension(path));
 
@@ -253,7 +427,7 @@ Load(Filesystem const *filesystem, std::string const &path, std::vector<std::str
 }
 
 static bool
-LoadContents(Filesystem const *filesystem, std::string const &path, std::unique_ptr<plist::Dictionary> *contentsDictionary)
+LoadContents(Filesystem const *filesystem, std::string const &path, ext::optional<std::vector<uint8_t>> *contents)
 {
     /*
      * Configure the asset with the contents.
@@ -267,57 +441,91 @@ LoadContents(Filesystem const *filesystem, std::string const &path, std::unique_
         /*
          * Read in the contents file.
          */
-        std::vector<uint8_t> contents;
-        if (!filesystem->read(&contents, contentsPath)) {
+        *contents = std::vector<uint8_t>();
+        if (!filesystem->read(&**contents, contentsPath)) {
             return false;
         }
+    }
 
-        /*
-         * If the Contents.json file exists, it must be JSON.
-         */
-        auto deserialized = plist::Format::JSON::Deserialize(contents, plist::Format::JSON::Create());
-        if (!deserialized.first) {
-            return false;
-        }
+    return true;
+}
 
-        /*
-         * If the Contents.json file exists, it must be a dictionary.
-         */
-        if (deserialized.first->type() != plist::Dictionary::Type()) {
-            return false;
-        }
+static bool
+LoadContentsDictionary(std::vector<uint8_t> const &contents, std::unique_ptr<plist::Dictionary> *contentsDictionary)
+{
+    /*
+     * If the Contents.json file exists, it must be JSON.
+     */
+    auto deserialized = plist::Format::JSON::Deserialize(contents, plist::Format::JSON::Create());
+    if (!deserialized.first) {
+        return false;
+    }
 
-        *contentsDictionary = plist::static_unique_pointer_cast<plist::Dictionary>(std::move(deserialized.first));
+    /*
+     * If the Contents.json file exists, it must be a dictionary.
+     */
+    if (deserialized.first->type() != plist::Dictionary::Type()) {
+        return false;
     }
 
+    *contentsDictionary = plist::static_unique_pointer_cast<plist::Dictionary>(std::move(deserialized.first));
     return true;
 }
 
 static bool
 LoadChildren(Filesystem const *filesystem, std::string const &path, FullyQualifiedName const &name, bool providesNamespace, std::vector<std::unique_ptr<Asset>> *children)
 {
-    bool error = false;
+    std::vector<std::string> groups = name.groups();
+    if (providesNamespace) {
+        // TODO: Should fully qualified names include extensions?
+        groups.push_back(name.name());
+    }
 
+    std::vector<std::string> paths;
     filesystem->readDirectory(path, false, [&](std::string const &fileName) -> void {
-        std::string child = path + "/" + fileName;
+        paths.push_back(path + "/" + fileName);
+    });
 
-        if (filesystem->type(child) == Filesystem::Type::Directory) {
-            std::vector<std::string> groups = name.groups();
-            if (providesNamespace) {
-                // TODO: Should fully qualified names include extensions?
-                groups.push_back(name.name());
+    /*
+     * Load children in parallel, each into its own slot to keep them in
+     * directory order. Files are skipped with a null asset. What each
+     * child prints is printed in the same order once all have loaded.
+     */
+    std::vector<std::unique_ptr<Asset>> assets = std::vector<std::unique_ptr<Asset>>(paths.size());
+    std::vector<uint8_t> directories = std::vector<uint8_t>(paths.size(), false);
+    std::vector<std::string> diagnostics = std::vector<std::string>(paths.size());
+
+    std::vector<std::function<void()>> tasks;
+    tasks.reserve(paths.size());
+    for (size_t n = 0; n < paths.size(); n++) {
+        tasks.push_back([&, n] {
+            if (filesystem->type(paths[n]) == Filesystem::Type::Directory) {
+                Diagnostics::Collect collect(&diagnostics[n]);
+                directories[n] = true;
+                assets[n] = Asset::Load(filesystem, paths[n], groups);
             }
+        });
+    }
+    AssetLoadPool::Current->run(std::move(tasks));
 
-            std::unique_ptr<Asset> asset = Asset::Load(filesystem, child, groups);
-            if (asset == nullptr) {
-                fprintf(stderr, "error: failed to load asset: %s\n", child.c_str());
-                error = true;
-                return;
-            }
+    bool error = false;
+    for (size_t n = 0; n < paths.size(); n++) {
+        if (!directories[n]) {
+            continue;
+        }
 
-            children->push_back(std::move(asset));
+        if (!diagnostics[n].empty()) {
+            Diagnostics::Print("%s", diagnostics[n].c_str());
         }
-    });
+
+        if (assets[n] == nullptr) {
+            Diagnostics::Print("error: failed to load asset: %s\n", paths[n].c_str());
+            error = true;
+            continue;
+        }
+
+        children->push_back(std::move(assets[n]));
+    }
 
     return error;
 }
@@ -328,11 +536,24 @@ load(Filesystem const *filesystem)
     /*
      * Load the contents. This can succeed but not load anything.
      */
-    std::unique_ptr<plist::Dictionary> contentsDictionary;
-    if (!LoadContents(filesystem, _path, &contentsDictionary)) {
+    ext::optional<std::vector<uint8_t>> contents;
+    if (!LoadContents(filesystem, _path, &contents)) {
         return false;
     }
 
+    /*
+     * Streamed contents are parsed after loading children, without ever
+     * reading them into a dictionary.
+     */
+    bool streamable = this->streamable();
+
+    std::unique_ptr<plist::Dictionary> contentsDictionary;
+    if (contents && !streamable) {
+        if (!LoadContentsDictionary(*contents, &contentsDictionary)) {
+            return false;
+        }
+    }
+
     /*
      * Note that some asset types have a field `provides-namespace` that affects
      * how children are loaded, which won't be loaded until parsing. To avoid
@@ -354,6 +575,30 @@ load(Filesystem const *filesystem)
         /* A child failing to load is not an error for this asset. */
     }
 
+    if (contents && streamable) {
+        plist::Format::JSONReader reader(contents->data(), contents->size());
+
+        /*
+         * If the Contents.json file exists, it must be a dictionary.
+         */
+        if (reader.next() != plist::Format::JSONReader::Token::DictionaryStart) {
+            return false;
+        }
+
+        if (!this->stream(&reader)) {
+            return false;
+        }
+
+        /*
+         * Nothing can follow the dictionary.
+         */
+        if (reader.next() != plist::Format::JSONReader::Token::End) {
+            return false;
+        }
+
+        return true;
+    }
+
     /*
      * Parse the contents dictionary.
      */
@@ -8,11 +8,13 @@
  */
 
 #include <xcassets/Asset/BrandAssets.h>
+#include <xcassets/Diagnostics.h>
 #include <plist/Array.h>
 #include <plist/String.h>
 #include <plist/Keys/Unpack.h>
 
 using xcassets::Asset::BrandAssets;
+using xcassets::Diagnostics;
 
 bool BrandAssets::BrandAsset::
 parse(plist::Dictionary const *dict)
@@ -26,7 +28,7 @@ parse(plist::Dictionary const *dict)
     auto R = unpack.cast <plist::String> ("role");
 
     if (!unpack.complete(true)) {
-        fprintf(stderr, "%s", unpack.errorText().c_str());
+        Diagnostics::Print("%s", unpack.errorText().c_str());
     }
 
     if (I != nullptr) {
@@ -65,7 +67,7 @@ parse(plist::Dictionary const *dict, std::unordered_set<std::string> *seen, bool
     auto As = unpack.cast <plist::Array> ("assets");
 
     if (!unpack.complete(check)) {
-        fprintf(stderr, "%s", unpack.errorText().c_str());
+        Diagnostics::Print("%s", unpack.errorText().c_str());
     }
 
     if (As != nullptr) {
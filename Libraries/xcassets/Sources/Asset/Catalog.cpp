@@ -8,10 +8,12 @@
  */
 
 #include <xcassets/Asset/Catalog.h>
+#include <xcassets/Diagnostics.h>
 #include <plist/Keys/Unpack.h>
 #include <libutil/Filesystem.h>
 
 using xcassets::Asset::Catalog;
+using xcassets::Diagnostics;
 using libutil::Filesystem;
 
 bool Catalog::
@@ -28,7 +30,7 @@ parse(plist::Dictionary const *dict, std::unordered_set<std::string> *seen, bool
         /* No additional contents. */
 
         if (!unpack.complete(check)) {
-            fprintf(stderr, "%s", unpack.errorText().c_str());
+            Diagnostics::Print("%s", unpack.errorText().c_str());
         }
     }
 
@@ -36,9 +38,9 @@ parse(plist::Dictionary const *dict, std::unordered_set<std::string> *seen, bool
 }
 
 std::unique_ptr<Catalog> Catalog::
-Load(libutil::Filesystem const *filesystem, std::string const &path)
+Load(libutil::Filesystem const *filesystem, std::string const &path, ext::optional<size_t> jobs)
 {
-    auto asset = Asset::Load(filesystem, path, { }, Catalog::Extension());
+    auto asset = Asset::Load(filesystem, path, { }, Catalog::Extension(), jobs);
     return libutil::static_unique_pointer_cast<Catalog>(std::move(asset));
 }
 
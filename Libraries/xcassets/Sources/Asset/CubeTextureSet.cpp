@@ -8,12 +8,14 @@
  */
 
 #include <xcassets/Asset/CubeTextureSet.h>
+#include <xcassets/Diagnostics.h>
 #include <plist/Array.h>
 #include <plist/Dictionary.h>
 #include <plist/String.h>
 #include <plist/Keys/Unpack.h>
 
 using xcassets::Asset::CubeTextureSet;
+using xcassets::Diagnostics;
 
 bool CubeTextureSet::Texture::
 parse(plist::Dictionary const *dict)
@@ -31,7 +33,7 @@ parse(plist::Dictionary const *dict)
     auto S   = unpack.cast <plist::String> ("scale");
 
     if (!unpack.complete(true)) {
-        fprintf(stderr, "%s", unpack.errorText().c_str());
+        Diagnostics::Print("%s", unpack.errorText().c_str());
     }
 
     if (CS != nullptr) {
@@ -82,7 +84,7 @@ parse(plist::Dictionary const *dict, std::unordered_set<std::string> *seen, bool
     auto Ts = unpack.cast <plist::Array> ("textures");
 
     if (!unpack.complete(check)) {
-        fprintf(stderr, "%s", unpack.errorText().c_str());
+        Diagnostics::Print("%s", unpack.errorText().c_str());
     }
 
     if (P != nullptr) {
@@ -94,7 +96,7 @@ parse(plist::Dictionary const *dict, std::unordered_set<std::string> *seen, bool
         auto ODRT = unpack.cast <plist::Array> ("on-demand-resource-tags");
 
         if (!unpack.complete(true)) {
-            fprintf(stderr, "%s", unpack.errorText().c_str());
+            Diagnostics::Print("%s", unpack.errorText().c_str());
         }
 
         if (I != nullptr) {
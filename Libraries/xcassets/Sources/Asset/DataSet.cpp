@@ -8,11 +8,13 @@
  */
 
 #include <xcassets/Asset/DataSet.h>
+#include <xcassets/Diagnostics.h>
 #include <plist/Keys/Unpack.h>
 #include <plist/Array.h>
 #include <plist/String.h>
 
 using xcassets::Asset::DataSet;
+using xcassets::Diagnostics;
 
 bool DataSet::Data::
 parse(plist::Dictionary const *dict)
@@ -28,7 +30,7 @@ parse(plist::Dictionary const *dict)
     auto UTI = unpack.cast <plist::String> ("universal-type-identifier");
 
     if (!unpack.complete(true)) {
-        fprintf(stderr, "%s", unpack.errorText().c_str());
+        Diagnostics::Print("%s", unpack.errorText().c_str());
     }
 
     if (CS != nullptr) {
@@ -62,7 +64,7 @@ bool DataSet::
 parse(plist::Dictionary const *dict, std::unordered_set<std::string> *seen, bool check)
 {
     if (!this->children().empty()) {
-        fprintf(stderr, "warning: unexpected child assets\n");
+        Diagnostics::Print("warning: unexpected child assets\n");
     }
 
     if (!Asset::parse(dict, seen, false)) {
@@ -80,7 +82,7 @@ parse(plist::Dictionary const *dict, std::unordered_set<std::string> *seen, bool
     auto Ds = unpack.cast <plist::Array> ("data");
 
     if (!unpack.complete(check)) {
-        fprintf(stderr, "%s", unpack.errorText().c_str());
+        Diagnostics::Print("%s", unpack.errorText().c_str());
     }
 
     if (P != nullptr) {
@@ -90,7 +92,7 @@ parse(plist::Dictionary const *dict, std::unordered_set<std::string> *seen, bool
         auto ODRT = unpack.cast <plist::Array> ("on-demand-resource-tags");
 
         if (!unpack.complete(true)) {
-            fprintf(stderr, "%s", unpack.errorText().c_str());
+            Diagnostics::Print("%s", unpack.errorText().c_str());
         }
 
         if (ODRT != nullptr) {
@@ -8,9 +8,11 @@
  */
 
 #include <xcassets/Asset/GCDashboardImage.h>
+#include <xcassets/Diagnostics.h>
 #include <plist/Keys/Unpack.h>
 
 using xcassets::Asset::GCDashboardImage;
+using xcassets::Diagnostics;
 
 bool GCDashboardImage::
 parse(plist::Dictionary const *dict, std::unordered_set<std::string> *seen, bool check)
@@ -26,7 +28,7 @@ parse(plist::Dictionary const *dict, std::unordered_set<std::string> *seen, bool
         auto P = unpack.cast <plist::Dictionary> ("properties");
 
         if (!unpack.complete(check)) {
-            fprintf(stderr, "%s", unpack.errorText().c_str());
+            Diagnostics::Print("%s", unpack.errorText().c_str());
         }
 
         if (P != nullptr) {
@@ -36,7 +38,7 @@ parse(plist::Dictionary const *dict, std::unordered_set<std::string> *seen, bool
             auto CR = unpack.cast <plist::Dictionary> ("content-reference");
 
             if (!unpack.complete(true)) {
-                fprintf(stderr, "%s", unpack.errorText().c_str());
+                Diagnostics::Print("%s", unpack.errorText().c_str());
             }
 
             if (CR != nullptr) {
@@ -8,10 +8,12 @@
  */
 
 #include <xcassets/Asset/GCLeaderboardSet.h>
+#include <xcassets/Diagnostics.h>
 #include <plist/String.h>
 #include <plist/Keys/Unpack.h>
 
 using xcassets::Asset::GCLeaderboardSet;
+using xcassets::Diagnostics;
 
 bool GCLeaderboardSet::
 parse(plist::Dictionary const *dict, std::unordered_set<std::string> *seen, bool check)
@@ -27,7 +29,7 @@ parse(plist::Dictionary const *dict, std::unordered_set<std::string> *seen, bool
         auto P = unpack.cast <plist::Dictionary> ("properties");
 
         if (!unpack.complete(check)) {
-            fprintf(stderr, "%s", unpack.errorText().c_str());
+            Diagnostics::Print("%s", unpack.errorText().c_str());
         }
 
         if (P != nullptr) {
@@ -38,7 +40,7 @@ parse(plist::Dictionary const *dict, std::unordered_set<std::string> *seen, bool
             auto I  = unpack.cast <plist::String> ("identifier");
 
             if (!unpack.complete(true)) {
-                fprintf(stderr, "%s", unpack.errorText().c_str());
+                Diagnostics::Print("%s", unpack.errorText().c_str());
             }
 
             if (CR != nullptr) {
@@ -8,12 +8,14 @@
  */
 
 #include <xcassets/Asset/Group.h>
+#include <xcassets/Diagnostics.h>
 #include <plist/Keys/Unpack.h>
 #include <plist/Array.h>
 #include <plist/String.h>
 #include <plist/Boolean.h>
 
 using xcassets::Asset::Group;
+using xcassets::Diagnostics;
 
 bool Group::
 parse(plist::Dictionary const *dict, std::unordered_set<std::string> *seen, bool check)
@@ -29,7 +31,7 @@ parse(plist::Dictionary const *dict, std::unordered_set<std::string> *seen, bool
         auto P = unpack.cast <plist::Dictionary> ("properties");
 
         if (!unpack.complete(check)) {
-            fprintf(stderr, "%s", unpack.errorText().c_str());
+            Diagnostics::Print("%s", unpack.errorText().c_str());
         }
 
         if (P != nullptr) {
@@ -40,7 +42,7 @@ parse(plist::Dictionary const *dict, std::unordered_set<std::string> *seen, bool
             auto PN   = unpack.cast <plist::Boolean> ("provides-namespace");
 
             if (!unpack.complete(true)) {
-                fprintf(stderr, "%s", unpack.errorText().c_str());
+                Diagnostics::Print("%s", unpack.errorText().c_str());
             }
 
             if (ODRT != nullptr) {
@@ -8,11 +8,13 @@
  */
 
 #include <xcassets/Asset/IconSet.h>
+#include <xcassets/Diagnostics.h>
 #include <plist/Keys/Unpack.h>
 #include <libutil/Filesystem.h>
 #include <libutil/FSUtil.h>
 
 using xcassets::Asset::IconSet;
+using xcassets::Diagnostics;
 namespace Slot = xcassets::Slot;
 using libutil::Filesystem;
 using libutil::FSUtil;
@@ -30,7 +32,7 @@ ext::optional<IconSet::Icon> IconSet::Icon::
 Parse(std::string const &path)
 {
     if (FSUtil::GetFileExtension(path) != "png") {
-        fprintf(stderr, "warning: icon is not png\n");
+        Diagnostics::Print("warning: icon is not png\n");
         return ext::nullopt;
     }
 
@@ -38,18 +40,18 @@ Parse(std::string const &path)
 
     std::string::size_type underscore = name.find('_');
     if (underscore == std::string::npos) {
-        fprintf(stderr, "warning: malformed icon name\n");
+        Diagnostics::Print("warning: malformed icon name\n");
         return ext::nullopt;
     }
 
     if (name.substr(0, underscore) != "icon") {
-        fprintf(stderr, "warning: malformed icon name\n");
+        Diagnostics::Print("warning: malformed icon name\n");
         return ext::nullopt;
     }
 
     std::string::size_type x = name.find('x', underscore);
     if (x == std::string::npos) {
-        fprintf(stderr, "warning: malformed icon name\n");
+        Diagnostics::Print("warning: malformed icon name\n");
         return ext::nullopt;
     }
 
@@ -64,7 +66,7 @@ Parse(std::string const &path)
     char *wend = NULL;
     double width = ::strtod(w.c_str(), &wend);
     if (wend != &w[w.size()] || w.size() == 0) {
-        fprintf(stderr, "warning: width not a number %s\n", w.c_str());
+        Diagnostics::Print("warning: width not a number %s\n", w.c_str());
         return ext::nullopt;
     }
 
@@ -74,7 +76,7 @@ Parse(std::string const &path)
     char *hend = NULL;
     double height = ::strtod(h.c_str(), &hend);
     if (hend != &h[h.size()] || h.size() == 0) {
-        fprintf(stderr, "warning: height not a number %s\n", h.c_str());
+        Diagnostics::Print("warning: height not a number %s\n", h.c_str());
         return ext::nullopt;
     }
 
@@ -113,7 +115,7 @@ bool IconSet::
 parse(plist::Dictionary const *dict, std::unordered_set<std::string> *seen, bool check)
 {
     if (!this->children().empty()) {
-        fprintf(stderr, "warning: unexpected child assets\n");
+        Diagnostics::Print("warning: unexpected child assets\n");
     }
 
     if (!Asset::parse(dict, seen, false)) {
@@ -127,7 +129,7 @@ parse(plist::Dictionary const *dict, std::unordered_set<std::string> *seen, bool
         /* No properties. */
 
         if (!unpack.complete(check)) {
-            fprintf(stderr, "%s", unpack.errorText().c_str());
+            Diagnostics::Print("%s", unpack.errorText().c_str());
         }
     }
 
@@ -8,12 +8,18 @@
  */
 
 #include <xcassets/Asset/ImageSet.h>
+#include <xcassets/Diagnostics.h>
 #include <plist/Keys/Unpack.h>
 #include <plist/Array.h>
 #include <plist/Boolean.h>
 #include <plist/String.h>
+#include <plist/Format/JSONReader.h>
 
 using xcassets::Asset::ImageSet;
+using xcassets::Diagnostics;
+using plist::Format::JSONReader;
+using plist::ObjectType;
+using plist::ObjectTypes;
 
 bool ImageSet::Image::
 parse(plist::Dictionary const *dict)
@@ -37,7 +43,7 @@ parse(plist::Dictionary const *dict)
     auto R   = unpack.cast <plist::Dictionary> ("resizing");
 
     if (!unpack.complete(true)) {
-        fprintf(stderr, "%s", unpack.errorText().c_str());
+        Diagnostics::Print("%s", unpack.errorText().c_str());
     }
 
     if (CS != nullptr) {
@@ -109,7 +115,7 @@ bool ImageSet::
 parse(plist::Dictionary const *dict, std::unordered_set<std::string> *seen, bool check)
 {
     if (!this->children().empty()) {
-        fprintf(stderr, "warning: unexpected child assets\n");
+        Diagnostics::Print("warning: unexpected child assets\n");
     }
 
     if (!Asset::parse(dict, seen, false)) {
@@ -127,50 +133,269 @@ parse(plist::Dictionary const *dict, std::unordered_set<std::string> *seen, bool
     auto Is = unpack.cast <plist::Array> ("images");
 
     if (!unpack.complete(check)) {
-        fprintf(stderr, "%s", unpack.errorText().c_str());
+        Diagnostics::Print("%s", unpack.errorText().c_str());
     }
 
     if (P != nullptr) {
-        std::unordered_set<std::string> seen;
-        auto unpack = plist::Keys::Unpack("Properties", P, &seen);
+        parseProperties(P);
+    }
 
-        auto TRI  = unpack.cast <plist::String> ("template-rendering-intent");
-        auto ODRT = unpack.cast <plist::Array> ("on-demand-resource-tags");
+    if (Is != nullptr) {
+        _images = std::vector<Image>();
 
-        if (!unpack.complete(true)) {
-            fprintf(stderr, "%s", unpack.errorText().c_str());
+        for (size_t n = 0; n < Is->count(); ++n) {
+            if (auto dict = Is->value<plist::Dictionary>(n)) {
+                Image image;
+                if (image.parse(dict)) {
+                    _images->push_back(image);
+                }
+            }
         }
+    }
 
-        if (TRI != nullptr) {
-            _templateRenderingIntent = TemplateRenderingIntents::Parse(TRI->value());
+    return true;
+}
+
+void ImageSet::
+parseProperties(plist::Dictionary const *dict)
+{
+    std::unordered_set<std::string> seen;
+    auto unpack = plist::Keys::Unpack("Properties", dict, &seen);
+
+    auto TRI  = unpack.cast <plist::String> ("template-rendering-intent");
+    auto ODRT = unpack.cast <plist::Array> ("on-demand-resource-tags");
+
+    if (!unpack.complete(true)) {
+        Diagnostics::Print("%s", unpack.errorText().c_str());
+    }
+
+    if (TRI != nullptr) {
+        _templateRenderingIntent = TemplateRenderingIntents::Parse(TRI->value());
+    }
+
+    if (ODRT != nullptr) {
+        _onDemandResourceTags = std::vector<std::string>();
+        _onDemandResourceTags->reserve(ODRT->count());
+
+        for (size_t n = 0; n < ODRT->count(); n++) {
+            if (auto string = ODRT->value<plist::String>(n)) {
+                _onDemandResourceTags->push_back(string->value());
+            }
         }
+    }
+}
+
+/*
+ * Check the type of a streamed value, recording an error in the same way as
+ * `plist::Keys::Unpack` if it's not the expected type. Unexpected values are
+ * skipped; false if they couldn't be.
+ */
+static bool
+ImageSetStreamCheck(JSONReader *reader, std::string const &name, std::string const &key, ObjectType type, std::vector<std::string> *errors, bool *expected)
+{
+    *expected = (reader->type() == type);
+    if (*expected) {
+        return true;
+    }
+
+    errors->push_back(name + " key " + key + " was type " + ObjectTypes::Name(reader->type()) + "; expected " + ObjectTypes::Name(type));
+    return reader->skip();
+}
 
-        if (ODRT != nullptr) {
-            _onDemandResourceTags = std::vector<std::string>();
-            _onDemandResourceTags->reserve(ODRT->count());
+/*
+ * Skip a streamed value with a key that isn't handled.
+ */
+static bool
+ImageSetStreamUnhandled(JSONReader *reader, std::string const &name, std::string const &key, std::vector<std::string> *errors)
+{
+    errors->push_back("unhandled " + name + " key " + key);
+    return reader->skip();
+}
+
+static void
+ImageSetStreamErrors(std::vector<std::string> const &errors)
+{
+    for (std::string const &error : errors) {
+        Diagnostics::Print("warning: %s\n", error.c_str());
+    }
+}
+
+bool ImageSet::Image::
+stream(JSONReader *reader)
+{
+    std::vector<std::string> errors;
+
+    while (reader->next() == JSONReader::Token::Key) {
+        std::string key = reader->string();
+        reader->next();
+
+        bool valid = false;
+        bool expected = false;
+        if (key == "color-space") {
+            valid = ImageSetStreamCheck(reader, "ImageSetImage", key, ObjectType::String, &errors, &expected);
+            if (expected) {
+                _colorSpace = Slot::ColorSpaces::Parse(reader->string());
+            }
+        } else if (key == "compression-type") {
+            valid = ImageSetStreamCheck(reader, "ImageSetImage", key, ObjectType::String, &errors, &expected);
+            if (expected) {
+                _compression = Compressions::Parse(reader->string());
+            }
+        } else if (key == "filename") {
+            valid = ImageSetStreamCheck(reader, "ImageSetImage", key, ObjectType::String, &errors, &expected);
+            if (expected) {
+                _fileName = reader->string();
+            }
+        } else if (key == "graphics-feature-set") {
+            valid = ImageSetStreamCheck(reader, "ImageSetImage", key, ObjectType::String, &errors, &expected);
+            if (expected) {
+                _graphicsFeatureSet = Slot::GraphicsFeatureSets::Parse(reader->string());
+            }
+        } else if (key == "idiom") {
+            valid = ImageSetStreamCheck(reader, "ImageSetImage", key, ObjectType::String, &errors, &expected);
+            if (expected) {
+                _idiom = Slot::Idioms::Parse(reader->string());
+            }
+        } else if (key == "memory") {
+            valid = ImageSetStreamCheck(reader, "ImageSetImage", key, ObjectType::String, &errors, &expected);
+            if (expected) {
+                _memory = Slot::MemoryRequirements::Parse(reader->string());
+            }
+        } else if (key == "scale") {
+            valid = ImageSetStreamCheck(reader, "ImageSetImage", key, ObjectType::String, &errors, &expected);
+            if (expected) {
+                _scale = Slot::Scale::Parse(reader->string());
+            }
+        } else if (key == "subtype") {
+            valid = ImageSetStreamCheck(reader, "ImageSetImage", key, ObjectType::String, &errors, &expected);
+            if (expected) {
+                _subtype = Slot::DeviceSubtypes::Parse(reader->string());
+            }
+        } else if (key == "screen-width") {
+            valid = ImageSetStreamCheck(reader, "ImageSetImage", key, ObjectType::String, &errors, &expected);
+            if (expected) {
+                _screenWidth = Slot::WatchSubtypes::ParseScreenWidth(reader->string());
+            }
+        } else if (key == "width-class") {
+            valid = ImageSetStreamCheck(reader, "ImageSetImage", key, ObjectType::String, &errors, &expected);
+            if (expected) {
+                _widthClass = Slot::SizeClasses::Parse(reader->string());
+            }
+        } else if (key == "height-class") {
+            valid = ImageSetStreamCheck(reader, "ImageSetImage", key, ObjectType::String, &errors, &expected);
+            if (expected) {
+                _heightClass = Slot::SizeClasses::Parse(reader->string());
+            }
+        } else if (key == "unassigned") {
+            valid = ImageSetStreamCheck(reader, "ImageSetImage", key, ObjectType::Boolean, &errors, &expected);
+            if (expected) {
+                _unassigned = reader->boolean();
+            }
+        } else if (key == "alignment-insets" || key == "resizing") {
+            /* Rare and nested, so parsed as a dictionary. */
+            valid = ImageSetStreamCheck(reader, "ImageSetImage", key, ObjectType::Dictionary, &errors, &expected);
+            if (expected) {
+                std::unique_ptr<plist::Object> object = reader->object();
+                if (object == nullptr) {
+                    return false;
+                }
 
-            for (size_t n = 0; n < ODRT->count(); n++) {
-                if (auto string = ODRT->value<plist::String>(n)) {
-                    _onDemandResourceTags->push_back(string->value());
+                auto dict = static_cast<plist::Dictionary const *>(object.get());
+                if (key == "alignment-insets") {
+                    Insets alignmentInsets;
+                    if (alignmentInsets.parse(dict)) {
+                        _alignmentInsets = alignmentInsets;
+                    }
+                } else {
+                    Resizing resizing;
+                    if (resizing.parse(dict)) {
+                        _resizing = resizing;
+                    }
                 }
             }
+        } else {
+            valid = ImageSetStreamUnhandled(reader, "ImageSetImage", key, &errors);
+        }
+
+        if (!valid) {
+            return false;
         }
     }
 
-    if (Is != nullptr) {
-        _images = std::vector<Image>();
+    ImageSetStreamErrors(errors);
+    return (reader->token() == JSONReader::Token::DictionaryEnd);
+}
 
-        for (size_t n = 0; n < Is->count(); ++n) {
-            if (auto dict = Is->value<plist::Dictionary>(n)) {
-                Image image;
-                if (image.parse(dict)) {
-                    _images->push_back(image);
+bool ImageSet::
+stream(JSONReader *reader)
+{
+    if (!this->children().empty()) {
+        Diagnostics::Print("warning: unexpected child assets\n");
+    }
+
+    std::vector<std::string> errors;
+    std::unique_ptr<plist::Object> info;
+    std::unique_ptr<plist::Object> properties;
+
+    while (reader->next() == JSONReader::Token::Key) {
+        std::string key = reader->string();
+        reader->next();
+
+        bool valid = false;
+        bool expected = false;
+        if (key == "info") {
+            valid = ImageSetStreamCheck(reader, "Asset", key, ObjectType::Dictionary, &errors, &expected);
+            if (expected) {
+                info = reader->object();
+                valid = (info != nullptr);
+            }
+        } else if (key == "properties") {
+            valid = ImageSetStreamCheck(reader, "ImageSet", key, ObjectType::Dictionary, &errors, &expected);
+            if (expected) {
+                properties = reader->object();
+                valid = (properties != nullptr);
+            }
+        } else if (key == "images") {
+            valid = ImageSetStreamCheck(reader, "ImageSet", key, ObjectType::Array, &errors, &expected);
+            if (expected) {
+                _images = std::vector<Image>();
+
+                while (valid && reader->next() != JSONReader::Token::ArrayEnd) {
+                    if (reader->token() == JSONReader::Token::DictionaryStart) {
+                        Image image;
+                        valid = image.stream(reader);
+                        if (valid) {
+                            _images->push_back(image);
+                        }
+                    } else {
+                        valid = (reader->token() != JSONReader::Token::Error && reader->skip());
+                    }
                 }
             }
+        } else {
+            valid = ImageSetStreamUnhandled(reader, "ImageSet", key, &errors);
+        }
+
+        if (!valid) {
+            return false;
         }
     }
 
-    return true;
-}
+    if (reader->token() != JSONReader::Token::DictionaryEnd) {
+        return false;
+    }
+
+    ImageSetStreamErrors(errors);
+
+    if (info != nullptr) {
+        if (!parseInfo(static_cast<plist::Dictionary const *>(info.get()))) {
+            return false;
+        }
+    }
 
+    if (properties != nullptr) {
+        parseProperties(static_cast<plist::Dictionary const *>(properties.get()));
+    }
 
+    return true;
+}
@@ -8,11 +8,13 @@
  */
 
 #include <xcassets/Asset/ImageStack.h>
+#include <xcassets/Diagnostics.h>
 #include <plist/Array.h>
 #include <plist/String.h>
 #include <plist/Keys/Unpack.h>
 
 using xcassets::Asset::ImageStack;
+using xcassets::Diagnostics;
 
 bool ImageStack::Layer::
 parse(plist::Dictionary const *dict)
@@ -23,7 +25,7 @@ parse(plist::Dictionary const *dict)
     auto F = unpack.cast <plist::String> ("filename");
 
     if (!unpack.complete(true)) {
-        fprintf(stderr, "%s", unpack.errorText().c_str());
+        Diagnostics::Print("%s", unpack.errorText().c_str());
     }
 
     if (F != nullptr) {
@@ -51,7 +53,7 @@ parse(plist::Dictionary const *dict, std::unordered_set<std::string> *seen, bool
     auto Ls = unpack.cast <plist::Array> ("layers");
 
     if (!unpack.complete(check)) {
-        fprintf(stderr, "%s", unpack.errorText().c_str());
+        Diagnostics::Print("%s", unpack.errorText().c_str());
     }
 
     if (P != nullptr) {
@@ -62,7 +64,7 @@ parse(plist::Dictionary const *dict, std::unordered_set<std::string> *seen, bool
         // TODO: canvasSize
 
         if (!unpack.complete(true)) {
-            fprintf(stderr, "%s", unpack.errorText().c_str());
+            Diagnostics::Print("%s", unpack.errorText().c_str());
         }
 
         if (ODRT != nullptr) {
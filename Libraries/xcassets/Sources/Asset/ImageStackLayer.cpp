@@ -8,9 +8,11 @@
  */
 
 #include <xcassets/Asset/ImageStackLayer.h>
+#include <xcassets/Diagnostics.h>
 #include <plist/Keys/Unpack.h>
 
 using xcassets::Asset::ImageStackLayer;
+using xcassets::Diagnostics;
 
 bool ImageStackLayer::
 parse(plist::Dictionary const *dict, std::unordered_set<std::string> *seen, bool check)
@@ -29,7 +31,7 @@ parse(plist::Dictionary const *dict, std::unordered_set<std::string> *seen, bool
     auto P = unpack.cast <plist::Dictionary> ("properties");
 
     if (!unpack.complete(check)) {
-        fprintf(stderr, "%s", unpack.errorText().c_str());
+        Diagnostics::Print("%s", unpack.errorText().c_str());
     }
 
     if (P != nullptr) {
@@ -41,7 +43,7 @@ parse(plist::Dictionary const *dict, std::unordered_set<std::string> *seen, bool
         // TODO: frame-center
 
         if (!unpack.complete(true)) {
-            fprintf(stderr, "%s", unpack.errorText().c_str());
+            Diagnostics::Print("%s", unpack.errorText().c_str());
         }
 
         if (CR != nullptr) {
@@ -8,11 +8,13 @@
  */
 
 #include <xcassets/Asset/LaunchImage.h>
+#include <xcassets/Diagnostics.h>
 #include <plist/Keys/Unpack.h>
 #include <plist/Array.h>
 #include <plist/String.h>
 
 using xcassets::Asset::LaunchImage;
+using xcassets::Diagnostics;
 
 bool LaunchImage::Image::
 parse(plist::Dictionary const *dict)
@@ -29,7 +31,7 @@ parse(plist::Dictionary const *dict)
     auto E   = unpack.cast <plist::String> ("extent");
 
     if (!unpack.complete(true)) {
-        fprintf(stderr, "%s", unpack.errorText().c_str());
+        Diagnostics::Print("%s", unpack.errorText().c_str());
     }
 
     if (F != nullptr) {
@@ -67,7 +69,7 @@ bool LaunchImage::
 parse(plist::Dictionary const *dict, std::unordered_set<std::string> *seen, bool check)
 {
     if (!this->children().empty()) {
-        fprintf(stderr, "warning: unexpected child assets\n");
+        Diagnostics::Print("warning: unexpected child assets\n");
     }
 
     if (!Asset::parse(dict, seen, false)) {
@@ -84,7 +86,7 @@ parse(plist::Dictionary const *dict, std::unordered_set<std::string> *seen, bool
     auto Is = unpack.cast <plist::Array> ("images");
 
     if (!unpack.complete(check)) {
-        fprintf(stderr, "%s", unpack.errorText().c_str());
+        Diagnostics::Print("%s", unpack.errorText().c_str());
     }
 
     if (Is != nullptr) {
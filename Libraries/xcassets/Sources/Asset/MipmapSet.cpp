@@ -8,12 +8,14 @@
  */
 
 #include <xcassets/Asset/MipmapSet.h>
+#include <xcassets/Diagnostics.h>
 #include <plist/Keys/Unpack.h>
 #include <plist/Array.h>
 #include <plist/Boolean.h>
 #include <plist/String.h>
 
 using xcassets::Asset::MipmapSet;
+using xcassets::Diagnostics;
 
 bool MipmapSet::Level::
 parse(plist::Dictionary const *dict)
@@ -25,7 +27,7 @@ parse(plist::Dictionary const *dict)
     auto ML = unpack.cast <plist::String> ("mipmap-level");
 
     if (!unpack.complete(true)) {
-        fprintf(stderr, "%s", unpack.errorText().c_str());
+        Diagnostics::Print("%s", unpack.errorText().c_str());
     }
 
     if (F != nullptr) {
@@ -43,7 +45,7 @@ bool MipmapSet::
 parse(plist::Dictionary const *dict, std::unordered_set<std::string> *seen, bool check)
 {
     if (!this->children().empty()) {
-        fprintf(stderr, "warning: unexpected child assets\n");
+        Diagnostics::Print("warning: unexpected child assets\n");
     }
 
     if (!Asset::parse(dict, seen, false)) {
@@ -61,7 +63,7 @@ parse(plist::Dictionary const *dict, std::unordered_set<std::string> *seen, bool
     auto Ls = unpack.cast <plist::Array> ("levels");
 
     if (!unpack.complete(check)) {
-        fprintf(stderr, "%s", unpack.errorText().c_str());
+        Diagnostics::Print("%s", unpack.errorText().c_str());
     }
 
     if (P != nullptr) {
@@ -71,7 +73,7 @@ parse(plist::Dictionary const *dict, std::unordered_set<std::string> *seen, bool
         auto LM = unpack.cast <plist::String> ("level-mode");
 
         if (!unpack.complete(true)) {
-            fprintf(stderr, "%s", unpack.errorText().c_str());
+            Diagnostics::Print("%s", unpack.errorText().c_str());
         }
 
         if (LM != nullptr) {
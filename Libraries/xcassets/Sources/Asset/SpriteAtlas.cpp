@@ -9,6 +9,7 @@
 
 #include <xcassets/Asset/SpriteAtlas.h>
 #include <xcassets/Asset/ImageSet.h>
+#include <xcassets/Diagnostics.h>
 #include <plist/Keys/Unpack.h>
 #include <plist/Array.h>
 #include <plist/String.h>
@@ -16,6 +17,7 @@
 
 using xcassets::Asset::SpriteAtlas;
 using xcassets::Asset::ImageSet;
+using xcassets::Diagnostics;
 
 bool SpriteAtlas::
 parse(plist::Dictionary const *dict, std::unordered_set<std::string> *seen, bool check)
@@ -31,7 +33,7 @@ parse(plist::Dictionary const *dict, std::unordered_set<std::string> *seen, bool
         auto P = unpack.cast <plist::Dictionary> ("properties");
 
         if (!unpack.complete(check)) {
-            fprintf(stderr, "%s", unpack.errorText().c_str());
+            Diagnostics::Print("%s", unpack.errorText().c_str());
         }
 
         if (P != nullptr) {
@@ -43,7 +45,7 @@ parse(plist::Dictionary const *dict, std::unordered_set<std::string> *seen, bool
             auto PN   = unpack.cast <plist::Boolean> ("provides-namespace");
 
             if (!unpack.complete(true)) {
-                fprintf(stderr, "%s", unpack.errorText().c_str());
+                Diagnostics::Print("%s", unpack.errorText().c_str());
             }
 
             if (CT != nullptr) {
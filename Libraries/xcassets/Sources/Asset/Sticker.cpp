@@ -8,17 +8,19 @@
  */
 
 #include <xcassets/Asset/Sticker.h>
+#include <xcassets/Diagnostics.h>
 #include <plist/Keys/Unpack.h>
 #include <plist/Dictionary.h>
 #include <plist/String.h>
 
 using xcassets::Asset::Sticker;
+using xcassets::Diagnostics;
 
 bool Sticker::
 parse(plist::Dictionary const *dict, std::unordered_set<std::string> *seen, bool check)
 {
     if (!this->children().empty()) {
-        fprintf(stderr, "warning: unexpected child assets\n");
+        Diagnostics::Print("warning: unexpected child assets\n");
     }
 
     if (!Asset::parse(dict, seen, false)) {
@@ -35,7 +37,7 @@ parse(plist::Dictionary const *dict, std::unordered_set<std::string> *seen, bool
     auto P = unpack.cast <plist::Dictionary> ("properties");
 
     if (!unpack.complete(check)) {
-        fprintf(stderr, "%s", unpack.errorText().c_str());
+        Diagnostics::Print("%s", unpack.errorText().c_str());
     }
 
     if (P != nullptr) {
@@ -46,7 +48,7 @@ parse(plist::Dictionary const *dict, std::unordered_set<std::string> *seen, bool
         auto F  = unpack.cast <plist::String> ("filename");
 
         if (!unpack.complete(true)) {
-            fprintf(stderr, "%s", unpack.errorText().c_str());
+            Diagnostics::Print("%s", unpack.errorText().c_str());
         }
 
         if (AL != nullptr) {
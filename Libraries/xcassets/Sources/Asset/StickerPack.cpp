@@ -8,11 +8,13 @@
  */
 
 #include <xcassets/Asset/StickerPack.h>
+#include <xcassets/Diagnostics.h>
 #include <plist/Array.h>
 #include <plist/String.h>
 #include <plist/Keys/Unpack.h>
 
 using xcassets::Asset::StickerPack;
+using xcassets::Diagnostics;
 
 bool StickerPack::Sticker::
 parse(plist::Dictionary const *dict)
@@ -23,7 +25,7 @@ parse(plist::Dictionary const *dict)
     auto F = unpack.cast <plist::String> ("filename");
 
     if (!unpack.complete(true)) {
-        fprintf(stderr, "%s", unpack.errorText().c_str());
+        Diagnostics::Print("%s", unpack.errorText().c_str());
     }
 
     if (F != nullptr) {
@@ -51,7 +53,7 @@ parse(plist::Dictionary const *dict, std::unordered_set<std::string> *seen, bool
     auto Ss = unpack.cast <plist::Array> ("stickers");
 
     if (!unpack.complete(check)) {
-        fprintf(stderr, "%s", unpack.errorText().c_str());
+        Diagnostics::Print("%s", unpack.errorText().c_str());
     }
 
     if (P != nullptr) {
@@ -61,7 +63,7 @@ parse(plist::Dictionary const *dict, std::unordered_set<std::string> *seen, bool
         auto GS = unpack.cast <plist::String> ("grid-size");
 
         if (!unpack.complete(true)) {
-            fprintf(stderr, "%s", unpack.errorText().c_str());
+            Diagnostics::Print("%s", unpack.errorText().c_str());
         }
 
         if (GS != nullptr) {
@@ -8,12 +8,14 @@
  */
 
 #include <xcassets/Asset/StickerSequence.h>
+#include <xcassets/Diagnostics.h>
 #include <plist/Keys/Unpack.h>
 #include <plist/Array.h>
 #include <plist/Real.h>
 #include <plist/String.h>
 
 using xcassets::Asset::StickerSequence;
+using xcassets::Diagnostics;
 
 bool StickerSequence::Frame::
 parse(plist::Dictionary const *dict)
@@ -24,7 +26,7 @@ parse(plist::Dictionary const *dict)
     auto F = unpack.cast <plist::String> ("filename");
 
     if (!unpack.complete(true)) {
-        fprintf(stderr, "%s", unpack.errorText().c_str());
+        Diagnostics::Print("%s", unpack.errorText().c_str());
     }
 
     if (F != nullptr) {
@@ -38,7 +40,7 @@ bool StickerSequence::
 parse(plist::Dictionary const *dict, std::unordered_set<std::string> *seen, bool check)
 {
     if (!this->children().empty()) {
-        fprintf(stderr, "warning: unexpected child assets\n");
+        Diagnostics::Print("warning: unexpected child assets\n");
     }
 
     if (!Asset::parse(dict, seen, false)) {
@@ -56,7 +58,7 @@ parse(plist::Dictionary const *dict, std::unordered_set<std::string> *seen, bool
     auto Fs = unpack.cast <plist::Array> ("frames");
 
     if (!unpack.complete(check)) {
-        fprintf(stderr, "%s", unpack.errorText().c_str());
+        Diagnostics::Print("%s", unpack.errorText().c_str());
     }
 
     if (P != nullptr) {
@@ -69,7 +71,7 @@ parse(plist::Dictionary const *dict, std::unordered_set<std::string> *seen, bool
         auto R  = unpack.coerce <plist::Real> ("repetitions");
 
         if (!unpack.complete(true)) {
-            fprintf(stderr, "%s", unpack.errorText().c_str());
+            Diagnostics::Print("%s", unpack.errorText().c_str());
         }
 
         if (AL != nullptr) {
@@ -8,10 +8,12 @@
  */
 
 #include <xcassets/Asset/Stickers.h>
+#include <xcassets/Diagnostics.h>
 #include <plist/Keys/Unpack.h>
 #include <libutil/Filesystem.h>
 
 using xcassets::Asset::Stickers;
+using xcassets::Diagnostics;
 using libutil::Filesystem;
 
 bool Stickers::
@@ -28,7 +30,7 @@ parse(plist::Dictionary const *dict, std::unordered_set<std::string> *seen, bool
         /* No additional contents. */
 
         if (!unpack.complete(check)) {
-            fprintf(stderr, "%s", unpack.errorText().c_str());
+            Diagnostics::Print("%s", unpack.errorText().c_str());
         }
     }
 
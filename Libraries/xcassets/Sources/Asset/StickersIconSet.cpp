@@ -8,6 +8,7 @@
  */
 
 #include <xcassets/Asset/StickersIconSet.h>
+#include <xcassets/Diagnostics.h>
 #include <plist/Keys/Unpack.h>
 #include <plist/Array.h>
 #include <plist/Boolean.h>
@@ -15,6 +16,7 @@
 #include <plist/String.h>
 
 using xcassets::Asset::StickersIconSet;
+using xcassets::Diagnostics;
 using Platform = StickersIconSet::Platform;
 using Platforms = StickersIconSet::Platforms;
 
@@ -31,7 +33,7 @@ parse(plist::Dictionary const *dict)
     auto P  = unpack.cast <plist::String> ("platform");
 
     if (!unpack.complete(true)) {
-        fprintf(stderr, "%s", unpack.errorText().c_str());
+        Diagnostics::Print("%s", unpack.errorText().c_str());
     }
 
     if (FN != nullptr) {
@@ -61,7 +63,7 @@ bool StickersIconSet::
 parse(plist::Dictionary const *dict, std::unordered_set<std::string> *seen, bool check)
 {
     if (!this->children().empty()) {
-        fprintf(stderr, "warning: unexpected child assets\n");
+        Diagnostics::Print("warning: unexpected child assets\n");
     }
 
     if (!Asset::parse(dict, seen, false)) {
@@ -78,7 +80,7 @@ parse(plist::Dictionary const *dict, std::unordered_set<std::string> *seen, bool
     auto I = unpack.cast <plist::Array> ("images");
 
     if (!unpack.complete(check)) {
-        fprintf(stderr, "%s", unpack.errorText().c_str());
+        Diagnostics::Print("%s", unpack.errorText().c_str());
     }
 
     if (I != nullptr) {
@@ -109,7 +111,7 @@ Parse(std::string const &value)
     } else if (value == "watchos") {
         return Platform::watchOS;
     } else {
-        fprintf(stderr, "warning: unknown platform %s\n", value.c_str());
+        Diagnostics::Print("warning: unknown platform %s\n", value.c_str());
         return ext::nullopt;
     }
 }
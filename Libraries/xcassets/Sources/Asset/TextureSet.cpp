@@ -8,12 +8,14 @@
  */
 
 #include <xcassets/Asset/TextureSet.h>
+#include <xcassets/Diagnostics.h>
 #include <plist/Array.h>
 #include <plist/Dictionary.h>
 #include <plist/String.h>
 #include <plist/Keys/Unpack.h>
 
 using xcassets::Asset::TextureSet;
+using xcassets::Diagnostics;
 
 bool TextureSet::Texture::
 parse(plist::Dictionary const *dict)
@@ -30,7 +32,7 @@ parse(plist::Dictionary const *dict)
     auto S   = unpack.cast <plist::String> ("scale");
 
     if (!unpack.complete(true)) {
-        fprintf(stderr, "%s", unpack.errorText().c_str());
+        Diagnostics::Print("%s", unpack.errorText().c_str());
     }
 
     if (CS != nullptr) {
@@ -77,7 +79,7 @@ parse(plist::Dictionary const *dict, std::unordered_set<std::string> *seen, bool
     auto Ts = unpack.cast <plist::Array> ("textures");
 
     if (!unpack.complete(check)) {
-        fprintf(stderr, "%s", unpack.errorText().c_str());
+        Diagnostics::Print("%s", unpack.errorText().c_str());
     }
 
     if (P != nullptr) {
@@ -89,7 +91,7 @@ parse(plist::Dictionary const *dict, std::unordered_set<std::string> *seen, bool
         auto ODRT = unpack.cast <plist::Array> ("on-demand-resource-tags");
 
         if (!unpack.complete(true)) {
-            fprintf(stderr, "%s", unpack.errorText().c_str());
+            Diagnostics::Print("%s", unpack.errorText().c_str());
         }
 
         if (I != nullptr) {
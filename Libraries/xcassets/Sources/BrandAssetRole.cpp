@@ -8,11 +8,13 @@
  */
 
 #include <xcassets/BrandAssetRole.h>
+#include <xcassets/Diagnostics.h>
 
 #include <cstdlib>
 
 using xcassets::BrandAssetRole;
 using xcassets::BrandAssetRoles;
+using xcassets::Diagnostics;
 
 ext::optional<BrandAssetRole> BrandAssetRoles::
 Parse(std::string const &value)
@@ -24,7 +26,7 @@ Parse(std::string const &value)
     } else if (value == "top-shelf-image-wide") {
         return BrandAssetRole::TopShelfImageWide;
     } else {
-        fprintf(stderr, "warning: unknown brand asset role %s\n", value.c_str());
+        Diagnostics::Print("warning: unknown brand asset role %s\n", value.c_str());
         return ext::nullopt;
     }
 }
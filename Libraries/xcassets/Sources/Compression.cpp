@@ -8,11 +8,13 @@
  */
 
 #include <xcassets/Compression.h>
+#include <xcassets/Diagnostics.h>
 
 #include <cstdlib>
 
 using xcassets::Compression;
 using xcassets::Compressions;
+using xcassets::Diagnostics;
 
 ext::optional<Compression> Compressions::
 Parse(std::string const &value)
@@ -28,7 +30,7 @@ Parse(std::string const &value)
     } else if (value == "gpu-optimized-smallest") {
         return Compression::GPUOptimizedSmallest;
     } else {
-        fprintf(stderr, "warning: unknown compression %s\n", value.c_str());
+        Diagnostics::Print("warning: unknown compression %s\n", value.c_str());
         return ext::nullopt;
     }
 }
@@ -8,10 +8,12 @@
  */
 
 #include <xcassets/ContentReference.h>
+#include <xcassets/Diagnostics.h>
 #include <plist/Keys/Unpack.h>
 #include <plist/String.h>
 
 using xcassets::ContentReference;
+using xcassets::Diagnostics;
 
 bool ContentReference::
 parse(plist::Dictionary const *dict)
@@ -24,7 +26,7 @@ parse(plist::Dictionary const *dict)
     auto MS = unpack.coerce <plist::String> ("matching-style");
 
     if (!unpack.complete(true)) {
-        fprintf(stderr, "%s", unpack.errorText().c_str());
+        Diagnostics::Print("%s", unpack.errorText().c_str());
     }
 
     if (T != nullptr) {
@@ -8,11 +8,13 @@
  */
 
 #include <xcassets/CubeFace.h>
+#include <xcassets/Diagnostics.h>
 
 #include <cstdlib>
 
 using xcassets::CubeFace;
 using xcassets::CubeFaces;
+using xcassets::Diagnostics;
 
 ext::optional<CubeFace> CubeFaces::
 Parse(std::string const &value)
@@ -30,7 +32,7 @@ Parse(std::string const &value)
     } else if (value == "z+") {
         return CubeFace::PositiveZ;
     } else {
-        fprintf(stderr, "warning: unknown cube face %s\n", value.c_str());
+        Diagnostics::Print("warning: unknown cube face %s\n", value.c_str());
         return ext::nullopt;
     }
 }
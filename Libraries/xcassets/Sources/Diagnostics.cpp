@@ -0,0 +1,56 @@
+/**
+ Copyright (c) 2015-present, Facebook, Inc.
+ All rights reserved.
+
+ This source code is licensed under the BSD-style license found in the
+ LICENSE file in the root directory of this source tree. An additional grant
+ of patent rights can be found in the PATENTS file in the same directory.
+ */
+
+#include <xcassets/Diagnostics.h>
+
+#include <cstdarg>
+#include <cstdio>
+#include <vector>
+
+using xcassets::Diagnostics;
+
+static thread_local std::string *DiagnosticsOutput = nullptr;
+
+Diagnostics::Collect::
+Collect(std::string *output) :
+    _output  (output),
+    _previous(DiagnosticsOutput)
+{
+    DiagnosticsOutput = _output;
+}
+
+Diagnostics::Collect::
+~Collect()
+{
+    DiagnosticsOutput = _previous;
+}
+
+void Diagnostics::
+Print(char const *format, ...)
+{
+    va_list args;
+    va_start(args, format);
+
+    if (std::string *output = DiagnosticsOutput) {
+        va_list size;
+        va_copy(size, args);
+        int length = vsnprintf(nullptr, 0, format, size);
+        va_end(size);
+
+        if (length > 0) {
+            std::vector<char> buffer = std::vector<char>(length + 1);
+            vsnprintf(buffer.data(), buffer.size(), format, args);
+            output->append(buffer.data(), length);
+        }
+    } else {
+        vfprintf(stderr, format, args);
+    }
+
+    va_end(args);
+}
@@ -8,10 +8,12 @@
  */
 
 #include <xcassets/Insets.h>
+#include <xcassets/Diagnostics.h>
 #include <plist/Keys/Unpack.h>
 #include <plist/Real.h>
 
 using xcassets::Insets;
+using xcassets::Diagnostics;
 
 bool Insets::
 parse(plist::Dictionary const *dict)
@@ -25,7 +27,7 @@ parse(plist::Dictionary const *dict)
     auto R = unpack.coerce <plist::Real> ("right");
 
     if (!unpack.complete(true)) {
-        fprintf(stderr, "%s", unpack.errorText().c_str());
+        Diagnostics::Print("%s", unpack.errorText().c_str());
     }
 
     if (T != nullptr) {
@@ -8,11 +8,13 @@
  */
 
 #include <xcassets/MatchingStyle.h>
+#include <xcassets/Diagnostics.h>
 
 #include <cstdlib>
 
 using xcassets::MatchingStyle;
 using xcassets::MatchingStyles;
+using xcassets::Diagnostics;
 
 ext::optional<MatchingStyle> MatchingStyles::
 Parse(std::string const &value)
@@ -20,7 +22,7 @@ Parse(std::string const &value)
     if (value == "fully-qualified-name") {
         return MatchingStyle::FullyQualifiedName;
     } else {
-        fprintf(stderr, "warning: unknown matching style %s\n", value.c_str());
+        Diagnostics::Print("warning: unknown matching style %s\n", value.c_str());
         return ext::nullopt;
     }
 }
@@ -8,11 +8,13 @@
  */
 
 #include <xcassets/MipmapLevel.h>
+#include <xcassets/Diagnostics.h>
 
 #include <cstdlib>
 
 using xcassets::MipmapLevel;
 using xcassets::MipmapLevels;
+using xcassets::Diagnostics;
 
 ext::optional<MipmapLevel> MipmapLevels::
 Parse(std::string const &value)
@@ -52,7 +54,7 @@ Parse(std::string const &value)
     } else if (value == "mipmap-level-16") {
         return MipmapLevel::Level16;
     } else {
-        fprintf(stderr, "warning: unknown mipmap level mode %s\n", value.c_str());
+        Diagnostics::Print("warning: unknown mipmap level mode %s\n", value.c_str());
         return ext::nullopt;
     }
 }
@@ -8,11 +8,13 @@
  */
 
 #include <xcassets/MipmapLevelMode.h>
+#include <xcassets/Diagnostics.h>
 
 #include <cstdlib>
 
 using xcassets::MipmapLevelMode;
 using xcassets::MipmapLevelModes;
+using xcassets::Diagnostics;
 
 ext::optional<MipmapLevelMode> MipmapLevelModes::
 Parse(std::string const &value)
@@ -24,7 +26,7 @@ Parse(std::string const &value)
     } else if (value == "fixed") {
         return MipmapLevelMode::Fixed;
     } else {
-        fprintf(stderr, "warning: unknown mipmap level mode %s\n", value.c_str());
+        Diagnostics::Print("warning: unknown mipmap level mode %s\n", value.c_str());
         return ext::nullopt;
     }
 }
@@ -8,11 +8,13 @@
  */
 
 #include <xcassets/Resizing.h>
+#include <xcassets/Diagnostics.h>
 #include <plist/Keys/Unpack.h>
 #include <plist/Real.h>
 #include <plist/String.h>
 
 using xcassets::Resizing;
+using xcassets::Diagnostics;
 
 bool Resizing::Center::
 parse(plist::Dictionary const *dict)
@@ -25,7 +27,7 @@ parse(plist::Dictionary const *dict)
     auto H = unpack.coerce <plist::Real> ("height");
 
     if (!unpack.complete(true)) {
-        fprintf(stderr, "%s", unpack.errorText().c_str());
+        Diagnostics::Print("%s", unpack.errorText().c_str());
     }
 
     if (M != nullptr) {
@@ -34,7 +36,7 @@ parse(plist::Dictionary const *dict)
         } else if (M->value() == "stretch") {
             _mode = Resizing::Center::Mode::Stretch;
         } else {
-            fprintf(stderr, "warning: unknown center mode %s\n", M->value().c_str());
+            Diagnostics::Print("warning: unknown center mode %s\n", M->value().c_str());
         }
     }
 
@@ -60,7 +62,7 @@ parse(plist::Dictionary const *dict)
     auto CI = unpack.cast <plist::Dictionary> ("cap-insets");
 
     if (!unpack.complete(true)) {
-        fprintf(stderr, "%s", unpack.errorText().c_str());
+        Diagnostics::Print("%s", unpack.errorText().c_str());
     }
 
     if (M != nullptr) {
@@ -71,7 +73,7 @@ parse(plist::Dictionary const *dict)
         } else if (M->value() == "9-part") {
             _mode = Resizing::Mode::NinePart;
         } else {
-            fprintf(stderr, "warning: unknown resizing mode %s\n", M->value().c_str());
+            Diagnostics::Print("warning: unknown resizing mode %s\n", M->value().c_str());
         }
     }
 
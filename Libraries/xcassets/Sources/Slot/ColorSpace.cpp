@@ -8,11 +8,13 @@
  */
 
 #include <xcassets/Slot/ColorSpace.h>
+#include <xcassets/Diagnostics.h>
 
 #include <cstdlib>
 
 using xcassets::Slot::ColorSpace;
 using xcassets::Slot::ColorSpaces;
+using xcassets::Diagnostics;
 
 ext::optional<ColorSpace> ColorSpaces::
 Parse(std::string const &value)
@@ -22,7 +24,7 @@ Parse(std::string const &value)
     } else if (value == "display-P3") {
         return ColorSpace::DisplayP3;
     } else {
-        fprintf(stderr, "warning: unknown platform %s\n", value.c_str());
+        Diagnostics::Print("warning: unknown platform %s\n", value.c_str());
         return ext::nullopt;
     }
 }
@@ -8,11 +8,13 @@
  */
 
 #include <xcassets/Slot/DeviceSubtype.h>
+#include <xcassets/Diagnostics.h>
 
 #include <cstdlib>
 
 using xcassets::Slot::DeviceSubtype;
 using xcassets::Slot::DeviceSubtypes;
+using xcassets::Diagnostics;
 
 ext::optional<DeviceSubtype> DeviceSubtypes::
 Parse(std::string const &value)
@@ -24,7 +26,7 @@ Parse(std::string const &value)
     } else if (value == "736h") {
         return DeviceSubtype::Height736;
     } else {
-        fprintf(stderr, "warning: unknown device subtype '%s'\n", value.c_str());
+        Diagnostics::Print("warning: unknown device subtype '%s'\n", value.c_str());
         return ext::nullopt;
     }
 }
@@ -8,11 +8,13 @@
  */
 
 #include <xcassets/Slot/GraphicsFeatureSet.h>
+#include <xcassets/Diagnostics.h>
 
 #include <cstdlib>
 
 using xcassets::Slot::GraphicsFeatureSet;
 using xcassets::Slot::GraphicsFeatureSets;
+using xcassets::Diagnostics;
 
 ext::optional<GraphicsFeatureSet> GraphicsFeatureSets::
 Parse(std::string const &value)
@@ -28,7 +30,7 @@ Parse(std::string const &value)
     } else if (value == "metal3v1") {
         return GraphicsFeatureSet::MetalFamily3Version1;
     } else {
-        fprintf(stderr, "warning: unknown graphics feature set %s\n", value.c_str());
+        Diagnostics::Print("warning: unknown graphics feature set %s\n", value.c_str());
         return ext::nullopt;
     }
 }
@@ -8,11 +8,13 @@
  */
 
 #include <xcassets/Slot/Idiom.h>
+#include <xcassets/Diagnostics.h>
 
 #include <cstdlib>
 
 using xcassets::Slot::Idiom;
 using xcassets::Slot::Idioms;
+using xcassets::Diagnostics;
 
 ext::optional<Idiom> Idioms::
 Parse(std::string const &value)
@@ -34,7 +36,7 @@ Parse(std::string const &value)
     } else if (value == "ios-marketing") {
         return Idiom::iOSMarketing;
     } else {
-        fprintf(stderr, "warning: unknown idiom %s\n", value.c_str());
+        Diagnostics::Print("warning: unknown idiom %s\n", value.c_str());
         return ext::nullopt;
     }
 }
@@ -8,10 +8,12 @@
  */
 
 #include <xcassets/Slot/ImageSize.h>
+#include <xcassets/Diagnostics.h>
 
 #include <sstream>
 
 using xcassets::Slot::ImageSize;
+using xcassets::Diagnostics;
 
 ImageSize::
 ImageSize(double width, double height) :
@@ -25,14 +27,14 @@ Parse(std::string const &value)
 {
     /* Must not be empty */
     if (value.empty()) {
-        fprintf(stderr, "warning: size not valid %s\n", value.c_str());
+        Diagnostics::Print("warning: size not valid %s\n", value.c_str());
         return ext::nullopt;
     }
 
     std::string::size_type x = value.find('x');
     if (x == std::string::npos || x == 0 || x == value.size() - 1) {
         /* Must contain two strings separated by 'x' */
-        fprintf(stderr, "warning: size not valid %s\n", value.c_str());
+        Diagnostics::Print("warning: size not valid %s\n", value.c_str());
         return ext::nullopt;
     }
 
@@ -42,14 +44,14 @@ Parse(std::string const &value)
     char *wend = NULL;
     double width = std::strtod(w.c_str(), &wend);
     if (wend != &w[w.size()]) {
-        fprintf(stderr, "warning: width not valid %s\n", w.c_str());
+        Diagnostics::Print("warning: width not valid %s\n", w.c_str());
         return ext::nullopt;
     }
 
     char *hend = NULL;
     double height = std::strtod(h.c_str(), &hend);
     if (hend != &h[h.size()]) {
-        fprintf(stderr, "warning: height not valid %s\n", h.c_str());
+        Diagnostics::Print("warning: height not valid %s\n", h.c_str());
         return ext::nullopt;
     }
 
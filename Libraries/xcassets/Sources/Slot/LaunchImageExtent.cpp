@@ -8,11 +8,13 @@
  */
 
 #include <xcassets/Slot/LaunchImageExtent.h>
+#include <xcassets/Diagnostics.h>
 
 #include <cstdlib>
 
 using xcassets::Slot::LaunchImageExtent;
 using xcassets::Slot::LaunchImageExtents;
+using xcassets::Diagnostics;
 
 ext::optional<LaunchImageExtent> LaunchImageExtents::
 Parse(std::string const &value)
@@ -22,7 +24,7 @@ Parse(std::string const &value)
     } else if (value == "full-screen") {
         return LaunchImageExtent::FullScreen;
     } else {
-        fprintf(stderr, "warning: unknown extent '%s'\n", value.c_str());
+        Diagnostics::Print("warning: unknown extent '%s'\n", value.c_str());
         return ext::nullopt;
     }
 }
@@ -8,11 +8,13 @@
  */
 
 #include <xcassets/Slot/MemoryRequirement.h>
+#include <xcassets/Diagnostics.h>
 
 #include <cstdlib>
 
 using xcassets::Slot::MemoryRequirement;
 using xcassets::Slot::MemoryRequirements;
+using xcassets::Diagnostics;
 
 ext::optional<MemoryRequirement> MemoryRequirements::
 Parse(std::string const &value)
@@ -24,7 +26,7 @@ Parse(std::string const &value)
     } else if (value == "4GB") {
         return MemoryRequirement::Minimum4GB;
     } else {
-        fprintf(stderr, "warning: unknown memory requirement %s\n", value.c_str());
+        Diagnostics::Print("warning: unknown memory requirement %s\n", value.c_str());
         return ext::nullopt;
     }
 }
@@ -8,11 +8,13 @@
  */
 
 #include <xcassets/Slot/Orientation.h>
+#include <xcassets/Diagnostics.h>
 
 #include <cstdlib>
 
 using xcassets::Slot::Orientation;
 using xcassets::Slot::Orientations;
+using xcassets::Diagnostics;
 
 ext::optional<Orientation> Orientations::
 Parse(std::string const &value)
@@ -22,7 +24,7 @@ Parse(std::string const &value)
     } else if (value == "landscape") {
         return Orientation::Landscape;
     } else {
-        fprintf(stderr, "warning: unknown orientation %s\n", value.c_str());
+        Diagnostics::Print("warning: unknown orientation %s\n", value.c_str());
         return ext::nullopt;
     }
 }
@@ -8,10 +8,12 @@
  */
 
 #include <xcassets/Slot/Scale.h>
+#include <xcassets/Diagnostics.h>
 
 #include <sstream>
 
 using xcassets::Slot::Scale;
+using xcassets::Diagnostics;
 
 Scale::
 Scale(double value) :
@@ -24,7 +26,7 @@ Parse(std::string const &value)
 {
     /* Must end in 'x'. */
     if (value.empty() || value[value.size() - 1] != 'x') {
-        fprintf(stderr, "warning: scale not valid %s\n", value.c_str());
+        Diagnostics::Print("warning: scale not valid %s\n", value.c_str());
         return ext::nullopt;
     }
 
@@ -36,7 +38,7 @@ Parse(std::string const &value)
     if (end == &number[number.size()]) {
         return Scale(scale);
     } else {
-        fprintf(stderr, "warning: scale not a number %s\n", value.c_str());
+        Diagnostics::Print("warning: scale not a number %s\n", value.c_str());
         return ext::nullopt;
     }
 }
@@ -8,11 +8,13 @@
  */
 
 #include <xcassets/Slot/SizeClass.h>
+#include <xcassets/Diagnostics.h>
 
 #include <cstdlib>
 
 using xcassets::Slot::SizeClass;
 using xcassets::Slot::SizeClasses;
+using xcassets::Diagnostics;
 
 ext::optional<SizeClass> SizeClasses::
 Parse(std::string const &value)
@@ -22,7 +24,7 @@ Parse(std::string const &value)
     } else if (value == "regular") {
         return SizeClass::Regular;
     } else {
-        fprintf(stderr, "warning: unknown size class %s\n", value.c_str());
+        Diagnostics::Print("warning: unknown size class %s\n", value.c_str());
         return ext::nullopt;
     }
 }
@@ -8,10 +8,12 @@
  */
 
 #include <xcassets/Slot/SystemVersion.h>
+#include <xcassets/Diagnostics.h>
 
 #include <sstream>
 
 using xcassets::Slot::SystemVersion;
+using xcassets::Diagnostics;
 
 SystemVersion::
 SystemVersion(int major, int minor, ext::optional<int> const &patch) :
@@ -26,14 +28,14 @@ Parse(std::string const &value)
 {
     /* Must not be empty */
     if (value.empty()) {
-        fprintf(stderr, "warning: system version not valid %s\n", value.c_str());
+        Diagnostics::Print("warning: system version not valid %s\n", value.c_str());
         return ext::nullopt;
     }
 
     std::string::size_type dot = value.find('.');
     if (dot == std::string::npos || dot == 0 || dot == value.size() - 1) {
         /* Must contain at least one dot. */
-        fprintf(stderr, "warning: system version not valid %s\n", value.c_str());
+        Diagnostics::Print("warning: system version not valid %s\n", value.c_str());
         return ext::nullopt;
     }
 
@@ -44,14 +46,14 @@ Parse(std::string const &value)
     char *mend = NULL;
     int major = std::strtol(m.c_str(), &mend, 0);
     if (mend != &m[m.size()]) {
-        fprintf(stderr, "warning: major version not valid %s\n", m.c_str());
+        Diagnostics::Print("warning: major version not valid %s\n", m.c_str());
         return ext::nullopt;
     }
 
     dot = rest.find('.');
     if (dot == 0 || dot == rest.size() - 1) {
         /* Cannot be empty or end with a dot. */
-        fprintf(stderr, "warning: system version not valid %s\n", value.c_str());
+        Diagnostics::Print("warning: system version not valid %s\n", value.c_str());
         return ext::nullopt;
     }
 
@@ -61,7 +63,7 @@ Parse(std::string const &value)
     char *nend = NULL;
     int minor = std::strtol(n.c_str(), &nend, 0);
     if (nend != &n[n.size()]) {
-        fprintf(stderr, "warning: minor version not valid %s\n", n.c_str());
+        Diagnostics::Print("warning: minor version not valid %s\n", n.c_str());
         return ext::nullopt;
     }
 
@@ -73,7 +75,7 @@ Parse(std::string const &value)
         char *pend = NULL;
         patch = std::strtol(p.c_str(), &pend, 0);
         if (pend != &p[p.size()]) {
-            fprintf(stderr, "warning: patch version not valid %s\n", p.c_str());
+            Diagnostics::Print("warning: patch version not valid %s\n", p.c_str());
             return ext::nullopt;
         }
     }
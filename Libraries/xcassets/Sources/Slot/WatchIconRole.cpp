@@ -8,11 +8,13 @@
  */
 
 #include <xcassets/Slot/WatchIconRole.h>
+#include <xcassets/Diagnostics.h>
 
 #include <cstdlib>
 
 using xcassets::Slot::WatchIconRole;
 using xcassets::Slot::WatchIconRoles;
+using xcassets::Diagnostics;
 
 ext::optional<WatchIconRole> WatchIconRoles::
 Parse(std::string const &value)
@@ -28,7 +30,7 @@ Parse(std::string const &value)
     } else if (value == "quickLook") {
         return WatchIconRole::ShortLookNotification;
     } else {
-        fprintf(stderr, "warning: unknown watch icon role %s\n", value.c_str());
+        Diagnostics::Print("warning: unknown watch icon role %s\n", value.c_str());
         return ext::nullopt;
     }
 }
@@ -8,11 +8,13 @@
  */
 
 #include <xcassets/Slot/WatchSubtype.h>
+#include <xcassets/Diagnostics.h>
 
 #include <cstdlib>
 
 using xcassets::Slot::WatchSubtype;
 using xcassets::Slot::WatchSubtypes;
+using xcassets::Diagnostics;
 
 ext::optional<WatchSubtype> WatchSubtypes::
 ParsePhysicalSize(std::string const &value)
@@ -22,7 +24,7 @@ ParsePhysicalSize(std::string const &value)
     } else if (value == "42mm") {
         return WatchSubtype::Large;
     } else {
-        fprintf(stderr, "warning: unknown watch physical size %s\n", value.c_str());
+        Diagnostics::Print("warning: unknown watch physical size %s\n", value.c_str());
         return ext::nullopt;
     }
 }
@@ -48,7 +50,7 @@ ParseScreenWidth(std::string const &value)
     } else if (value == ">145") {
         return WatchSubtype::Large;
     } else {
-        fprintf(stderr, "warning: unknown watch screen width %s\n", value.c_str());
+        Diagnostics::Print("warning: unknown watch screen width %s\n", value.c_str());
         return ext::nullopt;
     }
 }
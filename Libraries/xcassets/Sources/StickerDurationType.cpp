@@ -8,11 +8,13 @@
  */
 
 #include <xcassets/StickerDurationType.h>
+#include <xcassets/Diagnostics.h>
 
 #include <cstdlib>
 
 using xcassets::StickerDurationType;
 using xcassets::StickerDurationTypes;
+using xcassets::Diagnostics;
 
 ext::optional<StickerDurationType> StickerDurationTypes::
 Parse(std::string const &value)
@@ -22,7 +24,7 @@ Parse(std::string const &value)
     } else if (value == "fps") {
         return StickerDurationType::FPS;
     } else {
-        fprintf(stderr, "warning: unknown sticker duration type %s\n", value.c_str());
+        Diagnostics::Print("warning: unknown sticker duration type %s\n", value.c_str());
         return ext::nullopt;
     }
 }
@@ -8,11 +8,13 @@
  */
 
 #include <xcassets/StickerGridSize.h>
+#include <xcassets/Diagnostics.h>
 
 #include <cstdlib>
 
 using xcassets::StickerGridSize;
 using xcassets::StickerGridSizes;
+using xcassets::Diagnostics;
 
 ext::optional<StickerGridSize> StickerGridSizes::
 Parse(std::string const &value)
@@ -24,7 +26,7 @@ Parse(std::string const &value)
     } else if (value == "large") {
         return StickerGridSize::Large;
     } else {
-        fprintf(stderr, "warning: unknown sticker grid size %s\n", value.c_str());
+        Diagnostics::Print("warning: unknown sticker grid size %s\n", value.c_str());
         return ext::nullopt;
     }
 }
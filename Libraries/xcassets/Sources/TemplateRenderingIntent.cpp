@@ -8,11 +8,13 @@
  */
 
 #include <xcassets/TemplateRenderingIntent.h>
+#include <xcassets/Diagnostics.h>
 
 #include <cstdlib>
 
 using xcassets::TemplateRenderingIntent;
 using xcassets::TemplateRenderingIntents;
+using xcassets::Diagnostics;
 
 ext::optional<TemplateRenderingIntent> TemplateRenderingIntents::
 Parse(std::string const &value)
@@ -22,7 +24,7 @@ Parse(std::string const &value)
     } else if (value == "template") {
         return TemplateRenderingIntent::Template;
     } else {
-        fprintf(stderr, "warning: unknown template rendering intent %s\n", value.c_str());
+        Diagnostics::Print("warning: unknown template rendering intent %s\n", value.c_str());
         return ext::nullopt;
     }
 }
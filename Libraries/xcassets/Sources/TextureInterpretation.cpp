@@ -8,11 +8,13 @@
  */
 
 #include <xcassets/TextureInterpretation.h>
+#include <xcassets/Diagnostics.h>
 
 #include <cstdlib>
 
 using xcassets::TextureInterpretation;
 using xcassets::TextureInterpretations;
+using xcassets::Diagnostics;
 
 ext::optional<TextureInterpretation> TextureInterpretations::
 Parse(std::string const &value)
@@ -22,7 +24,7 @@ Parse(std::string const &value)
     } else if (value == "data") {
         return TextureInterpretation::Data;
     } else {
-        fprintf(stderr, "warning: unknown texture interpretation %s\n", value.c_str());
+        Diagnostics::Print("warning: unknown texture interpretation %s\n", value.c_str());
         return ext::nullopt;
     }
 }
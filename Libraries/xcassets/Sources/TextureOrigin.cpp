@@ -8,11 +8,13 @@
  */
 
 #include <xcassets/TextureOrigin.h>
+#include <xcassets/Diagnostics.h>
 
 #include <cstdlib>
 
 using xcassets::TextureOrigin;
 using xcassets::TextureOrigins;
+using xcassets::Diagnostics;
 
 ext::optional<TextureOrigin> TextureOrigins::
 Parse(std::string const &value)
@@ -20,7 +22,7 @@ Parse(std::string const &value)
     if (value == "bottom-left") {
         return TextureOrigin::BottomLeft;
     } else {
-        fprintf(stderr, "warning: unknown texture origin %s\n", value.c_str());
+        Diagnostics::Print("warning: unknown texture origin %s\n", value.c_str());
         return ext::nullopt;
     }
 }
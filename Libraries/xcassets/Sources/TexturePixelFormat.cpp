@@ -8,11 +8,13 @@
  */
 
 #include <xcassets/TexturePixelFormat.h>
+#include <xcassets/Diagnostics.h>
 
 #include <cstdlib>
 
 using xcassets::TexturePixelFormat;
 using xcassets::TexturePixelFormats;
+using xcassets::Diagnostics;
 
 ext::optional<TexturePixelFormat> TexturePixelFormats::
 Parse(std::string const &value)
@@ -42,7 +44,7 @@ Parse(std::string const &value)
     } else if (value == "astc-8x8-sRGB") {
         return TexturePixelFormat::ASTC8x8sRGB;
     } else {
-        fprintf(stderr, "warning: unknown texture interpretation %s\n", value.c_str());
+        Diagnostics::Print("warning: unknown texture interpretation %s\n", value.c_str());
         return ext::nullopt;
     }
 }
@@ -8,11 +8,13 @@
  */
 
 #include <xcassets/WatchComplicationRole.h>
+#include <xcassets/Diagnostics.h>
 
 #include <cstdlib>
 
 using xcassets::WatchComplicationRole;
 using xcassets::WatchComplicationRoles;
+using xcassets::Diagnostics;
 
 ext::optional<WatchComplicationRole> WatchComplicationRoles::
 Parse(std::string const &value)
@@ -24,7 +26,7 @@ Parse(std::string const &value)
     } else if (value == "utilitarian") {
         return WatchComplicationRole::Utilitarian;
     } else {
-        fprintf(stderr, "warning: unknown watch complication role %s\n", value.c_str());
+        Diagnostics::Print("warning: unknown watch complication role %s\n", value.c_str());
         return ext::nullopt;
     }
 }
@@ -0,0 +1,245 @@
+/**
+ Copyright (c) 2015-present, Facebook, Inc.
+ All rights reserved.
+
+ This source code is licensed under the BSD-style license found in the
+ LICENSE file in the root directory of this source tree. An additional grant
+ of patent rights can be found in the PATENTS file in the same directory.
+ */
+
+#include <gtest/gtest.h>
+#include <xcassets/Asset/Catalog.h>
+#include <xcassets/Asset/ImageSet.h>
+#include <xcassets/Diagnostics.h>
+#include <libutil/Filesystem.h>
+#include <libutil/MemoryFilesystem.h>
+
+namespace Asset = xcassets::Asset;
+using xcassets::Diagnostics;
+using libutil::Filesystem;
+using libutil::MemoryFilesystem;
+
+static std::vector<uint8_t>
+Contents(std::string const &string)
+{
+    return std::vector<uint8_t>(string.begin(), string.end());
+}
+
+#define CONTENTS(...) Contents(#__VA_ARGS__)
+
+static MemoryFilesystem::Entry
+ImageSetEntry(std::string const &name)
+{
+    return MemoryFilesystem::Entry::Directory(name + ".imageset", {
+        MemoryFilesystem::Entry::File("Contents.json", CONTENTS({
+            "images" : [ { "idiom" : "universal", "filename" : "image.png", "scale" : "1x" } ],
+            "info" : { "version" : 1, "author" : "xcode" }
+        })),
+    });
+}
+
+/*
+ * Names of all assets within an asset, depth first.
+ */
+static void
+AssetNames(Asset::Asset const *asset, std::vector<std::string> *names)
+{
+    for (auto const &child : asset->children()) {
+        names->push_back(child->name().string());
+        AssetNames(child.get(), names);
+    }
+}
+
+TEST(Catalog, ParallelOrder)
+{
+    /* Define catalog, with names not in sorted order. */
+    std::vector<MemoryFilesystem::Entry> inner;
+    for (int n = 40; n > 0; n--) {
+        inner.push_back(ImageSetEntry("Inner" + std::to_string(n)));
+    }
+
+    MemoryFilesystem filesystem = MemoryFilesystem({
+        MemoryFilesystem::Entry::Directory("Assets.xcassets", {
+            ImageSetEntry("Zebra"),
+            MemoryFilesystem::Entry::Directory("Namespace", {
+                MemoryFilesystem::Entry::File("Contents.json", CONTENTS({
+                    "properties" : { "provides-namespace": true }
+                })),
+                MemoryFilesystem::Entry::Directory("Nested", inner),
+                ImageSetEntry("Second"),
+            }),
+            MemoryFilesystem::Entry::File("Readme.txt", Contents("")),
+            ImageSetEntry("Alpha"),
+        }),
+    });
+
+    /* Load serially. */
+    auto serial = Asset::Catalog::Load(&filesystem, filesystem.path("Assets.xcassets"), 1);
+    ASSERT_NE(serial, nullptr);
+
+    std::vector<std::string> expected;
+    AssetNames(serial.get(), &expected);
+    ASSERT_EQ(45, expected.size());
+    EXPECT_EQ("Zebra", expected[0]);
+    EXPECT_EQ("Namespace", expected[1]);
+    EXPECT_EQ("Namespace/Nested", expected[2]);
+    EXPECT_EQ("Namespace/Inner40", expected[3]);
+    EXPECT_EQ("Namespace/Second", expected[43]);
+    EXPECT_EQ("Alpha", expected[44]);
+
+    /* Loading in parallel has the same assets, in the same order. */
+    for (size_t jobs : { 2, 4, 16 }) {
+        auto parallel = Asset::Catalog::Load(&filesystem, filesystem.path("Assets.xcassets"), jobs);
+        ASSERT_NE(parallel, nullptr);
+
+        std::vector<std::string> names;
+        AssetNames(parallel.get(), &names);
+        EXPECT_EQ(expected, names);
+    }
+}
+
+static MemoryFilesystem::Entry
+UnknownIdiomEntry(std::string const &name)
+{
+    return MemoryFilesystem::Entry::Directory(name + ".imageset", {
+        MemoryFilesystem::Entry::File("Contents.json", Contents("{ \"images\" : [ { \"idiom\" : \"" + name + "\" } ] }")),
+    });
+}
+
+TEST(Catalog, ParallelDiagnostics)
+{
+    /* Define catalog, with warnings in nested assets. */
+    std::vector<MemoryFilesystem::Entry> inner;
+    for (int n = 0; n < 20; n++) {
+        inner.push_back(UnknownIdiomEntry("inner" + std::to_string(n)));
+    }
+
+    MemoryFilesystem filesystem = MemoryFilesystem({
+        MemoryFilesystem::Entry::Directory("Assets.xcassets", {
+            UnknownIdiomEntry("first"),
+            MemoryFilesystem::Entry::Directory("Nested", inner),
+            UnknownIdiomEntry("last"),
+        }),
+    });
+
+    /* Load serially. */
+    std::string expected;
+    {
+        Diagnostics::Collect collect(&expected);
+        auto serial = Asset::Catalog::Load(&filesystem, filesystem.path("Assets.xcassets"), 1);
+        ASSERT_NE(serial, nullptr);
+    }
+    EXPECT_EQ(0, expected.find("warning: unknown idiom first\n"));
+    EXPECT_LT(expected.find("unknown idiom inner0\n"), expected.find("unknown idiom inner19\n"));
+    EXPECT_EQ(expected.size() - 1, expected.find("unknown idiom last\n") + 18);
+
+    /* Loading in parallel prints the same, in the same order. */
+    for (ext::optional<size_t> jobs : { ext::optional<size_t>(4), ext::optional<size_t>(16), ext::optional<size_t>() }) {
+        std::string output;
+        {
+            Diagnostics::Collect collect(&output);
+            auto parallel = Asset::Catalog::Load(&filesystem, filesystem.path("Assets.xcassets"), jobs);
+            ASSERT_NE(parallel, nullptr);
+        }
+        EXPECT_EQ(expected, output);
+    }
+}
+
+TEST(Catalog, StreamedImageSet)
+{
+    /* Define asset, using every key. */
+    MemoryFilesystem filesystem = MemoryFilesystem({
+        MemoryFilesystem::Entry::Directory("Assets.xcassets", {
+            MemoryFilesystem::Entry::Directory("Image.imageset", {
+                MemoryFilesystem::Entry::File("Contents.json", CONTENTS({
+                    "images" : [
+                        {
+                            "idiom" : "universal",
+                            "filename" : "image.png",
+                            "scale" : "1x",
+                            "color-space" : "sRGB",
+                            "unassigned" : false,
+                            "alignment-insets" : { "top" : 1, "left" : 2, "bottom" : 3, "right" : 4 },
+                            "resizing" : { "mode" : "9-part", "center" : { "mode" : "tile", "width" : 5 } }
+                        },
+                        "not an image",
+                        {
+                            "idiom" : "iphone",
+                            "scale" : "2x",
+                            "unknown" : [ { "nested" : true } ]
+                        },
+                    ],
+                    "properties" : {
+                        "template-rendering-intent" : "template",
+                        "on-demand-resource-tags" : [ "one", "two" ]
+                    },
+                    "unknown" : { "ignored" : [] },
+                    "info" : { "version" : 1, "author" : "xcode" }
+                })),
+            }),
+        }),
+    });
+
+    /* Load asset. */
+    auto catalog = Asset::Catalog::Load(&filesystem, filesystem.path("Assets.xcassets"));
+    ASSERT_NE(catalog, nullptr);
+
+    auto imageSet = catalog->child<Asset::ImageSet>("Image.imageset");
+    ASSERT_NE(imageSet, nullptr);
+
+    /* Verify asset. */
+    EXPECT_EQ(ext::optional<std::string>("xcode"), imageSet->author());
+    EXPECT_EQ(ext::optional<int>(1), imageSet->version());
+    EXPECT_EQ(ext::optional<xcassets::TemplateRenderingIntent>(xcassets::TemplateRenderingIntent::Template), imageSet->templateRenderingIntent());
+    ASSERT_TRUE(imageSet->onDemandResourceTags());
+    EXPECT_EQ(std::vector<std::string>({ "one", "two" }), *imageSet->onDemandResourceTags());
+
+    ASSERT_TRUE(imageSet->images());
+    ASSERT_EQ(2, imageSet->images()->size());
+
+    Asset::ImageSet::Image const &first = imageSet->images()->at(0);
+    EXPECT_EQ(ext::optional<std::string>("image.png"), first.fileName());
+    EXPECT_EQ(ext::optional<xcassets::Slot::Idiom>(xcassets::Slot::Idiom::Universal), first.idiom());
+    ASSERT_TRUE(first.scale());
+    EXPECT_EQ(1.0, first.scale()->value());
+    EXPECT_EQ(ext::optional<xcassets::Slot::ColorSpace>(xcassets::Slot::ColorSpace::sRGB), first.colorSpace());
+    EXPECT_EQ(ext::optional<bool>(false), first.unassignedOptional());
+    ASSERT_TRUE(first.alignmentInsets());
+    EXPECT_EQ(ext::optional<double>(2), first.alignmentInsets()->left());
+    ASSERT_TRUE(first.resizing());
+    EXPECT_EQ(ext::optional<xcassets::Resizing::Mode>(xcassets::Resizing::Mode::NinePart), first.resizing()->mode());
+    ASSERT_TRUE(first.resizing()->center());
+    EXPECT_EQ(ext::optional<double>(5), first.resizing()->center()->width());
+
+    Asset::ImageSet::Image const &second = imageSet->images()->at(1);
+    EXPECT_FALSE(second.fileName());
+    EXPECT_EQ(ext::optional<xcassets::Slot::Idiom>(xcassets::Slot::Idiom::Phone), second.idiom());
+    ASSERT_TRUE(second.scale());
+    EXPECT_EQ(2.0, second.scale()->value());
+}
+
+TEST(Catalog, InvalidImageSet)
+{
+    /* Define catalog, with image sets that are not valid. */
+    MemoryFilesystem filesystem = MemoryFilesystem({
+        MemoryFilesystem::Entry::Directory("Assets.xcassets", {
+            MemoryFilesystem::Entry::Directory("Array.imageset", {
+                MemoryFilesystem::Entry::File("Contents.json", Contents("[]")),
+            }),
+            MemoryFilesystem::Entry::Directory("Trailing.imageset", {
+                MemoryFilesystem::Entry::File("Contents.json", Contents("{ \"images\" : [] } {}")),
+            }),
+            MemoryFilesystem::Entry::Directory("Truncated.imageset", {
+                MemoryFilesystem::Entry::File("Contents.json", Contents("{ \"images\" : [ { \"idiom\" : ")),
+            }),
+            MemoryFilesystem::Entry::Directory("Missing.imageset", { }),
+            ImageSetEntry("Valid"),
+        }),
+    });
+
+    /* Only the valid image set loads. */
+    auto catalog = Asset::Catalog::Load(&filesystem, filesystem.path("Assets.xcassets"));
+    ASSERT_NE(catalog, nullptr);
+    ASSERT_EQ(1, catalog->children().size());
+    EXPECT_EQ("Valid", catalog->children().front()->name().string());
+}
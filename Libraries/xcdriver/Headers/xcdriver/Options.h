@@ -49,6 +49,9 @@ private:
     ext::optional<std::string> _formatter;
     ext::optional<std::string> _executor;
     ext::optional<bool>        _generate;
+    ext::optional<bool>        _actionCache;
+    ext::optional<std::string> _actionCachePath;
+    ext::optional<std::string> _jobserver;
 
 private:
     ext::optional<bool>        _parallelizeTargets;
@@ -158,6 +161,15 @@ public:
     /* Extension. */
     bool generate() const
     { return _generate.value_or(false); }
+    /* Extension. */
+    bool actionCache() const
+    { return _actionCache.value_or(false) || _actionCachePath; }
+    /* Extension. */
+    ext::optional<std::string> const &actionCachePath() const
+    { return _actionCachePath; }
+    /* Extension. */
+    ext::optional<std::string> const &jobserver() const
+    { return _jobserver; }
 
 public:
     bool parallelizeTargets() const
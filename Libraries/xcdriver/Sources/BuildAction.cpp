@@ -10,6 +10,7 @@
 #include <xcdriver/BuildAction.h>
 #include <xcdriver/Action.h>
 #include <xcdriver/Options.h>
+#include <xcexecution/ActionCache.h>
 #include <xcexecution/NinjaExecutor.h>
 #include <xcexecution/SimpleExecutor.h>
 #include <xcformatter/DefaultFormatter.h>
@@ -17,7 +18,12 @@
 #include <builtin/Registry.h>
 #include <libutil/Base.h>
 #include <libutil/Filesystem.h>
+#include <libutil/FSUtil.h>
 #include <process/Context.h>
+#include <process/Jobserver.h>
+
+#include <algorithm>
+#include <thread>
 
 #if !_WIN32
 #include <unistd.h>
@@ -26,6 +32,7 @@
 using xcdriver::BuildAction;
 using xcdriver::Options;
 using libutil::Filesystem;
+using libutil::FSUtil;
 
 BuildAction::
 BuildAction()
@@ -64,20 +71,67 @@ CreateExecutor(
     ext::optional<std::string> const &executor,
     std::shared_ptr<xcformatter::Formatter> const &formatter,
     bool dryRun,
-    bool generate)
+    bool generate,
+    std::shared_ptr<xcexecution::ActionCache> const &actionCache,
+    ext::optional<int> const &jobs,
+    std::shared_ptr<process::Jobserver> const &jobserver)
 {
     if (!executor || *executor == "simple") {
         auto registry = builtin::Registry::Default();
-        auto executor = xcexecution::SimpleExecutor::Create(formatter, dryRun, registry);
+        auto executor = xcexecution::SimpleExecutor::Create(formatter, dryRun, registry, actionCache, jobserver);
         return libutil::static_unique_pointer_cast<xcexecution::Executor>(std::move(executor));
     } else if (*executor == "ninja") {
-        auto executor = xcexecution::NinjaExecutor::Create(formatter, dryRun, generate);
+        ext::optional<size_t> ninjaJobs = (jobs ? ext::optional<size_t>(*jobs) : ext::nullopt);
+        auto executor = xcexecution::NinjaExecutor::Create(formatter, dryRun, generate, actionCache, ninjaJobs, jobserver);
         return libutil::static_unique_pointer_cast<xcexecution::Executor>(std::move(executor));
     }
 
     return nullptr;
 }
 
+/*
+ * Create the jobserver shared with tools that run jobs of their own, if the
+ * number of jobs is limited. Ninja only reads named pipes, so that style is
+ * the default for it.
+ */
+static bool
+CreateJobserver(Options const &options, process::Context const *processContext, std::shared_ptr<process::Jobserver> *jobserver)
+{
+    if (!options.jobs() && !options.jobserver()) {
+        return true;
+    }
+
+    bool ninja = (options.executor() && *options.executor() == "ninja");
+    std::string name = options.jobserver().value_or(ninja ? "fifo" : "pipe");
+    if (name == "none") {
+        return true;
+    }
+
+    ext::optional<process::Jobserver::Style> style = process::Jobserver::ParseStyle(name);
+    if (!style) {
+        fprintf(stderr, "error: unknown jobserver style '%s'\n", name.c_str());
+        return false;
+    }
+
+    size_t jobs = std::max<size_t>(std::thread::hardware_concurrency(), 1);
+    if (options.jobs()) {
+        if (*options.jobs() <= 0) {
+            fprintf(stderr, "error: invalid number of jobs %d\n", *options.jobs());
+            return false;
+        }
+        jobs = *options.jobs();
+    }
+
+    std::string temporaryDirectory = processContext->environmentVariable("TMPDIR").value_or("/tmp");
+    *jobserver = process::Jobserver::Create(*style, jobs, temporaryDirectory);
+    if (*jobserver == nullptr) {
+        /* Not fatal: tools fall back to their own limits. */
+        fprintf(stderr, "warning: couldn't create jobserver\n");
+    }
+
+    return true;
+}
+
 static bool
 VerifySupportedOptions(Options const &options)
 {
@@ -93,7 +147,7 @@ VerifySupportedOptions(Options const &options)
         fprintf(stderr, "warning: destination option not implemented\n");
     }
 
-    if (options.parallelizeTargets() || options.jobs()) {
+    if (options.parallelizeTargets()) {
         fprintf(stderr, "warning: job control option not implemented\n");
     }
 
@@ -144,10 +198,36 @@ Run(process::User const *user, process::Context const *processContext, process::
         return -1;
     }
 
+    /*
+     * Create the action cache, if enabled, to reuse outputs from earlier builds.
+     */
+    std::shared_ptr<xcexecution::ActionCache> actionCache;
+    if (options.actionCache()) {
+        ext::optional<std::string> actionCachePath = options.actionCachePath();
+        if (!actionCachePath) {
+            actionCachePath = xcexecution::ActionCache::DefaultPath(user);
+        }
+        if (!actionCachePath) {
+            fprintf(stderr, "error: unable to find action cache location\n");
+            return -1;
+        }
+
+        std::string path = FSUtil::ResolveRelativePath(*actionCachePath, processContext->currentDirectory());
+        actionCache = std::make_shared<xcexecution::ActionCache>(path, xcexecution::ActionCache::DefaultMaximumSize());
+    }
+
+    /*
+     * Create the jobserver, if enabled, to limit jobs across nested builds.
+     */
+    std::shared_ptr<process::Jobserver> jobserver;
+    if (!CreateJobserver(options, processContext, &jobserver)) {
+        return -1;
+    }
+
     /*
      * Create the executor used to perform the build.
      */
-    std::unique_ptr<xcexecution::Executor> executor = CreateExecutor(options.executor(), formatter, options.dryRun(), options.generate());
+    std::unique_ptr<xcexecution::Executor> executor = CreateExecutor(options.executor(), formatter, options.dryRun(), options.generate(), actionCache, options.jobs(), jobserver);
     if (executor == nullptr) {
         fprintf(stderr, "error: unknown executor '%s'\n", options.executor()->c_str());
         return -1;
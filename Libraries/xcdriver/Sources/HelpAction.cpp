@@ -72,6 +72,19 @@ Run(process::Context const *processContext)
         "    -generate                                   "
         "specify that an execution engine based on generating another build "
         "language should regenerate\n");
+    fprintf(
+        stdout,
+        "    -actionCache                                "
+        "reuse outputs of identical tool invocations from earlier builds\n");
+    fprintf(
+        stdout,
+        "    -actionCachePath PATH                       "
+        "store the action cache in PATH instead of ~/.xcbuild/cache\n");
+    fprintf(
+        stdout,
+        "    -jobserver STYLE                            "
+        "share the jobs with tools like make through a GNU make jobserver. "
+        "STYLE is 'pipe', 'fifo' or 'none'\n");
     fprintf(
         stdout,
         "    -project NAME                               "
@@ -129,7 +142,8 @@ Run(process::Context const *processContext)
     fprintf(
         stdout,
         "    -jobs NUMBER                                "
-        "not yet implemented\n");
+        "run at most NUMBER jobs at once, including those of nested "
+        "builds\n");
     fprintf(
         stdout,
         "    -dry-run                                    "
@@ -130,6 +130,12 @@ parseArgument(std::vector<std::string> const &args, std::vector<std::string>::co
         return libutil::Options::Next<std::string>(&_formatter, args, it);
     } else if (arg == "-generate") {
         return libutil::Options::Current<bool>(&_generate, arg);
+    } else if (arg == "-actionCache") {
+        return libutil::Options::Current<bool>(&_actionCache, arg);
+    } else if (arg == "-actionCachePath") {
+        return libutil::Options::Next<std::string>(&_actionCachePath, args, it);
+    } else if (arg == "-jobserver") {
+        return libutil::Options::Next<std::string>(&_jobserver, args, it);
     } else if (!arg.empty() && arg[0] != '-') {
         if (arg.find('=') != std::string::npos) {
             if (ext::optional<pbxsetting::Setting> setting = pbxsetting::Setting::Parse(arg)) {
@@ -0,0 +1,418 @@
+/**
+ Copyright (c) 2015-present, Facebook, Inc.
+ All rights reserved.
+
+ This source code is licensed under the BSD-style license found in the
+ LICENSE file in the root directory of this source tree. An additional grant
+ of patent rights can be found in the PATENTS file in the same directory.
+ */
+
+#include <benchmark/Harness.h>
+#include <benchmark/SyntheticWorkspace.h>
+#include <xcexecution/NinjaExecutor.h>
+#include <xcexecution/Parameters.h>
+#include <xcformatter/NullFormatter.h>
+#include <pbxbuild/Build/Environment.h>
+#include <pbxbuild/Build/Context.h>
+#include <pbxbuild/Target/Environment.h>
+#include <pbxbuild/Phase/Environment.h>
+#include <pbxbuild/Phase/PhaseInvocations.h>
+#include <pbxbuild/WorkspaceContext.h>
+#include <pbxproj/PBX/Project.h>
+#include <libutil/CachingFilesystem.h>
+#include <libutil/DefaultFilesystem.h>
+#include <libutil/MemoryFilesystem.h>
+#include <libutil/Filesystem.h>
+#include <libutil/Options.h>
+#include <process/DefaultContext.h>
+#include <process/DefaultUser.h>
+#include <process/MemoryContext.h>
+#include <process/MemoryLauncher.h>
+
+#include <cstdlib>
+
+#if !_WIN32
+#include <unistd.h>
+#endif
+
+using benchmark::Harness;
+using benchmark::SyntheticWorkspace;
+using libutil::DefaultFilesystem;
+using libutil::Filesystem;
+using libutil::MemoryFilesystem;
+
+class Options {
+private:
+    ext::optional<bool>        _help;
+
+private:
+    ext::optional<int>         _projects;
+    ext::optional<int>         _targets;
+    ext::optional<int>         _files;
+    ext::optional<int>         _xcconfigDepth;
+    ext::optional<int>         _crossProjectDependencies;
+
+private:
+    std::vector<std::string>   _filesystems;
+    ext::optional<std::string> _root;
+    ext::optional<std::string> _specifications;
+    ext::optional<bool>        _csv;
+
+public:
+    Options();
+    ~Options();
+
+public:
+    bool help() const
+    { return _help.value_or(false); }
+
+public:
+    int projects() const
+    { return _projects.value_or(4); }
+    int targets() const
+    { return _targets.value_or(8); }
+    int files() const
+    { return _files.value_or(50); }
+    int xcconfigDepth() const
+    { return _xcconfigDepth.value_or(4); }
+    int crossProjectDependencies() const
+    { return _crossProjectDependencies.value_or(2); }
+
+public:
+    std::vector<std::string> const &filesystems() const
+    { return _filesystems; }
+    ext::optional<std::string> const &root() const
+    { return _root; }
+    ext::optional<std::string> const &specifications() const
+    { return _specifications; }
+    bool csv() const
+    { return _csv.value_or(false); }
+
+private:
+    friend class libutil::Options;
+    std::pair<bool, std::string>
+    parseArgument(std::vector<std::string> const &args, std::vector<std::string>::const_iterator *it);
+};
+
+Options::
+Options()
+{
+}
+
+Options::
+~Options()
+{
+}
+
+std::pair<bool, std::string> Options::
+parseArgument(std::vector<std::string> const &args, std::vector<std::string>::const_iterator *it)
+{
+    std::string const &arg = **it;
+
+    if (arg == "-h" || arg == "--help") {
+        return libutil::Options::Current<bool>(&_help, arg);
+    } else if (arg == "--projects") {
+        return libutil::Options::Next<int>(&_projects, args, it);
+    } else if (arg == "--targets") {
+        return libutil::Options::Next<int>(&_targets, args, it);
+    } else if (arg == "--files") {
+        return libutil::Options::Next<int>(&_files, args, it);
+    } else if (arg == "--xcconfig-depth") {
+        return libutil::Options::Next<int>(&_xcconfigDepth, args, it);
+    } else if (arg == "--cross-project-dependencies") {
+        return libutil::Options::Next<int>(&_crossProjectDependencies, args, it);
+    } else if (arg == "--filesystem") {
+        return libutil::Options::AppendNext<std::string>(&_filesystems, args, it);
+    } else if (arg == "--root") {
+        return libutil::Options::Next<std::string>(&_root, args, it);
+    } else if (arg == "--specifications") {
+        return libutil::Options::Next<std::string>(&_specifications, args, it);
+    } else if (arg == "--csv") {
+        return libutil::Options::Current<bool>(&_csv, arg);
+    } else {
+        return std::make_pair(false, "unknown argument " + arg);
+    }
+}
+
+static int
+Help(std::string const &error = std::string())
+{
+    if (!error.empty()) {
+        fprintf(stderr, "error: %s\n", error.c_str());
+        fprintf(stderr, "\n");
+    }
+
+    fprintf(stderr, "Usage: bench_xcexecution_Pipeline [options]\n\n");
+    fprintf(stderr, "Measures the build planning pipeline on a synthetic workspace.\n\n");
+
+#define INDENT "  "
+    fprintf(stderr, "Workspace Shape:\n");
+    fprintf(stderr, INDENT "--projects <count>\n");
+    fprintf(stderr, INDENT "--targets <count> (per project)\n");
+    fprintf(stderr, INDENT "--files <count> (per target)\n");
+    fprintf(stderr, INDENT "--xcconfig-depth <depth>\n");
+    fprintf(stderr, INDENT "--cross-project-dependencies <count> (per target)\n");
+    fprintf(stderr, "\n");
+
+    fprintf(stderr, "Environment:\n");
+    fprintf(stderr, INDENT "--filesystem memory|default (repeatable; default both)\n");
+    fprintf(stderr, INDENT "--root <path> (for the default filesystem)\n");
+    fprintf(stderr, INDENT "--specifications <path>\n");
+    fprintf(stderr, INDENT "--csv\n");
+    fprintf(stderr, "\n");
+#undef INDENT
+
+    return (error.empty() ? EXIT_SUCCESS : EXIT_FAILURE);
+}
+
+static ext::optional<std::string>
+CreateTemporaryRoot()
+{
+#if _WIN32
+    return ext::nullopt;
+#else
+    char const *tmpdir = getenv("TMPDIR");
+    std::string pattern = std::string(tmpdir != nullptr ? tmpdir : "/tmp") + "/xcbuild-bench-XXXXXX";
+
+    std::vector<char> buffer = std::vector<char>(pattern.begin(), pattern.end());
+    buffer.push_back('\0');
+    if (mkdtemp(buffer.data()) == nullptr) {
+        return ext::nullopt;
+    }
+
+    return std::string(buffer.data());
+#endif
+}
+
+static bool
+Benchmark(
+    Harness *harness,
+    Filesystem *filesystem,
+    SyntheticWorkspace const &workspace,
+    std::string const &specificationsPath)
+{
+    DefaultFilesystem specificationsFilesystem;
+    process::DefaultUser user;
+    process::MemoryLauncher launcher = process::MemoryLauncher({ });
+
+    if (!harness->stage("Generate", [&]() -> bool {
+        return workspace.write(filesystem, &specificationsFilesystem, specificationsPath);
+    })) {
+        return false;
+    }
+
+    process::MemoryContext processContext = process::MemoryContext(
+        workspace.executablePath(),
+        workspace.root(),
+        { },
+        {
+            { "DEVELOPER_DIR", workspace.developerRoot() },
+            { "PATH", workspace.developerRoot() + "/usr/bin" },
+        });
+
+    /*
+     * Build products go in the workspace root rather than the user's
+     * derived data directory, so they are cleaned up with the workspace.
+     */
+    pbxsetting::Level derivedDataLevel = pbxsetting::Level({
+        pbxsetting::Setting::Create("DERIVED_DATA_DIR", workspace.derivedDataPath()),
+    });
+
+    ext::optional<pbxbuild::Build::Environment> buildEnvironment;
+    if (!harness->stage("Build::Environment::Default", [&]() -> bool {
+        ext::optional<pbxbuild::Build::Environment> defaultEnvironment = pbxbuild::Build::Environment::Default(&user, &processContext, filesystem);
+        if (!defaultEnvironment) {
+            return false;
+        }
+
+        pbxsetting::Environment baseEnvironment = pbxsetting::Environment(defaultEnvironment->baseEnvironment());
+        baseEnvironment.insertFront(derivedDataLevel, false);
+        buildEnvironment = pbxbuild::Build::Environment(
+            defaultEnvironment->specManager(),
+            defaultEnvironment->sdkManager(),
+            baseEnvironment,
+            defaultEnvironment->baseExecutablePaths());
+        return true;
+    })) {
+        return false;
+    }
+
+    xcexecution::Parameters parameters = xcexecution::Parameters(
+        workspace.workspacePath(),
+        ext::nullopt,
+        workspace.schemeName(),
+        ext::nullopt,
+        false,
+        { "build" },
+        std::string("Debug"),
+        { derivedDataLevel });
+
+    if (!harness->stage("Project::Open", [&]() -> bool {
+        std::string workspaceDirectory = workspace.workspacePath() + "/..";
+        for (size_t p = 0; p < workspace.parameters().projects(); p++) {
+            std::string name = "Project" + std::to_string(p);
+            if (pbxproj::PBX::Project::Open(filesystem, workspaceDirectory + "/" + name + "/" + name + ".xcodeproj") == nullptr) {
+                return false;
+            }
+        }
+        return true;
+    })) {
+        return false;
+    }
+
+    ext::optional<pbxbuild::WorkspaceContext> workspaceContext;
+    if (!harness->stage("WorkspaceContext", [&]() -> bool {
+        workspaceContext = parameters.loadWorkspace(filesystem, user.userName(), *buildEnvironment, processContext.currentDirectory());
+        return static_cast<bool>(workspaceContext);
+    })) {
+        return false;
+    }
+
+    ext::optional<pbxbuild::Build::Context> buildContext = parameters.createBuildContext(*workspaceContext);
+    if (!buildContext) {
+        fprintf(stderr, "error: unable to create build context\n");
+        return false;
+    }
+
+    ext::optional<pbxbuild::DirectedGraph<pbxproj::PBX::Target::shared_ptr>> targetGraph;
+    if (!harness->stage("DependencyResolver", [&]() -> bool {
+        targetGraph = parameters.resolveDependencies(*buildEnvironment, *buildContext);
+        return static_cast<bool>(targetGraph) && !targetGraph->nodes().empty();
+    })) {
+        return false;
+    }
+
+    /*
+     * Create target environments directly, as the build context caches them.
+     */
+    std::vector<std::pair<pbxproj::PBX::Target::shared_ptr, pbxbuild::Target::Environment>> targetEnvironments;
+    if (!harness->stage("Target::Environment::Create", [&]() -> bool {
+        for (pbxproj::PBX::Target::shared_ptr const &target : targetGraph->nodes()) {
+            ext::optional<pbxbuild::Target::Environment> targetEnvironment = pbxbuild::Target::Environment::Create(*buildEnvironment, *buildContext, target);
+            if (!targetEnvironment) {
+                return false;
+            }
+            targetEnvironments.push_back({ target, *targetEnvironment });
+        }
+        return true;
+    })) {
+        return false;
+    }
+
+    size_t invocations = 0;
+    if (!harness->stage("PhaseInvocations::Create", [&]() -> bool {
+        libutil::CachingFilesystem cachingFilesystem = libutil::CachingFilesystem(filesystem);
+        for (auto const &entry : targetEnvironments) {
+            pbxbuild::Phase::Environment phaseEnvironment = pbxbuild::Phase::Environment(*buildEnvironment, *buildContext, entry.first, entry.second);
+            pbxbuild::Phase::PhaseInvocations phaseInvocations = pbxbuild::Phase::PhaseInvocations::Create(&cachingFilesystem, phaseEnvironment, entry.first);
+            invocations += phaseInvocations.invocations().size();
+        }
+        return invocations > 0;
+    })) {
+        return false;
+    }
+
+    /*
+     * Generate without running Ninja. This loads the workspace again, as
+     * the executor does not share the state loaded above.
+     */
+    auto formatter = xcformatter::NullFormatter::Create();
+    auto executor = xcexecution::NinjaExecutor::Create(formatter, false, true);
+    if (!harness->stage("NinjaExecutor", [&]() -> bool {
+        return executor->build(&user, &processContext, &launcher, filesystem, *buildEnvironment, parameters);
+    })) {
+        return false;
+    }
+
+    return true;
+}
+
+int
+main(int argc, char **argv)
+{
+    process::DefaultContext processContext = process::DefaultContext();
+
+    /*
+     * Parse out the options, or print help & exit.
+     */
+    Options options;
+    std::pair<bool, std::string> result = libutil::Options::Parse<Options>(&options, processContext.commandLineArguments());
+    if (!result.first) {
+        return Help(result.second);
+    }
+
+    if (options.help()) {
+        return Help();
+    }
+
+    if (options.projects() <= 0 || options.targets() <= 0 || options.files() <= 0 || options.xcconfigDepth() < 0 || options.crossProjectDependencies() < 0) {
+        return Help("invalid workspace shape");
+    }
+
+#if defined(XCBUILD_SPECIFICATIONS_PATH)
+    std::string specificationsPath = options.specifications().value_or(XCBUILD_SPECIFICATIONS_PATH);
+#else
+    if (!options.specifications()) {
+        return Help("missing specifications path");
+    }
+    std::string specificationsPath = *options.specifications();
+#endif
+
+    SyntheticWorkspace::Parameters parameters = SyntheticWorkspace::Parameters(
+        options.projects(),
+        options.targets(),
+        options.files(),
+        options.xcconfigDepth(),
+        options.crossProjectDependencies());
+
+    std::vector<std::string> filesystems = options.filesystems();
+    if (filesystems.empty()) {
+        filesystems = { "memory", "default" };
+    }
+
+    bool success = true;
+    bool header = true;
+    for (std::string const &name : filesystems) {
+        std::string description =
+            "pipeline " + name +
+            " projects=" + std::to_string(parameters.projects()) +
+            " targets=" + std::to_string(parameters.targets()) +
+            " files=" + std::to_string(parameters.filesPerTarget()) +
+            " xcconfig-depth=" + std::to_string(parameters.xcconfigDepth()) +
+            " cross-project-dependencies=" + std::to_string(parameters.crossProjectDependencies());
+        Harness harness = Harness(description);
+
+        if (name == "memory") {
+            MemoryFilesystem filesystem = MemoryFilesystem({ });
+            SyntheticWorkspace workspace = SyntheticWorkspace(parameters, filesystem.path("bench"));
+            success = Benchmark(&harness, &filesystem, workspace, specificationsPath) && success;
+        } else if (name == "default") {
+            ext::optional<std::string> root = options.root();
+            if (!root) {
+                root = CreateTemporaryRoot();
+            }
+            if (!root) {
+                return Help("unable to create temporary directory; pass --root");
+            }
+
+            DefaultFilesystem filesystem;
+            SyntheticWorkspace workspace = SyntheticWorkspace(parameters, *root);
+            success = Benchmark(&harness, &filesystem, workspace, specificationsPath) && success;
+
+            if (!options.root()) {
+                filesystem.removeDirectory(*root, true);
+            }
+        } else {
+            return Help("unknown filesystem " + name);
+        }
+
+        if (options.csv()) {
+            harness.reportCSV(stdout, header);
+            header = false;
+        } else {
+            harness.report(stdout);
+        }
+    }
+
+    return (success ? EXIT_SUCCESS : EXIT_FAILURE);
+}
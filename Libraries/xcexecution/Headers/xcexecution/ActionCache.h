@@ -0,0 +1,176 @@
+/**
+ Copyright (c) 2015-present, Facebook, Inc.
+ All rights reserved.
+
+ This source code is licensed under the BSD-style license found in the
+ LICENSE file in the root directory of this source tree. An additional grant
+ of patent rights can be found in the PATENTS file in the same directory.
+ */
+
+#ifndef __xcexecution_ActionCache_h
+#define __xcexecution_ActionCache_h
+
+#include <pbxbuild/Tool/Invocation.h>
+#include <libutil/FileHasher.h>
+
+#include <string>
+#include <unordered_map>
+#include <ext/optional>
+
+#include <cstdint>
+
+namespace process { class User; }
+
+namespace xcexecution {
+
+/*
+ * A local cache of invocation outputs. Invocations are keyed by what can
+ * affect their outputs: the executable and its contents, the arguments,
+ * environment and working directory, and the contents of every input.
+ * Dependencies discovered from an invocation's dependency info are checked
+ * before a cached result is used.
+ *
+ * Outputs are kept in a content-addressed store, so identical outputs are
+ * only stored once. When the store grows past its maximum size, the least
+ * recently used entries are evicted.
+ *
+ * Layout of the cache directory:
+ *
+ *     actions/<key>    Entry for an invocation: its outputs and dependencies.
+ *     objects/<hash>   Contents of an output.
+ *     hashes           Remembered hashes of inputs, from `FileHasher`.
+ *     hashes.pending/  Hashes saved by other processes, for `trim()`.
+ */
+class ActionCache {
+public:
+    /*
+     * Counts of cache activity, for reporting.
+     */
+    class Statistics {
+    public:
+        size_t hits;
+        size_t misses;
+        size_t stores;
+        size_t evictions;
+
+    public:
+        Statistics();
+    };
+
+private:
+    std::string                                  _path;
+    uint64_t                                     _maximumSize;
+
+private:
+    Statistics                                   _statistics;
+    std::unordered_map<std::string, std::string> _executableHashes;
+    libutil::FileHasher                          _fileHasher;
+    bool                                         _fileHashesLoaded;
+
+public:
+    ActionCache(std::string const &path, uint64_t maximumSize);
+    ~ActionCache();
+
+public:
+    /*
+     * The directory containing the cache.
+     */
+    std::string const &path() const
+    { return _path; }
+
+    /*
+     * The size of stored outputs to trim the cache down to.
+     */
+    uint64_t maximumSize() const
+    { return _maximumSize; }
+
+    /*
+     * Activity since the cache was created.
+     */
+    Statistics const &statistics() const
+    { return _statistics; }
+
+public:
+    /*
+     * If an invocation can be cached, before looking at its inputs. Those
+     * without inputs or outputs, or with inputs that may not exist, can't.
+     */
+    static bool Cacheable(pbxbuild::Tool::Invocation const &invocation);
+
+    /*
+     * The cache key for an invocation run with an executable. Invocations
+     * that aren't cacheable, or have missing inputs, have no key.
+     */
+    ext::optional<std::string> key(
+        libutil::Filesystem const *filesystem,
+        pbxbuild::Tool::Invocation const &invocation,
+        std::string const &executable);
+
+    /*
+     * Restore the outputs of an invocation from the cache. Outputs are
+     * cloned from the cache where the filesystem supports it, and copied
+     * otherwise. Returns false if the invocation is not cached or a
+     * dependency has changed.
+     */
+    bool restore(
+        libutil::Filesystem *filesystem,
+        std::string const &key,
+        pbxbuild::Tool::Invocation const &invocation);
+
+    /*
+     * Store the outputs of an invocation after it has succeeded. Its
+     * dependency info files are stored with the outputs, so the build
+     * still finds the dependencies after restoring them.
+     */
+    bool store(
+        libutil::Filesystem *filesystem,
+        std::string const &key,
+        pbxbuild::Tool::Invocation const &invocation);
+
+    /*
+     * Evict least recently used entries until the stored outputs fit in
+     * the maximum size, then remove outputs no entry refers to. Also saves
+     * remembered input hashes for the next build.
+     */
+    bool trim(libutil::Filesystem *filesystem);
+
+    /*
+     * Save input hashes found since the cache was created, for the next
+     * `trim()` to remember. For separate processes using the cache during
+     * a build, like `action-cache-tool`, which can't all write the same
+     * file; `key` names the saved hashes.
+     */
+    bool saveHashes(libutil::Filesystem *filesystem, std::string const &key);
+
+public:
+    /*
+     * Describe an invocation and its executable, for a separate process
+     * using the cache: `action-cache-tool` runs Ninja's invocations. The
+     * description has everything `key()` and `store()` use.
+     */
+    static std::string
+    SerializeInvocation(pbxbuild::Tool::Invocation const &invocation, std::string const &executable);
+
+    /*
+     * Read a description from `SerializeInvocation()`.
+     */
+    static bool
+    DeserializeInvocation(std::string const &contents, pbxbuild::Tool::Invocation *invocation, std::string *executable);
+
+public:
+    /*
+     * The default cache location, in the user's home directory.
+     */
+    static ext::optional<std::string>
+    DefaultPath(process::User const *user);
+
+    /*
+     * The default maximum size, in bytes.
+     */
+    static uint64_t
+    DefaultMaximumSize();
+};
+
+}
+
+#endif // !__xcexecution_ActionCache_h
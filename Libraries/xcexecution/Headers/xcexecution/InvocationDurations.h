@@ -0,0 +1,114 @@
+/**
+ Copyright (c) 2015-present, Facebook, Inc.
+ All rights reserved.
+
+ This source code is licensed under the BSD-style license found in the
+ LICENSE file in the root directory of this source tree. An additional grant
+ of patent rights can be found in the PATENTS file in the same directory.
+ */
+
+#ifndef __xcexecution_InvocationDurations_h
+#define __xcexecution_InvocationDurations_h
+
+#include <pbxbuild/Tool/Invocation.h>
+#include <libutil/Hash.h>
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include <ext/optional>
+
+#include <cstdint>
+
+namespace libutil { class Filesystem; }
+
+namespace xcexecution {
+
+/*
+ * How long invocations took in earlier builds, used to start the longest
+ * chains of invocations first. Durations are keyed by an invocation's first
+ * output and a hash of its command, so a changed command is not estimated
+ * from how long the old one took.
+ *
+ * Kept between builds in the intermediates directory; see `Path()`.
+ */
+class InvocationDurations {
+private:
+    class Entry {
+    public:
+        libutil::Hash command;
+        uint64_t      milliseconds;
+    };
+
+private:
+    std::unordered_map<std::string, Entry> _entries;
+
+public:
+    InvocationDurations();
+    ~InvocationDurations();
+
+public:
+    /*
+     * How long an invocation took when it last ran, if known.
+     */
+    ext::optional<uint64_t> duration(pbxbuild::Tool::Invocation const &invocation) const;
+
+    /*
+     * Remember how long an invocation took. Invocations without outputs
+     * can't be identified between builds, so are not remembered.
+     */
+    void record(pbxbuild::Tool::Invocation const &invocation, uint64_t milliseconds);
+
+    /*
+     * The number of invocations with remembered durations.
+     */
+    size_t size() const
+    { return _entries.size(); }
+
+public:
+    /*
+     * For each invocation, the estimated time from it starting until every
+     * invocation after it finishes: its duration plus the heaviest chain of
+     * invocations depending on it, including those in later phases.
+     * Invocations without a remembered duration are estimated as the mean
+     * of those with one.
+     */
+    std::vector<uint64_t> weights(std::vector<pbxbuild::Tool::Invocation> const &invocations) const;
+
+    /*
+     * Order invocations so each comes after its dependencies and after the
+     * invocations in earlier phases, choosing the heaviest invocation that
+     * is ready at each step. Returns indexes into the invocations; nothing
+     * if the dependencies have a cycle.
+     */
+    ext::optional<std::vector<size_t>> schedule(std::vector<pbxbuild::Tool::Invocation> const &invocations) const;
+
+public:
+    /*
+     * Load remembered durations from a file, adding to those already known.
+     */
+    bool load(libutil::Filesystem const *filesystem, std::string const &path);
+
+    /*
+     * Save remembered durations to a file.
+     */
+    bool save(libutil::Filesystem *filesystem, std::string const &path) const;
+
+public:
+    /*
+     * Where durations are kept for a build's intermediates directory.
+     */
+    static std::string
+    Path(std::string const &intermediatesDirectory);
+
+    /*
+     * The hash of what an invocation runs: its executable, arguments and
+     * working directory.
+     */
+    static libutil::Hash
+    CommandHash(pbxbuild::Tool::Invocation const &invocation);
+};
+
+}
+
+#endif // !__xcexecution_InvocationDurations_h
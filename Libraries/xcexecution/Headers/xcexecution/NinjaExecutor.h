@@ -11,11 +11,15 @@
 #define __xcexecution_NinjaExecutor_h
 
 #include <xcexecution/Executor.h>
+#include <xcexecution/ActionCache.h>
+#include <xcexecution/InvocationDurations.h>
 #include <pbxbuild/Tool/AuxiliaryFile.h>
 #include <pbxbuild/Tool/Invocation.h>
 #include <pbxbuild/DirectedGraph.h>
+#include <process/Jobserver.h>
 
 namespace ninja { class Writer; }
+namespace dependency { class DependencyInfoConversion; }
 
 namespace xcexecution {
 
@@ -23,10 +27,43 @@ namespace xcexecution {
  * Concrete executor that generates Ninja files.
  */
 class NinjaExecutor : public Executor {
+private:
+    std::shared_ptr<ActionCache>        _actionCache;
+    ext::optional<size_t>               _jobs;
+    std::shared_ptr<process::Jobserver> _jobserver;
+
 public:
-    NinjaExecutor(std::shared_ptr<xcformatter::Formatter> const &formatter, bool dryRun, bool generate);
+    NinjaExecutor(
+        std::shared_ptr<xcformatter::Formatter> const &formatter,
+        bool dryRun,
+        bool generate,
+        std::shared_ptr<ActionCache> const &actionCache = nullptr,
+        ext::optional<size_t> const &jobs = ext::nullopt,
+        std::shared_ptr<process::Jobserver> const &jobserver = nullptr);
     ~NinjaExecutor();
 
+public:
+    /*
+     * Cache of invocation outputs, used through `action-cache-tool` for
+     * the invocations Ninja runs. Optional.
+     */
+    std::shared_ptr<ActionCache> const &actionCache() const
+    { return _actionCache; }
+
+    /*
+     * How many jobs Ninja runs at once, if not its default. Optional.
+     */
+    ext::optional<size_t> const &jobs() const
+    { return _jobs; }
+
+    /*
+     * Job tokens shared with Ninja and the tools it runs. Ninja 1.13 and
+     * later take jobs from the pool; earlier versions only use the number
+     * of jobs. Optional.
+     */
+    std::shared_ptr<process::Jobserver> const &jobserver() const
+    { return _jobserver; }
+
 public:
     virtual bool build(
         process::User const *user,
@@ -45,6 +82,8 @@ private:
         pbxbuild::Build::Context const &buildContext,
         pbxbuild::DirectedGraph<pbxproj::PBX::Target::shared_ptr> const &targetGraph,
         std::string const &dependencyInfoToolPath,
+        std::string const &builtinClientPath,
+        std::string const &actionCacheToolPath,
         std::string const &ninjaPath,
         std::string const &configurationHashPath,
         std::string const &intermediatesDirectory);
@@ -56,10 +95,14 @@ private:
         process::Context const *processContext,
         libutil::Filesystem *filesystem,
         std::string const &dependencyInfoToolPath,
+        std::string const &builtinClientPath,
+        std::string const &actionCacheToolPath,
         pbxproj::PBX::Target::shared_ptr const &target,
         pbxbuild::Target::Environment const &targetEnvironment,
         std::vector<pbxbuild::Tool::AuxiliaryFile> const &auxiliaryFiles,
-        std::vector<pbxbuild::Tool::Invocation> const &invocations);
+        std::vector<pbxbuild::Tool::Invocation> const &invocations,
+        InvocationDurations const &durations,
+        std::string const &intermediatesDirectory);
 
 private:
     bool buildAuxiliaryFile(
@@ -70,15 +113,27 @@ private:
         std::map<std::string, pbxbuild::Tool::AuxiliaryFile::Chunk const *> &auxiliaryFileChunks);
     bool buildInvocation(
         ninja::Writer *writer,
+        std::unordered_map<std::string, std::string> *toolRules,
+        std::unordered_map<std::unordered_map<std::string, std::string> const *, std::string> *environmentBases,
         pbxbuild::Tool::Invocation const &invocation,
         std::string const &executablePath,
-        std::string const &dependencyInfoToolPath,
+        std::string const &builtinClientPath,
+        std::string const &actionCacheToolPath,
+        std::vector<dependency::DependencyInfoConversion> *conversions,
+        std::vector<std::pair<std::string, std::string>> *invocationDescriptions,
         std::string const &temporaryDirectory,
+        std::string const &intermediatesDirectory,
         std::string const &after);
 
 public:
     static std::unique_ptr<NinjaExecutor>
-    Create(std::shared_ptr<xcformatter::Formatter> const &formatter, bool dryRun, bool generate);
+    Create(
+        std::shared_ptr<xcformatter::Formatter> const &formatter,
+        bool dryRun,
+        bool generate,
+        std::shared_ptr<ActionCache> const &actionCache = nullptr,
+        ext::optional<size_t> const &jobs = ext::nullopt,
+        std::shared_ptr<process::Jobserver> const &jobserver = nullptr);
 };
 
 }
@@ -11,8 +11,11 @@
 #define __xcexecution_SimpleExecutor_h
 
 #include <xcexecution/Executor.h>
+#include <xcexecution/ActionCache.h>
+#include <xcexecution/InvocationDurations.h>
 #include <pbxbuild/Tool/AuxiliaryFile.h>
 #include <builtin/Registry.h>
+#include <process/Jobserver.h>
 
 namespace xcexecution {
 
@@ -22,12 +25,44 @@ namespace xcexecution {
  */
 class SimpleExecutor : public Executor {
 private:
-    builtin::Registry _builtins;
+    builtin::Registry            _builtins;
+    std::shared_ptr<ActionCache> _actionCache;
+    std::shared_ptr<process::Jobserver> _jobserver;
+    InvocationDurations          _durations;
 
 public:
-    SimpleExecutor(std::shared_ptr<xcformatter::Formatter> const &formatter, bool dryRun, builtin::Registry const &builtins);
+    SimpleExecutor(
+        std::shared_ptr<xcformatter::Formatter> const &formatter,
+        bool dryRun,
+        builtin::Registry const &builtins,
+        std::shared_ptr<ActionCache> const &actionCache = nullptr,
+        std::shared_ptr<process::Jobserver> const &jobserver = nullptr);
     ~SimpleExecutor();
 
+public:
+    /*
+     * Cache of invocation outputs to reuse instead of running tools. Optional.
+     */
+    std::shared_ptr<ActionCache> const &actionCache() const
+    { return _actionCache; }
+
+    /*
+     * Job tokens to hold while running tools, and to share with tools that
+     * run jobs of their own. Optional.
+     */
+    std::shared_ptr<process::Jobserver> const &jobserver() const
+    { return _jobserver; }
+
+    /*
+     * How long invocations took, used to order them. Loaded from and saved
+     * to the intermediates directory by `build()`, and updated as
+     * invocations run.
+     */
+    InvocationDurations const &durations() const
+    { return _durations; }
+    InvocationDurations &durations()
+    { return _durations; }
+
 public:
     virtual bool build(
         process::User const *user,
@@ -41,6 +76,8 @@ public:
     bool writeAuxiliaryFiles(
         libutil::Filesystem *filesystem,
         std::vector<pbxbuild::Tool::AuxiliaryFile> const &auxiliaryFiles);
+    ext::optional<std::vector<pbxbuild::Tool::Invocation>> sortInvocations(
+        std::vector<pbxbuild::Tool::Invocation> const &invocations) const;
     std::pair<bool, std::vector<pbxbuild::Tool::Invocation>> performInvocations(
         process::Context const *processContext,
         process::Launcher *processLauncher,
@@ -59,7 +96,12 @@ public:
 
 public:
     static std::unique_ptr<SimpleExecutor>
-    Create(std::shared_ptr<xcformatter::Formatter> const &formatter, bool dryRun, builtin::Registry const &builtins);
+    Create(
+        std::shared_ptr<xcformatter::Formatter> const &formatter,
+        bool dryRun,
+        builtin::Registry const &builtins,
+        std::shared_ptr<ActionCache> const &actionCache = nullptr,
+        std::shared_ptr<process::Jobserver> const &jobserver = nullptr);
 };
 
 }
@@ -0,0 +1,785 @@
+/**
+ Copyright (c) 2015-present, Facebook, Inc.
+ All rights reserved.
+
+ This source code is licensed under the BSD-style license found in the
+ LICENSE file in the root directory of this source tree. An additional grant
+ of patent rights can be found in the PATENTS file in the same directory.
+ */
+
+#include <xcexecution/ActionCache.h>
+#include <dependency/BinaryDependencyInfo.h>
+#include <dependency/MakefileDependencyInfo.h>
+#include <libutil/Filesystem.h>
+#include <libutil/FSUtil.h>
+#include <libutil/Hash.h>
+#include <process/User.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <map>
+#include <sstream>
+#include <unordered_set>
+
+using xcexecution::ActionCache;
+using libutil::Filesystem;
+using libutil::FileHasher;
+using libutil::FSUtil;
+using libutil::Hash;
+using libutil::Permissions;
+
+ActionCache::Statistics::
+Statistics() :
+    hits     (0),
+    misses   (0),
+    stores   (0),
+    evictions(0)
+{
+}
+
+ActionCache::
+ActionCache(std::string const &path, uint64_t maximumSize) :
+    _path             (path),
+    _maximumSize      (maximumSize),
+    _fileHashesLoaded (false)
+{
+}
+
+ActionCache::
+~ActionCache()
+{
+}
+
+/*
+ * An entry in the cache for one invocation.
+ */
+class ActionCacheEntry {
+public:
+    class Output {
+    public:
+        std::string path;
+        std::string hash;
+        uint64_t    size;
+        bool        executable;
+    };
+
+    class Dependency {
+    public:
+        std::string path;
+        std::string hash;
+    };
+
+public:
+    uint64_t                used;
+    std::vector<Output>     outputs;
+    std::vector<Dependency> dependencies;
+
+public:
+    ActionCacheEntry() :
+        used(0)
+    {
+    }
+
+public:
+    std::string
+    serialize() const
+    {
+        std::string result;
+        result += "used " + std::to_string(used) + "\n";
+        for (Dependency const &dependency : dependencies) {
+            result += "dependency " + dependency.hash + " " + dependency.path + "\n";
+        }
+        for (Output const &output : outputs) {
+            result += "output " + output.hash + " " + std::to_string(output.size) + " " + (output.executable ? "x" : "-") + " " + output.path + "\n";
+        }
+        return result;
+    }
+
+    static ext::optional<ActionCacheEntry>
+    Deserialize(std::string const &contents)
+    {
+        ActionCacheEntry entry;
+
+        std::istringstream stream(contents);
+        std::string line;
+        while (std::getline(stream, line)) {
+            std::istringstream fields(line);
+            std::string type;
+            fields >> type;
+
+            if (type == "used") {
+                if (!(fields >> entry.used)) {
+                    return ext::nullopt;
+                }
+            } else if (type == "dependency") {
+                Dependency dependency;
+                if (!(fields >> dependency.hash) || fields.get() != ' ' || !std::getline(fields, dependency.path)) {
+                    return ext::nullopt;
+                }
+                entry.dependencies.push_back(dependency);
+            } else if (type == "output") {
+                Output output;
+                std::string executable;
+                if (!(fields >> output.hash >> output.size >> executable) || fields.get() != ' ' || !std::getline(fields, output.path)) {
+                    return ext::nullopt;
+                }
+                output.executable = (executable == "x");
+                entry.outputs.push_back(output);
+            } else {
+                return ext::nullopt;
+            }
+        }
+
+        return entry;
+    }
+};
+
+static std::string
+ActionCacheHash(uint8_t const *data, size_t size)
+{
+    return Hash::Data(data, size).hex();
+}
+
+static std::string
+ActionCacheHash(std::string const &contents)
+{
+    return Hash::String(contents).hex();
+}
+
+static ext::optional<std::string>
+ActionCacheFileHash(FileHasher *fileHasher, Filesystem const *filesystem, std::string const &path)
+{
+    ext::optional<Hash> hash = fileHasher->hash(filesystem, path);
+    if (!hash) {
+        return ext::nullopt;
+    }
+
+    return hash->hex();
+}
+
+/*
+ * Hash of an input, which can be a file or a directory of files.
+ */
+static ext::optional<std::string>
+ActionCacheInputHash(FileHasher *fileHasher, Filesystem const *filesystem, std::string const &path)
+{
+    ext::optional<Filesystem::Type> type = filesystem->type(path);
+    if (!type) {
+        return ext::nullopt;
+    }
+
+    switch (*type) {
+        case Filesystem::Type::File:
+            return ActionCacheFileHash(fileHasher, filesystem, path);
+        case Filesystem::Type::SymbolicLink:
+            if (ext::optional<std::string> target = filesystem->readSymbolicLink(path)) {
+                return ActionCacheHash("link " + *target);
+            } else {
+                return ext::nullopt;
+            }
+        case Filesystem::Type::Directory: {
+            std::map<std::string, Filesystem::Type> entries;
+            if (!filesystem->walkDirectory(path, true, [&](std::string const &name, Filesystem::Type type) {
+                entries.insert({ name, type });
+            })) {
+                return ext::nullopt;
+            }
+
+            std::string combined;
+            for (auto const &entry : entries) {
+                combined += entry.first + "\n";
+                if (entry.second != Filesystem::Type::Directory) {
+                    ext::optional<std::string> hash = ActionCacheInputHash(fileHasher, filesystem, path + "/" + entry.first);
+                    if (!hash) {
+                        return ext::nullopt;
+                    }
+                    combined += *hash + "\n";
+                }
+            }
+            return ActionCacheHash(combined);
+        }
+    }
+
+    return ext::nullopt;
+}
+
+static std::string
+ActionCacheEntryPath(std::string const &cache, std::string const &key)
+{
+    return cache + "/actions/" + key;
+}
+
+static std::string
+ActionCacheObjectPath(std::string const &cache, std::string const &hash)
+{
+    return cache + "/objects/" + hash;
+}
+
+static ext::optional<ActionCacheEntry>
+ActionCacheReadEntry(Filesystem const *filesystem, std::string const &path)
+{
+    std::vector<uint8_t> contents;
+    if (!filesystem->read(&contents, path)) {
+        return ext::nullopt;
+    }
+
+    return ActionCacheEntry::Deserialize(std::string(contents.begin(), contents.end()));
+}
+
+static bool
+ActionCacheWrite(Filesystem *filesystem, std::string const &path, uint8_t const *data, size_t size)
+{
+    if (!filesystem->createDirectory(FSUtil::GetDirectoryName(path), true)) {
+        return false;
+    }
+
+    /* Written atomically, so a partial write is never seen by another build. */
+    std::unique_ptr<Filesystem::Output> output = filesystem->openOutput(path);
+    if (output == nullptr || !output->write(data, size) || !output->commit()) {
+        return false;
+    }
+
+    return true;
+}
+
+static bool
+ActionCacheWriteEntry(Filesystem *filesystem, std::string const &path, ActionCacheEntry const &entry)
+{
+    std::string contents = entry.serialize();
+    return ActionCacheWrite(filesystem, path, reinterpret_cast<uint8_t const *>(contents.data()), contents.size());
+}
+
+/*
+ * Store an output file as an object, adding it to an entry.
+ */
+static bool
+ActionCacheStoreOutput(Filesystem *filesystem, std::string const &cache, std::string const &path, ActionCacheEntry *entry)
+{
+    if (path.find('\n') != std::string::npos || filesystem->type(path) == Filesystem::Type::Directory) {
+        return false;
+    }
+
+    /* Only files are stored. Read directly, as the tool wrote it behind any caching. */
+    std::vector<uint8_t> contents;
+    if (!filesystem->read(&contents, path)) {
+        return false;
+    }
+
+    ActionCacheEntry::Output output;
+    output.path = path;
+    output.hash = ActionCacheHash(contents.data(), contents.size());
+    output.size = contents.size();
+    output.executable = filesystem->isExecutable(path);
+
+    /* Identical contents are only stored once. */
+    std::string objectPath = ActionCacheObjectPath(cache, output.hash);
+    if (!filesystem->exists(objectPath)) {
+        if (!ActionCacheWrite(filesystem, objectPath, contents.data(), contents.size())) {
+            return false;
+        }
+    }
+
+    entry->outputs.push_back(output);
+    return true;
+}
+
+static uint64_t
+ActionCacheNow()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+bool ActionCache::
+Cacheable(pbxbuild::Tool::Invocation const &invocation)
+{
+    /*
+     * Without inputs, the outputs could depend on anything. Phony inputs
+     * may not exist, so they can't be hashed either.
+     */
+    if (invocation.outputs().empty() || !invocation.phonyInputs().empty()) {
+        return false;
+    }
+    if (invocation.inputs().empty() && invocation.inputDependencies().empty()) {
+        return false;
+    }
+
+    return true;
+}
+
+ext::optional<std::string> ActionCache::
+key(Filesystem const *filesystem, pbxbuild::Tool::Invocation const &invocation, std::string const &executable)
+{
+    if (!Cacheable(invocation)) {
+        return ext::nullopt;
+    }
+
+    /* Remembered file hashes avoid reading unchanged inputs. */
+    if (!_fileHashesLoaded) {
+        _fileHasher.load(filesystem, _path + "/hashes");
+        _fileHashesLoaded = true;
+    }
+
+    std::string data;
+
+    /* The executable itself can change, such as with a new compiler version. */
+    auto it = _executableHashes.find(executable);
+    if (it == _executableHashes.end()) {
+        ext::optional<std::string> hash = ActionCacheFileHash(&_fileHasher, filesystem, executable);
+        if (!hash) {
+            /* Builtin tools are part of this executable. */
+            hash = std::string();
+        }
+        it = _executableHashes.insert({ executable, *hash }).first;
+    }
+    data += "executable " + executable + " " + it->second + "\n";
+
+    data += "directory " + invocation.workingDirectory() + "\n";
+    for (std::string const &argument : invocation.arguments()) {
+        data += "argument " + std::to_string(argument.size()) + " " + argument + "\n";
+    }
+
+    /* Sort for a stable key. */
+    std::unordered_map<std::string, std::string> fullEnvironment = invocation.fullEnvironment();
+    std::map<std::string, std::string> environment = std::map<std::string, std::string>(fullEnvironment.begin(), fullEnvironment.end());
+    for (auto const &variable : environment) {
+        data += "environment " + std::to_string(variable.first.size()) + " " + variable.first + "=" + std::to_string(variable.second.size()) + " " + variable.second + "\n";
+    }
+
+    std::vector<std::string> inputs;
+    inputs.insert(inputs.end(), invocation.inputs().begin(), invocation.inputs().end());
+    inputs.insert(inputs.end(), invocation.inputDependencies().begin(), invocation.inputDependencies().end());
+    for (std::string const &input : inputs) {
+        std::string path = FSUtil::ResolveRelativePath(input, invocation.workingDirectory());
+        ext::optional<std::string> hash = ActionCacheInputHash(&_fileHasher, filesystem, path);
+        if (!hash) {
+            return ext::nullopt;
+        }
+        data += "input " + *hash + " " + path + "\n";
+    }
+
+    for (std::string const &output : invocation.outputs()) {
+        data += "output " + FSUtil::ResolveRelativePath(output, invocation.workingDirectory()) + "\n";
+    }
+
+    return ActionCacheHash(data);
+}
+
+bool ActionCache::
+restore(Filesystem *filesystem, std::string const &key, pbxbuild::Tool::Invocation const &invocation)
+{
+    std::string entryPath = ActionCacheEntryPath(_path, key);
+
+    ext::optional<ActionCacheEntry> entry = ActionCacheReadEntry(filesystem, entryPath);
+    if (!entry) {
+        _statistics.misses++;
+        return false;
+    }
+
+    /* Dependencies found when the invocation ran must not have changed. */
+    for (ActionCacheEntry::Dependency const &dependency : entry->dependencies) {
+        if (ActionCacheFileHash(&_fileHasher, filesystem, dependency.path) != dependency.hash) {
+            _statistics.misses++;
+            return false;
+        }
+    }
+
+    for (ActionCacheEntry::Output const &output : entry->outputs) {
+        if (filesystem->type(ActionCacheObjectPath(_path, output.hash)) != Filesystem::Type::File) {
+            _statistics.misses++;
+            return false;
+        }
+    }
+
+    for (ActionCacheEntry::Output const &output : entry->outputs) {
+        if (!filesystem->createDirectory(FSUtil::GetDirectoryName(output.path), true)) {
+            return false;
+        }
+
+        /*
+         * Share storage with the cached object where possible. Unlike a hard
+         * link, a tool later changing the output in place can't change the
+         * cached object.
+         */
+        if (!filesystem->cloneFile(ActionCacheObjectPath(_path, output.hash), output.path)) {
+            return false;
+        }
+
+        if (output.executable) {
+            Permissions permissions = Permissions({ Permissions::Permission::Execute }, { Permissions::Permission::Execute }, { Permissions::Permission::Execute });
+            if (!filesystem->writeFilePermissions(output.path, Permissions::Operation::Add, permissions)) {
+                return false;
+            }
+        }
+    }
+
+    /* Mark as recently used for eviction. */
+    entry->used = ActionCacheNow();
+    if (!ActionCacheWriteEntry(filesystem, entryPath, *entry)) {
+        return false;
+    }
+
+    _statistics.hits++;
+    return true;
+}
+
+bool ActionCache::
+store(Filesystem *filesystem, std::string const &key, pbxbuild::Tool::Invocation const &invocation)
+{
+    ActionCacheEntry entry;
+    entry.used = ActionCacheNow();
+
+    std::unordered_set<std::string> outputs;
+    for (std::string const &output : invocation.outputs()) {
+        outputs.insert(FSUtil::ResolveRelativePath(output, invocation.workingDirectory()));
+    }
+
+    /*
+     * Record dependencies the invocation found as it ran, so a cached
+     * result is not used after they change.
+     */
+    std::vector<std::string> dependencyInfoPaths;
+    for (pbxbuild::Tool::Invocation::DependencyInfo const &dependencyInfo : invocation.dependencyInfo()) {
+        std::string path = FSUtil::ResolveRelativePath(dependencyInfo.path(), invocation.workingDirectory());
+
+        std::vector<std::string> inputs;
+        if (dependencyInfo.format() == dependency::DependencyInfoFormat::Binary) {
+            std::vector<uint8_t> contents;
+            if (!filesystem->read(&contents, path)) {
+                return false;
+            }
+
+            auto binaryInfo = dependency::BinaryDependencyInfo::Deserialize(contents);
+            if (!binaryInfo) {
+                return false;
+            }
+            inputs = binaryInfo->dependencyInfo().inputs();
+        } else if (dependencyInfo.format() == dependency::DependencyInfoFormat::Makefile) {
+            std::vector<uint8_t> contents;
+            if (!filesystem->read(&contents, path)) {
+                return false;
+            }
+
+            auto makefileInfo = dependency::MakefileDependencyInfo::Deserialize(std::string(contents.begin(), contents.end()));
+            if (!makefileInfo) {
+                return false;
+            }
+            for (dependency::DependencyInfo const &info : makefileInfo->dependencyInfo()) {
+                inputs.insert(inputs.end(), info.inputs().begin(), info.inputs().end());
+            }
+        } else {
+            /* Directory dependency info is for an input, which is already hashed. */
+            continue;
+        }
+        dependencyInfoPaths.push_back(path);
+
+        for (std::string const &input : inputs) {
+            std::string inputPath = FSUtil::ResolveRelativePath(input, invocation.workingDirectory());
+            if (outputs.find(inputPath) != outputs.end()) {
+                continue;
+            }
+
+            ext::optional<std::string> hash = ActionCacheFileHash(&_fileHasher, filesystem, inputPath);
+            if (!hash) {
+                /* Can't tell if it changes, so don't cache. */
+                return false;
+            }
+            entry.dependencies.push_back({ inputPath, *hash });
+        }
+    }
+
+    for (std::string const &output : invocation.outputs()) {
+        if (!ActionCacheStoreOutput(filesystem, _path, FSUtil::ResolveRelativePath(output, invocation.workingDirectory()), &entry)) {
+            return false;
+        }
+    }
+
+    /*
+     * Dependency info files are outputs too. Ninja reads them after the
+     * invocation, including when it is restored from the cache instead.
+     */
+    for (std::string const &path : dependencyInfoPaths) {
+        if (outputs.find(path) == outputs.end()) {
+            if (!ActionCacheStoreOutput(filesystem, _path, path, &entry)) {
+                return false;
+            }
+        }
+    }
+
+    if (!ActionCacheWriteEntry(filesystem, ActionCacheEntryPath(_path, key), entry)) {
+        return false;
+    }
+
+    _statistics.stores++;
+    return true;
+}
+
+bool ActionCache::
+trim(Filesystem *filesystem)
+{
+    /*
+     * Remember hashes other processes found during the build. Hashes known
+     * here take precedence, then those saved by other processes, then
+     * those remembered before: a stale hash only costs reading the file.
+     */
+    std::vector<std::string> pending;
+    std::string pendingPath = _path + "/hashes.pending";
+    if (filesystem->type(pendingPath) == Filesystem::Type::Directory) {
+        filesystem->readDirectory(pendingPath, false, [&](std::string const &name) {
+            /* Skip files still being written. */
+            if (name.find('.') == std::string::npos) {
+                pending.push_back(pendingPath + "/" + name);
+            }
+        });
+    }
+
+    for (std::string const &path : pending) {
+        _fileHasher.load(filesystem, path);
+    }
+
+    if (_fileHashesLoaded || !pending.empty()) {
+        if (!_fileHashesLoaded) {
+            _fileHasher.load(filesystem, _path + "/hashes");
+            _fileHashesLoaded = true;
+        }
+
+        if (!filesystem->createDirectory(_path, true) || !_fileHasher.save(filesystem, _path + "/hashes")) {
+            return false;
+        }
+    }
+
+    /* Only remove what was loaded; other builds may be saving more. */
+    for (std::string const &path : pending) {
+        filesystem->removeFile(path);
+    }
+
+    std::vector<std::pair<std::string, ActionCacheEntry>> entries;
+    std::string actionsPath = _path + "/actions";
+    if (filesystem->type(actionsPath) == Filesystem::Type::Directory) {
+        filesystem->walkDirectory(actionsPath, false, [&](std::string const &name, Filesystem::Type type) {
+            if (type == Filesystem::Type::File) {
+                std::string path = actionsPath + "/" + name;
+                if (ext::optional<ActionCacheEntry> entry = ActionCacheReadEntry(filesystem, path)) {
+                    entries.push_back({ path, *entry });
+                } else {
+                    /* Unreadable entries are not useful. */
+                    filesystem->removeFile(path);
+                }
+            }
+        });
+    }
+
+    /*
+     * Count the size of each object once, however many entries use it.
+     */
+    std::unordered_map<std::string, std::pair<uint64_t, size_t>> objects;
+    uint64_t size = 0;
+    for (auto const &entry : entries) {
+        for (ActionCacheEntry::Output const &output : entry.second.outputs) {
+            auto it = objects.find(output.hash);
+            if (it == objects.end()) {
+                objects.insert({ output.hash, { output.size, 1 } });
+                size += output.size;
+            } else {
+                it->second.second++;
+            }
+        }
+    }
+
+    /*
+     * Evict the least recently used entries first.
+     */
+    std::sort(entries.begin(), entries.end(), [](std::pair<std::string, ActionCacheEntry> const &a, std::pair<std::string, ActionCacheEntry> const &b) {
+        return a.second.used < b.second.used || (a.second.used == b.second.used && a.first < b.first);
+    });
+
+    bool success = true;
+    for (auto const &entry : entries) {
+        if (size <= _maximumSize) {
+            break;
+        }
+
+        if (!filesystem->removeFile(entry.first)) {
+            success = false;
+            continue;
+        }
+        _statistics.evictions++;
+
+        for (ActionCacheEntry::Output const &output : entry.second.outputs) {
+            auto it = objects.find(output.hash);
+            if (it != objects.end() && --it->second.second == 0) {
+                size -= it->second.first;
+                objects.erase(it);
+            }
+        }
+    }
+
+    /*
+     * Remove objects that no remaining entry uses.
+     */
+    std::string objectsPath = _path + "/objects";
+    if (filesystem->type(objectsPath) == Filesystem::Type::Directory) {
+        std::vector<std::string> unused;
+        filesystem->walkDirectory(objectsPath, false, [&](std::string const &name, Filesystem::Type type) {
+            if (type == Filesystem::Type::File && objects.find(name) == objects.end()) {
+                unused.push_back(objectsPath + "/" + name);
+            }
+        });
+
+        for (std::string const &path : unused) {
+            if (!filesystem->removeFile(path)) {
+                success = false;
+            }
+        }
+    }
+
+    return success;
+}
+
+bool ActionCache::
+saveHashes(Filesystem *filesystem, std::string const &key)
+{
+    std::string pendingPath = _path + "/hashes.pending";
+    if (!filesystem->createDirectory(pendingPath, true)) {
+        return false;
+    }
+
+    /* Hashes loaded from the cache are already remembered there. */
+    return _fileHasher.save(filesystem, pendingPath + "/" + key, true);
+}
+
+/*
+ * Fields in an invocation description, each on its own line as a name and
+ * a value prefixed by its length, as values can contain any character.
+ */
+static void
+ActionCacheWriteField(std::string *result, std::string const &name, std::string const &value)
+{
+    *result += name + " " + std::to_string(value.size()) + " " + value + "\n";
+}
+
+static bool
+ActionCacheReadField(std::string const &contents, size_t *offset, std::string *name, std::string *value)
+{
+    size_t space = contents.find(' ', *offset);
+    if (space == std::string::npos) {
+        return false;
+    }
+    *name = contents.substr(*offset, space - *offset);
+
+    size_t start = contents.find(' ', space + 1);
+    if (start == std::string::npos) {
+        return false;
+    }
+
+    char *end = nullptr;
+    std::string length = contents.substr(space + 1, start - space - 1);
+    unsigned long size = std::strtoul(length.c_str(), &end, 10);
+    if (length.empty() || *end != '\0' || size > contents.size() - start - 1) {
+        return false;
+    }
+    *value = contents.substr(start + 1, size);
+
+    *offset = start + 1 + size;
+    if (*offset >= contents.size() || contents[*offset] != '\n') {
+        return false;
+    }
+    *offset += 1;
+
+    return true;
+}
+
+std::string ActionCache::
+SerializeInvocation(pbxbuild::Tool::Invocation const &invocation, std::string const &executable)
+{
+    std::string result;
+    ActionCacheWriteField(&result, "executable", executable);
+    ActionCacheWriteField(&result, "directory", invocation.workingDirectory());
+    for (std::string const &argument : invocation.arguments()) {
+        ActionCacheWriteField(&result, "argument", argument);
+    }
+    for (auto const &variable : invocation.fullEnvironment()) {
+        ActionCacheWriteField(&result, "environment", variable.first + "=" + variable.second);
+    }
+    for (std::string const &input : invocation.inputs()) {
+        ActionCacheWriteField(&result, "input", input);
+    }
+    for (std::string const &input : invocation.inputDependencies()) {
+        ActionCacheWriteField(&result, "input-dependency", input);
+    }
+    for (std::string const &input : invocation.phonyInputs()) {
+        ActionCacheWriteField(&result, "phony-input", input);
+    }
+    for (std::string const &output : invocation.outputs()) {
+        ActionCacheWriteField(&result, "output", output);
+    }
+    for (pbxbuild::Tool::Invocation::DependencyInfo const &dependencyInfo : invocation.dependencyInfo()) {
+        std::string format;
+        dependency::DependencyInfoFormats::Name(dependencyInfo.format(), &format);
+        ActionCacheWriteField(&result, "dependency-info", format + ":" + dependencyInfo.path());
+    }
+    return result;
+}
+
+bool ActionCache::
+DeserializeInvocation(std::string const &contents, pbxbuild::Tool::Invocation *invocation, std::string *executable)
+{
+    size_t offset = 0;
+    while (offset < contents.size()) {
+        std::string name;
+        std::string value;
+        if (!ActionCacheReadField(contents, &offset, &name, &value)) {
+            return false;
+        }
+
+        if (name == "executable") {
+            *executable = value;
+        } else if (name == "directory") {
+            invocation->workingDirectory() = value;
+        } else if (name == "argument") {
+            invocation->arguments().push_back(value);
+        } else if (name == "environment") {
+            size_t equals = value.find('=');
+            if (equals == std::string::npos) {
+                return false;
+            }
+            invocation->environment()[value.substr(0, equals)] = value.substr(equals + 1);
+        } else if (name == "input") {
+            invocation->inputs().push_back(value);
+        } else if (name == "input-dependency") {
+            invocation->inputDependencies().push_back(value);
+        } else if (name == "phony-input") {
+            invocation->phonyInputs().push_back(value);
+        } else if (name == "output") {
+            invocation->outputs().push_back(value);
+        } else if (name == "dependency-info") {
+            size_t colon = value.find(':');
+            dependency::DependencyInfoFormat format;
+            if (colon == std::string::npos || !dependency::DependencyInfoFormats::Parse(value.substr(0, colon), &format)) {
+                return false;
+            }
+            invocation->dependencyInfo().push_back(pbxbuild::Tool::Invocation::DependencyInfo(format, value.substr(colon + 1)));
+        } else {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+ext::optional<std::string> ActionCache::
+DefaultPath(process::User const *user)
+{
+    if (ext::optional<std::string> home = user->userHomeDirectory()) {
+        return *home + "/.xcbuild/cache";
+    }
+
+    return ext::nullopt;
+}
+
+uint64_t ActionCache::
+DefaultMaximumSize()
+{
+    /* 10 GiB. */
+    return 10ull * 1024 * 1024 * 1024;
+}
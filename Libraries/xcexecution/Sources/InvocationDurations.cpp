@@ -0,0 +1,361 @@
+/**
+ Copyright (c) 2015-present, Facebook, Inc.
+ All rights reserved.
+
+ This source code is licensed under the BSD-style license found in the
+ LICENSE file in the root directory of this source tree. An additional grant
+ of patent rights can be found in the PATENTS file in the same directory.
+ */
+
+#include <xcexecution/InvocationDurations.h>
+#include <libutil/Filesystem.h>
+#include <libutil/Interned.h>
+
+#include <algorithm>
+#include <functional>
+#include <map>
+#include <queue>
+#include <sstream>
+
+using xcexecution::InvocationDurations;
+using libutil::Filesystem;
+using libutil::Hash;
+
+static char const InvocationDurationsHeader[] = "invocation-durations 1";
+
+InvocationDurations::
+InvocationDurations()
+{
+}
+
+InvocationDurations::
+~InvocationDurations()
+{
+}
+
+ext::optional<uint64_t> InvocationDurations::
+duration(pbxbuild::Tool::Invocation const &invocation) const
+{
+    if (invocation.outputs().empty()) {
+        return ext::nullopt;
+    }
+
+    auto it = _entries.find(invocation.outputs().front());
+    if (it == _entries.end() || it->second.command != CommandHash(invocation)) {
+        return ext::nullopt;
+    }
+
+    return it->second.milliseconds;
+}
+
+void InvocationDurations::
+record(pbxbuild::Tool::Invocation const &invocation, uint64_t milliseconds)
+{
+    if (invocation.outputs().empty()) {
+        return;
+    }
+
+    Entry entry;
+    entry.command = CommandHash(invocation);
+    entry.milliseconds = milliseconds;
+    _entries[invocation.outputs().front()] = entry;
+}
+
+/*
+ * For each invocation, the invocations using its outputs.
+ */
+static std::vector<std::vector<size_t>>
+InvocationDurationsDependents(std::vector<pbxbuild::Tool::Invocation> const &invocations)
+{
+    /* Interned paths hash by identity, so lookups don't rehash the path. */
+    std::unordered_map<libutil::Path::Interned, size_t> outputToInvocation;
+    for (size_t i = 0; i < invocations.size(); i++) {
+        for (libutil::Path::Interned const &output : invocations[i].outputs()) {
+            outputToInvocation.insert({ output, i });
+        }
+    }
+
+    std::vector<std::vector<size_t>> dependents = std::vector<std::vector<size_t>>(invocations.size());
+    for (size_t i = 0; i < invocations.size(); i++) {
+        for (std::vector<libutil::Path::Interned> const *paths : {
+            &invocations[i].inputs(),
+            &invocations[i].phonyInputs(),
+            &invocations[i].inputDependencies(),
+        }) {
+            for (libutil::Path::Interned const &path : *paths) {
+                auto it = outputToInvocation.find(path);
+                if (it != outputToInvocation.end()) {
+                    dependents[it->second].push_back(i);
+                }
+            }
+        }
+    }
+
+    return dependents;
+}
+
+/*
+ * Invocations grouped by phase priority, earliest phase first.
+ */
+static std::map<uint32_t, std::vector<size_t>>
+InvocationDurationsPhases(std::vector<pbxbuild::Tool::Invocation> const &invocations)
+{
+    std::map<uint32_t, std::vector<size_t>> phases;
+    for (size_t i = 0; i < invocations.size(); i++) {
+        phases[invocations[i].priority()].push_back(i);
+    }
+    return phases;
+}
+
+static std::vector<uint64_t>
+InvocationDurationsWeights(
+    InvocationDurations const *durations,
+    std::vector<pbxbuild::Tool::Invocation> const &invocations,
+    std::vector<std::vector<size_t>> const &dependents)
+{
+    /*
+     * Estimate invocations that haven't run before as average ones. Every
+     * invocation counts for something, so longer chains still weigh more.
+     */
+    std::vector<ext::optional<uint64_t>> known;
+    uint64_t total = 0;
+    size_t count = 0;
+    for (pbxbuild::Tool::Invocation const &invocation : invocations) {
+        known.push_back(durations->duration(invocation));
+        if (known.back()) {
+            total += *known.back();
+            count++;
+        }
+    }
+
+    uint64_t average = (count > 0 ? total / count : 0);
+    std::vector<uint64_t> estimates;
+    for (ext::optional<uint64_t> const &duration : known) {
+        estimates.push_back(std::max<uint64_t>(duration.value_or(average), 1));
+    }
+
+    /*
+     * Each phase waits for the one before it, so the heaviest invocation in
+     * a phase is followed by every invocation in earlier phases. Weigh the
+     * latest phase first, and within a phase, dependents before the
+     * invocations they depend on.
+     */
+    enum class State : uint8_t {
+        Unvisited,
+        Visiting,
+        Weighed,
+    };
+
+    std::vector<uint64_t> weights = std::vector<uint64_t>(invocations.size(), 0);
+    std::vector<State> states = std::vector<State>(invocations.size(), State::Unvisited);
+
+    std::map<uint32_t, std::vector<size_t>> phases = InvocationDurationsPhases(invocations);
+    uint64_t after = 0;
+    for (auto phase = phases.rbegin(); phase != phases.rend(); ++phase) {
+        uint64_t heaviest = 0;
+
+        for (size_t root : phase->second) {
+            if (states[root] != State::Unvisited) {
+                continue;
+            }
+
+            /* Iterative, as chains of invocations can be long. */
+            std::vector<std::pair<size_t, size_t>> stack = { { root, 0 } };
+            states[root] = State::Visiting;
+
+            while (!stack.empty()) {
+                size_t node = stack.back().first;
+                if (stack.back().second < dependents[node].size()) {
+                    size_t dependent = dependents[node][stack.back().second++];
+
+                    /* Dependents in later phases are already weighed; cycles are ignored. */
+                    if (states[dependent] == State::Unvisited && invocations[dependent].priority() == phase->first) {
+                        states[dependent] = State::Visiting;
+                        stack.push_back({ dependent, 0 });
+                    }
+                    continue;
+                }
+
+                uint64_t longest = after;
+                for (size_t dependent : dependents[node]) {
+                    if (states[dependent] == State::Weighed) {
+                        longest = std::max(longest, weights[dependent]);
+                    }
+                }
+
+                weights[node] = estimates[node] + longest;
+                states[node] = State::Weighed;
+                heaviest = std::max(heaviest, weights[node]);
+                stack.pop_back();
+            }
+        }
+
+        after = heaviest;
+    }
+
+    return weights;
+}
+
+std::vector<uint64_t> InvocationDurations::
+weights(std::vector<pbxbuild::Tool::Invocation> const &invocations) const
+{
+    return InvocationDurationsWeights(this, invocations, InvocationDurationsDependents(invocations));
+}
+
+ext::optional<std::vector<size_t>> InvocationDurations::
+schedule(std::vector<pbxbuild::Tool::Invocation> const &invocations) const
+{
+    std::vector<std::vector<size_t>> dependents = InvocationDurationsDependents(invocations);
+    std::vector<uint64_t> weights = InvocationDurationsWeights(this, invocations, dependents);
+
+    std::vector<size_t> remaining = std::vector<size_t>(invocations.size(), 0);
+    for (std::vector<size_t> const &nodeDependents : dependents) {
+        for (size_t dependent : nodeDependents) {
+            remaining[dependent]++;
+        }
+    }
+
+    /* Heaviest first, then in the original order for a stable schedule. */
+    std::function<bool(size_t, size_t)> lighter = [&weights](size_t a, size_t b) -> bool {
+        return weights[a] < weights[b] || (weights[a] == weights[b] && a > b);
+    };
+
+    std::vector<size_t> result;
+    result.reserve(invocations.size());
+
+    for (auto const &phase : InvocationDurationsPhases(invocations)) {
+        std::priority_queue<size_t, std::vector<size_t>, std::function<bool(size_t, size_t)>> ready(lighter);
+        for (size_t node : phase.second) {
+            if (remaining[node] == 0) {
+                ready.push(node);
+            }
+        }
+
+        size_t scheduled = 0;
+        while (!ready.empty()) {
+            size_t node = ready.top();
+            ready.pop();
+
+            result.push_back(node);
+            scheduled++;
+
+            /* Dependents in later phases become ready when their phase starts. */
+            for (size_t dependent : dependents[node]) {
+                if (--remaining[dependent] == 0 && invocations[dependent].priority() == phase.first) {
+                    ready.push(dependent);
+                }
+            }
+        }
+
+        /* Anything left waits on itself or on a later phase. */
+        if (scheduled != phase.second.size()) {
+            return ext::nullopt;
+        }
+    }
+
+    return result;
+}
+
+bool InvocationDurations::
+load(Filesystem const *filesystem, std::string const &path)
+{
+    std::vector<uint8_t> contents;
+    if (!filesystem->read(&contents, path)) {
+        return false;
+    }
+
+    std::istringstream stream(std::string(contents.begin(), contents.end()));
+
+    std::string header;
+    if (!std::getline(stream, header) || header != InvocationDurationsHeader) {
+        return false;
+    }
+
+    std::unordered_map<std::string, Entry> entries;
+    std::string line;
+    while (std::getline(stream, line)) {
+        std::istringstream fields(line);
+
+        std::string hex;
+        Entry entry;
+        if (!(fields >> hex >> entry.milliseconds)) {
+            return false;
+        }
+
+        ext::optional<Hash> hash = Hash::Parse(hex);
+        if (!hash) {
+            return false;
+        }
+        entry.command = *hash;
+
+        /* The output is the rest of the line, after one space. */
+        if (fields.get() != ' ') {
+            return false;
+        }
+
+        std::string output;
+        std::getline(fields, output);
+        if (output.empty()) {
+            return false;
+        }
+
+        entries[output] = entry;
+    }
+
+    for (auto const &entry : entries) {
+        _entries[entry.first] = entry.second;
+    }
+
+    return true;
+}
+
+bool InvocationDurations::
+save(Filesystem *filesystem, std::string const &path) const
+{
+    std::string contents = std::string(InvocationDurationsHeader) + "\n";
+    for (auto const &entry : _entries) {
+        if (entry.first.find('\n') != std::string::npos) {
+            continue;
+        }
+
+        contents += entry.second.command.hex() + " " + std::to_string(entry.second.milliseconds) + " " + entry.first + "\n";
+    }
+
+    std::unique_ptr<Filesystem::Output> output = filesystem->openOutput(path);
+    if (output == nullptr) {
+        return false;
+    }
+
+    if (!output->write(reinterpret_cast<uint8_t const *>(contents.data()), contents.size())) {
+        return false;
+    }
+
+    return output->commit();
+}
+
+std::string InvocationDurations::
+Path(std::string const &intermediatesDirectory)
+{
+    return intermediatesDirectory + "/" + ".xcbuild-invocation-durations";
+}
+
+Hash InvocationDurations::
+CommandHash(pbxbuild::Tool::Invocation const &invocation)
+{
+    Hash::Stream stream;
+
+    if (ext::optional<pbxbuild::Tool::Invocation::Executable> const &executable = invocation.executable()) {
+        if (ext::optional<std::string> const &builtin = executable->builtin()) {
+            stream.update("builtin " + *builtin + "\n");
+        } else if (ext::optional<std::string> const &external = executable->external()) {
+            stream.update("external " + *external + "\n");
+        }
+    }
+
+    stream.update("directory " + invocation.workingDirectory() + "\n");
+    for (std::string const &argument : invocation.arguments()) {
+        stream.update("argument " + std::to_string(argument.size()) + " " + argument + "\n");
+    }
+
+    return stream.finish();
+}
@@ -14,31 +14,49 @@
 #include <pbxbuild/Phase/PhaseInvocations.h>
 #include <ninja/Writer.h>
 #include <ninja/Value.h>
+#include <dependency/DependencyInfoConversion.h>
 #include <plist/Data.h>
+#include <builtin/Client.h>
+#include <libutil/CachingFilesystem.h>
 #include <libutil/Escape.h>
 #include <libutil/Filesystem.h>
 #include <libutil/FSUtil.h>
+#include <libutil/Interned.h>
 #include <process/Context.h>
 #include <process/MemoryContext.h>
 #include <process/Launcher.h>
 #include <process/User.h>
-#include <libutil/md5.h>
+#include <libutil/Hash.h>
 
+#include <algorithm>
+#include <cctype>
+#include <cstdlib>
 #include <sstream>
-#include <iomanip>
+#include <thread>
 
 #include <sys/types.h>
 #include <sys/stat.h>
 
 using xcexecution::NinjaExecutor;
+using xcexecution::ActionCache;
 using xcexecution::Parameters;
+using xcexecution::InvocationDurations;
 using libutil::Escape;
 using libutil::Filesystem;
 using libutil::FSUtil;
 
 NinjaExecutor::
-NinjaExecutor(std::shared_ptr<xcformatter::Formatter> const &formatter, bool dryRun, bool generate) :
-    Executor(formatter, dryRun, generate)
+NinjaExecutor(
+    std::shared_ptr<xcformatter::Formatter> const &formatter,
+    bool dryRun,
+    bool generate,
+    std::shared_ptr<ActionCache> const &actionCache,
+    ext::optional<size_t> const &jobs,
+    std::shared_ptr<process::Jobserver> const &jobserver) :
+    Executor    (formatter, dryRun, generate),
+    _actionCache(actionCache),
+    _jobs       (jobs),
+    _jobserver  (jobserver)
 {
 }
 
@@ -77,6 +95,22 @@ TargetPhaseNinjaFinish(pbxproj::PBX::Target::shared_ptr const &target, int phase
     return "finish-target-" + target->name() + "-phase-priority-" + std::to_string(phasePriority);
 }
 
+static bool
+NinjaDependencyInfoNeedsConversion(pbxbuild::Tool::Invocation const &invocation, std::string const &intermediatesDirectory)
+{
+    /*
+     * Ninja reads a single Makefile-format dependency file natively, but
+     * resolves relative paths in it against its own directory. Tools run
+     * in another directory could write paths relative to theirs, so their
+     * dependency info is converted, which resolves against the tool's.
+     */
+    if (!(invocation.dependencyInfo().size() == 1 && invocation.dependencyInfo().front().format() == dependency::DependencyInfoFormat::Makefile)) {
+        return true;
+    }
+
+    return FSUtil::NormalizePath(invocation.workingDirectory()) != FSUtil::NormalizePath(intermediatesDirectory);
+}
+
 static std::string
 TargetNinjaPath(pbxproj::PBX::Target::shared_ptr const &target, pbxbuild::Target::Environment const &targetEnvironment)
 {
@@ -97,6 +131,80 @@ NinjaRuleName()
     return "invoke";
 }
 
+static std::string
+NinjaToolRuleName(std::string const &executablePath, size_t index)
+{
+    /* Name rules after the tool so the Ninja file stays readable. */
+    std::string name;
+    for (char c : FSUtil::GetBaseName(executablePath)) {
+        name += (isalnum(static_cast<unsigned char>(c)) || c == '-' || c == '_' || c == '.' ? c : '_');
+    }
+
+    return name + "-" + std::to_string(index);
+}
+
+static std::string
+NinjaLinkPoolName()
+{
+    return "link";
+}
+
+static std::string
+NinjaSwiftPoolName()
+{
+    return "swift";
+}
+
+static int
+NinjaPoolDepth(unsigned int fraction)
+{
+    /*
+     * Ninja defaults to slightly more jobs than there are processors; allow
+     * a fraction of that for tools that can each use gigabytes of memory.
+     */
+    unsigned int concurrency = std::thread::hardware_concurrency();
+    return std::max(1, static_cast<int>(concurrency / fraction));
+}
+
+static ext::optional<std::string>
+NinjaInvocationPool(pbxbuild::Tool::Invocation const &invocation, std::string const &executablePath)
+{
+    std::string name = FSUtil::GetBaseName(executablePath);
+
+    if (name == "ld") {
+        return NinjaLinkPoolName();
+    } else if (name == "swift" || name == "swiftc") {
+        return NinjaSwiftPoolName();
+    } else if (name == "clang" || name == "clang++" || name == "cc" || name == "c++") {
+        /* Linking through the compiler driver: only the linker writes binary dependency info. */
+        for (pbxbuild::Tool::Invocation::DependencyInfo const &dependencyInfo : invocation.dependencyInfo()) {
+            if (dependencyInfo.format() == dependency::DependencyInfoFormat::Binary) {
+                return NinjaLinkPoolName();
+            }
+        }
+    }
+
+    return ext::nullopt;
+}
+
+static bool
+NinjaSupportsResponseFile(std::string const &executablePath)
+{
+    /*
+     * Tools known to read arguments from "@file", all with LLVM's quoting.
+     * Not the linker or libtool: they either don't read response files or
+     * split them differently, so they get their arguments directly.
+     */
+    std::string name = FSUtil::GetBaseName(executablePath);
+    return (name == "clang" || name == "clang++" || name == "cc" || name == "c++" ||
+            name == "swift" || name == "swiftc");
+}
+
+/*
+ * Arguments longer than this are passed in a response file, if supported.
+ */
+static size_t const NinjaResponseFileThreshold = 8 * 1024;
+
 static std::string
 NinjaDescription(std::string const &description)
 {
@@ -112,19 +220,7 @@ NinjaDescription(std::string const &description)
 static std::string
 NinjaHash(char const *data, size_t size)
 {
-    md5_state_t state;
-    md5_init(&state);
-    md5_append(&state, reinterpret_cast<const md5_byte_t *>(data), size);
-    uint8_t digest[16];
-    md5_finish(&state, reinterpret_cast<md5_byte_t *>(&digest));
-
-    std::ostringstream ss;
-    ss << std::hex << std::setfill('0');
-    for (uint8_t c : digest) {
-        ss << std::setw(2) << static_cast<int>(c);
-    }
-
-    return ss.str();
+    return libutil::Hash::Data(data, size).hex();
 }
 
 static ext::optional<std::string>
@@ -203,13 +299,13 @@ NinjaInvocationPhonyOutput(pbxbuild::Tool::Invocation const &invocation)
     return ".ninja-phony-output-" + NinjaHash(key.data(), key.size());
 }
 
-static std::vector<std::string>
+static std::vector<libutil::Path::Interned>
 NinjaInvocationOutputs(pbxbuild::Tool::Invocation const &invocation)
 {
-    std::vector<std::string> outputs;
+    std::vector<libutil::Path::Interned> outputs;
 
     if (!invocation.outputs().empty()) {
-        outputs.insert(outputs.end(), invocation.outputs().begin(), invocation.outputs().end());
+        outputs = invocation.outputs();
     } else {
         outputs.push_back(NinjaInvocationPhonyOutput(invocation));
     }
@@ -280,20 +376,49 @@ WriteNinjaRegenerate(
     });
 }
 
-static bool
-WriteNinja(Filesystem *filesystem, ninja::Writer const &writer, std::string const &path)
+/*
+ * Streams Ninja output into a file as it is written, rather than
+ * holding the whole file in memory.
+ */
+class NinjaOutputSink : public ninja::Writer::Sink {
+private:
+    Filesystem::Output *_output;
+
+public:
+    explicit NinjaOutputSink(Filesystem::Output *output) :
+        _output(output)
+    {
+    }
+
+public:
+    virtual bool write(char const *data, size_t size)
+    {
+        return _output->write(reinterpret_cast<uint8_t const *>(data), size);
+    }
+};
+
+static std::unique_ptr<Filesystem::Output>
+OpenNinja(Filesystem *filesystem, std::string const &path)
 {
     if (!filesystem->createDirectory(FSUtil::GetDirectoryName(path), true)) {
-        return false;
+        return nullptr;
     }
 
-    std::string contents = writer.serialize();
-    std::vector<uint8_t> copy = std::vector<uint8_t>(contents.begin(), contents.end());
-    if (!filesystem->write(copy, path)) {
+    return filesystem->openOutput(path);
+}
+
+static bool
+WriteNinja(ninja::Writer *writer, Filesystem::Output *output)
+{
+    /*
+     * Write out anything still buffered, then replace the previous
+     * Ninja file. If anything failed, the previous file is kept.
+     */
+    if (!writer->flush()) {
         return false;
     }
 
-    return true;
+    return output->commit();
 }
 
 static bool
@@ -304,7 +429,8 @@ WriteAuxiliaryFiles(Filesystem *filesystem, std::map<std::string, pbxbuild::Tool
             return false;
         }
 
-        if (!filesystem->write(*it.second->data(), it.first)) {
+        /* Keep unchanged chunks, so Ninja doesn't rewrite the files using them. */
+        if (!filesystem->writeIfChanged(*it.second->data(), it.first)) {
             return false;
         }
     }
@@ -312,9 +438,56 @@ WriteAuxiliaryFiles(Filesystem *filesystem, std::map<std::string, pbxbuild::Tool
     return true;
 }
 
+/*
+ * How long each output took to build, from the log Ninja keeps in the build
+ * directory. Lines after the header are tab separated: start and end times
+ * in milliseconds, modification time, output path, and command hash. Later
+ * lines are from later builds.
+ */
+static std::unordered_map<std::string, uint64_t>
+NinjaLogDurations(Filesystem const *filesystem, std::string const &path)
+{
+    std::unordered_map<std::string, uint64_t> durations;
+
+    std::vector<uint8_t> contents;
+    if (!filesystem->read(&contents, path)) {
+        return durations;
+    }
+
+    std::istringstream stream(std::string(contents.begin(), contents.end()));
+
+    std::string line;
+    if (!std::getline(stream, line) || line.compare(0, 13, "# ninja log v") != 0) {
+        return durations;
+    }
+
+    while (std::getline(stream, line)) {
+        std::vector<std::string> fields;
+        std::istringstream lineStream(line);
+        std::string field;
+        while (std::getline(lineStream, field, '\t')) {
+            fields.push_back(field);
+        }
+        if (fields.size() < 4) {
+            continue;
+        }
+
+        char *startEnd = NULL;
+        char *endEnd = NULL;
+        unsigned long long start = ::strtoull(fields[0].c_str(), &startEnd, 10);
+        unsigned long long end = ::strtoull(fields[1].c_str(), &endEnd, 10);
+        if (*startEnd != '\0' || *endEnd != '\0' || end < start) {
+            continue;
+        }
+
+        durations[fields[3]] = end - start;
+    }
+
+    return durations;
+}
 
 static bool
-ShouldGenerateNinja(Filesystem const *filesystem, bool generate, Parameters const &buildParameters, std::string const &ninjaPath, std::string const &configurationHashPath)
+ShouldGenerateNinja(Filesystem const *filesystem, bool generate, std::string const &configurationHash, std::string const &ninjaPath, std::string const &configurationHashPath)
 {
     /*
      * If explicitly asked to generate, definitely need to regenerate.
@@ -347,7 +520,7 @@ ShouldGenerateNinja(Filesystem const *filesystem, bool generate, Parameters cons
         /* Can't be read, same as not existing. */
         return true;
     }
-    if (std::string(contents.begin(), contents.end()) != buildParameters.canonicalHash()) {
+    if (std::string(contents.begin(), contents.end()) != configurationHash) {
         return true;
     }
 
@@ -395,10 +568,44 @@ build(
     std::string executableRoot = FSUtil::GetDirectoryName(processContext->executablePath());
     std::string dependencyInfoToolPath = *NinjaBuiltinExecutablePath(processContext, filesystem, "dependency-info-tool");
 
+    /*
+     * Find the builtin client, if a builtin server is configured. Builtin tools are
+     * then run through it to use the server. Otherwise, they run directly: going
+     * through the client would only add a process for each of them.
+     */
+    std::string builtinClientPath;
+    if (processContext->environmentVariable(builtin::Client::SocketEnvironmentVariable())) {
+        builtinClientPath = NinjaBuiltinExecutablePath(processContext, filesystem, "builtin-client").value_or(std::string());
+    }
+
+    /*
+     * Find the action cache tool, if using the action cache. Cacheable invocations
+     * run through it, so it can restore their outputs instead.
+     */
+    std::string actionCacheToolPath;
+    if (_actionCache != nullptr) {
+        actionCacheToolPath = NinjaBuiltinExecutablePath(processContext, filesystem, "action-cache-tool").value_or(std::string());
+        if (actionCacheToolPath.empty()) {
+            fprintf(stderr, "warning: could not find action-cache-tool, not using the action cache\n");
+        }
+    }
+
+    /*
+     * The Ninja files depend on the parameters, whether builtin tools go through
+     * the server, and whether they use the cache.
+     */
+    std::string configurationHash = buildParameters.canonicalHash();
+    if (!builtinClientPath.empty()) {
+        configurationHash += "\nbuiltin-client " + builtinClientPath;
+    }
+    if (!actionCacheToolPath.empty()) {
+        configurationHash += "\naction-cache " + _actionCache->path();
+    }
+
     /*
      * If the Ninja file needs to be generated, generate it.
      */
-    if (ShouldGenerateNinja(filesystem, _generate, buildParameters, ninjaPath, configurationHashPath)) {
+    if (ShouldGenerateNinja(filesystem, _generate, configurationHash, ninjaPath, configurationHashPath)) {
         fprintf(stderr, "Generating Ninja files...\n");
 
         /*
@@ -434,6 +641,8 @@ build(
             *buildContext,
             *targetGraph,
             dependencyInfoToolPath,
+            builtinClientPath,
+            actionCacheToolPath,
             ninjaPath,
             configurationHashPath,
             intermediatesDirectory);
@@ -446,8 +655,7 @@ build(
         /*
          * Write out the configuration hash for the parameters in the Ninja.
          */
-        std::string hashContents = buildParameters.canonicalHash();
-        auto contents = std::vector<uint8_t>(hashContents.begin(), hashContents.end());
+        auto contents = std::vector<uint8_t>(configurationHash.begin(), configurationHash.end());
         if (!filesystem->write(contents, configurationHashPath)) {
             fprintf(stderr, "error: failed to generate ninja configuration hash\n");
             return false;
@@ -496,7 +704,20 @@ build(
             arguments.push_back("-n");
         }
 
-        // TODO(grp): Pass number of jobs if specified.
+        /*
+         * Share the jobserver with Ninja, which uses this process's token for
+         * its first job and takes the rest from the pool. Tools it runs, like
+         * make in a script phase, inherit it. Ninja before 1.13 ignores the
+         * pool, so pass the number of jobs too; it is the pool's size anyway.
+         */
+        std::unordered_map<std::string, std::string> environment = processContext->environmentVariables();
+        if (_jobserver != nullptr) {
+            _jobserver->environment(&environment);
+        }
+        if (_jobs) {
+            arguments.push_back("-j");
+            arguments.push_back(std::to_string(*_jobs));
+        }
 
         /*
          * Run Ninja and return if it failed. Ninja itself does the build.
@@ -505,8 +726,14 @@ build(
             *executable,
             intermediatesDirectory,
             arguments,
-            processContext->environmentVariables());
+            environment);
         ext::optional<int> exitCode = processLauncher->launch(filesystem, &ninja);
+
+        /* Ninja's invocations stored their outputs; keep the cache in its size. */
+        if (!actionCacheToolPath.empty() && !_dryRun) {
+            _actionCache->trim(filesystem);
+        }
+
         if (!exitCode || *exitCode != 0) {
             return false;
         }
@@ -524,6 +751,8 @@ buildAction(
     pbxbuild::Build::Context const &buildContext,
     pbxbuild::DirectedGraph<pbxproj::PBX::Target::shared_ptr> const &targetGraph,
     std::string const &dependencyInfoToolPath,
+    std::string const &builtinClientPath,
+    std::string const &actionCacheToolPath,
     std::string const &ninjaPath,
     std::string const &configurationHashPath,
     std::string const &intermediatesDirectory)
@@ -532,7 +761,14 @@ buildAction(
      * Write out a Ninja file for the build as a whole. Note each target will have a separate
      * file, this is to coordinate the build between targets.
      */
-    ninja::Writer writer;
+    std::unique_ptr<Filesystem::Output> output = OpenNinja(filesystem, ninjaPath);
+    if (output == nullptr) {
+        fprintf(stderr, "error: failed to write Ninja to %s\n", ninjaPath.c_str());
+        return false;
+    }
+
+    NinjaOutputSink sink = NinjaOutputSink(output.get());
+    ninja::Writer writer = ninja::Writer(&sink);
     writer.comment("xcbuild ninja");
     writer.comment("Action: " + buildContext.action());
     if (buildContext.workspaceContext().workspace() != nullptr) {
@@ -553,11 +789,34 @@ buildAction(
     writer.newline();
 
     /*
-     * Since invocations are already resolved at this point, we can't use more specific
-     * rules at the Ninja level. Instead, add a single rule that just passes through from
-     * the build command that calls it.
+     * Add a generic rule for commands not run by a tool, such as writing auxiliary
+     * files. Tool invocations use a rule per tool, written in each target's file.
+     */
+    writer.rule(NinjaRuleName(), ninja::Value::Expression("cd $dir && $exec"));
+
+    /*
+     * Limit how many memory-heavy tools run at once.
      */
-    writer.rule(NinjaRuleName(), ninja::Value::Expression("cd $dir && env $env $exec && $depexec"));
+    writer.pool(NinjaLinkPoolName(), NinjaPoolDepth(4));
+    writer.pool(NinjaSwiftPoolName(), NinjaPoolDepth(2));
+
+    /*
+     * Targets resolve many of the same paths, so cache filesystem queries
+     * across them. Generating only writes Ninja files and dependency info
+     * conversion lists into temporary directories, which resolving doesn't
+     * look at; no tools run until Ninja does.
+     */
+    libutil::CachingFilesystem cachingFilesystem = libutil::CachingFilesystem(filesystem);
+
+    /*
+     * Order each target's invocations by how long they and the invocations
+     * after them took before. Ninja records how long it took to build each
+     * output, so update the durations from its log.
+     */
+    std::string durationsPath = InvocationDurations::Path(intermediatesDirectory);
+    InvocationDurations durations;
+    durations.load(filesystem, durationsPath);
+    std::unordered_map<std::string, uint64_t> loggedDurations = NinjaLogDurations(filesystem, intermediatesDirectory + "/" + ".ninja_log");
 
     /*
      * Go over each target and write out Ninja targets for the start and end of each.
@@ -592,7 +851,7 @@ buildAction(
         }
 
         pbxbuild::Phase::Environment phaseEnvironment = pbxbuild::Phase::Environment(buildEnvironment, buildContext, target, *targetEnvironment);
-        pbxbuild::Phase::PhaseInvocations phaseInvocations = pbxbuild::Phase::PhaseInvocations::Create(phaseEnvironment, target);
+        pbxbuild::Phase::PhaseInvocations phaseInvocations = pbxbuild::Phase::PhaseInvocations::Create(&cachingFilesystem, phaseEnvironment, target);
 
         /*
          * As described above, the target's begin depends on all of the target dependencies.
@@ -619,10 +878,21 @@ buildAction(
         }
         writer.build({ ninja::Value::String(targetWriteAuxiliaryFiles) }, "phony", auxiliaryFileOutputs);
 
+        for (pbxbuild::Tool::Invocation const &invocation : phaseInvocations.invocations()) {
+            if (!invocation.executable() || invocation.outputs().empty()) {
+                continue;
+            }
+
+            auto it = loggedDurations.find(invocation.outputs().front());
+            if (it != loggedDurations.end()) {
+                durations.record(invocation, it->second);
+            }
+        }
+
         /*
          * Write out the Ninja file to build this target.
          */
-        if (!buildTargetInvocations(processContext, filesystem, dependencyInfoToolPath, target, *targetEnvironment, phaseInvocations.auxiliaryFiles(), phaseInvocations.invocations())) {
+        if (!buildTargetInvocations(processContext, filesystem, dependencyInfoToolPath, builtinClientPath, actionCacheToolPath, target, *targetEnvironment, phaseInvocations.auxiliaryFiles(), phaseInvocations.invocations(), durations, intermediatesDirectory)) {
             fprintf(stderr, "error: failed to build target ninja\n");
             return false;
         }
@@ -636,14 +906,14 @@ buildAction(
         /*
          * As described above, the target's finish depends on all of the invocation outputs.
          */
-        std::unordered_set<std::string> invocationOutputs;
+        std::unordered_set<libutil::Path::Interned> invocationOutputs;
         for (pbxbuild::Tool::Invocation const &invocation : phaseInvocations.invocations()) {
             if (!invocation.executable()) {
                 /* No outputs. */
                 continue;
             }
 
-            std::vector<std::string> outputs = NinjaInvocationOutputs(invocation);
+            std::vector<libutil::Path::Interned> outputs = NinjaInvocationOutputs(invocation);
             invocationOutputs.insert(outputs.begin(), outputs.end());
         }
 
@@ -654,7 +924,7 @@ buildAction(
          * the phony input, to avoid Ninja complaining about duplicate rules.
          */
         for (pbxbuild::Tool::Invocation const &invocation : phaseInvocations.invocations()) {
-            for (std::string const &phonyInput : invocation.phonyInputs()) {
+            for (libutil::Path::Interned const &phonyInput : invocation.phonyInputs()) {
                 if (invocationOutputs.find(phonyInput) == invocationOutputs.end()) {
                     writer.build({ ninja::Value::String(phonyInput) }, "phony", { });
                 }
@@ -672,6 +942,10 @@ buildAction(
         writer.build({ ninja::Value::String(targetFinish) }, "phony", { ninja::Value::String(TargetPhaseNinjaFinish(target, maxInvocationPriority)) });
     }
 
+    if (!durations.save(filesystem, durationsPath)) {
+        fprintf(stderr, "warning: unable to save invocation durations to %s\n", durationsPath.c_str());
+    }
+
     /*
      * Build up a list of all of the inputs to the build, so Ninja can regenerate as necessary.
      */
@@ -690,9 +964,9 @@ buildAction(
         inputPaths);
 
     /*
-     * Serialize the Ninja file into the build root.
+     * Finish the Ninja file in the build root.
      */
-    if (!WriteNinja(filesystem, writer, ninjaPath)) {
+    if (!WriteNinja(&writer, output.get())) {
         fprintf(stderr, "error: failed to write Ninja to %s\n", ninjaPath.c_str());
         return false;
     }
@@ -710,15 +984,27 @@ buildTargetInvocations(
     process::Context const *processContext,
     Filesystem *filesystem,
     std::string const &dependencyInfoToolPath,
+    std::string const &builtinClientPath,
+    std::string const &actionCacheToolPath,
     pbxproj::PBX::Target::shared_ptr const &target,
     pbxbuild::Target::Environment const &targetEnvironment,
     std::vector<pbxbuild::Tool::AuxiliaryFile> const &auxiliaryFiles,
-    std::vector<pbxbuild::Tool::Invocation> const &invocations)
+    std::vector<pbxbuild::Tool::Invocation> const &invocations,
+    InvocationDurations const &durations,
+    std::string const &intermediatesDirectory)
 {
     /*
      * Start building the Ninja file for this target.
      */
-    ninja::Writer writer;
+    std::string path = TargetNinjaPath(target, targetEnvironment);
+    std::unique_ptr<Filesystem::Output> output = OpenNinja(filesystem, path);
+    if (output == nullptr) {
+        fprintf(stderr, "error: unable to write target ninja: %s\n", path.c_str());
+        return false;
+    }
+
+    NinjaOutputSink sink = NinjaOutputSink(output.get());
+    ninja::Writer writer = ninja::Writer(&sink);
     writer.comment("xcbuild ninja");
     writer.comment("Target: " + target->name());
     writer.newline();
@@ -743,11 +1029,24 @@ buildTargetInvocations(
      * Group every invocation in target by its phase priority.
      */
     std::map<int, std::unordered_set<std::string>, std::less<uint32_t>> priorityToOutputs;
+    bool hasConversions = false;
     for (pbxbuild::Tool::Invocation const &invocation : invocations) {
-        std::vector<std::string> invocationOutputs = NinjaInvocationOutputs(invocation);
+        std::vector<libutil::Path::Interned> invocationOutputs = NinjaInvocationOutputs(invocation);
         if (!invocationOutputs.empty()) {
             priorityToOutputs[invocation.priority()].insert(invocationOutputs.begin(), invocationOutputs.end());
         }
+        if (invocation.executable() && !invocation.dependencyInfo().empty() && NinjaDependencyInfoNeedsConversion(invocation, intermediatesDirectory)) {
+            hasConversions = true;
+        }
+    }
+
+    /*
+     * Converted dependency info must be written before the target finishes.
+     */
+    std::string conversionsPath = temporaryDirectory + "/" + ".ninja-dependency-info-conversions";
+    std::string conversionsStamp = temporaryDirectory + "/" + ".ninja-dependency-info.stamp";
+    if (hasConversions && !priorityToOutputs.empty()) {
+        priorityToOutputs.rbegin()->second.insert(conversionsStamp);
     }
 
     /*
@@ -776,9 +1075,28 @@ buildTargetInvocations(
     }
 
     /*
-     * Add the build command for each invocation.
+     * Ninja starts ready edges in the order they are written, so write the
+     * invocations with the longest chains after them first.
      */
-    for (pbxbuild::Tool::Invocation const &invocation : invocations) {
+    std::vector<uint64_t> weights = durations.weights(invocations);
+    std::vector<size_t> order;
+    for (size_t i = 0; i < invocations.size(); i++) {
+        order.push_back(i);
+    }
+    std::stable_sort(order.begin(), order.end(), [&weights](size_t a, size_t b) {
+        return weights[a] > weights[b];
+    });
+
+    /*
+     * Add the build command for each invocation. Invocations of the same tool share a rule.
+     */
+    std::unordered_map<std::string, std::string> toolRules;
+    std::unordered_map<std::unordered_map<std::string, std::string> const *, std::string> environmentBases;
+    std::vector<dependency::DependencyInfoConversion> conversions;
+    std::vector<ninja::Value> conversionInputs;
+    std::vector<std::pair<std::string, std::string>> invocationDescriptions;
+    for (size_t index : order) {
+        pbxbuild::Tool::Invocation const &invocation = invocations[index];
         // TODO(grp): This should perhaps be a separate flag for a 'phony' invocation.
         if (invocation.executable()) {
             /* Find invocation executable. */
@@ -790,17 +1108,39 @@ buildTargetInvocations(
             }
 
             /* Write invocations to run after auxiliary files. */
-            if (!buildInvocation(&writer, invocation, *executablePath, dependencyInfoToolPath, temporaryDirectory, TargetPhaseNinjaBegin(target, invocation.priority()))) {
+            size_t previousConversions = conversions.size();
+            if (!buildInvocation(&writer, &toolRules, &environmentBases, invocation, *executablePath, builtinClientPath, actionCacheToolPath, &conversions, &invocationDescriptions, temporaryDirectory, intermediatesDirectory, TargetPhaseNinjaBegin(target, invocation.priority()))) {
                 return false;
             }
+
+            /* The conversion needs the outputs that produce the dependency info. */
+            if (conversions.size() != previousConversions) {
+                for (std::string const &output : NinjaInvocationOutputs(invocation)) {
+                    conversionInputs.push_back(ninja::Value::String(output));
+                }
+            }
         }
     }
 
     /*
-     * Serialize the Ninja file into the build root.
+     * Convert all non-Makefile dependency info in the target with a single
+     * process, rather than one for each invocation.
      */
-    std::string path = TargetNinjaPath(target, targetEnvironment);
-    if (!WriteNinja(filesystem, writer, path)) {
+    if (!conversions.empty()) {
+        std::string exec = Escape::Shell(dependencyInfoToolPath) + " --batch " + Escape::Shell(conversionsPath) + " && touch " + Escape::Shell(conversionsStamp);
+
+        std::vector<ninja::Binding> bindings = {
+            { "description", ninja::Value::String(NinjaDescription("Dependency info " + target->name())) },
+            { "dir", ninja::Value::String("/") },
+            { "exec", ninja::Value::String(exec) },
+        };
+        writer.build({ ninja::Value::String(conversionsStamp) }, NinjaRuleName(), conversionInputs, bindings);
+    }
+
+    /*
+     * Finish the Ninja file in the build root.
+     */
+    if (!WriteNinja(&writer, output.get())) {
         fprintf(stderr, "error: unable to write target ninja: %s\n", path.c_str());
         return false;
     }
@@ -808,6 +1148,19 @@ buildTargetInvocations(
         fprintf(stderr, "error: unable to write auxiliary files\n");
         return false;
     }
+    if (!conversions.empty()) {
+        std::string contents = dependency::DependencyInfoConversion::Serialize(conversions);
+        if (!filesystem->createDirectory(temporaryDirectory, true) || !filesystem->write(std::vector<uint8_t>(contents.begin(), contents.end()), conversionsPath)) {
+            fprintf(stderr, "error: unable to write dependency info conversions: %s\n", conversionsPath.c_str());
+            return false;
+        }
+    }
+    for (auto const &description : invocationDescriptions) {
+        if (!filesystem->createDirectory(temporaryDirectory, true) || !filesystem->write(std::vector<uint8_t>(description.second.begin(), description.second.end()), description.first)) {
+            fprintf(stderr, "error: unable to write invocation description: %s\n", description.first.c_str());
+            return false;
+        }
+    }
 
     return true;
 }
@@ -825,10 +1178,14 @@ buildAuxiliaryFile(
     std::vector<ninja::Value> orderDependencies = { ninja::Value::String(after) };
 
     /*
-     * Build up the command to create the auxiliary file.
+     * Build up the command to create the auxiliary file. The contents are
+     * written to a temporary file first, which replaces the auxiliary file
+     * only if different. With `restat`, Ninja then skips anything depending
+     * on an unchanged auxiliary file.
      */
     std::string escapedPath = Escape::Shell(auxiliaryFile.path());
-    std::string exec = "echo -n > " + escapedPath;
+    std::string escapedTemporaryPath = Escape::Shell(auxiliaryFile.path() + ".ninja-tmp");
+    std::string exec = ": > " + escapedTemporaryPath;
     for (pbxbuild::Tool::AuxiliaryFile::Chunk const &chunk : auxiliaryFile.chunks()) {
         exec += " && ";
 
@@ -850,9 +1207,11 @@ buildAuxiliaryFile(
         }
 
         exec += " >> ";
-        exec += escapedPath;
+        exec += escapedTemporaryPath;
     }
 
+    exec += " && { cmp -s " + escapedTemporaryPath + " " + escapedPath + " && rm -f " + escapedTemporaryPath + " || mv -f " + escapedTemporaryPath + " " + escapedPath + "; }";
+
     /* Mark the file as executable if necessary. */
     if (auxiliaryFile.executable()) {
         exec += " && ";
@@ -867,29 +1226,54 @@ buildAuxiliaryFile(
         { "description", ninja::Value::String(description) },
         { "dir", ninja::Value::String("/") },
         { "exec", ninja::Value::String(exec) },
-        { "depexec", ninja::Value::String("true") },
+        { "restat", ninja::Value::String("1") },
     };
     writer->build(outputs, NinjaRuleName(), inputs, bindings, { }, orderDependencies);
 
     return true;
 }
 
+/*
+ * Environment variables as arguments to `env`.
+ */
+static std::string
+NinjaEnvironment(std::unordered_map<std::string, std::string> const &environment)
+{
+    std::string result;
+    for (auto it = environment.begin(); it != environment.end(); ++it) {
+        if (it != environment.begin()) {
+            result += " ";
+        }
+        result += it->first + "=" + Escape::Shell(it->second);
+    }
+    return result;
+}
+
 bool NinjaExecutor::
 buildInvocation(
     ninja::Writer *writer,
+    std::unordered_map<std::string, std::string> *toolRules,
+    std::unordered_map<std::unordered_map<std::string, std::string> const *, std::string> *environmentBases,
     pbxbuild::Tool::Invocation const &invocation,
     std::string const &executablePath,
-    std::string const &dependencyInfoToolPath,
+    std::string const &builtinClientPath,
+    std::string const &actionCacheToolPath,
+    std::vector<dependency::DependencyInfoConversion> *conversions,
+    std::vector<std::pair<std::string, std::string>> *invocationDescriptions,
     std::string const &temporaryDirectory,
+    std::string const &intermediatesDirectory,
     std::string const &after)
 {
     /*
      * Build the invocation arguments. Must escape for shell arguments as Ninja passes
      * the command string directly to the shell, which would interpret spaces, etc as meaningful.
      */
-    std::string exec = Escape::Shell(executablePath);
+    std::string arguments;
     for (std::string const &arg : invocation.arguments()) {
-        exec += " " + Escape::Shell(arg);
+        if (&arg != &invocation.arguments().front()) {
+            arguments += " ";
+        }
+        arguments += Escape::Shell(arg);
     }
 
     /*
@@ -897,12 +1281,23 @@ buildInvocation(
      * `env` to avoid Bash-specific limitations on environment variables (some versions of Bash
      * don't allow setting "UID"). Intentionally add to, not replace, the process environment.
      */
-    std::string environment;
-    for (auto it = invocation.environment().begin(); it != invocation.environment().end(); ++it) {
-        if (it != invocation.environment().begin()) {
-            environment += " ";
+    std::string environment = NinjaEnvironment(invocation.environment());
+
+    /*
+     * A shared environment base is written once per target as a variable, which
+     * the command then references. Only the invocation's own variables are in
+     * each build edge, after the base so they take precedence.
+     */
+    std::string environmentBase;
+    if (invocation.environmentBase() != nullptr) {
+        auto it = environmentBases->find(invocation.environmentBase().get());
+        if (it == environmentBases->end()) {
+            std::string name = "environment_" + std::to_string(environmentBases->size());
+            writer->binding({ name, ninja::Value::String(NinjaEnvironment(*invocation.environmentBase())) });
+            it = environmentBases->insert({ invocation.environmentBase().get(), name }).first;
         }
-        environment += it->first + "=" + Escape::Shell(it->second);
+
+        environmentBase = it->second;
     }
 
     /*
@@ -912,42 +1307,120 @@ buildInvocation(
     std::string description = NinjaDescription(_formatter->beginInvocation(invocation, executableDisplayName, false));
 
     /*
-     * Add the dependency info converter & file.
+     * Add the dependency info file. Makefile-format dependency info from tools
+     * run in Ninja's directory is already what Ninja expects, so it is read
+     * directly with `deps = gcc` and stored in the Ninja log. Anything else is
+     * converted once the target's outputs exist, along with every other
+     * conversion in the target.
      */
     std::string dependencyInfoFile;
-    std::string dependencyInfoExec;
+    bool dependencyInfoGCC = false;
 
-    if (!invocation.dependencyInfo().empty()) {
+    if (!invocation.dependencyInfo().empty() && !NinjaDependencyInfoNeedsConversion(invocation, intermediatesDirectory)) {
+        dependencyInfoFile = FSUtil::ResolveRelativePath(invocation.dependencyInfo().front().path(), invocation.workingDirectory());
+        dependencyInfoGCC = true;
+    } else if (!invocation.dependencyInfo().empty()) {
         /* Determine the first output; Ninja expects that as the Makefile rule. */
         std::string output = NinjaInvocationOutputs(invocation).front();
 
-        /* Find where the generated dependency info should go. */
+        /* Find where the converted dependency info should go. */
         dependencyInfoFile = temporaryDirectory + "/" + ".ninja-dependency-info-" + NinjaHash(output.data(), output.size()) + ".d";
 
-        /* Build the dependency info rewriter arguments. */
-        std::vector<std::string> dependencyInfoArguments = {
-            "--name", output,
-            "--output", dependencyInfoFile,
-        };
-
         /* Add the input for each dependency info. */
+        std::vector<std::pair<dependency::DependencyInfoFormat, std::string>> inputs;
         for (pbxbuild::Tool::Invocation::DependencyInfo const &dependencyInfo : invocation.dependencyInfo()) {
-            std::string formatName;
-            if (!dependency::DependencyInfoFormats::Name(dependencyInfo.format(), &formatName)) {
-                return false;
-            }
-
-            dependencyInfoArguments.push_back(formatName + ":" + dependencyInfo.path());
+            inputs.push_back({ dependencyInfo.format(), dependencyInfo.path() });
         }
 
-        /* Create the command for converting the dependency info. */
-        dependencyInfoExec = Escape::Shell(dependencyInfoToolPath);
-        for (std::string const &arg : dependencyInfoArguments) {
-            dependencyInfoExec += " " + Escape::Shell(arg);
+        conversions->push_back(dependency::DependencyInfoConversion(output, dependencyInfoFile, invocation.workingDirectory(), inputs));
+    }
+
+    /*
+     * Pass long argument lists in a response file. Otherwise, the arguments are
+     * both written into the Ninja file and limited by the maximum command length.
+     */
+    std::string responseFile;
+    std::string responseArguments;
+    if (arguments.size() > NinjaResponseFileThreshold && NinjaSupportsResponseFile(executablePath)) {
+        std::string output = NinjaInvocationOutputs(invocation).front();
+        responseFile = temporaryDirectory + "/" + ".ninja-response-file-" + NinjaHash(output.data(), output.size()) + ".rsp";
+
+        /* The tool reads the file itself, not the shell, so quote for the tool. */
+        for (std::string const &arg : invocation.arguments()) {
+            if (&arg != &invocation.arguments().front()) {
+                responseArguments += " ";
+            }
+            responseArguments += Escape::ResponseFile(arg);
         }
+    }
+
+    /*
+     * Run cacheable invocations through the action cache tool, which restores their
+     * outputs if cached. It reads what the cache needs about the invocation from a
+     * description written alongside the Ninja file.
+     */
+    std::string invocationDescription;
+    if (!actionCacheToolPath.empty() && ActionCache::Cacheable(invocation)) {
+        std::string output = NinjaInvocationOutputs(invocation).front();
+        invocationDescription = temporaryDirectory + "/" + ".ninja-invocation-" + NinjaHash(output.data(), output.size()) + ".action";
+        invocationDescriptions->push_back({ invocationDescription, ActionCache::SerializeInvocation(invocation, executablePath) });
+    }
+
+    /*
+     * Memory-heavy tools run in a limited pool.
+     */
+    ext::optional<std::string> pool = NinjaInvocationPool(invocation, executablePath);
+
+    /*
+     * Build the command for the rule. Everything shared between invocations of the
+     * same tool is in the rule, so each build edge only has to specify its arguments.
+     */
+    std::string prefix = "cd " + Escape::Shell(invocation.workingDirectory()) + " && ";
+    ninja::Value executable = ninja::Value::String(std::string());
+    if (!invocationDescription.empty()) {
+        executable = ninja::Value::String(Escape::Shell(actionCacheToolPath) + " --cache " + Escape::Shell(_actionCache->path()) + " --invocation ") + ninja::Value::Expression("$invocation") + ninja::Value::String(" -- ");
+    }
+    if (invocation.executable()->builtin() && !builtinClientPath.empty()) {
+        executable = executable + ninja::Value::String(Escape::Shell(builtinClientPath) + " " + Escape::Shell(*invocation.executable()->builtin()) + " ");
     } else {
-        // TODO(grp): Avoid the need for an empty dependency info command if not used.
-        dependencyInfoExec = "true";
+        executable = executable + ninja::Value::String(Escape::Shell(executablePath) + " ");
+    }
+
+    ninja::Value command = ninja::Value::String(prefix);
+    if (!environmentBase.empty()) {
+        command = command + ninja::Value::String("env ") + ninja::Value::Expression("$" + environmentBase) + ninja::Value::String(" ") + ninja::Value::Expression("$env") + ninja::Value::String(" ") + executable;
+    } else if (!environment.empty()) {
+        command = command + ninja::Value::String("env " + environment + " ") + executable;
+    } else {
+        command = command + executable;
+    }
+    if (!responseFile.empty()) {
+        command = command + ninja::Value::String("@") + ninja::Value::Expression("$rsp");
+    } else {
+        command = command + ninja::Value::Expression("$args");
+    }
+
+    /*
+     * Find or write the rule for this tool.
+     */
+    std::string ruleKey = command.resolve(ninja::Value::EscapeMode::Value) + "\n" + pool.value_or("") + (dependencyInfoGCC ? "\ngcc" : "");
+    auto rule = toolRules->find(ruleKey);
+    if (rule == toolRules->end()) {
+        std::vector<ninja::Binding> ruleBindings;
+        if (!responseFile.empty()) {
+            ruleBindings.push_back({ "rspfile", ninja::Value::Expression("$rspfile_path") });
+            ruleBindings.push_back({ "rspfile_content", ninja::Value::Expression("$rsp_args") });
+        }
+        if (pool) {
+            ruleBindings.push_back({ "pool", ninja::Value::String(*pool) });
+        }
+        if (dependencyInfoGCC) {
+            ruleBindings.push_back({ "deps", ninja::Value::String("gcc") });
+        }
+
+        std::string ruleName = NinjaToolRuleName(executablePath, toolRules->size());
+        writer->rule(ruleName, command, ruleBindings);
+        rule = toolRules->insert({ ruleKey, ruleName }).first;
     }
 
     /*
@@ -955,18 +1428,23 @@ buildInvocation(
      */
     std::vector<ninja::Binding> bindings = {
         { "description", ninja::Value::String(description) },
-        { "dir", ninja::Value::String(Escape::Shell(invocation.workingDirectory())) },
-        { "exec", ninja::Value::String(exec) },
     };
-    if (!environment.empty()) {
-        bindings.push_back({ "env", ninja::Value::String(environment) });
-    }
-    if (!dependencyInfoExec.empty()) {
-        bindings.push_back({ "depexec", ninja::Value::String(dependencyInfoExec) });
+    if (!responseFile.empty()) {
+        bindings.push_back({ "rsp", ninja::Value::String(Escape::Shell(responseFile)) });
+        bindings.push_back({ "rspfile_path", ninja::Value::String(responseFile) });
+        bindings.push_back({ "rsp_args", ninja::Value::String(responseArguments) });
+    } else {
+        bindings.push_back({ "args", ninja::Value::String(arguments) });
     }
     if (!dependencyInfoFile.empty()) {
         bindings.push_back({ "depfile", ninja::Value::String(dependencyInfoFile) });
     }
+    if (!environmentBase.empty()) {
+        bindings.push_back({ "env", ninja::Value::String(environment) });
+    }
+    if (!invocationDescription.empty()) {
+        bindings.push_back({ "invocation", ninja::Value::String(Escape::Shell(invocationDescription)) });
+    }
 
     /*
      * Build up outputs as literal Ninja values.
@@ -1008,17 +1486,26 @@ buildInvocation(
     /*
      * Add the rule to build this invocation.
      */
-    writer->build(outputs, NinjaRuleName(), inputs, bindings, inputDependencies, orderDependencies);
+    writer->build(outputs, rule->second, inputs, bindings, inputDependencies, orderDependencies);
 
     return true;
 }
 
 std::unique_ptr<NinjaExecutor> NinjaExecutor::
-Create(std::shared_ptr<xcformatter::Formatter> const &formatter, bool dryRun, bool generate)
+Create(
+    std::shared_ptr<xcformatter::Formatter> const &formatter,
+    bool dryRun,
+    bool generate,
+    std::shared_ptr<ActionCache> const &actionCache,
+    ext::optional<size_t> const &jobs,
+    std::shared_ptr<process::Jobserver> const &jobserver)
 {
     return std::unique_ptr<NinjaExecutor>(new NinjaExecutor(
         formatter,
         dryRun,
-        generate
+        generate,
+        actionCache,
+        jobs,
+        jobserver
     ));
 }
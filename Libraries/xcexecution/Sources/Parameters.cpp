@@ -12,10 +12,7 @@
 #include <pbxbuild/Build/DependencyResolver.h>
 #include <libutil/Filesystem.h>
 #include <libutil/FSUtil.h>
-#include <libutil/md5.h>
-
-#include <sstream>
-#include <iomanip>
+#include <libutil/Hash.h>
 
 using xcexecution::Parameters;
 using libutil::Filesystem;
@@ -94,24 +91,15 @@ canonicalArguments() const
 std::string Parameters::
 canonicalHash() const
 {
-    md5_state_t state;
-    md5_init(&state);
+    libutil::Hash::Stream stream;
 
     std::vector<std::string> arguments = canonicalArguments();
     for (std::string const &argument : arguments) {
         /* Inlucde trailing NUL terminator to separate arguments. */
-        md5_append(&state, reinterpret_cast<const md5_byte_t *>(argument.data()), argument.size() + 1);
+        stream.update(argument.data(), argument.size() + 1);
     }
 
-    uint8_t digest[16];
-    md5_finish(&state, reinterpret_cast<md5_byte_t *>(&digest));
-
-    std::ostringstream ss;
-    ss << std::hex << std::setfill('0');
-    for (uint8_t c : digest) {
-        ss << std::setw(2) << static_cast<int>(c);
-    }
-    return ss.str();
+    return stream.finish().hex();
 }
 
 static pbxproj::PBX::Project::shared_ptr
@@ -13,8 +13,11 @@
 #include <builtin/Driver.h>
 #include <pbxbuild/Phase/Environment.h>
 #include <pbxbuild/Phase/PhaseInvocations.h>
+#include <libutil/CachingFilesystem.h>
+#include <libutil/FileHasher.h>
 #include <libutil/Filesystem.h>
 #include <libutil/FSUtil.h>
+#include <libutil/Interned.h>
 #include <process/Context.h>
 #include <process/MemoryContext.h>
 #include <process/Launcher.h>
@@ -23,18 +26,28 @@
 #include <sys/types.h>
 #include <sys/stat.h>
 
-#include <set>
+#include <chrono>
+#include <cstdio>
 
 using xcexecution::SimpleExecutor;
 using xcexecution::Parameters;
+using xcexecution::InvocationDurations;
+using libutil::CachingFilesystem;
 using libutil::Filesystem;
 using libutil::FSUtil;
 using libutil::Permissions;
 
 SimpleExecutor::
-SimpleExecutor(std::shared_ptr<xcformatter::Formatter> const &formatter, bool dryRun, builtin::Registry const &builtins) :
-    Executor (formatter, dryRun, false),
-    _builtins(builtins)
+SimpleExecutor(
+    std::shared_ptr<xcformatter::Formatter> const &formatter,
+    bool dryRun,
+    builtin::Registry const &builtins,
+    std::shared_ptr<ActionCache> const &actionCache,
+    std::shared_ptr<process::Jobserver> const &jobserver) :
+    Executor    (formatter, dryRun, false),
+    _builtins   (builtins),
+    _actionCache(actionCache),
+    _jobserver  (jobserver)
 {
 }
 
@@ -64,6 +77,14 @@ build(
 
     xcformatter::Formatter::Print(_formatter->begin(*buildContext));
 
+    /*
+     * Load how long invocations took in earlier builds, to order this one.
+     */
+    pbxsetting::Environment environment = pbxsetting::Environment(buildEnvironment.baseEnvironment());
+    environment.insertFront(pbxsetting::Level(workspaceContext->derivedDataHash().overrideSettings()), false);
+    std::string durationsPath = InvocationDurations::Path(environment.resolve("OBJROOT"));
+    _durations.load(filesystem, durationsPath);
+
     ext::optional<pbxbuild::DirectedGraph<pbxproj::PBX::Target::shared_ptr>> targetGraph = buildParameters.resolveDependencies(buildEnvironment, *buildContext);
     if (!targetGraph) {
         return false;
@@ -75,6 +96,14 @@ build(
         return false;
     }
 
+    /*
+     * Resolving targets queries the same paths many times. Cache them for
+     * resolving only: building a target runs tools that change the paths
+     * they query, so it uses the filesystem directly. Afterwards, forget
+     * the paths the target wrote so later targets see them.
+     */
+    CachingFilesystem cachingFilesystem = CachingFilesystem(filesystem);
+
     for (pbxproj::PBX::Target::shared_ptr const &target : *orderedTargets) {
         xcformatter::Formatter::Print(_formatter->beginTarget(*buildContext, target));
 
@@ -87,11 +116,25 @@ build(
 
         xcformatter::Formatter::Print(_formatter->beginCheckDependencies(target));
         pbxbuild::Phase::Environment phaseEnvironment = pbxbuild::Phase::Environment(buildEnvironment, *buildContext, target, *targetEnvironment);
-        pbxbuild::Phase::PhaseInvocations phaseInvocations = pbxbuild::Phase::PhaseInvocations::Create(phaseEnvironment, target);
+        pbxbuild::Phase::PhaseInvocations phaseInvocations = pbxbuild::Phase::PhaseInvocations::Create(&cachingFilesystem, phaseEnvironment, target);
         xcformatter::Formatter::Print(_formatter->finishCheckDependencies(target));
 
         auto result = buildTarget(processContext, processLauncher, filesystem, target, *targetEnvironment, phaseInvocations.auxiliaryFiles(), phaseInvocations.invocations());
+
+        for (pbxbuild::Tool::AuxiliaryFile const &auxiliaryFile : phaseInvocations.auxiliaryFiles()) {
+            cachingFilesystem.invalidate(auxiliaryFile.path());
+        }
+        for (pbxbuild::Tool::Invocation const &invocation : phaseInvocations.invocations()) {
+            for (std::string const &output : invocation.outputs()) {
+                cachingFilesystem.invalidate(output);
+            }
+        }
+
         if (!result.first) {
+            if (!_dryRun) {
+                _durations.save(filesystem, durationsPath);
+            }
+
             xcformatter::Formatter::Print(_formatter->finishTarget(*buildContext, target));
             xcformatter::Formatter::Print(_formatter->failure(*buildContext, result.second));
             return false;
@@ -100,67 +143,77 @@ build(
         xcformatter::Formatter::Print(_formatter->finishTarget(*buildContext, target));
     }
 
+    if (!_dryRun && !_durations.save(filesystem, durationsPath)) {
+        fprintf(stderr, "warning: unable to save invocation durations to %s\n", durationsPath.c_str());
+    }
+
+    if (_actionCache != nullptr && !_dryRun) {
+        _actionCache->trim(filesystem);
+
+        ActionCache::Statistics const &statistics = _actionCache->statistics();
+        fprintf(stderr, "note: action cache: %zu hits, %zu misses, %zu stored, %zu evicted\n",
+            statistics.hits, statistics.misses, statistics.stores, statistics.evictions);
+    }
+
     xcformatter::Formatter::Print(_formatter->success(*buildContext));
     return true;
 }
 
-static ext::optional<std::vector<pbxbuild::Tool::Invocation>>
-SortInvocations(std::vector<pbxbuild::Tool::Invocation> const &invocations)
+ext::optional<std::vector<pbxbuild::Tool::Invocation>> SimpleExecutor::
+sortInvocations(std::vector<pbxbuild::Tool::Invocation> const &invocations) const
 {
-    std::unordered_map<std::string, pbxbuild::Tool::Invocation const *> outputToInvocation;
-    std::set<uint32_t, std::less<uint32_t>> orderedPhasePriorities;
-    for (pbxbuild::Tool::Invocation const &invocation : invocations) {
-        for (std::string const &output : invocation.outputs()) {
-            outputToInvocation.insert({ output, &invocation });
-        }
-        orderedPhasePriorities.insert(invocation.priority());
+    /*
+     * Start the invocations with the longest chains after them first, so
+     * long ones don't start last and hold up the end of the build.
+     */
+    ext::optional<std::vector<size_t>> schedule = _durations.schedule(invocations);
+    if (!schedule) {
+        return ext::nullopt;
     }
 
-    pbxbuild::DirectedGraph<pbxbuild::Tool::Invocation const *> graph;
-    for (pbxbuild::Tool::Invocation const &invocation : invocations) {
-        std::unordered_set<pbxbuild::Tool::Invocation const *> emptySet;
-        graph.insert(&invocation, emptySet);
+    std::vector<pbxbuild::Tool::Invocation> result;
+    result.reserve(schedule->size());
+    for (size_t index : *schedule) {
+        result.push_back(invocations[index]);
+    }
+    return result;
+}
 
-        for (std::string const &input : invocation.inputs()) {
-            auto it = outputToInvocation.find(input);
-            if (it != outputToInvocation.end()) {
-                graph.insert(&invocation, { it->second });
-            }
-        }
-        for (std::string const &phonyInputs : invocation.phonyInputs()) {
-            auto it = outputToInvocation.find(phonyInputs);
-            if (it != outputToInvocation.end()) {
-                graph.insert(&invocation, { it->second });
-            }
-        }
-        for (std::string const &inputDependency : invocation.inputDependencies()) {
-            auto it = outputToInvocation.find(inputDependency);
-            if (it != outputToInvocation.end()) {
-                graph.insert(&invocation, { it->second });
+/*
+ * Pass the contents of an auxiliary file to a callback in pieces. File
+ * chunks are streamed, rather than read into memory in full.
+ */
+static bool
+AuxiliaryFileContents(
+    Filesystem const *filesystem,
+    pbxbuild::Tool::AuxiliaryFile const &auxiliaryFile,
+    std::function<bool(uint8_t const *, size_t)> const &cb)
+{
+    for (pbxbuild::Tool::AuxiliaryFile::Chunk const &chunk : auxiliaryFile.chunks()) {
+        switch (chunk.type()) {
+            case pbxbuild::Tool::AuxiliaryFile::Chunk::Type::Data: {
+                if (!cb(chunk.data()->data(), chunk.data()->size())) {
+                    return false;
+                }
+                break;
             }
-        }
-
-        auto it = orderedPhasePriorities.find(invocation.priority());
-        if (it != orderedPhasePriorities.end() && std::next(it) != orderedPhasePriorities.end()) {
-            for (pbxbuild::Tool::Invocation const &otherInvocation : invocations) {
-                if (otherInvocation.priority() == *std::next(it)) {
-                    graph.insert(&otherInvocation, { &invocation });
+            case pbxbuild::Tool::AuxiliaryFile::Chunk::Type::File: {
+                bool success = true;
+                if (!filesystem->readContents(*chunk.file(), [&](uint8_t const *data, size_t size) {
+                    success = success && cb(data, size);
+                })) {
+                    return false;
+                }
+                if (!success) {
+                    return false;
                 }
+                break;
             }
+            default: abort();
         }
     }
 
-    std::vector<pbxbuild::Tool::Invocation> result;
-
-    ext::optional<std::vector<pbxbuild::Tool::Invocation const *>> orderedInvocations = graph.ordered();
-    if (!orderedInvocations) {
-        return ext::nullopt;
-    }
-
-    for (pbxbuild::Tool::Invocation const *invocation : *orderedInvocations) {
-        result.push_back(*invocation);
-    }
-    return result;
+    return true;
 }
 
 bool SimpleExecutor::
@@ -180,31 +233,36 @@ writeAuxiliaryFiles(
             }
         }
 
-        xcformatter::Formatter::Print(_formatter->writeAuxiliaryFile(auxiliaryFile.path()));
+        /*
+         * Only write files with changed contents, so unchanged files keep
+         * their modification times and don't cause dependents to rebuild.
+         */
+        libutil::Hash::Stream stream;
+        if (!AuxiliaryFileContents(filesystem, auxiliaryFile, [&stream](uint8_t const *data, size_t size) -> bool {
+            stream.update(data, size);
+            return true;
+        })) {
+            return false;
+        }
 
-        if (!_dryRun) {
-            std::vector<uint8_t> data;
+        if (libutil::FileHasher::Contents(filesystem, auxiliaryFile.path()) != stream.finish()) {
+            xcformatter::Formatter::Print(_formatter->writeAuxiliaryFile(auxiliaryFile.path()));
 
-            for (pbxbuild::Tool::AuxiliaryFile::Chunk const &chunk : auxiliaryFile.chunks()) {
-                switch (chunk.type()) {
-                    case pbxbuild::Tool::AuxiliaryFile::Chunk::Type::Data: {
-                        data.insert(data.end(), chunk.data()->begin(), chunk.data()->end());
-                        break;
-                    }
-                    case pbxbuild::Tool::AuxiliaryFile::Chunk::Type::File: {
-                        std::vector<uint8_t> contents;
-                        if (!filesystem->read(&contents, *chunk.file())) {
-                            return false;
-                        }
-                        data.insert(data.end(), contents.begin(), contents.end());
-                        break;
-                    }
-                    default: abort();
+            if (!_dryRun) {
+                std::unique_ptr<Filesystem::Output> output = filesystem->openOutput(auxiliaryFile.path());
+                if (output == nullptr) {
+                    return false;
+                }
+
+                if (!AuxiliaryFileContents(filesystem, auxiliaryFile, [&output](uint8_t const *data, size_t size) -> bool {
+                    return output->write(data, size);
+                })) {
+                    return false;
                 }
-            }
 
-            if (!filesystem->write(data, auxiliaryFile.path())) {
-                return false;
+                if (!output->commit()) {
+                    return false;
+                }
             }
         }
 
@@ -226,6 +284,44 @@ writeAuxiliaryFiles(
     return true;
 }
 
+/*
+ * Set variables in an environment, remembering the values they replace.
+ */
+static void
+SimpleEnvironmentSet(
+    std::unordered_map<std::string, std::string> *environment,
+    std::unordered_map<std::string, std::string> const &variables,
+    std::vector<std::pair<std::string, ext::optional<std::string>>> *replaced)
+{
+    for (auto const &entry : variables) {
+        auto it = environment->find(entry.first);
+        if (it != environment->end()) {
+            replaced->push_back({ entry.first, it->second });
+            it->second = entry.second;
+        } else {
+            replaced->push_back({ entry.first, ext::nullopt });
+            environment->insert(entry);
+        }
+    }
+}
+
+/*
+ * Undo `SimpleEnvironmentSet()`, newest first.
+ */
+static void
+SimpleEnvironmentRestore(
+    std::unordered_map<std::string, std::string> *environment,
+    std::vector<std::pair<std::string, ext::optional<std::string>>> const &replaced)
+{
+    for (auto it = replaced.rbegin(); it != replaced.rend(); ++it) {
+        if (it->second) {
+            (*environment)[it->first] = *it->second;
+        } else {
+            environment->erase(it->first);
+        }
+    }
+}
+
 std::pair<bool, std::vector<pbxbuild::Tool::Invocation>> SimpleExecutor::
 performInvocations(
     process::Context const *processContext,
@@ -235,6 +331,9 @@ performInvocations(
     std::vector<pbxbuild::Tool::Invocation> const &orderedInvocations,
     bool createProductStructure)
 {
+    /* Contexts for shared environment bases, each combined with the process environment. */
+    std::unordered_map<std::unordered_map<std::string, std::string> const *, std::unique_ptr<process::MemoryContext>> baseContexts;
+
     for (pbxbuild::Tool::Invocation const &invocation : orderedInvocations) {
         // TODO(grp): This should perhaps be a separate flag for a 'phony' invocation.
         if (!invocation.executable()) {
@@ -257,6 +356,8 @@ performInvocations(
                 }
             }
 
+            std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
             if (ext::optional<std::string> const &builtin = executable.builtin()) {
                 /* Builtin tool, find and run in-process. */
                 if (std::shared_ptr<builtin::Driver> driver = _builtins.driver(*builtin)) {
@@ -266,7 +367,7 @@ performInvocations(
                         *builtin,
                         invocation.workingDirectory(),
                         invocation.arguments(),
-                        invocation.environment());
+                        invocation.fullEnvironment());
                     int exitCode = driver->run(&context, filesystem);
                     success = (exitCode == 0);
 
@@ -289,18 +390,79 @@ performInvocations(
                 if (path) {
                     xcformatter::Formatter::Print(_formatter->beginInvocation(invocation, *path, createProductStructure));
 
-                    /* Create the execution environment from the process and invocation environments, preferring the invocation. */
-                    std::unordered_map<std::string, std::string> environment = invocation.environment();
-                    environment.insert(processContext->environmentVariables().begin(), processContext->environmentVariables().end());
+                    /* Reuse the outputs of an identical earlier invocation, if cached. */
+                    ext::optional<std::string> key;
+                    if (_actionCache != nullptr) {
+                        key = _actionCache->key(filesystem, invocation, *path);
+                        if (key && _actionCache->restore(filesystem, *key, invocation)) {
+                            xcformatter::Formatter::Print(_formatter->finishInvocation(invocation, *path, createProductStructure));
+                            continue;
+                        }
+                    }
 
-                    process::MemoryContext context = process::MemoryContext(
-                        *path,
-                        invocation.workingDirectory(),
-                        invocation.arguments(),
-                        environment);
-                    ext::optional<int> exitCode = processLauncher->launch(filesystem, &context);
+                    /*
+                     * Create the execution environment from the process and invocation environments,
+                     * preferring the invocation. Invocations sharing a base launch from one context
+                     * for it; their own variables are set over it for the launch and then undone.
+                     */
+                    std::unique_ptr<process::MemoryContext> invocationContext;
+                    process::MemoryContext *context;
+                    if (invocation.environmentBase() != nullptr) {
+                        auto it = baseContexts.find(invocation.environmentBase().get());
+                        if (it == baseContexts.end()) {
+                            std::unordered_map<std::string, std::string> base = *invocation.environmentBase();
+                            base.insert(processContext->environmentVariables().begin(), processContext->environmentVariables().end());
+                            auto baseContext = std::unique_ptr<process::MemoryContext>(new process::MemoryContext(std::string(), std::string(), std::vector<std::string>(), base));
+                            it = baseContexts.insert({ invocation.environmentBase().get(), std::move(baseContext) }).first;
+                        }
+
+                        context = it->second.get();
+                        context->executablePath() = *path;
+                        context->currentDirectory() = invocation.workingDirectory();
+                        context->commandLineArguments() = invocation.arguments();
+                    } else {
+                        std::unordered_map<std::string, std::string> environment = invocation.environment();
+                        environment.insert(processContext->environmentVariables().begin(), processContext->environmentVariables().end());
+                        invocationContext = std::unique_ptr<process::MemoryContext>(new process::MemoryContext(
+                            *path,
+                            invocation.workingDirectory(),
+                            invocation.arguments(),
+                            environment));
+                        context = invocationContext.get();
+                    }
+
+                    std::vector<std::pair<std::string, ext::optional<std::string>>> replaced;
+                    if (invocation.environmentBase() != nullptr) {
+                        SimpleEnvironmentSet(&context->environmentVariables(), invocation.environment(), &replaced);
+                    }
+
+                    /* Tools running jobs of their own take further tokens from the same pool. */
+                    if (_jobserver != nullptr && invocation.jobserver()) {
+                        std::unordered_map<std::string, std::string> jobserverEnvironment;
+                        auto it = context->environmentVariables().find("MAKEFLAGS");
+                        if (it != context->environmentVariables().end()) {
+                            jobserverEnvironment.insert(*it);
+                        }
+                        _jobserver->environment(&jobserverEnvironment);
+                        SimpleEnvironmentSet(&context->environmentVariables(), jobserverEnvironment, &replaced);
+                    }
+
+                    /* Hold a token while running, as part of the limit shared with those tools. */
+                    if (_jobserver != nullptr && !_jobserver->acquire()) {
+                        return std::make_pair(false, std::vector<pbxbuild::Tool::Invocation>({ invocation }));
+                    }
+                    ext::optional<int> exitCode = processLauncher->launch(filesystem, context);
+                    SimpleEnvironmentRestore(&context->environmentVariables(), replaced);
+                    if (_jobserver != nullptr) {
+                        _jobserver->release();
+                    }
                     success = (exitCode && *exitCode == 0);
 
+                    if (success && key) {
+                        /* Failing to store only loses the cached result. */
+                        _actionCache->store(filesystem, *key, invocation);
+                    }
+
                     xcformatter::Formatter::Print(_formatter->finishInvocation(invocation, *path, createProductStructure));
                 } else {
                     /* Failed to find executable. */
@@ -313,6 +475,10 @@ performInvocations(
             if (!success) {
                 return std::make_pair(false, std::vector<pbxbuild::Tool::Invocation>({ invocation }));
             }
+
+            /* Remember how long it took, to order the next build. */
+            std::chrono::steady_clock::duration elapsed = std::chrono::steady_clock::now() - start;
+            _durations.record(invocation, std::chrono::duration_cast<std::chrono::milliseconds>(elapsed).count());
         }
     }
 
@@ -336,7 +502,7 @@ buildTarget(
         return std::make_pair(false, std::vector<pbxbuild::Tool::Invocation>());
     }
 
-    ext::optional<std::vector<pbxbuild::Tool::Invocation>> orderedInvocations = SortInvocations(invocations);
+    ext::optional<std::vector<pbxbuild::Tool::Invocation>> orderedInvocations = sortInvocations(invocations);
     if (!orderedInvocations) {
         fprintf(stderr, "error: cycle detected building invocation graph\n");
         return std::make_pair(false, std::vector<pbxbuild::Tool::Invocation>());
@@ -358,11 +524,18 @@ buildTarget(
 }
 
 std::unique_ptr<SimpleExecutor> SimpleExecutor::
-Create(std::shared_ptr<xcformatter::Formatter> const &formatter, bool dryRun, builtin::Registry const &builtins)
+Create(
+    std::shared_ptr<xcformatter::Formatter> const &formatter,
+    bool dryRun,
+    builtin::Registry const &builtins,
+    std::shared_ptr<ActionCache> const &actionCache,
+    std::shared_ptr<process::Jobserver> const &jobserver)
 {
     return std::unique_ptr<SimpleExecutor>(new SimpleExecutor(
         formatter,
         dryRun,
-        builtins
+        builtins,
+        actionCache,
+        jobserver
     ));
 }
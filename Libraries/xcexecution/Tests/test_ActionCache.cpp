@@ -0,0 +1,316 @@
+/**
+ Copyright (c) 2015-present, Facebook, Inc.
+ All rights reserved.
+
+ This source code is licensed under the BSD-style license found in the
+ LICENSE file in the root directory of this source tree. An additional grant
+ of patent rights can be found in the PATENTS file in the same directory.
+ */
+
+#include <gtest/gtest.h>
+#include <xcexecution/ActionCache.h>
+#include <xcexecution/SimpleExecutor.h>
+#include <xcformatter/NullFormatter.h>
+#include <pbxbuild/Tool/Invocation.h>
+#include <builtin/Registry.h>
+#include <process/MemoryContext.h>
+#include <process/MemoryLauncher.h>
+#include <libutil/MemoryFilesystem.h>
+
+#include <chrono>
+#include <thread>
+
+using xcexecution::ActionCache;
+using xcexecution::SimpleExecutor;
+using libutil::Filesystem;
+using libutil::MemoryFilesystem;
+
+static std::vector<uint8_t>
+Contents(std::string const &string)
+{
+    return std::vector<uint8_t>(string.begin(), string.end());
+}
+
+static pbxbuild::Tool::Invocation
+CompileInvocation(MemoryFilesystem const &filesystem, std::string const &input, std::string const &output)
+{
+    auto invocation = pbxbuild::Tool::Invocation();
+    invocation.executable() = pbxbuild::Tool::Invocation::Executable::External(filesystem.path("tool"));
+    invocation.workingDirectory() = filesystem.path("");
+    invocation.arguments() = { "-c", input, "-o", output };
+    invocation.inputs() = { filesystem.path(input) };
+    invocation.outputs() = { filesystem.path(output) };
+    return invocation;
+}
+
+TEST(ActionCache, StoreRestore)
+{
+    auto filesystem = MemoryFilesystem({
+        MemoryFilesystem::Entry::File("tool", Contents("tool")),
+        MemoryFilesystem::Entry::File("input.c", Contents("int a;")),
+    });
+
+    ActionCache cache(filesystem.path("cache"), 1024);
+    auto invocation = CompileInvocation(filesystem, "input.c", "input.o");
+
+    ext::optional<std::string> key = cache.key(&filesystem, invocation, filesystem.path("tool"));
+    ASSERT_NE(ext::nullopt, key);
+    EXPECT_EQ(key, cache.key(&filesystem, invocation, filesystem.path("tool")));
+
+    /* Not cached yet. */
+    EXPECT_FALSE(cache.restore(&filesystem, *key, invocation));
+
+    ASSERT_TRUE(filesystem.write(Contents("compiled"), filesystem.path("input.o")));
+    ASSERT_TRUE(cache.store(&filesystem, *key, invocation));
+
+    /* Outputs are restored after being removed. */
+    ASSERT_TRUE(filesystem.removeFile(filesystem.path("input.o")));
+    ASSERT_TRUE(cache.restore(&filesystem, *key, invocation));
+
+    std::vector<uint8_t> contents;
+    ASSERT_TRUE(filesystem.read(&contents, filesystem.path("input.o")));
+    EXPECT_EQ(Contents("compiled"), contents);
+
+    EXPECT_EQ(1, cache.statistics().hits);
+    EXPECT_EQ(1, cache.statistics().misses);
+    EXPECT_EQ(1, cache.statistics().stores);
+}
+
+TEST(ActionCache, Key)
+{
+    auto filesystem = MemoryFilesystem({
+        MemoryFilesystem::Entry::File("tool", Contents("tool")),
+        MemoryFilesystem::Entry::File("input.c", Contents("int a;")),
+    });
+
+    ActionCache cache(filesystem.path("cache"), 1024);
+    auto invocation = CompileInvocation(filesystem, "input.c", "input.o");
+    ext::optional<std::string> key = cache.key(&filesystem, invocation, filesystem.path("tool"));
+    ASSERT_NE(ext::nullopt, key);
+
+    /* Changing the arguments or environment changes the key. */
+    auto arguments = invocation;
+    arguments.arguments().push_back("-O2");
+    EXPECT_NE(key, cache.key(&filesystem, arguments, filesystem.path("tool")));
+
+    auto environment = invocation;
+    environment.environment() = { { "LANG", "C" } };
+    EXPECT_NE(key, cache.key(&filesystem, environment, filesystem.path("tool")));
+
+    /* Changing an input changes the key. */
+    ASSERT_TRUE(filesystem.write(Contents("int b;"), filesystem.path("input.c")));
+    EXPECT_NE(key, cache.key(&filesystem, invocation, filesystem.path("tool")));
+
+    /* Some invocations can't be cached. */
+    auto missing = CompileInvocation(filesystem, "missing.c", "missing.o");
+    EXPECT_EQ(ext::nullopt, cache.key(&filesystem, missing, filesystem.path("tool")));
+
+    auto phony = invocation;
+    phony.phonyInputs() = { filesystem.path("phony") };
+    EXPECT_EQ(ext::nullopt, cache.key(&filesystem, phony, filesystem.path("tool")));
+
+    auto noOutputs = invocation;
+    noOutputs.outputs().clear();
+    EXPECT_EQ(ext::nullopt, cache.key(&filesystem, noOutputs, filesystem.path("tool")));
+}
+
+TEST(ActionCache, SerializeInvocation)
+{
+    auto filesystem = MemoryFilesystem({
+        MemoryFilesystem::Entry::File("tool", Contents("tool")),
+        MemoryFilesystem::Entry::File("input.c", Contents("int a;")),
+    });
+
+    auto invocation = CompileInvocation(filesystem, "input.c", "input.o");
+    invocation.arguments().push_back("with space\nand newline");
+    invocation.environment() = { { "NAME", "a=b" } };
+    invocation.dependencyInfo() = { pbxbuild::Tool::Invocation::DependencyInfo(dependency::DependencyInfoFormat::Makefile, "input.d") };
+
+    pbxbuild::Tool::Invocation read;
+    std::string executable;
+    ASSERT_TRUE(ActionCache::DeserializeInvocation(ActionCache::SerializeInvocation(invocation, filesystem.path("tool")), &read, &executable));
+    EXPECT_EQ(filesystem.path("tool"), executable);
+    EXPECT_EQ(invocation.workingDirectory(), read.workingDirectory());
+    EXPECT_EQ(invocation.arguments(), read.arguments());
+    EXPECT_EQ(invocation.environment(), read.environment());
+    EXPECT_EQ(invocation.inputs(), read.inputs());
+    EXPECT_EQ(invocation.outputs(), read.outputs());
+    ASSERT_EQ(1, read.dependencyInfo().size());
+    EXPECT_EQ(dependency::DependencyInfoFormat::Makefile, read.dependencyInfo().front().format());
+    EXPECT_EQ("input.d", read.dependencyInfo().front().path());
+
+    /* A separate process finds the same key. */
+    ActionCache cache(filesystem.path("cache"), 1024);
+    EXPECT_EQ(cache.key(&filesystem, invocation, filesystem.path("tool")), cache.key(&filesystem, read, executable));
+
+    EXPECT_FALSE(ActionCache::DeserializeInvocation("argument 10 short\n", &read, &executable));
+    EXPECT_FALSE(ActionCache::DeserializeInvocation("unknown 0 \n", &read, &executable));
+}
+
+TEST(ActionCache, Dependencies)
+{
+    auto filesystem = MemoryFilesystem({
+        MemoryFilesystem::Entry::File("tool", Contents("tool")),
+        MemoryFilesystem::Entry::File("input.c", Contents("#include \"header.h\"")),
+        MemoryFilesystem::Entry::File("header.h", Contents("int a;")),
+    });
+
+    ActionCache cache(filesystem.path("cache"), 1024);
+    auto invocation = CompileInvocation(filesystem, "input.c", "input.o");
+    invocation.outputs().push_back(filesystem.path("input.d"));
+    invocation.dependencyInfo().push_back(pbxbuild::Tool::Invocation::DependencyInfo(
+        dependency::DependencyInfoFormat::Makefile,
+        filesystem.path("input.d")));
+
+    ext::optional<std::string> key = cache.key(&filesystem, invocation, filesystem.path("tool"));
+    ASSERT_NE(ext::nullopt, key);
+
+    ASSERT_TRUE(filesystem.write(Contents("compiled"), filesystem.path("input.o")));
+    ASSERT_TRUE(filesystem.write(Contents(filesystem.path("input.o") + ": " + filesystem.path("input.c") + " " + filesystem.path("header.h") + "\n"), filesystem.path("input.d")));
+    ASSERT_TRUE(cache.store(&filesystem, *key, invocation));
+    EXPECT_TRUE(cache.restore(&filesystem, *key, invocation));
+
+    /* A changed dependency isn't part of the key, but prevents restoring. */
+    ASSERT_TRUE(filesystem.write(Contents("int b;"), filesystem.path("header.h")));
+    EXPECT_EQ(key, cache.key(&filesystem, invocation, filesystem.path("tool")));
+    EXPECT_FALSE(cache.restore(&filesystem, *key, invocation));
+}
+
+TEST(ActionCache, RestoreDependencyInfo)
+{
+    auto filesystem = MemoryFilesystem({
+        MemoryFilesystem::Entry::File("tool", Contents("tool")),
+        MemoryFilesystem::Entry::File("input.c", Contents("#include \"header.h\"")),
+        MemoryFilesystem::Entry::File("header.h", Contents("int a;")),
+    });
+
+    /* As under Ninja, the dependency info isn't one of the outputs. */
+    ActionCache cache(filesystem.path("cache"), 1024);
+    auto invocation = CompileInvocation(filesystem, "input.c", "input.o");
+    invocation.dependencyInfo().push_back(pbxbuild::Tool::Invocation::DependencyInfo(
+        dependency::DependencyInfoFormat::Makefile,
+        filesystem.path("input.d")));
+
+    ext::optional<std::string> key = cache.key(&filesystem, invocation, filesystem.path("tool"));
+    ASSERT_NE(ext::nullopt, key);
+
+    std::vector<uint8_t> dependencies = Contents(filesystem.path("input.o") + ": " + filesystem.path("input.c") + " " + filesystem.path("header.h") + "\n");
+    ASSERT_TRUE(filesystem.write(Contents("compiled"), filesystem.path("input.o")));
+    ASSERT_TRUE(filesystem.write(dependencies, filesystem.path("input.d")));
+    ASSERT_TRUE(cache.store(&filesystem, *key, invocation));
+
+    /* Ninja removes the dependency info after reading it; a hit restores it. */
+    ASSERT_TRUE(filesystem.removeFile(filesystem.path("input.o")));
+    ASSERT_TRUE(filesystem.removeFile(filesystem.path("input.d")));
+    ASSERT_TRUE(cache.restore(&filesystem, *key, invocation));
+
+    std::vector<uint8_t> contents;
+    ASSERT_TRUE(filesystem.read(&contents, filesystem.path("input.d")));
+    EXPECT_EQ(dependencies, contents);
+
+    /* So the header is still a dependency after the hit. */
+    ASSERT_TRUE(filesystem.removeFile(filesystem.path("input.d")));
+    ASSERT_TRUE(filesystem.write(Contents("int b;"), filesystem.path("header.h")));
+    EXPECT_FALSE(cache.restore(&filesystem, *key, invocation));
+    EXPECT_FALSE(filesystem.exists(filesystem.path("input.d")));
+}
+
+TEST(ActionCache, SaveHashes)
+{
+    auto filesystem = MemoryFilesystem({
+        MemoryFilesystem::Entry::File("tool", Contents("tool")),
+        MemoryFilesystem::Entry::File("input.c", Contents("int a;")),
+    });
+
+    /* A separate process saves the hashes it found. */
+    ActionCache tool(filesystem.path("cache"), 1024);
+    auto invocation = CompileInvocation(filesystem, "input.c", "input.o");
+    ext::optional<std::string> key = tool.key(&filesystem, invocation, filesystem.path("tool"));
+    ASSERT_NE(ext::nullopt, key);
+    ASSERT_TRUE(tool.saveHashes(&filesystem, *key));
+    EXPECT_TRUE(filesystem.exists(filesystem.path("cache/hashes.pending/" + *key)));
+
+    /* Trimming remembers them, even if the build hashed nothing itself. */
+    ActionCache build(filesystem.path("cache"), 1024);
+    ASSERT_TRUE(build.trim(&filesystem));
+    EXPECT_TRUE(filesystem.exists(filesystem.path("cache/hashes")));
+    EXPECT_FALSE(filesystem.exists(filesystem.path("cache/hashes.pending/" + *key)));
+}
+
+TEST(ActionCache, Trim)
+{
+    auto filesystem = MemoryFilesystem({
+        MemoryFilesystem::Entry::File("tool", Contents("tool")),
+        MemoryFilesystem::Entry::File("first.c", Contents("int a;")),
+        MemoryFilesystem::Entry::File("second.c", Contents("int b;")),
+    });
+
+    /* Room for only one of the outputs. */
+    ActionCache cache(filesystem.path("cache"), 12);
+
+    auto first = CompileInvocation(filesystem, "first.c", "first.o");
+    ext::optional<std::string> firstKey = cache.key(&filesystem, first, filesystem.path("tool"));
+    ASSERT_NE(ext::nullopt, firstKey);
+    ASSERT_TRUE(filesystem.write(Contents("first-output"), filesystem.path("first.o")));
+    ASSERT_TRUE(cache.store(&filesystem, *firstKey, first));
+
+    /* Make sure the entries were used at different times. */
+    std::this_thread::sleep_for(std::chrono::milliseconds(2));
+
+    auto second = CompileInvocation(filesystem, "second.c", "second.o");
+    ext::optional<std::string> secondKey = cache.key(&filesystem, second, filesystem.path("tool"));
+    ASSERT_NE(ext::nullopt, secondKey);
+    ASSERT_TRUE(filesystem.write(Contents("secondoutput"), filesystem.path("second.o")));
+    ASSERT_TRUE(cache.store(&filesystem, *secondKey, second));
+
+    /* The least recently used entry and its output are evicted. */
+    ASSERT_TRUE(cache.trim(&filesystem));
+    EXPECT_EQ(1, cache.statistics().evictions);
+    EXPECT_FALSE(cache.restore(&filesystem, *firstKey, first));
+    EXPECT_TRUE(cache.restore(&filesystem, *secondKey, second));
+
+    size_t objects = 0;
+    filesystem.readDirectory(filesystem.path("cache/objects"), false, [&](std::string const &name) {
+        objects++;
+    });
+    EXPECT_EQ(1, objects);
+}
+
+TEST(ActionCache, SimpleExecutor)
+{
+    auto filesystem = MemoryFilesystem({
+        MemoryFilesystem::Entry::File("tool", Contents("tool")),
+        MemoryFilesystem::Entry::File("input.c", Contents("int a;")),
+    });
+
+    size_t launches = 0;
+    auto launcher = process::MemoryLauncher({
+        { filesystem.path("tool"), [&launches](Filesystem *filesystem, process::Context const *context) -> ext::optional<int> {
+            launches++;
+            return filesystem->write(Contents("compiled"), context->currentDirectory() + "/input.o") ? 0 : 1;
+        } },
+    });
+
+    auto context = process::MemoryContext(
+        "",
+        filesystem.path(""),
+        std::vector<std::string>(),
+        std::unordered_map<std::string, std::string>());
+
+    auto cache = std::make_shared<ActionCache>(filesystem.path("cache"), 1024);
+    auto formatter = xcformatter::NullFormatter::Create();
+    std::vector<std::string> const executablePaths = { filesystem.path("") };
+    SimpleExecutor executor = SimpleExecutor(formatter, false, builtin::Registry::Create({ }), cache);
+
+    auto invocation = CompileInvocation(filesystem, "input.c", "input.o");
+    ASSERT_TRUE(executor.performInvocations(&context, &launcher, &filesystem, executablePaths, { invocation }, false).first);
+    EXPECT_EQ(1, launches);
+    EXPECT_EQ(1, cache->statistics().stores);
+
+    /* The second build restores the output instead of running the tool. */
+    ASSERT_TRUE(filesystem.removeFile(filesystem.path("input.o")));
+    ASSERT_TRUE(executor.performInvocations(&context, &launcher, &filesystem, executablePaths, { invocation }, false).first);
+    EXPECT_EQ(1, launches);
+    EXPECT_EQ(1, cache->statistics().hits);
+    EXPECT_TRUE(filesystem.exists(filesystem.path("input.o")));
+}
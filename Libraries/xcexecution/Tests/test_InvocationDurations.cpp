@@ -0,0 +1,142 @@
+/**
+ Copyright (c) 2015-present, Facebook, Inc.
+ All rights reserved.
+
+ This source code is licensed under the BSD-style license found in the
+ LICENSE file in the root directory of this source tree. An additional grant
+ of patent rights can be found in the PATENTS file in the same directory.
+ */
+
+#include <gtest/gtest.h>
+#include <xcexecution/InvocationDurations.h>
+#include <pbxbuild/Tool/Invocation.h>
+#include <libutil/MemoryFilesystem.h>
+
+using xcexecution::InvocationDurations;
+using libutil::MemoryFilesystem;
+
+static pbxbuild::Tool::Invocation
+Invocation(std::vector<std::string> const &inputs, std::string const &output, uint32_t priority = 0)
+{
+    auto invocation = pbxbuild::Tool::Invocation();
+    invocation.executable() = pbxbuild::Tool::Invocation::Executable::External("/tool");
+    invocation.workingDirectory() = "/";
+    invocation.arguments() = { "-o", output };
+    for (std::string const &input : inputs) {
+        invocation.inputs().push_back(input);
+    }
+    invocation.outputs() = { output };
+    invocation.priority() = priority;
+    return invocation;
+}
+
+TEST(InvocationDurations, Record)
+{
+    InvocationDurations durations;
+
+    auto invocation = Invocation({ "/a.c" }, "/a.o");
+    EXPECT_EQ(ext::nullopt, durations.duration(invocation));
+
+    durations.record(invocation, 250);
+    EXPECT_EQ(ext::optional<uint64_t>(250), durations.duration(invocation));
+
+    /* A changed command for the same output isn't estimated from the old one. */
+    auto changed = invocation;
+    changed.arguments().push_back("-O2");
+    EXPECT_EQ(ext::nullopt, durations.duration(changed));
+
+    durations.record(changed, 400);
+    EXPECT_EQ(ext::optional<uint64_t>(400), durations.duration(changed));
+    EXPECT_EQ(ext::nullopt, durations.duration(invocation));
+
+    /* Without outputs, there's nothing to remember it by. */
+    auto phony = pbxbuild::Tool::Invocation();
+    durations.record(phony, 100);
+    EXPECT_EQ(ext::nullopt, durations.duration(phony));
+    EXPECT_EQ(1, durations.size());
+}
+
+TEST(InvocationDurations, SaveLoad)
+{
+    auto filesystem = MemoryFilesystem({ });
+
+    auto first = Invocation({ "/a.c" }, "/a.o");
+    auto second = Invocation({ "/b c.c" }, "/b c.o");
+
+    InvocationDurations durations;
+    durations.record(first, 10);
+    durations.record(second, 2000);
+    ASSERT_TRUE(durations.save(&filesystem, "/durations"));
+
+    InvocationDurations loaded;
+    ASSERT_TRUE(loaded.load(&filesystem, "/durations"));
+    EXPECT_EQ(2, loaded.size());
+    EXPECT_EQ(ext::optional<uint64_t>(10), loaded.duration(first));
+    EXPECT_EQ(ext::optional<uint64_t>(2000), loaded.duration(second));
+
+    /* Missing and invalid files don't load. */
+    InvocationDurations invalid;
+    EXPECT_FALSE(invalid.load(&filesystem, "/missing"));
+    ASSERT_TRUE(filesystem.write(std::vector<uint8_t>({ 'x', '\n' }), "/invalid"));
+    EXPECT_FALSE(invalid.load(&filesystem, "/invalid"));
+    EXPECT_EQ(0, invalid.size());
+}
+
+TEST(InvocationDurations, Weights)
+{
+    std::vector<pbxbuild::Tool::Invocation> invocations = {
+        Invocation({ "/a.c" }, "/a.o"),
+        Invocation({ "/b.c" }, "/b.o"),
+        Invocation({ "/a.o", "/b.o" }, "/binary"),
+        /* A later phase follows everything in earlier phases. */
+        Invocation({ }, "/copied", 1),
+    };
+
+    InvocationDurations durations;
+    durations.record(invocations[0], 100);
+    durations.record(invocations[1], 10);
+    durations.record(invocations[2], 20);
+    durations.record(invocations[3], 5);
+
+    EXPECT_EQ(std::vector<uint64_t>({ 125, 35, 25, 5 }), durations.weights(invocations));
+
+    /* Unknown durations are estimated as the average. */
+    InvocationDurations partial;
+    partial.record(invocations[0], 100);
+    partial.record(invocations[2], 20);
+    EXPECT_EQ(std::vector<uint64_t>({ 180, 140, 80, 60 }), partial.weights(invocations));
+
+    /* Without any durations, each invocation counts the same. */
+    EXPECT_EQ(std::vector<uint64_t>({ 3, 3, 2, 1 }), InvocationDurations().weights(invocations));
+}
+
+TEST(InvocationDurations, Schedule)
+{
+    std::vector<pbxbuild::Tool::Invocation> invocations = {
+        Invocation({ }, "/copied", 1),
+        Invocation({ "/short.o", "/long.o" }, "/binary"),
+        Invocation({ "/short.c" }, "/short.o"),
+        Invocation({ "/long.c" }, "/long.o"),
+        Invocation({ "/other.c" }, "/other.o"),
+    };
+
+    /* Without durations, the longer chains go first, otherwise in order. */
+    InvocationDurations durations;
+    EXPECT_EQ(std::vector<size_t>({ 2, 3, 1, 4, 0 }), *durations.schedule(invocations));
+
+    /* The longest remaining chain starts first. */
+    durations.record(invocations[2], 10);
+    durations.record(invocations[3], 500);
+    durations.record(invocations[4], 100);
+    durations.record(invocations[1], 50);
+    EXPECT_EQ(std::vector<size_t>({ 3, 4, 2, 1, 0 }), *durations.schedule(invocations));
+
+    /* Cycles can't be scheduled. */
+    invocations[2].inputs().push_back("/binary");
+    EXPECT_EQ(ext::nullopt, durations.schedule(invocations));
+
+    /* Neither can depending on a later phase. */
+    invocations[2].inputs().pop_back();
+    invocations[2].inputs().push_back("/copied");
+    EXPECT_EQ(ext::nullopt, durations.schedule(invocations));
+}
@@ -10,6 +10,7 @@
 #include <gtest/gtest.h>
 #include <xcexecution/SimpleExecutor.h>
 #include <xcformatter/NullFormatter.h>
+#include <pbxbuild/Tool/AuxiliaryFile.h>
 #include <pbxbuild/Tool/Invocation.h>
 #include <builtin/Driver.h>
 #include <builtin/Registry.h>
@@ -17,6 +18,8 @@
 #include <process/MemoryLauncher.h>
 #include <libutil/MemoryFilesystem.h>
 
+#include <algorithm>
+
 using xcexecution::SimpleExecutor;
 using libutil::Filesystem;
 using libutil::MemoryFilesystem;
@@ -139,3 +142,305 @@ TEST(SimpleExecutor, PropagateToolResult)
     EXPECT_EQ(fail2.second.size(), 1);
 }
 
+
+TEST(SimpleExecutor, SharedEnvironment)
+{
+    auto filesystem = MemoryFilesystem({
+        MemoryFilesystem::Entry::File("tool", std::vector<uint8_t>()),
+    });
+
+    std::vector<std::unordered_map<std::string, std::string>> environments;
+    auto launcher = process::MemoryLauncher({
+        { filesystem.path("tool"), [&environments](Filesystem *filesystem, process::Context const *context) -> ext::optional<int> {
+            environments.push_back(context->environmentVariables());
+            return 0;
+        } },
+    });
+
+    auto context = process::MemoryContext(
+        "",
+        filesystem.path(""),
+        std::vector<std::string>(),
+        std::unordered_map<std::string, std::string>({ { "PROCESS", "process" }, { "SHARED", "process" } }));
+
+    auto base = std::make_shared<std::unordered_map<std::string, std::string> const>(std::unordered_map<std::string, std::string>({
+        { "SHARED", "base" },
+        { "BASE", "base" },
+    }));
+
+    /* Only variables that differ from the base are stored. */
+    auto first = pbxbuild::Tool::Invocation();
+    first.executable() = pbxbuild::Tool::Invocation::Executable::External("tool");
+    first.shareEnvironment({ { "SHARED", "base" }, { "BASE", "base" }, { "OWN", "first" } }, base);
+    EXPECT_EQ(base, first.environmentBase());
+    EXPECT_EQ((std::unordered_map<std::string, std::string>({ { "OWN", "first" } })), first.environment());
+
+    auto second = pbxbuild::Tool::Invocation();
+    second.executable() = pbxbuild::Tool::Invocation::Executable::External("tool");
+    second.shareEnvironment({ { "SHARED", "second" }, { "BASE", "base" } }, base);
+    EXPECT_EQ((std::unordered_map<std::string, std::string>({ { "SHARED", "second" } })), second.environment());
+    EXPECT_EQ((std::unordered_map<std::string, std::string>({ { "SHARED", "second" }, { "BASE", "base" } })), second.fullEnvironment());
+
+    /* The base can't be used if it has variables the environment doesn't. */
+    auto third = pbxbuild::Tool::Invocation();
+    third.shareEnvironment({ { "OWN", "third" } }, base);
+    EXPECT_EQ(nullptr, third.environmentBase());
+    EXPECT_EQ((std::unordered_map<std::string, std::string>({ { "OWN", "third" } })), third.fullEnvironment());
+
+    auto formatter = xcformatter::NullFormatter::Create();
+    std::vector<std::string> const executablePaths = { filesystem.path("") };
+    SimpleExecutor executor = SimpleExecutor(formatter, false, builtin::Registry::Create({ }));
+
+    auto result = executor.performInvocations(&context, &launcher, &filesystem, executablePaths, { first, second, first }, false);
+    ASSERT_TRUE(result.first);
+    ASSERT_EQ(3, environments.size());
+
+    /* Invocation variables take precedence over the process environment. */
+    EXPECT_EQ((std::unordered_map<std::string, std::string>({
+        { "PROCESS", "process" }, { "SHARED", "base" }, { "BASE", "base" }, { "OWN", "first" },
+    })), environments[0]);
+    EXPECT_EQ((std::unordered_map<std::string, std::string>({
+        { "PROCESS", "process" }, { "SHARED", "second" }, { "BASE", "base" },
+    })), environments[1]);
+
+    /* Each invocation's own variables are only set for its launch. */
+    EXPECT_EQ(environments[0], environments[2]);
+}
+
+#if !_WIN32
+TEST(SimpleExecutor, Jobserver)
+{
+    auto filesystem = MemoryFilesystem({
+        MemoryFilesystem::Entry::File("tool", std::vector<uint8_t>()),
+    });
+
+    std::vector<ext::optional<std::string>> makeflags;
+    auto launcher = process::MemoryLauncher({
+        { filesystem.path("tool"), [&makeflags](Filesystem *filesystem, process::Context const *context) -> ext::optional<int> {
+            makeflags.push_back(context->environmentVariable("MAKEFLAGS"));
+            return 0;
+        } },
+    });
+
+    auto context = process::MemoryContext(
+        "",
+        filesystem.path(""),
+        std::vector<std::string>(),
+        std::unordered_map<std::string, std::string>());
+
+    std::shared_ptr<process::Jobserver> jobserver = process::Jobserver::Create(process::Jobserver::Style::Pipe, 2, "/tmp");
+    ASSERT_NE(nullptr, jobserver);
+
+    auto compile = pbxbuild::Tool::Invocation();
+    compile.executable() = pbxbuild::Tool::Invocation::Executable::External("tool");
+
+    auto script = pbxbuild::Tool::Invocation();
+    script.executable() = pbxbuild::Tool::Invocation::Executable::External("tool");
+    script.jobserver() = true;
+
+    auto flagged = script;
+    flagged.environment() = { { "MAKEFLAGS", "k" } };
+
+    auto formatter = xcformatter::NullFormatter::Create();
+    std::vector<std::string> const executablePaths = { filesystem.path("") };
+    SimpleExecutor executor = SimpleExecutor(formatter, false, builtin::Registry::Create({ }), nullptr, jobserver);
+
+    auto result = executor.performInvocations(&context, &launcher, &filesystem, executablePaths, { compile, script, flagged }, false);
+    ASSERT_TRUE(result.first);
+    ASSERT_EQ(3, makeflags.size());
+
+    /* Only tools that may run jobs of their own are told about the pool. */
+    EXPECT_EQ(ext::nullopt, makeflags[0]);
+    EXPECT_EQ(" " + jobserver->makeflags(), makeflags[1]);
+    EXPECT_EQ("k " + jobserver->makeflags(), makeflags[2]);
+
+    /* Each tool gave back its token. */
+    EXPECT_TRUE(jobserver->acquire());
+    EXPECT_TRUE(jobserver->acquire());
+    jobserver->release();
+    jobserver->release();
+}
+#endif
+
+/*
+ * Counts files written, to check that unchanged files are not.
+ */
+class CountingFilesystem : public MemoryFilesystem {
+public:
+    size_t writes;
+
+public:
+    CountingFilesystem(std::vector<Entry> const &entries) :
+        MemoryFilesystem(entries),
+        writes          (0)
+    {
+    }
+
+public:
+    virtual bool write(std::vector<uint8_t> const &contents, std::string const &path)
+    {
+        writes++;
+        return MemoryFilesystem::write(contents, path);
+    }
+};
+
+TEST(SimpleExecutor, WriteAuxiliaryFilesIfChanged)
+{
+    CountingFilesystem filesystem({
+        MemoryFilesystem::Entry::File("chunk", std::vector<uint8_t>({ 'b' })),
+    });
+
+    auto formatter = xcformatter::NullFormatter::Create();
+    SimpleExecutor executor = SimpleExecutor(formatter, false, builtin::Registry::Create({ }));
+
+    std::vector<pbxbuild::Tool::AuxiliaryFile> auxiliaryFiles = {
+        pbxbuild::Tool::AuxiliaryFile(filesystem.path("out/file"), {
+            pbxbuild::Tool::AuxiliaryFile::Chunk::Data({ 'a' }),
+            pbxbuild::Tool::AuxiliaryFile::Chunk::File(filesystem.path("chunk")),
+            pbxbuild::Tool::AuxiliaryFile::Chunk::Data({ 'c' }),
+        }),
+    };
+
+    ASSERT_TRUE(executor.writeAuxiliaryFiles(&filesystem, auxiliaryFiles));
+    EXPECT_EQ(1, filesystem.writes);
+
+    std::vector<uint8_t> contents;
+    ASSERT_TRUE(filesystem.read(&contents, filesystem.path("out/file")));
+    EXPECT_EQ(std::vector<uint8_t>({ 'a', 'b', 'c' }), contents);
+
+    /* Unchanged contents are not written again. */
+    ASSERT_TRUE(executor.writeAuxiliaryFiles(&filesystem, auxiliaryFiles));
+    EXPECT_EQ(1, filesystem.writes);
+
+    /* A changed file chunk changes the contents. */
+    ASSERT_TRUE(filesystem.write({ 'B' }, filesystem.path("chunk")));
+    ASSERT_TRUE(executor.writeAuxiliaryFiles(&filesystem, auxiliaryFiles));
+    EXPECT_EQ(3, filesystem.writes);
+    ASSERT_TRUE(filesystem.read(&contents, filesystem.path("out/file")));
+    EXPECT_EQ(std::vector<uint8_t>({ 'a', 'B', 'c' }), contents);
+
+    /* A missing file chunk fails. */
+    auxiliaryFiles.push_back(pbxbuild::Tool::AuxiliaryFile(filesystem.path("out/other"), {
+        pbxbuild::Tool::AuxiliaryFile::Chunk::File(filesystem.path("missing")),
+    }));
+    EXPECT_FALSE(executor.writeAuxiliaryFiles(&filesystem, auxiliaryFiles));
+}
+
+/*
+ * Simulate running invocations on a number of workers, on a clock rather
+ * than in real time. Each starts in the order given, once a worker is free
+ * and its inputs are built. Returns when the last one finishes.
+ */
+static uint64_t
+SimulatedMakespan(
+    std::vector<std::string> const &order,
+    std::vector<pbxbuild::Tool::Invocation> const &invocations,
+    std::unordered_map<std::string, uint64_t> const &durations,
+    size_t workers)
+{
+    std::unordered_map<std::string, uint64_t> finished;
+    std::vector<uint64_t> available = std::vector<uint64_t>(workers, 0);
+
+    for (std::string const &output : order) {
+        auto invocation = std::find_if(invocations.begin(), invocations.end(), [&output](pbxbuild::Tool::Invocation const &invocation) {
+            return invocation.outputs().front() == output;
+        });
+
+        auto worker = std::min_element(available.begin(), available.end());
+        uint64_t start = *worker;
+        for (std::string const &input : invocation->inputs()) {
+            auto it = finished.find(input);
+            if (it != finished.end()) {
+                start = std::max(start, it->second);
+            }
+        }
+
+        *worker = start + durations.at(output);
+        finished[output] = *worker;
+    }
+
+    return *std::max_element(available.begin(), available.end());
+}
+
+TEST(SimpleExecutor, LongestChainFirst)
+{
+    auto filesystem = MemoryFilesystem({
+        MemoryFilesystem::Entry::File("tool", std::vector<uint8_t>()),
+    });
+
+    std::vector<std::string> started;
+    auto launcher = process::MemoryLauncher({
+        { filesystem.path("tool"), [&started](Filesystem *filesystem, process::Context const *context) -> ext::optional<int> {
+            started.push_back(context->commandLineArguments().back());
+            return 0;
+        } },
+    });
+
+    auto context = process::MemoryContext(
+        "",
+        filesystem.path(""),
+        std::vector<std::string>(),
+        std::unordered_map<std::string, std::string>());
+
+    /*
+     * A skewed build: many short compiles, then one long compile, all
+     * linked together. Durations are on the simulated clock.
+     */
+    std::unordered_map<std::string, uint64_t> durations;
+    std::vector<pbxbuild::Tool::Invocation> invocations;
+
+    auto link = pbxbuild::Tool::Invocation();
+    link.executable() = pbxbuild::Tool::Invocation::Executable::External("tool");
+    link.arguments() = { "-o", filesystem.path("binary") };
+    link.outputs() = { filesystem.path("binary") };
+    durations[filesystem.path("binary")] = 5;
+
+    for (int i = 0; i < 13; i++) {
+        std::string name = (i < 12 ? "small" + std::to_string(i) : "large");
+        auto compile = pbxbuild::Tool::Invocation();
+        compile.executable() = pbxbuild::Tool::Invocation::Executable::External("tool");
+        compile.arguments() = { "-c", filesystem.path(name + ".c"), "-o", filesystem.path(name + ".o") };
+        compile.inputs() = { filesystem.path(name + ".c") };
+        compile.outputs() = { filesystem.path(name + ".o") };
+        invocations.push_back(compile);
+
+        link.inputs().push_back(filesystem.path(name + ".o"));
+        durations[filesystem.path(name + ".o")] = (i < 12 ? 5 : 40);
+    }
+    invocations.insert(invocations.begin(), link);
+
+    auto formatter = xcformatter::NullFormatter::Create();
+    std::vector<std::string> const executablePaths = { filesystem.path("") };
+
+    /* Without history, the long compile starts after the short ones. */
+    SimpleExecutor first = SimpleExecutor(formatter, false, builtin::Registry::Create({ }));
+    auto firstOrder = first.sortInvocations(invocations);
+    ASSERT_TRUE(firstOrder);
+    ASSERT_TRUE(first.performInvocations(&context, &launcher, &filesystem, executablePaths, *firstOrder, false).first);
+    ASSERT_EQ(invocations.size(), started.size());
+    EXPECT_EQ(filesystem.path("large.o"), started[12]);
+    uint64_t firstMakespan = SimulatedMakespan(started, invocations, durations, 4);
+    EXPECT_EQ(60, firstMakespan);
+
+    /* Running records how long each invocation took. */
+    for (pbxbuild::Tool::Invocation const &invocation : invocations) {
+        EXPECT_TRUE(first.durations().duration(invocation));
+    }
+
+    /* With the durations from an earlier build, it starts first. */
+    SimpleExecutor second = SimpleExecutor(formatter, false, builtin::Registry::Create({ }));
+    for (pbxbuild::Tool::Invocation const &invocation : invocations) {
+        second.durations().record(invocation, durations.at(invocation.outputs().front()));
+    }
+
+    started.clear();
+    auto secondOrder = second.sortInvocations(invocations);
+    ASSERT_TRUE(secondOrder);
+    ASSERT_TRUE(second.performInvocations(&context, &launcher, &filesystem, executablePaths, *secondOrder, false).first);
+    ASSERT_EQ(invocations.size(), started.size());
+    EXPECT_EQ(filesystem.path("large.o"), started[0]);
+    EXPECT_EQ(filesystem.path("binary"), started.back());
+    uint64_t secondMakespan = SimulatedMakespan(started, invocations, durations, 4);
+    EXPECT_EQ(45, secondMakespan);
+    EXPECT_LT(secondMakespan, firstMakespan);
+}
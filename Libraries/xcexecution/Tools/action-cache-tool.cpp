@@ -0,0 +1,208 @@
+/**
+ Copyright (c) 2015-present, Facebook, Inc.
+ All rights reserved.
+
+ This source code is licensed under the BSD-style license found in the
+ LICENSE file in the root directory of this source tree. An additional grant
+ of patent rights can be found in the PATENTS file in the same directory.
+ */
+
+#include <xcexecution/ActionCache.h>
+#include <libutil/Options.h>
+#include <libutil/DefaultFilesystem.h>
+#include <libutil/Filesystem.h>
+#include <process/DefaultContext.h>
+#include <process/DefaultLauncher.h>
+#include <process/MemoryContext.h>
+
+#include <cstdlib>
+
+using xcexecution::ActionCache;
+using libutil::DefaultFilesystem;
+using libutil::Filesystem;
+
+class Options {
+private:
+    ext::optional<bool>        _help;
+    ext::optional<bool>        _version;
+
+private:
+    ext::optional<std::string> _cache;
+    ext::optional<std::string> _invocation;
+    std::vector<std::string>   _command;
+
+public:
+    Options();
+    ~Options();
+
+public:
+    bool help() const
+    { return _help.value_or(false); }
+    bool version() const
+    { return _version.value_or(false); }
+
+public:
+    ext::optional<std::string> const &cache() const
+    { return _cache; }
+    ext::optional<std::string> const &invocation() const
+    { return _invocation; }
+    std::vector<std::string> const &command() const
+    { return _command; }
+
+private:
+    friend class libutil::Options;
+    std::pair<bool, std::string>
+    parseArgument(std::vector<std::string> const &args, std::vector<std::string>::const_iterator *it);
+};
+
+Options::
+Options()
+{
+}
+
+Options::
+~Options()
+{
+}
+
+std::pair<bool, std::string> Options::
+parseArgument(std::vector<std::string> const &args, std::vector<std::string>::const_iterator *it)
+{
+    std::string const &arg = **it;
+
+    if (arg == "-h" || arg == "--help") {
+        return libutil::Options::Current<bool>(&_help, arg);
+    } else if (arg == "-v" || arg == "--version") {
+        return libutil::Options::Current<bool>(&_version, arg);
+    } else if (arg == "-c" || arg == "--cache") {
+        return libutil::Options::Next<std::string>(&_cache, args, it);
+    } else if (arg == "-i" || arg == "--invocation") {
+        return libutil::Options::Next<std::string>(&_invocation, args, it);
+    } else if (arg == "--") {
+        /* Everything after is the command to run. */
+        _command = std::vector<std::string>(*it + 1, args.end());
+        *it = args.end() - 1;
+        return std::make_pair(true, std::string());
+    } else {
+        return std::make_pair(false, "unknown argument " + arg);
+    }
+}
+
+static int
+Help(std::string const &error = std::string())
+{
+    if (!error.empty()) {
+        fprintf(stderr, "error: %s\n", error.c_str());
+        fprintf(stderr, "\n");
+    }
+
+    fprintf(stderr, "Usage: action-cache-tool [options] -- command [arguments]\n\n");
+    fprintf(stderr, "Runs an invocation, reusing its outputs from the action cache.\n\n");
+
+#define INDENT "  "
+    fprintf(stderr, "Information:\n");
+    fprintf(stderr, INDENT "-h, --help\n");
+    fprintf(stderr, INDENT "-v, --version\n");
+    fprintf(stderr, "\n");
+
+    fprintf(stderr, "Cache Options:\n");
+    fprintf(stderr, INDENT "-c, --cache <path>\n");
+    fprintf(stderr, INDENT "-i, --invocation <description>\n");
+    fprintf(stderr, "\n");
+#undef INDENT
+
+    return (error.empty() ? EXIT_SUCCESS : EXIT_FAILURE);
+}
+
+static int
+Version()
+{
+    printf("action-cache-tool version 1\n");
+    return EXIT_SUCCESS;
+}
+
+int
+main(int argc, char **argv)
+{
+    DefaultFilesystem filesystem = DefaultFilesystem();
+    process::DefaultContext processContext = process::DefaultContext();
+    process::DefaultLauncher processLauncher = process::DefaultLauncher();
+
+    /*
+     * Parse out the options, or print help & exit.
+     */
+    Options options;
+    std::pair<bool, std::string> result = libutil::Options::Parse<Options>(&options, processContext.commandLineArguments());
+    if (!result.first) {
+        return Help(result.second);
+    }
+
+    /*
+     * Handle the basic options.
+     */
+    if (options.help()) {
+        return Help();
+    } else if (options.version()) {
+        return Version();
+    }
+
+    /*
+     * Diagnose missing options.
+     */
+    if (!options.cache() || !options.invocation() || options.command().empty()) {
+        return Help("missing option(s)");
+    }
+
+    /*
+     * Load the invocation the command runs, as the cache sees it.
+     */
+    std::vector<uint8_t> contents;
+    if (!filesystem.read(&contents, *options.invocation())) {
+        fprintf(stderr, "error: failed to open %s\n", options.invocation()->c_str());
+        return EXIT_FAILURE;
+    }
+
+    pbxbuild::Tool::Invocation invocation;
+    std::string executable;
+    if (!ActionCache::DeserializeInvocation(std::string(contents.begin(), contents.end()), &invocation, &executable)) {
+        fprintf(stderr, "error: invalid invocation description %s\n", options.invocation()->c_str());
+        return EXIT_FAILURE;
+    }
+
+    /*
+     * Restore the outputs if cached. The build trims the cache after Ninja
+     * finishes, so it isn't trimmed here, but input hashes found here are
+     * saved for it to remember.
+     */
+    ActionCache cache(*options.cache(), ActionCache::DefaultMaximumSize());
+    ext::optional<std::string> key = cache.key(&filesystem, invocation, executable);
+    if (key && cache.restore(&filesystem, *key, invocation)) {
+        cache.saveHashes(&filesystem, *key);
+        return EXIT_SUCCESS;
+    }
+
+    /*
+     * Otherwise, run the command, and store its outputs if it succeeds.
+     */
+    process::MemoryContext context = process::MemoryContext(
+        options.command().front(),
+        processContext.currentDirectory(),
+        std::vector<std::string>(options.command().begin() + 1, options.command().end()),
+        processContext.environmentVariables());
+
+    ext::optional<int> exitCode = processLauncher.launch(&filesystem, &context);
+    if (!exitCode) {
+        fprintf(stderr, "error: failed to launch %s\n", options.command().front().c_str());
+        return EXIT_FAILURE;
+    }
+
+    if (*exitCode == 0 && key) {
+        /* Failing to store only loses the cached result. */
+        cache.store(&filesystem, *key, invocation);
+    }
+    if (key) {
+        cache.saveHashes(&filesystem, *key);
+    }
+
+    return *exitCode;
+}
@@ -238,6 +238,9 @@ beginInvocation(pbxbuild::Tool::Invocation const &invocation, std::string const
 
         if (invocation.showEnvironmentInLog()) {
             std::map<std::string, std::string> sortedEnvironment = std::map<std::string, std::string>(invocation.environment().begin(), invocation.environment().end());
+            if (invocation.environmentBase() != nullptr) {
+                sortedEnvironment.insert(invocation.environmentBase()->begin(), invocation.environmentBase()->end());
+            }
             for (std::pair<std::string, std::string> const &entry : sortedEnvironment) {
                 message += INDENT + "export " + entry.first + "=" + entry.second + "\n";
             }